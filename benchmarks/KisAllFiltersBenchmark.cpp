@@ -0,0 +1,151 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAllFiltersBenchmark.h"
+#include "KisPeakMemorySampler.h"
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+
+#include <KoColor.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_selection.h"
+#include "kis_sequential_iterator.h"
+#include <KisGlobalResourcesInterface.h>
+
+namespace {
+
+const int canvasSizes[] = {512, 2048};
+
+QList<const KoColorSpace*> benchmarkColorSpaces()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    return {
+        registry->rgb8(),
+        registry->rgb16(),
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0)
+    };
+}
+
+KisPaintDeviceSP createNoiseDevice(const KoColorSpace *cs, const QRect &rect)
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(rgb8);
+
+    KoColor color(rgb8);
+    srand(31524744);
+
+    KisSequentialIterator it(dev, rect);
+    while (it.nextPixel()) {
+        color.fromQColor(QColor(rand() % 255, rand() % 255, rand() % 255));
+        memcpy(it.rawData(), color.data(), rgb8->pixelSize());
+    }
+
+    dev->convertTo(cs);
+    return dev;
+}
+
+KisSelectionSP createSelection(const QRect &rect)
+{
+    KisSelectionSP selection = new KisSelection();
+    KisPixelSelectionSP pixelSelection = selection->pixelSelection();
+
+    // a fully selected core with a semi-selected border around it
+    const int border = rect.width() / 8;
+    pixelSelection->select(rect.adjusted(border, border, -border, -border), 128);
+    pixelSelection->select(rect.adjusted(2 * border, 2 * border, -2 * border, -2 * border), MAX_SELECTED);
+
+    return selection;
+}
+
+}
+
+void KisAllFiltersBenchmark::benchmarkFilter_data()
+{
+    QTest::addColumn<QString>("filterId");
+    QTest::addColumn<QString>("colorSpaceId");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("useSelection");
+
+    QStringList filterIds = KisFilterRegistry::instance()->keys();
+    std::sort(filterIds.begin(), filterIds.end());
+
+    Q_FOREACH (const QString &filterId, filterIds) {
+        Q_FOREACH (const KoColorSpace *cs, benchmarkColorSpaces()) {
+            for (int size : canvasSizes) {
+                for (bool useSelection : {false, true}) {
+                    const QString tag = QString("%1:%2:%3:%4")
+                        .arg(filterId)
+                        .arg(cs->colorDepthId().id())
+                        .arg(size)
+                        .arg(useSelection ? "selection" : "noselection");
+
+                    QTest::newRow(tag.toLatin1()) << filterId << cs->id() << size << useSelection;
+                }
+            }
+        }
+    }
+}
+
+void KisAllFiltersBenchmark::benchmarkFilter()
+{
+    QFETCH(QString, filterId);
+    QFETCH(QString, colorSpaceId);
+    QFETCH(int, size);
+    QFETCH(bool, useSelection);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(colorSpaceId, 0);
+    QVERIFY(cs);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(filterId);
+    QVERIFY(filter);
+
+    KisFilterConfigurationSP config =
+        filter->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot();
+
+    const QRect rect(0, 0, size, size);
+    KisPaintDeviceSP src = createNoiseDevice(cs, rect);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    KisSelectionSP selection = useSelection ? createSelection(rect) : 0;
+
+    qint64 elapsed = 0;
+    qint64 peakMemory = 0;
+
+    QBENCHMARK_ONCE {
+        KisPeakMemorySampler sampler;
+        QElapsedTimer timer;
+        timer.start();
+
+        filter->process(src, dst, selection, rect, config);
+
+        elapsed = timer.nsecsElapsed();
+        peakMemory = sampler.stop();
+    }
+
+    const qreal megapixels = qreal(size) * size / 1e6;
+    const qreal seconds = qMax(qint64(1), elapsed) / 1e9;
+
+    qInfo().noquote() << QString("%1 %2 %3x%3 %4: %5 ms, %6 Mpx/s, peak memory %7 MiB")
+        .arg(filterId, -20)
+        .arg(cs->colorDepthId().id(), -4)
+        .arg(size)
+        .arg(useSelection ? "selection  " : "noselection")
+        .arg(elapsed / 1e6, 0, 'f', 1)
+        .arg(megapixels / seconds, 0, 'f', 2)
+        .arg(peakMemory / 1024.0 / 1024.0, 0, 'f', 1);
+}
+
+SIMPLE_TEST_MAIN(KisAllFiltersBenchmark)
@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALLFILTERSBENCHMARK_H
+#define KISALLFILTERSBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Runs every filter of KisFilterRegistry with its default configuration
+ * over a few color depths and canvas sizes, with and without a
+ * selection, and reports the throughput and the peak memory used by
+ * the tiles engine during the filtering.
+ *
+ * The set of filters can be limited with the standard QTest data tag
+ * syntax, e.g. `KisAllFiltersBenchmark benchmarkFilter:blur`
+ */
+class KisAllFiltersBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkFilter_data();
+    void benchmarkFilter();
+};
+
+#endif // KISALLFILTERSBENCHMARK_H
@@ -18,6 +18,20 @@
 #include "KisDocument.h"
 #include "kis_image.h"
 #include "kis_image_config.h"
+#include "kis_animation_frame_cache.h"
+#include "dialogs/KisAsyncAnimationCacheRenderDialog.h"
+#include "opengl/kis_opengl_image_textures.h"
+#include "KisLockFrameGenerationLock.h"
+#include "kis_keyframe_channel.h"
+#include "kis_raster_keyframe_channel.h"
+#include "kis_onion_skin_compositor.h"
+#include "kis_paint_layer.h"
+#include "kis_transform_mask.h"
+#include "KisRegion.h"
+#include <KisDumbTransformMaskParams.h>
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <kundo2command.h>
 
 namespace {
 void removeTempFiles(const QString &filesMask)
@@ -56,6 +70,66 @@ void runRenderingTest(KisImageSP image, int numCores, int numClones)
     }
 }
 
+KisImageSP createAnimatedImage(int numFrames, int numLayers, bool transformMasks, bool onionSkins)
+{
+    const QRect imageRect(0, 0, 1024, 1024);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "animation benchmark");
+    image->animationInterface()->setDocumentRange(KisTimeSpan::fromTimeToTime(0, numFrames - 1));
+
+    KUndo2Command parentCommand;
+    QList<KisPaintLayerSP> layers;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2);
+        image->addNode(layer, image->root());
+
+        layer->enableAnimation();
+        KisRasterKeyframeChannel *channel =
+            dynamic_cast<KisRasterKeyframeChannel*>(
+                layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true));
+
+        for (int time = 1; time < numFrames; time++) {
+            channel->addKeyframe(time, &parentCommand);
+        }
+        channel->setOnionSkinsEnabled(onionSkins);
+
+        if (transformMasks) {
+            KisTransformMaskSP mask = new KisTransformMask(image, QString("transform %1").arg(i));
+            image->addNode(mask, layer);
+            mask->setTransformParams(KisTransformMaskParamsInterfaceSP(
+                new KisDumbTransformMaskParams(QTransform::fromTranslate(-50, 30).rotate(15))));
+        }
+
+        layers << layer;
+    }
+
+    /**
+     * Every frame of every layer gets its own rect moving through the
+     * image, so the frames can be neither glued nor shared
+     */
+    for (int time = 0; time < numFrames; time++) {
+        image->animationInterface()->switchCurrentTimeAsync(time);
+        image->waitForDone();
+
+        for (int i = 0; i < layers.size(); i++) {
+            const QPoint offset(((time * 17 + i * 101) % 512), ((time * 11 + i * 53) % 512));
+            layers[i]->paintDevice()->fill(QRect(offset, QSize(512, 512)),
+                                           KoColor(QColor::fromHsv((time * 7 + i * 37) % 360, 200, 200), cs));
+        }
+    }
+
+    image->animationInterface()->switchCurrentTimeAsync(0);
+    image->waitForDone();
+
+    return image;
+}
+
+qreal framesPerSecond(int numFrames, qint64 elapsedMs)
+{
+    return numFrames * 1000.0 / qMax(qint64(1), elapsedMs);
+}
 
 }
 
@@ -99,4 +173,130 @@ void KisAnimationRenderingBenchmark::testCacheRendering()
     }
 }
 
+void KisAnimationRenderingBenchmark::testAnimationPerformance_data()
+{
+    QTest::addColumn<int>("numFrames");
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<bool>("transformMasks");
+    QTest::addColumn<bool>("onionSkins");
+    QTest::addColumn<bool>("useCache");
+    QTest::addColumn<bool>("diskSwapping");
+
+    QTest::newRow("baseline")       << 24  << 4  << false << false << true  << false;
+    QTest::newRow("many-frames")    << 120 << 4  << false << false << true  << false;
+    QTest::newRow("many-layers")    << 24  << 16 << false << false << true  << false;
+    QTest::newRow("transform-masks") << 24 << 4  << true  << false << true  << false;
+    QTest::newRow("onion-skins")    << 24  << 4  << false << true  << true  << false;
+    QTest::newRow("no-cache")       << 24  << 4  << false << false << false << false;
+    QTest::newRow("disk-swapping")  << 120 << 4  << false << false << true  << true;
+}
+
+void KisAnimationRenderingBenchmark::testAnimationPerformance()
+{
+    QFETCH(int, numFrames);
+    QFETCH(int, numLayers);
+    QFETCH(bool, transformMasks);
+    QFETCH(bool, onionSkins);
+    QFETCH(bool, useCache);
+    QFETCH(bool, diskSwapping);
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUseOnDiskAnimationCacheSwapping(diskSwapping);
+        cfg.setNumberOfOnionSkins(onionSkins ? 2 : 0);
+        for (int offset = -2; offset <= 2; offset++) {
+            if (!offset) continue;
+            cfg.setOnionSkinState(offset, onionSkins);
+        }
+    }
+    KisOnionSkinCompositor::instance()->configChanged();
+
+    KisImageSP image = createAnimatedImage(numFrames, numLayers, transformMasks, onionSkins);
+    KisImageAnimationInterface *animation = image->animationInterface();
+    const KisTimeSpan range = animation->documentPlaybackRange();
+
+    QElapsedTimer timer;
+
+    /**
+     * Regeneration: the frames are rendered in the background one by
+     * one, the way the cache populator and the exporter request them
+     */
+    timer.start();
+    for (int time = range.start(); time <= range.end(); time++) {
+        KisLockFrameGenerationLock lock(animation);
+        animation->requestFrameRegeneration(time, KisRegion(image->bounds()), false, std::move(lock));
+        image->waitForDone();
+    }
+    const qreal regenerationFps = framesPerSecond(range.duration(), timer.elapsed());
+
+    qreal cacheFps = 0;
+    qreal playbackFps = 0;
+
+    if (useCache) {
+        KisOpenGLImageTexturesSP glTex = KisOpenGLImageTextures::getImageTextures(image, 0, KoColorConversionTransformation::IntentPerceptual, KoColorConversionTransformation::Empty);
+        KisAnimationFrameCacheSP cache = new KisAnimationFrameCache(glTex);
+        glTex->testingForceInitialized();
+
+        /**
+         * Cache population: regeneration plus the conversion of the
+         * frames into the cache (and swapping them out, if enabled)
+         */
+        timer.restart();
+        KisAsyncAnimationCacheRenderDialog dlg(cache, range, 0);
+        dlg.setBatchMode(true);
+        QCOMPARE(dlg.regenerateRange(0), KisAsyncAnimationRenderDialogBase::RenderComplete);
+        cacheFps = framesPerSecond(range.duration(), timer.elapsed());
+
+        for (int time = range.start(); time <= range.end(); time++) {
+            QCOMPARE(cache->frameStatus(time), KisAnimationFrameCache::Cached);
+        }
+
+        /**
+         * Playback: fetching the cached frames in order. The texture
+         * upload itself needs a GL context, so the benchmark fetches
+         * the frames as images, which goes through the same decompression
+         * and swap-in path.
+         */
+        timer.restart();
+        for (int time = range.start(); time <= range.end(); time++) {
+            QImage frame = cache->getFrame(time);
+            QVERIFY(!frame.isNull());
+        }
+        playbackFps = framesPerSecond(range.duration(), timer.elapsed());
+    } else {
+        /**
+         * Without the cache the canvas has to switch the image to every
+         * frame it shows
+         */
+        timer.restart();
+        for (int time = range.start(); time <= range.end(); time++) {
+            animation->switchCurrentTimeAsync(time);
+            image->waitForDone();
+        }
+        playbackFps = framesPerSecond(range.duration(), timer.elapsed());
+    }
+
+    /**
+     * One line per scenario, so the results of different builds can
+     * be compared with a plain diff or grep
+     */
+    qInfo().noquote() << QString("ANIMATION-BENCHMARK %1 frames=%2 layers=%3 transforms=%4 onion=%5 cache=%6 swap=%7 regen_fps=%8 cache_fps=%9 playback_fps=%10")
+                         .arg(QTest::currentDataTag())
+                         .arg(numFrames).arg(numLayers)
+                         .arg(transformMasks).arg(onionSkins)
+                         .arg(useCache).arg(diskSwapping)
+                         .arg(regenerationFps, 0, 'f', 2)
+                         .arg(cacheFps, 0, 'f', 2)
+                         .arg(playbackFps, 0, 'f', 2);
+
+    QTest::setBenchmarkResult(regenerationFps, QTest::FramesPerSecond);
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUseOnDiskAnimationCacheSwapping(false);
+        cfg.setNumberOfOnionSkins(0);
+    }
+    KisOnionSkinCompositor::instance()->configChanged();
+}
+
 SIMPLE_TEST_MAIN(KisAnimationRenderingBenchmark)
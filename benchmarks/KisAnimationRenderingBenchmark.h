@@ -14,6 +14,9 @@ class KisAnimationRenderingBenchmark : public QObject
     Q_OBJECT
 private Q_SLOTS:
    void testCacheRendering();
+
+   void testAnimationPerformance_data();
+   void testAnimationPerformance();
 };
 
 #endif // KISANIMATIONRENDERINGBENCHMARK_H
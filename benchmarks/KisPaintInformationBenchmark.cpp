@@ -0,0 +1,90 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPaintInformationBenchmark.h"
+
+#include <cstdlib>
+#include <new>
+
+#include <QAtomicInt>
+#include <simpletest.h>
+
+#include <brushengine/kis_paint_information.h>
+
+namespace {
+QAtomicInt s_numAllocations;
+}
+
+/**
+ * Count all the heap allocations of the benchmark, so that the number
+ * of allocations per dab could be tracked independently from the
+ * platform's allocator
+ */
+void* operator new(size_t size)
+{
+    s_numAllocations.ref();
+
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+const int numDabs = 10000;
+
+/**
+ * Emulates what a stroke does for every dab: interpolates the paint
+ * information between two tablet events and copies it into a dab job
+ */
+void paintDabs(QVector<KisPaintInformation> &jobs)
+{
+    const KisPaintInformation pi1(QPointF(10, 10), 0.2, 0.1, 0.3, 0.0, 0.0, 1.0, 0.0, 1.0);
+    const KisPaintInformation pi2(QPointF(500, 300), 0.8, 0.3, 0.1, 0.0, 0.0, 1.0, 100.0, 1.5);
+
+    for (int i = 0; i < numDabs; i++) {
+        const qreal t = qreal(i) / numDabs;
+        KisPaintInformation pi = KisPaintInformation::mix(t, pi1, pi2);
+        jobs[i % jobs.size()] = pi;
+    }
+}
+
+}
+
+void KisPaintInformationBenchmark::benchmarkMixAndCopy()
+{
+    QVector<KisPaintInformation> jobs(64, KisPaintInformation());
+
+    QBENCHMARK {
+        paintDabs(jobs);
+    }
+}
+
+void KisPaintInformationBenchmark::benchmarkAllocationsPerDab()
+{
+    QVector<KisPaintInformation> jobs(64, KisPaintInformation());
+
+    // warm up the pools of the allocators
+    paintDabs(jobs);
+
+    const int startAllocations = s_numAllocations.loadAcquire();
+    paintDabs(jobs);
+    const int numAllocations = s_numAllocations.loadAcquire() - startAllocations;
+
+    qDebug() << "Heap allocations per dab:" << qreal(numAllocations) / numDabs;
+}
+
+SIMPLE_TEST_MAIN(KisPaintInformationBenchmark)
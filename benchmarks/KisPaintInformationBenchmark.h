@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPAINTINFORMATIONBENCHMARK_H
+#define KISPAINTINFORMATIONBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisPaintInformationBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkMixAndCopy();
+    void benchmarkAllocationsPerDab();
+};
+
+#endif // KISPAINTINFORMATIONBENCHMARK_H
@@ -0,0 +1,56 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPEAKMEMORYSAMPLER_H
+#define KISPEAKMEMORYSAMPLER_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "kis_memory_statistics_server.h"
+
+/**
+ * Samples the memory consumed by the tiles engine in a separate
+ * thread while the benchmarked operation is running. The result is
+ * the peak relative to the memory used when the sampler was created.
+ */
+class KisPeakMemorySampler
+{
+public:
+    KisPeakMemorySampler()
+        : m_baseline(currentMemory())
+        , m_peak(m_baseline)
+    {
+        m_thread = std::thread([this] () {
+            while (!m_stop) {
+                m_peak = qMax(m_peak.load(), currentMemory());
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+    }
+
+    qint64 stop()
+    {
+        m_stop = true;
+        m_thread.join();
+        return qMax(m_peak.load(), currentMemory()) - m_baseline;
+    }
+
+private:
+    static qint64 currentMemory()
+    {
+        return KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(0).realMemorySize;
+    }
+
+private:
+    const qint64 m_baseline;
+    std::atomic<qint64> m_peak;
+    std::atomic<bool> m_stop {false};
+    std::thread m_thread;
+};
+
+#endif // KISPEAKMEMORYSAMPLER_H
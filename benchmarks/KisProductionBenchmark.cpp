@@ -0,0 +1,410 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisProductionBenchmark.h"
+#include "KisPeakMemorySampler.h"
+
+#include <cmath>
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <KoColor.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+#include <KritaVersionWrapper.h>
+#include <kundo2command.h>
+
+#include "KisDocument.h"
+#include "KisPart.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_filter_mask.h"
+#include "kis_filter_strategy.h"
+#include "kis_image.h"
+#include "kis_image_animation_interface.h"
+#include "kis_keyframe_channel.h"
+#include "kis_layer_utils.h"
+#include "kis_paint_device.h"
+#include "kis_paint_layer.h"
+#include "kis_painter.h"
+#include "kis_psd_layer_style.h"
+#include "kis_raster_keyframe_channel.h"
+#include "kis_time_span.h"
+#include "kis_transform_worker.h"
+
+namespace {
+
+const QSize imageSize(2048, 2048);
+const int numStrokeDabs = 256;
+
+struct WorkloadResult {
+    qint64 elapsedMs = 0;
+    qint64 peakMemory = 0;
+};
+
+template <typename Func>
+WorkloadResult measureWorkload(Func func)
+{
+    WorkloadResult result;
+
+    KisPeakMemorySampler sampler;
+    QElapsedTimer timer;
+    timer.start();
+
+    func();
+
+    result.elapsedMs = timer.elapsed();
+    result.peakMemory = sampler.stop();
+
+    return result;
+}
+
+QString outputPath(const QString &fileName)
+{
+    return QString(FILES_OUTPUT_DIR) + '/' + fileName;
+}
+
+const KoColorSpace* scenarioColorSpace(const QString &scenario)
+{
+    if (scenario == "cmyk") {
+        return KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+    } else if (scenario == "f16") {
+        return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), 0);
+    }
+
+    return KoColorSpaceRegistry::instance()->rgb8();
+}
+
+void fillLayer(KisPaintLayerSP layer, int seed)
+{
+    const KoColorSpace *cs = layer->paintDevice()->colorSpace();
+
+    /**
+     * Every layer gets a few overlapping rects of its own, so that
+     * the tiles of the layers can be neither shared nor skipped as
+     * empty ones
+     */
+    for (int i = 0; i < 4; i++) {
+        const QPoint offset(((seed * 131 + i * 389) % (imageSize.width() / 2)),
+                            ((seed * 71 + i * 241) % (imageSize.height() / 2)));
+        layer->paintDevice()->fill(QRect(offset, imageSize / 2),
+                                   KoColor(QColor::fromHsv((seed * 37 + i * 53) % 360, 200, 200), cs));
+    }
+}
+
+KisImageSP createScenarioImage(const QString &scenario)
+{
+    const KoColorSpace *cs = scenarioColorSpace(scenario);
+    if (!cs) return 0;
+
+    KisImageSP image = new KisImage(0, imageSize.width(), imageSize.height(), cs, "production benchmark");
+
+    const bool isAnimation = scenario == "animation";
+    const int numLayers =
+        scenario == "layers-rgb8" ? 40 :
+        isAnimation ? 8 : 16;
+    const int numFrames = 24;
+
+    if (isAnimation) {
+        image->animationInterface()->setDocumentRange(KisTimeSpan::fromTimeToTime(0, numFrames - 1));
+    }
+
+    KUndo2Command parentCommand;
+    QList<KisPaintLayerSP> layers;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 * 3 / 4);
+        image->addNode(layer, image->root());
+        layers << layer;
+
+        if (isAnimation) {
+            layer->enableAnimation();
+            KisRasterKeyframeChannel *channel =
+                dynamic_cast<KisRasterKeyframeChannel*>(
+                    layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true));
+
+            for (int time = 1; time < numFrames; time++) {
+                channel->addKeyframe(time, &parentCommand);
+            }
+        } else {
+            fillLayer(layer, i);
+        }
+
+        if (scenario == "filter-masks" && i % 2) {
+            KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+            KIS_ASSERT(filter);
+            KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+            KisFilterMaskSP mask = new KisFilterMask(image, QString("blur %1").arg(i));
+            mask->initSelection(layer);
+            mask->setFilter(configuration->cloneWithResourcesSnapshot());
+            image->addNode(mask, layer);
+        }
+
+        if (scenario == "layer-styles" && i % 2) {
+            KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+
+            style->context()->keep_original = true;
+            style->dropShadow()->setEffectEnabled(true);
+            style->dropShadow()->setDistance(9);
+            style->dropShadow()->setSpread(100);
+            style->dropShadow()->setSize(9);
+            style->dropShadow()->setNoise(0);
+            style->dropShadow()->setKnocksOut(false);
+            style->dropShadow()->setOpacity(90);
+            style->dropShadow()->setAngle(0);
+
+            layer->setLayerStyle(style);
+        }
+    }
+
+    if (isAnimation) {
+        for (int time = 0; time < numFrames; time++) {
+            image->animationInterface()->switchCurrentTimeAsync(time);
+            image->waitForDone();
+
+            for (int i = 0; i < layers.size(); i++) {
+                fillLayer(layers[i], time * 13 + i);
+            }
+        }
+
+        image->animationInterface()->switchCurrentTimeAsync(0);
+        image->waitForDone();
+    }
+
+    return image;
+}
+
+QList<KisPaintLayerSP> collectPaintLayers(KisImageSP image)
+{
+    QList<KisPaintLayerSP> layers;
+
+    KisLayerUtils::recursiveApplyNodes(image->root(),
+        [&layers] (KisNodeSP node) {
+            KisPaintLayerSP layer = dynamic_cast<KisPaintLayer*>(node.data());
+            if (layer) {
+                layers << layer;
+            }
+        });
+
+    return layers;
+}
+
+/**
+ * Replays a stroke of dabs along a sine wave over the top paint
+ * layer. The updates are issued and awaited in small batches, the
+ * way the freehand stroke issues them while the user is painting.
+ */
+void replayStroke(KisImageSP image, KisPaintLayerSP layer)
+{
+    KisPaintDeviceSP device = layer->paintDevice();
+    const KoColorSpace *cs = device->colorSpace();
+
+    const QRect dabRect(0, 0, 64, 64);
+    KisPaintDeviceSP dab = new KisPaintDevice(cs);
+    dab->fill(dabRect, KoColor(Qt::black, cs));
+
+    QRect dirtyRect;
+
+    for (int i = 0; i < numStrokeDabs; i++) {
+        const qreal t = qreal(i) / numStrokeDabs;
+        const QPoint pos = QPointF(t * (image->width() - dabRect.width()),
+                                   (0.5 + 0.4 * std::sin(t * 4 * M_PI)) * (image->height() - dabRect.height())).toPoint();
+
+        KisPainter gc(device);
+        gc.setOpacityU8(OPACITY_OPAQUE_U8 / 4);
+        gc.bitBlt(pos, dab, dabRect);
+
+        dirtyRect |= QRect(pos, dabRect.size());
+
+        if (i % 8 == 7) {
+            layer->setDirty(dirtyRect);
+            image->waitForDone();
+            dirtyRect = QRect();
+        }
+    }
+
+    if (!dirtyRect.isEmpty()) {
+        layer->setDirty(dirtyRect);
+    }
+    image->waitForDone();
+}
+
+void transformLayers(KisImageSP image, const QList<KisPaintLayerSP> &layers)
+{
+    KisFilterStrategy *filterStrategy = KisFilterStrategyRegistry::instance()->value("Bicubic");
+
+    Q_FOREACH (KisPaintLayerSP layer, layers) {
+        KisTransformWorker worker(layer->paintDevice(),
+                                  0.9, 0.9,
+                                  0, 0,
+                                  M_PI / 12,
+                                  0, 0,
+                                  0, filterStrategy);
+        worker.run();
+    }
+
+    image->refreshGraphAsync();
+    image->waitForDone();
+}
+
+}
+
+void KisProductionBenchmark::cleanupTestCase()
+{
+    QString reportPath = qEnvironmentVariable("KRITA_BENCHMARK_REPORT");
+    if (reportPath.isEmpty()) {
+        reportPath = outputPath("production_benchmark.json");
+    }
+
+    QJsonObject report;
+    report["version"] = KritaVersionWrapper::versionString(true);
+    report["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["threads"] = QThread::idealThreadCount();
+    report["results"] = m_results;
+
+    QFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write the benchmark report to" << reportPath;
+        return;
+    }
+
+    file.write(QJsonDocument(report).toJson());
+    qInfo().noquote() << "PRODUCTION-BENCHMARK report written to" << reportPath;
+}
+
+void KisProductionBenchmark::benchmarkDocument_data()
+{
+    QTest::addColumn<QString>("scenario");
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("layers-rgb8")  << "layers-rgb8"  << QString();
+    QTest::newRow("filter-masks") << "filter-masks" << QString();
+    QTest::newRow("layer-styles") << "layer-styles" << QString();
+    QTest::newRow("animation")    << "animation"    << QString();
+    QTest::newRow("cmyk")         << "cmyk"         << QString();
+    QTest::newRow("f16")          << "f16"          << QString();
+
+    /**
+     * Real-life documents are too big to be shipped with the sources,
+     * so the corpus is supplied by the person running the benchmark
+     */
+    const QString corpusPath = qEnvironmentVariable("KRITA_BENCHMARK_CORPUS");
+    if (!corpusPath.isEmpty()) {
+        QDir corpusDir(corpusPath);
+        Q_FOREACH (const QFileInfo &info, corpusDir.entryInfoList({"*.kra"}, QDir::Files, QDir::Name)) {
+            const QString tag = QString("file:%1").arg(info.fileName());
+            QTest::newRow(tag.toUtf8()) << QString() << info.absoluteFilePath();
+        }
+    }
+}
+
+void KisProductionBenchmark::benchmarkDocument()
+{
+    QFETCH(QString, scenario);
+    QFETCH(QString, fileName);
+
+    if (fileName.isEmpty()) {
+        KisImageSP image = createScenarioImage(scenario);
+        if (!image) {
+            QSKIP("The color space of the scenario is not available");
+        }
+        image->waitForDone();
+
+        QScopedPointer<KisDocument> sourceDoc(KisPart::instance()->createDocument());
+        sourceDoc->setFileBatchMode(true);
+        sourceDoc->setCurrentImage(image);
+
+        fileName = outputPath("production_source.kra");
+        QVERIFY(sourceDoc->exportDocumentSync(fileName, "application/x-krita"));
+    }
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    doc->setFileBatchMode(true);
+
+    QMap<QString, WorkloadResult> results;
+    bool loadingResult = false;
+
+    results["open"] = measureWorkload([&] () {
+        loadingResult = doc->loadNativeFormat(fileName);
+        if (loadingResult) {
+            doc->image()->initialRefreshGraph();
+        }
+    });
+    QVERIFY(loadingResult);
+
+    KisImageSP image = doc->image();
+    const QList<KisPaintLayerSP> paintLayers = collectPaintLayers(image);
+    QVERIFY(!paintLayers.isEmpty());
+
+    results["refresh"] = measureWorkload([&] () {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    });
+
+    results["stroke"] = measureWorkload([&] () {
+        replayStroke(image, paintLayers.last());
+    });
+
+    results["transform"] = measureWorkload([&] () {
+        transformLayers(image, paintLayers);
+    });
+
+    bool savingResult = false;
+    results["save"] = measureWorkload([&] () {
+        savingResult = doc->exportDocumentSync(outputPath("production_save.kra"), "application/x-krita");
+    });
+    QVERIFY(savingResult);
+
+    bool exportResult = false;
+    results["export"] = measureWorkload([&] () {
+        exportResult = doc->exportDocumentSync(outputPath("production_export.png"), "image/png");
+    });
+    QVERIFY(exportResult);
+
+    QJsonObject workloads;
+    QStringList summary;
+
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        const qreal peakMiB = it.value().peakMemory / 1024.0 / 1024.0;
+
+        QJsonObject workload;
+        workload["ms"] = it.value().elapsedMs;
+        workload["peak_mib"] = peakMiB;
+        workloads[it.key()] = workload;
+
+        summary << QString("%1=%2ms/%3MiB")
+                   .arg(it.key())
+                   .arg(it.value().elapsedMs)
+                   .arg(peakMiB, 0, 'f', 1);
+    }
+
+    QJsonObject result;
+    result["document"] = QString(QTest::currentDataTag());
+    result["size"] = QString("%1x%2").arg(image->width()).arg(image->height());
+    result["colorspace"] = image->colorSpace()->id();
+    result["workloads"] = workloads;
+    m_results.append(result);
+
+    /**
+     * One line per document, so the results of different builds can
+     * be compared with a plain diff or grep even without the report
+     */
+    qInfo().noquote() << QString("PRODUCTION-BENCHMARK %1 %2")
+                         .arg(QTest::currentDataTag())
+                         .arg(summary.join(' '));
+}
+
+SIMPLE_TEST_MAIN(KisProductionBenchmark)
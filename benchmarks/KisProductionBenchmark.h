@@ -0,0 +1,45 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPRODUCTIONBENCHMARK_H
+#define KISPRODUCTIONBENCHMARK_H
+
+#include <simpletest.h>
+
+#include <QJsonArray>
+
+/**
+ * Runs the whole life cycle of a document the way it happens in
+ * production: opening the file, full refresh of the projection,
+ * painting, committing a transformation of all the layers, saving
+ * and exporting. Every workload is timed and its peak memory is
+ * sampled.
+ *
+ * The documents are generated synthetically (many layers, filter
+ * masks, layer styles, animation, CMYK and F16 images). Real-life
+ * documents can be added to the run by pointing the
+ * KRITA_BENCHMARK_CORPUS environment variable to a directory with
+ * .kra files.
+ *
+ * The results are written to the JSON file defined by the
+ * KRITA_BENCHMARK_REPORT environment variable (or to
+ * production_benchmark.json in the output directory), so that the
+ * reports of two builds can be compared automatically.
+ */
+class KisProductionBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void cleanupTestCase();
+
+    void benchmarkDocument_data();
+    void benchmarkDocument();
+
+private:
+    QJsonArray m_results;
+};
+
+#endif // KISPRODUCTIONBENCHMARK_H
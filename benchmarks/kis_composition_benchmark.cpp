@@ -25,6 +25,7 @@
 #include <KoColorSpaceRegistry.h>
 
 #include <KoColorSpaceTraits.h>
+#include <KoColorModelStandardIds.h>
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
@@ -36,6 +37,11 @@
 
 #include <kis_debug.h>
 
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
 #if defined Q_OS_WIN
 #define MEMALIGN_ALLOC(p, a, s) ((*(p)) = _aligned_malloc((s), (a)), *(p) ? 0 : errno)
 #define MEMALIGN_FREE(p) _aligned_free((p))
@@ -162,6 +168,27 @@ struct RandomGenerator<double> : RandomGenerator<float>
     }
 };
 
+#ifdef HAVE_OPENEXR
+template <>
+struct RandomGenerator<half>
+{
+    RandomGenerator(int seed)
+        : m_float(seed)
+    {
+    }
+
+    half operator() () {
+        return half(m_float());
+    }
+
+    half unit() {
+        return KoColorSpaceMathsTraits<half>::unitValue;
+    }
+
+    RandomGenerator<float> m_float;
+};
+#endif
+
 
 template <typename channel_type>
 void generateDataLine(uint seed, int numPixels, quint8 *srcPixels, quint8 *dstPixels, quint8 *mask, AlphaRange srcAlphaRange, AlphaRange dstAlphaRange)
@@ -227,7 +254,8 @@ QVector<Tile> generateTiles(int size,
                             const int dstAlignmentShift,
                             AlphaRange srcAlphaRange,
                             AlphaRange dstAlphaRange,
-                            const quint32 pixelSize)
+                            const quint32 pixelSize,
+                            const bool isHalfFloat = false)
 {
     QVector<Tile> tiles(size);
 
@@ -260,6 +288,10 @@ QVector<Tile> generateTiles(int size,
 
         if (pixelSize == 4) {
             generateDataLine<quint8>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#ifdef HAVE_OPENEXR
+        } else if (pixelSize == 8 && isHalfFloat) {
+            generateDataLine<half>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#endif
         } else if (pixelSize == 8) {
             generateDataLine<quint16>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else if (pixelSize == 16) {
@@ -359,13 +391,20 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
     return true;
 }
 
+inline bool isHalfFloatColorSpace(const KoColorSpace *cs)
+{
+    return cs->colorDepthId() == Float16BitsColorDepthID;
+}
+
 template<template<typename> class Compare = PixelEqualDirect>
-bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
+bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2,
+                   const QBitArray &channelFlags = QBitArray())
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
+    const bool isHalfFloat = isHalfFloatColorSpace(op1->colorSpace());
     const int alignment = 16;
-    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, op1->colorSpace()->pixelSize());
+    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, pixelSize, isHalfFloat);
 
     KoCompositeOp::ParameterInfo params;
     params.dstRowStride  = 4 * rowStride;
@@ -376,7 +415,7 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     // This is a hack as in the old version we get a rounding of opacity to this value
     params.opacity       = float(Arithmetic::scale<quint8>(0.5*1.0f))/255.0;
     params.flow          = 0.3*1.0f;
-    params.channelFlags  = QBitArray();
+    params.channelFlags  = channelFlags;
 
     params.dstRowStart   = tiles[0].dst;
     params.srcRowStart   = tiles[0].src;
@@ -392,6 +431,13 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     if (pixelSize == 4) {
         compareResult = compareTwoOpsPixels<quint8, Compare>(tiles, 10);
     }
+#ifdef HAVE_OPENEXR
+    else if (pixelSize == 8 && isHalfFloat) {
+        // half has only 11 bits of mantissa, so the tolerance
+        // should be relative to its precision, not to float's
+        compareResult = compareTwoOpsPixels<half, Compare>(tiles, half(2e-3f));
+    }
+#endif
     else if (pixelSize == 8) {
         compareResult = compareTwoOpsPixels<quint16, Compare>(tiles, 90);
     }
@@ -448,7 +494,8 @@ void benchmarkCompositeOp(const KoCompositeOp *op,
     QString testName = getTestName(haveMask, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange);
 
     QVector<Tile> tiles =
-        generateTiles(numTiles, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange, op->colorSpace()->pixelSize());
+        generateTiles(numTiles, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange,
+                      op->colorSpace()->pixelSize(), isHalfFloatColorSpace(op->colorSpace()));
 
     const int tileOffset = 4 * (processRect.y() * rowStride + processRect.x());
 
@@ -773,6 +820,20 @@ void KisCompositionBenchmark::compareRgbF32AlphaDarkenOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16AlphaDarkenOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#endif
+}
+
 void KisCompositionBenchmark::compareAlphaDarkenOpsNoMask()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -821,6 +882,22 @@ void KisCompositionBenchmark::compareOverOpsNoMask()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareOverOpsAlphaLocked()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOp32(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoBgrU8Traits>(cs);
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp, alphaLocked));
+    QVERIFY(compareTwoOps(false, opAct, opExp, alphaLocked));
+
+    delete opExp;
+    delete opAct;
+}
+
 void KisCompositionBenchmark::compareRgbU16OverOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
@@ -845,6 +922,50 @@ void KisCompositionBenchmark::compareRgbF32OverOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU16OverOpsAlphaLocked()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOpU64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoRgbU16Traits>(cs);
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp, alphaLocked));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::compareRgbF32OverOpsAlphaLocked()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOp128(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoRgbF32Traits>(cs);
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp, alphaLocked));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::compareRgbF16OverOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#endif
+}
+
 void KisCompositionBenchmark::compareRgbU8CopyOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -885,6 +1006,20 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16CopyOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpCopy2<KoRgbF16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#endif
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -1013,6 +1148,66 @@ void KisCompositionBenchmark::testRgbF32CompositeCopyOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeCopyLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpCopy2<KoRgbF16Traits>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeCopyOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#endif
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenReal_Aligned()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
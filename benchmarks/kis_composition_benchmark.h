@@ -37,15 +37,21 @@ private Q_SLOTS:
     void compareAlphaDarkenOpsNoMask();
     void compareRgbU16AlphaDarkenOps();
     void compareRgbF32AlphaDarkenOps();
+    void compareRgbF16AlphaDarkenOps();
 
     void compareOverOps();
     void compareOverOpsNoMask();
+    void compareOverOpsAlphaLocked();
     void compareRgbU16OverOps();
+    void compareRgbU16OverOpsAlphaLocked();
     void compareRgbF32OverOps();
+    void compareRgbF32OverOpsAlphaLocked();
+    void compareRgbF16OverOps();
 
     void compareRgbU8CopyOps();
     void compareRgbU16CopyOps();
     void compareRgbF32CopyOps();
+    void compareRgbF16CopyOps();
 
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
@@ -71,6 +77,15 @@ private Q_SLOTS:
     void testRgbF32CompositeCopyLegacy();
     void testRgbF32CompositeCopyOptimized();
 
+    void testRgbF16CompositeAlphaDarkenLegacy();
+    void testRgbF16CompositeAlphaDarkenOptimized();
+
+    void testRgbF16CompositeOverLegacy();
+    void testRgbF16CompositeOverOptimized();
+
+    void testRgbF16CompositeCopyLegacy();
+    void testRgbF16CompositeCopyOptimized();
+
     void testRgb8CompositeAlphaDarkenReal_Aligned();
     void testRgb8CompositeOverReal_Aligned();
 
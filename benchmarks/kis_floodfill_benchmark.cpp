@@ -62,6 +62,10 @@ void KisFloodFillBenchmark::initTestCase()
     KisPainter::copyAreaOptimized(QPoint(), m_deviceStandardFloodFill,
                                   m_deviceWithSelectionAsBoundary, m_deviceWithSelectionAsBoundary->exactBounds());
 
+    m_deviceWithCloseGap = new KisPaintDevice(m_colorSpace);
+    KisPainter::copyAreaOptimized(QPoint(), m_deviceStandardFloodFill,
+                                  m_deviceWithCloseGap, m_deviceStandardFloodFill->exactBounds());
+
     //m_deviceWithoutSelectionAsBoundary = m_deviceStandardFloodFill->
 
     const KoColorSpace* alphacs = KoColorSpaceRegistry::instance()->alpha8();
@@ -170,6 +174,47 @@ void KisFloodFillBenchmark::benchmarkFloodWithSelectionAsBoundary()
     }
 }
 
+void KisFloodFillBenchmark::benchmarkFloodWithCloseGap_data()
+{
+    QTest::addColumn<int>("closeGap");
+
+    QTest::newRow("gap-4") << 4;
+    QTest::newRow("gap-16") << 16;
+    QTest::newRow("gap-32") << 32;
+}
+
+void KisFloodFillBenchmark::benchmarkFloodWithCloseGap()
+{
+    QFETCH(int, closeGap);
+
+    KoColor fg(m_colorSpace);
+    KoColor bg(m_colorSpace);
+    fg.fromQColor(Qt::blue);
+    bg.fromQColor(Qt::black);
+
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(m_deviceWithCloseGap);
+        fillPainter.setPaintColor( fg );
+        fillPainter.setBackgroundColor( bg );
+
+        fillPainter.beginTransaction(kundo2_noi18n("Flood Fill"));
+
+        fillPainter.setOpacityToUnit();
+        // default
+        fillPainter.setFillThreshold(15);
+        fillPainter.setCompositeOpId(COMPOSITE_OVER);
+        fillPainter.setCareForSelection(true);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setUseCompositing(true);
+        fillPainter.setCloseGap(closeGap);
+
+        fillPainter.createFloodSelection(1, 1, m_deviceWithCloseGap, m_existingSelection);
+
+        fillPainter.deleteTransaction();
+    }
+}
 
 void KisFloodFillBenchmark::cleanupTestCase()
 {
@@ -24,6 +24,7 @@ private:
     KisPaintDeviceSP m_deviceStandardFloodFill;
     KisPaintDeviceSP m_deviceWithSelectionAsBoundary;
     KisPaintDeviceSP m_deviceWithoutSelectionAsBoundary;
+    KisPaintDeviceSP m_deviceWithCloseGap;
     KisPaintDeviceSP m_existingSelection;
     int m_startX;
     int m_startY;
@@ -35,6 +36,8 @@ private Q_SLOTS:
     void benchmarkFlood();
     void benchmarkFloodWithoutSelectionAsBoundary();
     void benchmarkFloodWithSelectionAsBoundary();
+    void benchmarkFloodWithCloseGap_data();
+    void benchmarkFloodWithCloseGap();
 
     
     
@@ -16,6 +16,7 @@
 #include <simpletest.h>
 
 #include "kis_iterator_ng.h"
+#include "KisTileSpanIterator.h"
 
 void KisHLineIteratorBenchmark::initTestCase()
 {
@@ -179,4 +180,30 @@ void KisHLineIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy(){
 
 
 
+void KisHLineIteratorBenchmark::benchmarkTileSpanWriteBytes()
+{
+    const int pixelSize = m_colorSpace->pixelSize();
+
+    QBENCHMARK{
+        KisTileSpanIterator it(m_device, QRect(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT));
+        while (it.nextSpan()) {
+            quint8 *row = it.rawData();
+            for (int j = 0; j < it.height(); j++) {
+                for (int i = 0; i < it.width(); i++) {
+                    memcpy(row + i * pixelSize, m_color->data(), pixelSize);
+                }
+                row += it.rowStride();
+            }
+        }
+    }
+}
+
+void KisHLineIteratorBenchmark::benchmarkTileSpanNoMemCpy()
+{
+    QBENCHMARK{
+        KisTileSpanIterator it(m_device, QRect(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT));
+        while (it.nextSpan());
+    }
+}
+
 SIMPLE_TEST_MAIN(KisHLineIteratorBenchmark)
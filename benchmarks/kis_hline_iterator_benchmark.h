@@ -44,6 +44,10 @@ private Q_SLOTS:
     void benchmarkConstNoMemCpy();
     // copy from one device to another
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // the same as benchmarkWriteBytes(), but tile by tile
+    void benchmarkTileSpanWriteBytes();
+    void benchmarkTileSpanNoMemCpy();
     
 
     
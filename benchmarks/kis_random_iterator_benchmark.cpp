@@ -16,6 +16,12 @@
 #include <simpletest.h>
 #include <kis_random_accessor_ng.h>
 
+#include <QThread>
+
+#include "tiles3/kis_tile_hash_table2.h"
+#include "tiles3/kis_tile_hash_table3.h"
+#include "tiles3/kis_tile_data_store.h"
+
 
 void KisRandomIteratorBenchmark::initTestCase()
 {
@@ -223,4 +229,74 @@ void KisRandomIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy()
 }
 
 
+/**
+ * Emulates what smudge and filter brushes do in KisRandomAccessor2:
+ * many threads looking up tiles in the same hash table
+ */
+template <class HashTable>
+void benchmarkConcurrentLookupsImpl()
+{
+    const int numCols = TEST_IMAGE_WIDTH / 64;
+    const int numRows = TEST_IMAGE_HEIGHT / 64;
+    const int numLookups = 1 << 20;
+    const int numThreads = qMax(2, QThread::idealThreadCount());
+
+    const quint8 defaultPixel[4] = {0, 0, 0, 0};
+    KisTileData *defaultTileData =
+        KisTileDataStore::instance()->createDefaultTileData(4, defaultPixel);
+
+    HashTable table(0);
+    table.setDefaultTileData(defaultTileData);
+
+    for (int row = 0; row < numRows; row++) {
+        for (int col = 0; col < numCols; col++) {
+            bool newTile = false;
+            table.getTileLazy(col, row, newTile);
+        }
+    }
+
+    QBENCHMARK {
+        QVector<QThread*> threads;
+
+        for (int i = 0; i < numThreads; i++) {
+            threads << QThread::create([&table, i] () {
+                quint32 seed = 123456 + i;
+
+                for (int j = 0; j < numLookups; j++) {
+                    seed = seed * 1103515245 + 12345;
+                    const int col = (seed >> 8) % numCols;
+                    const int row = (seed >> 20) % numRows;
+
+                    bool existingTile = false;
+                    typename HashTable::TileTypeSP tile =
+                        table.getReadOnlyTileLazy(col, row, existingTile);
+                    KIS_ASSERT(existingTile);
+                }
+            });
+        }
+
+        Q_FOREACH (QThread *thread, threads) {
+            thread->start();
+        }
+
+        Q_FOREACH (QThread *thread, threads) {
+            thread->wait();
+            delete thread;
+        }
+    }
+
+    table.clear();
+    table.setDefaultTileData(0);
+}
+
+void KisRandomIteratorBenchmark::benchmarkConcurrentLookupsLeapfrogTable()
+{
+    benchmarkConcurrentLookupsImpl<KisTileHashTableTraits2<KisTile>>();
+}
+
+void KisRandomIteratorBenchmark::benchmarkConcurrentLookupsOpenAddressingTable()
+{
+    benchmarkConcurrentLookupsImpl<KisTileHashTableTraits3<KisTile>>();
+}
+
 SIMPLE_TEST_MAIN(KisRandomIteratorBenchmark)
@@ -46,6 +46,10 @@ private Q_SLOTS:
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // concurrent tile lookups in the tile hash table
+    void benchmarkConcurrentLookupsLeapfrogTable();
+    void benchmarkConcurrentLookupsOpenAddressingTable();
 };
 
 #endif
@@ -0,0 +1,88 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_size_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+
+#include <kis_debug.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_datamanager.h>
+
+static const int NUM_LAYERS = 8;
+
+void KisTileSizeBenchmark::initTestCase()
+{
+    qDebug() << "Tile size:" << KisTileData::WIDTH << "x" << KisTileData::HEIGHT;
+}
+
+void KisTileSizeBenchmark::benchmarkBitBlt()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+
+    const QRect rc(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    src->fill(rc, KoColor(Qt::red, cs));
+
+    QBENCHMARK {
+        KisPainter gc(dst);
+        gc.setCompositeOpId(COMPOSITE_OVER);
+        gc.bitBlt(rc.topLeft(), src, rc);
+    }
+}
+
+void KisTileSizeBenchmark::benchmarkBitBltUnaligned()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+
+    const QRect rc(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT);
+    src->fill(rc, KoColor(Qt::red, cs));
+
+    QBENCHMARK {
+        KisPainter gc(dst);
+        gc.setCompositeOpId(COMPOSITE_OVER);
+        gc.bitBlt(QPoint(17, 13), src, rc);
+    }
+}
+
+void KisTileSizeBenchmark::benchmarkMergeWalker()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, cs, "tile size benchmark");
+
+    for (int i = 0; i < NUM_LAYERS; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2, cs);
+
+        const int step = TEST_IMAGE_WIDTH / (2 * NUM_LAYERS);
+        const QRect fillRect(i * step, i * step,
+                             TEST_IMAGE_WIDTH - 2 * i * step,
+                             TEST_IMAGE_HEIGHT - 2 * i * step);
+
+        layer->paintDevice()->fill(fillRect, KoColor(QColor::fromHsv(i * 360 / NUM_LAYERS, 255, 255), cs));
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisTileSizeBenchmark)
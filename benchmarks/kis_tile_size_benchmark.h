@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_TILE_SIZE_BENCHMARK_H
+#define KIS_TILE_SIZE_BENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Measures the operations that are most sensitive to the tile size
+ * of the build (see KRITA_TILE_SIZE CMake option). Run the benchmark
+ * in builds with different tile sizes to compare the results.
+ */
+class KisTileSizeBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkBitBlt();
+    void benchmarkBitBltUnaligned();
+    void benchmarkMergeWalker();
+};
+
+#endif
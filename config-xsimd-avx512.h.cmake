@@ -0,0 +1,3 @@
+/* config-xsimd-avx512.h.  Generated by cmake from config-xsimd-avx512.h.cmake */
+
+#cmakedefine HAVE_XSIMD_AVX512 1
@@ -30,6 +30,7 @@
 #include <QStandardPaths>
 #include <QString>
 #include <QThread>
+#include <QTimer>
 #include <QTranslator>
 #include <QImageReader>
 
@@ -37,6 +38,7 @@
 #include <KisMainWindow.h>
 #include <KisSupportedArchitectures.h>
 #include <KisUsageLogger.h>
+#include <KisStartupProfiler.h>
 #include <KoConfig.h>
 #include <KoResourcePaths.h>
 #include <kis_config.h>
@@ -234,6 +236,9 @@ Java_org_krita_android_JNIWrappers_openFileFromIntent(JNIEnv* /*env*/,
 
 extern "C" MAIN_EXPORT int MAIN_FN(int argc, char **argv)
 {
+    // start measuring the startup time as early as possible
+    KisStartupProfiler::instance();
+
 #ifdef Q_OS_ANDROID
     KisAndroidLogHandler::handler_init();
 #endif
@@ -617,7 +622,9 @@ extern "C" MAIN_EXPORT int MAIN_FN(int argc, char **argv)
 #endif
 
     // first create the application so we can create a pixmap
+    const int createApplicationPhase = KisStartupProfiler::instance()->beginPhase("Create application");
     KisApplication app(key, argc, argv);
+    KisStartupProfiler::instance()->endPhase(createApplicationPhase);
 
 #if defined Q_OS_WIN && QT_VERSION > QT_VERSION_CHECK(6, 0, 0)
     const bool forceWinTab = !KisConfig::useWin8PointerInputNoApp(&kritarc);
@@ -793,10 +800,19 @@ extern "C" MAIN_EXPORT int MAIN_FN(int argc, char **argv)
 
     KisApplication::setFont(KisUiFont::normalFont());
 
+    const int startApplicationPhase = KisStartupProfiler::instance()->beginPhase("Start application");
     if (!app.start(args)) {
         KisUsageLogger::log("Could not start Krita Application");
+        KisStartupProfiler::instance()->finish();
         return 1;
     }
+    KisStartupProfiler::instance()->endPhase(startApplicationPhase);
+
+    // the startup is over when the event loop has processed the first
+    // events, i.e. the main window has been shown
+    QTimer::singleShot(0, [] () {
+        KisStartupProfiler::instance()->finish();
+    });
 
     int state = KisApplication::exec();
 
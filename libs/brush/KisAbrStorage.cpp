@@ -8,6 +8,7 @@
 #include "KisAbrStorage.h"
 #include "KisResourceStorage.h"
 
+#include <QCryptographicHash>
 #include <QFileInfo>
 #include <KisStaticInitializer.h>
 
@@ -178,3 +179,18 @@ QImage KisAbrStorage::thumbnail() const
 {
     return m_brushCollection->image();
 }
+
+QString KisAbrStorage::fingerprint() const
+{
+    const QFileInfo fi(location());
+    if (!fi.exists()) return QString();
+
+    /**
+     * An unchanged collection is not synchronized on startup, so its
+     * brushes are not decoded until they are actually used
+     */
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(QString("%1:%2").arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).toUtf8());
+
+    return QString::fromLatin1(hash.result().toHex());
+}
@@ -27,6 +27,7 @@ public:
     QSharedPointer<KisResourceStorage::ResourceIterator> resources(const QString &resourceType) override;
     QSharedPointer<KisResourceStorage::TagIterator> tags(const QString &resourceType) override;
     QImage thumbnail() const override;
+    QString fingerprint() const override;
     KisAbrBrushCollectionSP m_brushCollection;
 };
 
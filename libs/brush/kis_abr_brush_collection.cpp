@@ -298,6 +298,58 @@ static QString abr_read_ucs2_text(QDataStream & abr)
 }
 
 
+/**
+ * Reads the name of the brush record at the current position of the
+ * stream and moves the stream to the next record. Returns false if the
+ * record doesn't contain a sampled brush.
+ */
+static bool abr_brush_scan_v6(QDataStream & abr, const QString filename, qint32 id, QString *name)
+{
+    qint32 brush_size = 0;
+    abr >> brush_size;
+
+    qint32 brush_end = brush_size;
+    // complement to 4
+    while (brush_end % 4 != 0) {
+        brush_end++;
+    }
+
+    *name = abr_v1_brush_name(filename, id);
+    abr.device()->seek(abr.device()->pos() + brush_end);
+
+    return abr.status() == QDataStream::Ok;
+}
+
+static bool abr_brush_scan_v12(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 id, QString *name)
+{
+    short brush_type;
+    qint32 brush_size;
+
+    abr >> brush_type;
+    abr >> brush_size;
+    const qint64 next_brush = abr.device()->pos() + brush_size;
+
+    if (brush_type != 2) {
+        abr.device()->seek(next_brush);
+        return false;
+    }
+
+    // discard 4 misc bytes and 2 spacing bytes
+    abr.device()->seek(abr.device()->pos() + 6);
+
+    name->clear();
+    if (abr_hdr->version == 2)
+        *name = abr_read_ucs2_text(abr);
+    if (name->isNull()) {
+        *name = abr_v1_brush_name(filename, id);
+    }
+
+    abr.device()->seek(next_brush);
+
+    return abr.status() == QDataStream::Ok;
+}
+
+
 quint32 KisAbrBrushCollection::abr_brush_load_v6(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 image_ID, qint32 id)
 {
     Q_UNUSED(image_ID);
@@ -424,8 +476,7 @@ qint32 KisAbrBrushCollection::abr_brush_load_v12(QDataStream & abr, AbrInfo *abr
         // computed brush
         // FIXME: support it!
         warnKrita  << "WARNING: computed brush unsupported, skipping.";
-        abr.device()->seek(abr.device()->pos() + next_brush);
-        // TODO: test also this one abr.skipRawData(next_brush);
+        abr.device()->seek(next_brush);
     }
     else if (brush_type == 2) {
         // sampled brush
@@ -530,6 +581,11 @@ KisAbrBrushCollection::KisAbrBrushCollection(const QString& filename)
 KisAbrBrushCollection::KisAbrBrushCollection(const KisAbrBrushCollection& rhs)
     : m_isLoaded(rhs.m_isLoaded)
     , m_lastModified(rhs.m_lastModified)
+    , m_filename(rhs.m_filename)
+    , m_data(rhs.m_data)
+    , m_header(rhs.m_header)
+    , m_brushRecords(rhs.m_brushRecords)
+    , m_allBrushesDecoded(rhs.m_allBrushesDecoded)
 {
     m_abrBrushes.reset(new QMap<QString, KisAbrBrushSP>());
     for (auto it = rhs.m_abrBrushes->begin();
@@ -561,10 +617,8 @@ bool KisAbrBrushCollection::load()
 
 bool KisAbrBrushCollection::loadFromDevice(QIODevice *dev)
 {
-    AbrInfo abr_hdr;
-    qint32 image_ID;
+    QSharedPointer<AbrInfo> abr_hdr(new AbrInfo());
     int i;
-    qint32 layer_ID;
 
     QByteArray ba = dev->readAll();
     QBuffer buf(&ba);
@@ -572,34 +626,111 @@ bool KisAbrBrushCollection::loadFromDevice(QIODevice *dev)
     QDataStream abr(&buf);
 
 
-    if (!abr_read_content(abr, &abr_hdr)) {
+    if (!abr_read_content(abr, abr_hdr.data())) {
         warnKrita << "Error: cannot parse ABR file: " << filename();
         return false;
     }
 
-    if (!abr_supported_content(&abr_hdr)) {
-        warnKrita << "ERROR: unable to decode abr format version " << abr_hdr.version << "(subver " << abr_hdr.subversion << ")";
+    if (!abr_supported_content(abr_hdr.data())) {
+        warnKrita << "ERROR: unable to decode abr format version " << abr_hdr->version << "(subver " << abr_hdr->subversion << ")";
         return false;
     }
 
-    if (abr_hdr.count == 0) {
+    if (abr_hdr->count == 0) {
         errKrita << "ERROR: no sample brush found in " << filename();
         return false;
     }
 
-    image_ID = 123456;
-
-    for (i = 0; i < abr_hdr.count; i++) {
-        layer_ID = abr_brush_load(abr, &abr_hdr, QFileInfo(filename()).fileName(), image_ID, i + 1);
-        if (layer_ID == -1) {
-            warnKrita << "Warning: problem loading brush #" << i << " in " << filename();
+    /**
+     * Decoding of the tips (RLE-decompression, conversion into QImage
+     * and hashing) takes most of the time of loading a big ABR file,
+     * even though usually only a few brushes of the collection are
+     * actually used in the session. So we just remember where every
+     * brush is stored and decode it when it is requested.
+     */
+    const QString shortFilename = QFileInfo(filename()).fileName();
+
+    m_brushRecords.clear();
+    m_abrBrushes->clear();
+    m_allBrushesDecoded = false;
+
+    for (i = 0; i < abr_hdr->count && !abr.atEnd(); i++) {
+        BrushRecord record;
+        record.offset = buf.pos();
+        record.id = i + 1;
+
+        QString name;
+        const bool isSampledBrush = abr_hdr->version == 6 ?
+            abr_brush_scan_v6(abr, shortFilename, record.id, &name) :
+            abr_brush_scan_v12(abr, abr_hdr.data(), shortFilename, record.id, &name);
+
+        if (isSampledBrush) {
+            m_brushRecords.insert(name, record);
         }
     }
 
+    m_data = ba;
+    m_header = abr_hdr;
+
     return true;
 
 }
 
+KisAbrBrushSP KisAbrBrushCollection::decodeBrush(const QString &name)
+{
+    KisAbrBrushSP brush = m_abrBrushes->value(name);
+    if (brush || !m_brushRecords.contains(name)) {
+        return brush;
+    }
+
+    const BrushRecord record = m_brushRecords.value(name);
+
+    QBuffer buf(&m_data);
+    buf.open(QIODevice::ReadOnly);
+    buf.seek(record.offset);
+    QDataStream abr(&buf);
+
+    const qint32 layer_ID = abr_brush_load(abr, m_header.data(), QFileInfo(filename()).fileName(), 123456, record.id);
+    if (layer_ID == -1) {
+        warnKrita << "Warning: problem loading brush #" << record.id - 1 << " in " << filename();
+    }
+
+    return m_abrBrushes->value(name);
+}
+
+void KisAbrBrushCollection::decodeAllBrushes()
+{
+    if (m_allBrushesDecoded) return;
+
+    for (auto it = m_brushRecords.constBegin(); it != m_brushRecords.constEnd(); ++it) {
+        decodeBrush(it.key());
+    }
+
+    /**
+     * All the tips live in the brushes now, the raw data of the file
+     * is not needed anymore
+     */
+    m_data.clear();
+    m_allBrushesDecoded = true;
+}
+
+QList<KisAbrBrushSP> KisAbrBrushCollection::brushes() const
+{
+    const_cast<KisAbrBrushCollection*>(this)->decodeAllBrushes();
+    return m_abrBrushes->values();
+}
+
+QSharedPointer<QMap<QString, KisAbrBrushSP>> KisAbrBrushCollection::brushesMap() const
+{
+    const_cast<KisAbrBrushCollection*>(this)->decodeAllBrushes();
+    return m_abrBrushes;
+}
+
+KisAbrBrushSP KisAbrBrushCollection::brushByName(QString name) const
+{
+    return const_cast<KisAbrBrushCollection*>(this)->decodeBrush(name);
+}
+
 bool KisAbrBrushCollection::save()
 {
     return false;
@@ -617,8 +748,12 @@ bool KisAbrBrushCollection::isLoaded() const
 
 QImage KisAbrBrushCollection::image() const
 {
-    if (m_abrBrushes->size() > 0) {
-        return m_abrBrushes->values().first()->image();
+    // only the first brush is needed for the preview
+    for (auto it = m_brushRecords.constBegin(); it != m_brushRecords.constEnd(); ++it) {
+        KisAbrBrushSP brush = brushByName(it.key());
+        if (brush) {
+            return brush->image();
+        }
     }
     return QImage();
 }
@@ -9,7 +9,9 @@
 #define KIS_ABR_BRUSH_COLLECTION_H
 
 #include <QImage>
+#include <QByteArray>
 #include <QDataStream>
+#include <QMap>
 #include <QString>
 #include <kis_debug.h>
 
@@ -61,20 +63,17 @@ public:
      */
     QString defaultFileExtension() const;
 
-    QList<KisAbrBrushSP> brushes() const {
-        return m_abrBrushes->values();
-    }
+    /**
+     * The brush tips are decoded lazily: load() only indexes the
+     * records of the file, the tips are decoded when they are
+     * requested for the first time. brushes() and brushesMap() decode
+     * all the brushes of the collection.
+     */
+    QList<KisAbrBrushSP> brushes() const;
 
-    QSharedPointer<QMap<QString, KisAbrBrushSP>> brushesMap() const {
-        return m_abrBrushes;
-    }
+    QSharedPointer<QMap<QString, KisAbrBrushSP>> brushesMap() const;
 
-    KisAbrBrushSP brushByName(QString name) const {
-        if (m_abrBrushes->contains(name)) {
-            return m_abrBrushes.data()->operator[](name);
-        }
-        return KisAbrBrushSP();
-    }
+    KisAbrBrushSP brushByName(QString name) const;
 
     QDateTime lastModified() const {
         return m_lastModified;
@@ -95,10 +94,23 @@ private:
     qint32 abr_brush_load_v12(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 image_ID, qint32 id);
     quint32 abr_brush_load_v6(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 image_ID, qint32 id);
 
+    KisAbrBrushSP decodeBrush(const QString &name);
+    void decodeAllBrushes();
+
+    struct BrushRecord {
+        qint64 offset {0};
+        qint32 id {0};
+    };
+
     bool m_isLoaded;
     QDateTime m_lastModified;
     QString m_filename;
     QSharedPointer<QMap<QString, KisAbrBrushSP>> m_abrBrushes;
+
+    QByteArray m_data;
+    QSharedPointer<AbrInfo> m_header;
+    QMap<QString, BrushRecord> m_brushRecords;
+    bool m_allBrushesDecoded {false};
 };
 
 typedef QSharedPointer<KisAbrBrushCollection> KisAbrBrushCollectionSP;
@@ -224,6 +224,17 @@ QImage KisBrush::brushTipImage() const
     return d->brushTipImage;
 }
 
+qint64 KisBrush::approximateMemoryUsage() const
+{
+    /**
+     * Small brush tips are shared with the resource image. The image
+     * pyramid is created lazily on the first dab, so it isn't counted.
+     */
+    const QImage thumbnail = image();
+    return d->brushTipImage.sizeInBytes() +
+        (thumbnail.cacheKey() != d->brushTipImage.cacheKey() ? thumbnail.sizeInBytes() : 0);
+}
+
 qint32 KisBrush::width() const
 {
     return d->width;
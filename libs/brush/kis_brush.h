@@ -129,6 +129,8 @@ public:
      */
     virtual QImage brushTipImage() const;
 
+    qint64 approximateMemoryUsage() const override;
+
     /**
      * Is a paint device of the brush that should be used for generation
      * of the brush outline. Usually, it is the same device returned
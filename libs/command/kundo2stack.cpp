@@ -431,6 +431,21 @@ bool KUndo2Command::isMerged() const
     return !m_mergeCommandsVector.isEmpty();
 }
 
+qint64 KUndo2Command::memoryCost() const
+{
+    qint64 cost = 0;
+
+    Q_FOREACH (const KUndo2Command *cmd, d->child_list) {
+        cost += cmd->memoryCost();
+    }
+
+    Q_FOREACH (const KUndo2Command *cmd, m_mergeCommandsVector) {
+        cost += cmd->memoryCost();
+    }
+
+    return cost;
+}
+
 KUndo2CommandExtraData* KUndo2Command::extraData() const
 {
     return d->extraData.data();
@@ -605,10 +620,34 @@ void KUndo2QStack::purgeRedoState()
 
 bool KUndo2QStack::checkUndoLimit()
 {
-    if (m_undo_limit <= 0 || !m_macro_stack.isEmpty() || m_undo_limit >= m_command_list.count())
+    if (!m_macro_stack.isEmpty())
         return false;
 
-    int del_count = m_command_list.count() - m_undo_limit;
+    int del_count = 0;
+
+    if (m_undo_limit > 0 && m_undo_limit < m_command_list.count())
+        del_count = m_command_list.count() - m_undo_limit;
+
+    if (m_undo_memory_limit > 0) {
+        qint64 totalCost = 0;
+        for (int i = del_count; i < m_command_list.count(); ++i)
+            totalCost += m_command_list.at(i)->memoryCost();
+
+        /**
+         * The commands that can be redone and the most recent command
+         * are never evicted, even if they don't fit into the budget
+         * on their own
+         */
+        const int maxDelCount = qMin(m_index, m_command_list.count() - 1);
+
+        while (totalCost > m_undo_memory_limit && del_count < maxDelCount) {
+            totalCost -= m_command_list.at(del_count)->memoryCost();
+            ++del_count;
+        }
+    }
+
+    if (del_count <= 0)
+        return false;
 
     for (int i = 0; i < del_count; ++i)
         delete m_command_list.takeFirst();
@@ -632,7 +671,7 @@ bool KUndo2QStack::checkUndoLimit()
 */
 
 KUndo2QStack::KUndo2QStack(QObject *parent)
-    : QObject(parent), m_index(0), m_clean_index(0), m_group(0), m_undo_limit(0)
+    : QObject(parent), m_index(0), m_clean_index(0), m_group(0), m_undo_limit(0), m_undo_memory_limit(0)
     , m_useCumulativeUndoRedo(false)
 {
 #ifndef QT_NO_UNDOGROUP
@@ -1324,6 +1363,28 @@ int KUndo2QStack::undoLimit() const
     return m_undo_limit;
 }
 
+/*!
+    Sets the maximum amount of memory (in bytes) the undo data of the
+    commands on this stack may occupy, see KUndo2Command::memoryCost().
+    When the budget is exceeded, the oldest commands are deleted from
+    the bottom of the stack. The command that has just been pushed
+    and the commands that can be redone are never deleted. The default
+    value is 0, which means that there is no limit.
+
+    Unlike setUndoLimit(), the budget may be changed on a non-empty
+    stack. The new value is applied on the next push().
+*/
+
+void KUndo2QStack::setUndoMemoryLimit(qint64 limit)
+{
+    m_undo_memory_limit = limit;
+}
+
+qint64 KUndo2QStack::undoMemoryLimit() const
+{
+    return m_undo_memory_limit;
+}
+
 /*!
     \property KUndo2QStack::active
     \brief the active status of this stack.
@@ -123,6 +123,15 @@ public:
     virtual void undoMergedCommands();
     virtual void redoMergedCommands();
 
+    /**
+     * \return the approximate amount of memory (in bytes) occupied by
+     * the undo data of the command. The default implementation sums up
+     * the costs of the child and merged commands.
+     *
+     * \see KUndo2QStack::setUndoMemoryLimit()
+     */
+    virtual qint64 memoryCost() const;
+
     /**
      * \return user-defined object associated with the command
      *
@@ -193,6 +202,9 @@ public:
     void setUndoLimit(int limit);
     int undoLimit() const;
 
+    void setUndoMemoryLimit(qint64 limit);
+    qint64 undoMemoryLimit() const;
+
     const KUndo2Command *command(int index) const;
 
     void setUseCumulativeUndoRedo(bool value);
@@ -229,6 +241,7 @@ private:
     int m_clean_index;
     KUndo2Group *m_group;
     int m_undo_limit;
+    qint64 m_undo_memory_limit;
     bool m_useCumulativeUndoRedo;
     KisCumulativeUndoData m_cumulativeUndoData;
 
@@ -429,4 +429,50 @@ void TestKUndo2Stack::testCleanIndexBeforeMerge()
     QCOMPARE(stack.command(2)->isMerged(), false);
 }
 
+namespace {
+struct CostlyCommand : public KUndo2Command
+{
+    CostlyCommand(const QString &text, qint64 cost)
+        : KUndo2Command(kundo2_noi18n(text)),
+          m_cost(cost)
+    {
+    }
+
+    qint64 memoryCost() const override {
+        return m_cost;
+    }
+
+    qint64 m_cost;
+};
+}
+
+void TestKUndo2Stack::testUndoMemoryLimit()
+{
+    KUndo2Stack stack;
+    stack.setUndoMemoryLimit(100);
+
+    for (int i = 0; i < 5; i++) {
+        stack.push(new CostlyCommand(QString::number(i), 30));
+    }
+
+    // only the three most recent commands fit into the budget
+    QCOMPARE(stack.count(), 3);
+    QCOMPARE(stack.index(), stack.count());
+    QCOMPARE(stack.command(0)->text().toString(), QString("2"));
+
+    // a huge command evicts everything but itself
+    stack.push(new CostlyCommand("huge", 1000));
+
+    QCOMPARE(stack.count(), 1);
+    QCOMPARE(stack.index(), stack.count());
+    QCOMPARE(stack.command(0)->text().toString(), QString("huge"));
+
+    // the next command evicts the huge one
+    stack.push(new CostlyCommand("5", 30));
+
+    QCOMPARE(stack.count(), 1);
+    QCOMPARE(stack.index(), stack.count());
+    QCOMPARE(stack.command(0)->text().toString(), QString("5"));
+}
+
 SIMPLE_TEST_MAIN(TestKUndo2Stack)
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void testMaxGroupDuration();
     void testCleanIndexAfterMerge();
     void testCleanIndexBeforeMerge();
+    void testUndoMemoryLimit();
 };
 
 #endif // TESTKUNDO2STACK_H
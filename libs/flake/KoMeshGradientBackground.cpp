@@ -11,6 +11,7 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QDebug>
+#include <QMutexLocker>
 
 #include "KoMeshPatchesRenderer.h"
 
@@ -38,6 +39,12 @@ public:
     QScopedPointer<SvgMeshGradient> gradient;
     QTransform matrix;
     KoMeshPatchesRenderer *renderer;
+
+    /**
+     * The tiles of a vector layer are rasterized concurrently, so the
+     * same background may be painted from several threads at once
+     */
+    QMutex rendererMutex;
 };
 
 KoMeshGradientBackground::KoMeshGradientBackground(const SvgMeshGradient *gradient, const QTransform &matrix)
@@ -79,7 +86,9 @@ void KoMeshGradientBackground::paint(QPainter &painter,
         meshBoundingRect = gradient->boundingRect();
     }
 
-    if (d->renderer->patchImage()->isNull()) {
+    QMutexLocker l(&d->rendererMutex);
+
+    if (!d->renderer->isConfiguredFor(meshBoundingRect, painter.transform())) {
 
         d->renderer->configure(meshBoundingRect, painter.transform());
         SvgMeshArray *mesharray = gradient->getMeshArray().data();
@@ -27,15 +27,15 @@ public:
     void configure(QRectF gradientRect, const QTransform& painterTransform) {
 
         // NOTE: This is a necessary step to prevent loss of quality, because painterTransform is scaled.
+        const QSizeF scale = scaleOf(gradientRect, painterTransform);
+        QTransform scaledTransform = QTransform::fromScale(scale.width(), scale.height());
 
-        // we wish to scale the patch, but not translate, because patch should stay inside
-        // the boundingRect
-        QTransform painterTransformShifted = painterTransform *
-            QTransform::fromTranslate(painterTransform.dx(), painterTransform.dy()).inverted();
+        m_gradientRect = gradientRect;
+        m_scale = scale;
 
-        // we are applying transformation on a Unit rect, so we can extract scaling info only
-        QRectF unitRectScaled = painterTransformShifted.mapRect(QRectF(gradientRect.topLeft(), QSize(1, 1)));
-        QTransform scaledTransform = QTransform::fromScale(unitRectScaled.width(), unitRectScaled.height());
+        if (m_patchPainter.isActive()) {
+            m_patchPainter.end();
+        }
 
         // boundingRect of the scaled version
         QRectF scaledGradientRect = scaledTransform.mapRect(gradientRect);
@@ -53,6 +53,19 @@ public:
         m_patchPainter.setCompositionMode(QPainter::CompositionMode_Source);
     }
 
+    /**
+     * The rendered patches can be reused as long as the gradient keeps
+     * its rect and the painter keeps its scale, i.e. the image only
+     * needs to be updated once per zoom level.
+     */
+    bool isConfiguredFor(const QRectF &gradientRect, const QTransform &painterTransform) const {
+        if (m_patch.isNull() || m_gradientRect != gradientRect) return false;
+
+        const QSizeF scale = scaleOf(gradientRect, painterTransform);
+        return qFuzzyCompare(scale.width(), m_scale.width()) &&
+            qFuzzyCompare(scale.height(), m_scale.height());
+    }
+
     void fillPatch(const SvgMeshPatch *patch,
                    SvgMeshGradient::Shading type,
                    const SvgMeshArray *mesharray = nullptr,
@@ -120,9 +133,6 @@ public:
             }
 
         } else {
-            const QPainterPath outline = patch->getPath();
-            const QRectF patchRect = outline.boundingRect();
-
             quint8 mixed[4];
             cs->mixColorsOp()->mixColors(c[0], 4, mixed);
 
@@ -132,14 +142,24 @@ public:
             QPen pen(average);
             pen.setWidth(0);
             m_patchPainter.setPen(pen);
-
-            if (patchRect.width() <= 1 && patchRect.height() <= 1) {
-                m_patchPainter.drawPoint(patchRect.topLeft());
-                m_patchPainter.fillPath(outline, average);
-
+            m_patchPainter.setBrush(average);
+
+            /**
+             * The patches that cannot be subdivided anymore are smaller
+             * than a couple of pixels, so the curvature of their sides is
+             * not visible. Fill them as quads of their corners, which is
+             * much cheaper than flattening four Bezier curves per patch.
+             */
+            if (!verticalDiv && !horizontalDiv) {
+                const QPointF corners[4] = {
+                    patch->getStop(SvgMeshPatch::Top).point,
+                    patch->getStop(SvgMeshPatch::Right).point,
+                    patch->getStop(SvgMeshPatch::Bottom).point,
+                    patch->getStop(SvgMeshPatch::Left).point
+                };
+                m_patchPainter.drawPolygon(corners, 4);
             } else {
-                m_patchPainter.setBrush(average);
-                m_patchPainter.drawPath(outline);
+                m_patchPainter.drawPath(patch->getPath());
             }
         }
     }
@@ -617,8 +637,22 @@ public:
         return &m_patch;
     }
 
+private:
+    static QSizeF scaleOf(const QRectF &gradientRect, const QTransform &painterTransform) {
+        // we wish to scale the patch, but not translate, because patch should stay inside
+        // the boundingRect
+        QTransform painterTransformShifted = painterTransform *
+            QTransform::fromTranslate(painterTransform.dx(), painterTransform.dy()).inverted();
+
+        // we are applying transformation on a Unit rect, so we can extract scaling info only
+        QRectF unitRectScaled = painterTransformShifted.mapRect(QRectF(gradientRect.topLeft(), QSize(1, 1)));
+        return unitRectScaled.size();
+    }
+
 private:
     QImage m_patch;
+    QRectF m_gradientRect;
+    QSizeF m_scale;
     QPainter m_patchPainter;
     // TODO: make them local
     QVector<QVector<qreal>> m_alpha;
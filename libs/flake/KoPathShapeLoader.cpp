@@ -10,6 +10,51 @@
 #include <FlakeDebug.h>
 #include <kis_algebra_2d.h>
 
+namespace {
+
+/**
+ * Replaces the commas and the runs of whitespace with single spaces
+ * and trims the buffer, which is what QString::simplified() does, but
+ * without the intermediate copies of the path data
+ */
+void simplifyPathData(QByteArray &buffer)
+{
+    char *dst = buffer.data();
+    const char *src = buffer.constData();
+    const char *end = src + buffer.size();
+
+    bool pendingSpace = false;
+
+    for (; src < end; ++src) {
+        const char c = *src;
+
+        if (c == ',' || c == ' ' || (c >= '\t' && c <= '\r') || uchar(c) == 0x85 || uchar(c) == 0xa0) {
+            pendingSpace = dst != buffer.constData();
+        } else {
+            if (pendingSpace) {
+                *(dst++) = ' ';
+                pendingSpace = false;
+            }
+            *(dst++) = c;
+        }
+    }
+
+    buffer.truncate(dst - buffer.constData());
+}
+
+qreal powerOfTen(int exponent)
+{
+    // the powers up to 1e22 are represented exactly
+    static const qreal powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    return exponent <= 22 ? powers[exponent] : pow(qreal(10), qreal(exponent));
+}
+
+}
+
 class KoPathShapeLoaderPrivate
 {
 public:
@@ -42,11 +87,8 @@ public:
 void KoPathShapeLoaderPrivate::parseSvg(const QString &s, bool process)
 {
     if (!s.isEmpty()) {
-        QString d = s;
-        d.replace(',', ' ');
-        d = d.simplified();
-
-        const QByteArray buffer = d.toLatin1();
+        QByteArray buffer = s.toLatin1();
+        simplifyPathData(buffer);
         const char *ptr = buffer.constData();
         const char *end = buffer.constData() + buffer.length() + 1;
 
@@ -324,16 +366,17 @@ void KoPathShapeLoaderPrivate::parseSvg(const QString &s, bool process)
 // parses the coord into number and forwards to the next token
 const char * KoPathShapeLoaderPrivate::getCoord(const char *ptr, qreal &number)
 {
-    int integer, exponent;
-    qreal decimal, frac;
-    int sign, expsign;
-
-    exponent = 0;
-    integer = 0;
-    frac = 1.0;
-    decimal = 0;
-    sign = 1;
-    expsign = 1;
+    /**
+     * The digits are accumulated into an integer mantissa and scaled
+     * once by an exact power of ten, which is both faster and more
+     * precise than summing up the fractional digits one by one
+     */
+    const int maxMantissaDigits = 18;
+
+    quint64 mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    int sign = 1;
 
     // read the sign
     if (*ptr == '+')
@@ -344,17 +387,33 @@ const char * KoPathShapeLoaderPrivate::getCoord(const char *ptr, qreal &number)
     }
 
     // read the integer part
-    while (*ptr != '\0' && *ptr >= '0' && *ptr <= '9')
-        integer = (integer * 10) + *(ptr++) - '0';
+    while (*ptr >= '0' && *ptr <= '9') {
+        if (mantissaDigits < maxMantissaDigits) {
+            mantissa = mantissa * 10 + (*ptr - '0');
+            if (mantissa) ++mantissaDigits;
+        } else {
+            ++exponent;
+        }
+        ++ptr;
+    }
+
     if (*ptr == '.') { // read the decimals
         ++ptr;
-        while (*ptr != '\0' && *ptr >= '0' && *ptr <= '9')
-            decimal += (*(ptr++) - '0') * (frac *= 0.1);
+        while (*ptr >= '0' && *ptr <= '9') {
+            if (mantissaDigits < maxMantissaDigits) {
+                mantissa = mantissa * 10 + (*ptr - '0');
+                if (mantissa) ++mantissaDigits;
+                --exponent;
+            }
+            ++ptr;
+        }
     }
 
     if (*ptr == 'e' || *ptr == 'E') { // read the exponent part
         ++ptr;
 
+        int expsign = 1;
+
         // read the sign of the exponent
         if (*ptr == '+')
             ++ptr;
@@ -363,15 +422,23 @@ const char * KoPathShapeLoaderPrivate::getCoord(const char *ptr, qreal &number)
             expsign = -1;
         }
 
-        exponent = 0;
-        while (*ptr != '\0' && *ptr >= '0' && *ptr <= '9') {
-            exponent *= 10;
-            exponent += *ptr - '0';
+        int explicitExponent = 0;
+        while (*ptr >= '0' && *ptr <= '9') {
+            if (explicitExponent < 10000) {
+                explicitExponent = explicitExponent * 10 + (*ptr - '0');
+            }
             ++ptr;
         }
+        exponent += expsign * explicitExponent;
+    }
+
+    number = qreal(mantissa);
+    if (exponent > 0) {
+        number *= powerOfTen(exponent);
+    } else if (exponent < 0) {
+        number /= powerOfTen(-exponent);
     }
-    number = integer + decimal;
-    number *= sign * pow((qreal)10, qreal(expsign * exponent));
+    number *= sign;
 
     // skip the following space
     if (*ptr == ' ')
@@ -16,6 +16,10 @@
 #include <QPointF>
 #include <QRectF>
 #include <QVarLengthArray>
+#include <QtMath>
+
+#include <algorithm>
+#include <numeric>
 
 #include <QDebug>
 #include "kis_assert.h"
@@ -62,6 +66,19 @@ public:
      */
     virtual void insert(const QRectF& bb, const T& data);
 
+    /**
+     * @brief Replace the content of the tree with the given data items
+     *
+     * The tree is packed bottom-up with the Sort-Tile-Recursive algorithm,
+     * which is much faster than inserting the items one by one and gives
+     * fuller nodes with less overlap. The items keep the insertion order
+     * of the vectors.
+     *
+     * @param bbs the bounding boxes of the data items
+     * @param data the data items
+     */
+    void bulkLoad(const QVector<QRectF> &bbs, const QVector<T> &data);
+
     /**
      * @brief Show if a shape is a part of the tree
      * @param data
@@ -327,6 +344,10 @@ class LeafNode : virtual public Node
     QPair<int, int> pickNext(Node * node, QVector<bool> & marker, Node * group1, Node * group2);
     virtual void adjustTree(Node * node1, Node * node2);
     void insertHelper(const QRectF& bb, const T& data, int id);
+    static QRectF normalizeBoundingBox(const QRectF &bb);
+
+    // methods for bulk loading
+    QVector<int> sortTileRecursive(const QVector<QPointF> &centers, QVector<int> &order) const;
 
     // methods for delete
     void insert(Node * node);
@@ -367,24 +388,7 @@ void KoRTree<T>::insert(const QRectF& bb, const T& data)
 template <typename T>
 void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
 {
-    QRectF nbb(bb.normalized());
-    // This has to be done as it is not possible to use QRectF::united() with a isNull()
-    if (nbb.isNull()) {
-        qWarning() <<  "KoRTree::insert boundingBox isNull setting size to" << nbb.size();
-
-        nbb.setWidth(0.0001);
-        nbb.setHeight(0.0001);
-    }
-    else {
-        // This has to be done as QRectF::intersects() return false if the rect does not have any area overlapping.
-        // If there is no width or height there is no area and therefore no overlapping.
-        if ( nbb.width() == 0 ) {
-            nbb.setWidth(0.0001);
-        }
-        if ( nbb.height() == 0 ) {
-            nbb.setHeight(0.0001);
-        }
-    }
+    const QRectF nbb = normalizeBoundingBox(bb);
 
     LeafNode * leaf = m_root->chooseLeaf(nbb);
     //debugFlake << " leaf" << leaf->nodeId() << nbb;
@@ -410,6 +414,133 @@ void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
     }
 }
 
+template <typename T>
+QRectF KoRTree<T>::normalizeBoundingBox(const QRectF &bb)
+{
+    QRectF nbb(bb.normalized());
+    // This has to be done as it is not possible to use QRectF::united() with a isNull()
+    if (nbb.isNull()) {
+        qWarning() <<  "KoRTree::insert boundingBox isNull setting size to" << nbb.size();
+
+        nbb.setWidth(0.0001);
+        nbb.setHeight(0.0001);
+    }
+    else {
+        // This has to be done as QRectF::intersects() return false if the rect does not have any area overlapping.
+        // If there is no width or height there is no area and therefore no overlapping.
+        if ( nbb.width() == 0 ) {
+            nbb.setWidth(0.0001);
+        }
+        if ( nbb.height() == 0 ) {
+            nbb.setHeight(0.0001);
+        }
+    }
+    return nbb;
+}
+
+template <typename T>
+void KoRTree<T>::bulkLoad(const QVector<QRectF> &bbs, const QVector<T> &data)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(bbs.size() == data.size());
+
+    clear();
+    if (data.isEmpty()) return;
+
+    const int firstId = LeafNode::dataIdCounter;
+    LeafNode::dataIdCounter += data.size();
+
+    QVector<QRectF> nbbs(data.size());
+    QVector<QPointF> centers(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        nbbs[i] = normalizeBoundingBox(bbs[i]);
+        centers[i] = nbbs[i].center();
+    }
+
+    QVector<int> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    QVector<int> groups = sortTileRecursive(centers, order);
+
+    QVector<Node *> nodes;
+    for (int i = 0; i < groups.size() - 1; ++i) {
+        LeafNode *leaf = createLeafNode(m_capacity + 1, 0, 0);
+        for (int j = groups[i]; j < groups[i + 1]; ++j) {
+            const int index = order[j];
+
+            // check if the shape is not already registered
+            KIS_SAFE_ASSERT_RECOVER_NOOP(!m_leafMap.contains(data[index]));
+
+            leaf->insert(nbbs[index], data[index], firstId + index);
+            m_leafMap[data[index]] = leaf;
+        }
+        nodes << leaf;
+    }
+
+    /**
+     * Pack the nodes of every level the same way until only the
+     * root is left
+     */
+    int level = 0;
+    while (nodes.size() > 1) {
+        ++level;
+
+        centers.resize(nodes.size());
+        for (int i = 0; i < nodes.size(); ++i) {
+            centers[i] = nodes[i]->boundingBox().center();
+        }
+
+        order.resize(nodes.size());
+        std::iota(order.begin(), order.end(), 0);
+        groups = sortTileRecursive(centers, order);
+
+        QVector<Node *> parents;
+        for (int i = 0; i < groups.size() - 1; ++i) {
+            NonLeafNode *parent = createNonLeafNode(m_capacity + 1, level, 0);
+            for (int j = groups[i]; j < groups[i + 1]; ++j) {
+                Node *node = nodes[order[j]];
+                parent->insert(node->boundingBox(), node);
+            }
+            parents << parent;
+        }
+        nodes = parents;
+    }
+
+    delete m_root;
+    m_root = nodes.first();
+}
+
+template <typename T>
+QVector<int> KoRTree<T>::sortTileRecursive(const QVector<QPointF> &centers, QVector<int> &order) const
+{
+    const int count = order.size();
+    const int numNodes = (count + m_capacity - 1) / m_capacity;
+    const int numSlices = qCeil(qSqrt(qreal(numNodes)));
+    const int sliceSize = (numNodes + numSlices - 1) / numSlices * m_capacity;
+
+    std::sort(order.begin(), order.end(),
+              [&centers] (int lhs, int rhs) { return centers[lhs].x() < centers[rhs].x(); });
+
+    /**
+     * Every vertical slice is sorted by y and split into the nodes
+     * evenly, so that only the last slice may have underfilled nodes
+     */
+    QVector<int> groups;
+    for (int sliceStart = 0; sliceStart < count; sliceStart += sliceSize) {
+        const int sliceEnd = qMin(count, sliceStart + sliceSize);
+
+        std::sort(order.begin() + sliceStart, order.begin() + sliceEnd,
+                  [&centers] (int lhs, int rhs) { return centers[lhs].y() < centers[rhs].y(); });
+
+        const int sliceCount = sliceEnd - sliceStart;
+        const int numGroups = (sliceCount + m_capacity - 1) / m_capacity;
+        for (int i = 0; i < numGroups; ++i) {
+            groups << sliceStart + i * sliceCount / numGroups;
+        }
+    }
+    groups << count;
+
+    return groups;
+}
+
 template <typename T>
 void KoRTree<T>::insert(Node * node)
 {
@@ -356,6 +356,50 @@ void KoShapeManager::Private::unlinkFromShapesRecursively(const QList<KoShape*>
     }
 }
 
+void KoShapeManager::Private::linkToShapesRecursively(KoShape *shape, QVector<KoShape *> &addedShapes)
+{
+    if (shapes.contains(shape))
+        return;
+    shape->addShapeManager(q);
+    shapes.append(shape);
+    addedShapes.append(shape);
+
+    // add the children of a KoShapeContainer
+    KoShapeContainer *container = dynamic_cast<KoShapeContainer*>(shape);
+
+    if (container) {
+        Q_FOREACH (KoShape *containerShape, container->shapes()) {
+            linkToShapesRecursively(containerShape, addedShapes);
+        }
+    }
+}
+
+void KoShapeManager::Private::insertIntoTree(const QVector<KoShape *> &addedShapes, bool treeIsEmpty)
+{
+    QVector<QRectF> rects;
+    QVector<KoShape*> treeShapes;
+
+    Q_FOREACH (KoShape *shape, addedShapes) {
+        if (shapeUsedInRenderingTree(shape)) {
+            rects.append(shape->boundingRect());
+            treeShapes.append(shape);
+        }
+    }
+
+    /**
+     * A whole layer is usually added at once when a document is
+     * loaded, so pack the tree in one go instead of splitting the
+     * nodes on every insertion
+     */
+    if (treeIsEmpty && treeShapes.size() > 1) {
+        tree.bulkLoad(rects, treeShapes);
+    } else {
+        for (int i = 0; i < treeShapes.size(); ++i) {
+            tree.insert(rects[i], treeShapes[i]);
+        }
+    }
+}
+
 KoShapeManager::~KoShapeManager()
 {
     d->unlinkFromShapesRecursively(d->shapes);
@@ -381,39 +425,45 @@ void KoShapeManager::setShapes(const QList<KoShape *> &shapes, Repaint repaint)
         d->shapes.clear();
     }
 
-    Q_FOREACH (KoShape *shape, shapes) {
-        addShape(shape, repaint);
-    }
-}
+    QVector<KoShape*> addedShapes;
 
-void KoShapeManager::addShape(KoShape *shape, Repaint repaint)
-{
     {
         QMutexLocker l1(&d->shapesMutex);
 
-        if (d->shapes.contains(shape))
-            return;
-        shape->addShapeManager(this);
-        d->shapes.append(shape);
+        const bool treeIsEmpty = d->shapes.isEmpty();
 
-        if (shapeUsedInRenderingTree(shape)) {
-            QMutexLocker l2(&d->treeMutex);
-
-            QRectF br(shape->boundingRect());
-            d->tree.insert(br, shape);
+        Q_FOREACH (KoShape *shape, shapes) {
+            d->linkToShapesRecursively(shape, addedShapes);
         }
+
+        QMutexLocker l2(&d->treeMutex);
+        d->insertIntoTree(addedShapes, treeIsEmpty);
     }
 
     if (repaint == PaintShapeOnAdd) {
-        shape->update();
+        Q_FOREACH (KoShape *shape, addedShapes) {
+            shape->update();
+        }
     }
+}
 
-    // add the children of a KoShapeContainer
-    KoShapeContainer *container = dynamic_cast<KoShapeContainer*>(shape);
+void KoShapeManager::addShape(KoShape *shape, Repaint repaint)
+{
+    QVector<KoShape*> addedShapes;
 
-    if (container) {
-        foreach (KoShape *containerShape, container->shapes()) {
-            addShape(containerShape, repaint);
+    {
+        QMutexLocker l1(&d->shapesMutex);
+
+        const bool treeIsEmpty = d->shapes.isEmpty();
+        d->linkToShapesRecursively(shape, addedShapes);
+
+        QMutexLocker l2(&d->treeMutex);
+        d->insertIntoTree(addedShapes, treeIsEmpty);
+    }
+
+    if (repaint == PaintShapeOnAdd) {
+        Q_FOREACH (KoShape *shape, addedShapes) {
+            shape->update();
         }
     }
 }
@@ -52,6 +52,20 @@ public:
      */
     void unlinkFromShapesRecursively(const QList<KoShape *> &shapes);
 
+    /**
+     * Recursively attach the shape and its children to this shape manager.
+     * The shapes that were not known yet are appended to \p addedShapes.
+     * Should be called with shapesMutex locked, the tree is not touched.
+     */
+    void linkToShapesRecursively(KoShape *shape, QVector<KoShape *> &addedShapes);
+
+    /**
+     * Add the new shapes to the tree. When the tree is still empty, it is
+     * packed in bulk instead of inserting the shapes one by one.
+     * Should be called with shapesMutex and treeMutex locked.
+     */
+    void insertIntoTree(const QVector<KoShape *> &addedShapes, bool treeIsEmpty);
+
     QList<KoShape *> shapes;
     KoSelection *selection;
     KoCanvasBase *canvas;
@@ -12,7 +12,11 @@
 #include <hb-ft.h>
 #include FT_TRUETYPE_TABLES_H
 
+#include <QDataStream>
+#include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
 
 
 /**
@@ -219,6 +223,27 @@ QDebug operator<<(QDebug dbg, const FontFamilyNode &node) {
     return dbg.space();
 }
 
+namespace {
+
+/**
+ * The information read from a single font file, i.e. everything
+ * addFontFromFile() needs to sort the file into the collection.
+ */
+struct FontFileNodes {
+    FontFamilyNode fontFamily;
+    FontFamilyNode typographicFamily;
+    FontFamilyNode wwsFamily;
+    bool isWWSFamilyWithoutName = false;
+    qint64 fileSize = -1;
+};
+
+QString fontFileKey(const QString &filename, int index)
+{
+    return QString::number(index) + ':' + filename;
+}
+
+}
+
 struct KoFFWWSConverter::Private {
     Private() {}
 
@@ -254,6 +279,10 @@ struct KoFFWWSConverter::Private {
      * if it cannot match the wws name. Similarly, if a full font name (yes, that exists too) has been used, this will be prioritized).
      */
     KisForest<FontFamilyNode> fontFamilyCollection;
+
+    QSet<QString> addedFontFiles;
+    QHash<QString, FontFileNodes> fontFileCache;
+    bool fontFileCacheChanged = false;
 };
 
 KoFFWWSConverter::KoFFWWSConverter()
@@ -338,16 +367,17 @@ bool KoFFWWSConverter::addFontFromPattern(const FcPattern *pattern, FT_LibrarySP
     return success;
 }
 
-bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index, FT_LibrarySP freeTypeLibrary) {
+namespace {
+
+bool readFontFile(const QString &filename, const int index, FT_LibrarySP freeTypeLibrary, FontFileNodes &nodes)
+{
+    FontFamilyNode &fontFamily = nodes.fontFamily;
+    FontFamilyNode &typographicFamily = nodes.typographicFamily;
+    FontFamilyNode &wwsFamily = nodes.wwsFamily;
+    bool &isWWSFamilyWithoutName = nodes.isWWSFamilyWithoutName;
 
-    FontFamilyNode fontFamily;
     fontFamily.fileName = filename;
     fontFamily.fileIndex = index;
-    for (auto it = d->fontFamilyCollection.begin(); it != d->fontFamilyCollection.end(); it++) {
-        if (it->fileName == fontFamily.fileName && it->fileIndex == fontFamily.fileIndex) {
-            return true;
-        }
-    }
 
     FT_Face f = nullptr;
     FT_FaceSP face;
@@ -361,9 +391,6 @@ bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index,
     fontFamily.fontFamily = face->family_name;
     fontFamily.fontStyle = face->style_name;
     fontFamily.lastModified = QFileInfo(fontFamily.fileName).lastModified();
-    FontFamilyNode typographicFamily;
-    FontFamilyNode wwsFamily;
-    bool isWWSFamilyWithoutName = false;
 
     if (!FT_IS_SFNT(face.data())) {
         fontFamily.type = FT_IS_SCALABLE(face.data())? KoSvgText::Type1FontType: KoSvgText::BDFFontType;
@@ -565,19 +592,29 @@ bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index,
     wwsFamily.type = fontFamily.type;
     typographicFamily.type = typographicFamily.type;
 
+    return true;
+}
+
+void insertFontNodes(KisForest<FontFamilyNode> &collection, FontFileNodes nodes)
+{
+    FontFamilyNode &fontFamily = nodes.fontFamily;
+    FontFamilyNode &typographicFamily = nodes.typographicFamily;
+    FontFamilyNode &wwsFamily = nodes.wwsFamily;
+    const bool isWWSFamilyWithoutName = nodes.isWWSFamilyWithoutName;
+
     if (typographicFamily.fontFamily.isEmpty() && fontFamily.fontFamily.isEmpty()) {
-        d->fontFamilyCollection.insert(d->fontFamilyCollection.childEnd(), fontFamily);
+        collection.insert(collection.childEnd(), fontFamily);
     } else {
         // find potential typographic family
-        auto it = d->fontFamilyCollection.childBegin();
-        for (; it != d->fontFamilyCollection.childEnd(); it++) {
+        auto it = collection.childBegin();
+        for (; it != collection.childEnd(); it++) {
             if (!typographicFamily.fontFamily.isEmpty() && it->fontFamily == typographicFamily.fontFamily) {
                 break;
             } else if (it->fontFamily == fontFamily.fontFamily) {
                 break;
             }
         }
-        if (it != d->fontFamilyCollection.childEnd()) {
+        if (it != collection.childEnd()) {
 
             if (isWWSFamilyWithoutName) {
                 wwsFamily.fontFamily = fontFamily.fontFamily;
@@ -591,10 +628,10 @@ bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index,
                     }
                 }
                 if (wws != childEnd(it)) {
-                    d->fontFamilyCollection.insert(childEnd(wws), fontFamily);
+                    collection.insert(childEnd(wws), fontFamily);
                 } else {
-                    auto wwsNew = d->fontFamilyCollection.insert(childEnd(it), wwsFamily);
-                    d->fontFamilyCollection.insert(childEnd(wwsNew), fontFamily);
+                    auto wwsNew = collection.insert(childEnd(it), wwsFamily);
+                    collection.insert(childEnd(wwsNew), fontFamily);
                 }
             } else if (!fontFamily.pixelSizes.isEmpty()) {
                 // sort any pixel sizes into the appropriate family.
@@ -611,28 +648,245 @@ bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index,
                     }
                 }
                 if (pixel == childEnd(it)) {
-                    d->fontFamilyCollection.insert(childEnd(it), fontFamily);
+                    collection.insert(childEnd(it), fontFamily);
                 }
 
             } else {
-                d->fontFamilyCollection.insert(childEnd(it), fontFamily);
+                collection.insert(childEnd(it), fontFamily);
             }
         } else {
-            auto typographic = d->fontFamilyCollection.insert(d->fontFamilyCollection.childEnd(), typographicFamily);
+            auto typographic = collection.insert(collection.childEnd(), typographicFamily);
             if (isWWSFamilyWithoutName) {
                 wwsFamily.fontFamily = fontFamily.fontFamily;
             }
             if (!wwsFamily.fontFamily.isEmpty()) {
-                auto wwsNew = d->fontFamilyCollection.insert(childEnd(typographic), wwsFamily);
-                d->fontFamilyCollection.insert(childEnd(wwsNew), fontFamily);
+                auto wwsNew = collection.insert(childEnd(typographic), wwsFamily);
+                collection.insert(childEnd(wwsNew), fontFamily);
             } else {
-                d->fontFamilyCollection.insert(childEnd(typographic), fontFamily);
+                collection.insert(childEnd(typographic), fontFamily);
             }
         }
     }
+}
+
+/**
+ * The font file cache keeps the result of reading the font files with
+ * FreeType and HarfBuzz between the sessions. Reading thousands of files
+ * on startup takes a lot of time, but the files rarely change.
+ *
+ * Only the data read by readFontFile() is stored, the languages and the
+ * sample strings come from Fontconfig, which has its own cache.
+ */
+const quint32 fontFileCacheMagic = 0x4b464643; // "KFFC"
+const quint32 fontFileCacheVersion = 1;
+
+void writeLocalizedNames(QDataStream &s, const QHash<QLocale, QString> &names)
+{
+    s << qint32(names.size());
+    for (auto it = names.constBegin(); it != names.constEnd(); ++it) {
+        s << it.key().name() << it.value();
+    }
+}
+
+void readLocalizedNames(QDataStream &s, QHash<QLocale, QString> &names)
+{
+    qint32 size = 0;
+    s >> size;
+    for (qint32 i = 0; i < size && s.status() == QDataStream::Ok; i++) {
+        QString locale;
+        QString name;
+        s >> locale >> name;
+        names.insert(QLocale(locale), name);
+    }
+}
+
+void writeNode(QDataStream &s, const FontFamilyNode &node)
+{
+    s << node.fontFamily << node.fontStyle << node.fileName << qint32(node.fileIndex) << node.lastModified;
+
+    writeLocalizedNames(s, node.localizedFontFamilies);
+    writeLocalizedNames(s, node.localizedFontStyle);
+    writeLocalizedNames(s, node.localizedTypographicStyle);
+    writeLocalizedNames(s, node.localizedWWSStyle);
+    writeLocalizedNames(s, node.localizedFullName);
+
+    s << qint32(node.axes.size());
+    for (const KoSvgText::FontFamilyAxis &axis : node.axes) {
+        s << axis.tag << axis.min << axis.max << axis.value << axis.defaultValue
+          << axis.variableAxis << axis.axisHidden;
+        writeLocalizedNames(s, axis.localizedLabels);
+    }
+
+    s << qint32(node.styleInfo.size());
+    for (const KoSvgText::FontFamilyStyleInfo &style : node.styleInfo) {
+        s << style.instanceCoords << style.isItalic << style.isOblique;
+        writeLocalizedNames(s, style.localizedLabels);
+    }
+
+    s << node.pixelSizes;
+
+    s << node.sizeInfo.isSet << node.sizeInfo.os2table << qint32(node.sizeInfo.subFamilyID)
+      << node.sizeInfo.low << node.sizeInfo.high << node.sizeInfo.designSize;
+    writeLocalizedNames(s, node.sizeInfo.localizedLabels);
+
+    s << node.isItalic << node.isOblique << qint32(node.type) << node.isVariable
+      << node.colorClrV0 << node.colorClrV1 << node.colorSVG << node.colorBitMap;
+}
+
+void readNode(QDataStream &s, FontFamilyNode &node)
+{
+    qint32 fileIndex = 0;
+    s >> node.fontFamily >> node.fontStyle >> node.fileName >> fileIndex >> node.lastModified;
+    node.fileIndex = fileIndex;
+
+    readLocalizedNames(s, node.localizedFontFamilies);
+    readLocalizedNames(s, node.localizedFontStyle);
+    readLocalizedNames(s, node.localizedTypographicStyle);
+    readLocalizedNames(s, node.localizedWWSStyle);
+    readLocalizedNames(s, node.localizedFullName);
+
+    qint32 numAxes = 0;
+    s >> numAxes;
+    for (qint32 i = 0; i < numAxes && s.status() == QDataStream::Ok; i++) {
+        KoSvgText::FontFamilyAxis axis;
+        s >> axis.tag >> axis.min >> axis.max >> axis.value >> axis.defaultValue
+          >> axis.variableAxis >> axis.axisHidden;
+        readLocalizedNames(s, axis.localizedLabels);
+        node.axes.insert(axis.tag, axis);
+    }
+
+    qint32 numStyles = 0;
+    s >> numStyles;
+    for (qint32 i = 0; i < numStyles && s.status() == QDataStream::Ok; i++) {
+        KoSvgText::FontFamilyStyleInfo style;
+        s >> style.instanceCoords >> style.isItalic >> style.isOblique;
+        readLocalizedNames(s, style.localizedLabels);
+        node.styleInfo.append(style);
+    }
+
+    s >> node.pixelSizes;
+
+    qint32 subFamilyID = 0;
+    s >> node.sizeInfo.isSet >> node.sizeInfo.os2table >> subFamilyID
+      >> node.sizeInfo.low >> node.sizeInfo.high >> node.sizeInfo.designSize;
+    node.sizeInfo.subFamilyID = subFamilyID;
+    readLocalizedNames(s, node.sizeInfo.localizedLabels);
+
+    qint32 type = 0;
+    s >> node.isItalic >> node.isOblique >> type >> node.isVariable
+      >> node.colorClrV0 >> node.colorClrV1 >> node.colorSVG >> node.colorBitMap;
+    node.type = KoSvgText::FontFormatType(type);
+}
+
+}
+
+bool KoFFWWSConverter::addFontFromFile(const QString &filename, const int index, FT_LibrarySP freeTypeLibrary) {
+
+    const QString key = fontFileKey(filename, index);
+    if (d->addedFontFiles.contains(key)) {
+        return true;
+    }
+
+    const QFileInfo fileInfo(filename);
+    FontFileNodes nodes;
+
+    auto cached = d->fontFileCache.constFind(key);
+    if (cached != d->fontFileCache.constEnd()
+        && cached->fileSize == fileInfo.size()
+        && cached->fontFamily.lastModified == fileInfo.lastModified()) {
+
+        nodes = *cached;
+    } else {
+        if (!readFontFile(filename, index, freeTypeLibrary, nodes)) {
+            return false;
+        }
+
+        nodes.fileSize = fileInfo.size();
+        d->fontFileCache.insert(key, nodes);
+        d->fontFileCacheChanged = true;
+    }
+
+    d->addedFontFiles.insert(key);
+    insertFontNodes(d->fontFamilyCollection, nodes);
+
+    return true;
+}
+
+bool KoFFWWSConverter::loadFontFileCache(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 size = 0;
+    s >> magic >> version >> size;
+
+    if (magic != fontFileCacheMagic || version != fontFileCacheVersion) {
+        return false;
+    }
+
+    QHash<QString, FontFileNodes> cache;
+
+    for (qint32 i = 0; i < size && s.status() == QDataStream::Ok; i++) {
+        FontFileNodes nodes;
+        qint64 fileSize = -1;
+        s >> nodes.isWWSFamilyWithoutName >> fileSize;
+        nodes.fileSize = fileSize;
+        readNode(s, nodes.fontFamily);
+        readNode(s, nodes.typographicFamily);
+        readNode(s, nodes.wwsFamily);
+
+        cache.insert(fontFileKey(nodes.fontFamily.fileName, nodes.fontFamily.fileIndex), nodes);
+    }
+
+    if (s.status() != QDataStream::Ok) {
+        qWarning() << "Font file cache" << fileName << "is corrupted, ignoring it";
+        return false;
+    }
+
+    d->fontFileCache = cache;
+    d->fontFileCacheChanged = false;
     return true;
 }
 
+bool KoFFWWSConverter::saveFontFileCache(const QString &fileName) const
+{
+    /**
+     * The entries of the removed font files are dropped on saving, so
+     * the cache doesn't grow forever
+     */
+    if (!d->fontFileCacheChanged && d->fontFileCache.size() == d->addedFontFiles.size()) {
+        return true;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open font file cache" << fileName << "for writing";
+        return false;
+    }
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_12);
+
+    s << fontFileCacheMagic << fontFileCacheVersion << qint32(d->addedFontFiles.size());
+
+    Q_FOREACH (const QString &key, d->addedFontFiles) {
+        const FontFileNodes nodes = d->fontFileCache.value(key);
+        s << nodes.isWWSFamilyWithoutName << nodes.fileSize;
+        writeNode(s, nodes.fontFamily);
+        writeNode(s, nodes.typographicFamily);
+        writeNode(s, nodes.wwsFamily);
+    }
+
+    return file.commit();
+}
+
 #include <KoWritingSystemUtils.h>
 void KoFFWWSConverter::addSupportedLanguagesByFile(const QString &filename, const int index, const QList<QLocale> &supportedLanguages, FcCharSet *set)
 {
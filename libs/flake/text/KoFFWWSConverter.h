@@ -73,6 +73,16 @@ public:
     /// and other font features.
     bool addFontFromFile(const QString &filename, const int index, FT_LibrarySP freeTypeLibrary);
 
+    /**
+     * Loads the information about the font files read in the previous
+     * sessions. addFontFromFile() then skips reading the files that
+     * have not been modified since.
+     */
+    bool loadFontFileCache(const QString &fileName);
+
+    /// Saves the information about the font files added to the converter.
+    bool saveFontFileCache(const QString &fileName) const;
+
     void addSupportedLanguagesByFile(const QString &filename, const int index, const QList<QLocale> &supportedLanguages, FcCharSet *set);
 
     /// Sort any straggling fonts into WWSFamilies.
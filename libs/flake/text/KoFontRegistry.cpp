@@ -63,6 +63,7 @@ private:
         QHash<QString, FcPatternSP> m_patterns;
         QHash<QString, FcFontSetSP> m_fontSets;
         QHash<QString, FT_FaceSP> m_faces;
+        QHash<FT_Face, QString> m_faceKeys;
         QHash<QString, QVector<KoFFWWSConverter::FontFileEntry>> m_suggestedFiles;
         QHash<QString, KoSvgText::FontMetrics> m_fontMetrics;
 
@@ -177,6 +178,13 @@ public:
         return m_data.localData()->m_faces;
     }
 
+    QHash<FT_Face, QString> &faceKeys()
+    {
+        if (!m_data.hasLocalData())
+            initialize();
+        return m_data.localData()->m_faceKeys;
+    }
+
     FcConfigSP config() const
     {
         return m_config;
@@ -195,9 +203,14 @@ public:
         FcObjectSet *objectSet = FcObjectSetBuild(FC_FAMILY, FC_FILE, FC_INDEX, FC_LANG, FC_CHARSET, nullptr);
         FcFontSetSP allFonts(FcFontList(m_config.data(), FcPatternCreate(), objectSet));
 
+        const QString fontFileCache = KoResourcePaths::saveLocation("cache", "/fonts/", true) + "fontfiles.cache";
+        fontFamilyConverter->loadFontFileCache(fontFileCache);
+
         for (int j = 0; j < allFonts->nfont; j++) {
             fontFamilyConverter->addFontFromPattern(allFonts->fonts[j], library());
         }
+
+        fontFamilyConverter->saveFontFileCache(fontFileCache);
         fontFamilyConverter->addGenericFamily("serif");
         fontFamilyConverter->addGenericFamily("sans-serif");
         fontFamilyConverter->addGenericFamily("monospace");
@@ -550,6 +563,7 @@ std::vector<FT_FaceSP> KoFontRegistry::facesForCSSValues(QVector<int> &lengths,
                 configureFaces({face}, info.size, info.fontSizeAdjust, xRes, yRes, info.computedAxisSettings());
                 faces.emplace_back(face);
                 d->typeFaces().insert(fontCacheEntry, face);
+                d->faceKeys().insert(face.data(), fontCacheEntry);
             }
         }
     }
@@ -1091,6 +1105,11 @@ KoSvgText::FontMetrics KoFontRegistry::generateFontMetrics(FT_FaceSP face, bool
     return metrics;
 }
 
+QString KoFontRegistry::faceCacheKey(FT_Face face) const
+{
+    return d->faceKeys().value(face);
+}
+
 int32_t KoFontRegistry::loadFlagsForFace(FT_Face face, bool isHorizontal, int32_t loadFlags, const KoSvgText::TextRendering rendering)
 {
     FT_Int32 faceLoadFlags = loadFlags;
@@ -110,6 +110,16 @@ public:
 
     static int32_t loadFlagsForFace(FT_Face face, bool isHorizontal = true, int32_t loadFlags = 0, const KoSvgText::TextRendering rendering = KoSvgText::RenderingAuto);
 
+    /**
+     * @brief faceCacheKey
+     * @param face a face returned by facesForCSSValues() in the current thread.
+     * @return the string identifying the font file, the face index, the size
+     * and the variation of the face. The key is the same for the faces
+     * loaded in different threads, so it can be used to share data derived
+     * from the face between the threads. Empty for unknown faces.
+     */
+    QString faceCacheKey(FT_Face face) const;
+
     // For PSD we only get the postscript name, and we'll need a bit
     // more information to get a proper css representation.
     KoCSSFontInfo getCssDataForPostScriptName (const QString postScriptName,
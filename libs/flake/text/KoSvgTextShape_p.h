@@ -492,6 +492,60 @@ public:
     bool isBidi = false;
     QPointF initialTextPosition = QPointF();
 
+    /**
+     * Everything the shaping stage of the layout depends on. The flow of
+     * the text (inline-size, shape-inside) and the positions of the text
+     * paths are not part of it.
+     */
+    struct ShapingKey {
+        QString text;
+        QVector<bool> collapseChars;
+        QVector<QPair<int, int>> clusterToOriginalString;
+        KoSvgTextProperties rootProperties;
+        QVector<KoSvgTextProperties> chunkProperties;
+        QVector<int> chunkSizes;
+        QVector<QColor> chunkFillColors;
+        QVector<bool> chunkFirstTextInPath;
+        QVector<KoSvgText::CharTransformation> resolvedTransforms;
+        int xRes = 0;
+        int yRes = 0;
+        bool disableFontMatching = false;
+
+        bool operator==(const ShapingKey &rhs) const {
+            return text == rhs.text
+                && collapseChars == rhs.collapseChars
+                && clusterToOriginalString == rhs.clusterToOriginalString
+                && rootProperties == rhs.rootProperties
+                && chunkProperties == rhs.chunkProperties
+                && chunkSizes == rhs.chunkSizes
+                && chunkFillColors == rhs.chunkFillColors
+                && chunkFirstTextInPath == rhs.chunkFirstTextInPath
+                && resolvedTransforms == rhs.resolvedTransforms
+                && xRes == rhs.xRes
+                && yRes == rhs.yRes
+                && disableFontMatching == rhs.disableFontMatching;
+        }
+    };
+
+    /**
+     * Shaping and loading of the glyphs take most of the time of the
+     * layout, so their results are kept for the next relayout. When only
+     * the flow of the text changes (e.g. the user resizes the inline-size
+     * or the shape the text is flowed into), the glyphs are reused.
+     */
+    struct ShapingCache {
+        bool isValid = false;
+        ShapingKey key;
+
+        QVector<CharacterResult> result;
+        QVector<KoSvgText::CharTransformation> resolvedTransforms;
+        QMap<int, int> logicalToVisual;
+        int dummyIndex = -1;
+        bool isBidi = false;
+    };
+
+    ShapingCache shapingCache;
+
     void relayout();
 
     static bool loadGlyph(const KoSvgText::ResolutionHandler &resHandler,
@@ -10,12 +10,16 @@
 
 #include "KisTofuGlyph.h"
 #include "KoFontLibraryResourceUtils.h"
+#include "KoFontRegistry.h"
 
 #include <FlakeDebug.h>
 #include <KoPathShape.h>
 
 #include <kis_global.h>
 
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QPainterPath>
 #include <QtMath>
 
@@ -38,6 +42,57 @@
 static QPainterPath convertFromFreeTypeOutline(FT_GlyphSlotRec *glyphSlot);
 static QImage convertFromFreeTypeBitmap(FT_GlyphSlotRec *glyphSlot);
 
+namespace {
+
+struct GlyphOutlineKey
+{
+    QString faceKey; ///< file, face index, size and variation of the face
+    FT_UInt glyphIndex;
+    FT_Int32 loadFlags;
+    int fontWeight; ///< the font weight decides whether the outline is emboldened
+
+    bool operator==(const GlyphOutlineKey &rhs) const {
+        return glyphIndex == rhs.glyphIndex &&
+            loadFlags == rhs.loadFlags &&
+            fontWeight == rhs.fontWeight &&
+            faceKey == rhs.faceKey;
+    }
+};
+
+uint qHash(const GlyphOutlineKey &key, uint seed = 0)
+{
+    return ::qHash(key.faceKey, seed) ^ ::qHash(key.glyphIndex << 8) ^
+        ::qHash(key.loadFlags) ^ ::qHash(key.fontWeight << 16);
+}
+
+struct GlyphOutline
+{
+    QPainterPath path; ///< the outline in freetype coordinates
+    int xAdvanceDelta = 0;
+    int yAdvanceDelta = 0;
+};
+
+/**
+ * The documents with lettering usually use a few fonts for thousands of
+ * glyphs, so the converted outlines are shared between all the text
+ * shapes of the process. The cost of an entry is the number of
+ * elements of the path, the limit is enough for a few hundred thousand
+ * average glyphs.
+ */
+const int maxCachedOutlineElements = 16 * 1024 * 1024;
+
+struct GlyphOutlineCache
+{
+    GlyphOutlineCache() : cache(maxCachedOutlineElements) {}
+
+    QMutex mutex;
+    QCache<GlyphOutlineKey, GlyphOutline> cache;
+};
+
+Q_GLOBAL_STATIC(GlyphOutlineCache, s_glyphOutlineCache)
+
+}
+
 static QString glyphFormatToStr(const FT_Glyph_Format _v)
 {
     const unsigned int v = _v;
@@ -341,15 +396,60 @@ std::pair<QTransform, qreal> KoSvgTextShape::Private::loadGlyphOnly(const QTrans
         currentGlyph.x_advance = new_x_advance;
         currentGlyph.y_advance = new_y_advance;
     } else {
-        if (const FT_Error err = FT_Load_Glyph(currentGlyph.ftface, currentGlyph.index, faceLoadFlags)) {
-            warnFlake << "Failed to load glyph, freetype error" << err;
-            return {glyphObliqueTf, bitmapScale};
+        const GlyphOutlineKey outlineKey {KoFontRegistry::instance()->faceCacheKey(currentGlyph.ftface),
+                                          currentGlyph.index,
+                                          faceLoadFlags,
+                                          charResult.fontWeight};
+        GlyphOutline cachedOutline;
+        bool isOutlineGlyph = false;
+
+        if (!outlineKey.faceKey.isEmpty()) {
+            QMutexLocker l(&s_glyphOutlineCache->mutex);
+            if (GlyphOutline *outline = s_glyphOutlineCache->cache.object(outlineKey)) {
+                cachedOutline = *outline;
+                isOutlineGlyph = true;
+            }
+        }
+
+        if (!isOutlineGlyph) {
+            if (const FT_Error err = FT_Load_Glyph(currentGlyph.ftface, currentGlyph.index, faceLoadFlags)) {
+                warnFlake << "Failed to load glyph, freetype error" << err;
+                return {glyphObliqueTf, bitmapScale};
+            }
+
+            /**
+             * Check whether we need to synthesize bold by emboldening the glyph.
+             * The emboldening changes the advance only if it is not zero, so
+             * we measure the change on a unit advance to be able to reapply
+             * it to the glyphs fetched from the cache.
+             */
+            int xAdvance = 1;
+            int yAdvance = 1;
+            emboldenGlyphIfNeeded(currentGlyph.ftface, charResult, &xAdvance, &yAdvance);
+            cachedOutline.xAdvanceDelta = xAdvance - 1;
+            cachedOutline.yAdvanceDelta = yAdvance - 1;
+
+            if (currentGlyph.ftface->glyph->format == FT_GLYPH_FORMAT_OUTLINE) {
+                cachedOutline.path = convertFromFreeTypeOutline(currentGlyph.ftface->glyph);
+
+                if (!outlineKey.faceKey.isEmpty()) {
+                    QMutexLocker l(&s_glyphOutlineCache->mutex);
+                    s_glyphOutlineCache->cache.insert(outlineKey,
+                                                      new GlyphOutline(cachedOutline),
+                                                      qMax(1, cachedOutline.path.elementCount()));
+                }
+                isOutlineGlyph = true;
+            }
         }
 
-        // Check whether we need to synthesize bold by emboldening the glyph:
-        emboldenGlyphIfNeeded(currentGlyph.ftface, charResult, &currentGlyph.x_advance, &currentGlyph.y_advance);
+        if (currentGlyph.x_advance != 0) {
+            currentGlyph.x_advance += cachedOutline.xAdvanceDelta;
+        }
+        if (currentGlyph.y_advance != 0) {
+            currentGlyph.y_advance += cachedOutline.yAdvanceDelta;
+        }
 
-        if (currentGlyph.ftface->glyph->format == FT_GLYPH_FORMAT_OUTLINE) {
+        if (isOutlineGlyph) {
             Glyph::Outline _discard; ///< Storage for discarded outline, must outlive outlineGlyph
             Glyph::Outline *outlineGlyph = std::get_if<Glyph::Outline>(&charResult.glyph);
             if (!outlineGlyph) {
@@ -372,8 +472,7 @@ std::pair<QTransform, qreal> KoSvgTextShape::Private::loadGlyphOnly(const QTrans
             std::tie(outlineGlyphTf, glyphObliqueTf) =
                 calcOutlineGlyphTransform(ftTF, currentGlyph, charResult, isHorizontal);
 
-            QPainterPath glyph = convertFromFreeTypeOutline(currentGlyph.ftface->glyph);
-            glyph = outlineGlyphTf.map(glyph);
+            const QPainterPath glyph = outlineGlyphTf.map(cachedOutline.path);
 
             if (charResult.visualIndex > -1) {
                 // this is for glyph clusters, unicode combining marks are always
@@ -248,392 +248,434 @@ void KoSvgTextShape::Private::relayout()
     }
     this->resolveTransforms(textData.childBegin(), text, result, globalIndex, isHorizontal, wrapped, false, resolvedTransforms, collapseChars, KoSvgTextProperties::defaultProperties(), true);
 
-    // pass everything to a css-compatible text-layout algortihm.
-    raqm_t_sp layout(raqm_create());
-
-    if (raqm_set_text_utf16(layout.data(), text.utf16(), static_cast<size_t>(text.size()))) {
-        if (writingMode == KoSvgText::VerticalRL || writingMode == KoSvgText::VerticalLR) {
-            raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_TTB);
-        } else if (direction == KoSvgText::DirectionRightToLeft) {
-            raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_RTL);
-        } else {
-            raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_LTR);
-        }
+    /**
+     * The inline-size affects the shaping only through the resolved
+     * transforms, so it is excluded from the properties to let the text
+     * be reflowed without reshaping.
+     */
+    ShapingKey shapingKey;
+    shapingKey.text = text;
+    shapingKey.collapseChars = collapseChars;
+    shapingKey.clusterToOriginalString = clusterToOriginalString;
+    shapingKey.rootProperties = rootProperties;
+    shapingKey.rootProperties.removeProperty(KoSvgTextProperties::InlineSizeId);
+    Q_FOREACH (const SubChunk &chunk, textChunks) {
+        KoColorBackground *b = dynamic_cast<KoColorBackground *>(chunk.bg.data());
+        KoSvgTextProperties chunkProperties = chunk.inheritedProps;
+        chunkProperties.removeProperty(KoSvgTextProperties::InlineSizeId);
+        shapingKey.chunkProperties.append(chunkProperties);
+        shapingKey.chunkSizes.append(chunk.text.size());
+        shapingKey.chunkFillColors.append(b ? b->color() : QColor());
+        shapingKey.chunkFirstTextInPath.append(chunk.firstTextInPath);
+    }
+    shapingKey.resolvedTransforms = resolvedTransforms;
+    shapingKey.xRes = this->xRes;
+    shapingKey.yRes = this->yRes;
+    shapingKey.disableFontMatching = disableFontMatching;
 
-        int start = 0;
-        Q_FOREACH (const SubChunk &chunk, textChunks) {
-            int length = chunk.text.size();
-            KoSvgTextProperties properties = chunk.inheritedProps;
-
-            // In this section we retrieve the resolved transforms and
-            // direction/anchoring that we can get from the subchunks.
-            KoSvgText::TextAnchor anchor = KoSvgText::TextAnchor(properties.propertyOrDefault(KoSvgTextProperties::TextAnchorId).toInt());
-            KoSvgText::Direction direction = KoSvgText::Direction(properties.propertyOrDefault(KoSvgTextProperties::DirectionId).toInt());
-            KoSvgText::WordBreak wordBreakStrictness = KoSvgText::WordBreak(properties.propertyOrDefault(KoSvgTextProperties::WordBreakId).toInt());
-            KoSvgText::HangingPunctuations hang =
-                properties.propertyOrDefault(KoSvgTextProperties::HangingPunctuationId).value<KoSvgText::HangingPunctuations>();
-            KoSvgText::TabSizeInfo tabInfo = properties.propertyOrDefault(KoSvgTextProperties::TabSizeId).value<KoSvgText::TabSizeInfo>();
-            KoSvgText::AutoLengthPercentage letterSpacing = properties.propertyOrDefault(KoSvgTextProperties::LetterSpacingId).value<KoSvgText::AutoLengthPercentage>();
-            KoSvgText::AutoLengthPercentage wordSpacing = properties.propertyOrDefault(KoSvgTextProperties::WordSpacingId).value<KoSvgText::AutoLengthPercentage>();
-            bool overflowWrap = KoSvgText::OverflowWrap(properties.propertyOrDefault(KoSvgTextProperties::OverflowWrapId).toInt()) != KoSvgText::OverflowWrapNormal;
-            KoSvgText::TextSpaceCollapse collapse = KoSvgText::TextSpaceCollapse(properties.propertyOrDefault(KoSvgTextProperties::TextCollapseId).toInt());
-
-            KoSvgText::LineBreak localLinebreakStrictness = KoSvgText::LineBreak(properties.property(KoSvgTextProperties::LineBreakId).toInt());
-            QString localLang = properties.property(KoSvgTextProperties::TextLanguage).toString();
-
-            if ((localLinebreakStrictness != linebreakStrictness && localLinebreakStrictness != KoSvgText::LineBreakAnywhere) || localLang != lang ) {
-                QString unibreakLang = langToLibUnibreakLang(localLang);
-                if (localLinebreakStrictness == KoSvgText::LineBreakStrict && !unibreakLang.isEmpty()) {
-                    unibreakLang += "-strict";
-                }
-                int localLineBreakStart = qMax(0, start -1);
-                int localLineBreakEnd = qMin(text.size(), start+chunk.text.size());
-                QVector<char> localLineBreaks(localLineBreakEnd - localLineBreakStart);
-                set_linebreaks_utf16(text.mid(localLineBreakStart, localLineBreaks.size()).utf16(),
-                                     static_cast<size_t>(localLineBreaks.size()),
-                                     unibreakLang.toUtf8().data(),
-                                     localLineBreaks.data());
-                for (int i = 0; i < localLineBreaks.size(); i++) {
-                    if (i < (start - localLineBreakStart)) continue;
-                    if (i+localLineBreakStart > start+chunk.text.size()) break;
-                    lineBreaks[i+localLineBreakStart] = localLineBreaks[i];
+    QMap<int, int> logicalToVisual;
+    int dummyIndex = -1;
+
+    if (shapingCache.isValid && shapingCache.key == shapingKey) {
+        result = shapingCache.result;
+        resolvedTransforms = shapingCache.resolvedTransforms;
+        logicalToVisual = shapingCache.logicalToVisual;
+        dummyIndex = shapingCache.dummyIndex;
+        this->isBidi = shapingCache.isBidi;
+    } else {
+        // pass everything to a css-compatible text-layout algortihm.
+        raqm_t_sp layout(raqm_create());
+
+        if (raqm_set_text_utf16(layout.data(), text.utf16(), static_cast<size_t>(text.size()))) {
+            if (writingMode == KoSvgText::VerticalRL || writingMode == KoSvgText::VerticalLR) {
+                raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_TTB);
+            } else if (direction == KoSvgText::DirectionRightToLeft) {
+                raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_RTL);
+            } else {
+                raqm_set_par_direction(layout.data(), raqm_direction_t::RAQM_DIRECTION_LTR);
+            }
+
+            int start = 0;
+            Q_FOREACH (const SubChunk &chunk, textChunks) {
+                int length = chunk.text.size();
+                KoSvgTextProperties properties = chunk.inheritedProps;
+
+                // In this section we retrieve the resolved transforms and
+                // direction/anchoring that we can get from the subchunks.
+                KoSvgText::TextAnchor anchor = KoSvgText::TextAnchor(properties.propertyOrDefault(KoSvgTextProperties::TextAnchorId).toInt());
+                KoSvgText::Direction direction = KoSvgText::Direction(properties.propertyOrDefault(KoSvgTextProperties::DirectionId).toInt());
+                KoSvgText::WordBreak wordBreakStrictness = KoSvgText::WordBreak(properties.propertyOrDefault(KoSvgTextProperties::WordBreakId).toInt());
+                KoSvgText::HangingPunctuations hang =
+                    properties.propertyOrDefault(KoSvgTextProperties::HangingPunctuationId).value<KoSvgText::HangingPunctuations>();
+                KoSvgText::TabSizeInfo tabInfo = properties.propertyOrDefault(KoSvgTextProperties::TabSizeId).value<KoSvgText::TabSizeInfo>();
+                KoSvgText::AutoLengthPercentage letterSpacing = properties.propertyOrDefault(KoSvgTextProperties::LetterSpacingId).value<KoSvgText::AutoLengthPercentage>();
+                KoSvgText::AutoLengthPercentage wordSpacing = properties.propertyOrDefault(KoSvgTextProperties::WordSpacingId).value<KoSvgText::AutoLengthPercentage>();
+                bool overflowWrap = KoSvgText::OverflowWrap(properties.propertyOrDefault(KoSvgTextProperties::OverflowWrapId).toInt()) != KoSvgText::OverflowWrapNormal;
+                KoSvgText::TextSpaceCollapse collapse = KoSvgText::TextSpaceCollapse(properties.propertyOrDefault(KoSvgTextProperties::TextCollapseId).toInt());
+
+                KoSvgText::LineBreak localLinebreakStrictness = KoSvgText::LineBreak(properties.property(KoSvgTextProperties::LineBreakId).toInt());
+                QString localLang = properties.property(KoSvgTextProperties::TextLanguage).toString();
+
+                if ((localLinebreakStrictness != linebreakStrictness && localLinebreakStrictness != KoSvgText::LineBreakAnywhere) || localLang != lang ) {
+                    QString unibreakLang = langToLibUnibreakLang(localLang);
+                    if (localLinebreakStrictness == KoSvgText::LineBreakStrict && !unibreakLang.isEmpty()) {
+                        unibreakLang += "-strict";
+                    }
+                    int localLineBreakStart = qMax(0, start -1);
+                    int localLineBreakEnd = qMin(text.size(), start+chunk.text.size());
+                    QVector<char> localLineBreaks(localLineBreakEnd - localLineBreakStart);
+                    set_linebreaks_utf16(text.mid(localLineBreakStart, localLineBreaks.size()).utf16(),
+                                         static_cast<size_t>(localLineBreaks.size()),
+                                         unibreakLang.toUtf8().data(),
+                                         localLineBreaks.data());
+                    for (int i = 0; i < localLineBreaks.size(); i++) {
+                        if (i < (start - localLineBreakStart)) continue;
+                        if (i+localLineBreakStart > start+chunk.text.size()) break;
+                        lineBreaks[i+localLineBreakStart] = localLineBreaks[i];
+                    }
                 }
-            }
 
-            KoColorBackground *b = dynamic_cast<KoColorBackground *>(chunk.bg.data());
-            QColor fillColor;
-            if (b)
-            {
-                fillColor = b->color();
-            }
-            if (!letterSpacing.isAuto) {
-                tabInfo.extraSpacing += letterSpacing.length.value;
-            }
-            if (!wordSpacing.isAuto) {
-                tabInfo.extraSpacing += wordSpacing.length.value;
-            }
+                KoColorBackground *b = dynamic_cast<KoColorBackground *>(chunk.bg.data());
+                QColor fillColor;
+                if (b)
+                {
+                    fillColor = b->color();
+                }
+                if (!letterSpacing.isAuto) {
+                    tabInfo.extraSpacing += letterSpacing.length.value;
+                }
+                if (!wordSpacing.isAuto) {
+                    tabInfo.extraSpacing += wordSpacing.length.value;
+                }
 
-            for (int i = 0; i < length; i++) {
-                CharacterResult cr = result[start + i];
-                cr.anchor = anchor;
-                cr.direction = direction;
-                QPair<bool, bool> canJustify = justify.value(start + i, QPair<bool, bool>(false, false));
-                cr.justifyBefore = canJustify.first;
-                cr.justifyAfter = canJustify.second;
-                cr.overflowWrap = overflowWrap;
-                if (lineBreaks[start + i] == LINEBREAK_MUSTBREAK) {
-                    cr.breakType = BreakType::HardBreak;
-                    cr.lineEnd = LineEdgeBehaviour::Collapse;
-                    cr.lineStart = LineEdgeBehaviour::Collapse;
-                } else if (lineBreaks[start + i] == LINEBREAK_ALLOWBREAK && wrap != KoSvgText::NoWrap) {
-                    cr.breakType = BreakType::SoftBreak;
-
-                    if (KoCssTextUtils::collapseLastSpace(text.at(start + i), collapse)) {
+                for (int i = 0; i < length; i++) {
+                    CharacterResult cr = result[start + i];
+                    cr.anchor = anchor;
+                    cr.direction = direction;
+                    QPair<bool, bool> canJustify = justify.value(start + i, QPair<bool, bool>(false, false));
+                    cr.justifyBefore = canJustify.first;
+                    cr.justifyAfter = canJustify.second;
+                    cr.overflowWrap = overflowWrap;
+                    if (lineBreaks[start + i] == LINEBREAK_MUSTBREAK) {
+                        cr.breakType = BreakType::HardBreak;
                         cr.lineEnd = LineEdgeBehaviour::Collapse;
                         cr.lineStart = LineEdgeBehaviour::Collapse;
-                    }
-                }
-                if (cr.lineEnd != LineEdgeBehaviour::Collapse) {
-                    const auto isFollowedByForcedLineBreak = [&]() {
-                        if (result.size() <= start + i + 1) {
-                            // End of the text block, consider it a forced line break
-                            return true;
-                        }
-                        if (lineBreaks[start + i+ 1] == LINEBREAK_MUSTBREAK) {
-                            // Next character is a forced line break
-                            return true;
+                    } else if (lineBreaks[start + i] == LINEBREAK_ALLOWBREAK && wrap != KoSvgText::NoWrap) {
+                        cr.breakType = BreakType::SoftBreak;
+
+                        if (KoCssTextUtils::collapseLastSpace(text.at(start + i), collapse)) {
+                            cr.lineEnd = LineEdgeBehaviour::Collapse;
+                            cr.lineStart = LineEdgeBehaviour::Collapse;
                         }
-                        if (resolvedTransforms.at(start + i + 1).startsNewChunk()) {
-                            // Next character is another chunk, consider it a forced line break
-                            return true;
+                    }
+                    if (cr.lineEnd != LineEdgeBehaviour::Collapse) {
+                        const auto isFollowedByForcedLineBreak = [&]() {
+                            if (result.size() <= start + i + 1) {
+                                // End of the text block, consider it a forced line break
+                                return true;
+                            }
+                            if (lineBreaks[start + i+ 1] == LINEBREAK_MUSTBREAK) {
+                                // Next character is a forced line break
+                                return true;
+                            }
+                            if (resolvedTransforms.at(start + i + 1).startsNewChunk()) {
+                                // Next character is another chunk, consider it a forced line break
+                                return true;
+                            }
+                            return false;
+                        };
+                        bool forceHang = false;
+                        if (KoCssTextUtils::hangLastSpace(text.at(start + i), collapse, wrap, forceHang, isFollowedByForcedLineBreak())) {
+                            cr.lineEnd = forceHang? LineEdgeBehaviour::ForceHang: LineEdgeBehaviour::ConditionallyHang;
+
+                        } else if (collapse == KoSvgText::BreakSpaces && wrap != KoSvgText::NoWrap && KoCssTextUtils::IsCssWordSeparator(QString(text.at(start + i)))) {
+                            cr.breakType = BreakType::SoftBreak;
                         }
-                        return false;
-                    };
-                    bool forceHang = false;
-                    if (KoCssTextUtils::hangLastSpace(text.at(start + i), collapse, wrap, forceHang, isFollowedByForcedLineBreak())) {
-                        cr.lineEnd = forceHang? LineEdgeBehaviour::ForceHang: LineEdgeBehaviour::ConditionallyHang;
-
-                    } else if (collapse == KoSvgText::BreakSpaces && wrap != KoSvgText::NoWrap && KoCssTextUtils::IsCssWordSeparator(QString(text.at(start + i)))) {
-                        cr.breakType = BreakType::SoftBreak;
                     }
-                }
 
-                if ((wordBreakStrictness == KoSvgText::WordBreakBreakAll ||
-                     localLinebreakStrictness == KoSvgText::LineBreakAnywhere)
-                        && wrap != KoSvgText::NoWrap) {
-                    if (graphemeBreaks[start + i] == GRAPHEMEBREAK_BREAK && cr.breakType == BreakType::NoBreak) {
-                        cr.breakType = BreakType::SoftBreak;
+                    if ((wordBreakStrictness == KoSvgText::WordBreakBreakAll ||
+                         localLinebreakStrictness == KoSvgText::LineBreakAnywhere)
+                            && wrap != KoSvgText::NoWrap) {
+                        if (graphemeBreaks[start + i] == GRAPHEMEBREAK_BREAK && cr.breakType == BreakType::NoBreak) {
+                            cr.breakType = BreakType::SoftBreak;
+                        }
+                    } else if (wordBreakStrictness == KoSvgText::WordBreakKeepAll) {
+                        cr.breakType = (wordBreaks[start + i] == WORDBREAK_BREAK)? cr.breakType: BreakType::NoBreak;
                     }
-                } else if (wordBreakStrictness == KoSvgText::WordBreakKeepAll) {
-                    cr.breakType = (wordBreaks[start + i] == WORDBREAK_BREAK)? cr.breakType: BreakType::NoBreak;
-                }
-                if (cr.lineStart != LineEdgeBehaviour::Collapse && hang.testFlag(KoSvgText::HangFirst)) {
-                    cr.lineStart = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangFirst)
-                        ? LineEdgeBehaviour::ForceHang
-                        : cr.lineEnd;
-                }
-                if (cr.lineEnd != LineEdgeBehaviour::Collapse) {
-                    if (hang.testFlag(KoSvgText::HangLast)) {
-                        cr.lineEnd = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangLast)
+                    if (cr.lineStart != LineEdgeBehaviour::Collapse && hang.testFlag(KoSvgText::HangFirst)) {
+                        cr.lineStart = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangFirst)
                             ? LineEdgeBehaviour::ForceHang
                             : cr.lineEnd;
                     }
-                    if (hang.testFlag(KoSvgText::HangEnd)) {
-                        LineEdgeBehaviour edge = hang.testFlag(KoSvgText::HangForce)
-                            ? LineEdgeBehaviour::ForceHang
-                            : LineEdgeBehaviour::ConditionallyHang;
-                        cr.lineEnd = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangEnd) ? edge : cr.lineEnd;
+                    if (cr.lineEnd != LineEdgeBehaviour::Collapse) {
+                        if (hang.testFlag(KoSvgText::HangLast)) {
+                            cr.lineEnd = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangLast)
+                                ? LineEdgeBehaviour::ForceHang
+                                : cr.lineEnd;
+                        }
+                        if (hang.testFlag(KoSvgText::HangEnd)) {
+                            LineEdgeBehaviour edge = hang.testFlag(KoSvgText::HangForce)
+                                ? LineEdgeBehaviour::ForceHang
+                                : LineEdgeBehaviour::ConditionallyHang;
+                            cr.lineEnd = KoCssTextUtils::characterCanHang(text.at(start + i), KoSvgText::HangEnd) ? edge : cr.lineEnd;
+                        }
                     }
-                }
 
-                cr.cursorInfo.isWordBoundary = (wordBreaks[start + i] == WORDBREAK_BREAK);
-                cr.cursorInfo.color = fillColor;
+                    cr.cursorInfo.isWordBoundary = (wordBreaks[start + i] == WORDBREAK_BREAK);
+                    cr.cursorInfo.color = fillColor;
 
 
 
-                if (resolvedTransforms.at(start + i).startsNewChunk()) {
-                    raqm_set_arbitrary_run_break(layout.data(), static_cast<size_t>(start + i), true);
-                }
+                    if (resolvedTransforms.at(start + i).startsNewChunk()) {
+                        raqm_set_arbitrary_run_break(layout.data(), static_cast<size_t>(start + i), true);
+                    }
 
-                if (chunk.firstTextInPath && i == 0) {
-                    cr.anchored_chunk = true;
+                    if (chunk.firstTextInPath && i == 0) {
+                        cr.anchored_chunk = true;
+                    }
+                    result[start + i] = cr;
                 }
-                result[start + i] = cr;
-            }
-
-            QVector<int> lengths;
-            QStringList fontFeatures = properties.fontFeaturesForText(start, length);
-
-            const KoSvgText::CssFontStyleData style = properties.propertyOrDefault(KoSvgTextProperties::FontStyleId).value<KoSvgText::CssFontStyleData>();
-            bool synthesizeWeight = properties.propertyOrDefault(KoSvgTextProperties::FontSynthesisBoldId).toBool();
-            bool synthesizeStyle = properties.propertyOrDefault(KoSvgTextProperties::FontSynthesisItalicId).toBool();
-
-            const std::vector<FT_FaceSP> faces = KoFontRegistry::instance()->facesForCSSValues(
-                lengths,
-                properties.cssFontInfo(),
-                chunk.text,
-                static_cast<quint32>(resHandler.xRes),
-                static_cast<quint32>(resHandler.yRes),
-                disableFontMatching);
-            const qreal fontSize = properties.cssFontInfo().size;
-            if (properties.hasProperty(KoSvgTextProperties::TextLanguage)) {
-                raqm_set_language(layout.data(),
-                                  properties.property(KoSvgTextProperties::TextLanguage).toString().toUtf8(),
-                                  static_cast<size_t>(start),
-                                  static_cast<size_t>(length));
-            }
-            Q_FOREACH (const QString &feature, fontFeatures) {
-                debugFlake << "adding feature" << feature;
-                raqm_add_font_feature(layout.data(), feature.toUtf8(), feature.toUtf8().size());
-            }
-
-            if (!letterSpacing.isAuto) {
-                raqm_set_letter_spacing_range(layout.data(),
-                                              static_cast<int>(letterSpacing.length.value * resHandler.freeTypePixel * resHandler.pointToPixelFactor(isHorizontal)),
-                                              static_cast<size_t>(start),
-                                              static_cast<size_t>(length));
-            }
 
-            if (!wordSpacing.isAuto) {
-                raqm_set_word_spacing_range(layout.data(),
-                                            static_cast<int>(wordSpacing.length.value * resHandler.freeTypePixel * resHandler.pointToPixelFactor(isHorizontal)),
-                                            static_cast<size_t>(start),
-                                            static_cast<size_t>(length));
-            }
+                QVector<int> lengths;
+                QStringList fontFeatures = properties.fontFeaturesForText(start, length);
+
+                const KoSvgText::CssFontStyleData style = properties.propertyOrDefault(KoSvgTextProperties::FontStyleId).value<KoSvgText::CssFontStyleData>();
+                bool synthesizeWeight = properties.propertyOrDefault(KoSvgTextProperties::FontSynthesisBoldId).toBool();
+                bool synthesizeStyle = properties.propertyOrDefault(KoSvgTextProperties::FontSynthesisItalicId).toBool();
+
+                const std::vector<FT_FaceSP> faces = KoFontRegistry::instance()->facesForCSSValues(
+                    lengths,
+                    properties.cssFontInfo(),
+                    chunk.text,
+                    static_cast<quint32>(resHandler.xRes),
+                    static_cast<quint32>(resHandler.yRes),
+                    disableFontMatching);
+                const qreal fontSize = properties.cssFontInfo().size;
+                if (properties.hasProperty(KoSvgTextProperties::TextLanguage)) {
+                    raqm_set_language(layout.data(),
+                                      properties.property(KoSvgTextProperties::TextLanguage).toString().toUtf8(),
+                                      static_cast<size_t>(start),
+                                      static_cast<size_t>(length));
+                }
+                Q_FOREACH (const QString &feature, fontFeatures) {
+                    debugFlake << "adding feature" << feature;
+                    raqm_add_font_feature(layout.data(), feature.toUtf8(), feature.toUtf8().size());
+                }
 
-            for (int i = 0; i < lengths.size(); i++) {
-                length = lengths.at(i);
-                const FT_FaceSP &face = faces.at(static_cast<size_t>(i));
-                const FT_Int32 faceLoadFlags = KoFontRegistry::loadFlagsForFace(face.data(), isHorizontal, 0, textRendering);
-                if (start == 0) {
-                    raqm_set_freetype_face(layout.data(), face.data());
-                    raqm_set_freetype_load_flags(layout.data(), faceLoadFlags);
+                if (!letterSpacing.isAuto) {
+                    raqm_set_letter_spacing_range(layout.data(),
+                                                  static_cast<int>(letterSpacing.length.value * resHandler.freeTypePixel * resHandler.pointToPixelFactor(isHorizontal)),
+                                                  static_cast<size_t>(start),
+                                                  static_cast<size_t>(length));
                 }
-                if (length > 0) {
-                    raqm_set_freetype_face_range(layout.data(),
-                                                 face.data(),
-                                                 static_cast<size_t>(start),
-                                                 static_cast<size_t>(length));
-                    raqm_set_freetype_load_flags_range(layout.data(),
-                                                       faceLoadFlags,
-                                                       static_cast<size_t>(start),
-                                                       static_cast<size_t>(length));
+
+                if (!wordSpacing.isAuto) {
+                    raqm_set_word_spacing_range(layout.data(),
+                                                static_cast<int>(wordSpacing.length.value * resHandler.freeTypePixel * resHandler.pointToPixelFactor(isHorizontal)),
+                                                static_cast<size_t>(start),
+                                                static_cast<size_t>(length));
                 }
 
-                QHash<QChar::Script, KoSvgText::FontMetrics> metricsList;
-                for (int j=start; j<start+length; j++) {
-                    const QChar::Script currentScript = QChar::script(getUcs4At(text, j));
-                    if (!metricsList.contains(currentScript)) {
-                        metricsList.insert(currentScript, KoFontRegistry::generateFontMetrics(face, isHorizontal, KoWritingSystemUtils::scriptTagForQCharScript(currentScript), textRendering));
+                for (int i = 0; i < lengths.size(); i++) {
+                    length = lengths.at(i);
+                    const FT_FaceSP &face = faces.at(static_cast<size_t>(i));
+                    const FT_Int32 faceLoadFlags = KoFontRegistry::loadFlagsForFace(face.data(), isHorizontal, 0, textRendering);
+                    if (start == 0) {
+                        raqm_set_freetype_face(layout.data(), face.data());
+                        raqm_set_freetype_load_flags(layout.data(), faceLoadFlags);
                     }
-                    result[j].metrics = metricsList.value(currentScript);
-                    if (fontSize < 1.0) {
-                        result[j].extraFontScaling = fontSize;
+                    if (length > 0) {
+                        raqm_set_freetype_face_range(layout.data(),
+                                                     face.data(),
+                                                     static_cast<size_t>(start),
+                                                     static_cast<size_t>(length));
+                        raqm_set_freetype_load_flags_range(layout.data(),
+                                                           faceLoadFlags,
+                                                           static_cast<size_t>(start),
+                                                           static_cast<size_t>(length));
                     }
 
-                    const KoSvgText::FontMetrics currentMetrics = properties.applyLineHeight(result[j].metrics);
+                    QHash<QChar::Script, KoSvgText::FontMetrics> metricsList;
+                    for (int j=start; j<start+length; j++) {
+                        const QChar::Script currentScript = QChar::script(getUcs4At(text, j));
+                        if (!metricsList.contains(currentScript)) {
+                            metricsList.insert(currentScript, KoFontRegistry::generateFontMetrics(face, isHorizontal, KoWritingSystemUtils::scriptTagForQCharScript(currentScript), textRendering));
+                        }
+                        result[j].metrics = metricsList.value(currentScript);
+                        if (fontSize < 1.0) {
+                            result[j].extraFontScaling = fontSize;
+                        }
 
-                    if (text.at(j) == QChar::Tabulation) {
-                        qreal tabSize = 0;
-                        if (tabInfo.isNumber) {
-                            // Try to avoid Nan situations.
-                            if (result[j].metrics.spaceAdvance > 0) {
-                                tabSize = (result[j].metrics.spaceAdvance + (tabInfo.extraSpacing*resHandler.freeTypePixel)) * tabInfo.value;
+                        const KoSvgText::FontMetrics currentMetrics = properties.applyLineHeight(result[j].metrics);
+
+                        if (text.at(j) == QChar::Tabulation) {
+                            qreal tabSize = 0;
+                            if (tabInfo.isNumber) {
+                                // Try to avoid Nan situations.
+                                if (result[j].metrics.spaceAdvance > 0) {
+                                    tabSize = (result[j].metrics.spaceAdvance + (tabInfo.extraSpacing*resHandler.freeTypePixel)) * tabInfo.value;
+                                } else {
+                                    tabSize = ((result[j].metrics.fontSize/2) + (tabInfo.extraSpacing*resHandler.freeTypePixel)) * tabInfo.value;
+                                }
                             } else {
-                                tabSize = ((result[j].metrics.fontSize/2) + (tabInfo.extraSpacing*resHandler.freeTypePixel)) * tabInfo.value;
+                                tabSize = tabInfo.length.value * resHandler.freeTypePixel;
                             }
-                        } else {
-                            tabSize = tabInfo.length.value * resHandler.freeTypePixel;
+                            result[j].tabSize = tabSize;
                         }
-                        result[j].tabSize = tabSize;
+
+                        result[j].fontHalfLeading = currentMetrics.lineGap / 2;
+                        result[j].fontStyle = synthesizeStyle? style.style: QFont::StyleNormal;
+                        result[j].fontWeight = synthesizeWeight? properties.propertyOrDefault(KoSvgTextProperties::FontWeightId).toInt(): 400;
                     }
 
-                    result[j].fontHalfLeading = currentMetrics.lineGap / 2;
-                    result[j].fontStyle = synthesizeStyle? style.style: QFont::StyleNormal;
-                    result[j].fontWeight = synthesizeWeight? properties.propertyOrDefault(KoSvgTextProperties::FontWeightId).toInt(): 400;
+                    start += length;
                 }
-
-                start += length;
             }
+            debugFlake << "text-length:" << text.size();
+        }
+        // set very first character as anchored chunk.
+        if (!result.empty()) {
+            result[0].anchored_chunk = true;
         }
-        debugFlake << "text-length:" << text.size();
-    }
-    // set very first character as anchored chunk.
-    if (!result.empty()) {
-        result[0].anchored_chunk = true;
-    }
 
-    if (raqm_layout(layout.data())) {
-        debugFlake << "layout succeeded";
-    }
+        if (raqm_layout(layout.data())) {
+            debugFlake << "layout succeeded";
+        }
 
-    // 2. Set flags and assign initial positions
-    // We also retreive a glyph path here.
-    size_t count = 0;
-    const raqm_glyph_t *glyphs = raqm_get_glyphs(layout.data(), &count);
-    if (!glyphs) {
-        return;
-    }
+        // 2. Set flags and assign initial positions
+        // We also retreive a glyph path here.
+        size_t count = 0;
+        const raqm_glyph_t *glyphs = raqm_get_glyphs(layout.data(), &count);
+        if (!glyphs) {
+            return;
+        }
 
-    QPointF totalAdvanceFTFontCoordinates;
-    QMap<int, int> logicalToVisual;
-    this->isBidi = false;
+        QPointF totalAdvanceFTFontCoordinates;
+        this->isBidi = false;
 
 
-    KIS_ASSERT(count <= INT32_MAX);
+        KIS_ASSERT(count <= INT32_MAX);
 
-    for (int i = 0; i < static_cast<int>(count); i++) {
-        raqm_glyph_t currentGlyph = glyphs[i];
-        KIS_ASSERT(currentGlyph.cluster <= INT32_MAX);
-        const int cluster = static_cast<int>(currentGlyph.cluster);
-        if (!result[cluster].addressable) {
-            continue;
-        }
-        CharacterResult charResult = result[cluster];
+        for (int i = 0; i < static_cast<int>(count); i++) {
+            raqm_glyph_t currentGlyph = glyphs[i];
+            KIS_ASSERT(currentGlyph.cluster <= INT32_MAX);
+            const int cluster = static_cast<int>(currentGlyph.cluster);
+            if (!result[cluster].addressable) {
+                continue;
+            }
+            CharacterResult charResult = result[cluster];
 
-        const FT_Int32 faceLoadFlags = KoFontRegistry::loadFlagsForFace(currentGlyph.ftface, isHorizontal, 0, textRendering);
+            const FT_Int32 faceLoadFlags = KoFontRegistry::loadFlagsForFace(currentGlyph.ftface, isHorizontal, 0, textRendering);
 
 
-        const char32_t codepoint = getUcs4At(text, cluster);
-        debugFlake << "glyph" << i << "cluster" << cluster << currentGlyph.index << codepoint;
+            const char32_t codepoint = getUcs4At(text, cluster);
+            debugFlake << "glyph" << i << "cluster" << cluster << currentGlyph.index << codepoint;
 
-        charResult.cursorInfo.rtl = raqm_get_direction_at_index(layout.data(), cluster) == RAQM_DIRECTION_RTL;
-        if (charResult.cursorInfo.rtl != (charResult.direction == KoSvgText::DirectionRightToLeft)) {
-            this->isBidi = true;
-        }
+            charResult.cursorInfo.rtl = raqm_get_direction_at_index(layout.data(), cluster) == RAQM_DIRECTION_RTL;
+            if (charResult.cursorInfo.rtl != (charResult.direction == KoSvgText::DirectionRightToLeft)) {
+                this->isBidi = true;
+            }
 
-        if (!this->loadGlyph(resHandler,
-                             faceLoadFlags,
-                             isHorizontal,
-                             codepoint,
-                             textRendering,
-                             currentGlyph,
-                             charResult,
-                             totalAdvanceFTFontCoordinates)) {
-            continue;
-        }
+            if (!this->loadGlyph(resHandler,
+                                 faceLoadFlags,
+                                 isHorizontal,
+                                 codepoint,
+                                 textRendering,
+                                 currentGlyph,
+                                 charResult,
+                                 totalAdvanceFTFontCoordinates)) {
+                continue;
+            }
 
-        charResult.visualIndex = i;
-        logicalToVisual.insert(cluster, i);
+            charResult.visualIndex = i;
+            logicalToVisual.insert(cluster, i);
 
-        charResult.middle = false;
+            charResult.middle = false;
 
-        result[cluster] = charResult;
-    }
+            result[cluster] = charResult;
+        }
 
-    // fix it so that characters that are in the 'middle' due to either being
-    // surrogates or part of a ligature, are marked as such. Also set the css
-    // position so that anchoring will work correctly later.
-    int firstCluster = -1;
-    bool graphemeBreakNext = false;
-    for (int i = 0; i < result.size(); i++) {
-        result[i].middle = result.at(i).visualIndex == -1;
-        if (result[i].addressable && !result.at(i).middle) {
-            if (result.at(i).plaintTextIndex > -1 && firstCluster > -1) {
-                CursorInfo info = result.at(firstCluster).cursorInfo;
-                // ensure the advance gets added to the ligature carets if we found them,
-                // so they don't get overwritten by the synthesis code.
-                if (!info.offsets.isEmpty()) {
-                    info.offsets.append(result.at(firstCluster).advance);
-                }
-                info.graphemeIndices.append(result.at(i).plaintTextIndex);
-                result[firstCluster].cursorInfo = info;
-            }
-            firstCluster = i;
-        } else {
-            int fC = qMax(0, firstCluster);
-            if (text[fC].isSpace() == text[i].isSpace()) {
-                if (result[fC].breakType != BreakType::HardBreak) {
-                    result[fC].breakType = result.at(i).breakType;
+        // fix it so that characters that are in the 'middle' due to either being
+        // surrogates or part of a ligature, are marked as such. Also set the css
+        // position so that anchoring will work correctly later.
+        int firstCluster = -1;
+        bool graphemeBreakNext = false;
+        for (int i = 0; i < result.size(); i++) {
+            result[i].middle = result.at(i).visualIndex == -1;
+            if (result[i].addressable && !result.at(i).middle) {
+                if (result.at(i).plaintTextIndex > -1 && firstCluster > -1) {
+                    CursorInfo info = result.at(firstCluster).cursorInfo;
+                    // ensure the advance gets added to the ligature carets if we found them,
+                    // so they don't get overwritten by the synthesis code.
+                    if (!info.offsets.isEmpty()) {
+                        info.offsets.append(result.at(firstCluster).advance);
+                    }
+                    info.graphemeIndices.append(result.at(i).plaintTextIndex);
+                    result[firstCluster].cursorInfo = info;
                 }
-                if (result[fC].lineStart == LineEdgeBehaviour::NoChange) {
-                    result[fC].lineStart = result.at(i).lineStart;
+                firstCluster = i;
+            } else {
+                int fC = qMax(0, firstCluster);
+                if (text[fC].isSpace() == text[i].isSpace()) {
+                    if (result[fC].breakType != BreakType::HardBreak) {
+                        result[fC].breakType = result.at(i).breakType;
+                    }
+                    if (result[fC].lineStart == LineEdgeBehaviour::NoChange) {
+                        result[fC].lineStart = result.at(i).lineStart;
+                    }
+                    if (result[fC].lineEnd == LineEdgeBehaviour::NoChange) {
+                        result[fC].lineEnd = result.at(i).lineEnd;
+                    }
                 }
-                if (result[fC].lineEnd == LineEdgeBehaviour::NoChange) {
-                    result[fC].lineEnd = result.at(i).lineEnd;
+                if (graphemeBreakNext && result[i].addressable && result.at(i).plaintTextIndex > -1) {
+                    result[fC].cursorInfo.graphemeIndices.append(result.at(i).plaintTextIndex);
                 }
+                result[i].cssPosition = result.at(fC).cssPosition + result.at(fC).advance;
+                result[i].hidden = true;
             }
-            if (graphemeBreakNext && result[i].addressable && result.at(i).plaintTextIndex > -1) {
-                result[fC].cursorInfo.graphemeIndices.append(result.at(i).plaintTextIndex);
-            }
-            result[i].cssPosition = result.at(fC).cssPosition + result.at(fC).advance;
-            result[i].hidden = true;
+            graphemeBreakNext = graphemeBreaks[i] == GRAPHEMEBREAK_BREAK;
+        }
+        int fC = qMax(0, firstCluster);
+        if (result.at(fC).cursorInfo.graphemeIndices.isEmpty() || graphemeBreakNext) {
+            result[fC].cursorInfo.graphemeIndices.append(plainText.size());
         }
-        graphemeBreakNext = graphemeBreaks[i] == GRAPHEMEBREAK_BREAK;
-    }
-    int fC = qMax(0, firstCluster);
-    if (result.at(fC).cursorInfo.graphemeIndices.isEmpty() || graphemeBreakNext) {
-        result[fC].cursorInfo.graphemeIndices.append(plainText.size());
-    }
 
-    // Add a dummy charResult at the end when the last non-collapsed position
-    // is a hard breaks, so the new line is laid out.
-    int dummyIndex = -1;
-    if (result.at(fC).breakType == BreakType::HardBreak) {
-        CharacterResult hardbreak = result.at(fC);
-        dummyIndex = fC +1;
-        CharacterResult dummy;
-        //dummy.hidden = true;
-        dummy.addressable = true;
-        dummy.visualIndex = hardbreak.visualIndex + 1;
-        dummy.scaledAscent = hardbreak.scaledAscent;
-        dummy.scaledDescent = hardbreak.scaledDescent;
-        dummy.scaledHalfLeading = hardbreak.scaledHalfLeading;
-        dummy.cssPosition = hardbreak.cssPosition + hardbreak.advance;
-        dummy.finalPosition = dummy.cssPosition;
-        dummy.inkBoundingBox = hardbreak.inkBoundingBox;
-        if (isHorizontal) {
-            dummy.scaleCharacterResult(0.0, 1.0);
-        } else {
-            dummy.scaleCharacterResult(1.0, 0.0);
+        // Add a dummy charResult at the end when the last non-collapsed position
+        // is a hard breaks, so the new line is laid out.
+        if (result.at(fC).breakType == BreakType::HardBreak) {
+            CharacterResult hardbreak = result.at(fC);
+            dummyIndex = fC +1;
+            CharacterResult dummy;
+            //dummy.hidden = true;
+            dummy.addressable = true;
+            dummy.visualIndex = hardbreak.visualIndex + 1;
+            dummy.scaledAscent = hardbreak.scaledAscent;
+            dummy.scaledDescent = hardbreak.scaledDescent;
+            dummy.scaledHalfLeading = hardbreak.scaledHalfLeading;
+            dummy.cssPosition = hardbreak.cssPosition + hardbreak.advance;
+            dummy.finalPosition = dummy.cssPosition;
+            dummy.inkBoundingBox = hardbreak.inkBoundingBox;
+            if (isHorizontal) {
+                dummy.scaleCharacterResult(0.0, 1.0);
+            } else {
+                dummy.scaleCharacterResult(1.0, 0.0);
+            }
+            dummy.plaintTextIndex = hardbreak.cursorInfo.graphemeIndices.last();
+            dummy.cursorInfo.caret = hardbreak.cursorInfo.caret;
+            dummy.cursorInfo.rtl = hardbreak.cursorInfo.rtl;
+            dummy.direction = hardbreak.direction;
+            result.insert(dummyIndex, dummy);
+            logicalToVisual.insert(dummyIndex, dummy.visualIndex);
+            resolvedTransforms.insert(dummyIndex, KoSvgText::CharTransformation());
         }
-        dummy.plaintTextIndex = hardbreak.cursorInfo.graphemeIndices.last();
-        dummy.cursorInfo.caret = hardbreak.cursorInfo.caret;
-        dummy.cursorInfo.rtl = hardbreak.cursorInfo.rtl;
-        dummy.direction = hardbreak.direction;
-        result.insert(dummyIndex, dummy);
-        logicalToVisual.insert(dummyIndex, dummy.visualIndex);
-        resolvedTransforms.insert(dummyIndex, KoSvgText::CharTransformation());
+
+        shapingCache.isValid = true;
+        shapingCache.key = shapingKey;
+        shapingCache.result = result;
+        shapingCache.resolvedTransforms = resolvedTransforms;
+        shapingCache.logicalToVisual = logicalToVisual;
+        shapingCache.dummyIndex = dummyIndex;
+        shapingCache.isBidi = this->isBidi;
     }
 
     debugFlake << "Glyphs retrieved";
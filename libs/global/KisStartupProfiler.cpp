@@ -0,0 +1,159 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStartupProfiler.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+
+#include "kis_debug.h"
+#include "KisUsageLogger.h"
+
+Q_GLOBAL_STATIC(KisStartupProfiler, s_instance)
+
+namespace {
+
+struct PhaseRecord {
+    QString name;
+    int depth = 0;
+    qint64 start = 0; // in microseconds
+    qint64 end = -1;
+};
+
+}
+
+struct KisStartupProfiler::Private
+{
+    QElapsedTimer timer;
+    QString fileName;
+    bool enabled = false;
+
+    QVector<PhaseRecord> phases;
+    int depth = 0;
+
+    qint64 timestamp() const {
+        return timer.nsecsElapsed() / 1000;
+    }
+
+    void printTimeline() const;
+    bool saveTrace() const;
+};
+
+void KisStartupProfiler::Private::printTimeline() const
+{
+    QString timeline = QString("Startup timeline (%1 ms in total):\n").arg(timestamp() / 1000.0, 0, 'f', 1);
+
+    for (const PhaseRecord &phase : phases) {
+        const qint64 duration = phase.end >= 0 ? phase.end - phase.start : -1;
+
+        timeline += QString("%1 ms %2%3: %4\n")
+            .arg(phase.start / 1000.0, 9, 'f', 1)
+            .arg(QString(2 * phase.depth, ' '))
+            .arg(phase.name)
+            .arg(duration >= 0 ? QString("%1 ms").arg(duration / 1000.0, 0, 'f', 1) : QString("not finished"));
+    }
+
+    qInfo().noquote() << timeline;
+    KisUsageLogger::write(timeline);
+}
+
+bool KisStartupProfiler::Private::saveTrace() const
+{
+    QJsonArray traceEvents;
+
+    for (const PhaseRecord &phase : phases) {
+        QJsonObject object;
+        object["name"] = phase.name;
+        object["cat"] = "startup";
+        object["ph"] = "X";
+        object["ts"] = phase.start;
+        object["dur"] = (phase.end >= 0 ? phase.end : timestamp()) - phase.start;
+        object["pid"] = 1;
+        object["tid"] = 1;
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        warnKrita << "KisStartupProfiler: failed to open" << fileName << "for writing";
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+KisStartupProfiler::KisStartupProfiler()
+    : m_d(new Private)
+{
+    m_d->fileName = qEnvironmentVariable("KRITA_STARTUP_PROFILE");
+    m_d->enabled = !m_d->fileName.isEmpty();
+    m_d->timer.start();
+}
+
+KisStartupProfiler::~KisStartupProfiler()
+{
+}
+
+KisStartupProfiler *KisStartupProfiler::instance()
+{
+    return s_instance;
+}
+
+bool KisStartupProfiler::isEnabled() const
+{
+    return m_d->enabled;
+}
+
+int KisStartupProfiler::beginPhase(const QString &name)
+{
+    if (!m_d->enabled) return -1;
+
+    PhaseRecord phase;
+    phase.name = name;
+    phase.depth = m_d->depth++;
+    phase.start = m_d->timestamp();
+    m_d->phases.append(phase);
+
+    return m_d->phases.size() - 1;
+}
+
+void KisStartupProfiler::endPhase(int index)
+{
+    if (!m_d->enabled || index < 0) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(index < m_d->phases.size());
+
+    m_d->phases[index].end = m_d->timestamp();
+    m_d->depth--;
+}
+
+void KisStartupProfiler::finish()
+{
+    if (!m_d->enabled) return;
+    m_d->enabled = false;
+
+    m_d->printTimeline();
+    m_d->saveTrace();
+}
+
+KisStartupProfiler::Phase::Phase(const QString &name)
+    : m_index(KisStartupProfiler::instance()->beginPhase(name))
+{
+}
+
+KisStartupProfiler::Phase::~Phase()
+{
+    KisStartupProfiler::instance()->endPhase(m_index);
+}
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTARTUPPROFILER_H
+#define KISSTARTUPPROFILER_H
+
+#include "kritaglobal_export.h"
+
+#include <QScopedPointer>
+#include <QString>
+
+/**
+ * Measures the phases of Krita's startup (initialization of the
+ * resources, loading of the plugins, creation of the main window etc.)
+ *
+ * The profiler is enabled by KRITA_STARTUP_PROFILE environment variable,
+ * which specifies the name of the trace file. When the startup is
+ * finished, the timeline of the phases is printed to the log and saved
+ * in Chrome's trace event format, so it can be opened in
+ * chrome://tracing or in https://ui.perfetto.dev. When the profiler is
+ * disabled, the phases cost nothing but a check of a flag.
+ *
+ * The phases are expected to be started and finished in the GUI thread
+ * only, they may be nested.
+ */
+class KRITAGLOBAL_EXPORT KisStartupProfiler
+{
+public:
+    /**
+     * A RAII wrapper measuring a phase from its construction to its
+     * destruction
+     */
+    class KRITAGLOBAL_EXPORT Phase
+    {
+    public:
+        Phase(const QString &name);
+        ~Phase();
+
+    private:
+        Q_DISABLE_COPY(Phase)
+        int m_index;
+    };
+
+public:
+    KisStartupProfiler();
+    ~KisStartupProfiler();
+
+    static KisStartupProfiler* instance();
+
+    bool isEnabled() const;
+
+    /**
+     * Starts a new phase. Returns the handle to be passed to endPhase()
+     * or -1 if the profiler is disabled.
+     */
+    int beginPhase(const QString &name);
+    void endPhase(int index);
+
+    /**
+     * Finishes profiling: prints the timeline and writes the trace file.
+     * Does nothing when the profiler is disabled or has already finished.
+     */
+    void finish();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISSTARTUPPROFILER_H
@@ -753,6 +753,28 @@ bool fuzzyMatrixCompare(const QTransform &t1, const QTransform &t2, qreal delta)
             qAbs(t1.m33() - t2.m33()) < delta;
 }
 
+bool isPixelAlignedTransform(const QTransform &t) {
+    const qreal delta = 1e-6;
+
+    auto isIntegral = [delta] (qreal value) {
+        return qAbs(value - qRound(value)) < delta;
+    };
+
+    if (!t.isAffine() ||
+        !isIntegral(t.dx()) || !isIntegral(t.dy())) {
+
+        return false;
+    }
+
+    const bool isStraight = qAbs(t.m12()) < delta && qAbs(t.m21()) < delta &&
+        qAbs(qAbs(t.m11()) - 1.0) < delta && qAbs(qAbs(t.m22()) - 1.0) < delta;
+
+    const bool isTransposed = qAbs(t.m11()) < delta && qAbs(t.m22()) < delta &&
+        qAbs(qAbs(t.m12()) - 1.0) < delta && qAbs(qAbs(t.m21()) - 1.0) < delta;
+
+    return isStraight || isTransposed;
+}
+
 bool fuzzyPointCompare(const QPointF &p1, const QPointF &p2)
 {
     return qFuzzyCompare(p1.x(), p2.x()) && qFuzzyCompare(p1.y(), p2.y());
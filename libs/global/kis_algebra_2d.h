@@ -658,6 +658,14 @@ inline QRectF absoluteToRelative(const QRectF &rel, const QRectF &rc) {
  */
 bool KRITAGLOBAL_EXPORT fuzzyMatrixCompare(const QTransform &t1, const QTransform &t2, qreal delta);
 
+/**
+ * Returns true if \p t maps the pixel grid onto itself, that is, it is
+ * a combination of an integer translation, flips and rotations by a
+ * multiple of 90 degrees. Such a transform can be applied by moving
+ * the pixels around without any resampling.
+ */
+bool KRITAGLOBAL_EXPORT isPixelAlignedTransform(const QTransform &t);
+
 /**
  * Returns true if the two points are equal within some tolerance, where the tolerance is determined
  * by Qt's built-in fuzzy comparison functions.
@@ -0,0 +1,145 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisBelowFilthyCache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+
+
+struct KisBelowFilthyCache::Private
+{
+    QMutex mutex;
+
+    const KisNode *keyNode = nullptr;
+    QVector<const KisNode*> belowNodes;
+
+    KisPaintDeviceSP device;
+    QRegion validRegion;
+
+    void resetUnlocked() {
+        keyNode = nullptr;
+        belowNodes.clear();
+        device = nullptr;
+        validRegion = QRegion();
+    }
+
+    bool isCompatible(KisPaintDeviceSP other) const {
+        return device &&
+            *device->colorSpace() == *other->colorSpace() &&
+            device->x() == other->x() &&
+            device->y() == other->y();
+    }
+
+    void processPass(const KisNode *passKeyNode, const QVector<const KisNode*> &passBelowNodes, const QRect &rect);
+};
+
+void KisBelowFilthyCache::Private::processPass(const KisNode *passKeyNode,
+                                               const QVector<const KisNode*> &passBelowNodes,
+                                               const QRect &rect)
+{
+    if (!keyNode) return;
+
+    if (passKeyNode == keyNode) {
+        if (passBelowNodes != belowNodes) {
+            // the stack has been restructured
+            resetUnlocked();
+        }
+        return;
+    }
+
+    const int passBelowSize = passBelowNodes.size();
+    const int cachedBelowSize = belowNodes.size();
+
+    if (passBelowSize > cachedBelowSize) {
+        /**
+         * The pass key node lays above our key node, the cached
+         * composition is not affected
+         */
+        if (passBelowNodes.mid(0, cachedBelowSize) != belowNodes ||
+            passBelowNodes[cachedBelowSize] != keyNode) {
+
+            resetUnlocked();
+        }
+    } else if (passBelowSize < cachedBelowSize &&
+               belowNodes.mid(0, passBelowSize) == passBelowNodes &&
+               belowNodes[passBelowSize] == passKeyNode) {
+        /**
+         * The pass key node lays below our key node, so the cached
+         * composition is modified in the \p rect
+         */
+        validRegion -= rect;
+    } else {
+        resetUnlocked();
+    }
+}
+
+KisBelowFilthyCache::KisBelowFilthyCache()
+    : m_d(new Private)
+{
+}
+
+KisBelowFilthyCache::~KisBelowFilthyCache()
+{
+}
+
+bool KisBelowFilthyCache::fetch(const KisNode *keyNode, const QVector<const KisNode*> &belowNodes,
+                                const QRect &rect, KisPaintDeviceSP dstDevice)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->processPass(keyNode, belowNodes, rect);
+
+    if (!m_d->keyNode || m_d->keyNode != keyNode) return false;
+
+    if (!m_d->isCompatible(dstDevice)) {
+        m_d->resetUnlocked();
+        return false;
+    }
+
+    if (m_d->validRegion.intersected(rect) != QRegion(rect)) return false;
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), m_d->device, dstDevice, rect);
+    return true;
+}
+
+void KisBelowFilthyCache::store(const KisNode *keyNode, const QVector<const KisNode*> &belowNodes,
+                                const QRect &rect, KisPaintDeviceSP srcDevice)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->keyNode != keyNode ||
+        m_d->belowNodes != belowNodes ||
+        !m_d->isCompatible(srcDevice)) {
+
+        m_d->resetUnlocked();
+
+        m_d->keyNode = keyNode;
+        m_d->belowNodes = belowNodes;
+        m_d->device = new KisPaintDevice(srcDevice->colorSpace());
+        m_d->device->prepareClone(srcDevice);
+    }
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), srcDevice, m_d->device, rect);
+    m_d->validRegion += rect;
+}
+
+void KisBelowFilthyCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->resetUnlocked();
+}
+
+bool KisBelowFilthyCache::isEmpty() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return !m_d->keyNode;
+}
@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISBELOWFILTHYCACHE_H
+#define KISBELOWFILTHYCACHE_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class QRect;
+
+/**
+ * @brief caches the composition of the children of a group that lay
+ * below the filthy node
+ *
+ * When a single layer inside a group is being modified, KisAsyncMerger
+ * recomposes all the layers below it (N_BELOW_FILTHY ones) into the
+ * original of the group on every update, although they do not change.
+ * The cache keeps the result of this partial composition for the last
+ * filthy node (the "key" node), so the merger can just copy it into
+ * the group's original and blend only the nodes starting from the key
+ * one.
+ *
+ * The cache is invalidated implicitly: every merge pass through the
+ * group reports its own key node and the list of nodes below it. If
+ * the key node of the pass lays below the cached key, the area of the
+ * pass is removed from the cache. If the list of the nodes doesn't
+ * match the cached one, the cache is dropped completely.
+ *
+ * The nodes are used as identifiers only and are never dereferenced.
+ *
+ * All the methods are thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisBelowFilthyCache
+{
+public:
+    KisBelowFilthyCache();
+    ~KisBelowFilthyCache();
+
+    /**
+     * Notify the cache about a merge pass in \p rect, where \p keyNode is
+     * the lowest node that is going to be recomposed and \p belowNodes is
+     * a list of the nodes below it (bottom to top).
+     *
+     * If the cache contains the composition of \p belowNodes in the
+     * whole \p rect, it is copied into \p dstDevice and true is
+     * returned.
+     */
+    bool fetch(const KisNode *keyNode, const QVector<const KisNode*> &belowNodes,
+               const QRect &rect, KisPaintDeviceSP dstDevice);
+
+    /**
+     * Save the composition of \p belowNodes in \p rect from \p srcDevice.
+     * If the cache belongs to a different key node, it is reset
+     * and adopted by \p keyNode.
+     */
+    void store(const KisNode *keyNode, const QVector<const KisNode*> &belowNodes,
+               const QRect &rect, KisPaintDeviceSP srcDevice);
+
+    /**
+     * Drops all the cached data
+     */
+    void clear();
+
+    /**
+     * @return true if the cache holds any data
+     */
+    bool isEmpty() const;
+
+private:
+    Q_DISABLE_COPY(KisBelowFilthyCache);
+
+    struct Private;
+    QScopedPointer<Private> m_d;
+};
+
+#endif // KISBELOWFILTHYCACHE_H
@@ -63,6 +63,15 @@ public:
     {
         HashKeyType key = *reinterpret_cast<const HashKeyType*>(colorPtr);
 
+        /**
+         * The spans of the filled areas usually consist of runs of
+         * exactly the same color, so the last result is checked before
+         * doing the hash lookup.
+         */
+        if (m_lastKeyValid && key == m_lastKey) {
+            return m_lastResult;
+        }
+
         quint8 result;
 
         typename HashType::iterator it = m_differences.find(key);
@@ -74,6 +83,8 @@ public:
             m_differences.insert(key, result);
         }
 
+        rememberLastResult(key, result);
+
         return result;
     }
 
@@ -81,7 +92,17 @@ protected:
     using HashKeyType = SrcPixelType;
     using HashType = QHash<HashKeyType, quint8>;
 
+    ALWAYS_INLINE void rememberLastResult(HashKeyType key, quint8 result) const
+    {
+        m_lastKey = key;
+        m_lastResult = result;
+        m_lastKeyValid = true;
+    }
+
     mutable HashType m_differences;
+    mutable HashKeyType m_lastKey {0};
+    mutable quint8 m_lastResult {0};
+    mutable bool m_lastKeyValid {false};
 };
 
 class SlowColorOrTransparentDifferencePolicy : public SlowDifferencePolicy
@@ -120,6 +141,10 @@ public:
     {
         HashKeyType key = *reinterpret_cast<const HashKeyType*>(colorPtr);
 
+        if (this->m_lastKeyValid && key == this->m_lastKey) {
+            return this->m_lastResult;
+        }
+
         quint8 result;
 
         typename HashType::iterator it = this->m_differences.find(key);
@@ -133,6 +158,8 @@ public:
             this->m_differences.insert(key, result);
         }
 
+        this->rememberLastResult(key, result);
+
         return result;
     }
 
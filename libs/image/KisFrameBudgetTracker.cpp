@@ -0,0 +1,162 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFrameBudgetTracker.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+/**
+ * The frames presented with a bigger interval are not a part of
+ * any smooth canvas action (panning, zooming or painting)
+ */
+const qint64 maxFrameInterval = 100000;
+
+const qint64 maxDeferralTime = 250000;
+
+qint64 averageValue(qint64 average, qint64 value) {
+    return average > 0 ? (3 * average + value) / 4 : value;
+}
+
+}
+
+struct KisFrameBudgetTracker::Private
+{
+    mutable QMutex mutex;
+    QElapsedTimer timer;
+
+    bool enabled = true;
+    qint64 lastFrameTime = -1;
+    qint64 frameInterval = 0;
+    qint64 jobCost = 0;
+    qint64 deferralStartTime = -1;
+};
+
+KisFrameBudgetTracker::KisFrameBudgetTracker()
+    : m_d(new Private)
+{
+    m_d->timer.start();
+}
+
+KisFrameBudgetTracker::~KisFrameBudgetTracker()
+{
+}
+
+void KisFrameBudgetTracker::setEnabled(bool value)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->enabled = value;
+}
+
+bool KisFrameBudgetTracker::isEnabled() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->enabled;
+}
+
+qint64 KisFrameBudgetTracker::currentTime() const
+{
+    return m_d->timer.nsecsElapsed() / 1000;
+}
+
+void KisFrameBudgetTracker::reportFramePresented()
+{
+    reportFramePresented(currentTime());
+}
+
+void KisFrameBudgetTracker::reportFramePresented(qint64 time)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->lastFrameTime >= 0) {
+        const qint64 interval = time - m_d->lastFrameTime;
+
+        if (interval > 0 && interval < maxFrameInterval) {
+            m_d->frameInterval = averageValue(m_d->frameInterval, interval);
+        }
+    }
+
+    m_d->lastFrameTime = time;
+}
+
+void KisFrameBudgetTracker::reportSpontaneousJobFinished(qint64 duration)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->jobCost = averageValue(m_d->jobCost, qMax(qint64(1), duration));
+}
+
+bool KisFrameBudgetTracker::shouldDeferSpontaneousJob(int *retryDelay)
+{
+    return shouldDeferSpontaneousJob(currentTime(), retryDelay);
+}
+
+bool KisFrameBudgetTracker::shouldDeferSpontaneousJob(qint64 time, int *retryDelay)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    auto allowJob = [this] () {
+        m_d->deferralStartTime = -1;
+        return false;
+    };
+
+    if (!m_d->enabled || m_d->lastFrameTime < 0 || m_d->frameInterval <= 0) {
+        return allowJob();
+    }
+
+    const qint64 interval = m_d->frameInterval;
+    const qint64 sinceLastFrame = time - m_d->lastFrameTime;
+
+    // the canvas has stopped presenting frames
+    if (sinceLastFrame > 2 * interval) {
+        return allowJob();
+    }
+
+    // the job has been waiting for too long already
+    if (m_d->deferralStartTime >= 0 && time - m_d->deferralStartTime > maxDeferralTime) {
+        return allowJob();
+    }
+
+    const qint64 budget = interval - sinceLastFrame;
+    if (m_d->jobCost <= budget) {
+        return allowJob();
+    }
+
+    if (m_d->deferralStartTime < 0) {
+        m_d->deferralStartTime = time;
+    }
+
+    /**
+     * A job that fits into a single frame is retried right after the
+     * next frame is expected to be presented, the longer ones have to
+     * wait until the canvas becomes idle.
+     */
+    qint64 retryTime = m_d->jobCost <= interval ?
+        qMax(m_d->lastFrameTime + interval, time) :
+        m_d->lastFrameTime + 2 * interval;
+
+    retryTime = qMin(retryTime, m_d->deferralStartTime + maxDeferralTime);
+
+    if (retryDelay) {
+        *retryDelay = qMax(1, int((retryTime - time + 999) / 1000) + 1);
+    }
+
+    return true;
+}
+
+qint64 KisFrameBudgetTracker::frameInterval() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->frameInterval;
+}
+
+qint64 KisFrameBudgetTracker::spontaneousJobCost() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->jobCost;
+}
@@ -0,0 +1,64 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFRAMEBUDGETTRACKER_H
+#define KISFRAMEBUDGETTRACKER_H
+
+#include "kritaimage_export.h"
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+
+/**
+ * Tracks the rate the canvas presents its frames at and the time the
+ * spontaneous jobs take to complete. It lets the update scheduler
+ * postpone spontaneous work (outline updates, transform mask
+ * recalculation, projection recycling) while the canvas is actively
+ * presenting frames and the job would not fit into the time left
+ * before the next one.
+ *
+ * The tracker never postpones a job for longer than a quarter of a
+ * second, and it stops postponing anything as soon as the canvas
+ * becomes idle.
+ *
+ * All the times are measured in microseconds. The overloads accepting
+ * the time explicitly are used by the unittests.
+ */
+class KRITAIMAGE_EXPORT KisFrameBudgetTracker
+{
+public:
+    KisFrameBudgetTracker();
+    ~KisFrameBudgetTracker();
+
+    void setEnabled(bool value);
+    bool isEnabled() const;
+
+    void reportFramePresented();
+    void reportFramePresented(qint64 time);
+
+    void reportSpontaneousJobFinished(qint64 duration);
+
+    /**
+     * Returns true if the next spontaneous job should be postponed
+     * to avoid dropping a canvas frame. In such a case \p retryDelay
+     * is set to the number of milliseconds after which the job should
+     * be tried again.
+     */
+    bool shouldDeferSpontaneousJob(int *retryDelay);
+    bool shouldDeferSpontaneousJob(qint64 time, int *retryDelay);
+
+    qint64 currentTime() const;
+
+    qint64 frameInterval() const;
+    qint64 spontaneousJobCost() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFRAMEBUDGETTRACKER_H
@@ -7,6 +7,7 @@ void KisFrameChangeUpdateRecipe::notify(KisNode *node) const
 {
     node->invalidateFrames(affectedRange, affectedRect);
     if (totalDirtyRect.isValid()) {
-        node->setDirty(totalDirtyRect);
+        // the frames have already been invalidated precisely
+        node->setDirtyDontResetAnimationCache(totalDirtyRect);
     }
 }
@@ -0,0 +1,174 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisNumaTopology.h"
+
+#include <QGlobalStatic>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QThread>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+#if defined Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+Q_GLOBAL_STATIC(KisNumaTopology, s_instance)
+
+namespace {
+
+/**
+ * The node the current thread has been pinned to by bindCurrentThread()
+ */
+thread_local int s_boundNode = -1;
+
+#if defined Q_OS_LINUX
+/**
+ * Parses the kernel's cpu list format, e.g. "0-7,16-23"
+ */
+QVector<int> parseCpuList(const QByteArray &list)
+{
+    QVector<int> result;
+
+    Q_FOREACH (const QByteArray &range, list.trimmed().split(',')) {
+        if (range.isEmpty()) continue;
+
+        const int dash = range.indexOf('-');
+        bool startOk = false;
+        bool endOk = false;
+
+        const int start = range.left(dash >= 0 ? dash : range.size()).toInt(&startOk);
+        const int end = dash >= 0 ? range.mid(dash + 1).toInt(&endOk) : start;
+
+        if (!startOk || (dash >= 0 && !endOk) || end < start) continue;
+
+        for (int cpu = start; cpu <= end; cpu++) {
+            result.append(cpu);
+        }
+    }
+
+    return result;
+}
+#endif
+
+}
+
+KisNumaTopology::KisNumaTopology()
+{
+    bool enabled = KisImageConfig(true).numaAwareScheduling();
+
+    const QByteArray envValue = qgetenv("KRITA_NUMA_AWARE");
+    if (!envValue.isEmpty()) {
+        enabled = envValue != "0";
+    }
+
+    if (!enabled) return;
+
+    detectNodes();
+    m_enabled = m_nodeCpus.size() > 1;
+
+    if (m_enabled) {
+        dbgImage << "NUMA-aware scheduling is enabled for" << m_nodeCpus.size() << "nodes";
+    }
+}
+
+KisNumaTopology::~KisNumaTopology()
+{
+}
+
+KisNumaTopology* KisNumaTopology::instance()
+{
+    return s_instance;
+}
+
+void KisNumaTopology::detectNodes()
+{
+#if defined Q_OS_LINUX
+    QDir nodesDir("/sys/devices/system/node");
+    const QStringList entries =
+        nodesDir.entryList(QStringList() << "node*", QDir::Dirs | QDir::NoDotAndDotDot);
+
+    QRegularExpression nodeName("^node(\\d+)$");
+
+    Q_FOREACH (const QString &entry, entries) {
+        QRegularExpressionMatch match = nodeName.match(entry);
+        if (!match.hasMatch()) continue;
+
+        QFile cpuListFile(nodesDir.filePath(entry + "/cpulist"));
+        if (!cpuListFile.open(QIODevice::ReadOnly)) continue;
+
+        const QVector<int> cpus = parseCpuList(cpuListFile.readAll());
+
+        // memory-only nodes cannot run workers
+        if (cpus.isEmpty()) continue;
+
+        const int node = m_nodeCpus.size();
+        m_nodeCpus.append(cpus);
+
+        Q_FOREACH (int cpu, cpus) {
+            if (cpu >= m_cpuToNode.size()) {
+                m_cpuToNode.resize(cpu + 1);
+            }
+            m_cpuToNode[cpu] = node;
+        }
+    }
+#endif
+}
+
+int KisNumaTopology::numNodes() const
+{
+    return m_enabled ? m_nodeCpus.size() : 1;
+}
+
+int KisNumaTopology::numCpusOnNode(int node) const
+{
+    return m_enabled ? m_nodeCpus[node].size() : QThread::idealThreadCount();
+}
+
+void KisNumaTopology::bindCurrentThread()
+{
+    if (!m_enabled || s_boundNode >= 0) return;
+
+    const int node = m_nextNode.fetchAndAddRelaxed(1) % m_nodeCpus.size();
+
+#if defined Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    Q_FOREACH (int cpu, m_nodeCpus[node]) {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+        warnImage << "Failed to pin a worker thread to NUMA node" << node;
+    }
+#endif
+
+    /**
+     * Even if pinning has failed, the thread still keeps the node, so
+     * that its tiles are reused together
+     */
+    s_boundNode = node;
+}
+
+int KisNumaTopology::currentNode() const
+{
+    if (!m_enabled) return -1;
+    if (s_boundNode >= 0) return s_boundNode;
+
+#if defined Q_OS_LINUX
+    const int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < m_cpuToNode.size()) {
+        return m_cpuToNode[cpu];
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISNUMATOPOLOGY_H
+#define KISNUMATOPOLOGY_H
+
+#include "kritaimage_export.h"
+
+#include <QAtomicInt>
+#include <QVector>
+
+
+/**
+ * Describes the NUMA nodes of the machine and implements the optional
+ * NUMA-aware mode of the image workers.
+ *
+ * In NUMA-aware mode every worker thread of KisUpdaterContext is pinned
+ * to the CPUs of a single node (the nodes are assigned round-robin), and
+ * KisTileData keeps its free buffers per node, so that a tile is reused
+ * by a thread that runs on the same node where the tile was written
+ * first. Without it, the merge workers on a multi-socket machine read a
+ * significant part of the tiles through the inter-socket link.
+ *
+ * The mode is enabled by KRITA_NUMA_AWARE environment variable (set to
+ * "1" or "0" to override the config) or by "numaAwareScheduling" option
+ * of KisImageConfig. It is read once on startup and is silently off on
+ * machines with a single node and on systems other than Linux.
+ */
+class KRITAIMAGE_EXPORT KisNumaTopology
+{
+public:
+    KisNumaTopology();
+    ~KisNumaTopology();
+
+    static KisNumaTopology* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled;
+    }
+
+    int numNodes() const;
+    int numCpusOnNode(int node) const;
+
+    /**
+     * Pins the current thread to the CPUs of the next node in
+     * round-robin order. Does nothing if the mode is disabled or
+     * the thread has already been pinned.
+     */
+    void bindCurrentThread();
+
+    /**
+     * The node the current thread is running on, or -1 if the mode
+     * is disabled
+     */
+    int currentNode() const;
+
+private:
+    void detectNodes();
+
+private:
+    Q_DISABLE_COPY(KisNumaTopology)
+
+    bool m_enabled = false;
+    QVector<QVector<int>> m_nodeCpus;
+    QVector<int> m_cpuToNode;
+    QAtomicInt m_nextNode;
+};
+
+#endif // KISNUMATOPOLOGY_H
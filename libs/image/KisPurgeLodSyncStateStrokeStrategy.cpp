@@ -0,0 +1,48 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPurgeLodSyncStateStrokeStrategy.h"
+
+#include <kis_image.h>
+#include "kis_layer_utils.h"
+#include "krita_utils.h"
+#include "kis_paint_device.h"
+
+
+KisPurgeLodSyncStateStrokeStrategy::KisPurgeLodSyncStateStrokeStrategy(KisImageWSP image)
+    : KisSimpleStrokeStrategy(QLatin1String("purge_lod_sync_state_stroke")),
+      m_image(image)
+{
+    enableJob(JOB_INIT, true, KisStrokeJobData::SEQUENTIAL, KisStrokeJobData::EXCLUSIVE);
+
+    setRequestsOtherStrokesToEnd(false);
+    setClearsRedoOnStart(false);
+    setCanForgetAboutMe(true);
+    setPriority(BACKGROUND_PRIORITY);
+}
+
+KisPurgeLodSyncStateStrokeStrategy::~KisPurgeLodSyncStateStrokeStrategy()
+{
+}
+
+void KisPurgeLodSyncStateStrokeStrategy::initStrokeCallback()
+{
+    KisImageSP image = m_image;
+    if (!image) return;
+
+    KisPaintDeviceList deviceList;
+
+    KisLayerUtils::recursiveApplyNodes(image->root(),
+        [&deviceList](KisNodeSP node) {
+             deviceList << node->getLodCapableDevices();
+        });
+
+    KritaUtils::makeContainerUnique(deviceList);
+
+    Q_FOREACH (KisPaintDeviceSP device, deviceList) {
+        device->purgeLodSyncState();
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPURGELODSYNCSTATESTROKESTRATEGY_H
+#define KISPURGELODSYNCSTATESTROKESTRATEGY_H
+
+#include "kritaimage_export.h"
+#include <kis_simple_stroke_strategy.h>
+#include "kis_types.h"
+
+/**
+ * Drops the state of the last LoD synchronization kept by all the
+ * paint devices of the image (see KisPaintDevice::purgeLodSyncState()).
+ * The state is useless while the image is not painted in LoD mode,
+ * so the image starts this stroke when LoD mode is turned off.
+ *
+ * The stroke is forgettable and runs with background priority.
+ */
+class KRITAIMAGE_EXPORT KisPurgeLodSyncStateStrokeStrategy : public KisSimpleStrokeStrategy
+{
+public:
+    KisPurgeLodSyncStateStrokeStrategy(KisImageWSP image);
+    ~KisPurgeLodSyncStateStrokeStrategy() override;
+
+private:
+    void initStrokeCallback() override;
+
+private:
+    KisImageWSP m_image;
+};
+
+#endif // KISPURGELODSYNCSTATESTROKESTRATEGY_H
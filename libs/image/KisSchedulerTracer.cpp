@@ -0,0 +1,211 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSchedulerTracer.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include <kis_debug.h>
+#include "kis_image_config.h"
+
+Q_GLOBAL_STATIC(KisSchedulerTracer, s_instance)
+
+namespace {
+
+/**
+ * The events are kept in memory until the trace is saved, so
+ * limit their number to keep long sessions from eating all RAM
+ */
+const int maxEvents = 1000000;
+
+struct Event {
+    char phase = 'X';
+    const char *category = 0;
+    QString name;
+    qint64 timestamp = 0;
+    qint64 duration = 0;
+    quintptr threadId = 0;
+    QVector<std::pair<const char*, qint64>> args;
+};
+
+}
+
+struct KisSchedulerTracer::Private
+{
+    QMutex mutex;
+    QElapsedTimer timer;
+    QString fileName;
+    QVector<Event> events;
+    int droppedEvents = 0;
+
+    void addEvent(Event &&event) {
+        QMutexLocker l(&mutex);
+
+        if (events.size() >= maxEvents) {
+            droppedEvents++;
+            return;
+        }
+
+        events.append(std::move(event));
+    }
+};
+
+KisSchedulerTracer::KisSchedulerTracer()
+    : m_d(new Private)
+{
+    QString fileName = qEnvironmentVariable("KRITA_SCHEDULER_TRACE");
+    if (fileName.isEmpty()) {
+        fileName = KisImageConfig(true).schedulerTraceFile();
+    }
+
+    if (!fileName.isEmpty()) {
+        start(fileName);
+    }
+}
+
+KisSchedulerTracer::~KisSchedulerTracer()
+{
+    if (isEnabled()) {
+        stop();
+    }
+}
+
+KisSchedulerTracer* KisSchedulerTracer::instance()
+{
+    return s_instance;
+}
+
+void KisSchedulerTracer::start(const QString &fileName)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->fileName = fileName;
+    m_d->events.clear();
+    m_d->droppedEvents = 0;
+    m_d->timer.start();
+
+    m_enabled.storeRelaxed(true);
+}
+
+bool KisSchedulerTracer::stop()
+{
+    m_enabled.storeRelaxed(false);
+    return save(m_d->fileName);
+}
+
+qint64 KisSchedulerTracer::timestamp() const
+{
+    return m_d->timer.nsecsElapsed() / 1000;
+}
+
+void KisSchedulerTracer::addSpan(const char *category, const QString &name, qint64 startTime, Args args)
+{
+    if (!isEnabled()) return;
+
+    Event event;
+    event.phase = 'X';
+    event.category = category;
+    event.name = name;
+    event.timestamp = startTime;
+    event.duration = timestamp() - startTime;
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    event.args = args;
+
+    m_d->addEvent(std::move(event));
+}
+
+void KisSchedulerTracer::addInstant(const char *category, const QString &name, Args args)
+{
+    if (!isEnabled()) return;
+
+    Event event;
+    event.phase = 'i';
+    event.category = category;
+    event.name = name;
+    event.timestamp = timestamp();
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    event.args = args;
+
+    m_d->addEvent(std::move(event));
+}
+
+void KisSchedulerTracer::addCounter(const char *name, Args args)
+{
+    if (!isEnabled()) return;
+
+    Event event;
+    event.phase = 'C';
+    event.category = "counters";
+    event.name = QString::fromLatin1(name);
+    event.timestamp = timestamp();
+    event.args = args;
+
+    m_d->addEvent(std::move(event));
+}
+
+bool KisSchedulerTracer::save(const QString &fileName) const
+{
+    QJsonArray traceEvents;
+    int droppedEvents = 0;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        for (const Event &event : std::as_const(m_d->events)) {
+            QJsonObject object;
+            object["name"] = event.name;
+            object["cat"] = QString::fromLatin1(event.category);
+            object["ph"] = QString(QChar::fromLatin1(event.phase));
+            object["ts"] = event.timestamp;
+            object["pid"] = 1;
+            object["tid"] = qint64(event.threadId);
+
+            if (event.phase == 'X') {
+                object["dur"] = event.duration;
+            } else if (event.phase == 'i') {
+                object["s"] = "t";
+            }
+
+            if (!event.args.isEmpty()) {
+                QJsonObject args;
+                for (auto it = event.args.begin(); it != event.args.end(); ++it) {
+                    args[QString::fromLatin1(it->first)] = it->second;
+                }
+                object["args"] = args;
+            }
+
+            traceEvents.append(object);
+        }
+
+        droppedEvents = m_d->droppedEvents;
+    }
+
+    if (droppedEvents) {
+        warnKrita << "KisSchedulerTracer: the trace is too long," << droppedEvents << "events have been dropped";
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        warnKrita << "KisSchedulerTracer: failed to open" << fileName << "for writing";
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
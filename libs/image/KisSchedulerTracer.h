@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSCHEDULERTRACER_H
+#define KISSCHEDULERTRACER_H
+
+#include "kritaimage_export.h"
+
+#include <initializer_list>
+#include <utility>
+
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QString>
+
+
+/**
+ * A lightweight tracing layer for the update scheduler. When enabled,
+ * it records the spans of the merge, stroke and spontaneous jobs, the
+ * depth of the queues and a few markers (strokes being started and
+ * finished, canvas updates), and saves them in Chrome's trace event
+ * format. The resulting file can be opened in chrome://tracing or in
+ * https://ui.perfetto.dev.
+ *
+ * Tracing is enabled by KRITA_SCHEDULER_TRACE environment variable or
+ * by "schedulerTraceFile" option of KisImageConfig. Both specify the
+ * name of the file the trace is saved to when Krita exits. When tracing
+ * is disabled every call costs a single atomic load.
+ */
+class KRITAIMAGE_EXPORT KisSchedulerTracer
+{
+public:
+    using Args = std::initializer_list<std::pair<const char*, qint64>>;
+
+public:
+    KisSchedulerTracer();
+    ~KisSchedulerTracer();
+
+    static KisSchedulerTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled.loadRelaxed();
+    }
+
+    /**
+     * Drops all the recorded events and starts recording a new trace,
+     * which will be saved into \p fileName on stop()
+     */
+    void start(const QString &fileName);
+
+    /**
+     * Stops recording and saves the trace into the file passed to
+     * start(). Returns false if the file couldn't be written.
+     */
+    bool stop();
+
+    bool save(const QString &fileName) const;
+
+    /**
+     * Time since the start of the trace in microseconds
+     */
+    qint64 timestamp() const;
+
+    /**
+     * Records a span of work on the current thread that has started
+     * at \p startTime (as returned by timestamp()) and ends now
+     */
+    void addSpan(const char *category, const QString &name, qint64 startTime, Args args = {});
+
+    void addInstant(const char *category, const QString &name, Args args = {});
+    void addCounter(const char *name, Args args);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+    QAtomicInt m_enabled;
+};
+
+#endif // KISSCHEDULERTRACER_H
@@ -0,0 +1,213 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILESPANITERATOR_H
+#define KISTILESPANITERATOR_H
+
+#include <QRect>
+
+#include <KoAlwaysInline.h>
+
+#include "kis_types.h"
+#include "kis_paint_device.h"
+#include "kis_random_accessor_ng.h"
+
+
+struct ReadOnlyTileSpanPolicy {
+    typedef KisRandomConstAccessorSP AccessorTypeSP;
+
+    ReadOnlyTileSpanPolicy(KisPaintDeviceSP dev, const QRect &rect) {
+        m_accessor = !rect.isEmpty() ? dev->createRandomConstAccessorNG() : 0;
+    }
+
+    ALWAYS_INLINE void updatePointersCache() {
+        m_rawDataConst = m_accessor->rawDataConst();
+        m_oldRawData = m_accessor->oldRawData();
+    }
+
+    ALWAYS_INLINE const quint8* rawDataConst() const {
+        return m_rawDataConst;
+    }
+
+    ALWAYS_INLINE const quint8* oldRawData() const {
+        return m_oldRawData;
+    }
+
+    AccessorTypeSP m_accessor;
+
+private:
+    const quint8 *m_rawDataConst {nullptr};
+    const quint8 *m_oldRawData {nullptr};
+};
+
+struct WritableTileSpanPolicy {
+    typedef KisRandomAccessorSP AccessorTypeSP;
+
+    WritableTileSpanPolicy(KisPaintDeviceSP dev, const QRect &rect) {
+        m_accessor = !rect.isEmpty() ? dev->createRandomAccessorNG() : 0;
+    }
+
+    ALWAYS_INLINE void updatePointersCache() {
+        m_rawData = m_accessor->rawData();
+        m_oldRawData = m_accessor->oldRawData();
+    }
+
+    ALWAYS_INLINE quint8* rawData() {
+        return m_rawData;
+    }
+
+    ALWAYS_INLINE const quint8* rawDataConst() const {
+        return m_rawData;
+    }
+
+    ALWAYS_INLINE const quint8* oldRawData() const {
+        return m_oldRawData;
+    }
+
+    AccessorTypeSP m_accessor;
+
+private:
+    quint8 *m_rawData {nullptr};
+    const quint8 *m_oldRawData {nullptr};
+};
+
+/**
+ * Tile span iterator walks through a rect of the device in blocks of
+ * contiguous memory, one block per tile. Every span is the part of the
+ * rect covered by a single tile, so the tile is fetched and locked only
+ * once and the kernel can process the whole block (usually 64x64
+ * pixels) with plain pointer arithmetic, without any per-pixel or
+ * per-row bookkeeping of the iterator.
+ *
+ * The rows of the span are not adjacent in memory: use rowStride() to
+ * get from one row to the next one.
+ *
+ * The iterator follows the same "java-style" rules as the sequential
+ * iterator: call nextSpan() before accessing the first span.
+ *
+ * \code{.cpp}
+ * KisTileSpanConstIterator it(dev, rect);
+ * while (it.nextSpan()) {
+ *     const quint8 *row = it.rawDataConst();
+ *
+ *     for (int y = 0; y < it.height(); y++) {
+ *         // process it.width() consecutive pixels of the row
+ *         processPixelData(row, it.width());
+ *         row += it.rowStride();
+ *     }
+ * }
+ * \endcode
+ *
+ * The spans are visited in the row-major order of the tiles. The
+ * writable version of the iterator creates the tiles of the device
+ * that do not exist yet, exactly like KisSequentialIterator does.
+ */
+template <class SpanPolicy>
+class KisTileSpanIteratorBase
+{
+public:
+    KisTileSpanIteratorBase(KisPaintDeviceSP dev, const QRect &rect)
+        : m_policy(dev, rect),
+          m_rect(rect),
+          m_x(rect.x()),
+          m_y(rect.y())
+    {
+    }
+
+    inline bool nextSpan() {
+        if (!m_policy.m_accessor || m_isFinished) return false;
+
+        if (!m_isStarted) {
+            m_isStarted = true;
+        } else {
+            m_x += m_width;
+
+            if (m_x > m_rect.right()) {
+                m_x = m_rect.x();
+                m_y += m_height;
+
+                if (m_y > m_rect.bottom()) {
+                    m_isFinished = true;
+                    return false;
+                }
+            }
+        }
+
+        m_width = qMin(m_policy.m_accessor->numContiguousColumns(m_x), m_rect.right() + 1 - m_x);
+        m_height = qMin(m_policy.m_accessor->numContiguousRows(m_y), m_rect.bottom() + 1 - m_y);
+        m_rowStride = m_policy.m_accessor->rowStride(m_x, m_y);
+
+        m_policy.m_accessor->moveTo(m_x, m_y);
+        m_policy.updatePointersCache();
+
+        return true;
+    }
+
+    /**
+     * The top-left pixel of the current span in the coordinates
+     * of the device
+     */
+    ALWAYS_INLINE int x() const {
+        return m_x;
+    }
+
+    ALWAYS_INLINE int y() const {
+        return m_y;
+    }
+
+    ALWAYS_INLINE int width() const {
+        return m_width;
+    }
+
+    ALWAYS_INLINE int height() const {
+        return m_height;
+    }
+
+    ALWAYS_INLINE QRect rect() const {
+        return QRect(m_x, m_y, m_width, m_height);
+    }
+
+    /**
+     * The distance in bytes between the beginnings of two
+     * consecutive rows of the span
+     */
+    ALWAYS_INLINE int rowStride() const {
+        return m_rowStride;
+    }
+
+    // SFINAE: This method becomes undefined for const version of the
+    //         iterator automatically
+    ALWAYS_INLINE quint8* rawData() {
+        return m_policy.rawData();
+    }
+
+    ALWAYS_INLINE const quint8* rawDataConst() const {
+        return m_policy.rawDataConst();
+    }
+
+    ALWAYS_INLINE const quint8* oldRawData() const {
+        return m_policy.oldRawData();
+    }
+
+private:
+    Q_DISABLE_COPY(KisTileSpanIteratorBase)
+    SpanPolicy m_policy;
+    const QRect m_rect;
+
+    int m_x;
+    int m_y;
+    int m_width {0};
+    int m_height {0};
+    int m_rowStride {0};
+
+    bool m_isStarted {false};
+    bool m_isFinished {false};
+};
+
+typedef KisTileSpanIteratorBase<ReadOnlyTileSpanPolicy> KisTileSpanConstIterator;
+typedef KisTileSpanIteratorBase<WritableTileSpanPolicy> KisTileSpanIterator;
+
+#endif // KISTILESPANITERATOR_H
@@ -8,6 +8,7 @@
 
 #include <QDomElement>
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "kis_paintop.h"
 #include "kis_algebra_2d.h"
@@ -48,6 +49,15 @@ struct KisPaintInformation::Private {
     ~Private() {
         KIS_ASSERT_RECOVER_NOOP(!sanityIsRegistered);
     }
+
+    /**
+     * Every tablet event and every interpolated dab creates a few
+     * paint information objects, so the private data is allocated
+     * from a per-thread pool of freed objects instead of the heap
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     Private(const Private &rhs) {
         copy(rhs);
     }
@@ -150,6 +160,78 @@ struct KisPaintInformation::Private {
     }
 };
 
+namespace {
+
+/**
+ * The free list of a thread is destroyed on the thread exit, but some
+ * objects may still be freed after that (e.g. the ones stored in
+ * thread-local or static storage), so track its state explicitly.
+ */
+enum FreeListState {
+    FreeListNotCreated = 0,
+    FreeListAlive,
+    FreeListDestroyed
+};
+
+thread_local int s_freeListState = FreeListNotCreated;
+
+struct PrivateFreeList
+{
+    /**
+     * The objects are usually created in the GUI thread and destroyed
+     * in the threads of the stroke, so the lists should not grow
+     * unbounded
+     */
+    static const int maxSize = 512;
+
+    PrivateFreeList() {
+        items.reserve(maxSize);
+        s_freeListState = FreeListAlive;
+    }
+
+    ~PrivateFreeList() {
+        s_freeListState = FreeListDestroyed;
+        for (void *ptr : items) {
+            ::operator delete(ptr);
+        }
+    }
+
+    std::vector<void*> items;
+};
+
+thread_local PrivateFreeList s_freeList;
+
+}
+
+void* KisPaintInformation::Private::operator new(size_t size)
+{
+    if (size == sizeof(Private) &&
+        s_freeListState != FreeListDestroyed &&
+        !s_freeList.items.empty()) {
+
+        void *ptr = s_freeList.items.back();
+        s_freeList.items.pop_back();
+        return ptr;
+    }
+
+    return ::operator new(size);
+}
+
+void KisPaintInformation::Private::operator delete(void *ptr, size_t size)
+{
+    if (!ptr) return;
+
+    if (size == sizeof(Private) &&
+        s_freeListState != FreeListDestroyed &&
+        s_freeList.items.size() < size_t(PrivateFreeList::maxSize)) {
+
+        s_freeList.items.push_back(ptr);
+        return;
+    }
+
+    ::operator delete(ptr);
+}
+
 KisPaintInformation::DistanceInformationRegistrar::
 DistanceInformationRegistrar(KisPaintInformation *_p, KisDistanceInformation *distanceInfo)
     : p(_p)
@@ -10,6 +10,7 @@
 #include "kis_node.h"
 #include "commands/kis_node_commands.h"
 #include "kis_command_ids.h"
+#include "kis_time_span.h"
 
 KisNodeCompositeOpCommand::KisNodeCompositeOpCommand(KisNodeSP node, const QString& newCompositeOp) :
         KisNodeCommand(kundo2_i18n("Composition Mode Change"), node)
@@ -26,6 +27,9 @@ void KisNodeCompositeOpCommand::setCompositeOpImpl(const QString &compositeOp)
     const QRect oldExtent = m_node->extent();
     m_node->setCompositeOpId(compositeOp);
     m_node->setDirty(oldExtent | m_node->extent());
+
+    // the composite op is not animated, so all the frames have changed
+    m_node->invalidateFrames(KisTimeSpan::infinite(0), QRect());
 }
 
 void KisNodeCompositeOpCommand::redo()
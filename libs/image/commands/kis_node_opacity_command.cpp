@@ -18,6 +18,24 @@
 
 using namespace KisCommandUtils;
 
+namespace {
+
+void invalidateNonAnimatedOpacityFrames(KisNodeSP node)
+{
+    /**
+     * BUG:499389 workaround.
+     * Unlike drawing, non-animated opacity changes need to be recached
+     * across all raster frames. The animated opacity invalidates the
+     * affected frames itself, when the value of the keyframe changes.
+     */
+    KisKeyframeChannel *channel = node->getKeyframeChannel(KisKeyframeChannel::Opacity.id());
+    if (!channel || !channel->keyframeCount()) {
+        node->invalidateFrames(KisTimeSpan::infinite(0), QRect());
+    }
+}
+
+}
+
 KisNodeOpacityCommand::KisNodeOpacityCommand(KisNodeSP node, quint8 newOpacity) :
         KisNodeCommand(kundo2_i18n("Opacity Change"), node)
 {
@@ -48,11 +66,7 @@ void KisNodeOpacityCommand::redo()
 
     m_node->setOpacity(m_newOpacity);
     m_node->setDirty();
-
-    // BUG:499389 workaround.
-    // Unlike drawing, non-animated opacity changes need to be recached across all raster frames.
-    // It's probably better to change KisNode::setDirty, KisImage::requestProjectionUpdate, and/or KisProjectionUpdateFlags.
-    m_node->invalidateFrames(KisTimeSpan::infinite(0), QRect());
+    invalidateNonAnimatedOpacityFrames(m_node);
 }
 
 void KisNodeOpacityCommand::undo()
@@ -61,6 +75,7 @@ void KisNodeOpacityCommand::undo()
 
     m_node->setOpacity(*m_oldOpacity);
     m_node->setDirty();
+    invalidateNonAnimatedOpacityFrames(m_node);
 
     if (m_autokey) {
         m_autokey->undo();
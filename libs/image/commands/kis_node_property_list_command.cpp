@@ -14,6 +14,7 @@
 #include "kis_undo_adapter.h"
 #include "kis_layer_properties_icons.h"
 #include "kis_command_ids.h"
+#include "kis_time_span.h"
 
 // HACK! please refactor out!
 #include "kis_simple_stroke_strategy.h"
@@ -206,6 +207,9 @@ void KisNodePropertyListCommand::doUpdate(const KisBaseNode::PropertyList &oldPr
         m_node->setDirtyDontResetAnimationCache(totalUpdateExtent);
     } else {
         m_node->setDirty(totalUpdateExtent); // TODO check if visibility was actually changed or not
+
+        // the properties are not animated, so all the frames have changed
+        m_node->invalidateFrames(KisTimeSpan::infinite(0), QRect());
     }
 }
 
@@ -141,6 +141,10 @@ bool KisSavedCommand::isMerged() const
 {
     return m_command->isMerged();
 }
+qint64 KisSavedCommand::memoryCost() const
+{
+    return m_command->memoryCost();
+}
 
 
 
@@ -341,6 +345,17 @@ void KisSavedMacroCommand::setOverrideInfo(const KisSavedMacroCommand *overridde
     m_d->skipWhenOverride = skipWhileOverride;
 }
 
+qint64 KisSavedMacroCommand::memoryCost() const
+{
+    qint64 cost = KisSavedCommandBase::memoryCost();
+
+    Q_FOREACH (const Private::SavedCommand &command, m_d->commands) {
+        cost += command.command->memoryCost();
+    }
+
+    return cost;
+}
+
 void KisSavedMacroCommand::addCommands(KisStrokeId id, bool undo)
 {
     QVector<KisStrokeJobData *> jobs;
@@ -24,8 +24,10 @@
 #include <QtMath>
 #include <QMutex>
 #include <QMutexLocker>
+#include <vector>
 #include <KoColor.h>
 #include <KoColorSpaceRegistry.h>
+#include <kis_global.h>
 
 #if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
 #include <QElapsedTimer>
@@ -60,10 +62,10 @@ ALWAYS_INLINE QPoint TransformMirrorHorizontally(int x, int y, int xOffset, int
 } // anonymous namespace
 
 template<bool BoundsCheck>
-bool KisGapMap::isOpaque(int x, int y)
+bool KisGapMap::isOpaque(DistanceContext& context, int x, int y)
 {
 #if KIS_GAP_MAP_DEBUG_LOGGING_AND_ASSERTS
-    const TileFlags flags = *tileFlagsPtr(x / TileSize, y / TileSize);
+    const TileFlags flags = *context.tileFlagsPtr(x / TileSize, y / TileSize);
     KIS_SAFE_ASSERT_RECOVER((flags & TILE_OPACITY_LOADED) != 0) {
         qDebug() << "ERROR: opacity at (" << x << "," << y << ") not loaded";
         return false;
@@ -71,19 +73,19 @@ bool KisGapMap::isOpaque(int x, int y)
 #endif
     if (BoundsCheck) {
         if ((x >= 0) && (x < m_size.width()) && (y >= 0) && (y < m_size.height())) {
-            return dataPtr(x, y)->opacity == MIN_SELECTED;
+            return context.dataPtr(x, y)->opacity == MIN_SELECTED;
         } else {
             return false;
         }
     } else {
-        return dataPtr(x, y)->opacity == MIN_SELECTED;
+        return context.dataPtr(x, y)->opacity == MIN_SELECTED;
     }
 }
 
 template<bool BoundsCheck>
-bool KisGapMap::isOpaque(const QPoint& p)
+bool KisGapMap::isOpaque(DistanceContext& context, const QPoint& p)
 {
-    return isOpaque<BoundsCheck>(p.x(), p.y());
+    return isOpaque<BoundsCheck>(context, p.x(), p.y());
 }
 
 KisGapMap::KisGapMap(int gapSize,
@@ -110,6 +112,65 @@ KisGapMap::KisGapMap(int gapSize,
     m_deviceSp->fill(mapBounds, color);
 }
 
+void KisGapMap::setFillOpacityFunc(const FillOpacityFunc& fillOpacityFunc)
+{
+    m_fillOpacityFunc = fillOpacityFunc;
+}
+
+void KisGapMap::invalidateChangedTiles(const std::function<bool(const QRect& rect)>& tileChanged)
+{
+    QVector<QPoint> changedTiles;
+
+    for (int ty = 0; ty < m_numTiles.height(); ++ty) {
+        for (int tx = 0; tx < m_numTiles.width(); ++tx) {
+            if ((*tileFlagsPtr(tx, ty) & TILE_OPACITY_LOADED) == 0) continue;
+
+            QRect rect(tx * TileSize, ty * TileSize, TileSize, TileSize);
+            rect.setRight(qMin(rect.right(), m_size.width() - 1));
+            rect.setBottom(qMin(rect.bottom(), m_size.height() - 1));
+
+            if (tileChanged(rect)) {
+                changedTiles.append(QPoint(tx, ty));
+            }
+        }
+    }
+
+    if (changedTiles.isEmpty()) return;
+
+    // The distance data of a tile depends on the opacity of the adjacent tiles.
+    QVector<QPoint> distanceTiles;
+    std::vector<bool> isDistanceTile(size_t(m_numTiles.width()) * m_numTiles.height(), false);
+
+    Q_FOREACH (const QPoint &tile, changedTiles) {
+        for (int ty = qMax(0, tile.y() - 1); ty <= qMin(tile.y() + 1, m_numTiles.height() - 1); ++ty) {
+            for (int tx = qMax(0, tile.x() - 1); tx <= qMin(tile.x() + 1, m_numTiles.width() - 1); ++tx) {
+                const size_t index = size_t(ty) * m_numTiles.width() + tx;
+
+                if (!isDistanceTile[index] && (*tileFlagsPtr(tx, ty) & TILE_DISTANCE_LOADED)) {
+                    isDistanceTile[index] = true;
+                    distanceTiles.append(QPoint(tx, ty));
+                }
+            }
+        }
+    }
+
+    Q_FOREACH (const QPoint &tile, distanceTiles) {
+        Data* tileData = reinterpret_cast<Data*>(m_accessor->tileRawData(tile.x(), tile.y()));
+        for (int i = 0; i < TileSize * TileSize; ++i) {
+            tileData[i].distance = DISTANCE_INFINITE;
+        }
+        tileData->flags &= ~TILE_DISTANCE_LOADED;
+    }
+
+    Q_FOREACH (const QPoint &tile, changedTiles) {
+        Data* tileData = reinterpret_cast<Data*>(m_accessor->tileRawData(tile.x(), tile.y()));
+        for (int i = 0; i < TileSize * TileSize; ++i) {
+            tileData[i].opacity = MAX_SELECTED;
+        }
+        tileData->flags &= ~(TILE_OPACITY_LOADED | TILE_HAS_OPAQUE_PIXELS);
+    }
+}
+
 void KisGapMap::loadOpacityTiles(const QRect& tileRect)
 {
 #if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
@@ -117,25 +178,38 @@ void KisGapMap::loadOpacityTiles(const QRect& tileRect)
     timer.start();
 #endif
 
+    QVector<QPoint> tiles;
+
     for (int ty = tileRect.top(); ty <= tileRect.bottom(); ++ty) {
         for (int tx = tileRect.left(); tx <= tileRect.right(); ++tx) {
-            TileFlags* const pFlags = tileFlagsPtr(tx, ty);
-            if ((*pFlags & TILE_OPACITY_LOADED) == 0) {
-                // Resize and clamp to image bounds.
-                QRect rect(tx * TileSize, ty * TileSize, TileSize, TileSize);
-                rect.setRight(qMin(rect.right(), m_size.width() - 1));
-                rect.setBottom(qMin(rect.bottom(), m_size.height() - 1));
+            if ((*tileFlagsPtr(tx, ty) & TILE_OPACITY_LOADED) == 0) {
+                tiles.append(QPoint(tx, ty));
+            }
+        }
+    }
+
+    QVector<bool> hasOpaquePixels(tiles.size());
+
+    for (int index = 0; index < tiles.size(); index++) {
+        const QPoint &tile = tiles[index];
+
+        // Resize and clamp to image bounds.
+        QRect rect(tile.x() * TileSize, tile.y() * TileSize, TileSize, TileSize);
+        rect.setRight(qMin(rect.right(), m_size.width() - 1));
+        rect.setBottom(qMin(rect.bottom(), m_size.height() - 1));
 
 #if KIS_GAP_MAP_DEBUG_LOGGING_AND_ASSERTS
-                qDebug() << "loadOpacityTiles()" << rect;
+        qDebug() << "loadOpacityTiles()" << rect;
 #endif
-                // It's not too elegant to pass the device, but this performs the best for now.
-                const bool hasOpaquePixels = m_fillOpacityFunc(m_deviceSp.data(), rect);
+        // It's not too elegant to pass the device, but this performs the best for now.
+        hasOpaquePixels[index] = m_fillOpacityFunc(m_deviceSp.data(), rect);
+    }
 
-                // This tile is now loaded.
-                *pFlags |= TILE_OPACITY_LOADED | (hasOpaquePixels ? TILE_HAS_OPAQUE_PIXELS : 0);
-            }
-        }
+    // The flags are written only after all the tiles are loaded, because
+    // they share the data with the opacity of the first pixel of the tile.
+    for (int i = 0; i < tiles.size(); i++) {
+        *tileFlagsPtr(tiles[i].x(), tiles[i].y()) |=
+            TILE_OPACITY_LOADED | (hasOpaquePixels[i] ? TILE_HAS_OPAQUE_PIXELS : 0);
     }
 
 #if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
@@ -143,25 +217,66 @@ void KisGapMap::loadOpacityTiles(const QRect& tileRect)
 #endif
 }
 
+/**
+ * Calculate the gap distance data of all the tiles in \p tileRect, which
+ * are not loaded yet. Every tile depends only on the opacity data of the
+ * adjacent tiles. The fill runs inside a stroke job, so the tiles are
+ * calculated serially in the calling thread.
+ */
+void KisGapMap::loadDistanceTiles(const QRect& tileRect)
+{
+    const QRect nearbyTilesRect =
+        kisGrowRect(tileRect, 1) & QRect(QPoint(), m_numTiles);
+
+    // For opacity data, we always load all the adjacent tiles.
+    loadOpacityTiles(nearbyTilesRect);
+
+    QVector<QPoint> tiles;
+
+    for (int ty = tileRect.top(); ty <= tileRect.bottom(); ++ty) {
+        for (int tx = tileRect.left(); tx <= tileRect.right(); ++tx) {
+            if ((*tileFlagsPtr(tx, ty) & TILE_DISTANCE_LOADED) == 0) {
+                tiles.append(QPoint(tx, ty));
+            }
+        }
+    }
+
+    Q_FOREACH (const QPoint &tile, tiles) {
+        // Clamped tile neighborhood.
+        const QPoint topLeft(qMax(0, tile.x() - 1),
+                             qMax(0, tile.y() - 1));
+        const QPoint bottomRight(qMin(tile.x() + 1, m_numTiles.width() - 1),
+                                 qMin(tile.y() + 1, m_numTiles.height() - 1));
+
+        DistanceContext context(m_deviceSp);
+        loadDistanceTile(context, tile, QRect(topLeft, bottomRight), m_gapSize);
+    }
+
+    // These tiles are now considered loaded.
+    Q_FOREACH (const QPoint &tile, tiles) {
+        *tileFlagsPtr(tile.x(), tile.y()) |= TILE_DISTANCE_LOADED;
+    }
+}
+
 /** This is a part of loadDistanceTile() implementation. */
-void KisGapMap::distanceSearchRowInnerLoop(bool boundsCheck, int y, int x1, int x2)
+void KisGapMap::distanceSearchRowInnerLoop(DistanceContext& context, bool boundsCheck, int y, int x1, int x2)
 {
     if (boundsCheck) {
         for (int x = x1; x <= x2; ++x) {
-            if (isOpaque<true>(x, y)) {
-                gapDistanceSearch<true>(x, y, TransformNone);
-                gapDistanceSearch<true>(x, y, TransformRotateClockwiseMirrorHorizontally);
-                gapDistanceSearch<true>(x, y, TransformRotateClockwise);
-                gapDistanceSearch<true>(x, y, TransformMirrorHorizontally);
+            if (isOpaque<true>(context, x, y)) {
+                gapDistanceSearch<true>(context, x, y, TransformNone);
+                gapDistanceSearch<true>(context, x, y, TransformRotateClockwiseMirrorHorizontally);
+                gapDistanceSearch<true>(context, x, y, TransformRotateClockwise);
+                gapDistanceSearch<true>(context, x, y, TransformMirrorHorizontally);
             }
         }
     } else {
         for (int x = x1; x <= x2; ++x) {
-            if (isOpaque<false>(x, y)) {
-                gapDistanceSearch<false>(x, y, TransformNone);
-                gapDistanceSearch<false>(x, y, TransformRotateClockwiseMirrorHorizontally);
-                gapDistanceSearch<false>(x, y, TransformRotateClockwise);
-                gapDistanceSearch<false>(x, y, TransformMirrorHorizontally);
+            if (isOpaque<false>(context, x, y)) {
+                gapDistanceSearch<false>(context, x, y, TransformNone);
+                gapDistanceSearch<false>(context, x, y, TransformRotateClockwiseMirrorHorizontally);
+                gapDistanceSearch<false>(context, x, y, TransformRotateClockwise);
+                gapDistanceSearch<false>(context, x, y, TransformMirrorHorizontally);
             }
         }
     }
@@ -177,36 +292,28 @@ void KisGapMap::distanceSearchRowInnerLoop(bool boundsCheck, int y, int x1, int
  *  and must be at least equal to the gap size. We need to do calculations in
  *  a larger region in order to compute correct distances within the requested rect.
  */
-void KisGapMap::loadDistanceTile(const QPoint& tile, const QRect& nearbyTilesRect, int guardBand)
+void KisGapMap::loadDistanceTile(DistanceContext& context, const QPoint& tile, const QRect& nearbyTilesRect, int guardBand)
 {
-#if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
-    QElapsedTimer timer;
-    timer.start();
-#endif
-
-    TileFlags* const pFlags = tileFlagsPtr(tile.x(), tile.y());
+    // NOTE: the tile is marked as loaded by the caller, since the flags
+    //       may be read by the concurrent jobs of the adjacent tiles.
 
-    // This tile is now considered loaded.
-    *pFlags |= TILE_DISTANCE_LOADED;
+    const TileFlags* const pFlags = context.tileFlagsPtr(tile.x(), tile.y());
 
     // Optimization: If a tile is completely transparent (TILE_HAS_OPAQUE_PIXELS == 0), then
     // we can skip the distance calculation for it. Unfortunately, with the guard bands we need
     // to check the flags of the neighboring tiles as well.
 
     const bool tileOpaque           = (*pFlags & TILE_HAS_OPAQUE_PIXELS) != 0;
-    const bool tileOpaqueLeft       = (nearbyTilesRect.left()   == tile.x()) ?                                           false : (*tileFlagsPtr(tile.x() - 1, tile.y())     & TILE_HAS_OPAQUE_PIXELS) != 0;
-    const bool tileOpaqueTopLeft    = (nearbyTilesRect.left()   == tile.x()) || (nearbyTilesRect.top()    == tile.y()) ? false : (*tileFlagsPtr(tile.x() - 1, tile.y() - 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
-    const bool tileOpaqueBottomLeft = (nearbyTilesRect.left()   == tile.x()) || (nearbyTilesRect.bottom() == tile.y()) ? false : (*tileFlagsPtr(tile.x() - 1, tile.y() + 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
-    const bool tileOpaqueTop        = (nearbyTilesRect.top()    == tile.y()) ?                                           false : (*tileFlagsPtr(tile.x(),     tile.y() - 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
-    const bool tileOpaqueBottom     = (nearbyTilesRect.bottom() == tile.y()) ?                                           false : (*tileFlagsPtr(tile.x(),     tile.y() + 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
+    const bool tileOpaqueLeft       = (nearbyTilesRect.left()   == tile.x()) ?                                           false : (*context.tileFlagsPtr(tile.x() - 1, tile.y())     & TILE_HAS_OPAQUE_PIXELS) != 0;
+    const bool tileOpaqueTopLeft    = (nearbyTilesRect.left()   == tile.x()) || (nearbyTilesRect.top()    == tile.y()) ? false : (*context.tileFlagsPtr(tile.x() - 1, tile.y() - 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
+    const bool tileOpaqueBottomLeft = (nearbyTilesRect.left()   == tile.x()) || (nearbyTilesRect.bottom() == tile.y()) ? false : (*context.tileFlagsPtr(tile.x() - 1, tile.y() + 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
+    const bool tileOpaqueTop        = (nearbyTilesRect.top()    == tile.y()) ?                                           false : (*context.tileFlagsPtr(tile.x(),     tile.y() - 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
+    const bool tileOpaqueBottom     = (nearbyTilesRect.bottom() == tile.y()) ?                                           false : (*context.tileFlagsPtr(tile.x(),     tile.y() + 1) & TILE_HAS_OPAQUE_PIXELS) != 0;
 
     if (! (tileOpaqueTopLeft || tileOpaqueTop || tileOpaqueLeft || tileOpaque || tileOpaqueBottomLeft || tileOpaqueBottom)) {
         // This tile as well as its surroundings are transparent.
         // We can simply exit without explicitly initializing the tile. The paint device's default pixel is DISTANCE_INFINITE.
 
-#if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
-        m_distanceElapsedNanos += timer.nsecsElapsed();
-#endif
         return;
     }
 
@@ -235,26 +342,22 @@ void KisGapMap::loadDistanceTile(const QPoint& tile, const QRect& nearbyTilesRec
         (rect.right() + (m_gapSize + 1) >= m_size.width()) ||  // no risk of accessing x<0
         (y1 - (m_gapSize + 1) < 0) || (y2 + (m_gapSize + 1) >= m_size.height());
 
-    m_tilePosition = rect.topLeft();
-    m_tileDataPtr = reinterpret_cast<Data*>(m_accessor->tileRawData(tile.x(), tile.y()));
+    context.tilePosition = rect.topLeft();
+    context.tileDataPtr = reinterpret_cast<Data*>(context.accessor.tileRawData(tile.x(), tile.y()));
 
     // Process the tile and its neighborhood in three passes:
     // Top (the top guard bands)
     for (int y = y1; y <= rect.top() - 1; ++y) {
-        distanceSearchRowInnerLoop(boundsCheck, y, x1Top, x2Top);
+        distanceSearchRowInnerLoop(context, boundsCheck, y, x1Top, x2Top);
     }
     // Middle (the left guard band and the tile)
     for (int y = rect.top(); y <= rect.bottom(); ++y) {
-        distanceSearchRowInnerLoop(boundsCheck, y, x1Middle, x2Middle);
+        distanceSearchRowInnerLoop(context, boundsCheck, y, x1Middle, x2Middle);
     }
     // Bottom (the bottom guard bands)
     for (int y = rect.bottom() + 1; y <= y2; ++y) {
-        distanceSearchRowInnerLoop(boundsCheck, y, x1Bottom, x2Bottom);
+        distanceSearchRowInnerLoop(context, boundsCheck, y, x1Bottom, x2Bottom);
     }
-
-#if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
-    m_distanceElapsedNanos += timer.nsecsElapsed();
-#endif
 }
 
 /**
@@ -278,10 +381,10 @@ void KisGapMap::loadDistanceTile(const QPoint& tile, const QRect& nearbyTilesRec
  * - Lastly, only some points in the half circle will be modified, it depends on the opacity checks.
  */
 template<bool BoundsCheck, typename CoordinateTransform>
-void KisGapMap::gapDistanceSearch(int x, int y, CoordinateTransform op)
+void KisGapMap::gapDistanceSearch(DistanceContext& context, int x, int y, CoordinateTransform op)
 {
-    if (isOpaque<BoundsCheck>(op(x, y, 0, -1)) ||
-        isOpaque<BoundsCheck>(op(x, y, 1, -1))) {
+    if (isOpaque<BoundsCheck>(context, op(x, y, 0, -1)) ||
+        isOpaque<BoundsCheck>(context, op(x, y, 1, -1))) {
         return;
     }
 
@@ -295,36 +398,36 @@ void KisGapMap::gapDistanceSearch(int x, int y, CoordinateTransform op)
                 break;
             }
 
-            if (isOpaque<BoundsCheck>(op(x, y, xoffs, -yoffs))) {
+            if (isOpaque<BoundsCheck>(context, op(x, y, xoffs, -yoffs))) {
                 const float dx = static_cast<float>(xoffs) / (yoffs - 1);
                 float tx = 0;
                 int cx = 0;
 
                 for (int cy = 1; cy < yoffs; ++cy) {
-                    updateDistance(op(x, y, cx, -cy), offsetDistance);
+                    updateDistance(context, op(x, y, cx, -cy), offsetDistance);
 
                     tx += dx;
                     if (static_cast<int>(tx) > cx) {
                         cx++;
-                        updateDistance(op(x, y, cx, -cy), offsetDistance);
+                        updateDistance(context, op(x, y, cx, -cy), offsetDistance);
                     }
 
-                    updateDistance(op(x, y, cx + 1, -cy), offsetDistance);
+                    updateDistance(context, op(x, y, cx + 1, -cy), offsetDistance);
                 }
             }
         }
     }
 }
 
-void KisGapMap::updateDistance(const QPoint& globalPosition, quint16 newDistance)
+void KisGapMap::updateDistance(DistanceContext& context, const QPoint& globalPosition, quint16 newDistance)
 {
-    const QPoint p = globalPosition - m_tilePosition;
+    const QPoint p = globalPosition - context.tilePosition;
 
     if ((p.x() < 0) || (p.x() >= TileSize) || (p.y() < 0) || (p.y() >= TileSize)) {
         return;
     }
 
-    Data* ptr = m_tileDataPtr + p.x() + TileSize * p.y();
+    Data* ptr = context.tileDataPtr + p.x() + TileSize * p.y();
     if (ptr->distance > newDistance) {
         ptr->distance = newDistance;
     }
@@ -337,21 +440,25 @@ quint16 KisGapMap::lazyDistance(int x, int y)
     qDebug() << "lazyDistance() at (" << x << "," << y << ")";
 #endif
 
+#if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
+    QElapsedTimer timer;
+    timer.start();
+    const quint64 opacityElapsedNanos = m_opacityElapsedNanos;
+#endif
+
     const int tx = x / TileSize;
     const int ty = y / TileSize;
 
-    // Clamped tile neighborhood.
-    const QPoint topLeft(qMax(0, tx - 1),
-                         qMax(0, ty - 1));
-    const QPoint bottomRight(qMin(tx + 1, m_numTiles.width() - 1),
-                             qMin(ty + 1, m_numTiles.height() - 1));
-    const QRect nearbyTiles = QRect(topLeft, bottomRight);
+    // The fill is likely to continue into the adjacent tiles, so the
+    // whole aligned block of tiles is calculated at once in parallel.
+    const QRect block = QRect(tx - tx % BlockSize, ty - ty % BlockSize, BlockSize, BlockSize) &
+                        QRect(QPoint(), m_numTiles);
 
-    // For opacity data, we always load all the adjacent tiles (up to 9 tiles in total).
-    loadOpacityTiles(nearbyTiles);
+    loadDistanceTiles(block);
 
-    // For distance data, we always load a single tile.
-    loadDistanceTile(QPoint(tx, ty), nearbyTiles, m_gapSize);
+#if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
+    m_distanceElapsedNanos += timer.nsecsElapsed() - (m_opacityElapsedNanos - opacityElapsedNanos);
+#endif
 
     // The data is now ready to be returned.
     return dataPtr(x, y)->distance;
@@ -85,6 +85,8 @@ public:
 
     /** A callback to request opacity data for pixels in the image.
      *  It can be called at any time distance() function is invoked.
+     *  The tiles are loaded in parallel, so the callback may be called
+     *  concurrently for different rects and must be thread-safe.
      *
      *  @param devicePtr our underlying paint device, it contains opacity among other data.
      *         For each pixel, the offset of opacity quint8 data is 2 bytes.
@@ -124,6 +126,18 @@ public:
         return m_gapSize;
     }
 
+    /** Replace the opacity callback, e.g. when the map is reused by another fill */
+    void setFillOpacityFunc(const FillOpacityFunc& fillOpacityFunc);
+
+    /** Drop the data of the already loaded tiles whose source has changed,
+     *  as well as the distance data of the adjacent tiles depending on them.
+     *  The dropped tiles are loaded again on the next request.
+     *
+     *  @param tileChanged a callback returning true if the source pixels
+     *         of the given rect (in the map coordinates) have changed.
+     */
+    void invalidateChangedTiles(const std::function<bool(const QRect& rect)>& tileChanged);
+
 #if KIS_GAP_MAP_MEASURE_ELAPSED_TIME
 public:
     quint64 opacityElapsedMillis() const
@@ -163,20 +177,50 @@ private:
     };
     static_assert(sizeof(Data) == sizeof(quint32));
 
+    /** The tiles are loaded in blocks of this size (in tiles) in parallel. */
+    static constexpr int BlockSize = 4;
+
+    /**
+     * The state of a distance calculation. Every concurrent job has its own
+     * accessor and writes only into the tile it calculates.
+     */
+    struct DistanceContext
+    {
+        DistanceContext(KisPaintDeviceSP& paintDevice)
+            : accessor(paintDevice)
+        {}
+
+        ALWAYS_INLINE Data* dataPtr(int x, int y)
+        {
+            return reinterpret_cast<Data*>(accessor.rawData(x, y));
+        }
+
+        ALWAYS_INLINE TileFlags* tileFlagsPtr(int tileX, int tileY)
+        {
+            return reinterpret_cast<TileFlags*>(
+                accessor.tileRawData(tileX, tileY) + offsetof(Data, flags));
+        }
+
+        KisTileOptimizedAccessor accessor;
+        QPoint tilePosition;    ///< The position of the currently computed tile compared to the whole region
+        Data* tileDataPtr {nullptr}; ///< The pointer to the currently computed tile data
+    };
+
     void loadOpacityTiles(const QRect& tileRect);
-    void loadDistanceTile(const QPoint& tile, const QRect& nearbyTilesRect, int guardBand);
-    void distanceSearchRowInnerLoop(bool boundsCheck, int y, int x1, int x2);
+    void loadDistanceTiles(const QRect& tileRect);
+    void loadDistanceTile(DistanceContext& context, const QPoint& tile, const QRect& nearbyTilesRect, int guardBand);
+    void distanceSearchRowInnerLoop(DistanceContext& context, bool boundsCheck, int y, int x1, int x2);
     quint16 lazyDistance(int x, int y);
 
     // Templates are used to generate optimized versions of the same function
     // (i.e., the if conditions can be removed at compilation time).
 
     template<bool BoundsCheck, typename CoordinateTransform>
-    void gapDistanceSearch(int x, int y, CoordinateTransform op);
+    void gapDistanceSearch(DistanceContext& context, int x, int y, CoordinateTransform op);
 
-    template<bool BoundsCheck> ALWAYS_INLINE bool isOpaque(int x, int y);
-    template<bool BoundsCheck> ALWAYS_INLINE bool isOpaque(const QPoint& p);
-    void updateDistance(const QPoint& globalPosition, quint16 newDistance);
+    template<bool BoundsCheck> ALWAYS_INLINE bool isOpaque(DistanceContext& context, int x, int y);
+    template<bool BoundsCheck> ALWAYS_INLINE bool isOpaque(DistanceContext& context, const QPoint& p);
+    void updateDistance(DistanceContext& context, const QPoint& globalPosition, quint16 newDistance);
 
     ALWAYS_INLINE bool isDistanceAvailable(int x, int y)
     {
@@ -197,13 +241,12 @@ private:
     const int m_gapSize;                      ///< Gap size in pixels for this map
     const QSize m_size;                       ///< Size in pixels of the opacity/gap map
     const QSize m_numTiles;                   ///< Map size in tiles
-    const FillOpacityFunc m_fillOpacityFunc;  ///< A callback to get the opacity data from the fill class
-
-    QPoint m_tilePosition;                    ///< The position of the currently computed tile compared to the whole region
-    Data* m_tileDataPtr;                      ///< The pointer to the currently computed tile data
+    FillOpacityFunc m_fillOpacityFunc;        ///< A callback to get the opacity data from the fill class
 
     KisPaintDeviceSP m_deviceSp;                            ///< A 32-bit per pixel paint device that holds the distance and other data
     std::unique_ptr<KisTileOptimizedAccessor> m_accessor;   ///< An accessor for the paint device
 };
 
+typedef KisSharedPtr<KisGapMap> KisGapMapSP;
+
 #endif /* __KIS_GAP_MAP_H */
@@ -0,0 +1,142 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_gap_map_cache.h"
+
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <kis_paint_device.h>
+#include <kis_random_accessor_ng.h>
+
+namespace {
+
+struct CacheEntry
+{
+    KisGapMapCache::Key key;
+    KisGapMapSP gapMap;
+    KisPaintDeviceWSP originalDevice;
+    KisPaintDeviceSP sourceDevice;
+    KisPaintDeviceSP boundaryDevice;
+};
+
+struct CacheStorage
+{
+    QMutex mutex;
+    CacheEntry entry;
+};
+
+Q_GLOBAL_STATIC(CacheStorage, s_cache)
+
+/**
+ * Returns true if the pixels of \p rect differ in the two devices. The
+ * tiles that are still shared between the devices are skipped without
+ * comparing their contents.
+ */
+bool devicesDiffer(KisPaintDeviceSP oldDevice, KisPaintDeviceSP newDevice, const QRect &rect)
+{
+    const int pixelSize = newDevice->pixelSize();
+
+    KisRandomConstAccessorSP oldIt = oldDevice->createRandomConstAccessorNG();
+    KisRandomConstAccessorSP newIt = newDevice->createRandomConstAccessorNG();
+
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        int x = rect.left();
+
+        while (x <= rect.right()) {
+            oldIt->moveTo(x, y);
+            newIt->moveTo(x, y);
+
+            const int numPixels = qMin(qMin(oldIt->numContiguousColumns(x),
+                                            newIt->numContiguousColumns(x)),
+                                       rect.right() - x + 1);
+
+            const quint8 *oldPtr = oldIt->rawDataConst();
+            const quint8 *newPtr = newIt->rawDataConst();
+
+            if (oldPtr != newPtr && memcmp(oldPtr, newPtr, size_t(numPixels) * pixelSize) != 0) {
+                return true;
+            }
+
+            x += numPixels;
+        }
+    }
+
+    return false;
+}
+
+}
+
+namespace KisGapMapCache
+{
+
+KisGapMapSP fetch(const Key &key,
+                  KisPaintDeviceSP sourceDevice,
+                  KisPaintDeviceSP boundaryDevice,
+                  const KisGapMap::FillOpacityFunc &fillOpacityFunc)
+{
+    CacheEntry entry;
+
+    {
+        QMutexLocker l(&s_cache->mutex);
+        std::swap(entry, s_cache->entry);
+    }
+
+    const bool canReuse =
+        entry.gapMap &&
+        entry.key == key &&
+        entry.originalDevice.isValid() &&
+        entry.originalDevice == sourceDevice.data() &&
+        *entry.sourceDevice->colorSpace() == *sourceDevice->colorSpace() &&
+        bool(entry.boundaryDevice) == bool(boundaryDevice) &&
+        (!boundaryDevice || *entry.boundaryDevice->colorSpace() == *boundaryDevice->colorSpace());
+
+    if (!canReuse) {
+        return new KisGapMap(key.gapSize, key.bounds, fillOpacityFunc);
+    }
+
+    entry.gapMap->setFillOpacityFunc(fillOpacityFunc);
+    entry.gapMap->invalidateChangedTiles(
+        [&] (const QRect &rect) {
+            return devicesDiffer(entry.sourceDevice, sourceDevice, rect) ||
+                (boundaryDevice && devicesDiffer(entry.boundaryDevice, boundaryDevice, rect));
+        });
+
+    return entry.gapMap;
+}
+
+void store(const Key &key,
+           KisGapMapSP gapMap,
+           KisPaintDeviceSP originalDevice,
+           KisPaintDeviceSP sourceDevice,
+           KisPaintDeviceSP boundaryDevice)
+{
+    // the callback refers to the policies of the finished fill
+    gapMap->setFillOpacityFunc(KisGapMap::FillOpacityFunc());
+
+    CacheEntry entry;
+    entry.key = key;
+    entry.gapMap = gapMap;
+    entry.originalDevice = originalDevice;
+    entry.sourceDevice = sourceDevice;
+    entry.boundaryDevice = boundaryDevice;
+
+    QMutexLocker l(&s_cache->mutex);
+    std::swap(entry, s_cache->entry);
+}
+
+void clear()
+{
+    CacheEntry entry;
+
+    {
+        QMutexLocker l(&s_cache->mutex);
+        std::swap(entry, s_cache->entry);
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_GAP_MAP_CACHE_H
+#define __KIS_GAP_MAP_CACHE_H
+
+#include <QByteArray>
+#include <QRect>
+
+#include "kritaimage_export.h"
+#include "kis_gap_map.h"
+
+/**
+ * Keeps the gap map of the last gap-closing fill, so that the successive
+ * fills with the same parameters on the same (or slightly changed)
+ * lineart don't have to calculate the distance data from scratch.
+ *
+ * The cache keeps copies of the source devices the map was calculated
+ * from. When the map is reused, only the tiles whose source pixels
+ * differ from the copies are recalculated. The map is reused only for
+ * the same source device; a fill on another device drops it, and so
+ * does clear(), which is called when the fill tool is deactivated.
+ */
+namespace KisGapMapCache
+{
+
+struct Key
+{
+    int gapSize {0};
+    QRect bounds;
+
+    /// identifies the selection policies and their parameters, that
+    /// define the opacity data of the map
+    QByteArray policy;
+
+    bool operator==(const Key &rhs) const {
+        return gapSize == rhs.gapSize && bounds == rhs.bounds && policy == rhs.policy;
+    }
+};
+
+/**
+ * Takes the map cached for \p key out of the cache and updates it for
+ * the current contents of \p sourceDevice and \p boundaryDevice (which
+ * may be null). Creates a new map if there is no suitable one.
+ */
+KRITAIMAGE_EXPORT KisGapMapSP fetch(const Key &key,
+                                    KisPaintDeviceSP sourceDevice,
+                                    KisPaintDeviceSP boundaryDevice,
+                                    const KisGapMap::FillOpacityFunc &fillOpacityFunc);
+
+/**
+ * Puts the map back into the cache after the fill has finished.
+ * \p originalDevice is the device the fill was run on. \p sourceDevice
+ * and \p boundaryDevice must be the copies of the devices made before
+ * the fill has started, the copy constructor of KisPaintDevice shares
+ * the tiles, so such copies are cheap.
+ */
+KRITAIMAGE_EXPORT void store(const Key &key,
+                             KisGapMapSP gapMap,
+                             KisPaintDeviceSP originalDevice,
+                             KisPaintDeviceSP sourceDevice,
+                             KisPaintDeviceSP boundaryDevice);
+
+/**
+ * Drops the cached map together with the copies of its source devices
+ */
+KRITAIMAGE_EXPORT void clear();
+
+}
+
+#endif /* __KIS_GAP_MAP_CACHE_H */
@@ -19,7 +19,9 @@
 #include "kis_fill_sanity_checks.h"
 #include <KisColorSelectionPolicies.h>
 #include "kis_gap_map.h"
+#include "kis_gap_map_cache.h"
 #include <queue>
+#include <typeinfo>
 
 #define MEASURE_FILL_TIME 0
 #if MEASURE_FILL_TIME
@@ -28,8 +30,6 @@
 
 namespace {
 
-typedef KisSharedPtr<KisGapMap> KisGapMapSP;
-
 /**
  * A work item for the gap closing fill.
  * Can work as a seed point and as a next queued pixel to continue the fill.
@@ -181,9 +181,17 @@ public:
     MaskedSelectionPolicy(BaseSelectionPolicy baseSelectionPolicy,
                           KisPaintDeviceSP maskDevice)
         : m_baseSelectionPolicy(baseSelectionPolicy)
+        , m_maskDevice(maskDevice)
         , m_maskIterator(maskDevice->createRandomConstAccessorNG())
     {}
 
+    // every copy gets its own iterator, so the copies can be moved independently
+    MaskedSelectionPolicy(const MaskedSelectionPolicy &rhs)
+        : m_baseSelectionPolicy(rhs.m_baseSelectionPolicy)
+        , m_maskDevice(rhs.m_maskDevice)
+        , m_maskIterator(m_maskDevice->createRandomConstAccessorNG())
+    {}
+
     ALWAYS_INLINE quint8 opacityFromDifference(quint8 difference, int x, int y)
     {
         m_maskIterator->moveTo(x, y);
@@ -198,6 +206,7 @@ public:
 
 private:
     BaseSelectionPolicy m_baseSelectionPolicy;
+    KisPaintDeviceSP m_maskDevice;
     KisRandomConstAccessorSP m_maskIterator;
 };
 
@@ -272,6 +281,33 @@ private:
     KisRandomAccessorSP m_groupMapIt;
 };
 
+/**
+ * The opacity data of the gap map is defined by the types of the
+ * policies of the fill and by their parameters.
+ */
+template <typename DifferencePolicy, typename SelectionPolicy>
+KisGapMapCache::Key makeGapMapCacheKey(int gapSize, const QRect &bounds,
+                                       const KoColor &referenceColor,
+                                       int threshold, int opacitySpread)
+{
+    KisGapMapCache::Key key;
+    key.gapSize = gapSize;
+    key.bounds = bounds;
+
+    key.policy.append(typeid(DifferencePolicy).name());
+    key.policy.append('\0');
+    key.policy.append(typeid(SelectionPolicy).name());
+    key.policy.append('\0');
+    key.policy.append(referenceColor.colorSpace()->id().toLatin1());
+    key.policy.append('\0');
+    key.policy.append(reinterpret_cast<const char*>(referenceColor.data()),
+                      referenceColor.colorSpace()->pixelSize());
+    key.policy.append(reinterpret_cast<const char*>(&threshold), sizeof(threshold));
+    key.policy.append(reinterpret_cast<const char*>(&opacitySpread), sizeof(opacitySpread));
+
+    return key;
+}
+
 } // anonymous namespace
 
 struct Q_DECL_HIDDEN KisScanlineFill::Private
@@ -289,6 +325,12 @@ struct Q_DECL_HIDDEN KisScanlineFill::Private
     int closeGap;           ///< try to close gaps up to this size in pixels
     KisGapMapSP gapMapSp;   ///< maintains the distance and opacity maps required for the algorithm
 
+    // The parameters of the fill that define the opacity data of the gap map.
+    // The map is cached between fills only when the reference color is known.
+    KoColor referenceColor;
+    bool hasReferenceColor = false;
+    KisPaintDeviceSP boundarySelection;
+
     QRect fillExtent;
 
     // The priority queue is required to correctly handle the fill "expansion" case
@@ -640,16 +682,39 @@ void KisScanlineFill::runImpl(DifferencePolicy &differencePolicy,
     timerTotal.start();
 #endif
 
+    KisGapMapCache::Key gapMapCacheKey;
+    KisPaintDeviceSP gapMapSourceDevice;
+    KisPaintDeviceSP gapMapBoundaryDevice;
+
     if (gapSize > 0) {
         // We need to reuse the complex policies used by this class and only provide the final
         // "projection" of opacity for the distance map calculation.
         auto opacityFunc = [&](KisPaintDevice* devicePtr, const QRect& rect) {
-            return fillOpacity(differencePolicy, selectionPolicy, pixelAccessPolicy, devicePtr, rect);
+            return fillOpacity(differencePolicy, selectionPolicy, devicePtr, rect);
         };
 
         // Prime the resources. The computations are made lazily, when distance at a pixel is requested.
         // Resources are freed automatically when the object is destroyed, that is together with the KisScanlineFill object.
-        m_d->gapMapSp = KisGapMapSP(new KisGapMap(gapSize, m_d->boundingRect, opacityFunc));
+        if (m_d->hasReferenceColor) {
+            /**
+             * The successive fills on the same lineart usually share
+             * the gap map, so take the one of the previous fill, with
+             * the tiles of the changed areas invalidated. The source
+             * devices are copied before the fill starts, since the fill
+             * itself may write into them.
+             */
+            gapMapSourceDevice = new KisPaintDevice(*m_d->device);
+            if (m_d->boundarySelection) {
+                gapMapBoundaryDevice = new KisPaintDevice(*m_d->boundarySelection);
+            }
+
+            gapMapCacheKey = makeGapMapCacheKey<DifferencePolicy, SelectionPolicy>(
+                gapSize, m_d->boundingRect, m_d->referenceColor, m_d->threshold, m_d->opacitySpread);
+            m_d->gapMapSp = KisGapMapCache::fetch(gapMapCacheKey, m_d->device,
+                                                  m_d->boundarySelection, opacityFunc);
+        } else {
+            m_d->gapMapSp = KisGapMapSP(new KisGapMap(gapSize, m_d->boundingRect, opacityFunc));
+        }
     }
 
     m_d->fillExtent = QRect();
@@ -721,6 +786,11 @@ void KisScanlineFill::runImpl(DifferencePolicy &differencePolicy,
 #endif
     } while (!m_d->forwardStack.isEmpty());
 
+    if (gapSize > 0 && m_d->hasReferenceColor) {
+        KisGapMapCache::store(gapMapCacheKey, m_d->gapMapSp, m_d->device,
+                              gapMapSourceDevice, gapMapBoundaryDevice);
+    }
+
 #if MEASURE_FILL_TIME
     static constexpr quint64 MillisDivisor = 1000000ull;
     const quint64 totalTime = timerTotal.nsecsElapsed();
@@ -752,6 +822,9 @@ void KisScanlineFill::selectDifferencePolicyAndRun(const KoColor &srcColor,
 {
     const int pixelSize = srcColor.colorSpace()->pixelSize();
 
+    m_d->referenceColor = srcColor;
+    m_d->hasReferenceColor = true;
+
     if (pixelSize == 1) {
         OptimizedDifferencePolicy<quint8> dp(srcColor, m_d->threshold);
         runImpl(dp, selectionPolicy, pixelAccessPolicy);
@@ -846,6 +919,8 @@ void KisScanlineFill::fillSelection(KisPixelSelectionSP pixelSelection, KisPaint
         m_d->filledSelectionIterator = pixelSelection->createRandomAccessorNG();
     }
 
+    m_d->boundarySelection = boundarySelection;
+
     if (softness == 0) {
         MaskedSelectionPolicy<HardSelectionPolicy>
             sp(HardSelectionPolicy(m_d->threshold), boundarySelection);
@@ -899,6 +974,8 @@ void KisScanlineFill::fillSelectionUntilColor(KisPixelSelectionSP pixelSelection
         m_d->filledSelectionIterator = pixelSelection->createRandomAccessorNG();
     }
 
+    m_d->boundarySelection = boundarySelection;
+
     if (softness == 0) {
         MaskedSelectionPolicy<SelectAllUntilColorHardSelectionPolicy>
             sp(SelectAllUntilColorHardSelectionPolicy(m_d->threshold), boundarySelection);
@@ -955,6 +1032,8 @@ void KisScanlineFill::fillSelectionUntilColorOrTransparent(KisPixelSelectionSP p
         m_d->filledSelectionIterator = pixelSelection->createRandomAccessorNG();
     }
 
+    m_d->boundarySelection = boundarySelection;
+
     if (softness == 0) {
         MaskedSelectionPolicy<SelectAllUntilColorHardSelectionPolicy>
             sp(SelectAllUntilColorHardSelectionPolicy(m_d->threshold), boundarySelection);
@@ -1055,11 +1134,13 @@ void KisScanlineFill::fillContiguousGroup(KisPaintDeviceSP groupMapDevice, qint3
  * a rect of the main filled region. The rect typically corresponds to
  * a tile of an opacity map maintained by KisGapMap, and is loaded on-demand
  * during an ongoing runImpl() loop.
+ *
+ * KisGapMap loads the tiles serially, so all the calls share the policies
+ * of the main fill (and the memoized differences of its difference policy).
  */
-template <typename DifferencePolicy, typename SelectionPolicy, typename PixelAccessPolicy>
+template <typename DifferencePolicy, typename SelectionPolicy>
 bool KisScanlineFill::fillOpacity(DifferencePolicy &differencePolicy,
                                   SelectionPolicy &selectionPolicy,
-                                  PixelAccessPolicy &pixelAccessPolicy,
                                   KisPaintDevice* const devicePtr,
                                   const QRect& rect) const
 {
@@ -1070,6 +1151,7 @@ bool KisScanlineFill::fillOpacity(DifferencePolicy &differencePolicy,
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->boundingRect.contains(rect) &&
                "FATAL: The rect is not fully inside the fill bounds");
 #endif
+    KisRandomConstAccessorSP srcIt = m_d->device->createRandomConstAccessorNG();
     KisRandomAccessorSP accessor = devicePtr->createRandomAccessorNG();
 
     const int pixelSize = m_d->device->pixelSize();
@@ -1080,13 +1162,13 @@ bool KisScanlineFill::fillOpacity(DifferencePolicy &differencePolicy,
 
     for (int y = rect.top(); y <= rect.bottom(); ++y) {
         int numPixelsLeft = 0;
-        quint8* dataPtr;
+        const quint8* dataPtr;
 
         for (int x = rect.left(); x <= rect.right(); ++x) {
             if (numPixelsLeft <= 0) {
-                pixelAccessPolicy.m_srcIt->moveTo(x, y);
-                numPixelsLeft = pixelAccessPolicy.m_srcIt->numContiguousColumns(x) - 1;
-                dataPtr = const_cast<quint8*>(pixelAccessPolicy.m_srcIt->rawDataConst());
+                srcIt->moveTo(x, y);
+                numPixelsLeft = srcIt->numContiguousColumns(x) - 1;
+                dataPtr = srcIt->rawDataConst();
             } else {
                 numPixelsLeft--;
                 dataPtr += pixelSize;
@@ -170,10 +170,9 @@ private:
                                  SelectionPolicy &selectionPolicy,
                                  PixelAccessPolicy &pixelAccessPolicy);
 
-    template <typename DifferencePolicy, typename SelectionPolicy, typename PixelAccessPolicy>
+    template <typename DifferencePolicy, typename SelectionPolicy>
     bool fillOpacity(DifferencePolicy &differencePolicy,
                      SelectionPolicy &selectionPolicy,
-                     PixelAccessPolicy &pixelAccessPolicy,
                      KisPaintDevice* const devicePtr,
                      const QRect& rect) const;
 
@@ -5,10 +5,13 @@
 
 #include "kis_async_merger.h"
 
+#include <memory>
+
 
 #include <kis_debug.h>
 
 #include <KoChannelInfo.h>
+#include <KoColorTransformation.h>
 #include <KoCompositeOpRegistry.h>
 
 #include "kis_node_visitor.h"
@@ -22,16 +25,20 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/kis_color_transformation_filter.h"
+#include "filter/kis_color_transformation_configuration.h"
 #include "kis_selection.h"
 #include "kis_clone_layer.h"
 #include "kis_processing_information.h"
 #include "kis_busy_progress_indicator.h"
+#include "kis_sequential_iterator.h"
 
 
 #include "kis_merge_walker.h"
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisBelowFilthyCache.h"
 
 
 //#define DEBUG_MERGER
@@ -169,6 +176,158 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+namespace {
+QAtomicInt s_belowFilthyCacheEnabled(1);
+
+/**
+ * Caching the composition of just a couple of layers doesn't pay off
+ * the memory it takes
+ */
+const int minBelowFilthyCacheNodes = 4;
+
+/**
+ * Adjustment layers with a point-wise filter, that simply replace
+ * the projection below them (copy composite op at full opacity, no
+ * selection, masks or layer styles), can be applied to the pixels
+ * in a single pass instead of filtering and compositing the whole
+ * area once per layer.
+ */
+KisAdjustmentLayer* fusableAdjustmentLayer(KisProjectionLeafSP leaf, KisPaintDeviceSP projection)
+{
+    KisAdjustmentLayer *layer = qobject_cast<KisAdjustmentLayer*>(leaf->node().data());
+    if (!layer) return nullptr;
+
+    if (!leaf->visible() ||
+        !leaf->shouldBeRendered() ||
+        layer->needProjection() ||
+        layer->hasEffectMasks() ||
+        layer->layerStyle() ||
+        layer->compositeOpId() != COMPOSITE_COPY ||
+        leaf->opacity() != OPACITY_OPAQUE_U8) {
+
+        return nullptr;
+    }
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (!channelFlags.isEmpty() && channelFlags.count(true) != channelFlags.size()) {
+        return nullptr;
+    }
+
+    KisFilterConfigurationSP filterConfig = layer->filter();
+    if (!filterConfig) return nullptr;
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(filterConfig->name());
+    if (!dynamic_cast<const KisColorTransformationFilter*>(filter.data())) return nullptr;
+
+    KisPaintDeviceSP originalDevice = layer->original();
+
+    /**
+     * The areas outside the extent of the projection are not filtered,
+     * but are still copied from the original, so the default pixels
+     * of the devices should match
+     */
+    if (*originalDevice->colorSpace() != *projection->colorSpace() ||
+        *originalDevice->colorSpace() != *originalDevice->compositionSourceColorSpace() ||
+        !(originalDevice->defaultPixel() == projection->defaultPixel())) {
+
+        return nullptr;
+    }
+
+    return layer;
+}
+
+/**
+ * Applies the filters of \p layers to \p projection in a single pass,
+ * writing the intermediate results into the original of every layer,
+ * so that the clones and the color samplers still see correct data.
+ */
+void applyFusedColorTransformations(const QVector<KisAdjustmentLayer*> &layers, KisPaintDeviceSP projection, const QRect &rect)
+{
+    const KoColorSpace *cs = projection->colorSpace();
+    const int pixelSize = cs->pixelSize();
+
+    std::vector<KoColorTransformation*> transformations;
+    std::vector<std::unique_ptr<KoColorTransformation>> ownedTransformations;
+    std::vector<std::unique_ptr<KisSequentialIterator>> originalIterators;
+
+    const QRect applyRect = rect & projection->extent();
+
+    Q_FOREACH (KisAdjustmentLayer *layer, layers) {
+        KisPaintDeviceSP originalDevice = layer->original();
+        originalDevice->clear(layer->projectionPlane()->needRectForOriginal(rect));
+
+        KIS_ASSERT_RECOVER_NOOP(layer->busyProgressIndicator());
+        layer->busyProgressIndicator()->update();
+
+        KisFilterConfigurationSP filterConfig = layer->filter();
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterConfig->name());
+        const KisColorTransformationFilter *colorFilter =
+            dynamic_cast<const KisColorTransformationFilter*>(filter.data());
+
+        /**
+         * The same way as in KisColorTransformationFilter::processImpl(),
+         * the cached transformations are owned by the configuration
+         */
+        KoColorTransformation *transformation = 0;
+        const KisColorTransformationConfiguration *colorConfig =
+            dynamic_cast<const KisColorTransformationConfiguration*>(filterConfig.data());
+
+        if (colorConfig) {
+            transformation = colorConfig->colorTransformation(cs, colorFilter);
+        } else {
+            transformation = colorFilter->createTransformation(cs, filterConfig);
+            ownedTransformations.emplace_back(transformation);
+        }
+
+        // a null transformation passes the pixels through
+        transformations.push_back(transformation);
+
+        if (!applyRect.isEmpty()) {
+            originalIterators.emplace_back(new KisSequentialIterator(originalDevice, applyRect));
+        }
+    }
+
+    if (applyRect.isEmpty()) return;
+
+    KisSequentialIterator dstIt(projection, applyRect);
+
+    int conseq = dstIt.nConseqPixels();
+    while (dstIt.nextPixels(conseq)) {
+        for (auto &it : originalIterators) {
+            it->nextPixels(conseq);
+        }
+
+        conseq = dstIt.nConseqPixels();
+        for (auto &it : originalIterators) {
+            conseq = qMin(conseq, it->nConseqPixels());
+        }
+
+        const quint8 *src = dstIt.rawDataConst();
+
+        for (size_t i = 0; i < transformations.size(); i++) {
+            quint8 *dst = originalIterators[i]->rawData();
+
+            if (transformations[i]) {
+                transformations[i]->transform(src, dst, conseq);
+            } else {
+                memcpy(dst, src, conseq * pixelSize);
+            }
+
+            src = dst;
+        }
+
+        // the layers have copy composite op, so the last result goes as it is
+        memcpy(dstIt.rawData(), src, conseq * pixelSize);
+    }
+}
+
+}
+
+void KisAsyncMerger::setBelowFilthyCacheEnabled(bool value)
+{
+    s_belowFilthyCacheEnabled.storeRelaxed(value);
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
@@ -191,6 +350,10 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         QRect applyRect = item.m_applyRect;
 
+        if (m_belowCacheGroup && currentLeaf->node() == m_belowCacheKeyNode) {
+            flushBelowFilthyCache();
+        }
+
         if (currentLeaf->isRoot()) {
             currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode(), item.m_renderFlags);
             continue;
@@ -211,6 +374,15 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if (!m_currentProjection) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
+
+            if (tryFetchBelowFilthyCache(walker, item, useTempProjections)) {
+                DEBUG_NODE_ACTION("Fetched from cache", "N_BELOW_FILTHY", currentLeaf, applyRect);
+                continue;
+            }
+        }
+
+        if (tryMergeFusedColorTransformations(walker, item, useTempProjections)) {
+            continue;
         }
 
         KisUpdateOriginalVisitor originalVisitor(applyRect,
@@ -272,6 +444,164 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+
+    m_belowCacheGroup = 0;
+    m_belowCacheKeyNode = nullptr;
+    m_belowCacheNodes.clear();
+}
+
+bool KisAsyncMerger::tryFetchBelowFilthyCache(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &item, bool useTempProjection)
+{
+    KisProjectionLeafSP parentLeaf = item.m_leaf->parent();
+    KisGroupLayerSP group = qobject_cast<KisGroupLayer*>(parentLeaf->node().data());
+    if (!group) return false;
+
+    /**
+     * The cache stores the composition on lod0 only. LodN updates
+     * never change lod0 data, so they don't invalidate it either.
+     */
+    if (walker.levelOfDetail() > 0) return false;
+
+    KisBelowFilthyCache &cache = group->belowFilthyCache();
+
+    /**
+     * When the need rects vary, the nodes are composed in different
+     * areas, so we cannot track the changes precisely. Just drop
+     * the cache in such a case.
+     */
+    if (!s_belowFilthyCacheEnabled.loadRelaxed() || !m_currentProjection || useTempProjection) {
+        if (!cache.isEmpty()) {
+            cache.clear();
+        }
+        return false;
+    }
+
+    KisBaseRectsWalker::LeafStack &leafStack = walker.leafStack();
+
+    QVector<const KisNode*> belowNodes;
+    const KisNode *keyNode = nullptr;
+    int keyIndex = -1;
+
+    if (item.m_position & KisMergeWalker::N_BELOW_FILTHY) {
+        belowNodes << item.m_leaf->node().data();
+
+        for (int i = leafStack.size() - 1; i >= 0; i--) {
+            const KisBaseRectsWalker::JobItem &nextItem = leafStack[i];
+
+            if (nextItem.m_leaf->parent() != parentLeaf ||
+                nextItem.m_position & KisMergeWalker::N_EXTRA ||
+                nextItem.m_applyRect != item.m_applyRect) {
+
+                break;
+            }
+
+            if (!(nextItem.m_position & KisMergeWalker::N_BELOW_FILTHY)) {
+                keyNode = nextItem.m_leaf->node().data();
+                keyIndex = i;
+                break;
+            }
+
+            belowNodes << nextItem.m_leaf->node().data();
+        }
+    } else {
+        keyNode = item.m_leaf->node().data();
+    }
+
+    if (!keyNode) {
+        cache.clear();
+        return false;
+    }
+
+    if (cache.fetch(keyNode, belowNodes, item.m_applyRect, m_currentProjection)) {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(keyIndex >= 0);
+
+        while (leafStack.size() > keyIndex + 1) {
+            leafStack.pop();
+        }
+        return true;
+    }
+
+    if (belowNodes.size() >= minBelowFilthyCacheNodes) {
+        m_belowCacheGroup = group;
+        m_belowCacheKeyNode = keyNode;
+        m_belowCacheNodes = belowNodes;
+        m_belowCacheRect = item.m_applyRect;
+    }
+
+    return false;
+}
+
+void KisAsyncMerger::flushBelowFilthyCache()
+{
+    if (m_currentProjection) {
+        m_belowCacheGroup->belowFilthyCache().store(m_belowCacheKeyNode, m_belowCacheNodes,
+                                                    m_belowCacheRect, m_currentProjection);
+    }
+
+    m_belowCacheGroup = 0;
+    m_belowCacheKeyNode = nullptr;
+    m_belowCacheNodes.clear();
+}
+
+bool KisAsyncMerger::tryMergeFusedColorTransformations(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &item, bool useTempProjection)
+{
+    if (!m_currentProjection) return false;
+    if (!(item.m_position & (KisMergeWalker::N_FILTHY | KisMergeWalker::N_ABOVE_FILTHY))) return false;
+
+    KisAdjustmentLayer *firstLayer = fusableAdjustmentLayer(item.m_leaf, m_currentProjection);
+    if (!firstLayer) return false;
+
+    KisBaseRectsWalker::LeafStack &leafStack = walker.leafStack();
+
+    QVector<KisBaseRectsWalker::JobItem> items;
+    QVector<KisAdjustmentLayer*> layers;
+
+    items << item;
+    layers << firstLayer;
+
+    for (int i = leafStack.size() - 1; i >= 0; i--) {
+        const KisBaseRectsWalker::JobItem &nextItem = leafStack[i];
+
+        if (items.last().m_position & KisMergeWalker::N_TOPMOST ||
+            nextItem.m_leaf->parent() != item.m_leaf->parent() ||
+            !(nextItem.m_position & KisMergeWalker::N_ABOVE_FILTHY) ||
+            nextItem.m_applyRect != item.m_applyRect ||
+            nextItem.m_leaf->node() == m_belowCacheKeyNode) {
+
+            break;
+        }
+
+        KisAdjustmentLayer *layer = fusableAdjustmentLayer(nextItem.m_leaf, m_currentProjection);
+        if (!layer) break;
+
+        items << nextItem;
+        layers << layer;
+    }
+
+    if (layers.size() < 2) return false;
+
+    for (int i = 1; i < items.size(); i++) {
+        leafStack.pop();
+    }
+
+    DEBUG_NODE_ACTION("Fusing color transformations", "", item.m_leaf, item.m_applyRect);
+
+    applyFusedColorTransformations(layers, m_currentProjection, item.m_applyRect);
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &fusedItem, items) {
+        KisNodeSP filthyNode =
+            fusedItem.m_position & KisMergeWalker::N_FILTHY ?
+            walker.startNode() : fusedItem.m_leaf->node();
+
+        fusedItem.m_leaf->projectionPlane()->recalculate(fusedItem.m_applyRect, filthyNode, fusedItem.m_renderFlags);
+    }
+
+    if (items.last().m_position & KisMergeWalker::N_TOPMOST) {
+        writeProjection(items.last().m_leaf, useTempProjection, item.m_applyRect);
+        resetProjection();
+    }
+
+    return true;
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
@@ -9,21 +9,32 @@
 #include "kritaimage_export.h"
 #include "kis_types.h"
 #include "KisRenderPassFlags.h"
+#include "kis_base_rects_walker.h"
 
 class QRect;
-class KisBaseRectsWalker;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
+    /**
+     * Enables or disables caching of the composition of the nodes
+     * below the filthy node in the groups (see KisBelowFilthyCache).
+     * The setting is shared by all the mergers.
+     */
+    static void setBelowFilthyCacheEnabled(bool value);
+
 private:
     inline void resetProjection();
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
     inline void writeProjection(KisProjectionLeafSP topmostLeaf, bool useTempProjection, const QRect &rect);
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
+    bool tryFetchBelowFilthyCache(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &item, bool useTempProjection);
+    void flushBelowFilthyCache();
+
+    bool tryMergeFusedColorTransformations(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &item, bool useTempProjection);
 
 private:
     /**
@@ -50,6 +61,16 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * The composition of the nodes below m_belowCacheKeyNode should be
+     * saved into the cache of m_belowCacheGroup right before the key
+     * node is composed
+     */
+    KisGroupLayerSP m_belowCacheGroup;
+    const KisNode *m_belowCacheKeyNode = nullptr;
+    QVector<const KisNode*> m_belowCacheNodes;
+    QRect m_belowCacheRect;
 };
 
 
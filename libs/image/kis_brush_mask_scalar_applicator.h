@@ -32,7 +32,7 @@ protected:
         MaskGenerator *m_maskGenerator = KisBrushMaskScalarApplicator<MaskGenerator, impl>::m_maskGenerator;
 
         qreal random = 1.0;
-        quint8 *dabPointer = m_d->device->data() + rect.y() * rect.width() * m_d->pixelSize;
+        quint8 *dabPointer = m_d->device->data() + rect.y() * m_d->device->bounds().width() * m_d->pixelSize;
         quint8 alphaValue = OPACITY_TRANSPARENT_U8;
         // this offset is needed when brush size is smaller then fixed device size
         int offset = (m_d->device->bounds().width() - rect.width()) * m_d->pixelSize;
@@ -9,6 +9,9 @@
 #include "kis_grid_interpolation_tools.h"
 #include "kis_green_coordinates_math.h"
 
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QPainter>
 
 #include "KoColor.h"
@@ -19,6 +22,61 @@
 
 #include <qnumeric.h>
 
+namespace {
+
+/**
+ * The grid and the Green coordinates of its points depend only on the
+ * original cage and the processed rect, so they stay the same while
+ * the user moves the handles of the cage. They are cached to make
+ * every update of the preview recalculate only the deformation itself.
+ */
+struct CageGridKey
+{
+    QVector<QPointF> origCage;
+    QRect srcBounds;
+    int pixelPrecision = 0;
+
+    bool operator==(const CageGridKey &rhs) const {
+        return pixelPrecision == rhs.pixelPrecision &&
+            srcBounds == rhs.srcBounds &&
+            origCage == rhs.origCage;
+    }
+};
+
+uint qHash(const CageGridKey &key, uint seed = 0)
+{
+    return qHashBits(key.origCage.constData(), key.origCage.size() * sizeof(QPointF),
+                     qHash(key.srcBounds.x(), seed) ^ qHash(key.srcBounds.y()) ^
+                     qHash(key.srcBounds.width()) ^ qHash(key.srcBounds.height()) ^
+                     qHash(key.pixelPrecision));
+}
+
+struct CageGrid
+{
+    QSize gridSize;
+    QVector<QPointF> allSrcPoints;
+    QVector<int> allToValidPointsMap;
+    QVector<QPointF> validPoints;
+    KisGreenCoordinatesMath cage;
+};
+
+/**
+ * The cost of an entry is the number of the precalculated coordinates.
+ * The limit keeps about 128 MiB of them: enough for the LoD and the
+ * actual layer of a typical cage.
+ */
+const int maxCachedCoordinates = 8 * 1024 * 1024;
+
+}
+
+struct KisCageTransformWorker::GridCache
+{
+    GridCache() : cache(maxCachedCoordinates) {}
+
+    QMutex mutex;
+    QCache<CageGridKey, CageGrid> cache;
+};
+
 struct Q_DECL_HIDDEN KisCageTransformWorker::Private
 {
     Private(const QVector<QPointF> &_origCage,
@@ -53,6 +111,8 @@ struct Q_DECL_HIDDEN KisCageTransformWorker::Private
 
     QSize gridSize;
 
+    GridCacheSP gridCache;
+
     bool isGridEmpty() const {
         return allSrcPoints.isEmpty();
     }
@@ -93,6 +153,16 @@ KisCageTransformWorker::~KisCageTransformWorker()
 {
 }
 
+KisCageTransformWorker::GridCacheSP KisCageTransformWorker::createGridCache()
+{
+    return GridCacheSP(new GridCache());
+}
+
+void KisCageTransformWorker::setGridCache(GridCacheSP cache)
+{
+    m_d->gridCache = cache;
+}
+
 void KisCageTransformWorker::setTransformedCage(const QVector<QPointF> &transformedCage)
 {
     m_d->transfCage = transformedCage;
@@ -151,6 +221,22 @@ void KisCageTransformWorker::prepareTransform()
 
     // no need to process empty devices
     if (srcBounds.isEmpty()) return;
+
+    const CageGridKey key {m_d->origCage, srcBounds, m_d->pixelPrecision};
+
+    if (m_d->gridCache) {
+        QMutexLocker l(&m_d->gridCache->mutex);
+
+        if (CageGrid *grid = m_d->gridCache->cache.object(key)) {
+            m_d->gridSize = grid->gridSize;
+            m_d->allSrcPoints = grid->allSrcPoints;
+            m_d->allToValidPointsMap = grid->allToValidPointsMap;
+            m_d->validPoints = grid->validPoints;
+            m_d->cage = grid->cage;
+            return;
+        }
+    }
+
     m_d->gridSize =
         GridIterationTools::calcGridSize(srcBounds, m_d->pixelPrecision);
 
@@ -182,6 +268,20 @@ void KisCageTransformWorker::prepareTransform()
     }
 
     m_d->cage.precalculateGreenCoordinates(m_d->origCage, m_d->validPoints);
+
+    if (m_d->gridCache) {
+        QMutexLocker l(&m_d->gridCache->mutex);
+
+        CageGrid *grid = new CageGrid();
+        grid->gridSize = m_d->gridSize;
+        grid->allSrcPoints = m_d->allSrcPoints;
+        grid->allToValidPointsMap = m_d->allToValidPointsMap;
+        grid->validPoints = m_d->validPoints;
+        grid->cage = m_d->cage;
+
+        const qint64 cost = qint64(m_d->validPoints.size()) * m_d->origCage.size();
+        m_d->gridCache->cache.insert(key, grid, int(qMin(cost, qint64(maxCachedCoordinates) + 1)));
+    }
 }
 
 QVector<QPointF> KisCageTransformWorker::Private::calculateTransformedPoints()
@@ -199,7 +299,6 @@ QVector<QPointF> KisCageTransformWorker::Private::calculateTransformedPoints()
             warnKrita << "WARNING: One grid point has been removed from consideration" << validPoints[i];
             transformedPoints[i] = validPoints[i];
         }
-
     }
 
     return transformedPoints;
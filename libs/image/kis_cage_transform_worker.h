@@ -8,6 +8,7 @@
 #define __KIS_CAGE_TRANSFORM_WORKER_H
 
 #include <QScopedPointer>
+#include <QSharedPointer>
 #include <kritaimage_export.h>
 #include <kis_types.h>
 
@@ -15,6 +16,19 @@ class QImage;
 
 class KRITAIMAGE_EXPORT KisCageTransformWorker
 {
+public:
+    /**
+     * The grid and the Green coordinates of its points depend only on
+     * the original cage and the processed rect. The cache keeps them
+     * between the workers while the user moves the handles of the cage.
+     * It belongs to the user of the workers (e.g. the transform stroke),
+     * who drops it when the cage is not edited anymore.
+     */
+    struct GridCache;
+    typedef QSharedPointer<GridCache> GridCacheSP;
+
+    static GridCacheSP createGridCache();
+
 public:
     KisCageTransformWorker(const QRect &deviceNonDefaultRegion,
                            const QVector<QPointF> &origCage,
@@ -29,6 +43,13 @@ public:
 
     ~KisCageTransformWorker();
 
+    /**
+     * Makes prepareTransform() reuse the grid prepared by another worker
+     * with the same cache. Without a cache the grid is always prepared
+     * from scratch.
+     */
+    void setGridCache(GridCacheSP cache);
+
     void prepareTransform();
     void setTransformedCage(const QVector<QPointF> &transformedCage);
     void run(KisPaintDeviceSP srcDevice, KisPaintDeviceSP dstDevice);
@@ -147,8 +147,21 @@ void KisCloneLayer::copyOriginalToProjection(const KisPaintDeviceSP original,
         KisPaintDeviceSP projection,
         const QRect& rect) const
 {
+    const QPoint offset(m_d->offset->x(), m_d->offset->y());
+
     QRect copyRect = rect;
-    copyRect.translate(-m_d->offset->x(), -m_d->offset->y());
+    copyRect.translate(-offset);
+
+    /**
+     * When the clone is moved by a whole number of tiles, (e.g. in
+     * pattern layouts), the projection just shares the tiles of the
+     * source via copy-on-write, so neither the pixels are copied nor
+     * the memory is spent, however many clones of the source exist.
+     */
+    if (projection->fastBitBltPossible(original, offset)) {
+        projection->fastBitBlt(original, copyRect, offset);
+        return;
+    }
 
     KisPainter::copyAreaOptimized(rect.topLeft(), original, projection, copyRect);
 }
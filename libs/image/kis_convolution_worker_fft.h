@@ -15,7 +15,10 @@
 #include "kis_convolution_worker.h"
 #include "kis_math_toolbox.h"
 
+#include <QHash>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
 #include <QVector>
 #include <QTextStream>
 #include <QFile>
@@ -31,9 +34,61 @@ class KisConvolutionWorkerFFTLock
 private:
     static QMutex fftwMutex;
     template<class _IteratorFactory_> friend class KisConvolutionWorkerFFT;
+
+    struct PlanPair {
+        fftw_plan forward;
+        fftw_plan backward;
+    };
+
+    /**
+     * Planning is not thread-safe in FFTW, executing a plan with new
+     * arrays is. Convolutions of the same kernel over the patches of
+     * an image keep requesting the same sizes, so the plans are kept
+     * around instead of being recreated for every call.
+     */
+    static QHash<QPair<quint32, quint32>, PlanPair> plans;
+    static const int maxCachedPlans = 16;
+
+    static void fetchPlans(quint32 fftWidth, quint32 fftHeight, quint32 fftLength,
+                           fftw_plan *forward, fftw_plan *backward)
+    {
+        QMutexLocker l(&fftwMutex);
+
+        const QPair<quint32, quint32> key(fftWidth, fftHeight);
+        auto it = plans.find(key);
+
+        if (it == plans.end()) {
+            if (plans.size() >= maxCachedPlans) {
+                Q_FOREACH (const PlanPair &pair, plans) {
+                    fftw_destroy_plan(pair.forward);
+                    fftw_destroy_plan(pair.backward);
+                }
+                plans.clear();
+            }
+
+            /**
+             * The plans are always executed in-place with the arrays
+             * allocated by fftw_malloc(), so they can be planned with
+             * a temporary array of the same kind
+             */
+            fftw_complex *buffer = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftLength);
+
+            PlanPair pair;
+            pair.forward = fftw_plan_dft_r2c_2d(fftHeight, fftWidth, (double*)buffer, buffer, FFTW_ESTIMATE);
+            pair.backward = fftw_plan_dft_c2r_2d(fftHeight, fftWidth, buffer, (double*)buffer, FFTW_ESTIMATE);
+
+            fftw_free(buffer);
+
+            it = plans.insert(key, pair);
+        }
+
+        *forward = it->forward;
+        *backward = it->backward;
+    }
 };
 
 QMutex KisConvolutionWorkerFFTLock::fftwMutex;
+QHash<QPair<quint32, quint32>, KisConvolutionWorkerFFTLock::PlanPair> KisConvolutionWorkerFFTLock::plans;
 
 
 template<class _IteratorFactory_>
@@ -74,8 +129,18 @@ public:
         const quint32 halfKernelWidth = (kernel->width() - 1) / 2;
         const quint32 halfKernelHeight = (kernel->height() - 1) / 2;
 
-        m_fftWidth = areaSize.width() + 4 * halfKernelWidth;
-        m_fftHeight = areaSize.height() + 2 * halfKernelHeight;
+        /**
+         * The area is processed in chunks (overlap-save), so the memory
+         * footprint is bounded by the size of the chunk, not by the size
+         * of the area. All the chunks have the same size of the transform,
+         * so the kernel is transformed only once. The chunks are still
+         * bigger than the kernel to keep the overlapping part reasonable.
+         */
+        const int chunkWidth = qMin(areaSize.width(), qMax(maxChunkSize, int(8 * halfKernelWidth)));
+        const int chunkHeight = qMin(areaSize.height(), qMax(maxChunkSize, int(8 * halfKernelHeight)));
+
+        m_fftWidth = chunkWidth + 4 * halfKernelWidth;
+        m_fftHeight = chunkHeight + 2 * halfKernelHeight;
 
         /**
          * FIXME: check whether this "optimization" is needed to
@@ -106,56 +171,73 @@ public:
         FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
         int cacheRowStride = m_fftWidth + m_extraMem;
 
-        fillCacheFromDevice(src,
-                            QRect(srcPos.x() - halfKernelWidth,
-                                  srcPos.y() - halfKernelHeight,
-                                  m_fftWidth,
-                                  m_fftHeight),
-                            cacheRowStride,
-                            info, dataRect);
+        /**
+         * When the convolution is done in-place, the already written
+         * chunks would leak into the overlapping parts of the next ones
+         */
+        KisPaintDeviceSP source = src;
+        if (src == this->m_painter->device()) {
+            source = new KisPaintDevice(*src);
+        }
 
-        addToProgress(10);
-        if (isInterrupted()) return;
+        const int numChunksX = (areaSize.width() + chunkWidth - 1) / chunkWidth;
+        const int numChunksY = (areaSize.height() + chunkHeight - 1) / chunkHeight;
 
         // calculate number off fft operations required for progress reporting
-        const float progressPerFFT = (100 - 30) / (double)(convChannelList.count() * 2 + 1);
+        const float progressPerFFT =
+            (100 - 30) / (double)(numChunksX * numChunksY * convChannelList.count() * 2 + 1);
+        const float progressPerChunk = 30.0 / (numChunksX * numChunksY);
 
         // perform FFT
         fftw_plan fftwPlanForward, fftwPlanBackward;
+        KisConvolutionWorkerFFTLock::fetchPlans(m_fftWidth, m_fftHeight, m_fftLength,
+                                                &fftwPlanForward, &fftwPlanBackward);
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
-        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
-
-        fftw_execute(fftwPlanForward);
+        fftw_execute_dft_r2c(fftwPlanForward, (double*)m_kernelFFT, m_kernelFFT);
         addToProgress(progressPerFFT);
         if (isInterrupted()) return;
 
-        for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+        for (int chunkY = 0; chunkY < numChunksY; chunkY++) {
+            for (int chunkX = 0; chunkX < numChunksX; chunkX++) {
+                const QPoint chunkOffset(chunkX * chunkWidth, chunkY * chunkHeight);
+                const QSize chunkSize(qMin(chunkWidth, areaSize.width() - chunkOffset.x()),
+                                      qMin(chunkHeight, areaSize.height() - chunkOffset.y()));
+
+                const QPoint chunkSrcPos = srcPos + chunkOffset;
+                const QPoint chunkDstPos = dstPos + chunkOffset;
+
+                fillCacheFromDevice(source,
+                                    QRect(chunkSrcPos.x() - halfKernelWidth,
+                                          chunkSrcPos.y() - halfKernelHeight,
+                                          m_fftWidth,
+                                          m_fftHeight),
+                                    cacheRowStride,
+                                    info, dataRect);
+
+                addToProgress(progressPerChunk * 0.5);
+                if (isInterrupted()) return;
+
+                for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
+                {
+                    fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
+                    addToProgress(progressPerFFT);
+                    if (isInterrupted()) return;
+
+                    fftMultiply(*k, m_kernelFFT);
+
+                    fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
+                    addToProgress(progressPerFFT);
+                    if (isInterrupted()) return;
+                }
 
-            fftMultiply(*k, m_kernelFFT);
+                writeResultToDevice(QRect(chunkDstPos, chunkSize),
+                                    cacheRowStride, halfKernelWidth, halfKernelHeight,
+                                    info, dataRect);
 
-            fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+                addToProgress(progressPerChunk * 0.5);
+            }
         }
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftw_destroy_plan(fftwPlanForward);
-        fftw_destroy_plan(fftwPlanBackward);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
-
-
-        writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
-                            cacheRowStride, halfKernelWidth, halfKernelHeight,
-                            info, dataRect);
-
-        addToProgress(20);
         cleanUp();
     }
 
@@ -536,6 +618,7 @@ private:
         // free kernel fft data
         if (m_kernelFFT) {
             fftw_free(m_kernelFFT);
+            m_kernelFFT = 0;
         }
 
         Q_FOREACH (fftw_complex *channel, m_channelFFT) {
@@ -544,6 +627,8 @@ private:
         m_channelFFT.clear();
     }
 private:
+    static const int maxChunkSize = 1024;
+
     quint32 m_fftWidth {0};
     quint32 m_fftHeight {0};
     quint32 m_fftLength {0};
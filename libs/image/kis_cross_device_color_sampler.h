@@ -7,6 +7,8 @@
 #ifndef __KIS_CROSS_DEVICE_COLOR_SAMPLER_H
 #define __KIS_CROSS_DEVICE_COLOR_SAMPLER_H
 
+#include <QVector>
+
 #include "KoColorSpace.h"
 #include "kis_random_sub_accessor.h"
 
@@ -90,6 +92,25 @@ public:
         sampleColorImpl<true>(x, y, dst);
     }
 
+    /**
+     * Samples \p numPoints colors at once and writes them one after
+     * another into \p dst. All the colors are converted into the
+     * destination color space in one go, which is much cheaper than
+     * converting them one by one.
+     *
+     * \p Point is QPoint or QPointF, depending on the coordinates type
+     * of the sampler
+     */
+    template <class Point>
+    inline void sampleColors(const Point *points, int numPoints, quint8 *dst) {
+        sampleColorsImpl<false>(points, numPoints, dst);
+    }
+
+    template <class Point>
+    inline void sampleOldColors(const Point *points, int numPoints, quint8 *dst) {
+        sampleColorsImpl<true>(points, numPoints, dst);
+    }
+
 private:
     template <typename T>
     inline void init(KisPaintDeviceSP src, T dst) {
@@ -97,6 +118,12 @@ private:
         m_dstCS = dst->colorSpace();
         m_data = new quint8[m_srcCS->pixelSize()];
 
+        /**
+         * Comparing the color spaces involves comparing their profiles,
+         * so do that only once instead of doing it for every pixel
+         */
+        m_sameColorSpace = *m_srcCS == *m_dstCS;
+
         m_accessor = Traits::createAccessor(src);
     }
 
@@ -106,6 +133,11 @@ private:
                               quint8 *dst) {
         m_accessor->moveTo(x, y);
 
+        if (m_sameColorSpace) {
+            Traits::template sampleData<useOldData>(m_accessor, dst, m_srcCS);
+            return;
+        }
+
         Traits::template sampleData<useOldData>(m_accessor, m_data, m_srcCS);
 
         m_srcCS->convertPixelsTo(m_data, dst, m_dstCS, 1,
@@ -113,11 +145,35 @@ private:
                                  KoColorConversionTransformation::internalConversionFlags());
     }
 
+    template <bool useOldData, class Point>
+    inline void sampleColorsImpl(const Point *points, int numPoints, quint8 *dst) {
+        const int srcPixelSize = m_srcCS->pixelSize();
+
+        quint8 *samples = dst;
+        if (!m_sameColorSpace) {
+            m_batchData.resize(numPoints * srcPixelSize);
+            samples = m_batchData.data();
+        }
+
+        for (int i = 0; i < numPoints; i++) {
+            m_accessor->moveTo(points[i].x(), points[i].y());
+            Traits::template sampleData<useOldData>(m_accessor, samples + i * srcPixelSize, m_srcCS);
+        }
+
+        if (!m_sameColorSpace) {
+            m_srcCS->convertPixelsTo(samples, dst, m_dstCS, numPoints,
+                                     KoColorConversionTransformation::internalRenderingIntent(),
+                                     KoColorConversionTransformation::internalConversionFlags());
+        }
+    }
+
 private:
     const KoColorSpace *m_srcCS;
     const KoColorSpace *m_dstCS;
     typename Traits::accessor_type m_accessor;
     quint8 *m_data;
+    QVector<quint8> m_batchData;
+    bool m_sameColorSpace {false};
 };
 
 typedef KisCrossDeviceColorSamplerImpl<SamplerTraitReal> KisCrossDeviceColorSampler;
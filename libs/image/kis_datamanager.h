@@ -117,6 +117,18 @@ public:
         return ACTUAL_DATAMGR::read(io);
     }
 
+    inline bool writeDelta(KisPaintDeviceWriter &writer, KisDataManager *baseDM) {
+        return ACTUAL_DATAMGR::writeDelta(writer, baseDM);
+    }
+
+    inline void addMissingTiles(KisDataManager *baseDM) {
+        ACTUAL_DATAMGR::addMissingTiles(baseDM);
+    }
+
+    inline int numSharedTiles(KisDataManager *otherDM) {
+        return ACTUAL_DATAMGR::numSharedTiles(otherDM);
+    }
+
     inline void purge(const QRect& area) {
         ACTUAL_DATAMGR::purge(area);
     }
@@ -208,6 +220,14 @@ public:
         ACTUAL_DATAMGR::bitBlt(const_cast<KisTiledDataManager*>(srcDM.data()), rect);
     }
 
+    /**
+     * The same as \ref bitBlt() but moves the cloned area by
+     * \p tileOffset tiles
+     */
+    inline void bitBlt(KisTiledDataManagerSP srcDM, const QRect &rect, const QPoint &tileOffset) {
+        ACTUAL_DATAMGR::bitBlt(const_cast<KisTiledDataManager*>(srcDM.data()), rect, tileOffset);
+    }
+
     /**
      * The same as \ref bitBlt() but reads old data
      */
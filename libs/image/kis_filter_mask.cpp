@@ -6,6 +6,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QRegion>
 #include <KoIcon.h>
 #include <kis_icon.h>
 #include <KoCompositeOpRegistry.h>
@@ -21,6 +22,27 @@
 #include "kis_busy_progress_indicator.h"
 #include "kis_painter.h"
 
+namespace {
+
+/**
+ * The limits of the output cache of a mask. Beyond the area the
+ * cache would cost as much memory as a layer, and a region of too
+ * many rects makes every lookup slower than the filter itself.
+ */
+const qint64 maxOutputCacheArea = 4096 * 4096;
+const int maxOutputCacheRects = 64;
+
+qint64 regionArea(const QRegion &region)
+{
+    qint64 area = 0;
+    for (const QRect &rc : region) {
+        area += qint64(rc.width()) * rc.height();
+    }
+    return area;
+}
+
+}
+
 struct KisFilterMask::Private
 {
     struct NeedsTransparentPixelsCache {
@@ -29,6 +51,25 @@ struct KisFilterMask::Private
     };
     QMutex transparentPixelsCacheLock;
     std::optional<NeedsTransparentPixelsCache> needsTransparentPixelsCache;
+
+    /**
+     * The output of the filter, saved for the updates that come from
+     * the masks above this one. Such updates don't change the input of
+     * the filter, so spatial filters don't need to be reprocessed.
+     *
+     * The cache is dropped when the mask becomes invisible and
+     * restarted when it grows beyond maxOutputCacheArea or
+     * maxOutputCacheRects.
+     */
+    QMutex outputCacheLock;
+    KisPaintDeviceSP outputCache;
+    QRegion outputCacheValidRegion;
+
+    void resetOutputCache() {
+        QMutexLocker l(&outputCacheLock);
+        outputCache = 0;
+        outputCacheValidRegion = QRegion();
+    }
 };
 
 KisFilterMask::KisFilterMask(KisImageWSP image, const QString &name)
@@ -86,6 +127,7 @@ void KisFilterMask::setFilter(KisFilterConfigurationSP filterConfig, bool checkC
 {
     KisNodeFilterInterface::setFilter(filterConfig, checkCompareConfig);
     m_d->needsTransparentPixelsCache = std::nullopt;
+    m_d->resetOutputCache();
 }
 
 QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
@@ -94,7 +136,6 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
                                   PositionToFilthy maskPos,
                                   KisRenderPassFlags flags) const
 {
-    Q_UNUSED(maskPos);
     Q_UNUSED(flags);
 
     KisFilterConfigurationSP filterConfig = filter();
@@ -119,15 +160,79 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
         return QRect();
     }
 
+    const int lod = dst->defaultBounds()->currentLevelOfDetail();
+
+    /**
+     * Only spatial filters are worth caching, the point-wise ones
+     * are as fast as copying the cached data back. LodN updates are
+     * never cached, the data of lod0 stays untouched during them.
+     */
+    const bool canUseOutputCache =
+        lod == 0 && filter->neededRect(rc, filterConfig.data(), lod) != rc;
+
+    if (canUseOutputCache && maskPos == N_BELOW_FILTHY) {
+        QMutexLocker l(&m_d->outputCacheLock);
+
+        if (m_d->outputCache &&
+            *m_d->outputCache->colorSpace() == *dst->colorSpace() &&
+            (QRegion(rc) - m_d->outputCacheValidRegion).isEmpty()) {
+
+            KisPaintDeviceSP outputCache = m_d->outputCache;
+            l.unlock();
+
+            KisPainter::copyAreaOptimized(rc.topLeft(), outputCache, dst, rc);
+            return filter->changedRect(rc, filterConfig.data(), lod);
+        }
+    }
+
     KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
     this->busyProgressIndicator()->update();
 
     filter->process(src, dst, 0, rc, filterConfig.data(), 0);
 
-    QRect r = filter->changedRect(rc, filterConfig.data(), dst->defaultBounds()->currentLevelOfDetail());
+    if (canUseOutputCache && qint64(rc.width()) * rc.height() <= maxOutputCacheArea) {
+        QMutexLocker l(&m_d->outputCacheLock);
+
+        if (!m_d->outputCache || *m_d->outputCache->colorSpace() != *dst->colorSpace()) {
+            m_d->outputCache = new KisPaintDevice(dst->colorSpace());
+            m_d->outputCacheValidRegion = QRegion();
+        } else {
+            const QRegion newRegion = m_d->outputCacheValidRegion + rc;
+
+            if (newRegion.rectCount() > maxOutputCacheRects ||
+                regionArea(newRegion) > maxOutputCacheArea) {
+
+                m_d->outputCache = new KisPaintDevice(dst->colorSpace());
+                m_d->outputCacheValidRegion = QRegion();
+            }
+        }
+
+        KisPaintDeviceSP outputCache = m_d->outputCache;
+        l.unlock();
+
+        KisPainter::copyAreaOptimized(rc.topLeft(), dst, outputCache, rc);
+
+        l.relock();
+
+        // the filter might have been changed in the meantime
+        if (m_d->outputCache == outputCache) {
+            m_d->outputCacheValidRegion += rc;
+        }
+    }
+
+    QRect r = filter->changedRect(rc, filterConfig.data(), lod);
     return r;
 }
 
+void KisFilterMask::notifyParentVisibilityChanged(bool value)
+{
+    if (!value || !visible(true)) {
+        m_d->resetOutputCache();
+    }
+
+    KisEffectMask::notifyParentVisibilityChanged(value);
+}
+
 bool KisFilterMask::accept(KisNodeVisitor &v)
 {
     return v.visit(this);
@@ -57,6 +57,8 @@ public:
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
 
+    void notifyParentVisibilityChanged(bool value) override;
+
 private:
     bool filterNeedsTransparentPixels() const;
 
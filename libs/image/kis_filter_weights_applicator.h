@@ -15,6 +15,8 @@
 #include <KoColorSpace.h>
 #include <KoMixColorsOp.h>
 
+#include <vector>
+
 
 namespace tmp {
     template <class iter> iter createIterator(KisPaintDeviceSP dev, qint32 start, qint32 lineNum, qint32 len);
@@ -234,7 +236,8 @@ public:
         const KoColor defaultPixelObject = m_src->defaultPixel();
         const quint8 *defaultPixel = defaultPixelObject.data();
         const quint8 *borderPixel = defaultPixel;
-        quint8 *srcLineBuf = new quint8[pixelSize * (rightSrcBorder - leftSrcBorder)];
+        m_srcLineBuf.resize(pixelSize * (rightSrcBorder - leftSrcBorder));
+        quint8 *srcLineBuf = m_srcLineBuf.data();
 
         int i = leftSrcBorder;
         quint8 *bufPtr = srcLineBuf;
@@ -249,11 +252,23 @@ public:
             memcpy(bufPtr, borderPixel, pixelSize);
         }
 
-        for (; i < srcLine.end(); i++, bufPtr+=pixelSize) {
+        /**
+         * Copy the line in the runs of pixels that are consecutive in
+         * memory (the rest of the tile row for horizontal passes), so
+         * the iterator is advanced once per run, not once per pixel
+         */
+        while (i < srcLine.end()) {
+            const int numPixels = qMin(srcIt->nConseqPixels(), srcLine.end() - i);
             quint8 *data = srcIt->rawData();
-            memcpy(bufPtr, data, pixelSize);
-            memcpy(data, defaultPixel, pixelSize);
-            srcIt->nextPixel();
+
+            memcpy(bufPtr, data, numPixels * pixelSize);
+            for (int j = 0; j < numPixels; j++, data += pixelSize) {
+                memcpy(data, defaultPixel, pixelSize);
+            }
+
+            i += numPixels;
+            bufPtr += numPixels * pixelSize;
+            srcIt->nextPixels(numPixels);
         }
 
         if (m_clampToEdge) {
@@ -264,27 +279,29 @@ public:
             memcpy(bufPtr, borderPixel, pixelSize);
         }
 
-        const quint8 **colors = new const quint8* [buffer->maxSpan()];
-
+        /**
+         * The pixels of a span are stored sequentially in the line
+         * buffer, so they are passed to the mixing op as a plain array,
+         * which the vectorized mixing ops can load directly
+         */
         T dstIt = tmp::createIterator<T>(m_dst, dstStart, line, dstEnd - dstStart);
-        for (int i = dstStart; i < dstEnd; i++) {
-            BlendSpan span = calculateBlendSpan(i, line, buffer);
+        int dstPos = dstStart;
+        while (dstPos < dstEnd) {
+            const int numPixels = qMin(dstIt->nConseqPixels(), dstEnd - dstPos);
+            quint8 *dstPtr = dstIt->rawData();
 
-            int bufIndexStart = span.firstBlendPixel - leftSrcBorder;
-            int bufIndexEnd = bufIndexStart + span.weights->span;
+            for (int j = 0; j < numPixels; j++, dstPos++, dstPtr += pixelSize) {
+                BlendSpan span = calculateBlendSpan(dstPos, line, buffer);
 
-            const quint8 **colorsPtr = colors;
-            for (int j = bufIndexStart; j < bufIndexEnd; j++) {
-                *(colorsPtr++) = srcLineBuf + j * pixelSize;
+                int bufIndexStart = span.firstBlendPixel - leftSrcBorder;
+
+                mixOp->mixColors(srcLineBuf + bufIndexStart * pixelSize,
+                                 span.weights->weight, span.weights->span, dstPtr);
             }
 
-            mixOp->mixColors(colors, span.weights->weight, span.weights->span, dstIt->rawData());
-            dstIt->nextPixel();
+            dstIt->nextPixels(numPixels);
         }
 
-        delete[] colors;
-        delete[] srcLineBuf;
-
         return LinePos(dstStart, qMax(0, dstEnd - dstStart));
     }
 
@@ -334,6 +351,8 @@ private:
     qreal m_shear;
     qreal m_dx;
     bool m_clampToEdge;
+
+    std::vector<quint8> m_srcLineBuf;
 };
 
 #endif /* __KIS_FILTER_WEIGHTS_APPLICATOR_H */
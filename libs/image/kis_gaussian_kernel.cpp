@@ -10,8 +10,271 @@
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
 #include <kis_transaction.h>
+#include <kis_default_bounds_base.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoUpdater.h>
 #include <QRect>
 
+#include <vector>
+
+namespace {
+
+/**
+ * Coefficients of the recursive Gaussian filter by
+ * I. T. Young and L. J. van Vliet, "Recursive implementation of
+ * the Gaussian filter", Signal Processing 44 (1995).
+ */
+struct RecursiveGaussianCoeffs
+{
+    RecursiveGaussianCoeffs(qreal sigma)
+    {
+        const qreal q = sigma >= 2.5 ?
+            0.98711 * sigma - 0.96330 :
+            3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+
+        const qreal q2 = q * q;
+        const qreal q3 = q2 * q;
+
+        const qreal b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+
+        b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+        b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+        b3 = 0.422205 * q3 / b0;
+        B = 1.0f - (b1 + b2 + b3);
+    }
+
+    float B;
+    float b1;
+    float b2;
+    float b3;
+};
+
+/**
+ * Smaller sigmas make the recursive filter unstable,
+ * the convolution is cheap for them anyway
+ */
+const qreal minRecursiveGaussianSigma = 0.5;
+
+/**
+ * Starting from this radius the cost of the convolution kernels
+ * (and the memory of the FFT buffers) grows faster than the
+ * accuracy of the recursive filter matters
+ */
+const qreal minRecursiveGaussianRadius = 50.0;
+
+/**
+ * Runs the causal and anti-causal passes of the filter along the
+ * columns of a row-major \p data of \p rowLength floats. The inner
+ * loops go over a contiguous row, so the compiler vectorizes them.
+ * The borders are extended by repeating the edge values.
+ */
+void recursiveGaussianColumns(float *data, int rowLength, int numRows,
+                              const RecursiveGaussianCoeffs &c)
+{
+    if (numRows < 4) return;
+
+    float *row = data;
+
+    // the steady state of a constant signal is the signal itself
+    for (int y = 0; y < numRows; y++, row += rowLength) {
+        const float *prev1 = y >= 1 ? row - rowLength : data;
+        const float *prev2 = y >= 2 ? row - 2 * rowLength : data;
+        const float *prev3 = y >= 3 ? row - 3 * rowLength : data;
+
+        for (int x = 0; x < rowLength; x++) {
+            row[x] = c.B * row[x] + c.b1 * prev1[x] + c.b2 * prev2[x] + c.b3 * prev3[x];
+        }
+    }
+
+    float *lastRow = data + (numRows - 1) * rowLength;
+    row = lastRow;
+
+    for (int y = numRows - 1; y >= 0; y--, row -= rowLength) {
+        const float *next1 = y + 1 < numRows ? row + rowLength : lastRow;
+        const float *next2 = y + 2 < numRows ? row + 2 * rowLength : lastRow;
+        const float *next3 = y + 3 < numRows ? row + 3 * rowLength : lastRow;
+
+        for (int x = 0; x < rowLength; x++) {
+            row[x] = c.B * row[x] + c.b1 * next1[x] + c.b2 * next2[x] + c.b3 * next3[x];
+        }
+    }
+}
+
+void transposePixels(const float *src, float *dst, int width, int height, int pixelLength)
+{
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const float *srcPixel = src + (y * width + x) * pixelLength;
+            float *dstPixel = dst + (x * height + y) * pixelLength;
+            std::copy(srcPixel, srcPixel + pixelLength, dstPixel);
+        }
+    }
+}
+
+bool canUseRecursiveGaussian(KisPaintDeviceSP device, qreal xRadius, qreal yRadius)
+{
+    if (qMax(xRadius, yRadius) < minRecursiveGaussianRadius) return false;
+
+    if ((xRadius > 0.0 && KisGaussianKernel::sigmaFromRadius(xRadius) < minRecursiveGaussianSigma) ||
+        (yRadius > 0.0 && KisGaussianKernel::sigmaFromRadius(yRadius) < minRecursiveGaussianSigma)) {
+
+        return false;
+    }
+
+    // the wrapping iterators of the convolution handle this mode
+    if (device->defaultBounds()->wrapAroundMode() && device->supportsWraproundMode()) {
+        return false;
+    }
+
+    const KoColorSpace *cs = device->colorSpace();
+
+    return KoColorSpaceRegistry::instance()->colorSpace(cs->colorModelId().id(),
+                                                        Float32BitsColorDepthID.id(),
+                                                        cs->profile());
+}
+
+/**
+ * Blurs the \p rect of the \p device with the recursive filter, whose
+ * cost doesn't depend on the radius. The pixels are converted into the
+ * floating point version of the color space and premultiplied by alpha,
+ * the same way the convolution workers do it.
+ */
+void applyRecursiveGaussian(KisPaintDeviceSP device,
+                            const QRect& rect,
+                            qreal xRadius, qreal yRadius,
+                            const QBitArray &channelFlags,
+                            KoUpdater *progressUpdater,
+                            KisConvolutionBorderOp borderOp)
+{
+    const KoColorSpace *cs = device->colorSpace();
+    const KoColorSpace *floatCs =
+        KoColorSpaceRegistry::instance()->colorSpace(cs->colorModelId().id(),
+                                                     Float32BitsColorDepthID.id(),
+                                                     cs->profile());
+
+    const int xMargin = xRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(xRadius) / 2 : 0;
+    const int yMargin = yRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(yRadius) / 2 : 0;
+
+    QRect readRect = rect.adjusted(-xMargin, -yMargin, xMargin, yMargin);
+
+    if (borderOp == BORDER_REPEAT) {
+        // the filter repeats the edge pixels itself
+        readRect &= rect | device->defaultBounds()->bounds();
+    }
+
+    if (readRect.isEmpty()) return;
+
+    const int width = readRect.width();
+    const int height = readRect.height();
+    const int numPixels = width * height;
+    const int channelCount = floatCs->channelCount();
+    const int pixelLength = channelCount;
+
+    std::vector<quint8> srcPixels(numPixels * cs->pixelSize());
+    device->readBytes(srcPixels.data(), readRect);
+
+    std::vector<float> pixels(numPixels * pixelLength);
+    cs->convertPixelsTo(srcPixels.data(), reinterpret_cast<quint8*>(pixels.data()),
+                        floatCs, numPixels,
+                        KoColorConversionTransformation::internalRenderingIntent(),
+                        KoColorConversionTransformation::internalConversionFlags());
+
+    std::vector<float> original(pixels);
+
+    const QList<KoChannelInfo*> channels = floatCs->channels();
+    int alphaIndex = -1;
+    QVector<int> channelIndexes;
+
+    for (int i = 0; i < channels.size(); i++) {
+        const int index = channels[i]->pos() / int(sizeof(float));
+        channelIndexes << index;
+
+        if (channels[i]->channelType() == KoChannelInfo::ALPHA) {
+            alphaIndex = index;
+        }
+    }
+
+    if (alphaIndex >= 0) {
+        for (int i = 0; i < numPixels; i++) {
+            float *pixel = pixels.data() + i * pixelLength;
+            const float alpha = pixel[alphaIndex];
+
+            for (int k = 0; k < pixelLength; k++) {
+                if (k != alphaIndex) pixel[k] *= alpha;
+            }
+        }
+    }
+
+    if (progressUpdater) progressUpdater->setProgress(20);
+
+    if (yRadius > 0.0) {
+        recursiveGaussianColumns(pixels.data(), width * pixelLength, height,
+                                 RecursiveGaussianCoeffs(KisGaussianKernel::sigmaFromRadius(yRadius)));
+    }
+
+    if (progressUpdater) progressUpdater->setProgress(50);
+
+    if (xRadius > 0.0) {
+        std::vector<float> transposed(pixels.size());
+        transposePixels(pixels.data(), transposed.data(), width, height, pixelLength);
+        recursiveGaussianColumns(transposed.data(), height * pixelLength, width,
+                                 RecursiveGaussianCoeffs(KisGaussianKernel::sigmaFromRadius(xRadius)));
+        transposePixels(transposed.data(), pixels.data(), height, width, pixelLength);
+    }
+
+    if (progressUpdater) progressUpdater->setProgress(80);
+
+    for (int i = 0; i < numPixels; i++) {
+        float *pixel = pixels.data() + i * pixelLength;
+        const float *originalPixel = original.data() + i * pixelLength;
+
+        if (alphaIndex >= 0) {
+            const float alpha = pixel[alphaIndex];
+            const float alphaInv = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+
+            for (int k = 0; k < pixelLength; k++) {
+                if (k != alphaIndex) pixel[k] *= alphaInv;
+            }
+        }
+
+        for (int ch = 0; ch < channelIndexes.size(); ch++) {
+            if (ch < channelFlags.size() && !channelFlags.testBit(ch)) {
+                pixel[channelIndexes[ch]] = originalPixel[channelIndexes[ch]];
+            }
+        }
+    }
+
+    floatCs->convertPixelsTo(reinterpret_cast<const quint8*>(pixels.data()), srcPixels.data(),
+                             cs, numPixels,
+                             KoColorConversionTransformation::internalRenderingIntent(),
+                             KoColorConversionTransformation::internalConversionFlags());
+
+    // write back only the requested area, the margins were read just for the context
+    const QRect writeRect = rect & readRect;
+    const int pixelSize = cs->pixelSize();
+    const int srcRowStride = width * pixelSize;
+    const int dstRowStride = writeRect.width() * pixelSize;
+
+    std::vector<quint8> dstPixels(writeRect.height() * dstRowStride);
+
+    const quint8 *srcPtr = srcPixels.data() +
+        (writeRect.y() - readRect.y()) * srcRowStride +
+        (writeRect.x() - readRect.x()) * pixelSize;
+
+    for (int y = 0; y < writeRect.height(); y++) {
+        std::copy(srcPtr, srcPtr + dstRowStride, dstPixels.data() + y * dstRowStride);
+        srcPtr += srcRowStride;
+    }
+
+    device->writeBytes(dstPixels.data(), writeRect);
+
+    if (progressUpdater) progressUpdater->setProgress(100);
+}
+
+}
+
 
 qreal KisGaussianKernel::sigmaFromRadius(qreal radius)
 {
@@ -109,8 +372,16 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 {
     QPoint srcTopLeft = rect.topLeft();
 
+    if (canUseRecursiveGaussian(device, xRadius, yRadius)) {
+        QScopedPointer<KisTransaction> transaction;
+        if (createTransaction) {
+            transaction.reset(new KisTransaction(device));
+        }
+
+        applyRecursiveGaussian(device, rect, xRadius, yRadius,
+                               channelFlags, progressUpdater, borderOp);
 
-    if (KisConvolutionPainter::supportsFFTW()) {
+    } else if (KisConvolutionPainter::supportsFFTW()) {
         KisConvolutionPainter painter(device, KisConvolutionPainter::FFTW);
         painter.setChannelFlags(channelFlags);
         painter.setProgress(progressUpdater);
@@ -7,6 +7,8 @@
 #include "kis_green_coordinates_math.h"
 
 #include <cmath>
+
+
 #include <kis_global.h>
 #include <kis_algebra_2d.h>
 using namespace KisAlgebra2D;
@@ -121,6 +123,17 @@ KisGreenCoordinatesMath::~KisGreenCoordinatesMath()
 {
 }
 
+KisGreenCoordinatesMath::KisGreenCoordinatesMath(const KisGreenCoordinatesMath &rhs)
+    : m_d(new Private(*rhs.m_d))
+{
+}
+
+KisGreenCoordinatesMath& KisGreenCoordinatesMath::operator=(const KisGreenCoordinatesMath &rhs)
+{
+    *m_d = *rhs.m_d;
+    return *this;
+}
+
 void KisGreenCoordinatesMath::precalculateGreenCoordinates(const QVector<QPointF> &originalCage, const QVector<QPointF> &points)
 {
     const int cageDirection = polygonDirection(originalCage);
@@ -172,20 +185,30 @@ void KisGreenCoordinatesMath::generateTransformedCageNormals(const QVector<QPoin
     }
 }
 
-QPointF KisGreenCoordinatesMath::transformedPoint(int pointIndex, const QVector<QPointF> &transformedCage)
+QPointF KisGreenCoordinatesMath::transformedPoint(int pointIndex, const QVector<QPointF> &transformedCage) const
 {
-    QPointF result;
-
     const int numCagePoints = transformedCage.size();
 
+    const PrecalculatedCoords &coords = m_d->precalculatedCoords.at(pointIndex);
+    const qreal *phi = coords.phi.constData();
+    const qreal *psi = coords.psi.constData();
+    const QPointF *vertices = transformedCage.constData();
+    const QPointF *normals = m_d->transformedCageNormals.constData();
 
-    PrecalculatedCoords *coords = &m_d->precalculatedCoords[pointIndex];
+    /**
+     * Accumulate the coordinates separately to let the compiler
+     * vectorize the loop
+     */
+    qreal x = 0.0;
+    qreal y = 0.0;
 
     for (int i = 0; i < numCagePoints; i++) {
-        result += coords->phi[i] * transformedCage[i];
-        result += coords->psi[i] * m_d->transformedCageNormals[i];
+        x += phi[i] * vertices[i].x();
+        y += phi[i] * vertices[i].y();
+        x += psi[i] * normals[i].x();
+        y += psi[i] * normals[i].y();
     }
 
-    return result;
+    return QPointF(x, y);
 }
 
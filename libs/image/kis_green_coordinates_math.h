@@ -19,6 +19,14 @@ public:
     KisGreenCoordinatesMath();
     ~KisGreenCoordinatesMath();
 
+    /**
+     * The precalculated coordinates are implicitly shared between the
+     * copies, so a copy can be transformed with a different cage in
+     * another thread without recalculating them
+     */
+    KisGreenCoordinatesMath(const KisGreenCoordinatesMath &rhs);
+    KisGreenCoordinatesMath& operator=(const KisGreenCoordinatesMath &rhs);
+
     /**
      * Prepare the transformation framework by computing internal
      * coordinates of the points in cage.
@@ -35,9 +43,10 @@ public:
     void generateTransformedCageNormals(const QVector<QPointF> &transformedCage);
 
     /**
-     * Transform one point according to its index
+     * Transform one point according to its index. The method doesn't
+     * change the object, so the points may be transformed concurrently.
      */
-    QPointF transformedPoint(int pointIndex, const QVector<QPointF> &transformedCage);
+    QPointF transformedPoint(int pointIndex, const QVector<QPointF> &transformedCage) const;
 
 private:
     struct Private;
@@ -167,12 +167,24 @@ struct PaintDevicePolygonOp
     PaintDevicePolygonOp(KisPaintDeviceSP srcDev, KisPaintDeviceSP dstDev)
         : m_srcDev(srcDev), m_dstDev(dstDev) {}
 
+    /**
+     * Restricts the written pixels to \p rect. The concurrent jobs
+     * may process the same cells with different non-overlapping
+     * clip rects.
+     */
+    void setClipRect(const QRect &rect) {
+        m_clipRect = rect;
+    }
+
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
         this->operator() (srcPolygon, dstPolygon, dstPolygon);
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
         QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        if (!m_clipRect.isNull()) {
+            boundRect &= m_clipRect;
+        }
         if (boundRect.isEmpty()) return;
 
         KisSequentialIterator dstIt(m_dstDev, boundRect);
@@ -232,6 +244,7 @@ struct PaintDevicePolygonOp
 
     KisPaintDeviceSP m_srcDev;
     KisPaintDeviceSP m_dstDev;
+    QRect m_clipRect;
 };
 
 struct QImagePolygonOp
@@ -247,12 +260,25 @@ struct QImagePolygonOp
     {
     }
 
+    /**
+     * Restricts the written pixels to \p rect (in the coordinates of
+     * the polygons, not of the image)
+     */
+    void setClipRect(const QRect &rect) {
+        m_clipRect = rect;
+    }
+
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
         this->operator() (srcPolygon, dstPolygon, dstPolygon);
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
         QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        if (!m_clipRect.isNull()) {
+            boundRect &= m_clipRect;
+            if (boundRect.isEmpty()) return;
+        }
+
         KisFourPointInterpolatorBackward interp(srcPolygon, dstPolygon);
 
         for (int y = boundRect.top(); y <= boundRect.bottom(); y++) {
@@ -304,6 +330,7 @@ struct QImagePolygonOp
 
     QRect m_srcImageRect;
     QRect m_dstImageRect;
+    QRect m_clipRect;
 };
 
 /*************************************************************/
@@ -595,6 +622,35 @@ inline void adjustAlignedPolygon(QPolygonF &polygon)
     polygon[3] += p3;
 }
 
+/**
+ * Returns the polygons of the cell of a regular (complete) grid with its
+ * top-left point at \p topLeftIndex, the same way iterateThroughGrid()
+ * builds them
+ */
+inline void fetchCompleteCellPolygons(int topLeftIndex,
+                                      const QSize &gridSize,
+                                      const QVector<QPointF> &originalPoints,
+                                      const QVector<QPointF> &transformedPoints,
+                                      QPolygonF *srcPolygon,
+                                      QPolygonF *dstPolygon)
+{
+    const int indexes[4] = {topLeftIndex,
+                            topLeftIndex + 1,
+                            topLeftIndex + gridSize.width() + 1,
+                            topLeftIndex + gridSize.width()};
+
+    srcPolygon->resize(4);
+    dstPolygon->resize(4);
+
+    for (int i = 0; i < 4; i++) {
+        (*srcPolygon)[i] = originalPoints[indexes[i]];
+        (*dstPolygon)[i] = transformedPoints[indexes[i]];
+    }
+
+    adjustAlignedPolygon(*srcPolygon);
+    adjustAlignedPolygon(*dstPolygon);
+}
+
 template <template <class PolygonOp, class IndexesOp> class IncompletePolygonPolicy,
           class PolygonOp,
           class IndexesOp>
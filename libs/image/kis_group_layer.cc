@@ -27,6 +27,7 @@
 #include "kis_layer_properties_icons.h"
 #include <kis_projection_leaf.h>
 #include <kis_abstract_projection_plane.h>
+#include "KisBelowFilthyCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -44,6 +45,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    KisBelowFilthyCache belowFilthyCache;
 
     std::tuple<KisPaintDeviceSP, bool> originalImpl() const;
 };
@@ -192,6 +194,8 @@ void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 
     Q_ASSERT(colorSpace);
 
+    m_d->belowFilthyCache.clear();
+
     if (!m_d->paintDevice) {
 
         KisPaintDeviceSP dev = new KisPaintDevice(this, colorSpace, new KisDefaultBounds(image()));
@@ -291,6 +295,11 @@ KisPaintDeviceSP KisGroupLayer::lazyDestinationForSubtreeComposition() const
     return ownsOriginal ? originalDev : nullptr;
 }
 
+KisBelowFilthyCache& KisGroupLayer::belowFilthyCache() const
+{
+    return m_d->belowFilthyCache;
+}
+
 QRect KisGroupLayer::amortizedProjectionRectForCleanupInChangePass() const
 {
     return hasEffectMasks() ? projection()->exactBoundsAmortized() : m_d->paintDevice->exactBoundsAmortized();
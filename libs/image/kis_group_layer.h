@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisBelowFilthyCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -66,6 +67,12 @@ public:
      */
     KisPaintDeviceSP lazyDestinationForSubtreeComposition() const;
 
+    /**
+     * The cache of the composition of the children below the filthy
+     * one, used by KisAsyncMerger
+     */
+    KisBelowFilthyCache& belowFilthyCache() const;
+
     qint32 x() const override;
     qint32 y() const override;
     void setX(qint32 x) override;
@@ -77,6 +77,7 @@
 
 #include "kis_suspend_projection_updates_stroke_strategy.h"
 #include "kis_sync_lod_cache_stroke_strategy.h"
+#include "KisPurgeLodSyncStateStrokeStrategy.h"
 
 #include "kis_projection_updates_filter.h"
 
@@ -84,6 +85,8 @@
 
 #include "kis_update_time_monitor.h"
 #include "kis_lockless_stack.h"
+#include "kis_datamanager.h"
+#include "tiles3/kis_tile_data_store.h"
 
 #include <QtCore>
 
@@ -892,6 +895,10 @@ void KisImage::purgeUnusedData(bool isCancellable)
             setClearsRedoOnStart(false);
             setRequestsOtherStrokesToEnd(!isCancellable);
             setCanForgetAboutMe(isCancellable);
+
+            if (isCancellable) {
+                setPriority(BACKGROUND_PRIORITY);
+            }
         }
 
         void initStrokeCallback() override
@@ -2152,6 +2159,49 @@ void KisImage::requestStrokeEndActiveNode()
     Q_EMIT sigStrokeEndRequested();
 }
 
+void KisImage::requestTilePrefetch(const QRect &rect, KisNodeSP node)
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    // nothing has been swapped out, so nothing to prefetch
+    if (store->numTiles() == store->numTilesInMemory()) return;
+
+    const QRect prefetchRect = rect & bounds();
+    if (prefetchRect.isEmpty()) return;
+
+    /**
+     * The walk over the whole graph is not safe outside the scheduler,
+     * and the scheduler doesn't start spontaneous jobs while the
+     * strokes are running, i.e. exactly when the hints are needed.
+     * So we only hint the devices we can reach directly: the
+     * projection the canvas reads from and the node the caller is
+     * going to work on. The layers underneath are loaded by the merge
+     * jobs when they recomposite the area anyway.
+     */
+    QVector<KisPaintDeviceSP> devices;
+    devices << m_d->rootLayer->projection();
+
+    if (node) {
+        devices << node->paintDevice() << node->original() << node->projection();
+    }
+
+    QSet<KisDataManager*> dataManagers;
+
+    Q_FOREACH (KisPaintDeviceSP device, devices) {
+        if (!device) continue;
+
+        KisDataManagerSP dm = device->dataManager();
+        if (dataManagers.contains(dm.data())) continue;
+        dataManagers.insert(dm.data());
+
+        /**
+         * prefetchRect() never blocks on the data manager lock and
+         * hands the swapped-out tiles over to the prefetcher thread
+         */
+        dm->prefetchRect(prefetchRect);
+    }
+}
+
 void KisImage::initialRefreshGraph()
 {
     /**
@@ -2551,6 +2601,11 @@ int KisImage::currentLevelOfDetail() const
     return m_d->scheduler.currentLevelOfDetail();
 }
 
+void KisImage::reportFramePresented()
+{
+    m_d->scheduler.reportFramePresented();
+}
+
 void KisImage::explicitRegenerateLevelOfDetail()
 {
     const KisLodPreferences pref = m_d->scheduler.lodPreferences();
@@ -2562,7 +2617,23 @@ void KisImage::explicitRegenerateLevelOfDetail()
 
 void KisImage::setLodPreferences(const KisLodPreferences &value)
 {
+    auto isLodActive = [] (const KisLodPreferences &pref) {
+        return pref.lodPreferred() && pref.desiredLevelOfDetail() > 0;
+    };
+
+    const bool lodWasActive = isLodActive(m_d->scheduler.lodPreferences());
+
     m_d->scheduler.setLodPreferences(value);
+
+    /**
+     * The devices keep the state of the last LoD sync to resync
+     * only the changed tiles next time. When LoD mode is turned
+     * off, the state is not needed anymore.
+     */
+    if (lodWasActive && !isLodActive(value)) {
+        KisStrokeId id = startStroke(new KisPurgeLodSyncStateStrokeStrategy(this));
+        endStroke(id);
+    }
 }
 
 KisLodPreferences KisImage::lodPreferences() const
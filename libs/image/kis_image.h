@@ -733,6 +733,13 @@ public:
      */
     int currentLevelOfDetail() const;
 
+    /**
+     * Notify the image that a canvas showing it has presented a frame.
+     * The frame rate is used to postpone spontaneous jobs of the
+     * scheduler that would make the canvas drop frames.
+     */
+    void reportFramePresented();
+
     /**
      * Relative position of the mirror axis center
      *     0,0 - topleft corner of the image
@@ -1237,6 +1244,20 @@ public Q_SLOTS:
      */
     void requestStrokeEndActiveNode();
 
+    /**
+     * Hints the tiles engine that the pixels in \p rect (in image
+     * coordinates) are going to be accessed soon, e.g. because the
+     * canvas has been panned over there or a stroke is heading
+     * there. Swapped-out tiles of the projection of the image and
+     * of \p node (if any) are loaded in the background by the tile
+     * data prefetcher.
+     *
+     * The method doesn't walk the graph and never blocks on locks or
+     * swap I/O, so it is safe to call from the GUI thread while the
+     * strokes are running.
+     */
+    void requestTilePrefetch(const QRect &rect, KisNodeSP node = KisNodeSP());
+
     /**
      * A special interface that commands use to modify image's global selection
      */
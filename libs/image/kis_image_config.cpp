@@ -80,6 +80,17 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+QString KisImageConfig::schedulerTraceFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("schedulerTraceFile", QString()) : QString();
+}
+
+void KisImageConfig::setSchedulerTraceFile(const QString &value)
+{
+    m_config.writeEntry("schedulerTraceFile", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -109,6 +120,61 @@ void KisImageConfig::setUpdatePatchWidth(int value)
     m_config.writeEntry("updatePatchWidth", value);
 }
 
+bool KisImageConfig::adaptiveUpdatePatches(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveUpdatePatches", true) : true;
+}
+
+void KisImageConfig::setAdaptiveUpdatePatches(bool value)
+{
+    m_config.writeEntry("adaptiveUpdatePatches", value);
+}
+
+bool KisImageConfig::enableBelowFilthyCache(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableBelowFilthyCache", true) : true;
+}
+
+void KisImageConfig::setEnableBelowFilthyCache(bool value)
+{
+    m_config.writeEntry("enableBelowFilthyCache", value);
+}
+
+bool KisImageConfig::incrementalLodSync(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("incrementalLodSync", true) : true;
+}
+
+void KisImageConfig::setIncrementalLodSync(bool value)
+{
+    m_config.writeEntry("incrementalLodSync", value);
+}
+
+bool KisImageConfig::frameBudgetScheduling(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("frameBudgetScheduling", true) : true;
+}
+
+void KisImageConfig::setFrameBudgetScheduling(bool value)
+{
+    m_config.writeEntry("frameBudgetScheduling", value);
+}
+
+bool KisImageConfig::numaAwareScheduling(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("numaAwareScheduling", false) : false;
+}
+
+void KisImageConfig::setNumaAwareScheduling(bool value)
+{
+    m_config.writeEntry("numaAwareScheduling", value);
+}
+
 qreal KisImageConfig::maxCollectAlpha() const
 {
     return m_config.readEntry("maxCollectAlpha", 2.5);
@@ -168,6 +234,105 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompressionAlgorithm(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionAlgorithm", "lzf") : QString("lzf");
+}
+
+void KisImageConfig::setSwapCompressionAlgorithm(const QString &value)
+{
+    m_config.writeEntry("swapCompressionAlgorithm", value);
+}
+
+int KisImageConfig::swapOutBatchSize(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapOutBatchSize", 0) : 0;
+}
+
+void KisImageConfig::setSwapOutBatchSize(int value)
+{
+    m_config.writeEntry("swapOutBatchSize", value);
+}
+
+bool KisImageConfig::mapWholeSwapFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("mapWholeSwapFile", false) : false;
+}
+
+void KisImageConfig::setMapWholeSwapFile(bool value)
+{
+    m_config.writeEntry("mapWholeSwapFile", value);
+}
+
+int KisImageConfig::compressedTilePoolSize(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("compressedTilePoolSize", 0) : 0;
+}
+
+void KisImageConfig::setCompressedTilePoolSize(int value)
+{
+    m_config.writeEntry("compressedTilePoolSize", value);
+}
+
+bool KisImageConfig::enableTileDataDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableTileDataDeduplication", false) : false;
+}
+
+void KisImageConfig::setEnableTileDataDeduplication(bool value)
+{
+    m_config.writeEntry("enableTileDataDeduplication", value);
+}
+
+bool KisImageConfig::lazyTileLoading(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("lazyTileLoading", false) : false;
+}
+
+void KisImageConfig::setLazyTileLoading(bool value)
+{
+    m_config.writeEntry("lazyTileLoading", value);
+}
+
+int KisImageConfig::undoSwapOutDepth(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoSwapOutDepth", 0) : 0;
+}
+
+void KisImageConfig::setUndoSwapOutDepth(int value)
+{
+    m_config.writeEntry("undoSwapOutDepth", value);
+}
+
+bool KisImageConfig::dropUnchangedUndoTiles(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("dropUnchangedUndoTiles", true) : true;
+}
+
+void KisImageConfig::setDropUnchangedUndoTiles(bool value)
+{
+    m_config.writeEntry("dropUnchangedUndoTiles", value);
+}
+
+int KisImageConfig::numDocumentsWithCaches(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("numDocumentsWithCaches", 3) : 3;
+}
+
+void KisImageConfig::setNumDocumentsWithCaches(int value)
+{
+    m_config.writeEntry("numDocumentsWithCaches", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -640,6 +805,16 @@ void KisImageConfig::setUseOnDiskAnimationCacheSwapping(bool value)
     m_config.writeEntry("useOnDiskAnimationCacheSwapping", value);
 }
 
+bool KisImageConfig::compressInMemoryAnimationCache(bool defaultValue) const
+{
+    return defaultValue ? true : m_config.readEntry("compressInMemoryAnimationCache", true);
+}
+
+void KisImageConfig::setCompressInMemoryAnimationCache(bool value)
+{
+    m_config.writeEntry("compressInMemoryAnimationCache", value);
+}
+
 QString KisImageConfig::animationCacheDir(bool defaultValue) const
 {
     return safelyGetWritableTempLocation("animation_cache", "animationCacheDir", defaultValue);
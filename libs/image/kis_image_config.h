@@ -24,12 +24,29 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    QString schedulerTraceFile(bool requestDefault = false) const;
+    void setSchedulerTraceFile(const QString &value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
     void setUpdatePatchHeight(int value);
     int updatePatchWidth() const;
     void setUpdatePatchWidth(int value);
+    bool adaptiveUpdatePatches(bool requestDefault = false) const;
+    void setAdaptiveUpdatePatches(bool value);
+    bool enableBelowFilthyCache(bool requestDefault = false) const;
+    void setEnableBelowFilthyCache(bool value);
+    bool incrementalLodSync(bool requestDefault = false) const;
+    void setIncrementalLodSync(bool value);
+    bool frameBudgetScheduling(bool requestDefault = false) const;
+    void setFrameBudgetScheduling(bool value);
+
+    /**
+     * \see KisNumaTopology
+     */
+    bool numaAwareScheduling(bool requestDefault = false) const;
+    void setNumaAwareScheduling(bool value);
 
     qreal maxCollectAlpha() const;
     qreal maxMergeAlpha() const;
@@ -46,6 +63,74 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Id of the algorithm used for compressing tiles in the swap file,
+     * see KisTileCompressorFactory::supportedSwapCompressions()
+     */
+    QString swapCompressionAlgorithm(bool requestDefault = false) const;
+    void setSwapCompressionAlgorithm(const QString &value);
+
+    /**
+     * Number of tiles the swapper compresses in parallel and writes
+     * to the swap file in one go. Values less than two disable
+     * batching, which is the default.
+     */
+    int swapOutBatchSize(bool requestDefault = false) const;
+    void setSwapOutBatchSize(int value);
+
+    /**
+     * Map the whole (sparse) swap file of maxSwapSize() at once
+     * instead of remapping windows of swapWindowSize()
+     */
+    bool mapWholeSwapFile(bool requestDefault = false) const;
+    void setMapWholeSwapFile(bool value);
+
+    /**
+     * Size of the RAM tier of the swap in MiB. The swapped out tiles
+     * are kept compressed in memory until the tier is full, and only
+     * the oldest of them are written to the swap file. Zero disables
+     * the tier.
+     */
+    int compressedTilePoolSize(bool requestDefault = false) const; // MiB
+    void setCompressedTilePoolSize(int value);
+
+    bool enableTileDataDeduplication(bool requestDefault = false) const;
+    void setEnableTileDataDeduplication(bool value);
+
+    /**
+     * When enabled, the tiles of the opened files are decompressed
+     * only when they are accessed for the first time, see
+     * KisTileDataStore::lazyTileLoadingEnabled()
+     */
+    bool lazyTileLoading(bool requestDefault = false) const;
+    void setLazyTileLoading(bool value);
+
+    /**
+     * Number of the most recent commits of every paint device whose
+     * undo data is kept uncompressed in memory. The undo data of the
+     * older commits is pushed to the swap right away. Zero means that
+     * the undo data is swapped out by the memory limits only.
+     */
+    int undoSwapOutDepth(bool requestDefault = false) const;
+    void setUndoSwapOutDepth(int value);
+
+    /**
+     * Compare the tiles of every undo revision with their previous
+     * versions on commit and drop the tiles whose pixels have not
+     * changed, e.g. the tiles an eraser has passed over empty areas
+     */
+    bool dropUnchangedUndoTiles(bool requestDefault = false) const;
+    void setDropUnchangedUndoTiles(bool value);
+
+    /**
+     * The number of the most recently activated documents that keep
+     * their optional caches (animation frames, onion skins). The caches
+     * of the other open documents are dropped when Krita becomes idle.
+     * Zero disables the dropping.
+     */
+    int numDocumentsWithCaches(bool requestDefault = false) const;
+    void setNumDocumentsWithCaches(int value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -127,6 +212,14 @@ public:
     bool useOnDiskAnimationCacheSwapping(bool defaultValue = false) const;
     void setUseOnDiskAnimationCacheSwapping(bool value);
 
+    /**
+     * When the animation cache is kept in memory, store the frames as
+     * compressed differences against the neighbouring full frames
+     * instead of the raw texture data.
+     */
+    bool compressInMemoryAnimationCache(bool defaultValue = false) const;
+    void setCompressInMemoryAnimationCache(bool value);
+
     QString animationCacheDir(bool defaultValue = false) const;
     void setAnimationCacheDir(const QString &value);
 
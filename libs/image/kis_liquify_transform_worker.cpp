@@ -32,8 +32,74 @@ struct Q_DECL_HIDDEN KisLiquifyTransformWorker::Private
     int pixelPrecision;
     QSize gridSize;
 
+    /**
+     * The area of the destination (in image coordinates) changed by the
+     * point operations since the last preview was rendered in
+     * runOnQImage(). The preview is re-rendered only in this area.
+     */
+    QRectF dirtyRect;
+    bool allPointsDirty = true;
+
+    struct PreviewCache {
+        QImage image;
+        qint64 srcImageKey = 0;
+        QPointF srcImageOffset;
+        QTransform imageToThumbTransform;
+        QRect dstBounds;
+        QPointF dstImageOffset;
+    };
+    PreviewCache previewCache;
+
     void preparePoints();
 
+    /**
+     * Collects the points changed by a point operation. The cells
+     * around the changed points change their shape, so the dirty area
+     * includes all their points.
+     */
+    struct DirtyPointsTracker {
+        DirtyPointsTracker(Private *_d) : d(_d) {}
+
+        inline void addPoint(int index, const QPointF &oldPoint) {
+            const int col = index % d->gridSize.width();
+            const int row = index / d->gridSize.width();
+
+            minCol = qMin(minCol, col);
+            maxCol = qMax(maxCol, col);
+            minRow = qMin(minRow, row);
+            maxRow = qMax(maxRow, row);
+
+            KisAlgebra2D::accumulateBounds(oldPoint, &oldBounds);
+        }
+
+        ~DirtyPointsTracker() {
+            if (minCol > maxCol) return;
+
+            const int left = qMax(0, minCol - 1);
+            const int right = qMin(d->gridSize.width() - 1, maxCol + 1);
+            const int top = qMax(0, minRow - 1);
+            const int bottom = qMin(d->gridSize.height() - 1, maxRow + 1);
+
+            QRectF bounds = oldBounds;
+
+            for (int row = top; row <= bottom; row++) {
+                const QPointF *pt = d->transformedPoints.constData() + row * d->gridSize.width() + left;
+                for (int col = left; col <= right; col++, pt++) {
+                    KisAlgebra2D::accumulateBounds(*pt, &bounds);
+                }
+            }
+
+            d->dirtyRect |= bounds;
+        }
+
+        Private *d;
+        int minCol = std::numeric_limits<int>::max();
+        int maxCol = -1;
+        int minRow = std::numeric_limits<int>::max();
+        int maxRow = -1;
+        QRectF oldBounds;
+    };
+
     struct MapIndexesOp;
 
     template <class ProcessOp>
@@ -118,6 +184,8 @@ const QVector<QPointF>& KisLiquifyTransformWorker::originalPoints() const
 
 QVector<QPointF>& KisLiquifyTransformWorker::transformedPoints()
 {
+    // the caller may change any point
+    m_d->allPointsDirty = true;
     return m_d->transformedPoints;
 }
 
@@ -174,6 +242,8 @@ void KisLiquifyTransformWorker::translate(const QPointF &offset)
         *it += offset;
         *refIt += offset;
     }
+
+    m_d->allPointsDirty = true;
 }
 
 void KisLiquifyTransformWorker::translateDstSpace(const QPointF &offset)
@@ -184,6 +254,8 @@ void KisLiquifyTransformWorker::translateDstSpace(const QPointF &offset)
     for (; it != end; ++it) {
         *it += offset;
     }
+
+    m_d->allPointsDirty = true;
 }
 
 void KisLiquifyTransformWorker::undoPoints(const QPointF &base,
@@ -202,6 +274,9 @@ void KisLiquifyTransformWorker::undoPoints(const QPointF &base,
     KIS_ASSERT_RECOVER_RETURN(m_d->originalPoints.size() ==
                               m_d->transformedPoints.size());
 
+    QVector<QPointF>::iterator begin = it;
+    Private::DirtyPointsTracker dirtyTracker(m_d.data());
+
     for (; it != end; ++it, ++refIt) {
         if (!clipRect.contains(*it)) continue;
 
@@ -209,6 +284,8 @@ void KisLiquifyTransformWorker::undoPoints(const QPointF &base,
         qreal dist = KisAlgebra2D::norm(diff);
         if (dist > maxDist) continue;
 
+        dirtyTracker.addPoint(it - begin, *it);
+
         qreal lambda = exp(-0.5 * pow2(dist / sigma));
         lambda *= amount;
         *it = *refIt * lambda + *it * (1.0 - lambda);
@@ -227,6 +304,9 @@ processTransformedPixelsBuildUp(ProcessOp op,
 
     QVector<QPointF>::iterator it = transformedPoints.begin();
     QVector<QPointF>::iterator end = transformedPoints.end();
+    QVector<QPointF>::iterator begin = it;
+
+    DirtyPointsTracker dirtyTracker(this);
 
     for (; it != end; ++it) {
         if (!clipRect.contains(*it)) continue;
@@ -235,6 +315,8 @@ processTransformedPixelsBuildUp(ProcessOp op,
         qreal dist = KisAlgebra2D::norm(diff);
         if (dist > maxDist) continue;
 
+        dirtyTracker.addPoint(it - begin, *it);
+
         const qreal lambda = exp(-0.5 * pow2(dist / sigma));
         *it = op(*it, base, diff, lambda);
     }
@@ -258,6 +340,9 @@ processTransformedPixelsWash(ProcessOp op,
     KIS_ASSERT_RECOVER_RETURN(originalPoints.size() ==
                               transformedPoints.size());
 
+    QVector<QPointF>::iterator begin = it;
+    DirtyPointsTracker dirtyTracker(this);
+
     for (; it != end; ++it, ++refIt) {
         if (!clipRect.contains(*it)) continue;
 
@@ -269,6 +354,7 @@ processTransformedPixelsWash(ProcessOp op,
         QPointF dstPt = op(*refIt, base, diff, lambda);
 
         if (kisDistance(dstPt, *refIt) > kisDistance(*it, *refIt)) {
+            dirtyTracker.addPoint(it - begin, *it);
             *it = (1.0 - flow) * (*it) + flow * dstPt;
         }
     }
@@ -397,6 +483,10 @@ void KisLiquifyTransformWorker::run(KisPaintDeviceSP srcDevice, KisPaintDeviceSP
 
     using namespace GridIterationTools;
 
+    /**
+     * The worker is run from inside a stroke job, so the grid is
+     * resampled serially in the calling thread
+     */
     PaintDevicePolygonOp polygonOp(srcDevice, dstDevice);
     RegularGridIndexesOp indexesOp(m_d->gridSize);
     iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
@@ -445,6 +535,8 @@ void KisLiquifyTransformWorker::transformSrcAndDst(const QTransform &t)
     for (auto it = m_d->transformedPoints.begin(); it != m_d->transformedPoints.end(); ++it) {
         *it = t.map(*it);
     }
+
+    m_d->allPointsDirty = true;
 }
 
 #include <functional>
@@ -501,16 +593,71 @@ QImage KisLiquifyTransformWorker::runOnQImage(const QImage &srcImage,
 
     QRect dstBoundsI = dstBounds.toAlignedRect();
 
-    QImage dstImage(dstBoundsI.size(), srcImage.format());
-    dstImage.fill(0);
+    Private::PreviewCache &cache = m_d->previewCache;
+
+    /**
+     * While the user paints with the liquify brush every dab changes
+     * only a small part of the grid, so, when the preview parameters
+     * stay the same, only the area around the changed points is
+     * re-rendered. The cells are visited in the usual order, so the
+     * pixels of the area get exactly the same values as after the full
+     * rendering.
+     */
+    const bool canUpdatePartially =
+        !m_d->allPointsDirty &&
+        !cache.image.isNull() &&
+        cache.srcImageKey == srcImage.cacheKey() &&
+        cache.srcImageOffset == srcImageOffset &&
+        cache.imageToThumbTransform == imageToThumbTransform &&
+        cache.dstBounds == dstBoundsI &&
+        cache.dstImageOffset == dstQImageOffset;
+
+    QImage dstImage;
+    QRect clipRect;
+
+    if (canUpdatePartially) {
+        if (m_d->dirtyRect.isEmpty()) {
+            return cache.image;
+        }
+
+        dstImage = cache.image;
+        clipRect = kisGrowRect(imageToThumbTransform.mapRect(m_d->dirtyRect).toAlignedRect(), 2);
+
+        const QPoint clearTopLeft = (QPointF(clipRect.topLeft()) - dstQImageOffset).toPoint();
+        const QPoint clearBottomRight = (QPointF(clipRect.bottomRight()) - dstQImageOffset).toPoint();
+        const QRect clearRect = QRect(clearTopLeft, clearBottomRight) & dstImage.rect();
+
+        for (int y = clearRect.top(); y <= clearRect.bottom(); y++) {
+            QRgb *line = reinterpret_cast<QRgb*>(dstImage.scanLine(y));
+            std::fill(line + clearRect.left(), line + clearRect.left() + clearRect.width(), 0);
+        }
+    } else {
+        dstImage = QImage(dstBoundsI.size(), srcImage.format());
+        dstImage.fill(0);
+    }
 
     GridIterationTools::QImagePolygonOp polygonOp(srcImage, dstImage, srcImageOffset, dstQImageOffset);
+    if (!clipRect.isEmpty()) {
+        polygonOp.setClipRect(clipRect);
+    }
+
     GridIterationTools::RegularGridIndexesOp indexesOp(m_d->gridSize);
     GridIterationTools::iterateThroughGrid
         <GridIterationTools::AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
                                                           m_d->gridSize,
                                                           originalPointsLocal,
                                                           transformedPointsLocal);
+
+    cache.image = dstImage;
+    cache.srcImageKey = srcImage.cacheKey();
+    cache.srcImageOffset = srcImageOffset;
+    cache.imageToThumbTransform = imageToThumbTransform;
+    cache.dstBounds = dstBoundsI;
+    cache.dstImageOffset = dstQImageOffset;
+
+    m_d->dirtyRect = QRectF();
+    m_d->allPointsDirty = false;
+
     return dstImage;
 }
 
@@ -8,6 +8,9 @@
 
 #include <QGlobalStatic>
 #include <QApplication>
+#include <QAtomicInteger>
+
+#include <algorithm>
 
 #include "kis_image.h"
 #include "kis_image_config.h"
@@ -25,6 +28,7 @@ struct Q_DECL_HIDDEN KisMemoryStatisticsServer::Private
     }
 
     KisSignalCompressor updateCompressor;
+    QAtomicInteger<qint64> frameCacheSize {0};
 };
 
 
@@ -53,9 +57,7 @@ inline void addDevice(KisPaintDeviceSP dev,
                       bool isProjection,
                       QSet<KisPaintDevice*> &devices,
                       qint64 &memBound,
-                      qint64 &layersSize,
-                      qint64 &projectionsSize,
-                      qint64 &lodSize)
+                      KisMemoryStatisticsServer::NodeStatistics &nodeStats)
 {
     if (dev && !devices.contains(dev.data())) {
         devices.insert(dev.data());
@@ -70,20 +72,18 @@ inline void addDevice(KisPaintDeviceSP dev,
         KIS_SAFE_ASSERT_RECOVER_NOOP(!temporaryData || isProjection);
 
         if (!isProjection) {
-            layersSize += imageData + temporaryData;
+            nodeStats.layerSize += imageData + temporaryData;
         } else {
-            projectionsSize += imageData + temporaryData;
+            nodeStats.projectionSize += imageData + temporaryData;
         }
 
-        lodSize += lodData;
+        nodeStats.lodSize += lodData;
     }
 }
 
 qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
                                       QSet<KisPaintDevice*> &devices,
-                                      qint64 &layersSize,
-                                      qint64 &projectionsSize,
-                                      qint64 &lodSize)
+                                      QVector<KisMemoryStatisticsServer::NodeStatistics> &nodes)
 {
     qint64 memBound = 0;
 
@@ -91,15 +91,21 @@ qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
             node->inherits("KisGroupLayer") ||
             node->inherits("KisAdjustmentLayer");
 
+    KisMemoryStatisticsServer::NodeStatistics nodeStats;
+    nodeStats.name = node->name();
+    nodeStats.uuid = node->uuid();
+
+    addDevice(node->paintDevice(), false, devices, memBound, nodeStats);
+    addDevice(node->original(), originalIsProjection, devices, memBound, nodeStats);
+    addDevice(node->projection(), true, devices, memBound, nodeStats);
 
-    addDevice(node->paintDevice(), false, devices, memBound, layersSize, projectionsSize, lodSize);
-    addDevice(node->original(), originalIsProjection, devices, memBound, layersSize, projectionsSize, lodSize);
-    addDevice(node->projection(), true, devices, memBound, layersSize, projectionsSize, lodSize);
+    if (nodeStats.totalSize() > 0) {
+        nodes.append(nodeStats);
+    }
 
     node = node->firstChild();
     while (node) {
-        memBound += calculateNodeMemoryHiBoundStep(node, devices,
-                                                   layersSize, projectionsSize, lodSize);
+        memBound += calculateNodeMemoryHiBoundStep(node, devices, nodes);
         node = node->nextSibling();
     }
 
@@ -109,18 +115,31 @@ qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
 qint64 calculateNodeMemoryHiBound(KisNodeSP node,
                                   qint64 &layersSize,
                                   qint64 &projectionsSize,
-                                  qint64 &lodSize)
+                                  qint64 &lodSize,
+                                  QVector<KisMemoryStatisticsServer::NodeStatistics> &nodes)
 {
     layersSize = 0;
     projectionsSize = 0;
     lodSize = 0;
+    nodes.clear();
 
     QSet<KisPaintDevice*> devices;
-    return calculateNodeMemoryHiBoundStep(node,
-                                          devices,
-                                          layersSize,
-                                          projectionsSize,
-                                          lodSize);
+    const qint64 memBound =
+        calculateNodeMemoryHiBoundStep(node, devices, nodes);
+
+    Q_FOREACH (const KisMemoryStatisticsServer::NodeStatistics &nodeStats, nodes) {
+        layersSize += nodeStats.layerSize;
+        projectionsSize += nodeStats.projectionSize;
+        lodSize += nodeStats.lodSize;
+    }
+
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [] (const KisMemoryStatisticsServer::NodeStatistics &lhs,
+                         const KisMemoryStatisticsServer::NodeStatistics &rhs) {
+                         return lhs.totalSize() > rhs.totalSize();
+                     });
+
+    return memBound;
 }
 
 
@@ -136,7 +155,8 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
             calculateNodeMemoryHiBound(image->root(),
                                        stats.layersSize,
                                        stats.projectionsSize,
-                                       stats.lodSize);
+                                       stats.lodSize,
+                                       stats.nodes);
     }
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
@@ -144,6 +164,9 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.compressedPoolSize = tileStats.compressedPoolSize;
+
+    stats.frameCacheSize = m_d->frameCacheSize.loadAcquire();
 
     KisImageConfig cfg(true);
 
@@ -155,6 +178,11 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     return stats;
 }
 
+void KisMemoryStatisticsServer::addFrameCacheMemoryUsage(qint64 delta)
+{
+    m_d->frameCacheSize.fetchAndAddOrdered(delta);
+}
+
 void KisMemoryStatisticsServer::tryForceUpdateMemoryStatisticsWhileIdle()
 {
     KisTileDataStore::instance()->tryForceUpdateMemoryStatisticsWhileIdle();
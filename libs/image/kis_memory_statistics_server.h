@@ -10,6 +10,9 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QScopedPointer>
+#include <QVector>
+#include <QString>
+#include <QUuid>
 
 #include "kritaimage_export.h"
 #include "kis_types.h"
@@ -19,6 +22,25 @@ class KRITAIMAGE_EXPORT KisMemoryStatisticsServer : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * Memory consumed by the paint devices of a single node. The
+     * devices shared with other nodes are accounted only once, for
+     * the first node that has them.
+     */
+    struct NodeStatistics
+    {
+        QString name;
+        QUuid uuid;
+
+        qint64 layerSize = 0;
+        qint64 projectionSize = 0;
+        qint64 lodSize = 0;
+
+        qint64 totalSize() const {
+            return layerSize + projectionSize + lodSize;
+        }
+    };
+
     struct Statistics
     {
         Statistics()
@@ -33,6 +55,9 @@ public:
               poolSize(0),
 
               swapSize(0),
+              compressedPoolSize(0),
+
+              frameCacheSize(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -52,11 +77,20 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 compressedPoolSize;
+
+        qint64 frameCacheSize;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
         qint64 tilesPoolLimit;
+
+        /**
+         * Per-node breakdown of imageSize, sorted by the total size
+         * of the node in descending order
+         */
+        QVector<NodeStatistics> nodes;
     };
 
 
@@ -68,6 +102,13 @@ public:
 
     Statistics fetchMemoryStatistics(KisImageSP image) const;
 
+    /**
+     * The animation frame cache lives outside the tiles engine, so
+     * it reports the change of its RAM usage (in bytes) itself.
+     * The call is thread-safe.
+     */
+    void addFrameCacheMemoryUsage(qint64 delta);
+
 public Q_SLOTS:
     void notifyImageChanged();
     void tryForceUpdateMemoryStatisticsWhileIdle();
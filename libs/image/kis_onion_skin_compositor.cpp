@@ -14,11 +14,14 @@
 #include "KoColorSpaceConstants.h"
 #include "kis_image_config.h"
 #include "kis_raster_keyframe_channel.h"
+#include "kis_paint_device_frames_interface.h"
 
 Q_GLOBAL_STATIC(KisOnionSkinCompositor, s_instance)
 
 struct KisOnionSkinCompositor::Private
 {
+    using TintedFrame = KisOnionSkinCompositor::TintedFramesCache::Frame;
+
     int numberOfSkins = 0;
     int tintFactor = 0;
     QColor backwardTintColor;
@@ -60,16 +63,61 @@ struct KisOnionSkinCompositor::Private
         return channel->keyframeAt<KisRasterKeyframe>(outFrame);
     }
 
-    void tryCompositeFrame(KisRasterKeyframeSP keyframe, KisPainter &gcFrame, KisPainter &gcDest, KisPaintDeviceSP tintSource, int opacity, const QRect &rect)
+    KisPaintDeviceSP tintFrame(KisRasterKeyframeSP keyframe, KisPaintDeviceSP tintSource,
+                               const QBitArray &channelFlags, const QRect &rect, bool *isCacheable)
+    {
+        KisPaintDeviceSP frameDevice = new KisPaintDevice(tintSource->colorSpace());
+        keyframe->writeFrameToDevice(frameDevice);
+
+        /**
+         * The tint doesn't touch the alpha channel, so for a frame with
+         * transparent default pixel it is enough to tint its extent. Such
+         * a frame doesn't depend on the composited rect and can be reused.
+         */
+        *isCacheable = frameDevice->defaultPixel().opacityU8() == OPACITY_TRANSPARENT_U8;
+        const QRect tintRect = *isCacheable ? frameDevice->extent() : rect;
+
+        KisPainter gcFrame(frameDevice);
+        gcFrame.setChannelFlags(channelFlags);
+        gcFrame.setOpacityU8(tintFactor);
+        gcFrame.bitBlt(tintRect.topLeft(), tintSource, tintRect);
+
+        return frameDevice;
+    }
+
+    void tryCompositeFrame(KisRasterKeyframeSP keyframe, KisPainter &gcDest, KisPaintDeviceSP tintSource,
+                           const QBitArray &channelFlags, int opacity, const QRect &rect,
+                           bool isForwardSkin, const KisPaintDeviceSP sourceDevice,
+                           KisOnionSkinCompositor::TintedFramesCache *cache,
+                           QHash<QPair<int, bool>, TintedFrame> *usedFrames)
     {
         if (keyframe.isNull() || opacity == OPACITY_TRANSPARENT_U8) return;
 
-        keyframe->writeFrameToDevice(gcFrame.device());
+        const QPair<int, bool> key(keyframe->frameID(), isForwardSkin);
+        const int sequenceNumber = sourceDevice->framesInterface()->frameSequenceNumber(keyframe->frameID());
+
+        KisPaintDeviceSP tintedFrame;
+
+        if (cache) {
+            const TintedFrame frame = usedFrames->value(key, cache->frames.value(key));
+
+            if (frame.device && frame.sequenceNumber == sequenceNumber) {
+                tintedFrame = frame.device;
+                usedFrames->insert(key, frame);
+            }
+        }
 
-        gcFrame.bitBlt(rect.topLeft(), tintSource, rect);
+        if (!tintedFrame) {
+            bool isCacheable = false;
+            tintedFrame = tintFrame(keyframe, tintSource, channelFlags, rect, &isCacheable);
+
+            if (cache && isCacheable) {
+                usedFrames->insert(key, TintedFrame{tintedFrame, sequenceNumber});
+            }
+        }
 
         gcDest.setOpacityU8(opacity);
-        gcDest.bitBlt(rect.topLeft(), gcFrame.device(), rect);
+        gcDest.bitBlt(rect.topLeft(), tintedFrame, rect);
     }
 
     void refreshConfig()
@@ -133,15 +181,12 @@ QSet<int> KisOnionSkinCompositor::colorLabelFilter()
     return m_d->colorLabelFilter;
 }
 
-void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect)
+void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect,
+                                       TintedFramesCache *tintedFrames)
 {
     KisRasterKeyframeChannel *keyframes = sourceDevice->keyframeChannel();
 
-    KisPaintDeviceSP frameDevice = new KisPaintDevice(sourceDevice->colorSpace());
-    KisPainter gcFrame(frameDevice);
     QBitArray channelFlags = sourceDevice->colorSpace()->channelFlags(true, false);
-    gcFrame.setChannelFlags(channelFlags);
-    gcFrame.setOpacityU8(m_d->tintFactor);
 
     KisPaintDeviceSP backwardTintDevice = m_d->setUpTintDevice(m_d->backwardTintColor, sourceDevice->colorSpace());
     KisPaintDeviceSP forwardTintDevice = m_d->setUpTintDevice(m_d->forwardTintColor, sourceDevice->colorSpace());
@@ -158,6 +203,18 @@ void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisP
         return;
     }
 
+    if (tintedFrames &&
+        (tintedFrames->configSeqNo != m_d->configSeqNo ||
+         !tintedFrames->colorSpace ||
+         *tintedFrames->colorSpace != *sourceDevice->colorSpace())) {
+
+        tintedFrames->frames.clear();
+        tintedFrames->configSeqNo = m_d->configSeqNo;
+        tintedFrames->colorSpace = sourceDevice->colorSpace();
+    }
+
+    QHash<QPair<int, bool>, Private::TintedFrame> usedFrames;
+
     keyframeTimeBck = keyframeTimeFwd = keyframes->activeKeyframeTime(time);
 
     for (int offset = 1; offset <= m_d->numberOfSkins; offset++) {
@@ -165,14 +222,21 @@ void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisP
         KisRasterKeyframeSP forwardKeyframe = m_d->getNextFrameToComposite(keyframes, keyframeTimeFwd, false);
 
         if (!backKeyframe.isNull()) {
-            m_d->tryCompositeFrame(backKeyframe, gcFrame, gcDest, backwardTintDevice, m_d->skinOpacity(-offset), rect);
+            m_d->tryCompositeFrame(backKeyframe, gcDest, backwardTintDevice, channelFlags,
+                                   m_d->skinOpacity(-offset), rect, false,
+                                   sourceDevice, tintedFrames, &usedFrames);
         }
 
         if (!forwardKeyframe.isNull()) {
-            m_d->tryCompositeFrame(forwardKeyframe, gcFrame, gcDest, forwardTintDevice, m_d->skinOpacity(offset), rect);
+            m_d->tryCompositeFrame(forwardKeyframe, gcDest, forwardTintDevice, channelFlags,
+                                   m_d->skinOpacity(offset), rect, true,
+                                   sourceDevice, tintedFrames, &usedFrames);
         }
     }
 
+    if (tintedFrames) {
+        tintedFrames->frames = usedFrames;
+    }
 }
 
 QRect KisOnionSkinCompositor::calculateFullExtent(const KisPaintDeviceSP device)
@@ -11,6 +11,10 @@
 #include "kritaimage_export.h"
 
 #include <QObject>
+#include <QHash>
+#include <QPair>
+
+class KoColorSpace;
 
 class KRITAIMAGE_EXPORT KisOnionSkinCompositor : public QObject
 {
@@ -21,7 +25,27 @@ public:
     ~KisOnionSkinCompositor() override;
     static KisOnionSkinCompositor *instance();
 
-    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect);
+    /**
+     * The tinted copies of the onion skin frames of one paint device.
+     * When passed to composite(), the frames are reused between the calls,
+     * so moving the playhead tints only the frames entering the onion
+     * skins. The frames that are not shown anymore are dropped.
+     */
+    struct TintedFramesCache
+    {
+        struct Frame {
+            KisPaintDeviceSP device;
+            int sequenceNumber = 0;
+        };
+
+        // the key is (frameID, isForwardSkin)
+        QHash<QPair<int, bool>, Frame> frames;
+        const KoColorSpace *colorSpace = nullptr;
+        int configSeqNo = -1;
+    };
+
+    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect,
+                   TintedFramesCache *tintedFrames = nullptr);
 
     QRect calculateFullExtent(const KisPaintDeviceSP device);
     QRect calculateExtent(const KisPaintDeviceSP device, int time);
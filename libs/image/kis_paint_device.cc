@@ -12,10 +12,13 @@
 #include <QImage>
 #include <QList>
 #include <QHash>
+#include <QMap>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QIODevice>
 #include <qmath.h>
+#include <limits>
+#include <optional>
 #include <KisRegion.h>
 
 #include <klocalizedstring.h>
@@ -58,12 +61,17 @@
 #include "kis_transform_worker.h"
 #include "kis_filter_strategy.h"
 #include "krita_utils.h"
+#include "kis_algebra_2d.h"
 #include <KisStaticInitializer.h>
 
 KIS_DECLARE_STATIC_INITIALIZER {
     qRegisterMetaType<KisPaintDeviceSP>("KisPaintDeviceSP");
 }
 
+namespace {
+QAtomicInt s_incrementalLodSyncEnabled(1);
+}
+
 struct KisPaintDevice::Private
 {
     /**
@@ -155,6 +163,7 @@ public:
     {
 
         m_lodData.reset();
+        m_lodSyncState.reset();
         m_externalFrameData.reset();
 
         if (!m_frames.isEmpty()) {
@@ -226,6 +235,12 @@ public:
         return data->cache()->invalidate();
     }
 
+    int frameSequenceNumber(int frameId) const
+    {
+        DataSP data = m_frames[frameId];
+        return data->cache()->sequenceNumber();
+    }
+
 private:
     typedef KisPaintDeviceData Data;
     typedef QSharedPointer<Data> DataSP;
@@ -388,12 +403,37 @@ public:
         return retval;
     }
 
+    bool readFrame(QIODevice *stream, int frameId, int baseFrameId)
+    {
+        DataSP data = m_frames[frameId];
+        DataSP baseData = m_frames[baseFrameId];
+
+        bool retval = data->dataManager()->read(stream);
+        data->dataManager()->addMissingTiles(baseData->dataManager().data());
+        data->cache()->invalidate();
+        return retval;
+    }
+
     bool writeFrame(KisPaintDeviceWriter &store, int frameId)
     {
         DataSP data = m_frames[frameId];
         return data->dataManager()->write(store);
     }
 
+    bool writeFrame(KisPaintDeviceWriter &store, int frameId, int baseFrameId)
+    {
+        DataSP data = m_frames[frameId];
+        DataSP baseData = m_frames[baseFrameId];
+        return data->dataManager()->writeDelta(store, baseData->dataManager().data());
+    }
+
+    int numSharedFrameTiles(int frameId, int otherFrameId)
+    {
+        DataSP data = m_frames[frameId];
+        DataSP otherData = m_frames[otherFrameId];
+        return data->dataManager()->numSharedTiles(otherData->dataManager().data());
+    }
+
     void setFrameDefaultPixel(const KoColor &defPixel, int frameId)
     {
         DataSP data = m_frames[frameId];
@@ -420,6 +460,8 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
     KisRegion regionForLodSyncing() const;
+    bool canSyncLodIncrementally(int lod) const;
+    void purgeLodSyncState();
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
@@ -595,6 +637,32 @@ private:
     DataSP m_data;
     mutable QScopedPointer<Data> m_lodData;
     mutable QScopedPointer<Data> m_externalFrameData;
+
+    /**
+     * The state of the device at the moment of the last LoD
+     * synchronization. Comparing the revisions of the tiles of the
+     * lod0 and lodN data managers against the live ones gives the
+     * region that has changed since then, without tracking every
+     * write to the device.
+     *
+     * The data managers are only compared as pointers and never
+     * dereferenced, so the state doesn't keep them alive. Even if
+     * another data manager gets the same address, the revisions
+     * still describe the content of its tiles correctly.
+     */
+    struct LodSyncState {
+        int levelOfDetail = 0;
+        int srcX = 0;
+        int srcY = 0;
+        const KoColorSpace *colorSpace = 0;
+        const KisDataManager *srcDataManager = 0;
+        QByteArray srcDefaultPixel;
+        KisDataManager::TileRevisions srcRevisions;
+        const KisDataManager *lodDataManager = 0;
+        QByteArray lodDefaultPixel;
+        KisDataManager::TileRevisions lodRevisions;
+    };
+    QScopedPointer<LodSyncState> m_lodSyncState;
     mutable QMutex m_dataSwitchLock;
 
     FramesHash m_frames;
@@ -675,14 +743,73 @@ struct KisPaintDevice::Private::StrategyPolicy {
 };
 
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
-    LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
+    LodDataStructImpl(Data *_lodData, std::optional<KisDataManager::TileRevisions> &&_srcRevisions)
+        : lodData(_lodData), srcRevisions(std::move(_srcRevisions)) {}
     QScopedPointer<Data> lodData;
+    std::optional<KisDataManager::TileRevisions> srcRevisions;
 };
 
+bool KisPaintDevice::Private::canSyncLodIncrementally(int lod) const
+{
+    if (!s_incrementalLodSyncEnabled.loadRelaxed() ||
+        !m_lodSyncState || !m_lodData || lod <= 0) return false;
+
+    const LodSyncState &state = *m_lodSyncState;
+    Data *srcData = currentNonLodData();
+
+    auto sameDefaultPixel = [] (KisDataManagerSP dm, const QByteArray &pixel) {
+        return int(dm->pixelSize()) == pixel.size() &&
+            !memcmp(dm->defaultPixel(), pixel.constData(), pixel.size());
+    };
+
+    /**
+     * Any change that is not a change of tiles (switching frames or
+     * color spaces, moving the device, changing the default pixel or
+     * the level of detail itself) requires a full resync.
+     */
+    return state.levelOfDetail == lod &&
+        m_lodData->levelOfDetail() == lod &&
+        state.srcDataManager == srcData->dataManager().data() &&
+        state.lodDataManager == m_lodData->dataManager().data() &&
+        state.colorSpace == srcData->colorSpace() &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        state.srcX == srcData->x() &&
+        state.srcY == srcData->y() &&
+        m_lodData->x() == KisLodTransform::coordToLodCoord(srcData->x(), lod) &&
+        m_lodData->y() == KisLodTransform::coordToLodCoord(srcData->y(), lod) &&
+        sameDefaultPixel(srcData->dataManager(), state.srcDefaultPixel) &&
+        sameDefaultPixel(m_lodData->dataManager(), state.lodDefaultPixel);
+}
+
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
 {
     Data *srcData = currentNonLodData();
-    return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
+
+    const int lod = defaultBounds->currentLevelOfDetail();
+    if (!canSyncLodIncrementally(lod)) {
+        return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
+    }
+
+    /**
+     * The lodN plane should be regenerated in the areas changed on
+     * lod0 since the last sync, and in the areas where lodN strokes
+     * have painted their (approximate) preview.
+     */
+    const LodSyncState &state = *m_lodSyncState;
+
+    QVector<QRect> rects =
+        srcData->dataManager()->changedRegion(state.srcRevisions)
+            .translated(srcData->x(), srcData->y()).rects();
+
+    const KisRegion lodRegion =
+        m_lodData->dataManager()->changedRegion(state.lodRevisions)
+            .translated(m_lodData->x(), m_lodData->y());
+
+    Q_FOREACH (const QRect &rc, lodRegion.rects()) {
+        rects << KisLodTransform::upscaledRect(rc, lod);
+    }
+
+    return KisRegion::fromOverlappingRects(rects, KisTileData::WIDTH);
 }
 
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
@@ -691,8 +818,24 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
 
     Data *srcData = currentNonLodData();
 
+    std::optional<KisDataManager::TileRevisions> srcRevisions;
+    if (s_incrementalLodSyncEnabled.loadRelaxed()) {
+        srcRevisions = srcData->dataManager()->tileRevisions();
+    }
+
+    if (canSyncLodIncrementally(newLod)) {
+        /**
+         * The unchanged parts of the current lodN plane are still
+         * valid, so just share its tiles and let the sync rewrite
+         * the region returned by regionForLodSyncing()
+         */
+        Data *lodData = new Data(q, m_lodData.data(), true);
+        lodData->cache()->invalidate();
+        return new LodDataStructImpl(lodData, std::move(srcRevisions));
+    }
+
     Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
+    LodDataStruct *lodStruct = new LodDataStructImpl(lodData, std::move(srcRevisions));
 
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
@@ -844,6 +987,37 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    if (!dst->srcRevisions) {
+        m_lodSyncState.reset();
+        return;
+    }
+
+    Data *srcData = currentNonLodData();
+
+    auto defaultPixel = [] (KisDataManagerSP dm) {
+        return QByteArray(reinterpret_cast<const char*>(dm->defaultPixel()), dm->pixelSize());
+    };
+
+    if (!m_lodSyncState) {
+        m_lodSyncState.reset(new LodSyncState());
+    }
+
+    m_lodSyncState->levelOfDetail = m_lodData->levelOfDetail();
+    m_lodSyncState->srcX = srcData->x();
+    m_lodSyncState->srcY = srcData->y();
+    m_lodSyncState->colorSpace = srcData->colorSpace();
+    m_lodSyncState->srcDataManager = srcData->dataManager().data();
+    m_lodSyncState->srcDefaultPixel = defaultPixel(srcData->dataManager());
+    m_lodSyncState->srcRevisions = std::move(*dst->srcRevisions);
+    m_lodSyncState->lodDataManager = m_lodData->dataManager().data();
+    m_lodSyncState->lodDefaultPixel = defaultPixel(m_lodData->dataManager());
+    m_lodSyncState->lodRevisions = m_lodData->dataManager()->tileRevisions();
+}
+
+void KisPaintDevice::Private::purgeLodSyncState()
+{
+    m_lodSyncState.reset();
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -1430,6 +1604,186 @@ QRect calculateExactBoundsImpl(const KisPaintDevice *device, const QRect &startR
                  boundBottom - boundTop + 1);
 }
 
+
+/**
+ * Scans the pixels of a rect lying within a single tile of the device.
+ * Every row of such a rect is contiguous in memory, so the accessor is
+ * moved only once per row.
+ *
+ * All the find*() methods update the passed bound only if they find a
+ * non-empty pixel beyond it, and they never scan the pixels that cannot
+ * extend the bound any more.
+ */
+template <class ComparePixelOp>
+struct TileBoundsScanner
+{
+    TileBoundsScanner(const KisPaintDevice *device, ComparePixelOp compareOp)
+        : m_accessor(device->createRandomConstAccessorNG()),
+          m_pixelSize(device->pixelSize()),
+          m_compareOp(compareOp)
+    {
+    }
+
+    void findTop(const QRect &rc, int *top) {
+        const int bottom = qMin(rc.bottom(), *top - 1);
+
+        for (int y = rc.top(); y <= bottom; y++) {
+            if (findFirstInRow(rc.left(), rc.right(), y) <= rc.right()) {
+                *top = y;
+                break;
+            }
+        }
+    }
+
+    void findBottom(const QRect &rc, int *bottom) {
+        const int top = qMax(rc.top(), *bottom + 1);
+
+        for (int y = rc.bottom(); y >= top; y--) {
+            if (findFirstInRow(rc.left(), rc.right(), y) <= rc.right()) {
+                *bottom = y;
+                break;
+            }
+        }
+    }
+
+    void findLeft(const QRect &rc, int *left) {
+        for (int y = rc.top(); y <= rc.bottom(); y++) {
+            const int right = qMin(rc.right(), *left - 1);
+            if (right < rc.left()) break;
+
+            const int x = findFirstInRow(rc.left(), right, y);
+            if (x <= right) {
+                *left = x;
+            }
+        }
+    }
+
+    void findRight(const QRect &rc, int *right) {
+        for (int y = rc.top(); y <= rc.bottom(); y++) {
+            const int left = qMax(rc.left(), *right + 1);
+            if (left > rc.right()) break;
+
+            const int x = findLastInRow(left, rc.right(), y);
+            if (x >= left) {
+                *right = x;
+            }
+        }
+    }
+
+private:
+    int findFirstInRow(int left, int right, int y) {
+        m_accessor->moveTo(left, y);
+        const quint8 *ptr = m_accessor->rawDataConst();
+
+        int x = left;
+        for (; x <= right; x++, ptr += m_pixelSize) {
+            if (!m_compareOp.isPixelEmpty(ptr)) break;
+        }
+        return x;
+    }
+
+    int findLastInRow(int left, int right, int y) {
+        m_accessor->moveTo(left, y);
+        const quint8 *ptr = m_accessor->rawDataConst() + (right - left) * m_pixelSize;
+
+        int x = right;
+        for (; x >= left; x--, ptr -= m_pixelSize) {
+            if (!m_compareOp.isPixelEmpty(ptr)) break;
+        }
+        return x;
+    }
+
+private:
+    KisRandomConstAccessorSP m_accessor;
+    const int m_pixelSize;
+    ComparePixelOp m_compareOp;
+};
+
+/**
+ * Calculates the exact bounds of the allocated tiles of the device. The
+ * pixels of the unallocated tiles are always default, so they are never
+ * scanned, which makes the calculation fast for large sparse devices.
+ * The tile rows are scanned from both sides until the first non-empty
+ * pixel is found, then the same is done for the tile columns within
+ * the found vertical range.
+ *
+ * Should be used only when the default pixel is considered empty by
+ * \p compareOp.
+ */
+template <class ComparePixelOp>
+QRect calculateExactBoundsTileBased(const KisPaintDevice *device, const QRect &startRect, ComparePixelOp compareOp)
+{
+    if (!startRect.isValid()) return QRect();
+
+    const int tileSize = KisTileData::WIDTH;
+    const QPoint origin(device->x(), device->y());
+
+    QMap<int, QVector<QRect>> tileRows;
+    QMap<int, QVector<QRect>> tileColumns;
+
+    Q_FOREACH (const QRect &rc, device->region().rects()) {
+        const QRect clippedRect = rc & startRect;
+        if (clippedRect.isEmpty()) continue;
+
+        const QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatches(clippedRect.translated(-origin), QSize(tileSize, tileSize));
+
+        Q_FOREACH (const QRect &patch, patches) {
+            const QRect tileRect = patch.translated(origin);
+            tileRows[KisAlgebra2D::divideFloor(patch.y(), tileSize)].append(tileRect);
+            tileColumns[KisAlgebra2D::divideFloor(patch.x(), tileSize)].append(tileRect);
+        }
+    }
+
+    TileBoundsScanner<ComparePixelOp> scanner(device, compareOp);
+
+    int top = std::numeric_limits<int>::max();
+    for (auto it = tileRows.constBegin(); it != tileRows.constEnd(); ++it) {
+        Q_FOREACH (const QRect &rc, it.value()) {
+            scanner.findTop(rc, &top);
+        }
+        if (top != std::numeric_limits<int>::max()) break;
+    }
+
+    // no non-empty pixels at all
+    if (top == std::numeric_limits<int>::max()) return QRect();
+
+    int bottom = std::numeric_limits<int>::min();
+    for (auto it = tileRows.constEnd(); it != tileRows.constBegin();) {
+        --it;
+        Q_FOREACH (const QRect &rc, it.value()) {
+            scanner.findBottom(rc, &bottom);
+        }
+        if (bottom != std::numeric_limits<int>::min()) break;
+    }
+
+    const QRect verticalRange(startRect.left(), top, startRect.width(), bottom - top + 1);
+
+    int left = std::numeric_limits<int>::max();
+    for (auto it = tileColumns.constBegin(); it != tileColumns.constEnd(); ++it) {
+        Q_FOREACH (const QRect &rc, it.value()) {
+            const QRect scanRect = rc & verticalRange;
+            if (!scanRect.isEmpty()) {
+                scanner.findLeft(scanRect, &left);
+            }
+        }
+        if (left != std::numeric_limits<int>::max()) break;
+    }
+
+    int right = std::numeric_limits<int>::min();
+    for (auto it = tileColumns.constEnd(); it != tileColumns.constBegin();) {
+        --it;
+        Q_FOREACH (const QRect &rc, it.value()) {
+            const QRect scanRect = rc & verticalRange;
+            if (!scanRect.isEmpty()) {
+                scanner.findRight(scanRect, &right);
+            }
+        }
+        if (right != std::numeric_limits<int>::min()) break;
+    }
+
+    return QRect(left, top, right - left + 1, bottom - top + 1);
+}
 }
 
 QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
@@ -1453,13 +1807,19 @@ QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
         }
     }
 
+    /**
+     * When the whole rect should be checked, the unallocated tiles can
+     * be skipped, since their pixels are default by definition
+     */
     if (nonDefaultOnly) {
         const KoColor defaultPixel = this->defaultPixel();
         Impl::CheckNonDefault compareOp(pixelSize(), defaultPixel.data());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = endRect.isEmpty() ?
+            Impl::calculateExactBoundsTileBased(this, startRect, compareOp) :
+            Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
     } else {
         Impl::CheckFullyTransparent compareOp(m_d->colorSpace());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = Impl::calculateExactBoundsTileBased(this, startRect, compareOp);
     }
 
     return endRect;
@@ -1974,6 +2334,30 @@ void KisPaintDevice::fastBitBlt(KisPaintDeviceSP src, const QRect &rect)
     m_d->currentStrategy()->fastBitBlt(src, rect);
 }
 
+bool KisPaintDevice::fastBitBltPossible(KisPaintDeviceSP src, const QPoint &offset)
+{
+    const QPoint dataOffset = offset + QPoint(src->x() - x(), src->y() - y());
+
+    return *colorSpace() == *src->colorSpace() &&
+        !defaultBounds()->wrapAroundMode() &&
+        !src->defaultBounds()->wrapAroundMode() &&
+        dataOffset.x() % KisTileData::WIDTH == 0 &&
+        dataOffset.y() % KisTileData::HEIGHT == 0;
+}
+
+void KisPaintDevice::fastBitBlt(KisPaintDeviceSP src, const QRect &srcRect, const QPoint &offset)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(fastBitBltPossible(src, offset));
+
+    const QPoint dataOffset = offset + QPoint(src->x() - x(), src->y() - y());
+
+    m_d->dataManager()->bitBlt(src->dataManager(),
+                               srcRect.translated(-src->x(), -src->y()),
+                               QPoint(dataOffset.x() / KisTileData::WIDTH,
+                                      dataOffset.y() / KisTileData::HEIGHT));
+    m_d->cache()->invalidate();
+}
+
 void KisPaintDevice::fastBitBltOldData(KisPaintDeviceSP src, const QRect &rect)
 {
     m_d->currentStrategy()->fastBitBltOldData(src, rect);
@@ -2165,6 +2549,16 @@ void KisPaintDevice::uploadLodDataStruct(LodDataStruct *dst)
     m_d->uploadLodDataStruct(dst);
 }
 
+void KisPaintDevice::purgeLodSyncState()
+{
+    m_d->purgeLodSyncState();
+}
+
+void KisPaintDevice::setIncrementalLodSyncEnabled(bool value)
+{
+    s_incrementalLodSyncEnabled.storeRelaxed(value);
+}
+
 void KisPaintDevice::generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod)
 {
     m_d->generateLodCloneDevice(dst, originalRect, lod);
@@ -2293,6 +2687,30 @@ bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId)
     return q->m_d->readFrame(stream, frameId);
 }
 
+bool KisPaintDeviceFramesInterface::writeFrame(KisPaintDeviceWriter &store, int frameId, int baseFrameId)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0 && baseFrameId >= 0) {
+        return false;
+    }
+    return q->m_d->writeFrame(store, frameId, baseFrameId);
+}
+
+bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId, int baseFrameId)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0 && baseFrameId >= 0) {
+        return false;
+    }
+    return q->m_d->readFrame(stream, frameId, baseFrameId);
+}
+
+int KisPaintDeviceFramesInterface::numSharedFrameTiles(int frameId, int otherFrameId)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0 && otherFrameId >= 0) {
+        return 0;
+    }
+    return q->m_d->numSharedFrameTiles(frameId, otherFrameId);
+}
+
 int KisPaintDeviceFramesInterface::currentFrameId() const
 {
     return q->m_d->currentFrameId();
@@ -2313,6 +2731,14 @@ void KisPaintDeviceFramesInterface::invalidateFrameCache(int frameId)
     return q->m_d->invalidateFrameCache(frameId);
 }
 
+int KisPaintDeviceFramesInterface::frameSequenceNumber(int frameId) const
+{
+    KIS_ASSERT_RECOVER(frameId >= 0) {
+        return q->sequenceNumber();
+    }
+    return q->m_d->frameSequenceNumber(frameId);
+}
+
 void KisPaintDeviceFramesInterface::setFrameOffset(int frameId, const QPoint &offset)
 {
     KIS_ASSERT_RECOVER_RETURN(frameId >= 0);
@@ -384,6 +384,24 @@ protected:
      */
     void fastBitBltOldData(KisPaintDeviceSP src, const QRect &rect);
 
+    /**
+     * Checks whether \p src can be cloned into this device with
+     * fastBitBlt(src, rect, offset), that is the color spaces are the
+     * same, none of the devices is in wrap-around mode and \p offset,
+     * corrected by the x,y shifts of the devices, is a whole number of
+     * tiles.
+     */
+    bool fastBitBltPossible(KisPaintDeviceSP src, const QPoint &offset);
+
+    /**
+     * The same as \ref fastBitBlt(), but the area \p srcRect of \p src
+     * is written to the device moved by \p offset. The tiles are shared
+     * between the devices via copy-on-write just like in fastBitBlt().
+     *
+     * \see fastBitBltPossible(KisPaintDeviceSP, const QPoint&)
+     */
+    void fastBitBlt(KisPaintDeviceSP src, const QRect &srcRect, const QPoint &offset);
+
     /**
      * Clones rect from another paint device in a rough and fast way.
      * All the tiles touched by rect will be shared, between both
@@ -922,6 +940,19 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
 
+    /**
+     * Drops the state of the last LoD synchronization that lets the
+     * next synchronization regenerate only the changed tiles. The next
+     * sync of the device will be a full one.
+     */
+    void purgeLodSyncState();
+
+    /**
+     * Enables or disables incremental LoD synchronization of all the
+     * devices, see KisImageConfig::incrementalLodSync()
+     */
+    static void setIncrementalLodSyncEnabled(bool value);
+
     void generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod);
 
     void setSupportsWraparoundMode(bool value);
@@ -98,6 +98,28 @@ public:
      */
     bool readFrame(QIODevice *stream, int frameId);
 
+    /**
+     * Writes only the tiles of \p frameId that are not shared with
+     * \p baseFrameId. Such a frame should be loaded with the base
+     * frame passed to readFrame().
+     *
+     * \see KisTiledDataManager::writeDelta()
+     */
+    bool writeFrame(KisPaintDeviceWriter &store, int frameId, int baseFrameId);
+
+    /**
+     * Loads a frame written against \p baseFrameId. The tiles missing
+     * in the stream are shared with the base frame, which should have
+     * been loaded beforehand.
+     */
+    bool readFrame(QIODevice *stream, int frameId, int baseFrameId);
+
+    /**
+     * \return the number of tiles \p frameId shares with \p otherFrameId
+     *         via copy-on-write
+     */
+    int numSharedFrameTiles(int frameId, int otherFrameId);
+
 
     /**
      * Returns frameId of the currently active frame.
@@ -117,6 +139,13 @@ public:
      */
     void invalidateFrameCache(int frameId);
 
+    /**
+     * Returns the sequence number of the cache object associated with
+     * the frame. It changes every time the content of the frame changes,
+     * so it can be used for validating external caches of the frame.
+     */
+    int frameSequenceNumber(int frameId) const;
+
     /**
      * Sets the offset for \p frameId.
      * Should be used by Undo framework only!
@@ -8,11 +8,25 @@
 
 #include <kritaimage_export.h>
 
+class KisTileSavingCache;
+
 class KRITAIMAGE_EXPORT KisPaintDeviceWriter {
 public:
     virtual ~KisPaintDeviceWriter() {}
     virtual bool write(const QByteArray &data) = 0;
     virtual bool write(const char* data, qint64 length) = 0;
+
+    /**
+     * The cache of the serialized tiles the devices can reuse while
+     * writing into this writer, or null if there is none
+     */
+    virtual KisTileSavingCache* tileSavingCache() const { return nullptr; }
+
+    /**
+     * When false, the tiles are written raw, which makes the writing
+     * much faster at the cost of a bigger file
+     */
+    virtual bool tileCompressionEnabled() const { return true; }
 };
 
 
@@ -525,8 +525,6 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
     // Check that selection has an alpha colorspace, crash if false
     Q_ASSERT(selection->colorSpace() == KoColorSpaceRegistry::instance()->alpha8());
 
-    const KoCompositeOp *compositeOp = d->compositeOp(srcDev->colorSpace());
-
     QRect srcRect = QRect(srcX, srcY, srcWidth, srcHeight);
 
     // save selection offset in case tryReduceSourceRect() will change rects
@@ -549,20 +547,6 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
     /* Trying to read outside a KisFixedPaintDevice is inherently wrong and shouldn't be done,
     so crash if someone attempts to do this. Don't resize YET as it would obfuscate the mistake. */
     KIS_SAFE_ASSERT_RECOVER_RETURN(selection->bounds().contains(selRect));
-    Q_UNUSED(selRect); // only used by the above Q_ASSERT
-
-
-    /* Create an intermediate byte array to hold information before it is written
-    to the current paint device (d->device) */
-    quint8* dstBytes = 0;
-    try {
-        dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
-    } catch (const std::bad_alloc&) {
-        warnKrita << "KisPainter::bitBltWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "dst bytes";
-        return;
-    }
-
-    d->device->readBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
 
     // Copy the relevant bytes of raw data from srcDev
     quint8* srcBytes = 0;
@@ -579,67 +563,19 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
     const quint8 *selRowStart = selection->data() +
         (selBounds.width() * (selRect.y() - selBounds.top()) + (selRect.x() - selBounds.left())) * selection->pixelSize();
 
-    /*
-     * This checks whether there is nothing selected.
+    /**
+     * The source is composited right into the tiles of the destination,
+     * the user selection (d->selection), if present, is read from its
+     * tiles and multiplied with \p selection one tile at a time
      */
-    if (!d->selection) {
-        /* As there's nothing selected, blit to dstBytes (intermediary bit array),
-          ignoring d->selection (the user selection)*/
-        d->paramInfo.dstRowStart   = dstBytes;
-        d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
-        d->paramInfo.srcRowStart   = srcBytes;
-        d->paramInfo.srcRowStride  = srcWidth * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = selRowStart;
-        d->paramInfo.maskRowStride = selBounds.width() * selection->pixelSize();
-        d->paramInfo.rows          = srcHeight;
-        d->paramInfo.cols          = srcWidth;
-        d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
-    }
-    else {
-        /* Read the user selection (d->selection) bytes into an array, ready
-        to merge in the next block*/
-        quint32 totalBytes = srcWidth * srcHeight * selection->pixelSize();
-        quint8* mergedSelectionBytes = 0;
-        try {
-            mergedSelectionBytes = new quint8[ totalBytes ];
-        } catch (const std::bad_alloc&) {
-            warnKrita << "KisPainter::bitBltWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
-            return;
-        }
+    KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
+    KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
+
+    d->applyFixedDevice(QRect(dstX, dstY, srcWidth, srcHeight),
+                        srcBytes, srcWidth * srcDev->pixelSize(),
+                        selRowStart, selBounds.width() * selection->pixelSize(),
+                        dstIt, maskIt, srcDev->colorSpace(), d->paramInfo);
 
-        d->selection->projection()->readBytes(mergedSelectionBytes, dstX, dstY, srcWidth, srcHeight);
-
-        KoCompositeOp::ParameterInfo multiplyParamInfo;
-        multiplyParamInfo.opacity = 1.0f;
-        multiplyParamInfo.flow = 1.0f;
-
-        // Merge selections here by multiplying them - compositeOP(COMPOSITE_MULT)
-        multiplyParamInfo.dstRowStart   = mergedSelectionBytes;
-        multiplyParamInfo.dstRowStride  = srcWidth * selection->pixelSize();
-        multiplyParamInfo.srcRowStart   = selRowStart;
-        multiplyParamInfo.srcRowStride  = selBounds.width() * selection->pixelSize();
-        multiplyParamInfo.maskRowStart  = 0;
-        multiplyParamInfo.maskRowStride = 0;
-        multiplyParamInfo.rows          = srcHeight;
-        multiplyParamInfo.cols          = srcWidth;
-        KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT)->composite(multiplyParamInfo);
-
-        // Blit to dstBytes (intermediary bit array)
-        d->paramInfo.dstRowStart   = dstBytes;
-        d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
-        d->paramInfo.srcRowStart   = srcBytes;
-        d->paramInfo.srcRowStride  = srcWidth * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = mergedSelectionBytes;
-        d->paramInfo.maskRowStride = srcWidth * selection->pixelSize();
-        d->paramInfo.rows          = srcHeight;
-        d->paramInfo.cols          = srcWidth;
-        d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
-        delete[] mergedSelectionBytes;
-    }
-
-    d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
-
-    delete[] dstBytes;
     delete[] srcBytes;
 
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
@@ -749,7 +685,10 @@ void KisPainter::bitBltImpl(qint32 dstX, qint32 dstY,
                 d->paramInfo.dstRowStride  = dstRowStride;
                 // if we don't use the oldRawData, we need to access the rawData of the source device.
                 d->paramInfo.srcRowStart   = useOldSrcData ? srcIt->oldRawData() : static_cast<KisRandomAccessor2*>(srcIt.data())->rawData();
-                d->paramInfo.srcRowStride  = srcRowStride;
+                // a uniform source tile is passed to the op as a single pixel
+                d->paramInfo.srcRowStride  =
+                    !useOldSrcData && static_cast<KisRandomAccessor2*>(srcIt.data())->isUniform() ?
+                        0 : srcRowStride;
                 d->paramInfo.maskRowStart  = static_cast<KisRandomAccessor2*>(maskIt.data())->rawData();
                 d->paramInfo.maskRowStride = maskRowStride;
                 d->paramInfo.rows          = rows;
@@ -797,7 +736,10 @@ void KisPainter::bitBltImpl(qint32 dstX, qint32 dstY,
                 d->paramInfo.dstRowStride  = dstRowStride;
                 // if we don't use the oldRawData, we need to access the rawData of the source device.
                 d->paramInfo.srcRowStart   = useOldSrcData ? srcIt->oldRawData() : static_cast<KisRandomAccessor2*>(srcIt.data())->rawData();
-                d->paramInfo.srcRowStride  = srcRowStride;
+                // a uniform source tile is passed to the op as a single pixel
+                d->paramInfo.srcRowStride  =
+                    !useOldSrcData && static_cast<KisRandomAccessor2*>(srcIt.data())->isUniform() ?
+                        0 : srcRowStride;
                 d->paramInfo.maskRowStart  = 0;
                 d->paramInfo.maskRowStride = 0;
                 d->paramInfo.rows          = rows;
@@ -966,55 +908,20 @@ void KisPainter::bltFixed(qint32 dstX, qint32 dstY,
     KIS_SAFE_ASSERT_RECOVER_RETURN(srcBounds.contains(srcRect));
     Q_UNUSED(srcRect); // only used in above assertion
 
-    const KoCompositeOp *compositeOp = d->compositeOp(srcDev->colorSpace());
-
-    /* Create an intermediate byte array to hold information before it is written
-    to the current paint device (aka: d->device) */
-    quint8* dstBytes = 0;
-    try {
-         dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
-    } catch (const std::bad_alloc&) {
-        warnKrita << "KisPainter::bltFixed std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
-        return;
-    }
-    d->device->readBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
-
     const quint8 *srcRowStart = srcDev->data() +
         (srcBounds.width() * (srcY - srcBounds.top()) + (srcX - srcBounds.left())) * srcDev->pixelSize();
 
-    d->paramInfo.dstRowStart   = dstBytes;
-    d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
-    d->paramInfo.srcRowStart   = srcRowStart;
-    d->paramInfo.srcRowStride  = srcBounds.width() * srcDev->pixelSize();
-    d->paramInfo.maskRowStart  = 0;
-    d->paramInfo.maskRowStride = 0;
-    d->paramInfo.rows          = srcHeight;
-    d->paramInfo.cols          = srcWidth;
-
-    if (d->selection) {
-        /* d->selection is a KisPaintDevice, so first a readBytes is performed to
-        get the area of interest... */
-        KisPaintDeviceSP selectionProjection(d->selection->projection());
-        quint8* selBytes = 0;
-        try {
-            selBytes = new quint8[srcWidth * srcHeight * selectionProjection->pixelSize()];
-        }
-        catch (const std::bad_alloc&) {
-            delete[] dstBytes;
-            return;
-        }
-
-        selectionProjection->readBytes(selBytes, dstX, dstY, srcWidth, srcHeight);
-        d->paramInfo.maskRowStart = selBytes;
-        d->paramInfo.maskRowStride = srcWidth * selectionProjection->pixelSize();
-    }
-
-    // ...and then blit.
-    d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
-    d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
+    /**
+     * The dab is composited right into the tiles of the destination,
+     * the user selection is read from the tiles of its projection
+     */
+    KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
+    KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
 
-    delete[] d->paramInfo.maskRowStart;
-    delete[] dstBytes;
+    d->applyFixedDevice(QRect(dstX, dstY, srcWidth, srcHeight),
+                        srcRowStart, srcBounds.width() * srcDev->pixelSize(),
+                        0, 0,
+                        dstIt, maskIt, srcDev->colorSpace(), d->paramInfo);
 
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
 }
@@ -1042,8 +949,6 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
      // Check that selection has an alpha colorspace, crash if false
     Q_ASSERT(selection->colorSpace() == KoColorSpaceRegistry::instance()->alpha8());
 
-    const KoCompositeOp *compositeOp = d->compositeOp(srcDev->colorSpace());
-
     QRect srcRect = QRect(srcX, srcY, srcWidth, srcHeight);
     QRect selRect = QRect(selX, selY, srcWidth, srcHeight);
 
@@ -1057,81 +962,23 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
     KIS_ASSERT(selBounds.contains(selRect));
     Q_UNUSED(selRect); // only used in above assertion
 
-    /* Create an intermediate byte array to hold information before it is written
-    to the current paint device (aka: d->device) */
-    quint8* dstBytes = 0;
-    try {
-        dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
-    } catch (const std::bad_alloc&) {
-        warnKrita << "KisPainter::bltFixedWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
-        return;
-    }
-    d->device->readBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
-
     const quint8 *srcRowStart = srcDev->data() +
         (srcBounds.width() * (srcY - srcBounds.top()) + (srcX - srcBounds.left())) * srcDev->pixelSize();
     const quint8 *selRowStart = selection->data() +
         (selBounds.width() * (selY - selBounds.top()) + (selX - selBounds.left())) * selection->pixelSize();
 
-    if (!d->selection) {
-        /* As there's nothing selected, blit to dstBytes (intermediary bit array),
-          ignoring d->selection (the user selection)*/
-        d->paramInfo.dstRowStart   = dstBytes;
-        d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
-        d->paramInfo.srcRowStart   = srcRowStart;
-        d->paramInfo.srcRowStride  = srcBounds.width() * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = selRowStart;
-        d->paramInfo.maskRowStride = selBounds.width() * selection->pixelSize();
-        d->paramInfo.rows          = srcHeight;
-        d->paramInfo.cols          = srcWidth;
-        d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
-    }
-    else {
-        /* Read the user selection (d->selection) bytes into an array, ready
-        to merge in the next block*/
-        quint32 totalBytes = srcWidth * srcHeight * selection->pixelSize();
-        quint8 * mergedSelectionBytes = 0;
-        try {
-            mergedSelectionBytes = new quint8[ totalBytes ];
-        } catch (const std::bad_alloc&) {
-            warnKrita << "KisPainter::bltFixedWithFixedSelection std::bad_alloc for " << totalBytes << "total bytes";
-            delete[] dstBytes;
-            return;
-        }
-        d->selection->projection()->readBytes(mergedSelectionBytes, dstX, dstY, srcWidth, srcHeight);
-
-        KoCompositeOp::ParameterInfo multiplyParamInfo;
-        multiplyParamInfo.opacity = 1.0f;
-        multiplyParamInfo.flow = 1.0f;
-
-        // Merge selections here by multiplying them - compositeOp(COMPOSITE_MULT)
-        multiplyParamInfo.dstRowStart   = mergedSelectionBytes;
-        multiplyParamInfo.dstRowStride  = srcWidth * selection->pixelSize();
-        multiplyParamInfo.srcRowStart   = selRowStart;
-        multiplyParamInfo.srcRowStride  = selBounds.width() * selection->pixelSize();
-        multiplyParamInfo.maskRowStart  = 0;
-        multiplyParamInfo.maskRowStride = 0;
-        multiplyParamInfo.rows          = srcHeight;
-        multiplyParamInfo.cols          = srcWidth;
-        KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT)->composite(multiplyParamInfo);
-
-        // Blit to dstBytes (intermediary bit array)
-        d->paramInfo.dstRowStart   = dstBytes;
-        d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
-        d->paramInfo.srcRowStart   = srcRowStart;
-        d->paramInfo.srcRowStride  = srcBounds.width() * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = mergedSelectionBytes;
-        d->paramInfo.maskRowStride = srcWidth * selection->pixelSize();
-        d->paramInfo.rows          = srcHeight;
-        d->paramInfo.cols          = srcWidth;
-        d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
-
-        delete[] mergedSelectionBytes;
-    }
-
-    d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
-
-    delete[] dstBytes;
+    /**
+     * The dab is composited right into the tiles of the destination,
+     * the user selection (d->selection), if present, is read from its
+     * tiles and multiplied with \p selection one tile at a time
+     */
+    KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
+    KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
+
+    d->applyFixedDevice(QRect(dstX, dstY, srcWidth, srcHeight),
+                        srcRowStart, srcBounds.width() * srcDev->pixelSize(),
+                        selRowStart, selBounds.width() * selection->pixelSize(),
+                        dstIt, maskIt, srcDev->colorSpace(), d->paramInfo);
 
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
 }
@@ -7,6 +7,8 @@
 #include "kis_painter.h"
 #include "kis_painter_p.h"
 
+#include <KoColorSpaceRegistry.h>
+
 #include "kis_paint_device.h"
 #include "kis_fixed_paint_device.h"
 #include "kis_random_accessor_ng.h"
@@ -135,6 +137,158 @@ void KisPainter::Private::applyDeviceWithSelection(const QRect &applyRect,
 
 }
 
+void KisPainter::Private::applyFixedDevice(const QRect &dstRect,
+                                           const quint8 *srcRowStart, int srcRowStride,
+                                           const quint8 *fixedMaskRowStart, int fixedMaskRowStride,
+                                           KisRandomAccessorSP dstIt,
+                                           KisRandomConstAccessorSP maskIt,
+                                           const KoColorSpace *srcColorSpace,
+                                           KoCompositeOp::ParameterInfo &localParamInfo)
+{
+    const int srcPixelSize = srcColorSpace->pixelSize();
+    const KoCompositeOp *op = compositeOp(srcColorSpace);
+
+    /**
+     * When both masks are present, they are multiplied into a buffer
+     * of a single tile, since the rects below never cross the tiles of
+     * the destination or the selection
+     */
+    const KoCompositeOp *multiplyOp = 0;
+    QVector<quint8> mergedMask;
+    KoCompositeOp::ParameterInfo multiplyParamInfo;
+
+    if (maskIt && fixedMaskRowStart) {
+        multiplyOp = KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT);
+        multiplyParamInfo.opacity = 1.0f;
+        multiplyParamInfo.flow = 1.0f;
+        multiplyParamInfo.maskRowStart = 0;
+        multiplyParamInfo.maskRowStride = 0;
+    }
+
+    qint32 dstY = dstRect.y();
+    qint32 rowsRemaining = dstRect.height();
+
+    while (rowsRemaining > 0) {
+        qint32 dstX = dstRect.x();
+
+        qint32 rows = qMin(rowsRemaining, dstIt->numContiguousRows(dstY));
+        if (maskIt) {
+            rows = qMin(rows, maskIt->numContiguousRows(dstY));
+        }
+
+        qint32 columnsRemaining = dstRect.width();
+
+        while (columnsRemaining > 0) {
+
+            qint32 columns = qMin(columnsRemaining, dstIt->numContiguousColumns(dstX));
+            if (maskIt) {
+                columns = qMin(columns, maskIt->numContiguousColumns(dstX));
+            }
+
+            qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
+            dstIt->moveTo(dstX, dstY);
+
+            const int offsetX = dstX - dstRect.x();
+            const int offsetY = dstY - dstRect.y();
+
+            const quint8 *fixedMask = fixedMaskRowStart ?
+                fixedMaskRowStart + offsetX + offsetY * fixedMaskRowStride : 0;
+
+            localParamInfo.maskRowStart  = fixedMask;
+            localParamInfo.maskRowStride = fixedMaskRowStride;
+
+            if (maskIt) {
+                qint32 maskRowStride = maskIt->rowStride(dstX, dstY);
+                maskIt->moveTo(dstX, dstY);
+
+                localParamInfo.maskRowStart  = maskIt->rawDataConst();
+                localParamInfo.maskRowStride = maskRowStride;
+
+                if (multiplyOp) {
+                    mergedMask.resize(rows * columns);
+
+                    const quint8 *selRow = maskIt->rawDataConst();
+                    quint8 *mergedRow = mergedMask.data();
+                    for (int y = 0; y < rows; y++) {
+                        memcpy(mergedRow, selRow, columns);
+                        selRow += maskRowStride;
+                        mergedRow += columns;
+                    }
+
+                    multiplyParamInfo.dstRowStart   = mergedMask.data();
+                    multiplyParamInfo.dstRowStride  = columns;
+                    multiplyParamInfo.srcRowStart   = fixedMask;
+                    multiplyParamInfo.srcRowStride  = fixedMaskRowStride;
+                    multiplyParamInfo.rows          = rows;
+                    multiplyParamInfo.cols          = columns;
+                    multiplyOp->composite(multiplyParamInfo);
+
+                    localParamInfo.maskRowStart  = mergedMask.constData();
+                    localParamInfo.maskRowStride = columns;
+                }
+            }
+
+            localParamInfo.dstRowStart   = dstIt->rawData();
+            localParamInfo.dstRowStride  = dstRowStride;
+            localParamInfo.srcRowStart   = srcRowStart + offsetX * srcPixelSize + offsetY * srcRowStride;
+            localParamInfo.srcRowStride  = srcRowStride;
+            localParamInfo.rows          = rows;
+            localParamInfo.cols          = columns;
+            colorSpace->bitBlt(srcColorSpace, localParamInfo, op, renderingIntent, conversionFlags);
+
+            dstX += columns;
+            columnsRemaining -= columns;
+        }
+
+        dstY += rows;
+        rowsRemaining -= rows;
+    }
+
+    localParamInfo.maskRowStart  = 0;
+    localParamInfo.maskRowStride = 0;
+}
+
+QVector<QRect> KisPainter::Private::splitIntoDestinationTiles(const QRect &rc, KisRandomAccessorSP dstIt)
+{
+    QVector<int> columns;
+    for (int x = rc.x(); x <= rc.right();) {
+        columns << x;
+        x += qMin(dstIt->numContiguousColumns(x), rc.right() - x + 1);
+    }
+    columns << rc.right() + 1;
+
+    QVector<QRect> tiles;
+
+    for (int y = rc.y(); y <= rc.bottom();) {
+        const int rows = qMin(dstIt->numContiguousRows(y), rc.bottom() - y + 1);
+
+        for (int i = 0; i < columns.size() - 1; i++) {
+            tiles << QRect(columns[i], y, columns[i + 1] - columns[i], rows);
+        }
+
+        y += rows;
+    }
+
+    return tiles;
+}
+
+QVector<QVector<int>> KisPainter::Private::binDabsByTiles(const QVector<QRect> &tiles,
+                                                          const QList<KisRenderedDab> &devices)
+{
+    QVector<QVector<int>> bins(tiles.size());
+
+    // every bin lists the dabs in their original order
+    for (int i = 0; i < tiles.size(); i++) {
+        for (int dabIndex = 0; dabIndex < devices.size(); dabIndex++) {
+            if (tiles[i].intersects(devices[dabIndex].realBounds())) {
+                bins[i].append(dabIndex);
+            }
+        }
+    }
+
+    return bins;
+}
+
 void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> allSrcDevices)
 {
     const KoColorSpace *srcColorSpace = 0;
@@ -168,6 +322,30 @@ void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> al
     KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
     KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
 
+    /**
+     * With many overlapping dabs it is much cheaper to composite all
+     * the dabs into one destination tile before moving to the next one:
+     * the tile is resolved only once and stays hot in cache. The dabs
+     * are applied to every tile in their original order, so the result
+     * is exactly the same.
+     */
+    if (devices.size() > 1) {
+        const QVector<QRect> tiles = d->splitIntoDestinationTiles(rc, dstIt);
+        const QVector<QVector<int>> bins = d->binDabsByTiles(tiles, devices);
+
+        for (int i = 0; i < tiles.size(); i++) {
+            Q_FOREACH (int dabIndex, bins[i]) {
+                if (maskIt) {
+                    d->applyDeviceWithSelection(tiles[i], devices[dabIndex], dstIt, maskIt, srcColorSpace, localParamInfo);
+                } else {
+                    d->applyDevice(tiles[i], devices[dabIndex], dstIt, srcColorSpace, localParamInfo);
+                }
+            }
+        }
+
+        return;
+    }
+
     if (maskIt) {
         Q_FOREACH (const KisRenderedDab &dab, devices) {
             d->applyDeviceWithSelection(rc, dab, dstIt, maskIt, srcColorSpace, localParamInfo);
@@ -93,6 +93,38 @@ struct Q_DECL_HIDDEN KisPainter::Private {
                                   const KoColorSpace *srcColorSpace,
                                   KoCompositeOp::ParameterInfo &localParamInfo);
 
+    /**
+     * Composites the fixed source \p srcRowStart onto \p dstRect of
+     * the destination device directly in its tiles, without reading the
+     * destination into an intermediate buffer. The source is expected
+     * to cover the whole \p dstRect.
+     *
+     * If \p maskIt is set, the source is masked with the user selection
+     * read straight from the tiles of the selection, aligned with the
+     * destination tiles. \p fixedMaskRowStart is an optional extra mask
+     * covering \p dstRect, e.g. the mask of a brush dab, it is
+     * multiplied with the user selection one tile at a time.
+     */
+    void applyFixedDevice(const QRect &dstRect,
+                          const quint8 *srcRowStart, int srcRowStride,
+                          const quint8 *fixedMaskRowStart, int fixedMaskRowStride,
+                          KisRandomAccessorSP dstIt,
+                          KisRandomConstAccessorSP maskIt,
+                          const KoColorSpace *srcColorSpace,
+                          KoCompositeOp::ParameterInfo &localParamInfo);
+
+    /**
+     * Splits \p rc into the rects covered by single tiles of the
+     * destination device, row by row
+     */
+    QVector<QRect> splitIntoDestinationTiles(const QRect &rc, KisRandomAccessorSP dstIt);
+
+    /**
+     * For every tile returns the indexes of the dabs intersecting it
+     */
+    QVector<QVector<int>> binDabsByTiles(const QVector<QRect> &tiles,
+                                         const QList<KisRenderedDab> &devices);
+
     template<class T> QVector<T> calculateMirroredObjects(const T &object);
 
 };
@@ -16,6 +16,8 @@
 #include <QVector3D>
 #include <QPolygonF>
 
+#include <vector>
+
 #include <KoUpdater.h>
 #include <KoColor.h>
 #include <KoCompositeOpRegistry.h>
@@ -81,6 +83,7 @@ void KisPerspectiveTransformWorker::init(const QTransform &transform)
 {
     m_isIdentity = transform.isIdentity();
     m_isTranslating = transform.type() == QTransform::TxTranslate;
+    m_isPixelAligned = KisAlgebra2D::isPixelAlignedTransform(transform);
 
     m_forwardTransform = transform;
     m_backwardTransform = transform.inverted();
@@ -107,6 +110,60 @@ void KisPerspectiveTransformWorker::setForwardTransform(const QTransform &transf
 }
 
 
+namespace {
+
+/**
+ * Applies a pixel-aligned transform (an integer offset combined with
+ * flips and rotations by 90 degrees) by moving the pixels around, the
+ * same way KisTransformWorker::rotateRight90() and friends do. Every
+ * destination pixel gets exactly the source pixel the bilinear sampler
+ * would have fetched.
+ */
+void runPixelAlignedPartialDst(KisPaintDeviceSP srcDev,
+                               KisPaintDeviceSP dstDev,
+                               const QRect &dstRect,
+                               const QTransform &backwardTransform)
+{
+    const int a = qRound(backwardTransform.m11());
+    const int b = qRound(backwardTransform.m21());
+    const int c = qRound(backwardTransform.dx());
+    const int d = qRound(backwardTransform.m12());
+    const int e = qRound(backwardTransform.m22());
+    const int f = qRound(backwardTransform.dy());
+
+    auto mapToSrc = [&] (int x, int y) {
+        return QPoint(a * x + b * y + c, d * x + e * y + f);
+    };
+
+    const QPoint srcCorner1 = mapToSrc(dstRect.left(), dstRect.top());
+    const QPoint srcCorner2 = mapToSrc(dstRect.right(), dstRect.bottom());
+    const QRect srcRect =
+        QRect(srcCorner1, QSize(1, 1)) | QRect(srcCorner2, QSize(1, 1));
+
+    const int pixelSize = srcDev->pixelSize();
+
+    std::vector<quint8> srcBuffer(size_t(srcRect.width()) * srcRect.height() * pixelSize);
+    std::vector<quint8> dstBuffer(size_t(dstRect.width()) * dstRect.height() * pixelSize);
+
+    srcDev->readBytes(srcBuffer.data(), srcRect);
+
+    quint8 *dstPtr = dstBuffer.data();
+
+    for (int y = dstRect.top(); y <= dstRect.bottom(); y++) {
+        for (int x = dstRect.left(); x <= dstRect.right(); x++) {
+            const QPoint srcPt = mapToSrc(x, y) - srcRect.topLeft();
+            const size_t srcOffset = (size_t(srcPt.y()) * srcRect.width() + srcPt.x()) * pixelSize;
+
+            memcpy(dstPtr, srcBuffer.data() + srcOffset, pixelSize);
+            dstPtr += pixelSize;
+        }
+    }
+
+    dstDev->writeBytes(dstBuffer.data(), dstRect);
+}
+
+}
+
 struct BilinearWrapper
 {
     using SrcAccessorSP = KisRandomSubAccessorSP;
@@ -208,10 +265,17 @@ void KisPerspectiveTransformWorker::runPartialDst(KisPaintDeviceSP srcDev,
     QRectF srcClipRect = kisGrowRect(srcDev->exactBounds(), 1) | srcDev->defaultBounds()->imageBorderRect();
     if (srcClipRect.isEmpty()) return;
 
-    if (m_isIdentity || (m_isTranslating && !m_forceSubPixelTranslation)) {
+    /**
+     * Sub-pixel translation is forced for animated masks, but when the
+     * translation happens to be integral, the bilinear sampling would
+     * only copy the pixels anyway.
+     */
+    if (m_isIdentity || (m_isTranslating && (!m_forceSubPixelTranslation || m_isPixelAligned))) {
         KisPainter gc(dstDev);
         gc.setCompositeOpId(COMPOSITE_COPY);
         gc.bitBlt(dstRect.topLeft(), srcDev, m_backwardTransform.mapRect(dstRect));
+    } else if (m_isPixelAligned && !srcDev->defaultBounds()->wrapAroundMode()) {
+        runPixelAlignedPartialDst(srcDev, dstDev, dstRect, m_backwardTransform);
     } else {
         KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, dstRect.height());
 
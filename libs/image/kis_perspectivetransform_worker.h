@@ -63,6 +63,7 @@ private:
     QTransform m_forwardTransform;
     bool m_isIdentity;
     bool m_isTranslating;
+    bool m_isPixelAligned;
     bool m_cropDst;
     bool m_forceSubPixelTranslation {false};
 };
@@ -6,12 +6,18 @@
 
 #include "kis_simple_update_queue.h"
 
+#include <utility>
+
 #include <QMutexLocker>
 #include <QVector>
+#include <KisRegion.h>
+#include <KisRectsGrid.h>
 
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "KisFrameBudgetTracker.h"
+#include "config-tile-size.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -42,7 +48,11 @@
 
 
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
-    : m_overrideLevelOfDetail(-1)
+    : m_threadsLimit(1),
+      m_overrideLevelOfDetail(-1),
+      m_frameBudgetTracker(0),
+      m_spontaneousJobsRetryDelay(0),
+      m_spontaneousJobsDeferralBlockCounter(0)
 {
     updateSettings();
 }
@@ -64,17 +74,87 @@ void KisSimpleUpdateQueue::updateSettings()
 
     m_patchWidth = config.updatePatchWidth();
     m_patchHeight = config.updatePatchHeight();
+    m_adaptivePatches = config.adaptiveUpdatePatches();
 
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
 }
 
+void KisSimpleUpdateQueue::setThreadsLimit(int value)
+{
+    QMutexLocker locker(&m_lock);
+    m_threadsLimit = qMax(1, value);
+}
+
+QSize KisSimpleUpdateQueue::patchSize(const QRect &cropRect) const
+{
+    QSize size(m_patchWidth, m_patchHeight);
+
+    if (!m_adaptivePatches || m_threadsLimit <= 1 || cropRect.isEmpty()) {
+        return size;
+    }
+
+    /**
+     * A full refresh of the image should generate at least two
+     * jobs per thread, otherwise a single deep layer stack will
+     * keep one core busy while the others are idle. The patches
+     * are kept aligned to the tile grid, so that every job covers
+     * whole tiles only, and are never smaller than two tiles to
+     * keep the per-walker overhead reasonable.
+     */
+    const int tileSize = KRITA_TILE_SIZE;
+    const int minPatchSize = 2 * tileSize;
+    const qint64 requiredPatches = 2 * m_threadsLimit;
+
+    auto numPatches = [&cropRect] (const QSize &size) {
+        return qint64((cropRect.width() + size.width() - 1) / size.width()) *
+            ((cropRect.height() + size.height() - 1) / size.height());
+    };
+
+    while (numPatches(size) < requiredPatches) {
+        if (size.width() >= size.height() && size.width() > minPatchSize) {
+            size.setWidth(qMax(minPatchSize, (size.width() / 2) / tileSize * tileSize));
+        } else if (size.height() > minPatchSize) {
+            size.setHeight(qMax(minPatchSize, (size.height() / 2) / tileSize * tileSize));
+        } else {
+            break;
+        }
+    }
+
+    return size;
+}
+
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
 {
     return m_overrideLevelOfDetail;
 }
 
+void KisSimpleUpdateQueue::setFrameBudgetTracker(KisFrameBudgetTracker *tracker)
+{
+    QMutexLocker locker(&m_lock);
+    m_frameBudgetTracker = tracker;
+}
+
+int KisSimpleUpdateQueue::takeSpontaneousJobsRetryDelay()
+{
+    QMutexLocker locker(&m_lock);
+    return std::exchange(m_spontaneousJobsRetryDelay, 0);
+}
+
+void KisSimpleUpdateQueue::blockSpontaneousJobsDeferral()
+{
+    QMutexLocker locker(&m_lock);
+    m_spontaneousJobsDeferralBlockCounter++;
+}
+
+void KisSimpleUpdateQueue::unblockSpontaneousJobsDeferral()
+{
+    QMutexLocker locker(&m_lock);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_spontaneousJobsDeferralBlockCounter > 0);
+    m_spontaneousJobsDeferralBlockCounter--;
+}
+
 void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
@@ -137,9 +217,20 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
         if (!numMergeJobs && !numStrokeJobs &&
             (currentLevelOfDetail < 0 || currentLevelOfDetail == job->levelOfDetail())) {
 
-            updaterContext.addSpontaneousJob(job);
-            m_spontaneousJobsList.removeFirst();
-            jobAdded = true;
+            int retryDelay = 0;
+
+            if (m_frameBudgetTracker &&
+                !m_spontaneousJobsDeferralBlockCounter &&
+                m_frameBudgetTracker->shouldDeferSpontaneousJob(&retryDelay)) {
+
+                m_spontaneousJobsRetryDelay =
+                    m_spontaneousJobsRetryDelay > 0 ?
+                    qMin(m_spontaneousJobsRetryDelay, retryDelay) : retryDelay;
+            } else {
+                updaterContext.addSpontaneousJob(job);
+                m_spontaneousJobsList.removeFirst();
+                jobAdded = true;
+            }
         }
     }
 
@@ -196,6 +287,14 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
         if(trySplitJob(node, rc, cropRect, levelOfDetail, type, dontInvalidateFrames)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type, dontInvalidateFrames)) continue;
 
+        const QVector<QRect> freshRects =
+            excludePendingAreas(node, rc, cropRect, levelOfDetail, type, dontInvalidateFrames, walkers);
+
+        if (freshRects.size() != 1 || freshRects.first() != rc) {
+            addJob(node, freshRects, cropRect, levelOfDetail, type, dontInvalidateFrames);
+            continue;
+        }
+
         if (type == KisBaseRectsWalker::UPDATE) {
             KisMergeWalker::Flags flags = KisMergeWalker::DEFAULT;
             if (dontInvalidateFrames) {
@@ -274,29 +373,115 @@ qint32 KisSimpleUpdateQueue::sizeMetric() const
     return m_updatesList.size() + m_spontaneousJobsList.size();
 }
 
+QVector<QRect> KisSimpleUpdateQueue::excludePendingAreas(KisNodeSP node,
+                                                         const QRect& rc,
+                                                         const QRect& cropRect,
+                                                         int levelOfDetail,
+                                                         KisBaseRectsWalker::UpdateType type,
+                                                         bool dontInvalidateFrames,
+                                                         const KisWalkersList &newWalkers)
+{
+    /**
+     * A walker sitting in the queue hasn't started yet, so it will
+     * recalculate its whole requested rect using the latest data. If
+     * the new update is requested for the same node with the same
+     * parameters, the area already covered by such walkers can be
+     * safely dropped from it. That is a common case for multi-brush,
+     * mirror and dense filter-mask updates, which generate heavily
+     * overlapping rects that are too big to be merged.
+     *
+     * The coverage is tracked in tile-aligned cells of KisRectsGrid.
+     * The pending rects are shrunk to the cells they cover completely,
+     * so we never drop a pixel no one is going to update.
+     */
+    const int cellSize = KRITA_TILE_SIZE;
+
+    auto innerAlignedRect = [cellSize] (const QRect &rc) {
+        const int x1 = (rc.left() + cellSize - 1) & ~(cellSize - 1);
+        const int y1 = (rc.top() + cellSize - 1) & ~(cellSize - 1);
+        const int x2 = (rc.left() + rc.width()) & ~(cellSize - 1);
+        const int y2 = (rc.top() + rc.height()) & ~(cellSize - 1);
+
+        return x2 > x1 && y2 > y1 ? QRect(x1, y1, x2 - x1, y2 - y1) : QRect();
+    };
+
+    KisRectsGrid grid(cellSize);
+    bool hasPendingAreas = false;
+
+    auto addPendingAreas = [&] (const KisWalkersList &walkers) {
+        Q_FOREACH (const KisBaseRectsWalkerSP &item, walkers) {
+            if(item->startNode() != node) continue;
+            if(item->type() != type) continue;
+            if(item->clonesDontInvalidateFrames() != dontInvalidateFrames) continue;
+            if(item->cropRect() != cropRect) continue;
+            if(item->levelOfDetail() != levelOfDetail) continue;
+
+            const QRect alignedRect = innerAlignedRect(item->requestedRect()) & grid.alignRect(rc);
+            if (!alignedRect.isEmpty()) {
+                grid.addAlignedRect(alignedRect);
+                hasPendingAreas = true;
+            }
+        }
+    };
+
+    {
+        QMutexLocker locker(&m_lock);
+        addPendingAreas(m_updatesList);
+    }
+    addPendingAreas(newWalkers);
+
+    if (!hasPendingAreas) {
+        return {rc};
+    }
+
+    const QRect alignedRect = grid.alignRect(rc);
+    QVector<QRect> freshRects;
+    bool hasCoveredCells = false;
+
+    for (int y = alignedRect.top(); y <= alignedRect.bottom(); y += cellSize) {
+        for (int x = alignedRect.left(); x <= alignedRect.right(); x += cellSize) {
+            const QRect cell(x, y, cellSize, cellSize);
+
+            if (grid.contains(cell)) {
+                hasCoveredCells = true;
+            } else {
+                freshRects << (cell & rc);
+            }
+        }
+    }
+
+    return hasCoveredCells ? KisRegion(std::move(freshRects)).rects() : QVector<QRect>({rc});
+}
+
 bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
                                        const QRect& cropRect,
                                        int levelOfDetail,
                                        KisBaseRectsWalker::UpdateType type,
                                        bool dontInvalidateFrames)
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
+    QSize patch;
+    {
+        QMutexLocker locker(&m_lock);
+        patch = patchSize(cropRect);
+    }
+
+    if(rc.width() <= patch.width() || rc.height() <= patch.height())
         return false;
 
     // a bit of recursive splitting...
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+    qint32 firstCol = rc.x() / patch.width();
+    qint32 firstRow = rc.y() / patch.height();
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+    qint32 lastCol = (rc.x() + rc.width()) / patch.width();
+    qint32 lastRow = (rc.y() + rc.height()) / patch.height();
 
     QVector<QRect> splitRects;
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
         for(qint32 j = firstCol; j <= lastCol; j++) {
-            QRect maxPatchRect(j * m_patchWidth, i * m_patchHeight,
-                               m_patchWidth, m_patchHeight);
+            QRect maxPatchRect(j * patch.width(), i * patch.height(),
+                               patch.width(), patch.height());
             QRect patchRect = rc & maxPatchRect;
             splitRects.append(patchRect);
         }
@@ -321,6 +506,7 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
     KisBaseRectsWalkerSP goodCandidate;
     KisBaseRectsWalkerSP item;
     KisWalkersListIterator iter(m_updatesList);
+    const QSize patch = patchSize(cropRect);
 
     /**
      * We add new jobs to the tail of the list,
@@ -338,7 +524,7 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
         if(item->cropRect() != cropRect) continue;
         if(item->levelOfDetail() != levelOfDetail) continue;
 
-        if(joinRects(baseRect, item->requestedRect(), m_maxMergeAlpha)) {
+        if(joinRects(baseRect, item->requestedRect(), patch, m_maxMergeAlpha)) {
             goodCandidate = item;
             break;
         }
@@ -368,6 +554,7 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
 {
     KisBaseRectsWalkerSP item;
     KisMutableWalkersListIterator iter(m_updatesList);
+    const QSize patch = patchSize(baseWalker->cropRect());
 
     while(iter.hasNext()) {
         item = iter.next();
@@ -379,7 +566,7 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
         if(item->cropRect() != baseWalker->cropRect()) continue;
         if(item->levelOfDetail() != baseWalker->levelOfDetail()) continue;
 
-        if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
+        if(joinRects(baseRect, item->requestedRect(), patch, maxAlpha)) {
             iter.remove();
         }
     }
@@ -390,10 +577,12 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
 }
 
 bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
-                                     const QRect& newRect, qreal maxAlpha)
+                                     const QRect& newRect,
+                                     const QSize &maxSize,
+                                     qreal maxAlpha)
 {
     QRect unitedRect = baseRect | newRect;
-    if(unitedRect.width() > m_patchWidth || unitedRect.height() > m_patchHeight)
+    if(unitedRect.width() > maxSize.width() || unitedRect.height() > maxSize.height())
         return false;
 
     bool result = false;
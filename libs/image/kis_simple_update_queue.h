@@ -11,6 +11,8 @@
 #include "kis_updater_context.h"
 #include <KisProjectionUpdateFlags.h>
 
+class KisFrameBudgetTracker;
+
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
 typedef QListIterator<KisBaseRectsWalkerSP> KisWalkersListIterator;
 typedef QMutableListIterator<KisBaseRectsWalkerSP> KisMutableWalkersListIterator;
@@ -47,19 +49,52 @@ public:
 
     void updateSettings();
 
+    /**
+     * Sets the number of threads the queue should try to feed
+     * with jobs. Used for adaptive splitting of big updates
+     * (see patchSize()).
+     */
+    void setThreadsLimit(int value);
+
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the tracker that decides whether the spontaneous jobs
+     * should be postponed to let the canvas present its frames in time
+     */
+    void setFrameBudgetTracker(KisFrameBudgetTracker *tracker);
+
+    /**
+     * Returns the delay (in milliseconds) after which the queue should
+     * be processed again, because some spontaneous jobs have been
+     * postponed, and resets it. Zero means no jobs are waiting.
+     */
+    int takeSpontaneousJobsRetryDelay();
+
+    /**
+     * While blocked, the spontaneous jobs are never postponed. The
+     * scheduler blocks the deferral when it waits for the queues to
+     * become empty (waitForDone(), barrierLock()), otherwise the
+     * waiting thread would spin until the tracker stops deferring.
+     * The calls can be nested.
+     */
+    void blockSpontaneousJobsDeferral();
+    void unblockSpontaneousJobsDeferral();
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
 
+    QVector<QRect> excludePendingAreas(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames, const KisWalkersList &newWalkers);
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
 
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
-    bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
+    bool joinRects(QRect& baseRect, const QRect& newRect, const QSize &maxSize, qreal maxAlpha);
+
+    QSize patchSize(const QRect &cropRect) const;
 
 protected:
 
@@ -80,6 +115,14 @@ protected:
     qint32 m_patchWidth;
     qint32 m_patchHeight;
 
+    /**
+     * When enabled, the patches are shrunk (in tile-aligned steps)
+     * until a full refresh of the image produces enough jobs to
+     * load all m_threadsLimit threads of the updater context.
+     */
+    bool m_adaptivePatches;
+    int m_threadsLimit;
+
     /**
      * Maximum coefficient of work while regular optimization()
      */
@@ -97,6 +140,10 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    KisFrameBudgetTracker *m_frameBudgetTracker;
+    int m_spontaneousJobsRetryDelay;
+    int m_spontaneousJobsDeferralBlockCounter;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
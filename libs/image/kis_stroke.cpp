@@ -259,6 +259,11 @@ bool KisStroke::canForgetAboutMe() const
     return m_strokeStrategy->canForgetAboutMe();
 }
 
+KisStrokeStrategy::Priority KisStroke::priority() const
+{
+    return m_strokeStrategy->priority();
+}
+
 bool KisStroke::isAsynchronouslyCancellable() const
 {
     return m_strokeStrategy->isAsynchronouslyCancellable();
@@ -13,8 +13,8 @@
 #include <kis_types.h>
 #include "kritaimage_export.h"
 #include "kis_stroke_job.h"
+#include "kis_stroke_strategy.h"
 
-class KisStrokeStrategy;
 class KUndo2MagicString;
 
 
@@ -59,6 +59,7 @@ public:
     bool supportsWrapAroundMode() const;
     int worksOnLevelOfDetail() const;
     bool canForgetAboutMe() const;
+    KisStrokeStrategy::Priority priority() const;
     bool isAsynchronouslyCancellable() const;
     bool clearsRedoOnStart() const;
     qreal balancingRatioOverride() const;
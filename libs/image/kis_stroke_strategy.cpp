@@ -20,6 +20,7 @@ KisStrokeStrategy::KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicS
       m_needsExplicitCancel(false),
       m_forceLodModeIfPossible(false),
       m_balancingRatioOverride(-1.0),
+      m_priority(NORMAL_PRIORITY),
       m_id(id),
       m_name(name),
       m_mutatedJobsInterface(0)
@@ -36,6 +37,7 @@ KisStrokeStrategy::KisStrokeStrategy(const KisStrokeStrategy &rhs)
       m_needsExplicitCancel(rhs.m_needsExplicitCancel),
       m_forceLodModeIfPossible(rhs.m_forceLodModeIfPossible),
       m_balancingRatioOverride(rhs.m_balancingRatioOverride),
+      m_priority(rhs.m_priority),
       m_id(rhs.m_id),
       m_name(rhs.m_name),
       m_mutatedJobsInterface(0)
@@ -239,6 +241,16 @@ void KisStrokeStrategy::setNeedsExplicitCancel(bool value)
     m_needsExplicitCancel = value;
 }
 
+KisStrokeStrategy::Priority KisStrokeStrategy::priority() const
+{
+    return m_priority;
+}
+
+void KisStrokeStrategy::setPriority(Priority value)
+{
+    m_priority = value;
+}
+
 qreal KisStrokeStrategy::balancingRatioOverride() const
 {
     return m_balancingRatioOverride;
@@ -19,6 +19,21 @@ class KisStrokesQueueMutatedJobInterface;
 
 class KRITAIMAGE_EXPORT KisStrokeStrategy
 {
+public:
+    /**
+     * Priority class of the stroke.
+     *
+     * Background strokes (thumbnails, histograms, other idle tasks)
+     * yield to the user's work: the strokes queue doesn't start their
+     * jobs while there are pending updates and, when a stroke of higher
+     * priority is waiting in the queue, cancels them between the jobs
+     * (if they are forgettable) or finishes them as soon as possible.
+     */
+    enum Priority {
+        NORMAL_PRIORITY,
+        BACKGROUND_PRIORITY
+    };
+
 public:
     KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicString &name = KUndo2MagicString());
     virtual ~KisStrokeStrategy();
@@ -112,6 +127,12 @@ public:
 
     bool needsExplicitCancel() const;
 
+    /**
+     * Returns the priority class of the stroke. Default is
+     * NORMAL_PRIORITY.
+     */
+    Priority priority() const;
+
 
     /**
      * \see setBalancingRatioOverride() for details
@@ -171,6 +192,7 @@ protected:
     void setCanForgetAboutMe(bool value);
     void setAsynchronouslyCancellable(bool value);
     void setNeedsExplicitCancel(bool value);
+    void setPriority(Priority value);
 
     /**
      * Set override for the desired scheduler balancing ratio:
@@ -203,6 +225,7 @@ private:
     bool m_needsExplicitCancel;
     bool m_forceLodModeIfPossible;
     qreal m_balancingRatioOverride;
+    Priority m_priority;
 
     QLatin1String m_id;
     KUndo2MagicString m_name;
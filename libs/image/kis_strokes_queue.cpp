@@ -21,6 +21,7 @@ typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
 
 #include "kis_image_interfaces.h"
+#include "KisSchedulerTracer.h"
 class KisStrokesQueue::LodNUndoStrokesFacade : public KisStrokesFacade
 {
 public:
@@ -85,6 +86,16 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     int desiredLevelOfDetail;
     int nextDesiredLevelOfDetail;
     QMutex mutex;
+
+    /**
+     * The number of processQueue() requests that have not been
+     * served yet and the externalJobsPending flag of the requests
+     * that have been collapsed into a still running pass, see
+     * processQueue()
+     */
+    QAtomicInt processQueueRequests;
+    QAtomicInt collapsedExternalJobsPending;
+
     KisLodSyncStrokeStrategyFactory lod0ToNStrokeStrategyFactory;
     KisSuspendResumeStrategyPairFactory suspendResumeUpdatesStrokeStrategyFactory;
     std::function<void()> purgeRedoStateCallback;
@@ -95,6 +106,8 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     KisLodPreferences lodPreferences;
 
     void cancelForgettableStrokes();
+    bool hasWaitingStrokesOfHigherPriority() const;
+    void tryPreemptBackgroundStroke();
     void startLod0ToNStroke(int levelOfDetail, bool forgettable);
 
 
@@ -177,6 +190,47 @@ void KisStrokesQueue::Private::cancelForgettableStrokes()
     }
 }
 
+bool KisStrokesQueue::Private::hasWaitingStrokesOfHigherPriority() const
+{
+    KisStrokeSP head = strokesQueue.head();
+
+    for (auto it = std::next(strokesQueue.begin()); it != strokesQueue.end(); ++it) {
+        KisStrokeSP stroke = *it;
+
+        if (stroke->priority() == KisStrokeStrategy::BACKGROUND_PRIORITY) continue;
+
+        /**
+         * Suspend/resume strokes are generated by the queue itself, and
+         * the LodN buddies of the background strokes inherit their
+         * priority.
+         */
+        if (stroke->type() == KisStroke::SUSPEND ||
+            stroke->type() == KisStroke::RESUME ||
+            (head->type() == KisStroke::LOD0 && head->lodBuddy() == stroke)) {
+
+            continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void KisStrokesQueue::Private::tryPreemptBackgroundStroke()
+{
+    KisStrokeSP stroke = strokesQueue.head();
+
+    if (stroke->priority() == KisStrokeStrategy::BACKGROUND_PRIORITY &&
+        stroke->canForgetAboutMe() &&
+        stroke->isEnded() &&
+        !stroke->isCancelled() &&
+        hasWaitingStrokesOfHigherPriority()) {
+
+        stroke->cancelStroke();
+    }
+}
+
 std::pair<StrokesQueueIterator, StrokesQueueIterator> KisStrokesQueue::Private::currentLodRange()
 {
     /**
@@ -589,15 +643,47 @@ void KisStrokesQueue::Private::forceResetLodAndCloseCurrentLodRange()
 void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
                                    bool externalJobsPending)
 {
-    updaterContext.lock();
-    m_d->mutex.lock();
+    /**
+     * Every finished job calls processQueue(), so with many cores
+     * the worker threads used to form a convoy on the context lock
+     * and the queue mutex, each of them just to pick one job. Now
+     * the requests are combined: if some thread is already
+     * processing the queue, we just ask it to do one more pass
+     * and return immediately, letting our worker thread
+     * continue (or exit) without waiting.
+     *
+     * The jobs are still dispatched centrally by processOneJob(),
+     * under both locks; the worker threads never steal jobs from
+     * each other.
+     */
+
+    if (externalJobsPending) {
+        m_d->collapsedExternalJobsPending.storeRelease(1);
+    }
+
+    if (m_d->processQueueRequests.fetchAndAddOrdered(1) > 0) {
+        return;
+    }
+
+    int handledRequests = 0;
 
-    while(updaterContext.hasSpareThread() &&
-          processOneJob(updaterContext,
-                        externalJobsPending));
+    do {
+        handledRequests = m_d->processQueueRequests.loadAcquire();
 
-    m_d->mutex.unlock();
-    updaterContext.unlock();
+        const bool passExternalJobsPending =
+            m_d->collapsedExternalJobsPending.fetchAndStoreOrdered(0);
+
+        updaterContext.lock();
+        m_d->mutex.lock();
+
+        while(updaterContext.hasSpareThread() &&
+              processOneJob(updaterContext,
+                            passExternalJobsPending));
+
+        m_d->mutex.unlock();
+        updaterContext.unlock();
+
+    } while (m_d->processQueueRequests.fetchAndAddOrdered(-handledRequests) != handledRequests);
 }
 
 bool KisStrokesQueue::needsExclusiveAccess() const
@@ -745,6 +831,12 @@ bool KisStrokesQueue::processOneJob(KisUpdaterContext &updaterContext,
     if(m_d->strokesQueue.isEmpty()) return false;
     bool result = false;
 
+    /**
+     * Background strokes are preempted between the jobs, as soon
+     * as a stroke of higher priority appears in the queue
+     */
+    m_d->tryPreemptBackgroundStroke();
+
     const int levelOfDetail = updaterContext.currentLevelOfDetail();
 
     const KisUpdaterContextSnapshotEx snapshot = updaterContext.getContextSnapshotEx();
@@ -755,6 +847,7 @@ bool KisStrokesQueue::processOneJob(KisUpdaterContext &updaterContext,
 
     if(checkStrokeState(hasStrokeJobs, levelOfDetail) &&
        checkExclusiveProperty(hasMergeJobs, hasStrokeJobs) &&
+       checkPriorityProperty(externalJobsPending) &&
        checkSequentialProperty(snapshot, externalJobsPending)) {
 
         KisStrokeSP stroke = m_d->strokesQueue.head();
@@ -772,6 +865,14 @@ void KisStrokesQueue::Private::loadStroke(KisStrokeSP stroke)
     balancingRatioOverride = stroke->balancingRatioOverride();
     currentStrokeLoaded = true;
 
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    if (tracer->isEnabled()) {
+        tracer->addInstant("strokes", QStringLiteral("start: ") + stroke->id(),
+                           {{"lod", stroke->worksOnLevelOfDetail()},
+                            {"type", stroke->type()},
+                            {"exclusive", stroke->isExclusive()}});
+    }
+
     /**
      * Some of the strokes can cancel their work with undoing all the
      * changes they did to the paint devices. The problem is that undo
@@ -848,6 +949,13 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->postSyncLod0GUIPlaneRequestForResume();
         }
 
+        KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+        if (tracer->isEnabled()) {
+            tracer->addInstant("strokes", QStringLiteral("end: ") + stroke->id(),
+                               {{"lod", stroke->worksOnLevelOfDetail()},
+                                {"cancelled", stroke->isCancelled()}});
+        }
+
         m_d->strokesQueue.dequeue(); // deleted by shared pointer
         m_d->needsExclusiveAccess = false;
         m_d->wrapAroundModeSupported = false;
@@ -911,6 +1019,21 @@ bool KisStrokesQueue::checkSequentialProperty(KisUpdaterContextSnapshotEx snapsh
     return true;
 }
 
+bool KisStrokesQueue::checkPriorityProperty(bool externalJobsPending)
+{
+    KisStrokeSP stroke = m_d->strokesQueue.head();
+
+    if (stroke->priority() != KisStrokeStrategy::BACKGROUND_PRIORITY) return true;
+
+    /**
+     * When some stroke of higher priority is waiting for the background
+     * one, we should let the latter finish as soon as possible. Otherwise
+     * the background stroke just doesn't compete with the pending
+     * updates for the threads.
+     */
+    return !externalJobsPending || m_d->hasWaitingStrokesOfHigherPriority();
+}
+
 bool KisStrokesQueue::checkLevelOfDetailProperty(int runningLevelOfDetail)
 {
     KisStrokeSP stroke = m_d->strokesQueue.head();
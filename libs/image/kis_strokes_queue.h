@@ -84,6 +84,7 @@ private:
     bool checkBarrierProperty(bool hasMergeJobs, bool hasStrokeJobs,
                               bool externalJobsPending);
     bool checkLevelOfDetailProperty(int runningLevelOfDetail);
+    bool checkPriorityProperty(bool externalJobsPending);
 
     class LodNUndoStrokesFacade;
     KisStrokeId startLodNUndoStroke(KisStrokeStrategy *strokeStrategy);
@@ -75,19 +75,21 @@ KisTimeSpan KisTimeSpan::calculateNodeAffectedFrames(const KisNode *node, int ti
     const QMap<QString, KisKeyframeChannel*> channels =
         node->keyframeChannels();
 
-    // TODO: channels should report to the image which channel exactly has changed
-    //       to avoid the dirty range to be stretched into infinity!
-
     if (channels.isEmpty() ||
         !channels.contains(KisKeyframeChannel::Raster.id())) {
         range = KisTimeSpan::infinite(0);
         return range;
     }
 
-    Q_FOREACH (const KisKeyframeChannel *channel, channels) {
-        // Union
-        range |= channel->affectedFrames(time);
-    }
+    /**
+     * A node update means that its content has changed. The content
+     * belongs to the raster frame active at \p time, so the other
+     * channels (opacity, transform) don't stretch the range. The changes
+     * of the keyframes of these channels invalidate their own affected
+     * frames, and the changes of the non-animated properties invalidate
+     * all the frames explicitly.
+     */
+    range = channels.value(KisKeyframeChannel::Raster.id())->affectedFrames(time);
 
     return range;
 }
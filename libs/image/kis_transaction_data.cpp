@@ -312,6 +312,11 @@ void KisTransactionData::undo()
     possiblyNotifySelectionChanged();
 }
 
+qint64 KisTransactionData::memoryCost() const
+{
+    return KUndo2Command::memoryCost() + m_d->memento->memoryCost();
+}
+
 void KisTransactionData::saveSelectionOutlineCache()
 {
     m_d->savedOutlineCacheValid = false;
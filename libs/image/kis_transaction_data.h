@@ -32,6 +32,8 @@ public:
     void redo() override;
     void undo() override;
 
+    qint64 memoryCost() const override;
+
     virtual void endTransaction();
 
 protected:
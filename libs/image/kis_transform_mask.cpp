@@ -471,6 +471,46 @@ QRect KisTransformMask::decorateRect(KisPaintDeviceSP &src,
         return rc;
     }
 
+    /**
+     * A pixel-aligned transform (an integer offset combined with flips
+     * and rotations by 90 degrees) is rendered by the partial worker
+     * exactly the way the static image would be, so there is no need
+     * to regenerate the static image of the whole layer after every
+     * update of the source: only the requested rect is recalculated.
+     * It turns a tiny dab under such a mask from the full-layer
+     * reprocessing into the update of the dab's rect only.
+     */
+    if (!m_d->staticCache.isCacheOverridden() &&
+        !m_d->recalculatingStaticImage &&
+        params->isAffine() &&
+        !src->defaultBounds()->wrapAroundMode() &&
+        KisAlgebra2D::isPixelAlignedTransform(params->finalAffineTransform())) {
+
+        /**
+         * The static image is not updated here, so it must not be
+         * used for this source anymore, e.g. when the transform
+         * stops being pixel-aligned.
+         */
+        if (maskPos == N_FILTHY || maskPos == N_ABOVE_FILTHY) {
+            m_d->staticCache.invalidateDeviceCache();
+        }
+
+        m_d->worker.setForceSubPixelTranslation(m_d->paramsHolder->isAnimated());
+        m_d->worker.setForwardTransform(params->finalAffineTransform());
+        m_d->worker.runPartialDst(src, dst, rc);
+
+#ifdef DEBUG_RENDERING
+        qDebug() << "Pixel-aligned partial" << name() << ppVar(src->exactBounds()) << ppVar(dst->exactBounds()) << ppVar(rc);
+        KIS_DUMP_DEVICE_2(src, DUMP_RECT, "aligned_src", "dd");
+        KIS_DUMP_DEVICE_2(dst, DUMP_RECT, "aligned_dst", "dd");
+#endif /* DEBUG_RENDERING */
+
+        KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
+        this->busyProgressIndicator()->update();
+
+        return rc;
+    }
+
     if (!m_d->staticCache.isCacheOverridden() &&
         !m_d->recalculatingStaticImage &&
         (maskPos == N_FILTHY || maskPos == N_ABOVE_FILTHY ||
@@ -14,6 +14,9 @@
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -30,6 +33,9 @@
 #include "kis_progress_update_helper.h"
 #include "kis_pixel_selection.h"
 #include "kis_image.h"
+#include "KisRunnableStrokeJobsInterface.h"
+#include "KisRunnableStrokeJobUtils.h"
+#include "config-tile-size.h"
 
 
 KisTransformWorker::KisTransformWorker(KisPaintDeviceSP dev,
@@ -189,34 +195,154 @@ void updateBounds<KisVLineIteratorSP>(QRect &boundRect, const KisFilterWeightsAp
     boundRect.setHeight(newBounds.size());
 }
 
+namespace {
+
+struct TransformBand
+{
+    int firstLine = 0;
+    int numLines = 0;
+};
+
+/**
+ * Splits the lines of a pass into bands aligned to the tile grid, so
+ * that the concurrent bands never write into the same tile
+ */
+QVector<TransformBand> splitIntoTransformBands(int firstLine, int numLines)
+{
+    const int bandSize = KRITA_TILE_SIZE;
+    const int endLine = firstLine + numLines;
+
+    QVector<TransformBand> bands;
+
+    int bandStart = firstLine;
+    while (bandStart < endLine) {
+        const int alignedStart = bandStart - ((bandStart % bandSize) + bandSize) % bandSize;
+        const int bandEnd = qMin(endLine, alignedStart + bandSize);
+
+        bands.append({bandStart, bandEnd - bandStart});
+        bandStart = bandEnd;
+    }
+
+    return bands;
+}
+
+}
+
+struct KisTransformWorker::Pass
+{
+    int numBands = 0;
+    std::function<void(int)> processBand;
+    std::function<void()> finish;
+};
+
+struct KisTransformWorker::JobsState
+{
+    JobsState(const KisTransformWorker &_worker)
+        : worker(_worker)
+    {
+    }
+
+    KisTransformWorker worker;
+    QVector<Step> steps;
+    int nextStep = 0;
+    Pass currentPass;
+
+    KisRunnableStrokeJobsInterface *jobsInterface = 0;
+    int levelOfDetail = 0;
+    std::function<void()> finishCallback;
+};
+
 template <class T>
-void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
-                                       double floatscale, double shear, double dx,
-                                       KisFilterStrategy *filterStrategy,
-                                       int portion)
+KisTransformWorker::Pass KisTransformWorker::preparePass(KisPaintDevice *src, KisPaintDevice *dst,
+                                                         double floatscale, double shear, double dx,
+                                                         KisFilterStrategy *filterStrategy,
+                                                         int portion)
 {
-    bool clampToEdge = shear == 0.0;
+    struct PassData {
+        PassData(KisFilterStrategy *filterStrategy, double floatscale,
+                 KoUpdaterPtr progressUpdater, int portion, int numBands)
+            : buf(filterStrategy, qAbs(floatscale)),
+              progressHelper(progressUpdater, portion, numBands)
+        {
+        }
+
+        KisFilterWeightsBuffer buf;
+        qreal filterSupport = 0.0;
+        qint32 srcStart = 0;
+        qint32 srcLen = 0;
+        qint32 firstLine = 0;
+        QVector<TransformBand> bands;
+        QVector<KisFilterWeightsApplicator::LinePos> linePositions;
+
+        KisProgressUpdateHelper progressHelper;
+        QMutex progressMutex;
+    };
+
+    const bool clampToEdge = shear == 0.0;
 
     qint32 srcStart, srcLen, firstLine, numLines;
     calcDimensions<T>(m_boundRect, srcStart, srcLen, firstLine, numLines);
 
-    KisProgressUpdateHelper progressHelper(m_progressUpdater, portion, numLines);
-    KisFilterWeightsBuffer buf(filterStrategy, qAbs(floatscale));
-    KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+    /**
+     * Every line of the pass reads and writes only its own pixels, so
+     * the lines can be resampled in any order. The bands may be processed
+     * in parallel, the results of the lines are united in the original
+     * order when the pass is finished.
+     */
+    const QVector<TransformBand> bands = splitIntoTransformBands(firstLine, numLines);
 
-    KisFilterWeightsApplicator::LinePos dstBounds;
+    QSharedPointer<PassData> data(
+        new PassData(filterStrategy, floatscale, m_progressUpdater, portion, bands.size()));
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
-        KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+    data->filterSupport = filterStrategy->support(data->buf.weightsPositionScale().toFloat());
+    data->srcStart = srcStart;
+    data->srcLen = srcLen;
+    data->firstLine = firstLine;
+    data->bands = bands;
+    data->linePositions.resize(numLines);
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support(buf.weightsPositionScale().toFloat()));
-        dstBounds.unite(dstPos);
+    Pass pass;
+    pass.numBands = bands.size();
 
-        progressHelper.step();
+    pass.processBand = [data, src, dst, floatscale, shear, dx, clampToEdge] (int bandIndex) {
+        const TransformBand &band = data->bands[bandIndex];
+        KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+
+        for (int i = band.firstLine; i < band.firstLine + band.numLines; i++) {
+            KisFilterWeightsApplicator::LinePos srcPos(data->srcStart, data->srcLen);
+            data->linePositions[i - data->firstLine] =
+                applicator.processLine<T>(srcPos, i, &data->buf, data->filterSupport);
+        }
+
+        QMutexLocker l(&data->progressMutex);
+        data->progressHelper.step();
+    };
+
+    pass.finish = [this, data] () {
+        KisFilterWeightsApplicator::LinePos dstBounds;
+        Q_FOREACH (const KisFilterWeightsApplicator::LinePos &dstPos, data->linePositions) {
+            dstBounds.unite(dstPos);
+        }
+
+        updateBounds<T>(m_boundRect, dstBounds);
+    };
+
+    return pass;
+}
+
+template <class T>
+void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
+                                       double floatscale, double shear, double dx,
+                                       KisFilterStrategy *filterStrategy,
+                                       int portion)
+{
+    Pass pass = preparePass<T>(src, dst, floatscale, shear, dx, filterStrategy, portion);
+
+    for (int i = 0; i < pass.numBands; i++) {
+        pass.processBand(i);
     }
 
-    updateBounds<T>(m_boundRect, dstBounds);
+    pass.finish();
 }
 
 template<typename T>
@@ -232,6 +358,101 @@ bool KisTransformWorker::run()
 }
 
 bool KisTransformWorker::runPartial(const QRect &processRect)
+{
+    QVector<Step> steps;
+
+    if (!prepareSteps(processRect, &steps)) return false;
+
+    Q_FOREACH (const Step &step, steps) {
+        Pass pass = step();
+
+        for (int i = 0; i < pass.numBands; i++) {
+            pass.processBand(i);
+        }
+
+        if (pass.finish) {
+            pass.finish();
+        }
+    }
+
+    return true;
+}
+
+void KisTransformWorker::runPartialInJobs(const QRect &processRect,
+                                          KisRunnableStrokeJobsInterface *jobsInterface,
+                                          int levelOfDetail,
+                                          std::function<void()> finishCallback)
+{
+    QSharedPointer<JobsState> state(new JobsState(*this));
+    state->jobsInterface = jobsInterface;
+    state->levelOfDetail = levelOfDetail;
+    state->finishCallback = finishCallback;
+
+    /**
+     * The steps capture the worker they were prepared by, so they
+     * should be prepared by the copy that lives in the shared state
+     */
+    if (!state->worker.prepareSteps(processRect, &state->steps)) {
+        state->steps.clear();
+    }
+
+    addNextStepJobs(state);
+}
+
+void KisTransformWorker::addNextStepJobs(QSharedPointer<JobsState> state)
+{
+    if (state->currentPass.finish) {
+        state->currentPass.finish();
+    }
+    state->currentPass = Pass();
+
+    /**
+     * The sequential steps and the single-band passes are done right
+     * here, there is no reason to spend a job on each of them
+     */
+    while (state->nextStep < state->steps.size()) {
+        Pass pass = state->steps[state->nextStep++]();
+
+        if (pass.numBands > 1) {
+            state->currentPass = pass;
+            break;
+        }
+
+        for (int i = 0; i < pass.numBands; i++) {
+            pass.processBand(i);
+        }
+
+        if (pass.finish) {
+            pass.finish();
+        }
+    }
+
+    if (state->currentPass.numBands <= 0) {
+        state->finishCallback();
+        return;
+    }
+
+    QVector<KisRunnableStrokeJobDataBase*> jobs;
+
+    for (int i = 0; i < state->currentPass.numBands; i++) {
+        KritaUtils::addJobConcurrent(jobs, state->levelOfDetail, [state, i] () {
+            state->currentPass.processBand(i);
+        });
+    }
+
+    /**
+     * The mutated jobs are executed before the next sequential job of
+     * the stroke, so the pass is finished before the jobs that were
+     * added after the transformation by the caller
+     */
+    KritaUtils::addJobSequential(jobs, state->levelOfDetail, [state] () {
+        addNextStepJobs(state);
+    });
+
+    state->jobsInterface->addRunnableJobs(jobs);
+}
+
+bool KisTransformWorker::prepareSteps(const QRect &processRect, QVector<Step> *steps)
 {
     /* Check for nonsense and let the user know, this helps debugging.
     Otherwise the program will crash at a later point, in a very obscure way, probably by division by zero */
@@ -248,9 +469,12 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
     m_boundRect = processRect;
 
     if (m_boundRect.isNull()) {
-        if (!m_progressUpdater.isNull()) {
-            m_progressUpdater->setProgress(100);
-        }
+        steps->append([this] () {
+            if (!m_progressUpdater.isNull()) {
+                m_progressUpdater->setProgress(100);
+            }
+            return Pass();
+        });
         return true;
     }
 
@@ -270,12 +494,20 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
         bool yShearPresent = !qFuzzyCompare(m_yshear, 0.0);
 
         if (scalePresent || (xShearPresent && yShearPresent)) {
-            transformPass <KisHLineIteratorSP>(m_dev.data(), m_dev.data(), xscale, yscale *  m_xshear, 0, m_filter, portion);
-            transformPass <KisVLineIteratorSP>(m_dev.data(), m_dev.data(), yscale, m_yshear, 0, m_filter, portion);
+            steps->append([this, xscale, yscale, portion] () {
+                return preparePass<KisHLineIteratorSP>(m_dev.data(), m_dev.data(), xscale, yscale *  m_xshear, 0, m_filter, portion);
+            });
+            steps->append([this, yscale, portion] () {
+                return preparePass<KisVLineIteratorSP>(m_dev.data(), m_dev.data(), yscale, m_yshear, 0, m_filter, portion);
+            });
         } else if (xShearPresent) {
-            transformPass <KisHLineIteratorSP>(m_dev.data(), m_dev.data(), xscale, m_xshear, 0, m_filter, portion);
+            steps->append([this, xscale, portion] () {
+                return preparePass<KisHLineIteratorSP>(m_dev.data(), m_dev.data(), xscale, m_xshear, 0, m_filter, portion);
+            });
         } else if (yShearPresent) {
-            transformPass <KisVLineIteratorSP>(m_dev.data(), m_dev.data(), yscale, m_yshear, 0, m_filter, portion);
+            steps->append([this, yscale, portion] () {
+                return preparePass<KisVLineIteratorSP>(m_dev.data(), m_dev.data(), yscale, m_yshear, 0, m_filter, portion);
+            });
         }
 
         yscale = 1.;
@@ -303,8 +535,18 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
      *
      * See: https://bugs.kde.org/show_bug.cgi?id=445714
      */
+    /**
+     * Forced sub-pixel translation (used by the animated transform masks)
+     * doesn't need any resampling if the translation is integral, so
+     * keyframed offsets can still go through the lossless path.
+     */
+    auto isIntegral = [] (qreal value) {
+        return qAbs(value - qRound(value)) < 1e-6;
+    };
+
     const bool simpleTransform =
-        !m_forceSubPixelTranslation &&
+        (!m_forceSubPixelTranslation ||
+         (isIntegral(xtranslate) && isIntegral(ytranslate))) &&
         (qFuzzyCompare(rotation, 0.0)) &&
         (qFuzzyCompare(xscale, 1.0) ||
          qFuzzyCompare(xscale, -1.0)) &&
@@ -323,14 +565,23 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
     switch (rotQuadrant) {
     case 1:
         swapValues(&xscale, &yscale);
-        m_boundRect = rotateRight90(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+        steps->append([this, progressPortion] () {
+            m_boundRect = rotateRight90(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+            return Pass();
+        });
         break;
     case 2:
-        m_boundRect = rotate180(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+        steps->append([this, progressPortion] () {
+            m_boundRect = rotate180(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+            return Pass();
+        });
         break;
     case 3:
         swapValues(&xscale, &yscale);
-        m_boundRect = rotateLeft90(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+        steps->append([this, progressPortion] () {
+            m_boundRect = rotateLeft90(m_dev, m_boundRect, m_progressUpdater, progressPortion);
+            return Pass();
+        });
         break;
     default:
         /* do nothing */
@@ -338,29 +589,33 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
     }
 
     if (simpleTransform) {
+        steps->append([this, xscale, yscale, xtranslate, ytranslate] () mutable {
+
+            // Flipping horizontally
+            if (qFuzzyCompare(xscale, -1.0)) {
+                QRect bounds = m_dev->exactBounds();
+                double center_x = bounds.topLeft().x() + bounds.width() / 2.0;
+                xtranslate -= 2 * center_x;
+                mirrorX(m_dev);
+            }
 
-        // Flipping horizontally
-        if (qFuzzyCompare(xscale, -1.0)) {
-            QRect bounds = m_dev->exactBounds();
-            double center_x = bounds.topLeft().x() + bounds.width() / 2.0;
-            xtranslate -= 2 * center_x;
-            mirrorX(m_dev);
-        }
+            // Flipping vertically
+            if (qFuzzyCompare(yscale, -1.0)) {
+                QRect bounds = m_dev->exactBounds();
+                double center_y = bounds.topLeft().y() + bounds.height() / 2.0;
+                ytranslate -= 2 * center_y;
+                mirrorY(m_dev);
+            }
 
-        // Flipping vertically
-        if (qFuzzyCompare(yscale, -1.0)) {
-            QRect bounds = m_dev->exactBounds();
-            double center_y = bounds.topLeft().y() + bounds.height() / 2.0;
-            ytranslate -= 2 * center_y;
-            mirrorY(m_dev);
-        }
+            // Simple translation
+            const int intXTranslate = qRound(xtranslate);
+            const int intYTranslate = qRound(ytranslate);
 
-        // Simple translation
-        const int intXTranslate = qRound(xtranslate);
-        const int intYTranslate = qRound(ytranslate);
+            m_boundRect.translate(intXTranslate, intYTranslate);
+            m_dev->moveTo(m_dev->x() + intXTranslate, m_dev->y() + intYTranslate);
 
-        m_boundRect.translate(intXTranslate, intYTranslate);
-        m_dev->moveTo(m_dev->x() + intXTranslate, m_dev->y() + intYTranslate);
+            return Pass();
+        });
 
     } else {
         QTransform SC = QTransform::fromScale(xscale, yscale);
@@ -382,10 +637,14 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
         qreal f = m.m32() - m.m31() * m.m12() / m.m11();
 
         // First Pass (X)
-        transformPass <KisHLineIteratorSP>(m_dev.data(), m_dev.data(), a, b, c, m_filter, progressPortion);
+        steps->append([this, a, b, c, progressPortion] () {
+            return preparePass<KisHLineIteratorSP>(m_dev.data(), m_dev.data(), a, b, c, m_filter, progressPortion);
+        });
 
         // Second Pass (Y)
-        transformPass <KisVLineIteratorSP>(m_dev.data(), m_dev.data(), e, d, f, m_filter, progressPortion);
+        steps->append([this, d, e, f, progressPortion] () {
+            return preparePass<KisVLineIteratorSP>(m_dev.data(), m_dev.data(), e, d, f, m_filter, progressPortion);
+        });
 
 #if 0
         /************************************************************/
@@ -428,15 +687,19 @@ bool KisTransformWorker::runPartial(const QRect &processRect)
 
     }
 
-    if (!m_progressUpdater.isNull()) {
-        m_progressUpdater->setProgress(100);
-    }
+    steps->append([this] () {
+        if (!m_progressUpdater.isNull()) {
+            m_progressUpdater->setProgress(100);
+        }
 
-    /**
-     * Purge the tiles which might be left after scaling down the
-     * image
-     */
-    m_dev->purgeDefaultPixels();
+        /**
+         * Purge the tiles which might be left after scaling down the
+         * image
+         */
+        m_dev->purgeDefaultPixels();
+
+        return Pass();
+    });
 
     return true;
 }
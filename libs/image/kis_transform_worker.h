@@ -12,11 +12,16 @@
 #include "kis_types.h"
 #include "kritaimage_export.h"
 
+#include <functional>
+
 #include <QRect>
+#include <QVector>
+#include <QSharedPointer>
 #include <KoUpdater.h>
 
 class KisPaintDevice;
 class KisFilterStrategy;
+class KisRunnableStrokeJobsInterface;
 class QTransform;
 
 class KRITAIMAGE_EXPORT KisTransformWorker
@@ -67,6 +72,22 @@ public:
     bool run();
     bool runPartial(const QRect &processRect);
 
+    /**
+     * Does the same as runPartial(), but adds the work into \p jobsInterface
+     * instead of doing it in place. Every resampling pass is split into
+     * tile-aligned bands, which are added as concurrent stroke jobs, and
+     * the steps between the passes are done in sequential jobs.
+     * \p finishCallback is called from the last sequential job, when the
+     * device is transformed.
+     *
+     * Must be called from a job of a running stroke. The worker is copied
+     * into the jobs, so it can be destroyed right after the call.
+     */
+    void runPartialInJobs(const QRect &processRect,
+                          KisRunnableStrokeJobsInterface *jobsInterface,
+                          int levelOfDetail,
+                          std::function<void()> finishCallback);
+
     /**
      * Returns a matrix of the transformation executed by the worker.
      * Resulting transformation has the following form (in Qt's matrix
@@ -96,8 +117,29 @@ public:
     void setForceSubPixelTranslation(bool value);
 
 private:
+    struct Pass;
+    struct JobsState;
+
+    /**
+     * A step of the transformation. The sequential part of the step is
+     * done in the call itself. If the step is a resampling pass, the
+     * returned bands of the pass are processed afterwards.
+     */
+    typedef std::function<Pass()> Step;
+
+    bool prepareSteps(const QRect &processRect, QVector<Step> *steps);
+    static void addNextStepJobs(QSharedPointer<JobsState> state);
+
     // XXX (BSAR): Why didn't we use the shared-pointer versions of the paint device classes?
     // CBR: because the template functions used within don't work if it's not true pointers
+    template <class T> Pass preparePass(KisPaintDevice* src,
+                                        KisPaintDevice* dst,
+                                        double xscale,
+                                        double  shear,
+                                        double dx,
+                                        KisFilterStrategy *filterStrategy,
+                                        int portion);
+
     template <class T> void transformPass(KisPaintDevice* src,
                                           KisPaintDevice* dst,
                                           double xscale,
@@ -17,6 +17,10 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisSchedulerTracer.h"
+#include "KisFrameBudgetTracker.h"
+#include "KisNumaTopology.h"
+#include <QElapsedTimer>
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -46,6 +50,12 @@ public:
     }
 
     void run() override {
+        /**
+         * In NUMA-aware mode the threads of the pool are pinned to
+         * the nodes the first time they pick up a job
+         */
+        KisNumaTopology::instance()->bindCurrentThread();
+
         runImpl();
 
         // notify that the job is exiting and wake everybody
@@ -80,6 +90,9 @@ private:
                 m_updaterContext->m_exclusiveJobLock.lockForRead();
             }
 
+            KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+            const qint64 traceStartTime = tracer->isEnabled() ? tracer->timestamp() : -1;
+
             if(m_atomicType == Type::MERGE) {
                 runMergeJob();
             } else {
@@ -97,10 +110,24 @@ private:
                     }
 #endif
 
-                    m_runnableJob->run();
+                    if (m_atomicType == Type::SPONTANEOUS &&
+                        m_updaterContext->m_frameBudgetTracker) {
+
+                        QElapsedTimer timer;
+                        timer.start();
+                        m_runnableJob->run();
+                        m_updaterContext->m_frameBudgetTracker->
+                            reportSpontaneousJobFinished(timer.nsecsElapsed() / 1000);
+                    } else {
+                        m_runnableJob->run();
+                    }
                 }
             }
 
+            if (traceStartTime >= 0) {
+                traceJob(tracer, traceStartTime);
+            }
+
             setDone();
 
             m_updaterContext->doSomeUsefulWork();
@@ -119,6 +146,25 @@ private:
         }
     }
 
+    void traceJob(KisSchedulerTracer *tracer, qint64 startTime) {
+        if (m_atomicType == Type::MERGE) {
+            tracer->addSpan("updates", QStringLiteral("merge"), startTime,
+                            {{"width", m_changeRect.width()},
+                             {"height", m_changeRect.height()},
+                             {"lod", m_walker ? m_walker->levelOfDetail() : 0}});
+        } else if (m_runnableJob) {
+            if (m_atomicType == Type::STROKE) {
+                tracer->addSpan("strokes", m_runnableJob->debugName(), startTime,
+                                {{"lod", static_cast<KisStrokeJob*>(m_runnableJob)->levelOfDetail()},
+                                 {"sequentiality", m_strokeJobSequentiality},
+                                 {"exclusive", m_exclusive}});
+            } else {
+                tracer->addSpan("spontaneous", m_runnableJob->debugName(), startTime,
+                                {{"exclusive", m_exclusive}});
+            }
+        }
+    }
+
 public:
 
     inline void runMergeJob() {
@@ -14,11 +14,16 @@
 #include "kis_updater_context.h"
 #include "kis_simple_update_queue.h"
 #include "kis_strokes_queue.h"
+#include "kis_async_merger.h"
+#include "kis_paint_device.h"
 
 #include "kis_queues_progress_updater.h"
 #include "KisImageConfigNotifier.h"
+#include "KisSchedulerTracer.h"
+#include "KisFrameBudgetTracker.h"
 
 #include <QReadWriteLock>
+#include <QTimer>
 #include "kis_lazy_wait_condition.h"
 #include <mutex>
 
@@ -56,6 +61,10 @@ struct Q_DECL_HIDDEN KisUpdateScheduler::Private {
     QReadWriteLock updatesStartLock;
     KisLazyWaitCondition updatesFinishedCondition;
 
+    KisFrameBudgetTracker frameBudgetTracker;
+    QTimer deferredJobsTimer;
+    QAtomicInt deferredJobsTimerArmed;
+
     qreal balancingRatio() const {
         const qreal strokeRatioOverride = strokesQueue.balancingRatioOverride();
         return strokeRatioOverride > 0 ? strokeRatioOverride : defaultBalancingRatio;
@@ -94,6 +103,7 @@ void KisUpdateScheduler::setThreadsLimit(int value)
     m_d->updaterContext.lock();
     m_d->updaterContext.setThreadsLimit(value);
     m_d->updaterContext.unlock();
+    m_d->updatesQueue.setThreadsLimit(value);
     unlock(false);
 }
 
@@ -107,6 +117,14 @@ void KisUpdateScheduler::connectSignals()
 {
     connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
             SLOT(updateSettings()));
+
+    m_d->updatesQueue.setFrameBudgetTracker(&m_d->frameBudgetTracker);
+    m_d->updaterContext.setFrameBudgetTracker(&m_d->frameBudgetTracker);
+
+    m_d->deferredJobsTimer.setSingleShot(true);
+    connect(&m_d->deferredJobsTimer, SIGNAL(timeout()), SLOT(slotProcessDeferredJobs()));
+    connect(this, SIGNAL(sigDeferredJobsPending(int)),
+            SLOT(slotStartDeferredJobsTimer(int)), Qt::QueuedConnection);
 }
 
 void KisUpdateScheduler::setProgressProxy(KoProgressProxy *progressProxy)
@@ -283,6 +301,9 @@ void KisUpdateScheduler::updateSettings()
     m_d->updatesQueue.updateSettings();
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
+    KisAsyncMerger::setBelowFilthyCacheEnabled(config.enableBelowFilthyCache());
+    KisPaintDevice::setIncrementalLodSyncEnabled(config.incrementalLodSync());
+    m_d->frameBudgetTracker.setEnabled(config.frameBudgetScheduling());
     setThreadsLimit(config.maxNumberOfThreads());
 }
 
@@ -320,10 +341,14 @@ bool KisUpdateScheduler::isIdle()
 
 void KisUpdateScheduler::waitForDone()
 {
+    m_d->updatesQueue.blockSpontaneousJobsDeferral();
+
     do {
         processQueues();
         m_d->updaterContext.waitForDone();
     } while(!m_d->updatesQueue.isEmpty() || !m_d->strokesQueue.isEmpty());
+
+    m_d->updatesQueue.unblockSpontaneousJobsDeferral();
 }
 
 bool KisUpdateScheduler::tryBarrierLock()
@@ -345,12 +370,16 @@ bool KisUpdateScheduler::tryBarrierLock()
 
 void KisUpdateScheduler::barrierLock()
 {
+    m_d->updatesQueue.blockSpontaneousJobsDeferral();
+
     do {
         m_d->processingBlocked = false;
         processQueues();
         m_d->processingBlocked = true;
         m_d->updaterContext.waitForDone();
     } while(!m_d->updatesQueue.isEmpty() || !m_d->strokesQueue.isEmpty());
+
+    m_d->updatesQueue.unblockSpontaneousJobsDeferral();
 }
 
 void KisUpdateScheduler::processQueues()
@@ -382,9 +411,50 @@ void KisUpdateScheduler::processQueues()
 
     }
 
+    /**
+     * The queues are processed after every finished job, so the
+     * timer is requested only once until it fires, otherwise the
+     * event loop would be flooded with the queued signals
+     */
+    const int retryDelay = m_d->updatesQueue.takeSpontaneousJobsRetryDelay();
+    if (retryDelay > 0 && m_d->deferredJobsTimerArmed.testAndSetOrdered(0, 1)) {
+        Q_EMIT sigDeferredJobsPending(retryDelay);
+    }
+
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    if (tracer->isEnabled()) {
+        qint32 numMergeJobs, numStrokeJobs;
+        m_d->updaterContext.getJobsSnapshot(numMergeJobs, numStrokeJobs);
+
+        tracer->addCounter("queues", {{"updates", m_d->updatesQueue.sizeMetric()},
+                                      {"strokes", m_d->strokesQueue.sizeMetric()}});
+        tracer->addCounter("jobs", {{"merge", numMergeJobs},
+                                    {"stroke", numStrokeJobs}});
+    }
+
     progressUpdate();
 }
 
+void KisUpdateScheduler::reportFramePresented()
+{
+    m_d->frameBudgetTracker.reportFramePresented();
+}
+
+void KisUpdateScheduler::slotStartDeferredJobsTimer(int delay)
+{
+    if (!m_d->deferredJobsTimer.isActive() ||
+        m_d->deferredJobsTimer.remainingTime() > delay) {
+
+        m_d->deferredJobsTimer.start(delay);
+    }
+}
+
+void KisUpdateScheduler::slotProcessDeferredJobs()
+{
+    m_d->deferredJobsTimerArmed.storeRelease(0);
+    processQueues();
+}
+
 void KisUpdateScheduler::blockUpdates()
 {
     m_d->updatesFinishedCondition.initWaiting();
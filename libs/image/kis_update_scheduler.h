@@ -216,6 +216,15 @@ public:
     bool wrapAroundModeSupported() const;
     int currentLevelOfDetail() const;
 
+    /**
+     * Called by the canvas every time it presents a frame. The scheduler
+     * uses the frame rate to postpone spontaneous jobs when they would
+     * make the canvas drop the next frame.
+     *
+     * \see KisFrameBudgetTracker
+     */
+    void reportFramePresented();
+
     void continueUpdate(const QRect &rect);
     void doSomeUsefulWork();
     void spareThreadAppeared();
@@ -232,6 +241,13 @@ protected Q_SLOTS:
      */
     void updateSettings();
 
+private Q_SLOTS:
+    void slotStartDeferredJobsTimer(int delay);
+    void slotProcessDeferredJobs();
+
+Q_SIGNALS:
+    void sigDeferredJobsPending(int delay);
+
 private:
     friend class UpdatesBlockTester;
     bool haveUpdatesRunning();
@@ -264,6 +264,8 @@ void KisUpdaterContext::setThreadsLimit(int value)
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(this);
     }
+
+    KisSchedulerTracer::instance()->addCounter("threads", {{"limit", value}});
 }
 
 int KisUpdaterContext::threadsLimit() const
@@ -299,6 +301,11 @@ void KisUpdaterContext::jobThreadExited()
     }
 }
 
+void KisUpdaterContext::setFrameBudgetTracker(KisFrameBudgetTracker *tracker)
+{
+    m_frameBudgetTracker = tracker;
+}
+
 void KisUpdaterContext::setTestingMode(bool value)
 {
     m_testingMode = value;
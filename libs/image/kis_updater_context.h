@@ -23,6 +23,7 @@ class KisUpdateJobItem;
 class KisSpontaneousJob;
 class KisStrokeJob;
 class KisUpdateScheduler;
+class KisFrameBudgetTracker;
 
 class KRITAIMAGE_EXPORT KisUpdaterContext
 {
@@ -134,6 +135,12 @@ public:
 
     void setTestingMode(bool value);
 
+    /**
+     * Sets the tracker that is notified about the time every
+     * spontaneous job takes to complete
+     */
+    void setFrameBudgetTracker(KisFrameBudgetTracker *tracker);
+
 protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
@@ -156,6 +163,7 @@ protected:
     QThreadPool m_threadPool;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
+    KisFrameBudgetTracker *m_frameBudgetTracker = 0;
     bool m_testingMode = false;
 
 private:
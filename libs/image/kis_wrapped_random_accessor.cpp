@@ -18,18 +18,49 @@ KisWrappedRandomAccessor::KisWrappedRandomAccessor(KisTiledDataManager *ktm,
     : KisRandomAccessor2(ktm, offsetX, offsetY, writable, completeListener),
       m_wrapRect(wrapRect),
       m_currentPos(QPoint()),
-      m_wrapAxis(wrapAroundModeAxis)
+      m_wrapAxis(wrapAroundModeAxis),
+      m_lastShiftX(wrapRect.x()),
+      m_lastShiftY(wrapRect.y())
 {
 }
 
+inline qint32 KisWrappedRandomAccessor::wrappedX(qint32 x) const
+{
+    if (m_wrapAxis == WRAPAROUND_VERTICAL) {
+        return x;
+    }
+
+    const qint32 result = x - m_lastShiftX;
+    if (result >= 0 && result < m_wrapRect.width()) {
+        return result;
+    }
+
+    const qint32 wrapped = KisWrappedRect::xToWrappedX(x, m_wrapRect, m_wrapAxis);
+    m_lastShiftX = x - wrapped;
+    return wrapped;
+}
+
+inline qint32 KisWrappedRandomAccessor::wrappedY(qint32 y) const
+{
+    if (m_wrapAxis == WRAPAROUND_HORIZONTAL) {
+        return y;
+    }
+
+    const qint32 result = y - m_lastShiftY;
+    if (result >= 0 && result < m_wrapRect.height()) {
+        return result;
+    }
+
+    const qint32 wrapped = KisWrappedRect::yToWrappedY(y, m_wrapRect, m_wrapAxis);
+    m_lastShiftY = y - wrapped;
+    return wrapped;
+}
+
 void KisWrappedRandomAccessor::moveTo(qint32 x, qint32 y)
 {
     m_currentPos = QPoint(x, y);
 
-    x = KisWrappedRect::xToWrappedX(x, m_wrapRect, m_wrapAxis);
-    y = KisWrappedRect::yToWrappedY(y, m_wrapRect, m_wrapAxis);
-
-    KisRandomAccessor2::moveTo(x, y);
+    KisRandomAccessor2::moveTo(wrappedX(x), wrappedY(y));
 }
 
 qint32 KisWrappedRandomAccessor::numContiguousColumns(qint32 x) const
@@ -37,7 +68,7 @@ qint32 KisWrappedRandomAccessor::numContiguousColumns(qint32 x) const
     if (m_wrapAxis == WRAPAROUND_VERTICAL) {
         return KisRandomAccessor2::numContiguousColumns(x);
     }
-    x = KisWrappedRect::xToWrappedX(x, m_wrapRect, m_wrapAxis);
+    x = wrappedX(x);
     qint32 distanceToBorder = m_wrapRect.x() + m_wrapRect.width() - x;
 
     return qMin(distanceToBorder, KisRandomAccessor2::numContiguousColumns(x));
@@ -48,7 +79,7 @@ qint32 KisWrappedRandomAccessor::numContiguousRows(qint32 y) const
     if (m_wrapAxis == WRAPAROUND_HORIZONTAL) {
         return KisRandomAccessor2::numContiguousRows(y);
     }
-    y = KisWrappedRect::yToWrappedY(y, m_wrapRect, m_wrapAxis);
+    y = wrappedY(y);
     qint32 distanceToBorder = m_wrapRect.y() + m_wrapRect.height() - y;
 
     return qMin(distanceToBorder, KisRandomAccessor2::numContiguousRows(y));
@@ -56,9 +87,7 @@ qint32 KisWrappedRandomAccessor::numContiguousRows(qint32 y) const
 
 qint32 KisWrappedRandomAccessor::rowStride(qint32 x, qint32 y) const
 {
-    x = KisWrappedRect::xToWrappedX(x, m_wrapRect, m_wrapAxis);
-    y = KisWrappedRect::yToWrappedY(y, m_wrapRect, m_wrapAxis);
-    return KisRandomAccessor2::rowStride(x, y);
+    return KisRandomAccessor2::rowStride(wrappedX(x), wrappedY(y));
 }
 
 qint32 KisWrappedRandomAccessor::x() const
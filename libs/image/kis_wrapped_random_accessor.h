@@ -29,10 +29,23 @@ public:
     qint32 x() const override;
     qint32 y() const override;
 
+private:
+    qint32 wrappedX(qint32 x) const;
+    qint32 wrappedY(qint32 y) const;
+
 private:
     QRect m_wrapRect;
     QPoint m_currentPos;
     WrapAroundAxis m_wrapAxis;
+
+    /**
+     * The shift between the original and the wrapped coordinates of
+     * the last accessed period of the wrap rect. The accessor is
+     * usually moved within a single period, so the shift lets us
+     * avoid integer division for every access.
+     */
+    mutable qint32 m_lastShiftX;
+    mutable qint32 m_lastShiftY;
 };
 
 #endif /* __KIS_WRAPPED_RANDOM_ACCESSOR_H */
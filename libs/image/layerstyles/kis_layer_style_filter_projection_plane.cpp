@@ -18,6 +18,9 @@
 #include "kis_multiple_projection.h"
 #include "KisLayerStyleKnockoutBlower.h"
 
+#include <QMutex>
+#include <QRegion>
+
 
 struct KisLayerStyleFilterProjectionPlane::Private
 {
@@ -48,6 +51,9 @@ struct KisLayerStyleFilterProjectionPlane::Private
     KisLayerStyleKnockoutBlower knockoutBlower;
 
     KisMultipleProjection projection;
+
+    QRegion upToDateRegion;
+    mutable QMutex upToDateLock;
 };
 
 KisLayerStyleFilterProjectionPlane::
@@ -81,6 +87,8 @@ QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNode
         return QRect();
     }
 
+    const int planesSeqNo = m_d->projection.planesSeqNo();
+
     m_d->projection.clear(rect);
     m_d->filter->processDirectly(m_d->sourceLayer->projection(),
                                  &m_d->projection,
@@ -88,6 +96,20 @@ QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNode
                                  rect,
                                  m_d->style,
                                  m_d->environment.data());
+
+    {
+        QMutexLocker l(&m_d->upToDateLock);
+
+        const bool isLod0 = m_d->environment->currentLevelOfDetail() == 0;
+
+        if (m_d->projection.planesSeqNo() != planesSeqNo) {
+            // the projections have been recreated, so only this rect is valid
+            m_d->upToDateRegion = isLod0 ? QRegion(rect) : QRegion();
+        } else if (isLod0) {
+            m_d->upToDateRegion += rect;
+        }
+    }
+
     return rect;
 }
 
@@ -111,6 +133,26 @@ KisLayerStyleKnockoutBlower *KisLayerStyleFilterProjectionPlane::knockoutBlower(
     return &m_d->knockoutBlower;
 }
 
+bool KisLayerStyleFilterProjectionPlane::isUpToDate(const QRect &rect) const
+{
+    QMutexLocker l(&m_d->upToDateLock);
+    return (QRegion(rect) - m_d->upToDateRegion).isEmpty();
+}
+
+void KisLayerStyleFilterProjectionPlane::invalidate(const QRect &sourceRect)
+{
+    const QRect dirtyRect = changeRect(sourceRect, KisLayer::N_ABOVE_FILTHY);
+
+    QMutexLocker l(&m_d->upToDateLock);
+    m_d->upToDateRegion -= dirtyRect;
+}
+
+void KisLayerStyleFilterProjectionPlane::invalidateAll()
+{
+    QMutexLocker l(&m_d->upToDateLock);
+    m_d->upToDateRegion = QRegion();
+}
+
 KisLayerStyleFilter *KisLayerStyleFilterProjectionPlane::filter() const
 {
     return m_d->filter.data();
@@ -46,6 +46,24 @@ public:
 
     KisLayerStyleKnockoutBlower *knockoutBlower() const;
 
+    /**
+     * A style projection depends on the alpha channel of the source
+     * layer only, so the owner of the plane may skip recalculation of
+     * the areas whose source alpha hasn't changed since the last time.
+     *
+     * \returns true if the whole \p rect has been recalculated on
+     *          the level of detail zero and not invalidated since then
+     */
+    bool isUpToDate(const QRect &rect) const;
+
+    /**
+     * Marks the results that depend on the source pixels in
+     * \p sourceRect as outdated
+     */
+    void invalidate(const QRect &sourceRect);
+
+    void invalidateAll();
+
 protected:
 
     KisLayerStyleFilter* filter() const;
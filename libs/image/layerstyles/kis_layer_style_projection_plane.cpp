@@ -24,6 +24,42 @@
 #include "KisLayerStyleKnockoutBlower.h"
 #include "krita_utils.h"
 
+#include "kis_pixel_selection.h"
+#include "kis_sequential_iterator.h"
+#include "kis_default_bounds_base.h"
+
+#include <cstring>
+
+#include <QMutex>
+#include <QRegion>
+
+namespace {
+
+/**
+ * \return the bounds of the runs of pixels within \p rect that differ
+ *         between the two alpha devices
+ */
+QRect differenceBounds(KisPaintDeviceSP lhs, KisPaintDeviceSP rhs, const QRect &rect)
+{
+    QRect result;
+
+    KisSequentialConstIterator lhsIt(lhs, rect);
+    KisSequentialConstIterator rhsIt(rhs, rect);
+
+    int numConseqPixels = qMin(lhsIt.nConseqPixels(), rhsIt.nConseqPixels());
+    while (lhsIt.nextPixels(numConseqPixels) && rhsIt.nextPixels(numConseqPixels)) {
+        numConseqPixels = qMin(lhsIt.nConseqPixels(), rhsIt.nConseqPixels());
+
+        if (memcmp(lhsIt.rawDataConst(), rhsIt.rawDataConst(), numConseqPixels)) {
+            result |= QRect(lhsIt.x(), lhsIt.y(), numConseqPixels, 1);
+        }
+    }
+
+    return result;
+}
+
+}
+
 struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
 {
     KisLayerProjectionPlaneWSP sourceProjectionPlane;
@@ -85,8 +121,67 @@ struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
                            KisLayerStyleFilterProjectionPlaneSP plane,
                            const QRect &rect,
                            KisPaintDeviceSP originalClone);
+
+    /**
+     * The alpha of the source layer the style projections have last been
+     * recalculated with. The styles depend only on the source alpha and
+     * the layer and image bounds, so recoloring the layer or repainting
+     * it with the same shape doesn't need the styles to be recalculated.
+     */
+    KisPixelSelectionSP sourceAlpha;
+    QRegion sourceAlphaRegion;
+    QRect sourceLayerBounds;
+    QRect sourceImageBounds;
+    QMutex sourceAlphaLock;
+
+    void invalidateChangedSourceAlpha(const QRect &sourceRect,
+                                      const QVector<KisLayerStyleFilterProjectionPlaneSP> &styles);
 };
 
+void KisLayerStyleProjectionPlane::Private::invalidateChangedSourceAlpha(const QRect &sourceRect,
+                                                                         const QVector<KisLayerStyleFilterProjectionPlaneSP> &styles)
+{
+    KisPaintDeviceSP source = sourceLayer->projection();
+
+    QMutexLocker l(&sourceAlphaLock);
+
+    const QRect layerBounds = source->exactBounds();
+    const QRect imageBounds = source->defaultBounds()->bounds();
+
+    if (!sourceAlpha || layerBounds != sourceLayerBounds || imageBounds != sourceImageBounds) {
+        sourceAlpha = new KisPixelSelection();
+        sourceAlphaRegion = QRegion();
+        sourceLayerBounds = layerBounds;
+        sourceImageBounds = imageBounds;
+
+        Q_FOREACH (KisLayerStyleFilterProjectionPlaneSP plane, styles) {
+            plane->invalidateAll();
+        }
+    }
+
+    KisCachedSelection::Guard s1(cachedSelection);
+    KisPixelSelectionSP currentAlpha = s1.selection()->pixelSelection();
+    KisLsUtils::selectionFromAlphaChannel(source, s1.selection(), sourceRect);
+
+    // the source alpha that has never been seen is considered changed
+    QRect changedRect = (QRegion(sourceRect) - sourceAlphaRegion).boundingRect();
+
+    const QRegion knownRegion = sourceAlphaRegion & sourceRect;
+    for (const QRect &rc : knownRegion) {
+        changedRect |= differenceBounds(currentAlpha, sourceAlpha, rc);
+    }
+
+    if (!changedRect.isEmpty()) {
+        Q_FOREACH (KisLayerStyleFilterProjectionPlaneSP plane, styles) {
+            plane->invalidate(changedRect);
+        }
+
+        KisPainter::copyAreaOptimized(sourceRect.topLeft(), currentAlpha, sourceAlpha, sourceRect);
+    }
+
+    sourceAlphaRegion += sourceRect;
+}
+
 KisLayerStyleProjectionPlane::KisLayerStyleProjectionPlane(KisLayer *sourceLayer)
     : m_d(new Private)
 {
@@ -226,7 +321,28 @@ QRect KisLayerStyleProjectionPlane::recalculate(const QRect& rect, KisNodeSP fil
     if (m_d->style->isEnabled()) {
         result = sourcePlane->recalculate(stylesNeedRect(rect), filthyNode, flags);
 
-        Q_FOREACH (const KisAbstractProjectionPlaneSP plane, m_d->allStyles()) {
+        QVector<KisLayerStyleFilterProjectionPlaneSP> styles = m_d->allStyles();
+
+        /**
+         * The projections of the levels of detail are not tracked, they
+         * are always recalculated in full
+         */
+        if (!m_d->sourceLayer->projection()->defaultBounds()->currentLevelOfDetail()) {
+            m_d->invalidateChangedSourceAlpha(stylesNeedRect(rect), styles);
+
+            styles.erase(std::remove_if(styles.begin(), styles.end(),
+                                        [&rect] (const KisLayerStyleFilterProjectionPlaneSP &plane) {
+                                            return plane->isUpToDate(rect);
+                                        }),
+                         styles.end());
+        }
+
+        /**
+         * The styles are recalculated in the calling merge job. The
+         * updates scheduler already runs the merge jobs of different
+         * patches on all of its threads.
+         */
+        Q_FOREACH (const KisLayerStyleFilterProjectionPlaneSP plane, styles) {
             plane->recalculate(rect, filthyNode, flags);
         }
     } else {
@@ -63,10 +63,15 @@ namespace KisLsUtils
         KisSequentialConstIterator srcIt(srcDevice, srcRect);
         KisSequentialIterator dstIt(selection, srcRect);
 
-        while (srcIt.nextPixel() && dstIt.nextPixel()) {
-            quint8 *dstPtr = dstIt.rawData();
-            const quint8* srcPtr = srcIt.rawDataConst();
-            *dstPtr = cs->opacityU8(srcPtr);
+        /**
+         * Copy the alpha run by run instead of calling the color space
+         * for every pixel. The runs of both iterators match unless the
+         * source device is moved by a fraction of a tile.
+         */
+        int numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+        while (srcIt.nextPixels(numConseqPixels) && dstIt.nextPixels(numConseqPixels)) {
+            numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+            cs->copyOpacityU8(const_cast<quint8*>(srcIt.rawDataConst()), dstIt.rawData(), numConseqPixels);
         }
 
     }
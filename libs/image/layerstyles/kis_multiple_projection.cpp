@@ -8,6 +8,7 @@
 
 #include <QMap>
 #include <QReadWriteLock>
+#include <QAtomicInt>
 
 
 #include <KoColorSpace.h>
@@ -30,6 +31,7 @@ struct KisMultipleProjection::Private
 {
     QReadWriteLock lock;
     PlanesMap planes;
+    QAtomicInt planesSeqNo;
 };
 
 
@@ -94,6 +96,7 @@ KisPaintDeviceSP KisMultipleProjection::getProjection(const QString &id,
                 plane.opacity = opacity;
                 plane.channelFlags = channelFlags;
                 writeIt = m_d->planes.insert(id, plane);
+                m_d->planesSeqNo.ref();
             } else if (writeIt->compositeOpId != compositeOpId ||
                        *writeIt->device->colorSpace() != *prototype->colorSpace()) {
 
@@ -101,6 +104,7 @@ KisPaintDeviceSP KisMultipleProjection::getProjection(const QString &id,
                 writeIt->compositeOpId = compositeOpId;
                 writeIt->opacity = opacity;
                 writeIt->channelFlags = channelFlags;
+                m_d->planesSeqNo.ref();
             }
 
             return writeIt->device;
@@ -113,13 +117,18 @@ KisPaintDeviceSP KisMultipleProjection::getProjection(const QString &id,
 void KisMultipleProjection::freeProjection(const QString &id)
 {
     QWriteLocker writeLocker(&m_d->lock);
-    m_d->planes.remove(id);
+    if (m_d->planes.remove(id)) {
+        m_d->planesSeqNo.ref();
+    }
 }
 
 void KisMultipleProjection::freeAllProjections()
 {
     QWriteLocker writeLocker(&m_d->lock);
-    m_d->planes.clear();
+    if (!m_d->planes.isEmpty()) {
+        m_d->planes.clear();
+        m_d->planesSeqNo.ref();
+    }
 }
 
 void KisMultipleProjection::clear(const QRect &rc)
@@ -169,3 +178,7 @@ bool KisMultipleProjection::isEmpty() const
     return m_d->planes.isEmpty();
 }
 
+int KisMultipleProjection::planesSeqNo() const
+{
+    return m_d->planesSeqNo.loadAcquire();
+}
@@ -34,6 +34,13 @@ public:
 
     bool isEmpty() const;
 
+    /**
+     * \return a sequence number that is increased every time a
+     *         projection is created, reset or freed, i.e. every
+     *         time the content of the projections is lost
+     */
+    int planesSeqNo() const;
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
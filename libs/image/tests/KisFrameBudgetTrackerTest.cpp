@@ -0,0 +1,116 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFrameBudgetTrackerTest.h"
+
+#include "KisFrameBudgetTracker.h"
+
+#include <simpletest.h>
+
+namespace {
+void presentFrames(KisFrameBudgetTracker &tracker, qint64 from, qint64 to, qint64 interval)
+{
+    for (qint64 time = from; time <= to; time += interval) {
+        tracker.reportFramePresented(time);
+    }
+}
+}
+
+void KisFrameBudgetTrackerTest::testIdleCanvas()
+{
+    KisFrameBudgetTracker tracker;
+    tracker.reportSpontaneousJobFinished(10000);
+
+    int retryDelay = 0;
+
+    // no frames presented at all
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(1000, &retryDelay));
+
+    // a single frame doesn't define any frame rate
+    tracker.reportFramePresented(2000);
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(3000, &retryDelay));
+
+    // the frames are too rare to be a part of a smooth action
+    tracker.reportFramePresented(500000);
+    QCOMPARE(tracker.frameInterval(), qint64(0));
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(510000, &retryDelay));
+}
+
+void KisFrameBudgetTrackerTest::testDeferShortJob()
+{
+    KisFrameBudgetTracker tracker;
+    tracker.reportSpontaneousJobFinished(10000);
+
+    presentFrames(tracker, 0, 48000, 16000);
+    QCOMPARE(tracker.frameInterval(), qint64(16000));
+
+    int retryDelay = 0;
+
+    // the job fits into the time left before the next frame
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(50000, &retryDelay));
+
+    // the job would make the next frame late
+    QVERIFY(tracker.shouldDeferSpontaneousJob(60000, &retryDelay));
+    QCOMPARE(retryDelay, 5);
+
+    // the next frame has been presented, the job fits now
+    tracker.reportFramePresented(64000);
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(65000, &retryDelay));
+
+    // the canvas has stopped presenting frames
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(120000, &retryDelay));
+}
+
+void KisFrameBudgetTrackerTest::testMaxDeferralTime()
+{
+    KisFrameBudgetTracker tracker;
+
+    // the job never fits into a single frame
+    tracker.reportSpontaneousJobFinished(20000);
+
+    const qint64 interval = 16000;
+    tracker.reportFramePresented(0);
+
+    int retryDelay = 0;
+    qint64 firstDeferral = -1;
+
+    for (qint64 time = interval; time < 400000; time += interval) {
+        tracker.reportFramePresented(time);
+
+        const qint64 requestTime = time + 1000;
+
+        if (!tracker.shouldDeferSpontaneousJob(requestTime, &retryDelay)) {
+            QVERIFY(firstDeferral >= 0);
+            QVERIFY(requestTime - firstDeferral > 250000);
+            QVERIFY(requestTime - firstDeferral <= 250000 + interval);
+            return;
+        }
+
+        if (firstDeferral < 0) {
+            firstDeferral = requestTime;
+        }
+
+        // the long job waits for the canvas to become idle
+        const qint64 retryTime = qMin(time + 2 * interval, firstDeferral + 250000);
+        QCOMPARE(retryDelay, int((retryTime - requestTime + 999) / 1000 + 1));
+    }
+
+    QFAIL("the job has been deferred forever");
+}
+
+void KisFrameBudgetTrackerTest::testDisabled()
+{
+    KisFrameBudgetTracker tracker;
+    tracker.setEnabled(false);
+    tracker.reportSpontaneousJobFinished(10000);
+
+    presentFrames(tracker, 0, 48000, 16000);
+
+    int retryDelay = 0;
+    QVERIFY(!tracker.shouldDeferSpontaneousJob(60000, &retryDelay));
+}
+
+SIMPLE_TEST_MAIN(KisFrameBudgetTrackerTest)
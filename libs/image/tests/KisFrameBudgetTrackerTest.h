@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFRAMEBUDGETTRACKERTEST_H
+#define KISFRAMEBUDGETTRACKERTEST_H
+
+#include <simpletest.h>
+
+class KisFrameBudgetTrackerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIdleCanvas();
+    void testDeferShortJob();
+    void testMaxDeferralTime();
+    void testDisabled();
+};
+
+#endif // KISFRAMEBUDGETTRACKERTEST_H
@@ -9,6 +9,7 @@
 #include "kis_merge_walker.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_async_merger.h"
+#include "KisBelowFilthyCache.h"
 
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
@@ -287,6 +288,151 @@ void KisAsyncMergerTest::testSubgraphingWithoutUpdatingParent()
 }
 
 
+    /*
+      +--------------+
+      |root          |
+      | top          |
+      | paint 5      |
+      | ...          |
+      | paint 1      |
+      +--------------+
+     */
+
+void KisAsyncMergerTest::testBelowFilthyCache()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 128, 128, colorSpace, "cache test");
+
+    QVector<KisPaintDeviceSP> devices;
+    QVector<KisLayerSP> layers;
+
+    for (int i = 0; i < 5; i++) {
+        KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+        device->fill(QRect(i * 16, i * 16, 64, 64), KoColor(QColor(50 * i, 255 - 50 * i, 0), colorSpace));
+        devices << device;
+
+        layers << new KisPaintLayer(image, QString("paint%1").arg(i + 1), 160, device);
+        image->addNode(layers.last(), image->rootLayer());
+    }
+
+    KisPaintDeviceSP topDevice = new KisPaintDevice(colorSpace);
+    KisLayerSP topLayer = new KisPaintLayer(image, "top", 200, topDevice);
+    image->addNode(topLayer, image->rootLayer());
+
+    image->initialRefreshGraph();
+
+    KisBelowFilthyCache &cache = image->rootLayer()->belowFilthyCache();
+    QVERIFY(cache.isEmpty());
+
+    auto mergeNode = [&] (KisNodeSP node, const QRect &rc) {
+        KisMergeWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        walker.collectRects(node, rc);
+        merger.startMerge(walker);
+    };
+
+    auto checkAgainstFullRefresh = [&] () {
+        KisPaintDeviceSP result = new KisPaintDevice(*image->rootLayer()->original());
+
+        KisFullRefreshWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        walker.collectRects(image->rootLayer(), image->bounds());
+        merger.startMerge(walker);
+
+        QPoint pt;
+        return TestUtil::comparePaintDevices(pt, result, image->rootLayer()->original());
+    };
+
+    // populate the cache
+    topDevice->fill(QRect(10, 10, 20, 20), KoColor(Qt::blue, colorSpace));
+    mergeNode(topLayer, image->bounds());
+    QVERIFY(!cache.isEmpty());
+
+    // fetch the composition from the cache
+    topDevice->fill(QRect(40, 40, 20, 20), KoColor(Qt::red, colorSpace));
+    mergeNode(topLayer, image->bounds());
+    QVERIFY(!cache.isEmpty());
+
+    QVERIFY(checkAgainstFullRefresh());
+
+    // the full refresh has invalidated the cached area, populate it again
+    mergeNode(topLayer, image->bounds());
+    QVERIFY(!cache.isEmpty());
+
+    // change one of the layers below
+    devices[1]->fill(QRect(0, 0, 32, 32), KoColor(Qt::white, colorSpace));
+    mergeNode(layers[1], QRect(0, 0, 32, 32));
+
+    topDevice->fill(QRect(0, 0, 20, 20), KoColor(Qt::green, colorSpace));
+    mergeNode(topLayer, image->bounds());
+
+    QVERIFY(checkAgainstFullRefresh());
+}
+
+    /*
+      +-----------+
+      |root       |
+      | invert 2  |
+      | desat     |
+      | invert 1  |
+      | paint 1   |
+      +-----------+
+     */
+
+void KisAsyncMergerTest::testFusedColorTransformations()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 128, 128, colorSpace, "fusion test");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(colorSpace);
+    device1->fill(QRect(0, 0, 96, 96), KoColor(QColor(200, 100, 50), colorSpace));
+    device1->fill(QRect(32, 32, 64, 64), KoColor(QColor(10, 220, 120, 128), colorSpace));
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+    image->addNode(paintLayer1, image->rootLayer());
+
+    const QStringList filterIds = {"invert", "desaturate", "invert"};
+
+    QVector<KisFilterSP> filters;
+    QVector<KisFilterConfigurationSP> configurations;
+    QVector<KisLayerSP> adjustmentLayers;
+
+    for (int i = 0; i < filterIds.size(); i++) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterIds[i]);
+        QVERIFY(filter);
+        KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+        QVERIFY(configuration);
+
+        filters << filter;
+        configurations << configuration->cloneWithResourcesSnapshot();
+
+        adjustmentLayers << new KisAdjustmentLayer(image, QString("adj%1").arg(i + 1), configurations.last(), 0);
+        image->addNode(adjustmentLayers.last(), image->rootLayer());
+    }
+
+    image->initialRefreshGraph();
+
+    const QRect updateRect(16, 16, 64, 64);
+    device1->fill(updateRect, KoColor(QColor(30, 60, 90), colorSpace));
+
+    KisMergeWalker walker(image->bounds());
+    KisAsyncMerger merger;
+    walker.collectRects(paintLayer1, updateRect);
+    merger.startMerge(walker);
+
+    // the intermediate results should still be written into the layers
+    KisPaintDeviceSP expected = new KisPaintDevice(*device1);
+
+    for (int i = 0; i < filters.size(); i++) {
+        filters[i]->process(expected, image->bounds(), configurations[i]);
+
+        QPoint pt;
+        QVERIFY(TestUtil::comparePaintDevices(pt, expected, adjustmentLayers[i]->original()));
+    }
+
+    QPoint pt;
+    QVERIFY(TestUtil::comparePaintDevices(pt, expected, image->rootLayer()->original()));
+}
+
 #include <KoCompositeOpRegistry.h>
 
 enum DependentNodeType {
@@ -20,6 +20,8 @@ private Q_SLOTS:
     void debugObligeChild();
     void testFullRefreshWithClones();
     void testSubgraphingWithoutUpdatingParent();
+    void testBelowFilthyCache();
+    void testFusedColorTransformations();
 
     void testFullRefreshGroupWithMask();
     void testFullRefreshGroupWithStyle();
@@ -19,7 +19,8 @@
 #include <kis_cage_transform_worker.h>
 #include <algorithm>
 
-void testCage(bool clockwise, bool unityTransform, bool benchmarkPrepareOnly = false, int pixelPrecision = 8, bool testQImage = false)
+void testCage(bool clockwise, bool unityTransform, bool benchmarkPrepareOnly = false, int pixelPrecision = 8, bool testQImage = false,
+              KisCageTransformWorker::GridCacheSP gridCache = KisCageTransformWorker::GridCacheSP())
 {
     TestUtil::TestProgressBar bar;
     KoProgressUpdater pu(&bar);
@@ -70,6 +71,7 @@ void testCage(bool clockwise, bool unityTransform, bool benchmarkPrepareOnly = f
                                   origPoints,
                                   updater,
                                   pixelPrecision);
+    worker.setGridCache(gridCache);
 
     QImage result;
     QPointF srcQImageOffset(0, 0);
@@ -120,6 +122,14 @@ void KisCageTransformWorkerTest::testCageClockwise()
     testCage(true, false);
 }
 
+void KisCageTransformWorkerTest::testCageClockwiseCachedGrid()
+{
+    // the second worker reuses the grid prepared by the first one
+    KisCageTransformWorker::GridCacheSP gridCache = KisCageTransformWorker::createGridCache();
+    testCage(true, false, false, 8, false, gridCache);
+    testCage(true, false, false, 8, false, gridCache);
+}
+
 void KisCageTransformWorkerTest::testCageClockwisePrepareOnly()
 {
     testCage(true, false, true);
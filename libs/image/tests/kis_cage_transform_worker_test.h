@@ -14,6 +14,7 @@ class KisCageTransformWorkerTest : public QObject
     Q_OBJECT
 private Q_SLOTS:
     void testCageClockwise();
+    void testCageClockwiseCachedGrid();
     void testCageClockwisePrepareOnly();
     void testCageClockwisePixelPrecision4();
     void testCageClockwisePixelPrecision8QImage();
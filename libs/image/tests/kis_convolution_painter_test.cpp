@@ -450,6 +450,50 @@ void KisConvolutionPainterTest::testGaussianDetailsFFTW()
     testGaussianDetails(true);
 }
 
+void KisConvolutionPainterTest::testRecursiveGaussian()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 400, 400);
+    const qreal radius = 60;
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+    dev->fill(imageRect, KoColor(Qt::white, cs));
+    dev->fill(QRect(150, 120, 100, 160), KoColor(Qt::black, cs));
+    dev->fill(QRect(0, 0, 40, 400), KoColor(Qt::red, cs));
+
+    KisPaintDeviceSP interm = new KisPaintDevice(cs);
+    interm->setDefaultBounds(dev->defaultBounds());
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+
+    KisConvolutionKernelSP kernelHoriz = KisGaussianKernel::createHorizontalKernel(radius);
+    KisConvolutionKernelSP kernelVertical = KisGaussianKernel::createVerticalKernel(radius);
+    const int verticalMargin = kernelVertical->height() / 2 + 1;
+
+    KisConvolutionPainter horizPainter(interm, KisConvolutionPainter::SPATIAL);
+    horizPainter.applyMatrix(kernelHoriz, reference,
+                             imageRect.topLeft() - QPoint(0, verticalMargin),
+                             imageRect.topLeft() - QPoint(0, verticalMargin),
+                             imageRect.size() + QSize(0, 2 * verticalMargin),
+                             BORDER_REPEAT);
+
+    KisConvolutionPainter verticalPainter(reference, KisConvolutionPainter::SPATIAL);
+    verticalPainter.applyMatrix(kernelVertical, interm,
+                                imageRect.topLeft(), imageRect.topLeft(),
+                                imageRect.size(), BORDER_REPEAT);
+
+    // the radius is big enough for the recursive filter to be used
+    KisGaussianKernel::applyGaussian(dev, imageRect, radius, radius,
+                                     cs->channelFlags(true, true), 0);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::compareQImages(errorPoint,
+                                     reference->convertToQImage(0, imageRect),
+                                     dev->convertToQImage(0, imageRect),
+                                     4, 4));
+}
+
 #include "kis_transaction.h"
 
 void KisConvolutionPainterTest::testDilate()
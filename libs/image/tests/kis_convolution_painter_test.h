@@ -47,6 +47,8 @@ private Q_SLOTS:
     void testGaussianDetailsSpatial();
     void testGaussianDetailsFFTW();
 
+    void testRecursiveGaussian();
+
     void testDilate();
     void testErode();
 
@@ -7,6 +7,7 @@
 #include "kis_filter_mask_test.h"
 #include <simpletest.h>
 
+#include <KoColor.h>
 #include <KoColorSpaceRegistry.h>
 
 #include "kis_selection.h"
@@ -132,4 +133,68 @@ void KisFilterMaskTest::testProjectionSelectedTransparentPixels()
     }
 }
 
+void KisFilterMaskTest::testOutputCache()
+{
+    const QRect rc(0, 0, 200, 200);
+
+    TestUtil::MaskParent p(rc);
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+    KisPaintDeviceSP source = layer->paintDevice();
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("blur");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP  kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+
+    mask->initSelection(layer);
+    mask->select(rc, MAX_SELECTED);
+
+    auto applyMask = [&] (KisNode::PositionToFilthy pos) {
+        KisPaintDeviceSP device = new KisPaintDevice(*source);
+        mask->apply(device, rc, rc, pos, KisRenderPassFlag::None);
+        return device;
+    };
+
+    source->fill(QRect(50, 50, 100, 100), KoColor(Qt::white, source->colorSpace()));
+    KisPaintDeviceSP reference = applyMask(KisNode::N_ABOVE_FILTHY);
+
+    /**
+     * The updates coming from the masks above don't change the input
+     * of the mask, so it is allowed to reuse its previous output. Change
+     * the input behind the mask's back to see whether it does.
+     */
+    source->fill(QRect(20, 20, 40, 40), KoColor(Qt::red, source->colorSpace()));
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::comparePaintDevices(errpoint, reference, applyMask(KisNode::N_BELOW_FILTHY)));
+
+    // the other updates should always reprocess the input
+    QVERIFY(!TestUtil::comparePaintDevices(errpoint, reference, applyMask(KisNode::N_ABOVE_FILTHY)));
+
+    // and changing the filter drops the cache
+    source->fill(QRect(20, 20, 40, 40), KoColor(Qt::green, source->colorSpace()));
+    reference = applyMask(KisNode::N_ABOVE_FILTHY);
+
+    source->fill(QRect(20, 20, 40, 40), KoColor(Qt::blue, source->colorSpace()));
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+
+    QVERIFY(!TestUtil::comparePaintDevices(errpoint, reference, applyMask(KisNode::N_BELOW_FILTHY)));
+
+    // hiding the mask drops the cache as well
+    reference = applyMask(KisNode::N_ABOVE_FILTHY);
+
+    source->fill(QRect(20, 20, 40, 40), KoColor(Qt::red, source->colorSpace()));
+    mask->setVisible(false);
+    mask->setVisible(true);
+
+    QVERIFY(!TestUtil::comparePaintDevices(errpoint, reference, applyMask(KisNode::N_BELOW_FILTHY)));
+}
+
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void testProjectionNotSelected();
     void testProjectionSelected();
     void testProjectionSelectedTransparentPixels();
+    void testOutputCache();
 
 };
 
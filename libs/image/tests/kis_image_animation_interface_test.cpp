@@ -20,6 +20,7 @@
 #include "kis_image_animation_interface.h"
 #include "kis_signal_compressor_with_param.h"
 #include "kis_raster_keyframe_channel.h"
+#include "kis_scalar_keyframe_channel.h"
 #include "kis_time_span.h"
 #include "KisLockFrameGenerationLock.h"
 
@@ -185,6 +186,40 @@ void KisImageAnimationInterfaceTest::testFramesChangedSignal()
 
 }
 
+void KisImageAnimationInterfaceTest::testFramesChangedSignalAnimatedOpacity()
+{
+    QRect refRect(QRect(0,0,512,512));
+    TestUtil::MaskParent p(refRect);
+
+    KisPaintLayerSP layer = p.layer;
+    layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+
+    KisKeyframeChannel *rasterChannel = layer->paintDevice()->keyframeChannel();
+    rasterChannel->addKeyframe(10);
+    rasterChannel->addKeyframe(20);
+
+    KisScalarKeyframeChannel *opacityChannel =
+        dynamic_cast<KisScalarKeyframeChannel*>(
+            layer->getKeyframeChannel(KisKeyframeChannel::Opacity.id(), true));
+    QVERIFY(opacityChannel);
+
+    opacityChannel->addScalarKeyframe(0, 100);
+    opacityChannel->addScalarKeyframe(30, 50);
+
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    i->switchCurrentTimeAsync(15);
+    p.image->waitForDone();
+
+    QSignalSpy spy(i, SIGNAL(sigFramesChanged(KisTimeSpan,QRect)));
+
+    // the interpolated opacity doesn't stretch the range of the content change
+    i->notifyNodeChanged(layer.data(), QRect(), false);
+
+    QCOMPARE(spy.count(), 1);
+    QList<QVariant> arguments = spy.takeFirst();
+    QCOMPARE(arguments.at(0).value<KisTimeSpan>(), KisTimeSpan::fromTimeWithDuration(10, 10));
+}
+
 void KisImageAnimationInterfaceTest::testAnimationCompositionBug()
 {
     QRect rect(QRect(0,0,512,512));
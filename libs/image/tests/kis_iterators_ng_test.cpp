@@ -462,6 +462,74 @@ void KisIteratorNGTest::sequentialIteratorWithProgressIncomplete()
     QCOMPARE(proxy.value(), proxy.max());
 }
 
+#include <KisTileSpanIterator.h>
+
+void KisIteratorNGTest::tileSpanIter()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setX(10);
+    dev->setY(-15);
+
+    const QRect rc(33, -10, 150, 100);
+    const int pixelSize = cs->pixelSize();
+
+    auto pixelValue = [] (int x, int y) {
+        return quint8((x * 7 + y * 13) & 0xff);
+    };
+
+    { // const iterator with **empty** area never enters the loop
+        KisTileSpanConstIterator it(dev, QRect());
+        QVERIFY(!it.nextSpan());
+    }
+
+    {
+        KisTileSpanIterator it(dev, rc);
+        int numPixels = 0;
+
+        while (it.nextSpan()) {
+            QVERIFY(rc.contains(it.rect()));
+            QVERIFY(it.width() <= 64);
+            QVERIFY(it.height() <= 64);
+
+            quint8 *row = it.rawData();
+            for (int y = 0; y < it.height(); y++) {
+                for (int x = 0; x < it.width(); x++) {
+                    memset(row + x * pixelSize, pixelValue(it.x() + x, it.y() + y), pixelSize);
+                }
+                row += it.rowStride();
+            }
+
+            numPixels += it.width() * it.height();
+        }
+
+        QVERIFY(!it.nextSpan());
+        QCOMPARE(numPixels, rc.width() * rc.height());
+    }
+
+    QCOMPARE(dev->exactBounds(), rc);
+
+    {
+        KisSequentialConstIterator it(dev, rc);
+        while (it.nextPixel()) {
+            QCOMPARE(it.rawDataConst()[0], pixelValue(it.x(), it.y()));
+        }
+    }
+
+    {
+        KisTileSpanConstIterator it(dev, rc);
+        while (it.nextSpan()) {
+            const quint8 *row = it.rawDataConst();
+            for (int y = 0; y < it.height(); y++) {
+                for (int x = 0; x < it.width(); x++) {
+                    QCOMPARE(row[x * pixelSize], pixelValue(it.x() + x, it.y() + y));
+                }
+                row += it.rowStride();
+            }
+        }
+    }
+}
+
 void KisIteratorNGTest::hLineIter()
 {
     allCsApplicator(&KisIteratorNGTest::hLineIter);
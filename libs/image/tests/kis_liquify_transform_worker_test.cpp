@@ -121,6 +121,46 @@ void KisLiquifyTransformWorkerTest::testPointsQImage()
     TestUtil::checkQImage(result, "liquify_transform_test", "liquify_qimage", "resultImage");
 }
 
+void KisLiquifyTransformWorkerTest::testIncrementalQImage()
+{
+    QImage image(TestUtil::fetchDataFileLazy("test_transform_quality_second.png"));
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    const QRect srcBounds = image.rect();
+    const QTransform imageToThumbTransform = QTransform::fromScale(0.5, 0.5);
+    const QImage thumb = image.transformed(imageToThumbTransform);
+
+    auto applyFirstStroke = [] (KisLiquifyTransformWorker &worker) {
+        worker.translatePoints(QPointF(100,100), QPointF(50, 0), 50, false, 0.2);
+    };
+
+    auto applySecondStroke = [] (KisLiquifyTransformWorker &worker) {
+        worker.scalePoints(QPointF(400,300), 0.5, 50, false, 0.2);
+        worker.undoPoints(QPointF(120,100), 0.5, 30);
+    };
+
+    KisLiquifyTransformWorker incrementalWorker(srcBounds, 0, 8);
+    QPointF incrementalOffset;
+
+    applyFirstStroke(incrementalWorker);
+    incrementalWorker.runOnQImage(thumb, QPointF(10, 10), imageToThumbTransform, &incrementalOffset);
+
+    applySecondStroke(incrementalWorker);
+    const QImage incrementalResult =
+        incrementalWorker.runOnQImage(thumb, QPointF(10, 10), imageToThumbTransform, &incrementalOffset);
+
+    KisLiquifyTransformWorker fullWorker(srcBounds, 0, 8);
+    QPointF fullOffset;
+
+    applyFirstStroke(fullWorker);
+    applySecondStroke(fullWorker);
+    const QImage fullResult =
+        fullWorker.runOnQImage(thumb, QPointF(10, 10), imageToThumbTransform, &fullOffset);
+
+    QCOMPARE(incrementalOffset, fullOffset);
+    QCOMPARE(incrementalResult, fullResult);
+}
+
 void KisLiquifyTransformWorkerTest::testIdentityTransform()
 {
     TestUtil::TestProgressBar bar;
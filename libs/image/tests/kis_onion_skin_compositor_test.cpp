@@ -146,4 +146,86 @@ void KisOnionSkinCompositorTest::testSettings()
     QVERIFY(chk.checkDevice(compositeDevice, p.image, "02_single_skin_tinted"));
 }
 
+void KisOnionSkinCompositorTest::testTintedFramesCache()
+{
+    KisImageConfig config(false);
+    config.setOnionSkinTintFactor(64);
+    config.setOnionSkinTintColorBackward(Qt::blue);
+    config.setOnionSkinTintColorForward(Qt::red);
+    config.setNumberOfOnionSkins(2);
+    config.setOnionSkinOpacity(-2, 64);
+    config.setOnionSkinOpacity(-1, 128);
+    config.setOnionSkinOpacity(1, 128);
+    config.setOnionSkinOpacity(2, 64);
+
+    KisOnionSkinCompositor *compositor = KisOnionSkinCompositor::instance();
+    compositor->configChanged();
+
+    TestUtil::MaskParent p;
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    KisPaintDeviceSP paintDevice = p.layer->paintDevice();
+    paintDevice->createKeyframeChannel(KoID());
+    KisRasterKeyframeChannel *keyframes = paintDevice->keyframeChannel();
+
+    const QVector<QColor> colors({Qt::red, Qt::green, Qt::blue, Qt::yellow});
+
+    for (int index = 0; index < colors.size(); index++) {
+        keyframes->addKeyframe(index * 10);
+        i->switchCurrentTimeAsync(index * 10);
+        p.image->waitForDone();
+        paintDevice->fill(QRect(index * 64, 0, 256, 256), KoColor(colors[index], paintDevice->colorSpace()));
+    }
+
+    const QRect rc(0, 0, 512, 256);
+    KisOnionSkinCompositor::TintedFramesCache cache;
+    QPoint errorPoint;
+
+    auto compositeAndCompare = [&] (int time) {
+        i->switchCurrentTimeAsync(time);
+        p.image->waitForDone();
+
+        KisPaintDeviceSP cachedDevice = new KisPaintDevice(p.image->colorSpace());
+        compositor->composite(paintDevice, cachedDevice, rc, &cache);
+
+        KisPaintDeviceSP referenceDevice = new KisPaintDevice(p.image->colorSpace());
+        compositor->composite(paintDevice, referenceDevice, rc);
+
+        return TestUtil::comparePaintDevices(errorPoint, cachedDevice, referenceDevice);
+    };
+
+    const int frame0 = keyframes->keyframeAt<KisRasterKeyframe>(0)->frameID();
+    const int frame30 = keyframes->keyframeAt<KisRasterKeyframe>(30)->frameID();
+
+    // skins: 0 | 20, 30
+    QVERIFY(compositeAndCompare(10));
+    QCOMPARE(cache.frames.size(), 3);
+
+    KisPaintDeviceSP backwardFrame0 = cache.frames.value(qMakePair(frame0, false)).device;
+    KisPaintDeviceSP forwardFrame30 = cache.frames.value(qMakePair(frame30, true)).device;
+    QVERIFY(backwardFrame0);
+    QVERIFY(forwardFrame30);
+
+    // skins: 0, 10 | 30, only frame 10 is tinted again
+    QVERIFY(compositeAndCompare(20));
+    QCOMPARE(cache.frames.size(), 3);
+    QCOMPARE(cache.frames.value(qMakePair(frame0, false)).device.data(), backwardFrame0.data());
+    QCOMPARE(cache.frames.value(qMakePair(frame30, true)).device.data(), forwardFrame30.data());
+
+    // changing the content of a frame invalidates its tinted copy
+    i->switchCurrentTimeAsync(0);
+    p.image->waitForDone();
+    paintDevice->fill(QRect(0, 128, 512, 128), KoColor(Qt::white, paintDevice->colorSpace()));
+    paintDevice->setDirty();
+
+    QVERIFY(compositeAndCompare(20));
+    QVERIFY(cache.frames.value(qMakePair(frame0, false)).device.data() != backwardFrame0.data());
+
+    // changing the config drops all the tinted copies
+    config.setOnionSkinTintColorBackward(Qt::green);
+    compositor->configChanged();
+
+    QVERIFY(compositeAndCompare(20));
+    QVERIFY(cache.frames.value(qMakePair(frame30, true)).device.data() != forwardFrame30.data());
+}
+
 SIMPLE_TEST_MAIN(KisOnionSkinCompositorTest)
@@ -17,6 +17,7 @@ private Q_SLOTS:
 
     void testComposite();
     void testSettings();
+    void testTintedFramesCache();
 };
 
 #endif
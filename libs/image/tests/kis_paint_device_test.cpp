@@ -704,6 +704,30 @@ void KisPaintDeviceTest::testExactBoundsWeirdNullAlphaCase()
     QCOMPARE(dev->exactBounds(), QRect(10,10,10,10));
 }
 
+void KisPaintDeviceTest::testExactBoundsSparse()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->moveTo(13, -7);
+
+    dev->setPixel(-1000, 300, KoColor(Qt::white, cs));
+    dev->setPixel(2000, 1500, KoColor(Qt::white, cs));
+    dev->fill(QRect(500, -900, 3, 5), KoColor(Qt::white, cs));
+
+    QCOMPARE(dev->exactBounds(), QRect(QPoint(-1000, -900), QPoint(2000, 1500)));
+
+    // the allocated, but fully transparent tiles are not counted
+    dev->fill(QRect(-3000, 2000, 100, 100), KoColor(Qt::transparent, cs));
+    dev->setDirty();
+
+    QCOMPARE(dev->exactBounds(), QRect(QPoint(-1000, -900), QPoint(2000, 1500)));
+
+    dev->clear(QRect(-1000, 300, 1, 1));
+    dev->setDirty();
+
+    QCOMPARE(dev->exactBounds(), QRect(QPoint(500, -900), QPoint(2000, 1500)));
+}
+
 void KisPaintDeviceTest::benchmarkExactBoundsNullDefaultPixel()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -1538,6 +1562,65 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+void KisPaintDeviceTest::testLodDeviceIncrementalSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 512, 512);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(rect);
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, rect);
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    // nothing has changed since the sync
+    QVERIFY(dev->regionForLodSyncing().isEmpty());
+
+    // paint on lod0...
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(100, 100, 30, 30), KoColor(Qt::blue, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    QCOMPARE(dev->regionForLodSyncing().boundingRect(), QRect(64, 64, 128, 128));
+
+    // ... and emulate a preview painted by a lodN stroke
+    dev->fill(QRect(10, 10, 5, 5), KoColor(Qt::green, cs));
+    QCOMPARE(dev->regionForLodSyncing().boundingRect(), QRect(0, 0, 192, 192));
+
+    syncLodCache(dev, 1);
+    QVERIFY(dev->regionForLodSyncing().isEmpty());
+
+    KisPaintDeviceSP ref = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *refBounds = new TestingLodDefaultBounds(rect);
+    ref->setDefaultBounds(refBounds);
+    fillGradientDevice(ref, rect);
+    ref->fill(QRect(100, 100, 30, 30), KoColor(Qt::blue, cs));
+
+    refBounds->testingSetLevelOfDetail(1);
+    syncLodCache(ref, 1);
+
+    QCOMPARE(dev->convertToQImage(0, 0, 0, 256, 256),
+             ref->convertToQImage(0, 0, 0, 256, 256));
+
+    // a change of the level of detail falls back to a full sync
+    bounds->testingSetLevelOfDetail(2);
+    QCOMPARE(dev->regionForLodSyncing().boundingRect(), rect);
+
+    // so does disabling the incremental sync...
+    bounds->testingSetLevelOfDetail(1);
+    QVERIFY(dev->regionForLodSyncing().isEmpty());
+
+    KisPaintDevice::setIncrementalLodSyncEnabled(false);
+    QCOMPARE(dev->regionForLodSyncing().boundingRect(), rect);
+    KisPaintDevice::setIncrementalLodSyncEnabled(true);
+
+    // ... and purging the state of the last sync
+    dev->purgeLodSyncState();
+    QCOMPARE(dev->regionForLodSyncing().boundingRect(), rect);
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -36,6 +36,7 @@ private Q_SLOTS:
     void testTranslate();
     void testOpacity();
     void testExactBoundsWeirdNullAlphaCase();
+    void testExactBoundsSparse();
     void benchmarkExactBoundsNullDefaultPixel();
     void testAmortizedExactBounds();
     void testNonDefaultPixelArea();
@@ -53,6 +54,7 @@ private Q_SLOTS:
 
     void testLodTransform();
     void testLodDevice();
+    void testLodDeviceIncrementalSync();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
@@ -363,6 +363,47 @@ dbgKrita << "canary4";
     */
 }
 
+void KisPainterTest::testBltFixedWithUserSelection()
+{
+    const KoColorSpace* cs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace* alpha8 = KoColorSpaceRegistry::instance()->alpha8();
+
+    // the dab crosses the borders of the destination tiles
+    KisFixedPaintDeviceSP src = new KisFixedPaintDevice(cs);
+    src->setRect(QRect(0, 0, 100, 100));
+    src->initialize();
+    src->fill(QRect(0, 0, 100, 100), KoColor(Qt::red, cs));
+
+    KisFixedPaintDeviceSP fixedSelection = new KisFixedPaintDevice(alpha8);
+    fixedSelection->setRect(QRect(0, 0, 100, 100));
+    fixedSelection->initialize();
+    fixedSelection->fill(QRect(0, 30, 100, 70), KoColor(Qt::white, alpha8));
+
+    KisSelectionSP sel = new KisSelection();
+    sel->pixelSelection()->select(QRect(0, 0, 60, 200));
+    sel->updateProjection();
+
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    KisPainter painter(dst);
+    painter.setSelection(sel);
+    painter.bltFixed(30, 30, src, 0, 0, 100, 100);
+    painter.end();
+
+    QCOMPARE(dst->exactBounds(), QRect(30, 30, 30, 100));
+
+    dst->clear();
+    painter.begin(dst);
+    painter.setSelection(sel);
+    painter.bltFixedWithFixedSelection(30, 30, src, fixedSelection, 100, 100);
+    painter.end();
+
+    QCOMPARE(dst->exactBounds(), QRect(30, 60, 30, 70));
+
+    QColor c;
+    dst->pixel(45, 100, &c);
+    QCOMPARE(c, QColor(Qt::red));
+}
+
 void KisPainterTest::testSelectionBitBltEraseCompositeOp()
 {
     const KoColorSpace* cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -36,6 +36,7 @@ private Q_SLOTS:
     void testSelectionBltSelection(); // Square selection
     void testSimpleAlphaCopy();
     void testSelectionBitBltFixedSelection();
+    void testBltFixedWithUserSelection();
     void testSelectionBitBltEraseCompositeOp();
 
     void testBitBltOldData();
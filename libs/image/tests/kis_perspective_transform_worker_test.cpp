@@ -15,6 +15,8 @@
 
 #include "kis_perspectivetransform_worker.h"
 #include "kis_transaction.h"
+#include "kis_random_accessor_ng.h"
+#include "kis_random_sub_accessor.h"
 
 
 class PerspectiveWorkerTester : public TestUtil::QImageBasedTest
@@ -60,4 +62,67 @@ void KisPerspectiveTransformWorkerTest::testSimpleTransform()
     t.checkLayer("simple_transform");
 }
 
+void KisPerspectiveTransformWorkerTest::testPixelAlignedPartialDst_data()
+{
+    QTest::addColumn<QTransform>("transform");
+
+    const QTransform offset = QTransform::fromTranslate(17, -5);
+
+    QTest::newRow("translate") << offset;
+    QTest::newRow("rotate-90") << QTransform().rotate(90) * offset;
+    QTest::newRow("rotate-180") << QTransform().rotate(180) * offset;
+    QTest::newRow("rotate-270") << QTransform().rotate(270) * offset;
+    QTest::newRow("flip-x") << QTransform::fromScale(-1, 1) * offset;
+    QTest::newRow("flip-y") << QTransform::fromScale(1, -1) * offset;
+    QTest::newRow("transpose") << QTransform(0, 1, 1, 0, 0, 0) * offset;
+}
+
+void KisPerspectiveTransformWorkerTest::testPixelAlignedPartialDst()
+{
+    QFETCH(QTransform, transform);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect srcRect(3, 7, 61, 43);
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+
+    {
+        KisRandomAccessorSP it = src->createRandomAccessorNG();
+        for (int y = srcRect.top(); y <= srcRect.bottom(); y++) {
+            for (int x = srcRect.left(); x <= srcRect.right(); x++) {
+                it->moveTo(x, y);
+                const QColor color(x * 4 % 256, y * 5 % 256, (x * y) % 256, 255);
+                memcpy(it->rawData(), KoColor(color, cs).data(), cs->pixelSize());
+            }
+        }
+    }
+
+    const QRect dstRect = transform.mapRect(srcRect);
+
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+
+    KisPerspectiveTransformWorker worker(0, transform, true, 0);
+    worker.setForceSubPixelTranslation(true);
+    worker.runPartialDst(src, dst, dstRect);
+
+    KisRandomSubAccessorSP srcAcc = src->createRandomSubAccessor();
+    KisRandomConstAccessorSP dstIt = dst->createRandomConstAccessorNG();
+    const QTransform backwardTransform = transform.inverted();
+
+    QVector<quint8> expected(cs->pixelSize());
+
+    for (int y = dstRect.top(); y <= dstRect.bottom(); y++) {
+        for (int x = dstRect.left(); x <= dstRect.right(); x++) {
+            const QPointF srcPoint = backwardTransform.map(QPointF(x, y));
+            srcAcc->moveTo(srcPoint.x(), srcPoint.y());
+            srcAcc->sampledOldRawData(expected.data());
+
+            dstIt->moveTo(x, y);
+            if (memcmp(dstIt->rawDataConst(), expected.constData(), cs->pixelSize())) {
+                QFAIL(QString("Pixel mismatch at (%1, %2)").arg(x).arg(y).toLatin1());
+            }
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisPerspectiveTransformWorkerTest)
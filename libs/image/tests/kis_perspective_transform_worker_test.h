@@ -14,6 +14,8 @@ class KisPerspectiveTransformWorkerTest : public QObject
     Q_OBJECT
 private Q_SLOTS:
     void testSimpleTransform();
+    void testPixelAlignedPartialDst_data();
+    void testPixelAlignedPartialDst();
 };
 
 #endif /* __KIS_PERSPECTIVE_TRANSFORM_WORKER_TEST_H */
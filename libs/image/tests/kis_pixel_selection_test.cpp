@@ -26,6 +26,7 @@
 #include "kis_transaction.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "commands/kis_selection_commands.h"
+#include "kis_selection_filters.h"
 
 
 void KisPixelSelectionTest::testCreation()
@@ -580,5 +581,36 @@ void KisPixelSelectionTest::testOutlineArtifacts()
                    QPoint(0,0)})}));
 }
 
+void KisPixelSelectionTest::testGrowShrink()
+{
+    const QRect processRect(0, 0, 500, 2000);
+    const QRect selectedRect(100, 50, 300, 1900);
+    const int radius = 20;
+
+    KisPixelSelectionSP sel = new KisPixelSelection();
+    sel->select(selectedRect);
+
+    KisGrowSelectionFilter growFilter(radius, radius);
+    growFilter.process(sel, processRect);
+    QCOMPARE(sel->selectedExactRect(), kisGrowRect(selectedRect, radius));
+
+    KisShrinkSelectionFilter shrinkFilter(radius, radius, false);
+    shrinkFilter.process(sel, processRect);
+    QCOMPARE(sel->selectedExactRect(), selectedRect);
+    QVERIFY(sel->isTotallyUnselected(QRect(0, 0, 500, 50)));
+    QVERIFY(!sel->isTotallyUnselected(QRect(100, 1000, 1, 1)));
+}
+
+void KisPixelSelectionTest::testSymmetricDifferenceSelection()
+{
+    KisPixelSelectionSP sel1 = new KisPixelSelection();
+    KisPixelSelectionSP sel2 = new KisPixelSelection();
+    sel1->select(QRect(0, 0, 500, 500));
+    sel2->select(QRect(250, 0, 500, 500));
+    sel1->applySelection(sel2, SELECTION_SYMMETRICDIFFERENCE);
+    QCOMPARE(sel1->selectedExactRect(), QRect(0, 0, 750, 500));
+    QVERIFY(sel1->isTotallyUnselected(QRect(250, 0, 250, 500)));
+}
+
 KISTEST_MAIN(KisPixelSelectionTest)
 
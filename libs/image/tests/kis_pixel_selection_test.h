@@ -35,6 +35,9 @@ private Q_SLOTS:
     void testOutlineCacheTransactions();
 
     void testOutlineArtifacts();
+
+    void testGrowShrink();
+    void testSymmetricDifferenceSelection();
 };
 
 #endif
@@ -356,4 +356,46 @@ void KisScanlineFillTest::testGapClosingFill()
     testGapClosingFillGeneral(QPoint(147, 97), 32);
 }
 
+void KisScanlineFillTest::testGapClosingFillOnChangedDevice()
+{
+    const KoColorSpace* cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    QImage srcImage(TestUtil::fetchDataFileLazy("close_gap_low.png"));
+    QVERIFY(!srcImage.isNull());
+
+    const QRect imageRect = srcImage.rect();
+    const QPoint seed(103, 94);
+
+    dev->convertFromQImage(srcImage, 0, 0, 0);
+
+    auto fillWithGap = [&] (int gapSize) {
+        KisPixelSelectionSP pixelSelection = new KisPixelSelection(new KisSelectionDefaultBounds(dev));
+
+        KisScanlineFill gc(dev, seed, imageRect);
+        gc.setThreshold(1);
+        gc.setOpacitySpread(100);
+        gc.setCloseGap(gapSize);
+        gc.fillSelection(pixelSelection);
+
+        return pixelSelection->convertToQImage(0,
+                                               imageRect.x(), imageRect.y(),
+                                               imageRect.width(), imageRect.height());
+    };
+
+    // the gap map of this fill is reused by the next one
+    fillWithGap(3);
+
+    // close the gap on the right side of the seed with a line
+    dev->fill(QRect(110, 60, 3, 60), KoColor(Qt::black, cs));
+
+    const QImage reusedMapResult = fillWithGap(3);
+
+    // a fill with other parameters replaces the cached map
+    fillWithGap(4);
+    const QImage newMapResult = fillWithGap(3);
+
+    QCOMPARE(reusedMapResult, newMapResult);
+}
+
 SIMPLE_TEST_MAIN(KisScanlineFillTest)
@@ -28,6 +28,7 @@ private Q_SLOTS:
     void testExternalFill();
 
     void testGapClosingFill();
+    void testGapClosingFillOnChangedDevice();
 
 private:
     void testFillGeneral(const QVector<KisFillInterval> &initialBackwardIntervals,
@@ -140,6 +140,45 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testSplitAdaptive()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,0,1000,1000);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    /**
+     * With 8 threads a full refresh should be split into at
+     * least 16 tile-aligned patches
+     */
+    queue.setThreadsLimit(8);
+    queue.addFullRefreshJob(paintLayer, dirtyRect1, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 16);
+
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,256,256)));
+    QVERIFY(checkWalker(walkersList[3], QRect(768,0,232,256)));
+    QVERIFY(checkWalker(walkersList[15], QRect(768,768,232,232)));
+
+    queue.optimize();
+
+    // the patches should not be joined back
+
+    QCOMPARE(walkersList.size(), 16);
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,256,256)));
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -242,6 +281,51 @@ void KisSimpleUpdateQueueTest::testMixingTypes()
     QCOMPARE(walkersList[5]->clonesDontInvalidateFrames(), true);
 }
 
+void KisSimpleUpdateQueueTest::testExcludePendingAreas()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    // the rects are too different to be merged
+    QRect dirtyRect1(0,0,300,100);
+    QRect dirtyRect2(0,0,100,300);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+    queue.addUpdateJob(paintLayer, dirtyRect2, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+
+    /**
+     * The first walker fully covers the top row of tiles of the
+     * second rect, so it is dropped from the second walker
+     */
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,300,100)));
+    QVERIFY(checkWalker(walkersList[1], QRect(0,64,100,236)));
+
+    // a different node invalidates different layers, no dropping
+    KisPaintLayerSP paintLayer2 = new KisPaintLayer(image, "test2", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer2);
+    image->unlock();
+
+    queue.addUpdateJob(paintLayer2, dirtyRect2, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 3);
+    QVERIFY(checkWalker(walkersList[2], QRect(0,0,100,300)));
+}
+
 void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
 {
     KisTestableSimpleUpdateQueue queue;
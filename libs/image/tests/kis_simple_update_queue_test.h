@@ -21,8 +21,10 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testSplitAdaptive();
     void testChecksum();
     void testMixingTypes();
+    void testExcludePendingAreas();
     void testSpontaneousJobsCompression();
 };
 
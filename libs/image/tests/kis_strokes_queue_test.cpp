@@ -6,6 +6,7 @@
 
 #include "kis_strokes_queue_test.h"
 #include <simpletest.h>
+#include <QThread>
 
 #include "kistest.h"
 
@@ -1126,5 +1127,134 @@ void KisStrokesQueueTest::testUniquelyConcurrentJobs()
     queue.endStroke(id1);
 }
 
+void KisStrokesQueueTest::testConcurrentProcessQueueRequests()
+{
+    KisStrokesQueue queue;
+    KisStrokeId id = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("tri_"), false));
+    for (int i = 0; i < 8; i++) {
+        queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    }
+    queue.endStroke(id);
+
+    KisTestableUpdaterContext context(4);
+    QVector<KisUpdateJobItem*> jobs;
+
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "tri_init");
+    VERIFY_EMPTY(jobs[1]);
+
+    /**
+     * Several threads request the queue processing at once. Some of
+     * the requests are collapsed into the one being executed, but
+     * the spare threads of the context should still be filled.
+     */
+    auto requestProcessing = [&] () {
+        QVector<QThread*> threads;
+        for (int i = 0; i < 4; i++) {
+            threads << QThread::create([&] () { queue.processQueue(context, false); });
+        }
+        Q_FOREACH (QThread *thread, threads) {
+            thread->start();
+        }
+        Q_FOREACH (QThread *thread, threads) {
+            thread->wait();
+            delete thread;
+        }
+    };
+
+    for (int pass = 0; pass < 2; pass++) {
+        context.clear();
+        requestProcessing();
+
+        jobs = context.getJobs();
+        COMPARE_NAME(jobs[0], "tri_dab");
+        COMPARE_NAME(jobs[1], "tri_dab");
+        COMPARE_NAME(jobs[2], "tri_dab");
+        COMPARE_NAME(jobs[3], "tri_dab");
+    }
+
+    context.clear();
+    requestProcessing();
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "tri_finish");
+    VERIFY_EMPTY(jobs[1]);
+    VERIFY_EMPTY(jobs[2]);
+    VERIFY_EMPTY(jobs[3]);
+}
+
+
+class KisBackgroundTestingStrokeStrategy : public KisTestingStrokeStrategy
+{
+public:
+    KisBackgroundTestingStrokeStrategy(const QLatin1String &prefix)
+        : KisTestingStrokeStrategy(prefix, false)
+    {
+        setPriority(BACKGROUND_PRIORITY);
+    }
+};
+
+void KisStrokesQueueTest::testBackgroundPriority()
+{
+    KisStrokesQueue queue;
+    KisStrokeId id = queue.startStroke(new KisBackgroundTestingStrokeStrategy(QLatin1String("bg_")));
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(id);
+
+    KisTestableUpdaterContext context(2);
+    QVector<KisUpdateJobItem*> jobs;
+
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_init");
+    VERIFY_EMPTY(jobs[1]);
+
+    // the background stroke should yield to the pending updates
+    context.clear();
+    queue.processQueue(context, true);
+
+    jobs = context.getJobs();
+    VERIFY_EMPTY(jobs[0]);
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    COMPARE_NAME(jobs[1], "bg_dab");
+
+    // a waiting stroke of normal priority makes the background one hurry up
+    KisStrokeId id2 = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("nor_")));
+    queue.addJob(id2, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(id2);
+
+    context.clear();
+    queue.processQueue(context, true);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, true);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_finish");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, true);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "nor_init");
+    VERIFY_EMPTY(jobs[1]);
+}
+
 
 KISTEST_MAIN(KisStrokesQueueTest)
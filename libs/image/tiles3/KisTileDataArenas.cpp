@@ -0,0 +1,212 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataArenas.h"
+
+#include <QGlobalStatic>
+
+#include "kis_debug.h"
+#include "KisNumaTopology.h"
+
+Q_GLOBAL_STATIC(KisTileDataArenas, s_instance)
+
+namespace {
+const int NUM_SIZE_CLASSES = 3;
+}
+
+struct KisTileDataArenas::Arena
+{
+    Arena(KisTileDataArenas *_registry, int _scale = 1)
+        : registry(_registry),
+          scale(_scale)
+    {
+    }
+
+    /**
+     * Called by QThreadStorage when the thread exits
+     */
+    ~Arena() {
+        /**
+         * If the registry is already dead, the application is
+         * going down, so the buffers will be freed with the
+         * global pool anyway. The node arenas have no registry
+         * and are destroyed only together with it.
+         */
+        if (!registry || s_instance.isDestroyed()) return;
+
+        registry->unregisterArena(this);
+    }
+
+    void takeSurplus(int numRetained, QVector<QPair<quint8*, qint32>> &surplus) {
+        QMutexLocker l(&lock);
+
+        for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+            while (buffers[i].size() > numRetained * scale) {
+                surplus.append(qMakePair(buffers[i].takeLast(), qint32(4 << i)));
+            }
+        }
+    }
+
+    KisTileDataArenas *registry;
+
+    /**
+     * The node arenas are shared by all the threads of the node,
+     * so they keep proportionally more buffers
+     */
+    const int scale;
+
+    /**
+     * The lock is almost never contended: only the owner thread
+     * and the rebalancing code ever take it
+     */
+    QMutex lock;
+    QVector<quint8*> buffers[NUM_SIZE_CLASSES];
+};
+
+KisTileDataArenas::KisTileDataArenas()
+{
+    KisNumaTopology *numa = KisNumaTopology::instance();
+
+    if (numa->isEnabled()) {
+        for (int node = 0; node < numa->numNodes(); node++) {
+            Arena *arena = new Arena(nullptr, numa->numCpusOnNode(node));
+            m_nodeArenas.append(arena);
+            m_arenas.append(arena);
+        }
+    }
+}
+
+KisTileDataArenas::~KisTileDataArenas()
+{
+    /**
+     * The arenas of the threads that are still alive are
+     * destroyed by QThreadStorage later, when the threads
+     * exit; their buffers are freed with the global pool
+     */
+
+    qDeleteAll(m_nodeArenas);
+}
+
+KisTileDataArenas* KisTileDataArenas::instance()
+{
+    return s_instance;
+}
+
+void KisTileDataArenas::setGlobalFreeFunc(GlobalFreeFunc func)
+{
+    m_globalFreeFunc = func;
+}
+
+inline int KisTileDataArenas::sizeClass(qint32 pixelSize)
+{
+    switch (pixelSize) {
+    case 4:
+        return 0;
+    case 8:
+        return 1;
+    case 16:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+KisTileDataArenas::Arena* KisTileDataArenas::localArena()
+{
+    if (!m_localArena.hasLocalData()) {
+        Arena *arena = new Arena(this);
+
+        {
+            QMutexLocker l(&m_registryLock);
+            m_arenas.append(arena);
+        }
+
+        m_localArena.setLocalData(arena);
+    }
+
+    return m_localArena.localData();
+}
+
+KisTileDataArenas::Arena* KisTileDataArenas::nodeArena(int numaNode)
+{
+    return numaNode >= 0 && numaNode < m_nodeArenas.size() ?
+        m_nodeArenas[numaNode] : localArena();
+}
+
+bool KisTileDataArenas::pop(qint32 pixelSize, quint8 *&ptr)
+{
+    const int index = sizeClass(pixelSize);
+    if (index < 0) return false;
+
+    Arena *arena = m_nodeArenas.isEmpty() ?
+        localArena() : nodeArena(KisNumaTopology::instance()->currentNode());
+    QMutexLocker l(&arena->lock);
+
+    if (arena->buffers[index].isEmpty()) return false;
+
+    ptr = arena->buffers[index].takeLast();
+    return true;
+}
+
+bool KisTileDataArenas::push(qint32 pixelSize, quint8 *ptr, int numaNode)
+{
+    const int index = sizeClass(pixelSize);
+    if (index < 0) return false;
+
+    Arena *arena = m_nodeArenas.isEmpty() ? localArena() : nodeArena(numaNode);
+    QMutexLocker l(&arena->lock);
+
+    if (arena->buffers[index].size() >= MAX_BUFFERS * arena->scale) return false;
+
+    arena->buffers[index].append(ptr);
+    return true;
+}
+
+void KisTileDataArenas::rebalance()
+{
+    trimArenas(RETAINED_BUFFERS);
+}
+
+void KisTileDataArenas::drainAll()
+{
+    trimArenas(0);
+}
+
+void KisTileDataArenas::trimArenas(int numRetained)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_globalFreeFunc);
+
+    QVector<QPair<quint8*, qint32>> surplus;
+
+    {
+        QMutexLocker l(&m_registryLock);
+
+        Q_FOREACH (Arena *arena, m_arenas) {
+            arena->takeSurplus(numRetained, surplus);
+        }
+    }
+
+    for (auto it = surplus.begin(); it != surplus.end(); ++it) {
+        m_globalFreeFunc(it->first, it->second);
+    }
+}
+
+void KisTileDataArenas::unregisterArena(Arena *arena)
+{
+    {
+        QMutexLocker l(&m_registryLock);
+        m_arenas.removeOne(arena);
+    }
+
+    QVector<QPair<quint8*, qint32>> surplus;
+    arena->takeSurplus(0, surplus);
+
+    if (m_globalFreeFunc) {
+        for (auto it = surplus.begin(); it != surplus.end(); ++it) {
+            m_globalFreeFunc(it->first, it->second);
+        }
+    }
+}
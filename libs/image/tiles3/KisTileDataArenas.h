@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDATAARENAS_H
+#define KISTILEDATAARENAS_H
+
+#include <QMutex>
+#include <QList>
+#include <QVector>
+#include <QThreadStorage>
+
+#include "kritaimage_export.h"
+
+/**
+ * Per-thread caches of the standard tile data buffers (one tile of
+ * 4, 8 or 16 bytes per pixel).
+ *
+ * When many threads allocate and free tiles at once (e.g. during
+ * merge jobs of KisUpdaterContext or massive fills), the global pool
+ * becomes a serialization point. Each thread keeps a few free buffers
+ * of its own in an arena, so most of the allocations don't touch any
+ * shared memory at all.
+ *
+ * Since tiles are often freed in a different thread than they were
+ * allocated in, the arenas may accumulate buffers. KisTileDataPooler
+ * calls rebalance() periodically to return the surplus buffers back
+ * to the global pool.
+ *
+ * In NUMA-aware mode (see KisNumaTopology) the arenas are kept per
+ * NUMA node instead of per thread. A buffer is returned to the arena
+ * of the node it has been allocated on, so it is reused only by the
+ * threads of the same node.
+ */
+class KRITAIMAGE_EXPORT KisTileDataArenas
+{
+public:
+    /**
+     * A function that returns the buffer to the global pool
+     */
+    typedef void (*GlobalFreeFunc)(quint8 *ptr, qint32 pixelSize);
+
+    static const int MAX_BUFFERS = 32;
+    static const int RETAINED_BUFFERS = 8;
+
+public:
+    KisTileDataArenas();
+    ~KisTileDataArenas();
+
+    static KisTileDataArenas* instance();
+
+    void setGlobalFreeFunc(GlobalFreeFunc func);
+
+    /**
+     * Takes a buffer from the arena of the current thread
+     * \return false if there is no suitable buffer
+     */
+    bool pop(qint32 pixelSize, quint8 *&ptr);
+
+    /**
+     * Puts the buffer into the arena of the current thread, or
+     * into the arena of \p numaNode in NUMA-aware mode
+     * \return false if the arena cannot accept the buffer
+     *         and it should be freed globally
+     */
+    bool push(qint32 pixelSize, quint8 *ptr, int numaNode = -1);
+
+    /**
+     * Returns the buffers exceeding RETAINED_BUFFERS in every
+     * arena to the global pool
+     */
+    void rebalance();
+
+    /**
+     * Returns all the arena buffers to the global pool. Should be
+     * called before the global pool is purged.
+     */
+    void drainAll();
+
+private:
+    struct Arena;
+    friend struct Arena;
+
+    static inline int sizeClass(qint32 pixelSize);
+    Arena* localArena();
+    Arena* nodeArena(int numaNode);
+
+    void trimArenas(int numRetained);
+    void unregisterArena(Arena *arena);
+
+private:
+    Q_DISABLE_COPY(KisTileDataArenas)
+
+    QMutex m_registryLock;
+    QList<Arena*> m_arenas;
+    QThreadStorage<Arena*> m_localArena;
+    QVector<Arena*> m_nodeArenas;
+    GlobalFreeFunc m_globalFreeFunc = nullptr;
+};
+
+#endif // KISTILEDATAARENAS_H
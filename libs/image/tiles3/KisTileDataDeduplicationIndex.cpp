@@ -0,0 +1,80 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataDeduplicationIndex.h"
+
+#include <QHashFunctions>
+#include <cstring>
+
+#include "kis_tile_data.h"
+
+
+KisTileDataDeduplicationIndex::KisTileDataDeduplicationIndex()
+{
+}
+
+KisTileDataDeduplicationIndex::~KisTileDataDeduplicationIndex()
+{
+    Q_FOREACH (KisTileData *td, m_index) {
+        td->release();
+    }
+}
+
+KisTileData* KisTileDataDeduplicationIndex::findOrAdd(KisTileData *td)
+{
+    if (!td->m_swapLock.tryLockForRead()) return nullptr;
+
+    if (!td->data()) {
+        td->m_swapLock.unlock();
+        return nullptr;
+    }
+
+    const int dataSize = td->pixelSize() * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const quint64 key = qHashBits(td->data(), dataSize, td->pixelSize());
+
+    KisTileData *result = nullptr;
+
+    auto it = m_index.find(key);
+    while (it != m_index.end() && it.key() == key) {
+        KisTileData *candidate = it.value();
+
+        if (candidate == td) {
+            result = td;
+            break;
+        }
+
+        if (candidate->pixelSize() == td->pixelSize() &&
+            candidate->m_swapLock.tryLockForRead()) {
+
+            const bool isSame =
+                candidate->data() &&
+                !memcmp(candidate->data(), td->data(), dataSize);
+
+            candidate->m_swapLock.unlock();
+
+            if (isSame) {
+                result = candidate;
+                break;
+            }
+        }
+
+        ++it;
+    }
+
+    if (!result) {
+        td->acquire();
+        m_index.insert(key, td);
+        result = td;
+    }
+
+    td->m_swapLock.unlock();
+    return result;
+}
+
+int KisTileDataDeduplicationIndex::size() const
+{
+    return m_index.size();
+}
@@ -0,0 +1,55 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDATADEDUPLICATIONINDEX_H
+#define KISTILEDATADEDUPLICATIONINDEX_H
+
+#include <QMultiHash>
+
+#include "kritaimage_export.h"
+
+class KisTileData;
+
+/**
+ * A content index of tile data objects used by a single
+ * deduplication pass of KisTileDataStore.
+ *
+ * Every tile data added to the index is acquired by the
+ * index as if it was one more user of it. It makes the data
+ * immutable while the index exists, because any tile trying
+ * to write into it will have to do copy-on-write first.
+ * Therefore, the index should be short-living, otherwise
+ * it will cause unnecessary COWs.
+ */
+class KRITAIMAGE_EXPORT KisTileDataDeduplicationIndex
+{
+public:
+    KisTileDataDeduplicationIndex();
+    ~KisTileDataDeduplicationIndex();
+
+    /**
+     * Searches for a tile data with exactly the same content as \p td.
+     * If there is no such data in the index yet, \p td itself is added
+     * to the index and returned.
+     *
+     * \return the tile data that should be shared instead of \p td or
+     *         nullptr if \p td cannot be processed right now (e.g. it
+     *         is swapped out)
+     *
+     * PRECONDITIONS: the content of \p td is guaranteed to be not
+     *                changed during the call, i.e. no one has write
+     *                access to it
+     */
+    KisTileData* findOrAdd(KisTileData *td);
+
+    int size() const;
+
+private:
+    Q_DISABLE_COPY(KisTileDataDeduplicationIndex)
+    QMultiHash<quint64, KisTileData*> m_index;
+};
+
+#endif // KISTILEDATADEDUPLICATIONINDEX_H
@@ -0,0 +1,131 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileSavingCache.h"
+
+#include <QHash>
+#include <QHashFunctions>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "kis_tile_data.h"
+
+namespace {
+
+struct TileKey
+{
+    quint64 revision;
+    qint32 col;
+    qint32 row;
+
+    bool operator==(const TileKey &rhs) const {
+        return revision == rhs.revision && col == rhs.col && row == rhs.row;
+    }
+};
+
+inline uint qHash(const TileKey &key, uint seed = 0)
+{
+    return ::qHash(key.revision, seed) ^ ::qHash(key.col << 16) ^ ::qHash(key.row);
+}
+
+struct TileEntry
+{
+    QByteArray data;
+    int pass = 0;
+};
+
+const qint64 defaultMemoryLimit = 512 * 1024 * 1024;
+
+}
+
+struct KisTileSavingCache::Private
+{
+    mutable QMutex mutex;
+    QHash<TileKey, TileEntry> entries;
+    int currentPass = 0;
+    qint64 memoryUsage = 0;
+    qint64 memoryLimit = defaultMemoryLimit;
+
+};
+
+KisTileSavingCache::KisTileSavingCache()
+    : m_d(new Private)
+{
+}
+
+KisTileSavingCache::~KisTileSavingCache()
+{
+}
+
+void KisTileSavingCache::beginPass()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->currentPass++;
+}
+
+void KisTileSavingCache::endPass()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    auto it = m_d->entries.begin();
+    while (it != m_d->entries.end()) {
+        if (it->pass != m_d->currentPass) {
+            m_d->memoryUsage -= it->data.size();
+            it = m_d->entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool KisTileSavingCache::fetch(KisTileData *td, qint32 col, qint32 row, QByteArray *data)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    auto it = m_d->entries.find({td->revision(), col, row});
+    if (it == m_d->entries.end()) return false;
+
+    it->pass = m_d->currentPass;
+    *data = it->data;
+    return true;
+}
+
+void KisTileSavingCache::insert(KisTileData *td, qint32 col, qint32 row, const QByteArray &data)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->memoryUsage + data.size() > m_d->memoryLimit) return;
+
+    const TileKey key = {td->revision(), col, row};
+    if (m_d->entries.contains(key)) return;
+
+    m_d->entries.insert(key, {data, m_d->currentPass});
+    m_d->memoryUsage += data.size();
+}
+
+void KisTileSavingCache::setMemoryLimit(qint64 bytes)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->memoryLimit = bytes;
+}
+
+qint64 KisTileSavingCache::memoryLimit() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->memoryLimit;
+}
+
+qint64 KisTileSavingCache::memoryUsage() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->memoryUsage;
+}
+
+int KisTileSavingCache::numEntries() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->entries.size();
+}
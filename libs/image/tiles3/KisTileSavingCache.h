@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILESAVINGCACHE_H
+#define KISTILESAVINGCACHE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+#include "kritaimage_export.h"
+
+class KisTileData;
+
+/**
+ * A cache of the serialized tiles that lives between the savings of
+ * the same document (e.g. between two autosaves).
+ *
+ * The entries are keyed by the revision of the tile data and the
+ * position of the tile, see KisTileData::revision(). The revision
+ * changes on every write into the data, so a matching entry means
+ * that the content hasn't changed since the previous saving, and its
+ * compressed representation can be written as it is.
+ *
+ * The cache keeps only the serialized bytes and never holds the tile
+ * data itself, so it neither keeps the old versions of the changed
+ * tiles in memory nor prevents them from being swapped out.
+ *
+ * The entries that haven't been used by the latest saving pass are
+ * dropped in endPass(), so the cache keeps only the tiles of the
+ * latest version of the document.
+ *
+ * The cache is thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisTileSavingCache
+{
+public:
+    KisTileSavingCache();
+    ~KisTileSavingCache();
+
+    /**
+     * Starts a new saving pass
+     */
+    void beginPass();
+
+    /**
+     * Drops the entries that haven't been fetched or inserted
+     * since the latest call to beginPass()
+     */
+    void endPass();
+
+    /**
+     * Fetches the serialized data of a tile with data \p td at the
+     * position (\p col, \p row)
+     *
+     * \return true if the tile is present in the cache
+     */
+    bool fetch(KisTileData *td, qint32 col, qint32 row, QByteArray *data);
+
+    /**
+     * Stores the serialized data of a tile. The data is not stored if
+     * it doesn't fit into the memory limit of the cache.
+     */
+    void insert(KisTileData *td, qint32 col, qint32 row, const QByteArray &data);
+
+    /**
+     * Sets the max total size of the stored data. Zero disables the cache.
+     */
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const;
+
+    qint64 memoryUsage() const;
+    int numEntries() const;
+
+private:
+    Q_DISABLE_COPY(KisTileSavingCache)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+typedef QSharedPointer<KisTileSavingCache> KisTileSavingCacheSP;
+
+#endif // KISTILESAVINGCACHE_H
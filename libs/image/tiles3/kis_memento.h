@@ -10,6 +10,7 @@
 
 #include <QtGlobal>
 #include <QRect>
+#include <QAtomicInteger>
 
 #include "kis_global.h"
 
@@ -64,6 +65,14 @@ public:
         return QRect(x, y, w, h);
     }
 
+    /**
+     * The size (in bytes) of the tile data committed to the
+     * revision of this memento. Known after the commit only.
+     */
+    inline qint64 memoryCost() const {
+        return m_memoryCost.loadAcquire();
+    }
+
     void saveOldDefaultPixel(const quint8* pixel, quint32 pixelSize) {
         m_oldDefaultPixel = new quint8[pixelSize];
         memcpy(m_oldDefaultPixel, pixel, pixelSize);
@@ -85,6 +94,13 @@ public:
 private:
     friend class KisMementoManager;
 
+    inline void resetExtent() {
+        m_extentMinX = qint32_MAX;
+        m_extentMinY = qint32_MAX;
+        m_extentMaxX = qint32_MIN;
+        m_extentMaxY = qint32_MIN;
+    }
+
     inline void updateExtent(qint32 col, qint32 row, QMutex *currentMementoExtentLock) {
         const qint32 tileMinX = col * KisTileData::WIDTH;
         const qint32 tileMinY = row * KisTileData::HEIGHT;
@@ -116,6 +132,8 @@ private:
     qint32 m_extentMaxX;
     qint32 m_extentMinY;
     qint32 m_extentMaxY;
+
+    QAtomicInteger<qint64> m_memoryCost {0};
 };
 
 #endif // KIS_MEMENTO_H_
@@ -173,6 +173,9 @@ public:
     inline KisTileData* tileData() const {
         return m_tileData;
     }
+    inline bool isCommitted() const {
+        return m_committedFlag;
+    }
 
     void debugPrintInfo() {
         QString s = QString("------\n"
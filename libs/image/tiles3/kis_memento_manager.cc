@@ -5,6 +5,8 @@
  */
 
 #include <QtGlobal>
+#include <cstring>
+#include <QVector>
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 
@@ -183,35 +185,148 @@ void KisMementoManager::commit()
     KisMementoItemSP mi;
     KisMementoItemSP parentMI;
     bool newTile;
+    qint64 memoryCost = 0;
+    bool hasDroppedTiles = false;
+
+    const bool dropUnchangedTiles =
+        KisTileDataStore::instance()->dropUnchangedUndoTiles();
 
     KisMementoItemHashTableIterator iter(&m_index);
     while ((mi = iter.tile())) {
         parentMI = m_headsHashTable.getTileLazy(mi->col(), mi->row(), newTile);
 
+        if (dropUnchangedTiles && isUnchangedTile(mi, parentMI)) {
+            /**
+             * The tile has been COW'ed by a writer, but all the pixels
+             * are still the same, e.g. an eraser over an empty area.
+             * Don't add it to the revision, but still commit it and
+             * make it the new head: its tile data must stay shared with
+             * the history to let the next writer COW it and register
+             * the change again. Nothing will ever roll back to its
+             * parent, so the parent is not linked.
+             */
+            mi->commit();
+            m_headsHashTable.deleteTile(mi->col(), mi->row());
+            iter.moveCurrentToHashTable(&m_headsHashTable);
+            hasDroppedTiles = true;
+            continue;
+        }
+
         mi->setParent(parentMI);
         mi->commit();
         revisionList.append(mi);
 
+        if (mi->type() == KisMementoItem::CHANGED && mi->tileData()) {
+            memoryCost += qint64(mi->tileData()->pixelSize()) * KisTileData::WIDTH * KisTileData::HEIGHT;
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
         //iter.next(); // previous line does this for us
     }
 
+    if (hasDroppedTiles && m_currentMemento) {
+        m_currentMemento->resetExtent();
+        Q_FOREACH (const KisMementoItemSP &item, revisionList) {
+            m_currentMemento->updateExtent(item->col(), item->row(), &m_currentMementoExtentLock);
+        }
+    }
+
     KisHistoryItem hItem;
     hItem.itemList = revisionList;
     hItem.memento = m_currentMemento.data();
     m_revisions.append(hItem);
 
+    if (m_currentMemento) {
+        m_currentMemento->m_memoryCost.storeRelease(memoryCost);
+    }
+
     m_currentMemento = 0;
     KIS_ASSERT(m_index.isEmpty());
 
     DEBUG_DUMP_MESSAGE("COMMIT_DONE");
 
+    swapOutOldRevision();
+
     // Waking up pooler to prepare copies for us
     KisTileDataStore::instance()->kickPooler();
 }
 
+bool KisMementoManager::isUnchangedTile(KisMementoItemSP mi, KisMementoItemSP parentMI) const
+{
+    /**
+     * Already committed items come from rollforward(), they
+     * have been checked on their first commit
+     */
+    if (mi->isCommitted() || mi->type() != KisMementoItem::CHANGED) return false;
+
+    KisTileData *td = mi->tileData();
+    KisTileData *parentTd = parentMI->tileData();
+
+    if (!td || !parentTd) return false;
+    if (td->pixelSize() != parentTd->pixelSize()) return false;
+
+    /**
+     * A deleted parent stores the default pixel of the device. If the
+     * default pixel has been changed by the transaction, the tile
+     * must be kept in the revision even if it equals to the parent,
+     * because undoing the transaction restores the old default pixel.
+     */
+    if (parentMI->type() == KisMementoItem::DELETED && m_currentMemento) {
+        const quint8 *oldDefaultPixel = m_currentMemento->oldDefaultPixel();
+        const quint8 *newDefaultPixel = m_currentMemento->newDefaultPixel();
+
+        if (!oldDefaultPixel || !newDefaultPixel ||
+            memcmp(oldDefaultPixel, newDefaultPixel, td->pixelSize())) {
+
+            return false;
+        }
+    }
+
+    if (td == parentTd) return true;
+
+    td->blockSwapping();
+    parentTd->blockSwapping();
+
+    const bool isSame =
+        !memcmp(td->data(), parentTd->data(),
+                td->pixelSize() * KisTileData::WIDTH * KisTileData::HEIGHT);
+
+    parentTd->unblockSwapping();
+    td->unblockSwapping();
+
+    return isSame;
+}
+
+void KisMementoManager::swapOutOldRevision()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    const int depth = store->undoSwapOutDepth();
+    if (depth <= 0 || m_revisions.size() <= depth) return;
+
+    /**
+     * Every commit pushes exactly one revision out of the window
+     * of the recent ones, so there is no need to check the older
+     * revisions: they have been passed to the swapper already
+     */
+    const KisHistoryItem &revision = m_revisions[m_revisions.size() - 1 - depth];
+
+    QVector<KisTileData*> tiles;
+    tiles.reserve(revision.itemList.size());
+
+    Q_FOREACH (const KisMementoItemSP &mi, revision.itemList) {
+        KisTileData *td = mi->tileData();
+        if (mi->type() != KisMementoItem::CHANGED || !td || !td->historical()) continue;
+
+        td->ref();
+        tiles.append(td);
+    }
+
+    store->swapOutHistoricalTileData(tiles);
+}
+
 KisTileSP KisMementoManager::getCommittedTile(qint32 col, qint32 row, bool &existingTile)
 {
     /**
@@ -277,6 +392,7 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
     KisMementoItemSP mi;
     KisMementoItemSP parentMI;
     KisMementoItemList::iterator iter;
+    QVector<KisTileData*> swappedTiles;
 
     blockRegistration();
     forEachReversed(iter, changeList.itemList) {
@@ -291,6 +407,16 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
         m_headsHashTable.deleteTile(parentMI->col(), parentMI->row());
         m_headsHashTable.addTile(parentMI);
 
+        /**
+         * The restored tiles of the old revisions may be swapped out,
+         * let the prefetcher load them before the device is updated
+         */
+        KisTileData *td = parentMI->tileData();
+        if (parentMI->type() == KisMementoItem::CHANGED && td && !td->data()) {
+            td->ref();
+            swappedTiles.append(td);
+        }
+
         // This is not necessary
         //mi->setParent(0);
     }
@@ -315,6 +441,8 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
     m_cancelledRevisions.prepend(changeList);
     DEBUG_DUMP_MESSAGE("UNDONE");
 
+    KisTileDataStore::instance()->prefetchTileData(swappedTiles);
+
     // Waking up pooler to prepare copies for us
     KisTileDataStore::instance()->kickPooler();
 }
@@ -118,6 +118,19 @@ protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
 
+    /**
+     * Pushes the tile data of the revision that has just left the
+     * window of KisTileDataStore::undoSwapOutDepth() recent commits
+     * to the swap
+     */
+    void swapOutOldRevision();
+
+    /**
+     * Checks if the uncommitted item \p mi stores exactly the same
+     * pixels as its previous version \p parentMI
+     */
+    bool isUnchangedTile(KisMementoItemSP mi, KisMementoItemSP parentMI) const;
+
 protected:
     /**
      * INDEX of tiles to be committed with next commit()
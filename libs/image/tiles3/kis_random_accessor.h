@@ -22,6 +22,7 @@ class KisRandomAccessor2 : public KisRandomAccessorNG
         KisTileSP oldtile;
         quint8* data;
         const quint8* oldData;
+        bool isUniform;
         qint32 area_x1, area_y1, area_x2, area_y2;
     };
 
@@ -78,6 +79,14 @@ public:
     qint32 x() const override;
     qint32 y() const override;
 
+    /**
+     * Returns true if all the pixels of the tile the accessor points
+     * to are known to be the same, \see KisTileData::isUniform()
+     */
+    inline bool isUniform() const {
+        return m_isUniform;
+    }
+
 private:
     KisTiledDataManager *m_ktm;
     KisTileInfo** m_tilesCache;
@@ -85,6 +94,7 @@ private:
     qint32 m_pixelSize;
     quint8* m_data;
     const quint8* m_oldData;
+    bool m_isUniform;
     bool m_writable;
     int m_lastX, m_lastY;
     qint32 m_offsetX, m_offsetY;
@@ -11,6 +11,7 @@
 #include "kis_tile_data_store.h"
 #include "kis_tile.h"
 #include "kis_memento_manager.h"
+#include "KisTileDataDeduplicationIndex.h"
 #include "kis_debug.h"
 
 
@@ -258,6 +259,13 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    /**
+     * The tile data is not shared anymore, so the writer may
+     * change any of its pixels
+     */
+    m_tileData->resetUniform();
+    m_tileData->updateRevision();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
@@ -284,6 +292,48 @@ void KisTile::unlockForRead() const
 }
 
 
+bool KisTile::tryDeduplicate(KisTileDataDeduplicationIndex &index)
+{
+    /**
+     * The lock order is the same as in lockForWrite(): COW mutex
+     * first, then the barrier lock. Holding the barrier lock with
+     * zero lock counter guarantees that no one can start accessing
+     * the tile data while we are working with it.
+     */
+    QMutexLocker cowLocker(&m_COWMutex);
+    QMutexLocker barrierLocker(&m_swapBarrierLock);
+
+    if (m_lockCounter > 0) return false;
+
+    KisTileData *sharedTileData = index.findOrAdd(m_tileData);
+    if (!sharedTileData || sharedTileData == m_tileData) return false;
+
+    /**
+     * The content of the tile is not changed, so we don't need
+     * to notify the memento manager about it
+     */
+    sharedTileData->acquire();
+    KisTileData *oldTileData = m_tileData;
+    m_tileData = sharedTileData;
+    oldTileData->release();
+
+    return true;
+}
+
+KisTileData* KisTile::refSwappedOutTileData()
+{
+    QMutexLocker cowLocker(&m_COWMutex);
+
+    /**
+     * We don't take the swap lock, the result is just a hint
+     * and will be rechecked by the prefetcher
+     */
+    if (m_tileData->data()) return 0;
+
+    m_tileData->ref();
+    return m_tileData;
+}
+
 #include <stdio.h>
 void KisTile::debugPrintInfo()
 {
@@ -27,6 +27,7 @@ class KisTile;
 typedef KisSharedPtr<KisTile> KisTileSP;
 
 class KisMementoManager;
+class KisTileDataDeduplicationIndex;
 
 
 /**
@@ -119,6 +120,23 @@ public:
         return m_tileData;
     }
 
+    /**
+     * Looks up the content of the tile in \p index and, if an identical
+     * tile data is found there, makes the tile share it instead of its
+     * own one. The tile is skipped if someone is accessing it right now.
+     *
+     * \return true if the tile has been switched to the shared tile data
+     */
+    bool tryDeduplicate(KisTileDataDeduplicationIndex &index);
+
+    /**
+     * If the tile data of the tile has been swapped out, refs it
+     * and returns it, otherwise returns null. Used for prefetching
+     * the tile data in the background, the caller is responsible
+     * for deref()'ing the returned tile data.
+     */
+    KisTileData* refSwappedOutTileData();
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -13,18 +13,28 @@
 
 #include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
+#include "KisTileDataArenas.h"
+#include "KisNumaTopology.h"
 
 // BPP == bytes per pixel
 #define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 #define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+/**
+ * The pools grow by a fixed number of chunks, so with bigger tiles we
+ * should scale the chunk counts down to keep the same memory footprint
+ * of a single pool allocation as with the default 64x64 tiles
+ */
+#define TILE_POOL_SCALE ((__TILE_DATA_WIDTH * __TILE_DATA_HEIGHT) / (64 * 64))
+
+typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256 / TILE_POOL_SCALE, 4096 / TILE_POOL_SCALE> BoostPool4BPP;
+typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128 / TILE_POOL_SCALE, 2048 / TILE_POOL_SCALE> BoostPool8BPP;
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
 
 SimpleCache KisTileData::m_cache;
+std::atomic<quint64> KisTileData::m_lastRevision {0};
 
 SimpleCache::~SimpleCache()
 {
@@ -56,13 +66,15 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_isUniform(1),
+      m_revision(++m_lastRevision),
       m_pixelSize(pixelSize),
       m_store(store)
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
     }
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_numaNode);
 
     fillWithPixel(defPixel);
 }
@@ -85,13 +97,15 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_isUniform(rhs.m_isUniform.loadAcquire()),
+      m_revision(++m_lastRevision),
       m_pixelSize(rhs.m_pixelSize),
       m_store(rhs.m_store)
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
     }
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_numaNode);
 
     memcpy(m_data, rhs.data(), m_pixelSize * WIDTH * HEIGHT);
 }
@@ -114,7 +128,7 @@ void KisTileData::fillWithPixel(const quint8 *defPixel)
 void KisTileData::releaseMemory()
 {
     if (m_data) {
-        freeData(m_data, m_pixelSize);
+        freeData(m_data, m_pixelSize, m_numaNode);
         m_data = 0;
     }
 
@@ -129,13 +143,35 @@ void KisTileData::releaseMemory()
 void KisTileData::allocateMemory()
 {
     Q_ASSERT(!m_data);
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_numaNode);
 }
 
-quint8* KisTileData::allocateData(const qint32 pixelSize)
+KisTileDataArenas* KisTileData::arenas()
+{
+    static KisTileDataArenas *s_arenas = [] () {
+        KisTileDataArenas *arenas = KisTileDataArenas::instance();
+        arenas->setGlobalFreeFunc(&KisTileData::freeDataGlobal);
+        return arenas;
+    }();
+
+    return s_arenas;
+}
+
+void KisTileData::rebalanceArenas()
+{
+    arenas()->rebalance();
+}
+
+quint8* KisTileData::allocateData(const qint32 pixelSize, qint32 &numaNode)
 {
     quint8 *ptr = 0;
 
+    numaNode = KisNumaTopology::instance()->currentNode();
+
+    if (arenas()->pop(pixelSize, ptr)) {
+        return ptr;
+    }
+
     if (!m_cache.pop(pixelSize, ptr)) {
         switch (pixelSize) {
         case 4:
@@ -153,7 +189,14 @@ quint8* KisTileData::allocateData(const qint32 pixelSize)
     return ptr;
 }
 
-void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
+void KisTileData::freeData(quint8* ptr, const qint32 pixelSize, qint32 numaNode)
+{
+    if (!arenas()->push(pixelSize, ptr, numaNode)) {
+        freeDataGlobal(ptr, pixelSize);
+    }
+}
+
+void KisTileData::freeDataGlobal(quint8* ptr, const qint32 pixelSize)
 {
     if (!m_cache.push(pixelSize, ptr)) {
         switch (pixelSize) {
@@ -222,6 +265,7 @@ void KisTileData::releaseInternalPools()
 
         if (!failedToLock) {
             // purge the pools memory
+            arenas()->drainAll();
             m_cache.clear();
             BoostPool4BPP::purge_memory();
             BoostPool8BPP::purge_memory();
@@ -233,7 +277,7 @@ void KisTileData::releaseInternalPools()
                 KisTileData *item = *it;
                 const int chunkSize = item->m_pixelSize * WIDTH * HEIGHT;
 
-                item->m_data = allocateData(item->m_pixelSize);
+                item->m_data = allocateData(item->m_pixelSize, item->m_numaNode);
                 memcpy(item->m_data, chunkIt->data(), chunkSize);
 
                 item->m_swapLock.unlock();
@@ -26,6 +26,8 @@ inline quint8* KisTileData::data() const {
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
+    resetUniform();
+    updateRevision();
 }
 
 inline quint32 KisTileData::pixelSize() const {
@@ -103,6 +105,20 @@ inline void KisTileData::setMementoed(bool value) {
     m_mementoFlag += value ? 1 : -1;
 }
 
+inline bool KisTileData::isUniform() const {
+    return m_isUniform.loadAcquire();
+}
+inline void KisTileData::resetUniform() {
+    m_isUniform.storeRelease(0);
+}
+
+inline quint64 KisTileData::revision() const {
+    return m_revision.load(std::memory_order_acquire);
+}
+inline void KisTileData::updateRevision() {
+    m_revision.store(++m_lastRevision, std::memory_order_release);
+}
+
 inline bool KisTileData::historical() const {
     return mementoed() && numUsers() <= 1;
 }
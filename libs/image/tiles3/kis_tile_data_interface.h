@@ -10,19 +10,22 @@
 
 #include <QReadWriteLock>
 #include <QAtomicInt>
+#include <atomic>
 
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
+#include "config-tile-size.h"
 
 class KisTileData;
 class KisTileDataStore;
+class KisTileDataArenas;
 
 /**
  * WARNING: Those definitions for internal use only!
  * Please use KisTileData::WIDTH/HEIGHT instead
  */
-#define __TILE_DATA_WIDTH 64
-#define __TILE_DATA_HEIGHT 64
+#define __TILE_DATA_WIDTH KRITA_TILE_SIZE
+#define __TILE_DATA_HEIGHT KRITA_TILE_SIZE
 
 typedef KisLocklessStack<KisTileData*> KisTileDataCache;
 
@@ -159,6 +162,28 @@ public:
     inline bool mementoed() const;
     inline void setMementoed(bool value);
 
+    /**
+     * Shows whether all the pixels of the tile data are known to be
+     * the same, i.e. the data has been filled with a single pixel and
+     * nobody has locked it for writing since then. The flag is
+     * conservative: a reset flag doesn't mean the pixels differ.
+     *
+     * A uniform source lets the compositing read a single pixel
+     * instead of the whole buffer.
+     */
+    inline bool isUniform() const;
+    inline void resetUniform();
+
+    /**
+     * A number that identifies the content of the tile data. It is
+     * unique among all the tile data objects ever created and gets a
+     * new value every time the data is locked for writing, so two
+     * equal revisions always mean equal pixels, even if the object
+     * has been deleted and another one allocated at its address.
+     */
+    inline quint64 revision() const;
+    inline void updateRevision();
+
     /**
      * Controlling methods for setting 'age' marks
      */
@@ -211,8 +236,26 @@ public:
 private:
     void fillWithPixel(const quint8 *defPixel);
 
-    static quint8* allocateData(const qint32 pixelSize);
-    static void freeData(quint8 *ptr, const qint32 pixelSize);
+    /**
+     * Allocates a buffer for the tile. \p numaNode is set to the NUMA
+     * node of the current thread, which is going to write the buffer
+     * first and hence is considered its owner.
+     */
+    static quint8* allocateData(const qint32 pixelSize, qint32 &numaNode);
+    static void freeData(quint8 *ptr, const qint32 pixelSize, qint32 numaNode);
+
+    /**
+     * Frees the buffer bypassing the per-thread arenas
+     */
+    static void freeDataGlobal(quint8 *ptr, const qint32 pixelSize);
+
+    static KisTileDataArenas* arenas();
+
+    /**
+     * Called by the pooler periodically to move the buffers
+     * accumulated by the threads back to the global pool
+     */
+    static void rebalanceArenas();
 private:
     friend class KisTileDataPooler;
     friend class KisTileDataPoolerTest;
@@ -231,6 +274,8 @@ private:
     friend class KisTileDataStoreReverseIterator;
     friend class KisTileDataStoreClockIterator;
 
+    friend class KisTileDataDeduplicationIndex;
+
     /**
      * The state of the tile.
      * Filled in by tileDataStore and
@@ -300,10 +345,32 @@ private:
      */
     mutable QAtomicInt m_refCount;
 
+    /**
+     * Set when the data is filled with a single pixel,
+     * \see isUniform()
+     */
+    QAtomicInt m_isUniform;
+
+    /**
+     * \see revision()
+     *
+     * The revision is updated by any thread that locks the tile for
+     * writing, and is read without any lock (e.g. by the tile saving
+     * cache in the autosave thread), so it is atomic.
+     */
+    std::atomic<quint64> m_revision;
+    static std::atomic<quint64> m_lastRevision;
+
 
     qint32 m_pixelSize;
     //qint32 m_timeStamp;
 
+    /**
+     * The NUMA node of the thread that has allocated m_data,
+     * or -1 if NUMA-aware mode is disabled
+     */
+    qint32 m_numaNode;
+
     KisTileDataStore *m_store;
     static SimpleCache m_cache;
 
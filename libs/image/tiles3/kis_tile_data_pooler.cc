@@ -19,6 +19,12 @@ const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
 
+/**
+ * Deduplication walks through all the tiles of all the
+ * data managers, so we shouldn't do it too often
+ */
+static const qint64 DEDUPLICATION_INTERVAL = 30000; // 00m30s
+
 //#define DEBUG_POOLER
 
 #ifdef DEBUG_POOLER
@@ -88,12 +94,17 @@ KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit
     m_lastRealMemoryMetric = 0;
     m_lastHistoricalMemoryMetric = 0;
 
+    KisImageConfig config(true);
+
     if(memoryLimit >= 0) {
         m_memoryLimit = memoryLimit;
     }
     else {
-        m_memoryLimit = MiB_TO_METRIC(KisImageConfig(true).poolLimit());
+        m_memoryLimit = MiB_TO_METRIC(config.poolLimit());
     }
+
+    m_deduplicationEnabled = config.enableTileDataDeduplication();
+    m_deduplicationTimer.start();
 }
 
 KisTileDataPooler::~KisTileDataPooler()
@@ -208,11 +219,39 @@ void KisTileDataPooler::run()
 
         m_store->endIteration(iter);
 
+        if (!m_lastCycleHadWork) {
+            tryDeduplicateTileData();
+        }
+
+        KisTileData::rebalanceArenas();
+
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
     }
 }
 
+void KisTileDataPooler::tryDeduplicateTileData()
+{
+    if (!m_deduplicationEnabled ||
+        m_deduplicationTimer.elapsed() < DEDUPLICATION_INTERVAL) {
+
+        return;
+    }
+
+    DEBUG_SIMPLE_ACTION("deduplication started");
+
+    /**
+     * Should be called outside the iteration of the store,
+     * because deduplication may free tile data
+     */
+    const int numDeduplicated = m_store->deduplicateTileData();
+    m_deduplicationTimer.restart();
+
+    if (numDeduplicated > 0) {
+        dbgTiles << "KisTileDataPooler: deduplicated" << numDeduplicated << "tiles";
+    }
+}
+
 void KisTileDataPooler::forceUpdateMemoryStats()
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(!isRunning());
@@ -409,5 +448,7 @@ void KisTileDataPooler::debugTileStatistics()
 
 void KisTileDataPooler::testingRereadConfig()
 {
-    m_memoryLimit = MiB_TO_METRIC(KisImageConfig(true).poolLimit());
+    KisImageConfig config(true);
+    m_memoryLimit = MiB_TO_METRIC(config.poolLimit());
+    m_deduplicationEnabled = config.enableTileDataDeduplication();
 }
@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QThread>
 #include <QSemaphore>
+#include <QElapsedTimer>
 
 #include "kritaimage_export.h"
 
@@ -71,6 +72,8 @@ protected:
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied);
 
+    void tryDeduplicateTileData();
+
 private:
     void debugTileStatistics();
 protected:
@@ -83,6 +86,9 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+
+    bool m_deduplicationEnabled;
+    QElapsedTimer m_deduplicationTimer;
 };
 
 
@@ -15,6 +15,9 @@
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
+#include "kis_tiled_data_manager.h"
+#include "KisTileDataDeduplicationIndex.h"
+#include "kis_image_config.h"
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
@@ -58,17 +61,25 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
       m_clockIndex(1)
 {
+    m_deduplicationEnabled = KisImageConfig(true).enableTileDataDeduplication();
+    m_lazyTileLoadingEnabled = KisImageConfig(true).lazyTileLoading();
+    m_undoSwapOutDepth = qMax(0, KisImageConfig(true).undoSwapOutDepth());
+    m_dropUnchangedUndoTiles = KisImageConfig(true).dropUnchangedUndoTiles();
+
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
@@ -99,6 +110,7 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
 
     stats.swapSize = m_swappedStore.totalSwapMemoryUsed();
+    stats.compressedPoolSize = m_swappedStore.compressedPoolMemoryUsed();
 
     return stats;
 }
@@ -164,6 +176,79 @@ void KisTileDataStore::unregisterTileData(KisTileData *td)
     unregisterTileDataImp(td);
 }
 
+bool KisTileDataStore::tryRegisterDataManager(KisTiledDataManager *dm)
+{
+    if (!m_deduplicationEnabled) return false;
+
+    QMutexLocker l(&m_dataManagersLock);
+    m_dataManagers.insert(dm);
+    return true;
+}
+
+void KisTileDataStore::unregisterDataManager(KisTiledDataManager *dm)
+{
+    QMutexLocker l(&m_dataManagersLock);
+
+    // wait until the pooler finishes deduplicating this manager
+    while (m_currentDeduplicatedManager == dm) {
+        m_dataManagerReleased.wait(&m_dataManagersLock);
+    }
+
+    m_dataManagers.remove(dm);
+}
+
+int KisTileDataStore::deduplicateTileData()
+{
+    QList<KisTiledDataManager*> dataManagers;
+
+    {
+        QMutexLocker l(&m_dataManagersLock);
+        dataManagers = m_dataManagers.values();
+    }
+
+    KisTileDataDeduplicationIndex index;
+    int numDeduplicated = 0;
+
+    Q_FOREACH (KisTiledDataManager *dm, dataManagers) {
+        {
+            QMutexLocker l(&m_dataManagersLock);
+
+            // the manager could have died in the meantime
+            if (!m_dataManagers.contains(dm)) continue;
+            m_currentDeduplicatedManager = dm;
+        }
+
+        /**
+         * We don't hold any locks of the store here, because
+         * releasing tile data may call freeTileData()
+         */
+        numDeduplicated += dm->deduplicateTiles(index);
+
+        {
+            QMutexLocker l(&m_dataManagersLock);
+            m_currentDeduplicatedManager = nullptr;
+            m_dataManagerReleased.wakeAll();
+        }
+    }
+
+    return numDeduplicated;
+}
+
+void KisTileDataStore::prefetchTileData(const QVector<KisTileData*> &tiles)
+{
+    if (tiles.isEmpty()) return;
+
+    /**
+     * Let the OS start reading the swap file while the
+     * requests are waiting in the queue
+     */
+    Q_FOREACH (KisTileData *td, tiles) {
+        m_swappedStore.prefetchTileData(td);
+    }
+
+    m_prefetcher.enqueue(tiles);
+}
+
 KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, const quint8 *defPixel)
 {
     KisTileData *td = new KisTileData(pixelSize, defPixel, this);
@@ -279,6 +364,98 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+bool KisTileDataStore::lazyTileLoadingEnabled() const
+{
+    return m_lazyTileLoadingEnabled;
+}
+
+bool KisTileDataStore::trySwapOutCompressedTileData(KisTileData *td, const QByteArray &data,
+                                                    const QString &compressionName)
+{
+    bool result = false;
+
+    QReadLocker lock(&m_iteratorLock);
+    if (!td->m_swapLock.tryLockForWrite()) return result;
+
+    if (td->data()) {
+        if (m_swappedStore.trySwapOutCompressedTileData(td, data, compressionName)) {
+            unregisterTileDataImp(td);
+            result = true;
+        }
+    }
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
+int KisTileDataStore::undoSwapOutDepth() const
+{
+    return m_undoSwapOutDepth;
+}
+
+bool KisTileDataStore::dropUnchangedUndoTiles() const
+{
+    return m_dropUnchangedUndoTiles;
+}
+
+void KisTileDataStore::swapOutHistoricalTileData(const QVector<KisTileData*> &tiles)
+{
+    m_swapper.enqueueHistoricalTiles(tiles);
+}
+
+qint64 KisTileDataStore::trySwapHistoricalTileDataBatch(const QVector<KisTileData*> &candidates)
+{
+    QVector<KisTileData*> tiles;
+    tiles.reserve(candidates.size());
+
+    Q_FOREACH (KisTileData *td, candidates) {
+        if (td->historical()) {
+            tiles.append(td);
+        }
+    }
+
+    if (tiles.isEmpty()) return 0;
+
+    QReadLocker lock(&m_iteratorLock);
+    return trySwapTileDataBatch(tiles);
+}
+
+qint64 KisTileDataStore::trySwapTileDataBatch(const QVector<KisTileData*> &candidates)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    QVector<KisTileData*> tiles;
+    tiles.reserve(candidates.size());
+
+    Q_FOREACH (KisTileData *td, candidates) {
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (!td->data()) {
+            td->m_swapLock.unlock();
+            continue;
+        }
+
+        tiles.append(td);
+    }
+
+    qint64 freedMetric = 0;
+
+    if (m_swappedStore.trySwapOutTileDataBatch(tiles)) {
+        Q_FOREACH (KisTileData *td, tiles) {
+            unregisterTileDataImp(td);
+            freedMetric += td->pixelSize();
+        }
+    }
+
+    Q_FOREACH (KisTileData *td, tiles) {
+        td->m_swapLock.unlock();
+    }
+
+    return freedMetric;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -365,8 +542,12 @@ void KisTileDataStore::debugClear()
 
 void KisTileDataStore::testingRereadConfig()
 {
+    m_deduplicationEnabled = KisImageConfig(true).enableTileDataDeduplication();
+    m_lazyTileLoadingEnabled = KisImageConfig(true).lazyTileLoading();
+    m_undoSwapOutDepth = qMax(0, KisImageConfig(true).undoSwapOutDepth());
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
     kickPooler();
 }
 
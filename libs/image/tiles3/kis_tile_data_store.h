@@ -11,16 +11,21 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSet>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
 class KisTileDataStoreIterator;
 class KisTileDataStoreReverseIterator;
 class KisTileDataStoreClockIterator;
+class KisTiledDataManager;
 
 /**
  * Stores tileData objects. When needed compresses them and swaps.
@@ -42,6 +47,7 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 compressedPoolSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -107,6 +113,63 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Try swap out a batch of tile data objects. The tiles
+     * that are being accessed at the moment are skipped.
+     *
+     * \return the metric of the memory freed
+     */
+    qint64 trySwapTileDataBatch(const QVector<KisTileData*> &candidates);
+
+    /**
+     * When enabled, the data managers put the tiles read from files
+     * into the swap as they are, without decompressing them. The tiles
+     * are decompressed by the usual swap-in on the first access, so
+     * the tiles of the hidden layers and frames are never decompressed.
+     */
+    bool lazyTileLoadingEnabled() const;
+
+    /**
+     * Swap out \p td using its already compressed representation
+     * \p data. Fails if the compression is not the one used by the
+     * swap, or if the tile data is being accessed at the moment.
+     */
+    bool trySwapOutCompressedTileData(KisTileData *td, const QByteArray &data,
+                                      const QString &compressionName);
+
+    /**
+     * Number of the most recent commits of a memento manager whose
+     * tile data is not pushed to the swap by swapOutHistoricalTileData().
+     * Zero means the history is swapped out by the memory limits only.
+     *
+     * \see KisImageConfig::undoSwapOutDepth()
+     */
+    int undoSwapOutDepth() const;
+
+    /**
+     * Whether the memento managers should drop the tiles whose
+     * pixels have not changed from the committed revisions
+     *
+     * \see KisImageConfig::dropUnchangedUndoTiles()
+     */
+    bool dropUnchangedUndoTiles() const;
+
+    /**
+     * Asks the swapper to push the tile data of an old undo revision
+     * out of memory in the background. The caller should have ref()'ed
+     * every tile data in \p tiles, the store takes over these references.
+     */
+    void swapOutHistoricalTileData(const QVector<KisTileData*> &tiles);
+
+    /**
+     * Swaps out the tile data of \p candidates that are still used
+     * by the undo history only. The tiles that are being accessed,
+     * or became a part of a paint device again, are skipped.
+     *
+     * \return the metric of the memory freed
+     */
+    qint64 trySwapHistoricalTileDataBatch(const QVector<KisTileData*> &candidates);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -132,6 +195,37 @@ public:
     void registerTileData(KisTileData *td);
     void unregisterTileData(KisTileData *td);
 
+    /**
+     * Data managers register themselves in the store to let
+     * deduplicateTileData() find their tiles. Registration
+     * happens only when the deduplication is enabled in the
+     * config.
+     *
+     * \return true if the data manager has been registered,
+     *         and therefore should be unregistered on destruction
+     */
+    bool tryRegisterDataManager(KisTiledDataManager *dm);
+    void unregisterDataManager(KisTiledDataManager *dm);
+
+    /**
+     * Searches for tile data objects with byte-identical content
+     * among all registered data managers and makes their tiles
+     * share a single tile data via copy-on-write. Called by the
+     * pooler thread in its idle time.
+     *
+     * \return the number of tiles switched to a shared tile data
+     */
+    int deduplicateTileData();
+
+    /**
+     * Asks the store to swap in \p tiles in the background, because
+     * someone is going to access them soon. The caller should have
+     * ref()'ed each of the tile data, the store takes over these
+     * references. Tile data that is already in memory is just
+     * skipped.
+     */
+    void prefetchTileData(const QVector<KisTileData*> &tiles);
+
 private:
     KisTileData *allocTileData(qint32 pixelSize, const quint8 *defPixel);
 
@@ -153,6 +247,7 @@ private:
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -169,6 +264,15 @@ private:
     QAtomicInt m_clockIndex;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
+
+    bool m_deduplicationEnabled = false;
+    bool m_lazyTileLoadingEnabled = false;
+    int m_undoSwapOutDepth = 0;
+    bool m_dropUnchangedUndoTiles = true;
+    QMutex m_dataManagersLock;
+    QWaitCondition m_dataManagerReleased;
+    QSet<KisTiledDataManager*> m_dataManagers;
+    KisTiledDataManager *m_currentDeduplicatedManager = nullptr;
 };
 
 template<typename T>
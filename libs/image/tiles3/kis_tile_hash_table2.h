@@ -529,8 +529,18 @@ void KisTileHashTableTraits2<T>::debugMaxListLength(qint32 &/*min*/, qint32 &/*m
 {
 }
 
+#include "config-hash-table-implementation.h"
+
+#ifdef USE_OPEN_ADDRESSING_HASH_TABLE
+#include "kis_tile_hash_table3.h"
+
+typedef KisTileHashTableTraits3<KisTile> KisTileHashTable;
+typedef KisTileHashTableIteratorTraits3<KisTile> KisTileHashTableIterator;
+typedef KisTileHashTableIteratorTraits3<KisTile> KisTileHashTableConstIterator;
+#else
 typedef KisTileHashTableTraits2<KisTile> KisTileHashTable;
 typedef KisTileHashTableIteratorTraits2<KisTile> KisTileHashTableIterator;
 typedef KisTileHashTableIteratorTraits2<KisTile> KisTileHashTableConstIterator;
+#endif // USE_OPEN_ADDRESSING_HASH_TABLE
 
 #endif // KIS_TILEHASHTABLE_2_H
@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_hash_table3.h"
+
+#include <QGlobalStatic>
+#include <QThread>
+
+Q_GLOBAL_STATIC(KisTileHashTableReclaimer, s_instance)
+
+
+KisTileHashTableReclaimer* KisTileHashTableReclaimer::instance()
+{
+    return s_instance;
+}
+
+KisTileHashTableReclaimer::Slot* KisTileHashTableReclaimer::threadSlot()
+{
+    static thread_local Slot *slot = 0;
+
+    if (!slot) {
+        KisTileHashTableReclaimer *reclaimer = instance();
+        const int index = reclaimer->m_nextSlot.fetch_add(1, std::memory_order_relaxed);
+        slot = &reclaimer->m_slots[index % NUM_SLOTS];
+    }
+
+    return slot;
+}
+
+void KisTileHashTableReclaimer::retire(ReclaimFunc func, void *object)
+{
+    QMutexLocker l(&m_lock);
+    m_pendingActions.append({func, object});
+}
+
+void KisTileHashTableReclaimer::update(bool force)
+{
+    QVector<Action> actions;
+
+    {
+        if (force) {
+            m_lock.lock();
+        } else if (!m_lock.tryLock()) {
+            // someone else is already collecting the garbage
+            return;
+        }
+
+        actions.swap(m_pendingActions);
+        m_lock.unlock();
+    }
+
+    if (actions.isEmpty()) return;
+
+    /**
+     * All the objects in actions have been unlinked before they
+     * were retired, so make sure the unlinking is visible before
+     * we start checking the readers
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        while (m_slots[i].readers.load(std::memory_order_acquire)) {
+            if (!force) {
+                // someone still reads the tables, try next time
+                QMutexLocker l(&m_lock);
+                m_pendingActions.append(actions);
+                return;
+            }
+
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    /**
+     * Destroying tiles may take locks of the tile data store,
+     * so do that with no locks held
+     */
+    Q_FOREACH (const Action &action, actions) {
+        action.func(action.object);
+    }
+}
@@ -0,0 +1,857 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_TILEHASHTABLE_3_H
+#define KIS_TILEHASHTABLE_3_H
+
+#include <atomic>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "kis_shared.h"
+#include "kis_shared_ptr.h"
+#include "kis_tile.h"
+#include "kis_debug.h"
+
+/**
+ * A reclamation domain shared by all KisTileHashTableTraits3 objects.
+ *
+ * The readers of the tables don't take any locks. Instead, every
+ * thread is assigned one of NUM_SLOTS cache-line-aligned slots and
+ * increments the reader counter of this slot while it accesses raw
+ * pointers stored in a table. Since different threads use different
+ * cache lines, the readers don't fight for a single shared counter
+ * (that is what QSBR in KisTileHashTableTraits2 does).
+ *
+ * The objects unlinked from a table are retired into the domain and
+ * destroyed only when every slot has been seen empty after the
+ * retirement. The slots are checked one by one; it is enough, because
+ * a reader that entered a slot after the object has been unlinked
+ * cannot see it anymore.
+ */
+class KRITAIMAGE_EXPORT KisTileHashTableReclaimer
+{
+public:
+    static const int NUM_SLOTS = 128;
+
+    struct alignas(64) Slot {
+        std::atomic<int> readers {0};
+    };
+
+    /**
+     * Marks the current thread as a reader of raw pointers
+     * for the lifetime of the guard. Please don't take **any**
+     * locks while the guard is alive.
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard()
+            : m_slot(KisTileHashTableReclaimer::threadSlot())
+        {
+            m_slot->readers.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~ReadGuard()
+        {
+            m_slot->readers.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        Q_DISABLE_COPY(ReadGuard)
+        Slot *m_slot;
+    };
+
+    typedef void (*ReclaimFunc)(void*);
+
+public:
+    static KisTileHashTableReclaimer* instance();
+
+    /**
+     * Schedules \p func(\p object) to be called when none of the
+     * readers can access \p object anymore. The object should
+     * have already been unlinked from all the tables.
+     */
+    void retire(ReclaimFunc func, void *object);
+
+    /**
+     * Destroys the retired objects if there are no readers that
+     * could still access them. With \p force set, waits for the
+     * readers to leave. Must not be called with a ReadGuard alive
+     * in the current thread.
+     */
+    void update(bool force = false);
+
+private:
+    static Slot* threadSlot();
+
+private:
+    struct Action {
+        ReclaimFunc func;
+        void *object;
+    };
+
+    Slot m_slots[NUM_SLOTS];
+    std::atomic<int> m_nextSlot {0};
+
+    QMutex m_lock;
+    QVector<Action> m_pendingActions;
+};
+
+/**
+ * An alternative to KisTileHashTableTraits2 with the same interface.
+ * The table uses open addressing over cache-line-aligned buckets, so
+ * looking up a tile usually touches a single cache line and doesn't
+ * write into any shared memory. That is done in KisRandomAccessor2
+ * a lot, e.g. by smudge and filter brushes.
+ *
+ * Lookups are lock-free. Insertions and removals (that happen only
+ * when a tile is created or deleted) are serialized by a mutex. Just
+ * like in the leapfrog map, the keys are never removed from a table:
+ * an erased tile leaves its key with a null value, and the dead keys
+ * are dropped when the table is rebuilt on growth.
+ *
+ * Enabled with USE_OPEN_ADDRESSING_HASH_TABLE cmake option.
+ */
+
+template <class T>
+class KisTileHashTableIteratorTraits3;
+
+template <class T>
+class KisTileHashTableTraits3
+{
+    static constexpr bool isInherited = std::is_convertible<T*, KisShared*>::value;
+    Q_STATIC_ASSERT_X(isInherited, "Template must inherit KisShared");
+
+public:
+    typedef T TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+    typedef KisWeakSharedPtr<T> TileTypeWSP;
+
+    KisTileHashTableTraits3(KisMementoManager *mm);
+    KisTileHashTableTraits3(const KisTileHashTableTraits3<T> &ht, KisMementoManager *mm);
+    ~KisTileHashTableTraits3();
+
+    bool isEmpty()
+    {
+        return !m_numTiles.loadRelaxed();
+    }
+
+    bool tileExists(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * returns null.
+     * \param col column of the tile
+     * \param row row of the tile
+     */
+    TileTypeSP getExistingTile(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates a new one, attaches it to the list and returns.
+     * \param col column of the tile
+     * \param row row of the tile
+     * \param newTile out-parameter, returns true if a new tile
+     *                was created
+     */
+    TileTypeSP getTileLazy(qint32 col, qint32 row, bool& newTile);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates nothing, but returns shared default tile object
+     * of the table. Be careful, this object has column and row
+     * parameters set to (qint32_MIN, qint32_MIN).
+     * \param col column of the tile
+     * \param row row of the tile
+     * \param existingTile returns true if the tile actually exists in the table
+     *                     and it is not a lazily created default wrapper tile
+     */
+    TileTypeSP getReadOnlyTileLazy(qint32 col, qint32 row, bool &existingTile);
+    void addTile(TileTypeSP tile);
+    bool deleteTile(TileTypeSP tile);
+    bool deleteTile(qint32 col, qint32 row);
+
+    void clear();
+
+    void setDefaultTileData(KisTileData *defaultTileData);
+    KisTileData* defaultTileData();
+
+    /**
+     * Returns a pointer to the default tile data object with ref counter
+     * increased by one. Make sure you call deref() after you finished using
+     * this object.
+     */
+    KisTileData* refAndFetchDefaultTileData();
+
+
+    qint32 numTiles()
+    {
+        return m_numTiles.loadRelaxed();
+    }
+
+    void debugPrintInfo();
+    void debugMaxListLength(qint32 &min, qint32 &max);
+
+    friend class KisTileHashTableIteratorTraits3<T>;
+
+private:
+    struct alignas(64) Bucket {
+        static const int SIZE = 4;
+
+        Bucket() {
+            for (int i = 0; i < SIZE; i++) {
+                keys[i].store(0, std::memory_order_relaxed);
+                values[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<quint32> keys[SIZE];
+        std::atomic<TileType*> values[SIZE];
+    };
+
+    struct Table {
+        Table(quint32 numBuckets)
+            : mask(numBuckets - 1),
+              numUsedKeys(0),
+              buckets(new Bucket[numBuckets])
+        {
+            KIS_ASSERT(!(numBuckets & mask));
+        }
+
+        ~Table() {
+            delete[] buckets;
+        }
+
+        quint32 numSlots() const {
+            return (mask + 1) * Bucket::SIZE;
+        }
+
+        const quint32 mask;
+        quint32 numUsedKeys; // guarded by m_writeLock
+        Bucket * const buckets;
+    };
+
+    static const quint32 MIN_NUM_BUCKETS = 16;
+
+    static void destroyTable(void *table)
+    {
+        delete static_cast<Table*>(table);
+    }
+
+    static void derefTile(void *tile)
+    {
+        TileTypeSP::deref(0, static_cast<TileType*>(tile));
+    }
+
+    inline quint32 calculateHashImpl(qint32 col, qint32 row)
+    {
+        if (col == 0 && row == 0) {
+            col = 0x7FFF;
+            row = 0x7FFF;
+        }
+
+        return ((static_cast<quint32>(row) << 16) | (static_cast<quint32>(col) & 0xFFFF));
+    }
+
+    inline quint32 calculateHash(qint32 col, qint32 row)
+    {
+#ifdef SANITY_CHECK
+        KIS_ASSERT_RECOVER_NOOP(qAbs(row) < 0x7FFF && qAbs(col) < 0x7FFF);
+#endif // SANITY_CHECK
+
+        return calculateHashImpl(col, row);
+    }
+
+    /**
+     * A version of the hash function that returns an invalid hash in
+     * case the requested tile is out of range
+     */
+    inline quint32 calculateHashSafe(qint32 col, qint32 row)
+    {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(qAbs(row) < 0x7FFF && qAbs(col) < 0x7FFF, 0);
+        return calculateHashImpl(col, row);
+    }
+
+    /**
+     * Neighbouring tiles have neighbouring keys, so scramble
+     * them a bit to avoid long probing sequences
+     */
+    static inline quint32 bucketIndex(quint32 key, quint32 mask)
+    {
+        quint32 h = key * 2654435761U;
+        h ^= h >> 16;
+        return h & mask;
+    }
+
+    /**
+     * Finds the slot for \p key in \p table. Keys are stored in the
+     * order of the probing sequence and never removed, so the search
+     * can stop at the first empty key.
+     *
+     * \return true if the key exists, otherwise returns the first empty
+     *              slot in \p bucket and \p slot
+     */
+    static bool findSlot(Table *table, quint32 key, Bucket **bucket, int *slot)
+    {
+        const quint32 startIndex = bucketIndex(key, table->mask);
+
+        for (quint32 probe = 0; probe <= table->mask; probe++) {
+            Bucket *b = &table->buckets[(startIndex + probe) & table->mask];
+
+            for (int i = 0; i < Bucket::SIZE; i++) {
+                const quint32 storedKey = b->keys[i].load(std::memory_order_acquire);
+
+                if (storedKey == key || !storedKey) {
+                    *bucket = b;
+                    *slot = i;
+                    return storedKey;
+                }
+            }
+        }
+
+        // the table is never full, so we should never get here
+        KIS_ASSERT(0 && "tile hash table is overflown");
+        return false;
+    }
+
+    /**
+     * Lock-free lookup, must be called with the ReadGuard taken
+     */
+    inline TileType* lookup(quint32 key) const
+    {
+        Table *table = m_table.load(std::memory_order_acquire);
+
+        Bucket *bucket = 0;
+        int slot = 0;
+
+        return findSlot(table, key, &bucket, &slot) ?
+            bucket->values[slot].load(std::memory_order_acquire) : nullptr;
+    }
+
+    /**
+     * Puts \p item into \p table, must be called with m_writeLock held
+     * \return the item that has been replaced
+     */
+    static TileType* assignImpl(Table *table, quint32 key, TileType *item)
+    {
+        Bucket *bucket = 0;
+        int slot = 0;
+
+        if (findSlot(table, key, &bucket, &slot)) {
+            return bucket->values[slot].exchange(item, std::memory_order_acq_rel);
+        }
+
+        // the value should be visible to the readers before the key
+        bucket->values[slot].store(item, std::memory_order_relaxed);
+        bucket->keys[slot].store(key, std::memory_order_release);
+        table->numUsedKeys++;
+
+        return nullptr;
+    }
+
+    /**
+     * Rebuilds the table when it becomes too dense, must be called with
+     * m_writeLock held. The readers may continue using the old table
+     * until the reclaimer destroys it.
+     */
+    void growIfNeeded()
+    {
+        Table *table = m_table.load(std::memory_order_relaxed);
+
+        // keep the load factor below 3/4
+        if (table->numUsedKeys * 4 < table->numSlots() * 3) return;
+
+        const quint32 numLiveTiles = qMax(1, m_numTiles.loadRelaxed());
+        quint32 numBuckets = MIN_NUM_BUCKETS;
+        while (numBuckets * Bucket::SIZE < numLiveTiles * 3) {
+            numBuckets <<= 1;
+        }
+
+        Table *newTable = new Table(numBuckets);
+
+        for (quint32 i = 0; i <= table->mask; i++) {
+            Bucket &b = table->buckets[i];
+
+            for (int j = 0; j < Bucket::SIZE; j++) {
+                TileType *item = b.values[j].load(std::memory_order_relaxed);
+                if (item) {
+                    assignImpl(newTable, b.keys[j].load(std::memory_order_relaxed), item);
+                }
+            }
+        }
+
+        m_table.store(newTable, std::memory_order_release);
+        KisTileHashTableReclaimer::instance()->retire(&destroyTable, table);
+    }
+
+    inline void insert(quint32 idx, TileTypeSP item)
+    {
+        TileTypeSP::ref(0, item.data());
+        TileType *tile = 0;
+
+        {
+            QReadLocker locker(&m_iteratorLock);
+            QMutexLocker writeLocker(&m_writeLock);
+
+            tile = assignImpl(m_table.load(std::memory_order_relaxed), idx, item.data());
+
+            if (!tile) {
+                m_numTiles.fetchAndAddRelaxed(1);
+                growIfNeeded();
+            }
+        }
+
+        if (tile) {
+            tile->notifyDeadWithoutDetaching();
+            KisTileHashTableReclaimer::instance()->retire(&derefTile, tile);
+        }
+
+        KisTileHashTableReclaimer::instance()->update();
+    }
+
+    inline bool erase(quint32 idx)
+    {
+        TileType *tile = 0;
+
+        {
+            QMutexLocker writeLocker(&m_writeLock);
+
+            Bucket *bucket = 0;
+            int slot = 0;
+
+            if (findSlot(m_table.load(std::memory_order_relaxed), idx, &bucket, &slot)) {
+                tile = bucket->values[slot].exchange(nullptr, std::memory_order_acq_rel);
+            }
+
+            if (tile) {
+                m_numTiles.fetchAndSubRelaxed(1);
+            }
+        }
+
+        if (tile) {
+            tile->notifyDetachedFromDataManager();
+            KisTileHashTableReclaimer::instance()->retire(&derefTile, tile);
+        }
+
+        KisTileHashTableReclaimer::instance()->update();
+        return tile;
+    }
+
+private:
+    std::atomic<Table*> m_table;
+    QMutex m_writeLock;
+
+    /**
+     * We still need something to guard changes in m_defaultTileData,
+     * otherwise there will be concurrent read/writes, resulting in broken memory.
+     */
+    QReadWriteLock m_defaultPixelDataLock;
+    mutable QReadWriteLock m_iteratorLock;
+
+    QAtomicInt m_numTiles;
+    KisTileData *m_defaultTileData;
+    KisMementoManager *m_mementoManager;
+};
+
+template <class T>
+class KisTileHashTableIteratorTraits3
+{
+public:
+    typedef T TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+    typedef typename KisTileHashTableTraits3<T>::Table Table;
+    typedef typename KisTileHashTableTraits3<T>::Bucket Bucket;
+
+    /**
+     * The iterator blocks insertions into the table, so the
+     * table cannot be rebuilt while we walk through it
+     */
+    KisTileHashTableIteratorTraits3(KisTileHashTableTraits3<T> *ht)
+        : m_ht(ht),
+          m_index(0)
+    {
+        m_ht->m_iteratorLock.lockForWrite();
+        m_table = m_ht->m_table.load(std::memory_order_acquire);
+        skipEmptySlots();
+    }
+
+    ~KisTileHashTableIteratorTraits3()
+    {
+        m_ht->m_iteratorLock.unlock();
+    }
+
+    void next()
+    {
+        m_index++;
+        skipEmptySlots();
+    }
+
+    TileTypeSP tile() const
+    {
+        KisTileHashTableReclaimer::ReadGuard guard;
+        return TileTypeSP(slotValue(m_index));
+    }
+
+    bool isDone() const
+    {
+        return m_index >= m_table->numSlots();
+    }
+
+    void deleteCurrent()
+    {
+        m_ht->erase(slotKey(m_index));
+        next();
+    }
+
+    void moveCurrentToHashTable(KisTileHashTableTraits3<T> *newHashTable)
+    {
+        TileTypeSP tile = this->tile();
+        next();
+
+        quint32 idx = m_ht->calculateHash(tile->col(), tile->row());
+        m_ht->erase(idx);
+        newHashTable->insert(idx, tile);
+    }
+
+private:
+    quint32 slotKey(quint32 index) const
+    {
+        const Bucket &b = m_table->buckets[index / Bucket::SIZE];
+        return b.keys[index % Bucket::SIZE].load(std::memory_order_acquire);
+    }
+
+    TileType* slotValue(quint32 index) const
+    {
+        const Bucket &b = m_table->buckets[index / Bucket::SIZE];
+        return b.values[index % Bucket::SIZE].load(std::memory_order_acquire);
+    }
+
+    void skipEmptySlots()
+    {
+        while (!isDone() && !slotValue(m_index)) {
+            m_index++;
+        }
+    }
+
+private:
+    KisTileHashTableTraits3<T> *m_ht;
+    Table *m_table;
+    quint32 m_index;
+};
+
+template <class T>
+KisTileHashTableTraits3<T>::KisTileHashTableTraits3(KisMementoManager *mm)
+    : m_table(new Table(MIN_NUM_BUCKETS)),
+      m_numTiles(0), m_defaultTileData(0), m_mementoManager(mm)
+{
+}
+
+template <class T>
+KisTileHashTableTraits3<T>::KisTileHashTableTraits3(const KisTileHashTableTraits3<T> &ht, KisMementoManager *mm)
+    : KisTileHashTableTraits3(mm)
+{
+    setDefaultTileData(ht.m_defaultTileData);
+
+    QWriteLocker locker(&ht.m_iteratorLock);
+    Table *table = ht.m_table.load(std::memory_order_acquire);
+
+    for (quint32 i = 0; i <= table->mask; i++) {
+        Bucket &b = table->buckets[i];
+
+        for (int j = 0; j < Bucket::SIZE; j++) {
+            TileTypeSP tile;
+
+            {
+                KisTileHashTableReclaimer::ReadGuard guard;
+                tile = b.values[j].load(std::memory_order_acquire);
+            }
+
+            if (tile) {
+                TileTypeSP clonedTile = new TileType(*tile, m_mementoManager);
+                insert(b.keys[j].load(std::memory_order_relaxed), clonedTile);
+            }
+        }
+    }
+}
+
+template <class T>
+KisTileHashTableTraits3<T>::~KisTileHashTableTraits3()
+{
+    clear();
+    setDefaultTileData(0);
+
+    delete m_table.load(std::memory_order_relaxed);
+
+    /**
+     * Make sure all our tiles are dead by the moment the
+     * data manager is destroyed
+     */
+    KisTileHashTableReclaimer::instance()->update(true);
+}
+
+template<class T>
+bool KisTileHashTableTraits3<T>::tileExists(qint32 col, qint32 row)
+{
+    return getExistingTile(col, row);
+}
+
+template <class T>
+typename KisTileHashTableTraits3<T>::TileTypeSP KisTileHashTableTraits3<T>::getExistingTile(qint32 col, qint32 row)
+{
+    const quint32 idx = calculateHashSafe(col, row);
+    if (!idx) {
+        /// a tile with invalid index obviously doesn't exist
+        return TileTypeSP();
+    }
+
+    KisTileHashTableReclaimer::ReadGuard guard;
+    return TileTypeSP(lookup(idx));
+}
+
+template <class T>
+typename KisTileHashTableTraits3<T>::TileTypeSP KisTileHashTableTraits3<T>::getTileLazy(qint32 col, qint32 row, bool &newTile)
+{
+    newTile = false;
+    const quint32 idx = calculateHashSafe(col, row);
+    if (!idx) {
+        /// when invalid tile index is requested, just return a
+        /// detached tile with the default data
+
+        /// we pretend as if this tile has already existed, it will
+        /// allow the calling code to avoid modifying the extent
+        /// manager
+        newTile = false;
+
+        QReadLocker locker(&m_defaultPixelDataLock);
+        return new TileType(col, row, m_defaultTileData, 0);
+    }
+
+    TileTypeSP tile;
+
+    {
+        KisTileHashTableReclaimer::ReadGuard guard;
+        tile = lookup(idx);
+    }
+
+    if (tile) return tile;
+
+    // no locks can be taken inside the read guard,
+    // so create the tile outside of it
+    {
+        QReadLocker locker(&m_defaultPixelDataLock);
+        tile = new TileType(col, row, m_defaultTileData, 0);
+    }
+
+    TileTypeSP existingTile;
+
+    {
+        // iterator lock should be taken **before**
+        // the write lock
+        QReadLocker locker(&m_iteratorLock);
+        QMutexLocker writeLocker(&m_writeLock);
+
+        Table *table = m_table.load(std::memory_order_relaxed);
+
+        Bucket *bucket = 0;
+        int slot = 0;
+
+        /**
+         * No one can erase the tile while we hold the write
+         * lock, so it is safe to access it without the guard
+         */
+        if (findSlot(table, idx, &bucket, &slot)) {
+            existingTile = bucket->values[slot].load(std::memory_order_acquire);
+        }
+
+        if (!existingTile) {
+            TileTypeSP::ref(0, tile.data());
+            assignImpl(table, idx, tile.data());
+            m_numTiles.fetchAndAddRelaxed(1);
+            growIfNeeded();
+        }
+    }
+
+    if (existingTile) {
+        // someone has managed to create the tile before us
+        tile->notifyDeadWithoutDetaching();
+        tile = existingTile;
+    } else {
+        newTile = true;
+        tile->notifyAttachedToDataManager(m_mementoManager);
+    }
+
+    KisTileHashTableReclaimer::instance()->update();
+    return tile;
+}
+
+template <class T>
+typename KisTileHashTableTraits3<T>::TileTypeSP KisTileHashTableTraits3<T>::getReadOnlyTileLazy(qint32 col, qint32 row, bool &existingTile)
+{
+    const quint32 idx = calculateHashSafe(col, row);
+    if (!idx) {
+        /// when invalid tile index is requested, just return a
+        /// detached tile with the default data
+
+        /// we pretend as if this tile hasn't existed, it will
+        /// allow the calling code to avoid modifying the extent
+        /// manager (note, that is opposite to what happens in
+        /// getTileLazy())
+        existingTile = false;
+
+        QReadLocker locker(&m_defaultPixelDataLock);
+        return new TileType(col, row, m_defaultTileData, 0);
+    }
+
+    TileTypeSP tile;
+
+    {
+        KisTileHashTableReclaimer::ReadGuard guard;
+        tile = lookup(idx);
+    }
+
+    existingTile = tile;
+
+    if (!existingTile) {
+        QReadLocker locker(&m_defaultPixelDataLock);
+        tile = new TileType(col, row, m_defaultTileData, 0);
+    }
+
+    return tile;
+}
+
+template <class T>
+void KisTileHashTableTraits3<T>::addTile(TileTypeSP tile)
+{
+    quint32 idx = calculateHash(tile->col(), tile->row());
+    insert(idx, tile);
+}
+
+template <class T>
+bool KisTileHashTableTraits3<T>::deleteTile(TileTypeSP tile)
+{
+    return deleteTile(tile->col(), tile->row());
+}
+
+template <class T>
+bool KisTileHashTableTraits3<T>::deleteTile(qint32 col, qint32 row)
+{
+    const quint32 idx = calculateHashSafe(col, row);
+    if (!idx) {
+        /// when invalid tile index is requested, just do nothing
+        return false;
+    }
+
+    return erase(idx);
+}
+
+template<class T>
+void KisTileHashTableTraits3<T>::clear()
+{
+    QVector<TileType*> deadTiles;
+
+    {
+        QWriteLocker locker(&m_iteratorLock);
+        QMutexLocker writeLocker(&m_writeLock);
+
+        Table *table = m_table.load(std::memory_order_relaxed);
+
+        for (quint32 i = 0; i <= table->mask; i++) {
+            Bucket &b = table->buckets[i];
+
+            for (int j = 0; j < Bucket::SIZE; j++) {
+                TileType *tile = b.values[j].exchange(nullptr, std::memory_order_acq_rel);
+                if (tile) {
+                    deadTiles.append(tile);
+                }
+            }
+        }
+
+        m_numTiles.storeRelaxed(0);
+    }
+
+    Q_FOREACH (TileType *tile, deadTiles) {
+        tile->notifyDetachedFromDataManager();
+        KisTileHashTableReclaimer::instance()->retire(&derefTile, tile);
+    }
+
+    // garbage collection must **not** be run with locks held
+    KisTileHashTableReclaimer::instance()->update();
+}
+
+template <class T>
+inline void KisTileHashTableTraits3<T>::setDefaultTileData(KisTileData *defaultTileData)
+{
+    QWriteLocker locker(&m_defaultPixelDataLock);
+
+    if (m_defaultTileData) {
+        m_defaultTileData->release();
+        m_defaultTileData = 0;
+    }
+
+    if (defaultTileData) {
+        defaultTileData->acquire();
+        m_defaultTileData = defaultTileData;
+    }
+}
+
+template <class T>
+inline KisTileData* KisTileHashTableTraits3<T>::defaultTileData()
+{
+    QReadLocker locker(&m_defaultPixelDataLock);
+    return m_defaultTileData;
+}
+
+template <class T>
+inline KisTileData* KisTileHashTableTraits3<T>::refAndFetchDefaultTileData()
+{
+    QReadLocker locker(&m_defaultPixelDataLock);
+    m_defaultTileData->ref();
+    return m_defaultTileData;
+}
+
+template <class T>
+void KisTileHashTableTraits3<T>::debugPrintInfo()
+{
+    QMutexLocker writeLocker(&m_writeLock);
+    Table *table = m_table.load(std::memory_order_relaxed);
+
+    dbgTiles << "==========================\n"
+             << "TileHashTable:"
+             << "\n   buckets:\t" << table->mask + 1
+             << "\n   used keys:\t" << table->numUsedKeys
+             << "\n   tiles:\t" << numTiles();
+}
+
+template <class T>
+void KisTileHashTableTraits3<T>::debugMaxListLength(qint32 &min, qint32 &max)
+{
+    QMutexLocker writeLocker(&m_writeLock);
+    Table *table = m_table.load(std::memory_order_relaxed);
+
+    /**
+     * There are no lists in open addressing, so report
+     * the number of occupied slots per bucket instead
+     */
+    min = Bucket::SIZE;
+    max = 0;
+
+    for (quint32 i = 0; i <= table->mask; i++) {
+        qint32 numUsed = 0;
+        for (int j = 0; j < Bucket::SIZE; j++) {
+            if (table->buckets[i].values[j].load(std::memory_order_relaxed)) {
+                numUsed++;
+            }
+        }
+
+        min = qMin(min, numUsed);
+        max = qMax(max, numUsed);
+    }
+}
+
+#endif // KIS_TILEHASHTABLE_3_H
@@ -6,7 +6,15 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <memory>
+#include <vector>
+
+#include <QAtomicInt>
+#include <QGlobalStatic>
 #include <QRect>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <QVector>
 
 #include "kis_tile.h"
@@ -14,12 +22,79 @@
 #include "kis_tile_data_wrapper.h"
 #include "kis_tiled_data_manager_p.h"
 #include "kis_memento_manager.h"
+#include "KisTileSavingCache.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
 
 #include "kis_paint_device_writer.h"
 
 #include "kis_global.h"
+#include "kis_assert.h"
+
+namespace {
+
+/**
+ * The devices with fewer tiles are (de)compressed in the calling thread,
+ * the overhead of the pool is not worth it
+ */
+const int minTilesForParallelProcessing = 256;
+const int tilesPerChunk = 32;
+
+/**
+ * The pool is separate from the global one to not compete with the
+ * other users of it (e.g. QtConcurrent) and to not block them for the
+ * duration of the saving or loading
+ */
+Q_GLOBAL_STATIC(QThreadPool, s_tileProcessingPool)
+
+class KisBufferPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    bool write(const QByteArray &data) override {
+        buffer.append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        buffer.append(data, length);
+        return true;
+    }
+
+    QByteArray buffer;
+};
+
+struct CompressedTile
+{
+    KisTileSP tile;
+    QByteArray data;
+};
+
+struct WritingChunk
+{
+    QVector<KisTileSP> tiles;
+    KisBufferPaintDeviceWriter writer;
+    bool success = true;
+    QSemaphore done;
+};
+
+template <typename Func>
+class FunctionRunnable : public QRunnable
+{
+public:
+    FunctionRunnable(Func func) : m_func(func) {}
+    void run() override { m_func(); }
+
+private:
+    Func m_func;
+};
+
+template <typename Func>
+QRunnable* createRunnable(Func func)
+{
+    return new FunctionRunnable<Func>(func);
+}
+
+}
 
 
 /* The data area is divided into tiles each say 64x64 pixels (defined at compile time)
@@ -40,6 +115,9 @@ KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
     m_pixelSize = pixelSize;
     m_defaultPixel = new quint8[m_pixelSize];
     setDefaultPixel(defaultPixel);
+
+    m_registeredForDeduplication =
+        KisTileDataStore::instance()->tryRegisterDataManager(this);
 }
 
 KisTiledDataManager::KisTiledDataManager(const KisTiledDataManager &dm)
@@ -64,6 +142,9 @@ KisTiledDataManager::KisTiledDataManager(const KisTiledDataManager &dm)
      */
     memcpy(m_defaultPixel, dm.m_defaultPixel, m_pixelSize);
     recalculateExtent();
+
+    m_registeredForDeduplication =
+        KisTileDataStore::instance()->tryRegisterDataManager(this);
 }
 
 KisTiledDataManager::~KisTiledDataManager()
@@ -76,6 +157,11 @@ KisTiledDataManager::~KisTiledDataManager()
      * Manager should be alive during  that destruction. We could  use shared
      * pointers instead, but they create too much overhead.
      */
+
+    if (m_registeredForDeduplication) {
+        KisTileDataStore::instance()->unregisterDataManager(this);
+    }
+
     delete m_hashTable;
     delete m_mementoManager;
 
@@ -101,35 +187,234 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 {
     QReadLocker locker(&m_lock);
 
+    QVector<KisTileSP> tiles;
+    tiles.reserve(m_hashTable->numTiles());
+
+    for (KisTileHashTableConstIterator iter(m_hashTable); iter.tile(); iter.next()) {
+        tiles.append(iter.tile());
+    }
+
+    return writeTiles(tiles, store);
+}
+
+bool KisTiledDataManager::writeDelta(KisPaintDeviceWriter &store, KisTiledDataManager *baseDM)
+{
+    QReadLocker locker(&m_lock);
+    QReadLocker baseLocker(&baseDM->m_lock);
+
+    QVector<KisTileSP> tiles;
+
+    for (KisTileHashTableConstIterator iter(m_hashTable); iter.tile(); iter.next()) {
+        KisTileSP tile = iter.tile();
+
+        bool baseTileExists = false;
+        KisTileSP baseTile = baseDM->getReadOnlyTileLazy(tile->col(), tile->row(), baseTileExists);
+
+        if (!baseTileExists || baseTile->tileData() != tile->tileData()) {
+            tiles.append(tile);
+        }
+    }
+
+    /**
+     * The tiles that exist in the base only should be reset to the
+     * default pixel of this data manager explicitly, otherwise
+     * addMissingTiles() would bring them back on loading
+     */
+    for (KisTileHashTableConstIterator iter(baseDM->m_hashTable); iter.tile(); iter.next()) {
+        KisTileSP baseTile = iter.tile();
+
+        bool tileExists = false;
+        KisTileSP tile = getReadOnlyTileLazy(baseTile->col(), baseTile->row(), tileExists);
+
+        if (!tileExists) {
+            tiles.append(tile);
+        }
+    }
+
+    return writeTiles(tiles, store);
+}
+
+void KisTiledDataManager::addMissingTiles(KisTiledDataManager *baseDM)
+{
+    QWriteLocker locker(&m_lock);
+    QReadLocker baseLocker(&baseDM->m_lock);
+
+    for (KisTileHashTableConstIterator iter(baseDM->m_hashTable); iter.tile(); iter.next()) {
+        KisTileSP baseTile = iter.tile();
+        const qint32 col = baseTile->col();
+        const qint32 row = baseTile->row();
+
+        if (m_hashTable->tileExists(col, row)) continue;
+
+        baseTile->lockForRead();
+        KisTileSP clonedTile = KisTileSP(new KisTile(col, row, baseTile->tileData(), m_mementoManager));
+        baseTile->unlockForRead();
+
+        m_hashTable->addTile(clonedTile);
+        m_extentManager.notifyTileAdded(col, row);
+    }
+}
+
+int KisTiledDataManager::numSharedTiles(KisTiledDataManager *otherDM)
+{
+    QReadLocker locker(&m_lock);
+    QReadLocker otherLocker(&otherDM->m_lock);
+
+    int numShared = 0;
+
+    for (KisTileHashTableConstIterator iter(m_hashTable); iter.tile(); iter.next()) {
+        KisTileSP tile = iter.tile();
+
+        bool otherTileExists = false;
+        KisTileSP otherTile = otherDM->getReadOnlyTileLazy(tile->col(), tile->row(), otherTileExists);
+
+        if (otherTileExists && otherTile->tileData() == tile->tileData()) {
+            numShared++;
+        }
+    }
+
+    return numShared;
+}
+
+bool KisTiledDataManager::writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store)
+{
     bool retval = true;
 
+    /**
+     * When the in-memory tiles are bigger than the ones in the file,
+     * every tile is split into FILE_TILE_WIDTH x FILE_TILE_HEIGHT
+     * chunks on saving
+     */
+    const bool splitTiles =
+        KisTileData::WIDTH != FILE_TILE_WIDTH ||
+        KisTileData::HEIGHT != FILE_TILE_HEIGHT;
+
+    const quint32 numFileTiles = tiles.size() *
+        (KisTileData::WIDTH / FILE_TILE_WIDTH) *
+        (KisTileData::HEIGHT / FILE_TILE_HEIGHT);
+
     if(CURRENT_VERSION == LEGACY_VERSION) {
         char str[80];
-        sprintf(str, "%d\n", m_hashTable->numTiles());
+        sprintf(str, "%d\n", numFileTiles);
         retval = store.write(str, strlen(str));
     }
     else {
-        retval = writeTilesHeader(store, m_hashTable->numTiles());
+        retval = writeTilesHeader(store, numFileTiles);
     }
 
+    if (tiles.size() >= minTilesForParallelProcessing &&
+        s_tileProcessingPool->maxThreadCount() > 1) {
 
-    KisTileHashTableConstIterator iter(m_hashTable);
-    KisTileSP tile;
+        return retval && writeTilesParallel(tiles, splitTiles, store);
+    }
 
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION, store.tileCompressionEnabled());
 
-    while ((tile = iter.tile())) {
-        retval = compressor->writeTile(tile, store);
+    Q_FOREACH (KisTileSP tile, tiles) {
+        retval = writeTile(compressor.data(), tile, splitTiles, store.tileSavingCache(), store);
         if (!retval) {
             warnFile << "Failed to write tile";
             break;
         }
-        iter.next();
     }
 
     return retval;
 }
+
+bool KisTiledDataManager::writeTile(KisAbstractTileCompressor *compressor, KisTileSP tile,
+                                    bool splitTiles, KisTileSavingCache *cache,
+                                    KisPaintDeviceWriter &store)
+{
+    if (cache) {
+        QByteArray data;
+
+        if (!cache->fetch(tile->tileData(), tile->col(), tile->row(), &data)) {
+            KisBufferPaintDeviceWriter buffer;
+            if (!writeTile(compressor, tile, splitTiles, nullptr, buffer)) {
+                return false;
+            }
+
+            data = buffer.buffer;
+            cache->insert(tile->tileData(), tile->col(), tile->row(), data);
+        }
+
+        return store.write(data);
+    }
+
+    return splitTiles ?
+        writeTileSplit(compressor, tile, store) :
+        compressor->writeTile(tile, store);
+}
+
+bool KisTiledDataManager::writeTilesParallel(const QVector<KisTileSP> &tiles, bool splitTiles,
+                                             KisPaintDeviceWriter &store)
+{
+    /**
+     * The tiles are compressed in chunks on the pool, and the calling
+     * thread appends the finished chunks to the store in their original
+     * order, so the result is byte-for-byte the same as the one of the
+     * sequential writing. The number of the chunks in flight is limited
+     * to keep the memory footprint of the compressed data bounded.
+     */
+    const int numChunks = (tiles.size() + tilesPerChunk - 1) / tilesPerChunk;
+    const int maxChunksInFlight = 4 * s_tileProcessingPool->maxThreadCount();
+
+    KisTileSavingCache *cache = store.tileSavingCache();
+    const bool compressionEnabled = store.tileCompressionEnabled();
+
+    std::vector<std::unique_ptr<WritingChunk>> chunks(numChunks);
+    int numSubmittedChunks = 0;
+
+    auto submitNextChunk = [&] () {
+        WritingChunk *chunk = new WritingChunk();
+        chunk->tiles = tiles.mid(numSubmittedChunks * tilesPerChunk, tilesPerChunk);
+        chunks[numSubmittedChunks++].reset(chunk);
+
+        s_tileProcessingPool->start(createRunnable([this, chunk, splitTiles, cache, compressionEnabled] () {
+            KisAbstractTileCompressorSP compressor =
+                KisTileCompressorFactory::create(CURRENT_VERSION, compressionEnabled);
+
+            Q_FOREACH (KisTileSP tile, chunk->tiles) {
+                if (!writeTile(compressor.data(), tile, splitTiles, cache, chunk->writer)) {
+                    chunk->success = false;
+                    break;
+                }
+            }
+
+            chunk->done.release();
+        }));
+    };
+
+    while (numSubmittedChunks < qMin(numChunks, maxChunksInFlight)) {
+        submitNextChunk();
+    }
+
+    bool retval = true;
+
+    for (int i = 0; i < numSubmittedChunks; i++) {
+        WritingChunk *chunk = chunks[i].get();
+        chunk->done.acquire();
+
+        if (retval) {
+            retval = chunk->success && store.write(chunk->writer.buffer);
+            if (!retval) {
+                warnFile << "Failed to write tile";
+            }
+        }
+
+        // don't submit anything new after a failure, but wait for
+        // the chunks that are still in progress
+        chunks[i].reset();
+
+        if (retval && numSubmittedChunks < numChunks) {
+            submitNextChunk();
+        }
+    }
+
+    return retval;
+}
+
 bool KisTiledDataManager::read(QIODevice *stream)
 {
     clear();
@@ -149,6 +434,10 @@ bool KisTiledDataManager::read(QIODevice *stream)
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
 
+    // legacy files have no header and always store 64x64 tiles
+    qint32 tileWidth = FILE_TILE_WIDTH;
+    qint32 tileHeight = FILE_TILE_HEIGHT;
+
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
 
@@ -157,7 +446,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, tileWidth, tileHeight))
             return false;
     }
     else {
@@ -168,16 +457,152 @@ bool KisTiledDataManager::read(QIODevice *stream)
         KisTileCompressorFactory::create(tilesVersion);
 
     bool readSuccess = true;
+
+    if (tileWidth != KisTileData::WIDTH || tileHeight != KisTileData::HEIGHT) {
+        readSuccess = readTilesSplit(compressor.data(), stream,
+                                     numTiles, tileWidth, tileHeight);
+    } else if (tilesVersion != LEGACY_VERSION &&
+               KisTileDataStore::instance()->lazyTileLoadingEnabled()) {
+
+        readSuccess = readTilesLazily(compressor.data(), stream, numTiles);
+    } else if (tilesVersion != LEGACY_VERSION &&
+               numTiles >= quint32(minTilesForParallelProcessing) &&
+               s_tileProcessingPool->maxThreadCount() > 1) {
+
+        readSuccess = readTilesParallel(compressor.data(), tilesVersion, stream, numTiles);
+    } else {
+        for (quint32 i = 0; i < numTiles; i++) {
+            if (!compressor->readTile(stream, this)) {
+                readSuccess = false;
+            }
+        }
+    }
+
+    m_mementoManager->commit();
+    return readSuccess;
+}
+
+bool KisTiledDataManager::readTilesLazily(KisAbstractTileCompressor *compressor,
+                                          QIODevice *stream, quint32 numTiles)
+{
+    KisTileCompressor2 *compressor2 = dynamic_cast<KisTileCompressor2*>(compressor);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(compressor2, false);
+
+    const QString compressionName = compressor2->compressionName();
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    bool readSuccess = true;
+
     for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
+        KisTileSP tile;
+        QByteArray data;
+
+        if (!compressor->readTileCompressed(stream, this, tile, data)) {
+            readSuccess = false;
+            continue;
+        }
+
+        // detach the tile data from the default one, see readTilesParallel()
+        tile->lockForWrite();
+        tile->unlockForWrite();
+
+        /**
+         * If the swap uses the same compression as the file, the
+         * compressed data goes to the swap as it is, otherwise the
+         * tile is just decompressed in place
+         */
+        if (store->trySwapOutCompressedTileData(tile->tileData(), data, compressionName)) {
+            continue;
+        }
+
+        tile->lockForWrite();
+        if (!compressor->decompressTileData(reinterpret_cast<quint8*>(data.data()), data.size(),
+                                            tile->tileData())) {
             readSuccess = false;
         }
+        tile->unlockForWrite();
     }
 
-    m_mementoManager->commit();
     return readSuccess;
 }
 
+bool KisTiledDataManager::readTilesParallel(KisAbstractTileCompressor *compressor, qint32 tilesVersion,
+                                            QIODevice *stream, quint32 numTiles)
+{
+    /**
+     * The stream can be read sequentially only, so the calling thread
+     * reads the headers and the compressed data of the tiles, and the
+     * decompression is done on the pool. The number of the chunks in
+     * flight is limited to keep the memory footprint bounded.
+     */
+    const int maxChunksInFlight = 4 * s_tileProcessingPool->maxThreadCount();
+    QSemaphore freeChunkSlots(maxChunksInFlight);
+    QAtomicInt decompressionFailed;
+
+    bool readSuccess = true;
+
+    auto submitChunk = [&] (QVector<CompressedTile> chunk) {
+        freeChunkSlots.acquire();
+
+        s_tileProcessingPool->start(createRunnable([chunk, tilesVersion, &freeChunkSlots, &decompressionFailed] () mutable {
+            KisAbstractTileCompressorSP compressor =
+                KisTileCompressorFactory::create(tilesVersion);
+
+            for (CompressedTile &compressedTile : chunk) {
+                QByteArray &data = compressedTile.data;
+
+                compressedTile.tile->lockForWrite();
+                const bool result =
+                    compressor->decompressTileData(reinterpret_cast<quint8*>(data.data()), data.size(),
+                                                   compressedTile.tile->tileData());
+                compressedTile.tile->unlockForWrite();
+
+                if (!result) {
+                    decompressionFailed.storeRelease(1);
+                }
+            }
+
+            freeChunkSlots.release();
+        }));
+    };
+
+    QVector<CompressedTile> chunk;
+    chunk.reserve(tilesPerChunk);
+
+    for (quint32 i = 0; i < numTiles; i++) {
+        CompressedTile compressedTile;
+
+        if (!compressor->readTileCompressed(stream, this, compressedTile.tile, compressedTile.data)) {
+            readSuccess = false;
+            continue;
+        }
+
+        /**
+         * Detach the tile data from the default one right here, so
+         * that the memento manager, which is not thread-safe, would
+         * register the tile change in the calling thread
+         */
+        compressedTile.tile->lockForWrite();
+        compressedTile.tile->unlockForWrite();
+
+        chunk.append(compressedTile);
+
+        if (chunk.size() >= tilesPerChunk) {
+            submitChunk(chunk);
+            chunk.clear();
+        }
+    }
+
+    if (!chunk.isEmpty()) {
+        submitChunk(chunk);
+    }
+
+    // wait for all the chunks to be decompressed
+    freeChunkSlots.acquire(maxChunksInFlight);
+
+    return readSuccess && !decompressionFailed.loadAcquire();
+}
+
 bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles)
 {
     QString buffer;
@@ -188,8 +613,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
                      "PIXELSIZE %4\n"
                      "DATA %5\n")
         .arg(CURRENT_VERSION)
-        .arg(KisTileData::WIDTH)
-        .arg(KisTileData::HEIGHT)
+        .arg(FILE_TILE_WIDTH)
+        .arg(FILE_TILE_HEIGHT)
         .arg(pixelSize())
         .arg(numTiles);
 
@@ -206,7 +631,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                                             qint32 &tileWidth, qint32 &tileHeight)
 {
     /**
      * We assume that there is only one version of this header
@@ -226,12 +652,14 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
         takeOneLine(stream, maxLineLength, keyword, value);
 
         if (keyword == "TILEWIDTH") {
-            if(value != KisTileData::WIDTH)
+            if(value != KisTileData::WIDTH && value != FILE_TILE_WIDTH)
                 goto wrongString;
+            tileWidth = value;
         }
         else if (keyword == "TILEHEIGHT") {
-            if(value != KisTileData::HEIGHT)
+            if(value != KisTileData::HEIGHT && value != FILE_TILE_HEIGHT)
                 goto wrongString;
+            tileHeight = value;
         }
         else if (keyword == "PIXELSIZE") {
             if((quint32)value != pixelSize())
@@ -260,6 +688,64 @@ wrongString:
     return false;
 }
 
+bool KisTiledDataManager::writeTileSplit(KisAbstractTileCompressor *compressor,
+                                         KisTileSP tile,
+                                         KisPaintDeviceWriter &store)
+{
+    const qint32 pixelSize = this->pixelSize();
+    const qint32 tileRowStride = KisTileData::WIDTH * pixelSize;
+    const qint32 fileRowStride = FILE_TILE_WIDTH * pixelSize;
+    QByteArray buffer(FILE_TILE_HEIGHT * fileRowStride, 0);
+
+    bool retval = true;
+
+    const QRect tileRect = tile->extent();
+
+    for (qint32 subY = 0; retval && subY < KisTileData::HEIGHT; subY += FILE_TILE_HEIGHT) {
+        for (qint32 subX = 0; retval && subX < KisTileData::WIDTH; subX += FILE_TILE_WIDTH) {
+            quint8 *dst = reinterpret_cast<quint8*>(buffer.data());
+
+            tile->lockForRead();
+            const quint8 *src = tile->data() + subY * tileRowStride + subX * pixelSize;
+            for (qint32 row = 0; row < FILE_TILE_HEIGHT; row++) {
+                memcpy(dst, src, fileRowStride);
+                src += tileRowStride;
+                dst += fileRowStride;
+            }
+            tile->unlockForRead();
+
+            const QRect rect(tileRect.x() + subX, tileRect.y() + subY,
+                             FILE_TILE_WIDTH, FILE_TILE_HEIGHT);
+
+            retval = compressor->writeTileRect(reinterpret_cast<const quint8*>(buffer.constData()),
+                                               rect, pixelSize, store);
+        }
+    }
+
+    return retval;
+}
+
+bool KisTiledDataManager::readTilesSplit(KisAbstractTileCompressor *compressor, QIODevice *stream,
+                                         quint32 numTiles, qint32 tileWidth, qint32 tileHeight)
+{
+    const qint32 pixelSize = this->pixelSize();
+    QByteArray buffer(tileWidth * tileHeight * pixelSize, 0);
+
+    bool readSuccess = true;
+    for (quint32 i = 0; i < numTiles; i++) {
+        QPoint topLeft;
+        if (compressor->readTileRect(stream, pixelSize, tileWidth, tileHeight,
+                                     reinterpret_cast<quint8*>(buffer.data()), topLeft)) {
+            writeBytesBody(reinterpret_cast<const quint8*>(buffer.constData()),
+                           topLeft.x(), topLeft.y(), tileWidth, tileHeight);
+        } else {
+            readSuccess = false;
+        }
+    }
+
+    return readSuccess;
+}
+
 void KisTiledDataManager::purge(const QRect& area)
 {
     QList<KisTileSP> tilesToDelete;
@@ -430,7 +916,7 @@ void KisTiledDataManager::clear()
 
 
 template<bool useOldSrcData>
-void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect)
+void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect, const QPoint &tileOffset)
 {
     if (rect.isEmpty()) return;
 
@@ -440,6 +926,14 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
 
     const quint32 rowStride = KisTileData::WIDTH * pixelSize;
 
+    /**
+     * The rect is passed in the coordinates of the source, the tiles
+     * are written \p tileOffset tiles away from their source position.
+     * The offsets inside the tiles are the same in both managers.
+     */
+    const qint32 dColumn = tileOffset.x();
+    const qint32 dRow = tileOffset.y();
+
     qint32 firstColumn = xToCol(rect.left());
     qint32 lastColumn = xToCol(rect.right());
 
@@ -463,21 +957,21 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
             if (cloneTileRect == tileRect) {
                  // Clone whole tile
                  const bool wasDeleted =
-                     m_hashTable->deleteTile(column, row);
+                     m_hashTable->deleteTile(column + dColumn, row + dRow);
 
                  if (srcTileExists || !defaultPixelsCoincide) {
                      srcTile->lockForRead();
                      KisTileData *td = srcTile->tileData();
-                     KisTileSP clonedTile = KisTileSP(new KisTile(column, row, td, m_mementoManager));
+                     KisTileSP clonedTile = KisTileSP(new KisTile(column + dColumn, row + dRow, td, m_mementoManager));
                      srcTile->unlockForRead();
 
                      m_hashTable->addTile(clonedTile);
 
                      if (!wasDeleted) {
-                         m_extentManager.notifyTileAdded(column, row);
+                         m_extentManager.notifyTileAdded(column + dColumn, row + dRow);
                      }
                  } else if (wasDeleted) {
-                     m_extentManager.notifyTileRemoved(column, row);
+                     m_extentManager.notifyTileRemoved(column + dColumn, row + dRow);
                  }
 
             } else {
@@ -485,8 +979,8 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
                 qint32 rowsRemaining = cloneTileRect.height();
 
                 KisTileDataWrapper tw(this,
-                                      cloneTileRect.left(),
-                                      cloneTileRect.top(),
+                                      cloneTileRect.left() + dColumn * KisTileData::WIDTH,
+                                      cloneTileRect.top() + dRow * KisTileData::HEIGHT,
                                       KisTileDataWrapper::WRITE);
                 srcTile->lockForRead();
                 // We suppose that the shift in both tiles is the same
@@ -559,12 +1053,17 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
 
 void KisTiledDataManager::bitBlt(KisTiledDataManager *srcDM, const QRect &rect)
 {
-    bitBltImpl<false>(srcDM, rect);
+    bitBltImpl<false>(srcDM, rect, QPoint());
+}
+
+void KisTiledDataManager::bitBlt(KisTiledDataManager *srcDM, const QRect &rect, const QPoint &tileOffset)
+{
+    bitBltImpl<false>(srcDM, rect, tileOffset);
 }
 
 void KisTiledDataManager::bitBltOldData(KisTiledDataManager *srcDM, const QRect &rect)
 {
-    bitBltImpl<true>(srcDM, rect);
+    bitBltImpl<true>(srcDM, rect, QPoint());
 }
 
 void KisTiledDataManager::bitBltRough(KisTiledDataManager *srcDM, const QRect &rect)
@@ -577,6 +1076,60 @@ void KisTiledDataManager::bitBltRoughOldData(KisTiledDataManager *srcDM, const Q
     bitBltRoughImpl<true>(srcDM, rect);
 }
 
+int KisTiledDataManager::deduplicateTiles(KisTileDataDeduplicationIndex &index)
+{
+    QReadLocker locker(&m_lock);
+
+    int numDeduplicated = 0;
+
+    KisTileHashTableIterator iter(m_hashTable);
+
+    while (!iter.isDone()) {
+        KisTileSP tile = iter.tile();
+
+        if (tile->tryDeduplicate(index)) {
+            numDeduplicated++;
+        }
+
+        iter.next();
+    }
+
+    return numDeduplicated;
+}
+
+void KisTiledDataManager::prefetchRect(const QRect &rect)
+{
+    if (rect.isEmpty()) return;
+
+    QVector<KisTileData*> swappedTiles;
+
+    /**
+     * Prefetching is just a hint, so it should never
+     * block the caller, which is usually the GUI thread
+     */
+    if (!m_lock.tryLockForRead()) return;
+
+    const QRect tilesRect =
+        QRect(QPoint(xToCol(rect.left()), yToRow(rect.top())),
+              QPoint(xToCol(rect.right()), yToRow(rect.bottom())));
+
+    for (qint32 row = tilesRect.top(); row <= tilesRect.bottom(); row++) {
+        for (qint32 col = tilesRect.left(); col <= tilesRect.right(); col++) {
+            KisTileSP tile = m_hashTable->getExistingTile(col, row);
+            if (!tile) continue;
+
+            KisTileData *td = tile->refSwappedOutTileData();
+            if (td) {
+                swappedTiles.append(td);
+            }
+        }
+    }
+
+    m_lock.unlock();
+
+    KisTileDataStore::instance()->prefetchTileData(swappedTiles);
+}
+
 void KisTiledDataManager::setExtent(qint32 x, qint32 y, qint32 w, qint32 h)
 {
     setExtent(QRect(x, y, w, h));
@@ -675,6 +1228,55 @@ KisRegion KisTiledDataManager::region() const
     return KisRegion(std::move(rects));
 }
 
+KisTiledDataManager::TileRevisions KisTiledDataManager::tileRevisions() const
+{
+    TileRevisions revisions;
+    KisTileSP tile;
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    while ((tile = iter.tile())) {
+        revisions.insert(qMakePair(tile->col(), tile->row()), tile->tileData()->revision());
+        iter.next();
+    }
+
+    return revisions;
+}
+
+KisRegion KisTiledDataManager::changedRegion(const TileRevisions &revisions) const
+{
+    QVector<QRect> rects;
+    KisTileSP tile;
+    int numKnownTiles = 0;
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    while ((tile = iter.tile())) {
+        auto it = revisions.constFind(qMakePair(tile->col(), tile->row()));
+        if (it == revisions.constEnd() || *it != tile->tileData()->revision()) {
+            rects << tile->extent();
+        }
+
+        if (it != revisions.constEnd()) {
+            numKnownTiles++;
+        }
+        iter.next();
+    }
+
+    /**
+     * Some tiles have been removed since the revisions were taken
+     */
+    if (numKnownTiles < revisions.size()) {
+        for (auto it = revisions.constBegin(); it != revisions.constEnd(); ++it) {
+            if (!m_hashTable->tileExists(it.key().first, it.key().second)) {
+                rects << QRect(it.key().first * KisTileData::WIDTH,
+                               it.key().second * KisTileData::HEIGHT,
+                               KisTileData::WIDTH, KisTileData::HEIGHT);
+            }
+        }
+    }
+
+    return KisRegion(std::move(rects));
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
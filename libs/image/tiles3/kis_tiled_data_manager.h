@@ -9,6 +9,8 @@
 
 #include <QtGlobal>
 #include <QVector>
+#include <QHash>
+#include <QPair>
 #include <KisRegion.h>
 
 #include <kis_shared.h>
@@ -33,7 +35,10 @@ typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
 
 class KisTiledIterator;
 class KisTiledRandomAccessor;
+class KisTileDataDeduplicationIndex;
+class KisTileSavingCache;
 class KisPaintDeviceWriter;
+class KisAbstractTileCompressor;
 class QIODevice;
 
 /**
@@ -58,6 +63,14 @@ private:
     static const qint32 LEGACY_VERSION = 1;
     static const qint32 CURRENT_VERSION = 2;
 
+    /**
+     * The tiles are always saved into the files in 64x64 chunks
+     * to keep the files compatible between the builds with
+     * different KisTileData::WIDTH/HEIGHT
+     */
+    static const qint32 FILE_TILE_WIDTH = 64;
+    static const qint32 FILE_TILE_HEIGHT = 64;
+
 protected:
     /*FIXME:*/
 public:
@@ -75,6 +88,7 @@ protected:
     friend class KisTiledRandomAccessor;
     friend class KisRandomAccessor2;
     friend class KisStressJob;
+    friend class KisTiledDataManagerTest;
 
 public:
     void setDefaultPixel(const quint8 *defPixel);
@@ -192,6 +206,22 @@ public:
 
     static void releaseInternalPools();
 
+    /**
+     * Makes the tiles of the data manager share tile data objects
+     * with identical content registered in \p index. Used by
+     * KisTileDataStore::deduplicateTileData()
+     *
+     * \return the number of tiles switched to a shared tile data
+     */
+    int deduplicateTiles(KisTileDataDeduplicationIndex &index);
+
+    /**
+     * Asks the tile data store to swap in the tiles covering
+     * \p rect in the background. Tiles that have never been
+     * created are not touched.
+     */
+    void prefetchRect(const QRect &rect);
+
 protected:
     /**
      * Reads and writes the tiles
@@ -199,6 +229,30 @@ protected:
     bool write(KisPaintDeviceWriter &store);
     bool read(QIODevice *stream);
 
+    /**
+     * Writes only the tiles that don't share their tile data with the
+     * tiles of \p baseDM at the same positions. The positions where
+     * \p baseDM has a tile and this data manager has none are written
+     * as default tiles. The result is a usual tiles stream, which
+     * gives the original content when read with read() and completed
+     * with addMissingTiles(baseDM).
+     */
+    bool writeDelta(KisPaintDeviceWriter &store, KisTiledDataManager *baseDM);
+
+    /**
+     * Shares (copy-on-write) the tiles of \p baseDM at the positions
+     * where this data manager has no tiles yet.
+     *
+     * \see writeDelta()
+     */
+    void addMissingTiles(KisTiledDataManager *baseDM);
+
+    /**
+     * \return the number of tiles sharing their tile data with the
+     *         tiles of \p otherDM at the same positions
+     */
+    int numSharedTiles(KisTiledDataManager *otherDM);
+
     void purge(const QRect& area);
 
     inline quint32 pixelSize() const {
@@ -216,6 +270,24 @@ public:
 
     KisRegion region() const;
 
+    typedef QHash<QPair<qint32, qint32>, quint64> TileRevisions;
+
+    /**
+     * Returns the revisions of the tile data of all the tiles of the
+     * data manager, see KisTileData::revision(). Unlike a copy-on-write
+     * clone, the revisions neither keep the tile data alive nor make
+     * the next write into the tiles copy them.
+     */
+    TileRevisions tileRevisions() const;
+
+    /**
+     * Returns the region covered by the tiles whose revision differs
+     * from the one in \p revisions, taken earlier with tileRevisions(),
+     * including the tiles added or removed since then. Pixels are
+     * never read.
+     */
+    KisRegion changedRegion(const TileRevisions &revisions) const;
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
@@ -230,6 +302,13 @@ public:
      */
     void bitBlt(KisTiledDataManager *srcDM, const QRect &rect);
 
+    /**
+     * The same as \ref bitBlt(), but the cloned area is moved by
+     * \p tileOffset tiles. \p rect is passed in the coordinates
+     * of \p srcDM.
+     */
+    void bitBlt(KisTiledDataManager *srcDM, const QRect &rect, const QPoint &tileOffset);
+
     /**
      * The same as \ref bitBlt(), but reads old data
      */
@@ -340,6 +419,8 @@ private:
 
     mutable QReadWriteLock m_lock;
 
+    bool m_registeredForDeduplication = false;
+
 private:
     // Allow compression routines to calculate (col,row) coordinates
     // and pixel size
@@ -357,8 +438,24 @@ private:
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
+    bool writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store);
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                            qint32 &tileWidth, qint32 &tileHeight);
+
+    bool writeTile(KisAbstractTileCompressor *compressor, KisTileSP tile,
+                   bool splitTiles, KisTileSavingCache *cache,
+                   KisPaintDeviceWriter &store);
+    bool writeTileSplit(KisAbstractTileCompressor *compressor, KisTileSP tile,
+                        KisPaintDeviceWriter &store);
+    bool writeTilesParallel(const QVector<KisTileSP> &tiles, bool splitTiles,
+                            KisPaintDeviceWriter &store);
+    bool readTilesLazily(KisAbstractTileCompressor *compressor,
+                         QIODevice *stream, quint32 numTiles);
+    bool readTilesParallel(KisAbstractTileCompressor *compressor, qint32 tilesVersion,
+                           QIODevice *stream, quint32 numTiles);
+    bool readTilesSplit(KisAbstractTileCompressor *compressor, QIODevice *stream,
+                        quint32 numTiles, qint32 tileWidth, qint32 tileHeight);
 
     inline qint32 divideRoundDown(qint32 x, const qint32 y) const
     {
@@ -375,7 +472,7 @@ private:
     quint8* duplicatePixel(qint32 num, const quint8 *pixel);
 
     template<bool useOldSrcData>
-        void bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect);
+        void bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect, const QPoint &tileOffset);
     template<bool useOldSrcData>
         void bitBltRoughImpl(KisTiledDataManager *srcDM, const QRect &rect);
 
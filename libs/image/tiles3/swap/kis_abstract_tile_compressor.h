@@ -43,6 +43,41 @@ public:
      */
     virtual bool readTile(QIODevice *stream, KisTiledDataManager *dm) = 0;
 
+    /**
+     * Reads the header and the compressed data of the next tile from
+     * the \p stream, but doesn't decompress it. The tile is created in
+     * \p dm and returned in \p tile, the compressed data is returned in
+     * \p data and can be decompressed later with decompressTileData(),
+     * possibly in another thread and by another instance of the compressor.
+     *
+     * \see readTile()
+     */
+    virtual bool readTileCompressed(QIODevice *stream, KisTiledDataManager *dm,
+                                    KisTileSP &tile, QByteArray &data) = 0;
+
+    /**
+     * Compresses a linear block of pixels \p data covering \p rect
+     * and writes it into the \p stream with the same header as
+     * writeTile() would do. Used by datamanager when the tiles layout
+     * of the file differs from the in-memory one.
+     *
+     * \see readTileRect()
+     */
+    virtual bool writeTileRect(const quint8 *data, const QRect &rect,
+                               qint32 pixelSize, KisPaintDeviceWriter &store) = 0;
+
+    /**
+     * Reads a tile of \p tileWidth x \p tileHeight pixels from the
+     * \p stream into a linear buffer \p data, which should be big
+     * enough to hold it. The position of the tile is returned in
+     * \p topLeft.
+     *
+     * \see writeTileRect()
+     */
+    virtual bool readTileRect(QIODevice *stream, qint32 pixelSize,
+                              qint32 tileWidth, qint32 tileHeight,
+                              quint8 *data, QPoint &topLeft) = 0;
+
     /**
      * Compresses a \p tileData and writes it into the \p buffer.
      * The buffer must be at least tileDataBufferSize() bytes long.
@@ -76,6 +76,40 @@ KisChunk KisChunkAllocator::getChunk(quint64 size)
     return KisChunk(m_list.end());
 }
 
+QVector<KisChunk> KisChunkAllocator::getContiguousChunks(const QVector<quint64> &sizes)
+{
+    QVector<KisChunk> result;
+    if (sizes.isEmpty()) return result;
+
+    quint64 totalSize = 0;
+    Q_FOREACH (quint64 size, sizes) {
+        totalSize += size;
+    }
+
+    /**
+     * Allocate a single chunk for the whole run first and then split
+     * it into the requested pieces. After getChunk() m_iterator points
+     * to the position right after the allocated chunk, so the new pieces
+     * are inserted in front of it and the iterator stays valid.
+     */
+    KisChunkDataListIterator it = getChunk(totalSize).position();
+    KisChunkDataListIterator nextIt = it;
+    ++nextIt;
+
+    quint64 begin = it->m_begin;
+    it->setChunk(begin, sizes.first());
+    result.append(KisChunk(it));
+    begin += sizes.first();
+
+    for (int i = 1; i < sizes.size(); i++) {
+        it = m_list.insert(nextIt, KisChunkData(begin, sizes[i]));
+        result.append(KisChunk(it));
+        begin += sizes[i];
+    }
+
+    return result;
+}
+
 bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
                                        KisChunkDataListIterator &iterator,
                                        quint64 size)
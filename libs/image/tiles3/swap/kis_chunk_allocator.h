@@ -8,6 +8,7 @@
 #define __KIS_CHUNK_LIST_H
 
 #include <QLinkedList>
+#include <QVector>
 #include "kritaimage_export.h"
 
 #define MiB (1ULL << 20)
@@ -125,6 +126,14 @@ public:
     }
 
     KisChunk getChunk(quint64 size);
+
+    /**
+     * Allocates a set of chunks of \p sizes that follow each other
+     * in the store without any gaps, so the whole set can be written
+     * in one go. Every chunk of the run should be freed separately.
+     */
+    QVector<KisChunk> getContiguousChunks(const QVector<quint64> &sizes);
+
     void freeChunk(KisChunk chunk);
 
     void debugChunks();
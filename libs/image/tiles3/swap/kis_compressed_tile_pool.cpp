@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_compressed_tile_pool.h"
+
+#include "kis_assert.h"
+
+
+KisCompressedTilePool::KisCompressedTilePool(qint64 maxSize)
+    : m_maxSize(maxSize)
+{
+}
+
+void KisCompressedTilePool::add(KisTileData *td, const quint8 *data, qint32 size)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_tiles.contains(td));
+
+    Entry entry;
+    entry.data = QByteArray(reinterpret_cast<const char*>(data), size);
+    entry.seqNo = m_nextSeqNo++;
+
+    m_order.insert(entry.seqNo, td);
+    m_tiles.insert(td, entry);
+
+    m_totalSize += size;
+}
+
+bool KisCompressedTilePool::take(KisTileData *td, QByteArray &data)
+{
+    auto it = m_tiles.find(td);
+    if (it == m_tiles.end()) return false;
+
+    data = it->data;
+    m_order.remove(it->seqNo);
+    m_totalSize -= data.size();
+    m_tiles.erase(it);
+
+    return true;
+}
+
+bool KisCompressedTilePool::takeOldest(KisTileData *&td, QByteArray &data)
+{
+    if (m_order.isEmpty()) return false;
+
+    td = m_order.first();
+    return take(td, data);
+}
+
+qint32 KisCompressedTilePool::numTiles() const
+{
+    return m_tiles.size();
+}
+
+qint64 KisCompressedTilePool::totalSize() const
+{
+    return m_totalSize;
+}
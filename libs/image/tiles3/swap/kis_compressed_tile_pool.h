@@ -0,0 +1,90 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_COMPRESSED_TILE_POOL_H
+#define __KIS_COMPRESSED_TILE_POOL_H
+
+#include "kritaimage_export.h"
+
+#include <QHash>
+#include <QMap>
+#include <QByteArray>
+
+class KisTileData;
+
+/**
+ * An in-memory tier of the swap. It keeps the compressed data of
+ * swapped out tiles in RAM, so swapping them back in costs only a
+ * decompression. When the pool grows bigger than its limit, the
+ * oldest entries are supposed to be spilled to the swap file by
+ * the owner, see KisSwappedDataStore.
+ *
+ * LOCKING: the pool has no locking of its own, all the calls
+ *          should be guarded by the owner
+ */
+class KRITAIMAGE_EXPORT KisCompressedTilePool
+{
+public:
+    KisCompressedTilePool(qint64 maxSize);
+
+    /**
+     * The pool is disabled when its limit is zero
+     */
+    inline bool isEnabled() const {
+        return m_maxSize > 0;
+    }
+
+    inline bool isOverflowed() const {
+        return m_totalSize > m_maxSize;
+    }
+
+    inline bool contains(KisTileData *td) const {
+        return m_tiles.contains(td);
+    }
+
+    /**
+     * Puts \p size bytes of compressed \p data of the \p td into
+     * the pool. The tile data should not be present in the pool yet.
+     */
+    void add(KisTileData *td, const quint8 *data, qint32 size);
+
+    /**
+     * Removes the \p td from the pool and returns its compressed
+     * data in \p data. Returns false if the tile is not in the pool.
+     */
+    bool take(KisTileData *td, QByteArray &data);
+
+    /**
+     * Removes the oldest entry of the pool and returns it in
+     * \p td and \p data. Returns false if the pool is empty.
+     */
+    bool takeOldest(KisTileData *&td, QByteArray &data);
+
+    /**
+     * Number of tile data objects stored in the pool
+     */
+    qint32 numTiles() const;
+
+    /**
+     * Size of the compressed data stored in the pool in bytes
+     */
+    qint64 totalSize() const;
+
+private:
+    struct Entry {
+        QByteArray data;
+        quint64 seqNo = 0;
+    };
+
+    qint64 m_maxSize = 0;
+    qint64 m_totalSize = 0;
+    quint64 m_nextSeqNo = 0;
+
+    QHash<KisTileData*, Entry> m_tiles;
+    QMap<quint64, KisTileData*> m_order;
+};
+
+#endif /* __KIS_COMPRESSED_TILE_POOL_H */
@@ -65,6 +65,65 @@ bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *d
     return true;
 }
 
+bool KisLegacyTileCompressor::readTileCompressed(QIODevice *stream, KisTiledDataManager *dm,
+                                                 KisTileSP &tile, QByteArray &data)
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+
+    const qint32 bufferSize = maxHeaderLength() + 1;
+    QByteArray headerBuffer(bufferSize, 0);
+
+    qint32 x, y;
+    qint32 width, height;
+
+    stream->readLine(headerBuffer.data(), bufferSize);
+    if (sscanf(headerBuffer.constData(), "%d,%d,%d,%d", &x, &y, &width, &height) != 4) {
+        return false;
+    }
+
+    qint32 row = yToRow(dm, y);
+    qint32 col = xToCol(dm, x);
+
+    tile = dm->getTile(col, row, true);
+
+    // legacy tiles are not compressed at all
+    data = stream->read(tileDataSize);
+    return data.size() == tileDataSize;
+}
+
+bool KisLegacyTileCompressor::writeTileRect(const quint8 *data, const QRect &rect,
+                                            qint32 pixelSize, KisPaintDeviceWriter &store)
+{
+    const qint32 bufferSize = maxHeaderLength() + 1;
+    QScopedArrayPointer<char> headerBuffer(new char[bufferSize]);
+
+    snprintf(headerBuffer.data(), bufferSize, "%d,%d,%d,%d\n",
+             rect.x(), rect.y(), rect.width(), rect.height());
+
+    store.write(headerBuffer.data(), strlen(headerBuffer.data()));
+    return store.write((const char *)data, pixelSize * rect.width() * rect.height());
+}
+
+bool KisLegacyTileCompressor::readTileRect(QIODevice *stream, qint32 pixelSize,
+                                           qint32 tileWidth, qint32 tileHeight,
+                                           quint8 *data, QPoint &topLeft)
+{
+    const qint32 bufferSize = maxHeaderLength() + 1;
+    QScopedArrayPointer<char> headerBuffer(new char[bufferSize]);
+
+    qint32 x, y;
+    qint32 width, height;
+
+    stream->readLine(headerBuffer.data(), bufferSize);
+    if (sscanf(headerBuffer.data(), "%d,%d,%d,%d", &x, &y, &width, &height) != 4) {
+        return false;
+    }
+
+    const qint32 dataSize = pixelSize * tileWidth * tileHeight;
+    topLeft = QPoint(x, y);
+    return stream->read((char *)data, dataSize) == dataSize;
+}
+
 void KisLegacyTileCompressor::compressTileData(KisTileData *tileData,
                                                quint8 *buffer,
                                                qint32 bufferSize,
@@ -18,6 +18,13 @@ public:
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *stream, KisTiledDataManager *dm) override;
+    bool readTileCompressed(QIODevice *stream, KisTiledDataManager *dm,
+                            KisTileSP &tile, QByteArray &data) override;
+    bool writeTileRect(const quint8 *data, const QRect &rect,
+                       qint32 pixelSize, KisPaintDeviceWriter &store) override;
+    bool readTileRect(QIODevice *stream, qint32 pixelSize,
+                      qint32 tileWidth, qint32 tileHeight,
+                      quint8 *data, QPoint &topLeft) override;
 
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
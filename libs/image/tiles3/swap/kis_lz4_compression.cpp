@@ -0,0 +1,44 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_lz4_compression.h"
+
+#include <lz4.h>
+
+
+KisLz4Compression::KisLz4Compression()
+{
+}
+
+KisLz4Compression::~KisLz4Compression()
+{
+}
+
+qint32 KisLz4Compression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    /**
+     * LZ4 returns zero on failure, which matches the convention
+     * of KisAbstractCompression
+     */
+    return LZ4_compress_default(reinterpret_cast<const char*>(input),
+                                reinterpret_cast<char*>(output),
+                                inputLength, outputLength);
+}
+
+qint32 KisLz4Compression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    const int result =
+        LZ4_decompress_safe(reinterpret_cast<const char*>(input),
+                            reinterpret_cast<char*>(output),
+                            inputLength, outputLength);
+
+    return result > 0 ? result : 0;
+}
+
+qint32 KisLz4Compression::outputBufferSize(qint32 dataSize)
+{
+    return LZ4_compressBound(dataSize);
+}
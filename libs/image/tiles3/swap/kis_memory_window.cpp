@@ -9,6 +9,11 @@
 
 #include <QDir>
 
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
 KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
@@ -43,12 +48,78 @@ KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize
     }
 }
 
+KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize, quint64 fullMappingSize)
+    : KisMemoryWindow(swapDir, writeWindowSize)
+{
+    if (m_valid) {
+        tryMapWholeFile(fullMappingSize);
+    }
+}
+
 KisMemoryWindow::~KisMemoryWindow()
 {
 }
 
+void KisMemoryWindow::tryMapWholeFile(quint64 fullMappingSize)
+{
+#if defined Q_OS_UNIX
+    if (sizeof(void*) < 8) {
+        warnKrita << "KisMemoryWindow: full mapping of the swap file is not supported on 32-bit systems";
+        return;
+    }
+
+    // resizing via ftruncate() creates a sparse file, so no disk space is wasted
+    if (!m_file.resize(fullMappingSize)) {
+        warnKrita << "KisMemoryWindow: failed to resize the swap file to" << fullMappingSize << "bytes";
+        return;
+    }
+
+    // A workaround for https://bugreports.qt-project.org/browse/QTBUG-6330
+    m_file.exists();
+
+    m_fullMapping = m_file.map(0, fullMappingSize);
+
+    if (!m_fullMapping) {
+        warnKrita << "KisMemoryWindow: failed to map the whole swap file, falling back to windowed mapping";
+        m_file.resize(0);
+        return;
+    }
+
+    m_fullMappingSize = fullMappingSize;
+
+    /**
+     * Tiles are swapped in in quite random order, so the default
+     * read-ahead of the kernel would just pollute the page cache.
+     * We explicitly ask for the data we need in adviseWillNeed().
+     */
+    madvise(m_fullMapping, m_fullMappingSize, MADV_RANDOM);
+#else
+    Q_UNUSED(fullMappingSize);
+#endif
+}
+
+void KisMemoryWindow::adviseWillNeed(const KisChunkData &chunk)
+{
+    if (!m_fullMapping || chunk.m_end >= m_fullMappingSize) return;
+
+#if defined Q_OS_UNIX
+    static const quint64 pageSize = quint64(sysconf(_SC_PAGESIZE));
+
+    const quint64 alignedBegin = chunk.m_begin & ~(pageSize - 1);
+    const quint64 length = chunk.m_end + 1 - alignedBegin;
+
+    madvise(m_fullMapping + alignedBegin, length, MADV_WILLNEED);
+#else
+    Q_UNUSED(chunk);
+#endif
+}
+
 quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 {
+    if (m_fullMapping) {
+        return fullMappingPtr(readChunk);
+    }
+
     if (!adjustWindow(readChunk, &m_readWindowEx, &m_writeWindowEx)) {
         return nullptr;
     }
@@ -58,6 +129,10 @@ quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 
 quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
 {
+    if (m_fullMapping) {
+        return fullMappingPtr(writeChunk);
+    }
+
     if (!adjustWindow(writeChunk, &m_writeWindowEx, &m_readWindowEx)) {
         return nullptr;
     }
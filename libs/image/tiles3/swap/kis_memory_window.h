@@ -22,8 +22,37 @@ public:
      * @param writeWindowSize write window size.
      */
     KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
+
+    /**
+     * Creates a memory window that maps the whole swap file of
+     * \p fullMappingSize bytes at once. The file is created sparse,
+     * so its disk space is allocated only when the data is written.
+     * Chunk pointers are calculated directly from the mapping, so
+     * no remapping ever happens.
+     *
+     * If the mapping cannot be created (e.g. on 32-bit systems or
+     * on Windows, where the files cannot be sparse by default), the
+     * object falls back to the usual read/write windows of
+     * \p writeWindowSize.
+     */
+    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize, quint64 fullMappingSize);
+
     ~KisMemoryWindow();
 
+    /**
+     * \return true if the whole file is mapped at once
+     */
+    inline bool isFullyMapped() const {
+        return m_fullMapping;
+    }
+
+    /**
+     * Hints the OS that \p chunk is going to be read soon, so it
+     * could start reading it in the background. Works only when
+     * the file is fully mapped, otherwise does nothing.
+     */
+    void adviseWillNeed(const KisChunkData &chunk);
+
     inline quint8* getReadChunkPtr(KisChunk readChunk) {
         return getReadChunkPtr(readChunk.data());
     }
@@ -59,9 +88,18 @@ private:
                       MappingWindow *adjustingWindow,
                       MappingWindow *otherWindow);
 
+    void tryMapWholeFile(quint64 fullMappingSize);
+
+    inline quint8* fullMappingPtr(const KisChunkData &chunk) const {
+        return chunk.m_end < m_fullMappingSize ? m_fullMapping + chunk.m_begin : nullptr;
+    }
+
 private:
     QTemporaryFile m_file;
 
+    quint8 *m_fullMapping = nullptr;
+    quint64 m_fullMappingSize = 0;
+
     bool m_valid;
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
@@ -5,17 +5,66 @@
  */
 
 #include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
 //#include "kis_debug.h"
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
 
-#include "kis_tile_compressor_2.h"
+#include "kis_tile_compressor_factory.h"
 
 //#define COMPRESSOR_VERSION 2
 
+namespace {
+
+class BatchCompressionJob : public QRunnable
+{
+public:
+    BatchCompressionJob(KisAbstractTileCompressor *compressor,
+                        const QVector<KisTileData*> &tiles,
+                        QVector<QByteArray> &buffers,
+                        QVector<quint64> &sizes,
+                        int begin, int end)
+        : m_compressor(compressor),
+          m_tiles(tiles),
+          m_buffers(buffers),
+          m_sizes(sizes),
+          m_begin(begin),
+          m_end(end)
+    {
+    }
+
+    void run() override {
+        for (int i = m_begin; i < m_end; i++) {
+            KisTileData *td = m_tiles[i];
+            QByteArray &buffer = m_buffers[i];
+
+            const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
+            if (buffer.size() < expectedBufferSize) {
+                buffer.resize(expectedBufferSize);
+            }
+
+            qint32 bytesWritten;
+            m_compressor->compressTileData(td, (quint8*) buffer.data(), buffer.size(), bytesWritten);
+            m_sizes[i] = bytesWritten;
+        }
+    }
+
+private:
+    KisAbstractTileCompressor *m_compressor;
+    const QVector<KisTileData*> &m_tiles;
+    QVector<QByteArray> &m_buffers;
+    QVector<quint64> &m_sizes;
+    int m_begin;
+    int m_end;
+};
+
+}
+
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_totalSwapMemoryUsed(0)
+    : m_compressedPool(qint64(KisImageConfig(true).compressedTilePoolSize()) * MiB),
+      m_totalSwapMemoryUsed(0)
 {
     KisImageConfig config(true);
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
@@ -23,14 +72,37 @@ KisSwappedDataStore::KisSwappedDataStore()
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace = config.mapWholeSwapFile() ?
+        new KisMemoryWindow(config.swapDir(), swapWindowSize, maxSwapSize) :
+        new KisMemoryWindow(config.swapDir(), swapWindowSize);
+
+    m_compressor =
+        KisTileCompressorFactory::createSwapCompressor(config.swapCompressionAlgorithm());
+
+    KisTileCompressor2 *compressor2 = dynamic_cast<KisTileCompressor2*>(m_compressor);
+    if (compressor2) {
+        m_compressionName = compressor2->compressionName();
+    }
+
+    /**
+     * Compression of a tile is cheap enough, so we don't need
+     * many threads for it. We also don't want the swapper to
+     * steal too much CPU from the updates scheduler.
+     */
+    const int numWorkers = qBound(1, QThread::idealThreadCount() / 2, 4);
+    m_batchPool.setMaxThreadCount(numWorkers);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    for (int i = 0; i < numWorkers; i++) {
+        m_batchCompressors.append(
+            KisTileCompressorFactory::createSwapCompressor(config.swapCompressionAlgorithm()));
+    }
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
+    m_batchPool.waitForDone();
+    qDeleteAll(m_batchCompressors);
+
     delete m_compressor;
     delete m_swapSpace;
     delete m_allocator;
@@ -41,7 +113,7 @@ quint64 KisSwappedDataStore::numTiles() const
     // We are not acquiring the lock here...
     // Hope QLinkedList will ensure atomic access to it's size...
 
-    return m_allocator->numChunks();
+    return m_allocator->numChunks() + m_compressedPool.numTiles();
 }
 
 bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
@@ -62,22 +134,187 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     qint32 bytesWritten;
     m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
 
-    KisChunk chunk = m_allocator->getChunk(bytesWritten);
-    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
-    if (!ptr) {
+    if (m_compressedPool.isEnabled()) {
+        m_compressedPool.add(td, (quint8*) m_buffer.data(), bytesWritten);
+        td->releaseMemory();
+
+        spillCompressedPool();
+        return true;
+    }
+
+    if (!writeToSwapFile(td, (quint8*) m_buffer.data(), bytesWritten)) {
         qWarning() << "swap out of tile failed";
         return false;
     }
-    memcpy(ptr, m_buffer.data(), bytesWritten);
 
     td->releaseMemory();
-    td->setSwapChunk(chunk);
 
+    return true;
+}
+
+bool KisSwappedDataStore::trySwapOutCompressedTileData(KisTileData *td, const QByteArray &data,
+                                                       const QString &compressionName)
+{
+    Q_ASSERT(td->data());
+
+    if (m_compressionName.isEmpty() || compressionName != m_compressionName ||
+        data.size() > m_compressor->tileDataBufferSize(td)) {
+
+        return false;
+    }
+
+    QMutexLocker locker(&m_lock);
+
+    if (m_compressedPool.isEnabled()) {
+        m_compressedPool.add(td, (const quint8*) data.constData(), data.size());
+        td->releaseMemory();
+
+        spillCompressedPool();
+        return true;
+    }
+
+    if (!writeToSwapFile(td, (const quint8*) data.constData(), data.size())) {
+        return false;
+    }
+
+    td->releaseMemory();
+
+    return true;
+}
+
+bool KisSwappedDataStore::writeToSwapFile(KisTileData *td, const quint8 *data, qint32 size)
+{
+    KisChunk chunk = m_allocator->getChunk(size);
+    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+    if (!ptr) {
+        m_allocator->freeChunk(chunk);
+        return false;
+    }
+    memcpy(ptr, data, size);
+
+    td->setSwapChunk(chunk);
     m_totalSwapMemoryUsed += chunk.size();
 
     return true;
 }
 
+void KisSwappedDataStore::spillCompressedPool()
+{
+    /**
+     * The tiles in the pool have no data, so their state
+     * (the pool entry or the swap chunk) is guarded by m_lock
+     * only and we can spill them without taking their locks
+     */
+
+    KisTileData *td = 0;
+    QByteArray data;
+
+    while (m_compressedPool.isOverflowed() &&
+           m_compressedPool.takeOldest(td, data)) {
+
+        if (!writeToSwapFile(td, (const quint8*) data.constData(), data.size())) {
+            qWarning() << "spilling of the compressed tiles to the swap file failed";
+
+            // the pool will just grow over its limit
+            m_compressedPool.add(td, (const quint8*) data.constData(), data.size());
+            break;
+        }
+    }
+}
+
+void KisSwappedDataStore::compressBatch(const QVector<KisTileData*> &tiles)
+{
+    if (m_batchBuffers.size() < tiles.size()) {
+        m_batchBuffers.resize(tiles.size());
+    }
+    m_batchSizes.resize(tiles.size());
+
+    const int numJobs = qMin(m_batchCompressors.size(), tiles.size());
+    const int tilesPerJob = (tiles.size() + numJobs - 1) / numJobs;
+
+    /**
+     * The first portion of the tiles is compressed in the
+     * current thread, while the rest of the work is handed
+     * over to the pool.
+     */
+    for (int i = 1; i < numJobs; i++) {
+        const int begin = i * tilesPerJob;
+        const int end = qMin(begin + tilesPerJob, tiles.size());
+        if (begin >= end) break;
+
+        m_batchPool.start(new BatchCompressionJob(m_batchCompressors[i], tiles,
+                                                  m_batchBuffers, m_batchSizes,
+                                                  begin, end));
+    }
+
+    BatchCompressionJob(m_batchCompressors[0], tiles,
+                        m_batchBuffers, m_batchSizes,
+                        0, qMin(tilesPerJob, tiles.size())).run();
+
+    m_batchPool.waitForDone();
+}
+
+bool KisSwappedDataStore::trySwapOutTileDataBatch(const QVector<KisTileData*> &tiles)
+{
+    if (tiles.isEmpty()) return true;
+
+    QMutexLocker batchLocker(&m_batchLock);
+
+    /**
+     * We don't need m_lock while compressing the data, so
+     * swap-in of other tiles can happen in the meantime
+     */
+    compressBatch(tiles);
+
+    QMutexLocker locker(&m_lock);
+
+    if (m_compressedPool.isEnabled()) {
+        for (int i = 0; i < tiles.size(); i++) {
+            KisTileData *td = tiles[i];
+            Q_ASSERT(td->data());
+
+            m_compressedPool.add(td, (const quint8*) m_batchBuffers[i].constData(), m_batchSizes[i]);
+            td->releaseMemory();
+        }
+
+        spillCompressedPool();
+        return true;
+    }
+
+    QVector<KisChunk> chunks = m_allocator->getContiguousChunks(m_batchSizes);
+
+    quint64 totalSize = 0;
+    Q_FOREACH (quint64 size, m_batchSizes) {
+        totalSize += size;
+    }
+
+    const KisChunkData slab(chunks.first().begin(), totalSize);
+    quint8 *ptr = m_swapSpace->getWriteChunkPtr(slab);
+    if (!ptr) {
+        qWarning() << "swap out of a batch of tiles failed";
+
+        Q_FOREACH (const KisChunk &chunk, chunks) {
+            m_allocator->freeChunk(chunk);
+        }
+        return false;
+    }
+
+    for (int i = 0; i < tiles.size(); i++) {
+        KisTileData *td = tiles[i];
+        Q_ASSERT(td->data());
+
+        memcpy(ptr, m_batchBuffers[i].constData(), m_batchSizes[i]);
+        ptr += m_batchSizes[i];
+
+        td->releaseMemory();
+        td->setSwapChunk(chunks[i]);
+
+        m_totalSwapMemoryUsed += chunks[i].size();
+    }
+
+    return true;
+}
+
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
@@ -85,6 +322,13 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     // see comment in swapOutTileData()
 
+    QByteArray compressedData;
+    if (m_compressedPool.take(td, compressedData)) {
+        td->allocateMemory();
+        m_compressor->decompressTileData((quint8*) compressedData.data(), compressedData.size(), td);
+        return;
+    }
+
     KisChunk chunk = td->swapChunk();
     m_totalSwapMemoryUsed -= chunk.size();
 
@@ -97,10 +341,23 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     m_allocator->freeChunk(chunk);
 }
 
+void KisSwappedDataStore::prefetchTileData(KisTileData *td)
+{
+    QMutexLocker locker(&m_lock);
+
+    if (td->data() || m_compressedPool.contains(td)) return;
+
+    KisChunk chunk = td->swapChunk();
+    m_swapSpace->adviseWillNeed(chunk.data());
+}
+
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
+    QByteArray unused;
+    if (m_compressedPool.take(td, unused)) return;
+
     m_totalSwapMemoryUsed -= td->swapChunk().size();
 
     m_allocator->freeChunk(td->swapChunk());
@@ -112,6 +369,11 @@ qint64 KisSwappedDataStore::totalSwapMemoryUsed() const
     return m_totalSwapMemoryUsed;
 }
 
+qint64 KisSwappedDataStore::compressedPoolMemoryUsed() const
+{
+    return m_compressedPool.totalSize();
+}
+
 void KisSwappedDataStore::debugStatistics()
 {
     m_allocator->sanityCheck();
@@ -11,6 +11,10 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QVector>
+#include <QThreadPool>
+
+#include "kis_compressed_tile_pool.h"
 
 
 class QMutex;
@@ -38,6 +42,30 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Swap out a batch of tile data objects at once. The tiles
+     * are compressed in parallel on a small worker pool and then
+     * written into a contiguous region of the swap file.
+     *
+     * Either all the tiles of the batch are swapped out or none.
+     *
+     * LOCKING: the locks on all the tile data objects should be
+     *          taken by the caller before making a call.
+     */
+    bool trySwapOutTileDataBatch(const QVector<KisTileData*> &tiles);
+
+    /**
+     * Swap out the data of \a td, using \a data as its already
+     * compressed representation, e.g. the one read from a file.
+     * The data is accepted only if it has been compressed with
+     * the same algorithm as the swap uses.
+     *
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool trySwapOutCompressedTileData(KisTileData *td, const QByteArray &data,
+                                      const QString &compressionName);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -46,6 +74,15 @@ public:
      */
     void swapInTileData(KisTileData *td);
 
+    /**
+     * Hint the OS that the data of a swapped-out \a td is going
+     * to be swapped in soon. It has effect only when the swap
+     * file is mapped as a whole, see KisImageConfig::mapWholeSwapFile()
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    void prefetchTileData(KisTileData *td);
+
     /**
      * Forget all the information linked with the tile data.
      * This should be done before deleting of the tile data,
@@ -59,20 +96,52 @@ public:
      */
     qint64 totalSwapMemoryUsed() const;
 
+    /**
+     * Returns the amount of RAM occupied by the compressed tiles
+     * that have not been spilled to the swap file yet, see
+     * KisImageConfig::compressedTilePoolSize()
+     */
+    qint64 compressedPoolMemoryUsed() const;
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
+private:
+    void compressBatch(const QVector<KisTileData*> &tiles);
+
+    bool writeToSwapFile(KisTileData *td, const quint8 *data, qint32 size);
+    void spillCompressedPool();
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
+    QString m_compressionName;
+
+    /**
+     * Every worker of the pool owns a separate compressor, because
+     * the compressors are not reentrant. The objects are guarded
+     * by m_batchLock.
+     */
+    QMutex m_batchLock;
+    QThreadPool m_batchPool;
+    QVector<KisAbstractTileCompressor*> m_batchCompressors;
+    QVector<QByteArray> m_batchBuffers;
+    QVector<quint64> m_batchSizes;
 
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
     QMutex m_lock;
 
+    /**
+     * RAM tier of the swap, guarded by m_lock. The tiles are
+     * compressed with m_compressor in both the tiers, so spilling
+     * them to the file doesn't need any recompression.
+     */
+    KisCompressedTilePool m_compressedPool;
+
     qint64 m_totalSwapMemoryUsed;
 };
 
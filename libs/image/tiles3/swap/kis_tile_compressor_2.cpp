@@ -8,14 +8,20 @@
 #include "kis_lzf_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
+#include "kis_assert.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
-
 
 KisTileCompressor2::KisTileCompressor2()
+    : KisTileCompressor2(new KisLzfCompression(), "LZF")
+{
+}
+
+KisTileCompressor2::KisTileCompressor2(KisAbstractCompression *compression, const QString &compressionName)
+    : m_compression(compression),
+      m_compressionName(compressionName)
 {
-    m_compression = new KisLzfCompression();
+    KIS_ASSERT(m_compression);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
@@ -23,6 +29,16 @@ KisTileCompressor2::~KisTileCompressor2()
     delete m_compression;
 }
 
+void KisTileCompressor2::setCompressionEnabled(bool value)
+{
+    m_compressionEnabled = value;
+}
+
+QString KisTileCompressor2::compressionName() const
+{
+    return m_compressionName;
+}
+
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
     const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
@@ -80,6 +96,91 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
     return false;
 }
 
+bool KisTileCompressor2::readTileCompressed(QIODevice *stream, KisTiledDataManager *dm,
+                                            KisTileSP &tile, QByteArray &data)
+{
+    QByteArray header = stream->readLine(maxHeaderLength());
+
+    QList<QByteArray> headerItems = header.trimmed().split(',');
+    if (headerItems.size() == 4) {
+        qint32 x = headerItems.takeFirst().toInt();
+        qint32 y = headerItems.takeFirst().toInt();
+        QString compressionName = headerItems.takeFirst();
+        qint32 dataSize = headerItems.takeFirst().toInt();
+
+        Q_ASSERT(headerItems.isEmpty());
+        Q_ASSERT(compressionName == m_compressionName);
+
+        if (dataSize <= 0 || dataSize > TILE_DATA_SIZE(pixelSize(dm)) + 1) {
+            return false;
+        }
+
+        qint32 row = yToRow(dm, y);
+        qint32 col = xToCol(dm, x);
+
+        tile = dm->getTile(col, row, true);
+
+        data = stream->read(dataSize);
+        return data.size() == dataSize;
+    }
+    return false;
+}
+
+bool KisTileCompressor2::writeTileRect(const quint8 *data, const QRect &rect,
+                                       qint32 pixelSize, KisPaintDeviceWriter &store)
+{
+    const qint32 dataSize = pixelSize * rect.width() * rect.height();
+    prepareStreamingBuffer(dataSize);
+
+    qint32 bytesWritten;
+    compressBuffer(data, dataSize, pixelSize,
+                   (quint8*)m_streamingBuffer.data(), bytesWritten);
+
+    QString header = getHeader(rect.topLeft(), bytesWritten);
+    bool retval = true;
+    retval = store.write(header.toLatin1());
+    if (!retval) {
+        warnFile << "Failed to write the tile header";
+    }
+    retval = store.write(m_streamingBuffer.data(), bytesWritten);
+    if (!retval) {
+        warnFile << "Failed to write the tile data";
+    }
+    return retval;
+}
+
+bool KisTileCompressor2::readTileRect(QIODevice *stream, qint32 pixelSize,
+                                      qint32 tileWidth, qint32 tileHeight,
+                                      quint8 *data, QPoint &topLeft)
+{
+    const qint32 dataSize = pixelSize * tileWidth * tileHeight;
+    prepareStreamingBuffer(dataSize);
+
+    QByteArray header = stream->readLine(maxHeaderLength());
+
+    QList<QByteArray> headerItems = header.trimmed().split(',');
+    if (headerItems.size() == 4) {
+        qint32 x = headerItems.takeFirst().toInt();
+        qint32 y = headerItems.takeFirst().toInt();
+        QString compressionName = headerItems.takeFirst();
+        qint32 compressedSize = headerItems.takeFirst().toInt();
+
+        Q_ASSERT(headerItems.isEmpty());
+        Q_ASSERT(compressionName == m_compressionName);
+
+        if (compressedSize > m_streamingBuffer.size()) {
+            return false;
+        }
+
+        stream->read(m_streamingBuffer.data(), compressedSize);
+
+        topLeft = QPoint(x, y);
+        return decompressBuffer((quint8*)m_streamingBuffer.data(), compressedSize,
+                                data, dataSize, pixelSize);
+    }
+    return false;
+}
+
 void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
 {
     /**
@@ -109,54 +210,74 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
 {
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
-    qint32 compressedBytes;
 
     Q_UNUSED(bufferSize);
     Q_ASSERT(bufferSize >= tileDataSize + 1);
 
-    prepareWorkBuffers(tileDataSize);
+    compressBuffer(tileData->data(), tileDataSize, pixelSize, buffer, bytesWritten);
+}
+
+bool KisTileCompressor2::decompressTileData(quint8 *buffer,
+                                            qint32 bufferSize,
+                                            KisTileData *tileData)
+{
+    const qint32 pixelSize = tileData->pixelSize();
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+
+    return decompressBuffer(buffer, bufferSize, tileData->data(), tileDataSize, pixelSize);
+}
+
+void KisTileCompressor2::compressBuffer(const quint8 *data, qint32 dataSize, qint32 pixelSize,
+                                        quint8 *buffer, qint32 &bytesWritten)
+{
+    if (!m_compressionEnabled) {
+        buffer[0] = RAW_DATA_FLAG;
+        memcpy(buffer + 1, data, dataSize);
+        bytesWritten = dataSize + 1;
+        return;
+    }
+
+    qint32 compressedBytes;
+
+    prepareWorkBuffers(dataSize);
 
-    KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
-                                            tileDataSize, pixelSize);
+    KisAbstractCompression::linearizeColors(const_cast<quint8*>(data), (quint8*)m_linearizationBuffer.data(),
+                                            dataSize, pixelSize);
 
-    compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
+    compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), dataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
+    if(compressedBytes < dataSize) {
         buffer[0] = COMPRESSED_DATA_FLAG;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
     else {
         buffer[0] = RAW_DATA_FLAG;
-        memcpy(buffer + 1, tileData->data(), tileDataSize);
-        bytesWritten = tileDataSize + 1;
+        memcpy(buffer + 1, data, dataSize);
+        bytesWritten = dataSize + 1;
     }
 }
 
-bool KisTileCompressor2::decompressTileData(quint8 *buffer,
-                                            qint32 bufferSize,
-                                            KisTileData *tileData)
+bool KisTileCompressor2::decompressBuffer(quint8 *buffer, qint32 bufferSize,
+                                          quint8 *data, qint32 dataSize, qint32 pixelSize)
 {
-    const qint32 pixelSize = tileData->pixelSize();
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
-
     if(buffer[0] == COMPRESSED_DATA_FLAG) {
-        prepareWorkBuffers(tileDataSize);
+        prepareWorkBuffers(dataSize);
 
         qint32 bytesWritten;
         bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
-        if (bytesWritten == tileDataSize) {
+                                                 (quint8*)m_linearizationBuffer.data(), dataSize);
+        if (bytesWritten == dataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
-                                                      tileData->data(),
-                                                      tileDataSize, pixelSize);
+                                                      data,
+                                                      dataSize, pixelSize);
             return true;
         }
         return false;
     }
     else {
-        memcpy(tileData->data(), buffer + 1, tileDataSize);
+        memcpy(data, buffer + 1, dataSize);
         return true;
     }
     return false;
@@ -186,3 +307,9 @@ inline QString KisTileCompressor2::getHeader(KisTileSP tile,
 
     return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(m_compressionName).arg(compressedSize);
 }
+
+inline QString KisTileCompressor2::getHeader(const QPoint &topLeft,
+                                             qint32 compressedSize)
+{
+    return QString("%1,%2,%3,%4\n").arg(topLeft.x()).arg(topLeft.y()).arg(m_compressionName).arg(compressedSize);
+}
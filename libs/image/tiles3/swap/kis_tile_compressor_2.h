@@ -15,10 +15,39 @@ class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
     KisTileCompressor2();
+
+    /**
+     * Creates a compressor that uses \p compression backend instead
+     * of the default LZF one. The compressor takes ownership of the
+     * passed object. \p compressionName is written into the tile
+     * headers and should not be longer than five characters.
+     */
+    KisTileCompressor2(KisAbstractCompression *compression, const QString &compressionName);
+
     ~KisTileCompressor2() override;
 
+    /**
+     * When compression is disabled, the tiles are written with
+     * RAW_DATA_FLAG without even trying to compress them, so
+     * that the reading code doesn't need to know about it
+     */
+    void setCompressionEnabled(bool value);
+
+    /**
+     * The name of the compression algorithm written into the
+     * headers of the tiles
+     */
+    QString compressionName() const;
+
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
+    bool readTileCompressed(QIODevice *stream, KisTiledDataManager *dm,
+                            KisTileSP &tile, QByteArray &data) override;
+    bool writeTileRect(const quint8 *data, const QRect &rect,
+                       qint32 pixelSize, KisPaintDeviceWriter &store) override;
+    bool readTileRect(QIODevice *stream, qint32 pixelSize,
+                      qint32 tileWidth, qint32 tileHeight,
+                      quint8 *data, QPoint &topLeft) override;
 
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
@@ -33,6 +62,12 @@ private:
     qint32 maxHeaderLength();
 
     QString getHeader(KisTileSP tile, qint32 compressedSize);
+    QString getHeader(const QPoint &topLeft, qint32 compressedSize);
+
+    void compressBuffer(const quint8 *data, qint32 dataSize, qint32 pixelSize,
+                        quint8 *buffer, qint32 &bytesWritten);
+    bool decompressBuffer(quint8 *buffer, qint32 bufferSize,
+                          quint8 *data, qint32 dataSize, qint32 pixelSize);
 
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
@@ -46,7 +81,8 @@ private:
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QString m_compressionName;
+    bool m_compressionEnabled = true;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
@@ -0,0 +1,56 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_compressor_factory.h"
+
+#include <config-tile-compression.h>
+
+#include "kis_debug.h"
+#include "kis_lzf_compression.h"
+
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "kis_zstd_compression.h"
+#endif
+
+
+QStringList KisTileCompressorFactory::supportedSwapCompressions()
+{
+    QStringList result;
+    result << "lzf";
+#ifdef HAVE_LZ4
+    result << "lz4";
+#endif
+#ifdef HAVE_ZSTD
+    result << "zstd";
+#endif
+    return result;
+}
+
+KisAbstractTileCompressor* KisTileCompressorFactory::createSwapCompressor(const QString &compressionId)
+{
+#ifdef HAVE_LZ4
+    if (compressionId == "lz4") {
+        return new KisTileCompressor2(new KisLz4Compression(), "LZ4");
+    }
+#endif
+
+#ifdef HAVE_ZSTD
+    if (compressionId == "zstd") {
+        return new KisTileCompressor2(new KisZstdCompression(), "ZSTD");
+    }
+#endif
+
+    if (compressionId != "lzf") {
+        warnTiles << "Swap compression" << compressionId
+                  << "is not supported by this build, falling back to LZF";
+    }
+
+    return new KisTileCompressor2();
+}
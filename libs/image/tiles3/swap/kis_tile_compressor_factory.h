@@ -7,29 +7,57 @@
 #ifndef __KIS_TILE_COMPRESSOR_FACTORY_H
 #define __KIS_TILE_COMPRESSOR_FACTORY_H
 
+#include <QStringList>
+
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
 
+class KisAbstractCompression;
+
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * Creates a compressor for reading and writing the tiles of
+     * version \p version. If \p compressionEnabled is false, the
+     * created compressor writes the tiles raw, which is still
+     * readable by any compressor of the same version.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version, bool compressionEnabled = true) {
         switch(version) {
         case 1:
             return KisAbstractTileCompressorSP(new KisLegacyTileCompressor());
             break;
-        case 2:
-            return KisAbstractTileCompressorSP(new KisTileCompressor2());
+        case 2: {
+            KisTileCompressor2 *compressor = new KisTileCompressor2();
+            compressor->setCompressionEnabled(compressionEnabled);
+            return KisAbstractTileCompressorSP(compressor);
             break;
+        }
         default:
             qFatal("Unknown version of the tiles");
             return KisAbstractTileCompressorSP();
         };
     }
 
+    /**
+     * Ids of the compression algorithms that can be used for
+     * the swap file, the first one is the default. The list
+     * depends on the libraries found at build time.
+     */
+    static QStringList supportedSwapCompressions();
+
+    /**
+     * Creates a tile compressor for swapping tiles out to the
+     * swap file using algorithm \p compressionId. If the algorithm
+     * is not supported by the current build, falls back to LZF.
+     *
+     * The caller takes ownership of the returned object.
+     */
+    static KisAbstractTileCompressor* createSwapCompressor(const QString &compressionId);
+
 private:
     KisTileCompressorFactory();
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_FACTORY_H */
-
@@ -0,0 +1,172 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QQueue>
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "tiles3/swap/kis_tile_data_swapper_p.h"
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_debug.h"
+
+/**
+ * About four screens of 4K viewport worth of tiles. When the user
+ * pans faster than we can fetch, the oldest hints are not relevant
+ * anymore anyway.
+ */
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 2048;
+
+//#define DEBUG_PREFETCHER
+
+#ifdef DEBUG_PREFETCHER
+#define DEBUG_ACTION(action) dbgKrita << action
+#define DEBUG_VALUE(value) dbgKrita << "\t" << ppVar(value)
+#else
+#define DEBUG_ACTION(action)
+#define DEBUG_VALUE(value)
+#endif
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+public:
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+    KisStoreLimits limits;
+
+    QMutex queueLock;
+    QQueue<KisTileData*> queue;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    clearQueue();
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::enqueue(const QVector<KisTileData*> &tiles)
+{
+    QVector<KisTileData*> droppedTiles;
+    int numAdded = 0;
+
+    {
+        QMutexLocker l(&m_d->queueLock);
+
+        Q_FOREACH (KisTileData *td, tiles) {
+            m_d->queue.enqueue(td);
+            numAdded++;
+        }
+
+        while (m_d->queue.size() > MAX_QUEUE_SIZE) {
+            droppedTiles.append(m_d->queue.dequeue());
+            numAdded--;
+        }
+    }
+
+    /**
+     * deref() may free the tile data, which takes locks of the
+     * store, so do that outside the queue lock
+     */
+    Q_FOREACH (KisTileData *td, droppedTiles) {
+        td->deref();
+    }
+
+    if (numAdded > 0) {
+        m_d->semaphore.release(numAdded);
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+
+    clearQueue();
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    m_d->limits = KisStoreLimits();
+}
+
+bool KisTileDataPrefetcher::takeNext(KisTileData **td)
+{
+    QMutexLocker l(&m_d->queueLock);
+    if (m_d->queue.isEmpty()) return false;
+
+    *td = m_d->queue.dequeue();
+    return true;
+}
+
+void KisTileDataPrefetcher::clearQueue()
+{
+    KisTileData *td = 0;
+    while (takeNext(&td)) {
+        td->deref();
+    }
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        /**
+         * The semaphore may have more permits than the queue has
+         * items, because enqueue() drops the oldest requests
+         */
+        KisTileData *td = 0;
+        if (!takeNext(&td)) continue;
+
+        processTileData(td);
+        td->deref();
+    }
+}
+
+void KisTileDataPrefetcher::processTileData(KisTileData *td)
+{
+    /**
+     * Fetching tiles above the hard limit would just make the
+     * swapper throw out the tiles that are really in use
+     */
+    if (m_d->store->memoryMetric() > m_d->limits.hardLimit()) {
+        DEBUG_ACTION("Prefetch request dropped: too little memory");
+        return;
+    }
+
+    /**
+     * No need to take the swap lock here, the check is
+     * repeated in blockSwapping() anyway
+     */
+    if (td->data()) return;
+
+    DEBUG_ACTION("Prefetching tile data");
+    DEBUG_VALUE(td);
+
+    /**
+     * blockSwapping() loads the data and resets its age, so the
+     * swapper will not push it back to the disk right away
+     */
+    td->blockSwapping();
+    td->unblockSwapping();
+}
@@ -0,0 +1,64 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+
+class KisTileDataStore;
+class KisTileData;
+
+/**
+ * A background thread that swaps in tile data before someone
+ * actually tries to access it. The requests come in the form of
+ * "hot rect" hints, e.g. the visible area of the canvas or the
+ * predicted path of the stroke. All the requests are just hints:
+ * the prefetcher may drop them when the queue is too long or when
+ * the store is too close to its memory limits.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Queues swapped-out tile data for loading. The caller should
+     * have ref()'ed every tile data in \p tiles, the prefetcher
+     * takes over these references.
+     */
+    void enqueue(const QVector<KisTileData*> &tiles);
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+private:
+    void run() override;
+
+    bool takeNext(KisTileData **td);
+    void processTileData(KisTileData *td);
+    void clearQueue();
+
+private:
+    static const int MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
@@ -41,6 +41,15 @@ public:
     KisTileDataStore *store;
     KisStoreLimits limits;
     QMutex cycleLock;
+    int batchSize = 0;
+
+    QMutex historicalQueueLock;
+    QVector<KisTileData*> historicalQueue;
+
+    void readBatchSize() {
+        KisImageConfig config(true);
+        batchSize = config.swapOutBatchSize();
+    }
 };
 
 KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
@@ -49,10 +58,12 @@ KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
 {
     m_d->shouldExitFlag = 0;
     m_d->store = store;
+    m_d->readBatchSize();
 }
 
 KisTileDataSwapper::~KisTileDataSwapper()
 {
+    clearHistoricalQueue();
     delete m_d;
 }
 
@@ -68,6 +79,8 @@ void KisTileDataSwapper::terminateSwapper()
         m_d->shouldExitFlag = true;
         kick();
     } while(!wait(exitTimeout));
+
+    clearHistoricalQueue();
 }
 
 void KisTileDataSwapper::waitForWork()
@@ -86,6 +99,71 @@ void KisTileDataSwapper::run()
         QThread::msleep(DELAY);
 
         doJob();
+        swapOutHistoricalTiles();
+    }
+}
+
+void KisTileDataSwapper::enqueueHistoricalTiles(const QVector<KisTileData*> &tiles)
+{
+    if (tiles.isEmpty()) return;
+
+    {
+        QMutexLocker l(&m_d->historicalQueueLock);
+        m_d->historicalQueue += tiles;
+    }
+
+    kick();
+}
+
+void KisTileDataSwapper::swapOutHistoricalTiles()
+{
+    QVector<KisTileData*> tiles;
+
+    {
+        QMutexLocker l(&m_d->historicalQueueLock);
+        tiles.swap(m_d->historicalQueue);
+    }
+
+    if (tiles.isEmpty()) return;
+
+    DEBUG_ACTION("Swapping out old undo revisions");
+    DEBUG_VALUE(tiles.size());
+
+    {
+        QMutexLocker locker(&m_d->cycleLock);
+
+        /**
+         * The tiles are pushed in batches even when batching is
+         * disabled for the usual passes, the compression of the
+         * undo data is not urgent anyway
+         */
+        const int batchSize = qMax(1, m_d->batchSize);
+
+        for (int i = 0; i < tiles.size(); i += batchSize) {
+            m_d->store->trySwapHistoricalTileDataBatch(tiles.mid(i, batchSize));
+        }
+    }
+
+    /**
+     * deref() may free the tile data, which takes locks of the
+     * store, so do that outside the cycle lock
+     */
+    Q_FOREACH (KisTileData *td, tiles) {
+        td->deref();
+    }
+}
+
+void KisTileDataSwapper::clearHistoricalQueue()
+{
+    QVector<KisTileData*> tiles;
+
+    {
+        QMutexLocker l(&m_d->historicalQueueLock);
+        tiles.swap(m_d->historicalQueue);
+    }
+
+    Q_FOREACH (KisTileData *td, tiles) {
+        td->deref();
     }
 }
 
@@ -184,6 +262,10 @@ public:
 template<class strategy>
 qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 {
+    if (m_d->batchSize > 1) {
+        return batchedPass<strategy>(needToFreeMetric);
+    }
+
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
 
@@ -224,7 +306,74 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     return freedMetric;
 }
 
+template<class strategy>
+qint64 KisTileDataSwapper::batchedPass(qint64 needToFreeMetric)
+{
+    /**
+     * The same as pass(), but the candidates are collected into
+     * batches that are compressed in parallel and written
+     * to the swap file in one go
+     */
+
+    qint64 freedMetric = 0;
+    qint64 pendingMetric = 0;
+    QList<KisTileData*> additionalCandidates;
+    QVector<KisTileData*> batch;
+    batch.reserve(m_d->batchSize);
+
+    typename strategy::iterator *iter =
+        strategy::beginIteration(m_d->store);
+
+    auto flushBatch = [&] () {
+        freedMetric += iter->trySwapOutBatch(batch);
+        pendingMetric = 0;
+        batch.clear();
+    };
+
+    auto addToBatch = [&] (KisTileData *td) {
+        batch.append(td);
+        pendingMetric += td->pixelSize();
+
+        if (batch.size() >= m_d->batchSize) {
+            flushBatch();
+        }
+    };
+
+    KisTileData *item = 0;
+
+    while (iter->hasNext()) {
+        item = iter->next();
+
+        if (freedMetric + pendingMetric >= needToFreeMetric) break;
+
+        if (!strategy::isInteresting(item)) continue;
+
+        if (strategy::swapOutFirst(item)) {
+            addToBatch(item);
+        }
+        else {
+            item->markOld();
+            additionalCandidates.append(item);
+        }
+    }
+
+    Q_FOREACH (item, additionalCandidates) {
+        if (freedMetric + pendingMetric >= needToFreeMetric) break;
+
+        addToBatch(item);
+    }
+
+    if (!batch.isEmpty()) {
+        flushBatch();
+    }
+
+    strategy::endIteration(m_d->store, iter);
+
+    return freedMetric;
+}
+
 void KisTileDataSwapper::testingRereadConfig()
 {
     m_d->limits = KisStoreLimits();
+    m_d->readBatchSize();
 }
@@ -8,6 +8,7 @@
 
 #include <QObject>
 #include <QThread>
+#include <QVector>
 
 #include "kritaimage_export.h"
 
@@ -28,6 +29,14 @@ public:
     void terminateSwapper();
     void checkFreeMemory();
 
+    /**
+     * Queues the tile data of the old undo revisions for swapping
+     * out, regardless of the memory limits. The caller should have
+     * ref()'ed every tile data in \p tiles, the swapper takes over
+     * these references.
+     */
+    void enqueueHistoricalTiles(const QVector<KisTileData*> &tiles);
+
     void testingRereadConfig();
 
 private:
@@ -35,7 +44,10 @@ private:
     void run() override;
 
     void doJob();
+    void swapOutHistoricalTiles();
+    void clearHistoricalQueue();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
+    template<class strategy> qint64 batchedPass(qint64 needToFreeMetric);
 
 private:
     static const qint32 TIMEOUT;
@@ -0,0 +1,40 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+#include <QScopedPointer>
+
+/**
+ * Compression backend based on Zstandard. It is a bit slower than
+ * LZF on compression, but decompresses faster and produces noticeably
+ * smaller chunks, which lowers the amount of data read from the disk
+ * on swap-in.
+ *
+ * NOTE: the object keeps its own compression and decompression
+ * contexts, so it is not reentrant, the same way as the tile
+ * compressor that owns it.
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    KisZstdCompression(int compressionLevel = 3);
+    ~KisZstdCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
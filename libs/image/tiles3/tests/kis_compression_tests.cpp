@@ -11,6 +11,15 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include <config-tile-compression.h>
+
+#ifdef HAVE_LZ4
+#include "tiles3/swap/kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "tiles3/swap/kis_zstd_compression.h"
+#endif
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -209,6 +218,36 @@ void KisCompressionTests::testLzfOverflow()
     delete compression;
 }
 
+void KisCompressionTests::testLz4RoundTrip()
+{
+#ifdef HAVE_LZ4
+    KisAbstractCompression *compression = new KisLz4Compression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    testOverflow(compression);
+
+    delete compression;
+#else
+    QSKIP("LZ4 support is not built");
+#endif
+}
+
+void KisCompressionTests::testZstdRoundTrip()
+{
+#ifdef HAVE_ZSTD
+    KisAbstractCompression *compression = new KisZstdCompression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    testOverflow(compression);
+
+    delete compression;
+#else
+    QSKIP("Zstd support is not built");
+#endif
+}
+
 void KisCompressionTests::benchmarkMemCpy()
 {
     QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
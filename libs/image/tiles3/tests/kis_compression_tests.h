@@ -30,6 +30,9 @@ private Q_SLOTS:
     void testLzfRoundTrip();
     void testLzfOverflow();
 
+    void testLz4RoundTrip();
+    void testZstdRoundTrip();
+
     void benchmarkMemCpy();
 
     void benchmarkCompressionLzf();
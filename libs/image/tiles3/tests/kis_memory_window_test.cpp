@@ -43,6 +43,48 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testFullMapping()
+{
+    QTemporaryDir swapDir;
+    KisMemoryWindow memory(swapDir.path(), 1024, 64 * MiB);
+
+#ifndef Q_OS_UNIX
+    QVERIFY(!memory.isFullyMapped());
+#endif
+
+    quint8 oddValue = 0xee;
+    const quint8 chunkLength = 10;
+
+    quint8 oddBuf[chunkLength];
+    memset(oddBuf, oddValue, chunkLength);
+
+    KisChunkData chunk1(0, chunkLength);
+    KisChunkData chunk2(32 * MiB, chunkLength);
+
+    quint8 *ptr;
+
+    ptr = memory.getWriteChunkPtr(chunk1);
+    QVERIFY(ptr);
+    memcpy(ptr, oddBuf, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk2);
+    QVERIFY(ptr);
+    memcpy(ptr, oddBuf, chunkLength);
+
+    memory.adviseWillNeed(chunk2);
+
+    ptr = memory.getReadChunkPtr(chunk2);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk1);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+
+    if (memory.isFullyMapped()) {
+        // the chunk is outside the mapped file
+        QVERIFY(!memory.getWriteChunkPtr(KisChunkData(64 * MiB, chunkLength)));
+    }
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
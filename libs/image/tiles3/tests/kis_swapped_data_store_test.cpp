@@ -121,5 +121,113 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testBatchedRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 10000;
+    const qint32 BATCH_SIZE = 64;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+
+    KisSwappedDataStore store;
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    QVector<KisTileData*> batch;
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        batch.append(td);
+
+        if (batch.size() == BATCH_SIZE || i == NUM_TILES - 1) {
+            // FIXME: take a lock of the tile data
+            QVERIFY(store.trySwapOutTileDataBatch(batch));
+            batch.clear();
+        }
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
+void KisSwappedDataStoreTest::testCompressedPool()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+    const qint64 POOL_SIZE = 1 * MiB;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(8);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setCompressedTilePoolSize(POOL_SIZE / MiB);
+
+    KisSwappedDataStore store;
+
+    QRandomGenerator rng(10);
+    QList<KisTileData*> tileDataList;
+    QList<QByteArray> expectedData;
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+
+        // random noise is incompressible, so the pool will overflow
+        for (qint32 j = 0; j < TILESIZE; j++) {
+            td->data()[j] = rng.bounded(256);
+        }
+
+        expectedData.append(QByteArray((const char*)td->data(), TILESIZE));
+        tileDataList.append(td);
+
+        // FIXME: take a lock of the tile data
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    QVERIFY(store.compressedPoolMemoryUsed() > 0);
+    QVERIFY(store.compressedPoolMemoryUsed() <= POOL_SIZE);
+    QVERIFY(store.totalSwapMemoryUsed() > 0);
+
+    for(qint32 i = NUM_TILES - 1; i >= 0; i--) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QVERIFY(!memcmp(expectedData[i].constData(), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.compressedPoolMemoryUsed(), qint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+
+    config.setCompressedTilePoolSize(0);
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
@@ -132,6 +132,36 @@ void KisTileCompressorsTest::doLowLevelRoundTripIncompressible(KisAbstractTileCo
     tile->unlock();
 }
 
+void KisTileCompressorsTest::doRectRoundTrip(KisAbstractTileCompressor *compressor)
+{
+    const qint32 pixelSize = 2;
+    const QRect rect(128, 64, 64, 32);
+    const qint32 dataSize = pixelSize * rect.width() * rect.height();
+
+    QByteArray srcData(dataSize, 0);
+    for (int i = 0; i < dataSize; i++) {
+        srcData[i] = i % 7;
+    }
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+
+    bool retval = compressor->writeTileRect((const quint8*)srcData.constData(),
+                                            rect, pixelSize, writer);
+    QVERIFY(retval);
+
+    fakeStore.startReading();
+
+    QByteArray dstData(dataSize, 0);
+    QPoint topLeft;
+    retval = compressor->readTileRect(fakeStore.device(), pixelSize,
+                                      rect.width(), rect.height(),
+                                      (quint8*)dstData.data(), topLeft);
+    QVERIFY(retval);
+    QCOMPARE(topLeft, rect.topLeft());
+    QCOMPARE(dstData, srcData);
+}
+
 void KisTileCompressorsTest::testRoundTripLegacy()
 {
     KisAbstractTileCompressor *compressor = new KisLegacyTileCompressor();
@@ -146,6 +176,13 @@ void KisTileCompressorsTest::testLowLevelRoundTripLegacy()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRectRoundTripLegacy()
+{
+    KisAbstractTileCompressor *compressor = new KisLegacyTileCompressor();
+    doRectRoundTrip(compressor);
+    delete compressor;
+}
+
 void KisTileCompressorsTest::testRoundTrip2()
 {
     KisAbstractTileCompressor *compressor = new KisTileCompressor2();
@@ -167,6 +204,34 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRectRoundTrip2()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2();
+    doRectRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testRoundTripUncompressed2()
+{
+    KisTileCompressor2 *compressor = new KisTileCompressor2();
+    compressor->setCompressionEnabled(false);
+    doRoundTrip(compressor);
+    doRectRoundTrip(compressor);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+    KisTileSP tile = dm.getTile(0, 0, false);
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(compressor->writeTile(tile, writer));
+
+    // the uniform tile is perfectly compressible, but is written raw
+    QVERIFY(fakeStore.device()->size() > TILESIZE);
+
+    delete compressor;
+}
+
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
@@ -17,15 +17,19 @@ private:
     void doRoundTrip(KisAbstractTileCompressor *compressor);
     void doLowLevelRoundTrip(KisAbstractTileCompressor *compressor);
     void doLowLevelRoundTripIncompressible(KisAbstractTileCompressor *compressor);
+    void doRectRoundTrip(KisAbstractTileCompressor *compressor);
 
 
 private Q_SLOTS:
     void testRoundTripLegacy();
     void testLowLevelRoundTripLegacy();
+    void testRectRoundTripLegacy();
 
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+    void testRectRoundTrip2();
+    void testRoundTripUncompressed2();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
@@ -176,5 +176,222 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testDeduplication()
+{
+    KisImageConfig config(false);
+    config.setMemoryHardLimitPercent(config.memoryHardLimitPercent(true));
+    config.setMemorySoftLimitPercent(config.memorySoftLimitPercent(true));
+    config.setEnableTileDataDeduplication(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+
+    {
+        KisTiledDataManager dm1(pixelSize, &defaultPixel);
+        KisTiledDataManager dm2(pixelSize, &defaultPixel);
+
+        for(qint32 col = 0; col < 4; col++) {
+            KisTileSP tile1 = dm1.getTile(col, 0, true);
+            KisTileSP tile2 = dm2.getTile(col, 0, true);
+
+            tile1->lockForWrite();
+            tile2->lockForWrite();
+            memset(tile1->tileData()->data(), COLUMN2COLOR(col % 2), TILESIZE);
+            memset(tile2->tileData()->data(), COLUMN2COLOR(col % 2), TILESIZE);
+            tile1->unlockForWrite();
+            tile2->unlockForWrite();
+        }
+
+        const qint32 numTilesBefore = store->numTiles();
+
+        QCOMPARE(store->deduplicateTileData(), 6);
+
+        /**
+         * The index has already been destroyed, so only two
+         * unique tile datas should be left out of eight ones
+         */
+        QCOMPARE(store->numTiles(), numTilesBefore - 6);
+
+        for(qint32 col = 0; col < 4; col++) {
+            KisTileSP tile1 = dm1.getTile(col, 0, false);
+            KisTileSP tile2 = dm2.getTile(col, 0, false);
+
+            QCOMPARE(tile1->tileData(), tile2->tileData());
+            QCOMPARE(tile1->tileData(), dm1.getTile(col % 2, 0, false)->tileData());
+        }
+
+        /// writing into a deduplicated tile should detach it
+        KisTileSP tile = dm1.getTile(0, 0, true);
+        tile->lockForWrite();
+        memset(tile->tileData()->data(), 42, TILESIZE);
+        tile->unlockForWrite();
+        tile = 0;
+
+        tile = dm2.getTile(0, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(0), tile->tileData()->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    config.setEnableTileDataDeduplication(false);
+    store->testingRereadConfig();
+
+    QCOMPARE(store->numTiles(), 0);
+}
+
+void KisTileDataStoreTest::testPrefetch()
+{
+    KisImageConfig config(false);
+    config.setMemoryHardLimitPercent(config.memoryHardLimitPercent(true));
+    config.setMemorySoftLimitPercent(config.memorySoftLimitPercent(true));
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const int numTiles = 4;
+
+    for(qint32 col = 0; col < numTiles; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    store->debugSwapAll();
+
+    for(qint32 col = 0; col < numTiles; col++) {
+        QVERIFY(!dm.getTile(col, 0, false)->tileData()->data());
+    }
+
+    /// the last tile is not covered by the hint
+    dm.prefetchRect(QRect(0, 0, (numTiles - 1) * KisTileData::WIDTH, 1));
+
+    for(qint32 col = 0; col < numTiles - 1; col++) {
+        KisTileData *td = dm.getTile(col, 0, false)->tileData();
+        QTRY_VERIFY(td->data());
+    }
+
+    QVERIFY(!dm.getTile(numTiles - 1, 0, false)->tileData()->data());
+
+    for(qint32 col = 0; col < numTiles; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+}
+void KisTileDataStoreTest::testLazyLoading()
+{
+    KisImageConfig config(false);
+    config.setLazyTileLoading(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    const int numTiles = 4;
+
+    KoStoreFake fakeStore;
+
+    {
+        KisTiledDataManager srcDM(pixelSize, &defaultPixel);
+
+        for(qint32 col = 0; col < numTiles; col++) {
+            KisTileSP tile = srcDM.getTile(col, 0, true);
+            tile->lockForWrite();
+            memset(tile->tileData()->data(), COLUMN2COLOR(col), TILESIZE);
+            tile->unlockForWrite();
+        }
+
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        QVERIFY(srcDM.write(writer));
+    }
+
+    fakeStore.startReading();
+
+    {
+        KisTiledDataManager dm(pixelSize, &defaultPixel);
+        const qint32 numTilesInMemoryBefore = store->numTilesInMemory();
+
+        QVERIFY(dm.read(fakeStore.device()));
+
+        // the tiles have gone to the swap without decompression
+        QCOMPARE(store->numTilesInMemory(), numTilesInMemoryBefore);
+
+        for(qint32 col = 0; col < numTiles; col++) {
+            KisTileSP tile = dm.getTile(col, 0, false);
+            tile->lockForRead();
+            QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->tileData()->data(), TILESIZE));
+            tile->unlockForRead();
+        }
+
+        QCOMPARE(store->numTilesInMemory(), numTilesInMemoryBefore + numTiles);
+    }
+
+    config.setLazyTileLoading(false);
+    store->testingRereadConfig();
+}
+
+void KisTileDataStoreTest::testUndoSwapOut()
+{
+    KisImageConfig config(false);
+    config.setUndoSwapOutDepth(1);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    auto fillTile = [&dm] (quint8 color) {
+        KisTileSP tile = dm.getTile(0, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), color, TILESIZE);
+        tile->unlockForWrite();
+    };
+
+    KisMementoSP memento1 = dm.getMemento();
+    fillTile(1);
+    dm.commit();
+
+    KisTileData *oldTileData = dm.getTile(0, 0, false)->tileData();
+
+    KisMementoSP memento2 = dm.getMemento();
+    fillTile(2);
+    dm.commit();
+
+    /// the first revision has left the window of the recent commits
+    QTRY_VERIFY(!oldTileData->data());
+    QVERIFY(dm.getTile(0, 0, false)->tileData()->data());
+
+    dm.rollback(memento2);
+
+    /// the restored tile is prefetched back
+    KisTileSP tile = dm.getTile(0, 0, false);
+    QCOMPARE(tile->tileData(), oldTileData);
+    QTRY_VERIFY(oldTileData->data());
+
+    tile->lockForRead();
+    QVERIFY(memoryIsFilled(1, tile->data(), TILESIZE));
+    tile->unlockForRead();
+
+    config.setUndoSwapOutDepth(0);
+    store->testingRereadConfig();
+}
+
+
 SIMPLE_TEST_MAIN(KisTileDataStoreTest)
 
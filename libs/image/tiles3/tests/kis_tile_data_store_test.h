@@ -18,6 +18,10 @@ private Q_SLOTS:
     void testClockIterator();
     void testLeaks();
     void testSwapping();
+    void testDeduplication();
+    void testPrefetch();
+    void testLazyLoading();
+    void testUndoSwapOut();
 };
 
 #endif /* KIS_TILE_DATA_STORE_TEST_H */
@@ -10,6 +10,9 @@
 #include <QRandomGenerator>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_hash_table3.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/KisTileSavingCache.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -104,6 +107,31 @@ void KisTiledDataManagerTest::testUndoingNewTiles()
     QCOMPARE(srcDM.extent(), nullRect);
 }
 
+void KisTiledDataManagerTest::testUniformTileData()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    // the default tile is uniform
+    QVERIFY(srcDM.getTile(0, 0, false)->tileData()->isUniform());
+
+    // the tiles covered by the cleared rect fully share a uniform data
+    quint8 oddPixel = 128;
+    srcDM.clear(QRect(0, 0, 128, 64), &oddPixel);
+
+    KisTileSP tile0 = srcDM.getTile(0, 0, false);
+    KisTileSP tile1 = srcDM.getTile(1, 0, false);
+
+    QVERIFY(tile0->tileData()->isUniform());
+    QCOMPARE(tile0->tileData(), tile1->tileData());
+
+    // a write detaches the data and resets the flag
+    srcDM.setPixel(10, 10, &defaultPixel);
+
+    QVERIFY(!srcDM.getTile(0, 0, false)->tileData()->isUniform());
+    QVERIFY(srcDM.getTile(1, 0, false)->tileData()->isUniform());
+}
+
 void KisTiledDataManagerTest::testPurgedAndEmptyTransactions()
 {
     quint8 defaultPixel = 0;
@@ -173,6 +201,55 @@ void KisTiledDataManagerTest::testPurgedAndEmptyTransactions()
 
 
 }
+
+void KisTiledDataManagerTest::testDropUnchangedTiles()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    const quint8 oddPixel1 = 128;
+    const quint8 oddPixel2 = 255;
+    srcDM.clear(QRect(0, 0, 128, 64), oddPixel1);
+
+    QVector<quint8> sameData(64 * 64, oddPixel1);
+    QVector<quint8> newData(64 * 64, oddPixel2);
+    QVector<quint8> defaultData(64 * 64, defaultPixel);
+
+    KisMementoSP memento1 = srcDM.getMemento();
+    srcDM.writeBytes(sameData.data(), 0, 0, 64, 64);
+    srcDM.writeBytes(newData.data(), 64, 0, 64, 64);
+    srcDM.writeBytes(defaultData.data(), 0, 64, 64, 64);
+    srcDM.commit();
+
+    // only the really changed tile is stored in the revision
+    QCOMPARE(memento1->extent(), QRect(64, 0, 64, 64));
+
+    // the dropped tile still registers its changes
+    KisMementoSP memento2 = srcDM.getMemento();
+    srcDM.writeBytes(newData.data(), 0, 0, 64, 64);
+    srcDM.commit();
+
+    QCOMPARE(memento2->extent(), QRect(0, 0, 64, 64));
+
+    quint8 pixel = 0;
+
+    srcDM.rollback(memento2);
+    srcDM.readBytes(&pixel, 0, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel1);
+    srcDM.readBytes(&pixel, 64, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel2);
+
+    srcDM.rollback(memento1);
+    srcDM.readBytes(&pixel, 0, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel1);
+    srcDM.readBytes(&pixel, 64, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel1);
+
+    srcDM.rollforward(memento1);
+    srcDM.readBytes(&pixel, 64, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel2);
+}
+
 void KisTiledDataManagerTest::testUnversionedBitBlt()
 {
     quint8 defaultPixel = 0;
@@ -204,6 +281,45 @@ void KisTiledDataManagerTest::testUnversionedBitBlt()
     QVERIFY(checkTilesShared(&srcDM, &dstDM, false, false, tilesRect));
 }
 
+void KisTiledDataManagerTest::testShiftedBitBlt()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+    KisTiledDataManager dstDM(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    QRect rect(0,0,512,512);
+    QRect cloneRect(81,80,250,250);
+    QRect tilesRect(2,2,3,3);
+    QPoint tileOffset(1,2);
+
+    srcDM.clear(rect, &oddPixel1);
+    dstDM.clear(rect, &oddPixel2);
+
+    dstDM.bitBlt(&srcDM, cloneRect, tileOffset);
+
+    quint8 *buffer = new quint8[rect.width()*rect.height()];
+
+    dstDM.readBytes(buffer, rect.x(), rect.y(), rect.width(), rect.height());
+
+    QVERIFY(checkHole(buffer, oddPixel1, cloneRect.translated(64, 128),
+                      oddPixel2, rect));
+
+    delete[] buffer;
+
+    // Test whether tiles became shared
+    for(qint32 row = tilesRect.y(); row <= tilesRect.bottom(); row++) {
+        for(qint32 col = tilesRect.x(); col <= tilesRect.right(); col++) {
+            KisTileSP srcTile = srcDM.getTile(col, row, false);
+            KisTileSP dstTile = dstDM.getTile(col + tileOffset.x(), row + tileOffset.y(), false);
+
+            QCOMPARE(dstTile->tileData(), srcTile->tileData());
+        }
+    }
+}
+
 void KisTiledDataManagerTest::testVersionedBitBlt()
 {
     quint8 defaultPixel = 0;
@@ -531,6 +647,301 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testOpenAddressingHashTable()
+{
+    quint8 defaultPixel = 0;
+    KisTileData *defaultTileData =
+        KisTileDataStore::instance()->createDefaultTileData(1, &defaultPixel);
+
+    typedef KisTileHashTableTraits3<KisTile> HashTable;
+
+    HashTable table(0);
+    table.setDefaultTileData(defaultTileData);
+
+    // enough tiles to make the table grow a few times
+    const qint32 numCols = 50;
+    const qint32 numRows = 40;
+
+    for (qint32 row = -numRows / 2; row < numRows / 2; row++) {
+        for (qint32 col = -numCols / 2; col < numCols / 2; col++) {
+            bool newTile = false;
+            KisTileSP tile = table.getTileLazy(col, row, newTile);
+            QVERIFY(newTile);
+            QCOMPARE(tile->col(), col);
+            QCOMPARE(tile->row(), row);
+        }
+    }
+
+    QCOMPARE(table.numTiles(), numCols * numRows);
+
+    bool newTile = true;
+    KisTileSP tile = table.getTileLazy(3, 4, newTile);
+    QVERIFY(!newTile);
+    QVERIFY(table.getExistingTile(3, 4) == tile);
+    tile = 0;
+
+    // delete every second column
+    for (qint32 row = -numRows / 2; row < numRows / 2; row++) {
+        for (qint32 col = -numCols / 2; col < numCols / 2; col += 2) {
+            QVERIFY(table.deleteTile(col, row));
+        }
+    }
+
+    QCOMPARE(table.numTiles(), numCols * numRows / 2);
+
+    bool existingTile = true;
+    tile = table.getReadOnlyTileLazy(-numCols / 2, 0, existingTile);
+    QVERIFY(!existingTile);
+    QVERIFY(!table.getExistingTile(-numCols / 2, 0));
+    QVERIFY(table.getExistingTile(-numCols / 2 + 1, 0));
+
+    // the deleted keys should be reusable
+    tile = table.getTileLazy(-numCols / 2, 0, newTile);
+    QVERIFY(newTile);
+    tile = 0;
+
+    int numIterated = 0;
+    {
+        KisTileHashTableIteratorTraits3<KisTile> iter(&table);
+        while (!iter.isDone()) {
+            QVERIFY(iter.tile());
+            numIterated++;
+            iter.next();
+        }
+    }
+    QCOMPARE(numIterated, numCols * numRows / 2 + 1);
+
+    table.clear();
+    QVERIFY(table.isEmpty());
+    QVERIFY(!table.getExistingTile(3, 4));
+
+    table.setDefaultTileData(0);
+}
+
+void KisTiledDataManagerTest::testReadWriteManyTiles()
+{
+    /**
+     * The device is big enough to be (de)compressed on
+     * several threads, the layout of the result must be
+     * the same as in the sequential case
+     */
+    const QRect rect(-100, -100, 30 * KisTileData::WIDTH, 30 * KisTileData::HEIGHT);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    QByteArray srcData(rect.width() * rect.height(), 0);
+    QRandomGenerator random(1234);
+    for (int i = 0; i < srcData.size(); i++) {
+        // keep the data partially compressible
+        srcData[i] = (i / 7) % 3 ? char(random.bounded(256)) : char(i / 255);
+    }
+    srcDM.writeBytes(reinterpret_cast<const quint8*>(srcData.constData()),
+                     rect.x(), rect.y(), rect.width(), rect.height());
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(srcDM.write(writer));
+
+    fakeStore.startReading();
+
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    QVERIFY(dstDM.read(fakeStore.device()));
+
+    QByteArray dstData(srcData.size(), 0);
+    dstDM.readBytes(reinterpret_cast<quint8*>(dstData.data()),
+                    rect.x(), rect.y(), rect.width(), rect.height());
+
+    QCOMPARE(dstDM.extent(), srcDM.extent());
+    QVERIFY(dstData == srcData);
+}
+
+class KisCachingPaintDeviceWriter : public KisFakePaintDeviceWriter
+{
+public:
+    KisCachingPaintDeviceWriter(KoStore *store, KisTileSavingCache *cache)
+        : KisFakePaintDeviceWriter(store),
+          m_cache(cache)
+    {
+    }
+
+    KisTileSavingCache* tileSavingCache() const override {
+        return m_cache;
+    }
+
+private:
+    KisTileSavingCache *m_cache;
+};
+
+QByteArray KisTiledDataManagerTest::writeDataManager(KisTiledDataManager &dm, KisTileSavingCache *cache)
+{
+    KoStoreFake fakeStore;
+    KisCachingPaintDeviceWriter writer(&fakeStore, cache);
+    bool result = dm.write(writer);
+    Q_ASSERT(result);
+    Q_UNUSED(result);
+
+    fakeStore.startReading();
+    return fakeStore.device()->readAll();
+}
+
+void KisTiledDataManagerTest::testTileSavingCache()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+    dm.clear(0, 0, 4 * KisTileData::WIDTH, 4 * KisTileData::HEIGHT, &oddPixel1);
+
+    KisTileSavingCache cache;
+
+    KisTileData *tileData = dm.getTile(0, 0, false)->tileData();
+    const qint32 numUsers = tileData->numUsers();
+
+    cache.beginPass();
+    const QByteArray firstPass = writeDataManager(dm, &cache);
+    cache.endPass();
+
+    QCOMPARE(firstPass, writeDataManager(dm, nullptr));
+    QCOMPARE(cache.numEntries(), 16);
+
+    // the cache doesn't hold the tile data
+    QCOMPARE(tileData->numUsers(), numUsers);
+
+    // the change gives the tile a new revision
+    dm.clear(0, 0, 1, 1, &oddPixel2);
+
+    cache.beginPass();
+    const QByteArray secondPass = writeDataManager(dm, &cache);
+    cache.endPass();
+
+    QVERIFY(secondPass != firstPass);
+    QCOMPARE(secondPass, writeDataManager(dm, nullptr));
+    QCOMPARE(cache.numEntries(), 16);
+
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    {
+        KoStoreFake fakeStore;
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        writer.write(secondPass);
+        fakeStore.startReading();
+        QVERIFY(dstDM.read(fakeStore.device()));
+    }
+
+    quint8 pixel = 0;
+    dstDM.readBytes(&pixel, 0, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel2);
+    dstDM.readBytes(&pixel, 1, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel1);
+
+    cache.setMemoryLimit(0);
+    cache.beginPass();
+    writeDataManager(dm, &cache);
+    cache.endPass();
+
+    QCOMPARE(cache.numEntries(), 0);
+}
+
+void KisTiledDataManagerTest::testWriteDelta()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager baseDM(1, &defaultPixel);
+    baseDM.clear(0, 0, 4 * KisTileData::WIDTH, 4 * KisTileData::HEIGHT, &oddPixel1);
+
+    // the copy shares all the tiles, then one tile is changed and one is removed
+    KisTiledDataManager dm(baseDM);
+    dm.clear(0, 0, 1, 1, &oddPixel2);
+    dm.clear(3 * KisTileData::WIDTH, 3 * KisTileData::HEIGHT,
+             KisTileData::WIDTH, KisTileData::HEIGHT, &defaultPixel);
+    dm.purge(dm.extent());
+
+    QCOMPARE(dm.numSharedTiles(&baseDM), 14);
+
+    QByteArray delta;
+    {
+        KoStoreFake fakeStore;
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        QVERIFY(dm.writeDelta(writer, &baseDM));
+        fakeStore.startReading();
+        delta = fakeStore.device()->readAll();
+    }
+
+    QVERIFY(delta.size() < writeDataManager(dm, nullptr).size());
+
+    /**
+     * The delta is a usual tiles stream with the changed tile and
+     * the removed one, which is stored as a default tile
+     */
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    {
+        KoStoreFake fakeStore;
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        writer.write(delta);
+        fakeStore.startReading();
+        QVERIFY(dstDM.read(fakeStore.device()));
+    }
+
+    quint8 pixel = 0;
+    dstDM.readBytes(&pixel, 0, 0, 1, 1);
+    QCOMPARE(pixel, oddPixel2);
+    dstDM.readBytes(&pixel, 3 * KisTileData::WIDTH, 3 * KisTileData::HEIGHT, 1, 1);
+    QCOMPARE(pixel, defaultPixel);
+    dstDM.readBytes(&pixel, KisTileData::WIDTH, 0, 1, 1);
+    QCOMPARE(pixel, defaultPixel);
+}
+
+void KisTiledDataManagerTest::testAddMissingTiles()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager baseDM(1, &defaultPixel);
+    baseDM.clear(0, 0, 4 * KisTileData::WIDTH, 4 * KisTileData::HEIGHT, &oddPixel1);
+
+    KisTiledDataManager dm(baseDM);
+    dm.clear(0, 0, 1, 1, &oddPixel2);
+    dm.clear(3 * KisTileData::WIDTH, 3 * KisTileData::HEIGHT,
+             KisTileData::WIDTH, KisTileData::HEIGHT, &defaultPixel);
+    dm.purge(dm.extent());
+
+    QByteArray delta;
+    {
+        KoStoreFake fakeStore;
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        QVERIFY(dm.writeDelta(writer, &baseDM));
+        fakeStore.startReading();
+        delta = fakeStore.device()->readAll();
+    }
+
+    KisTiledDataManager loadedBaseDM(baseDM);
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    {
+        KoStoreFake fakeStore;
+        KisFakePaintDeviceWriter writer(&fakeStore);
+        writer.write(delta);
+        fakeStore.startReading();
+        QVERIFY(dstDM.read(fakeStore.device()));
+    }
+    dstDM.addMissingTiles(&loadedBaseDM);
+
+    // the tiles missing in the delta are shared with the base, not copied
+    QCOMPARE(dstDM.numSharedTiles(&loadedBaseDM), 14);
+
+    const QRect rect(0, 0, 4 * KisTileData::WIDTH, 4 * KisTileData::HEIGHT);
+    QByteArray expectedData(rect.width() * rect.height(), 0);
+    QByteArray dstData(expectedData.size(), 0);
+
+    dm.readBytes(reinterpret_cast<quint8*>(expectedData.data()), rect.x(), rect.y(), rect.width(), rect.height());
+    dstDM.readBytes(reinterpret_cast<quint8*>(dstData.data()), rect.x(), rect.y(), rect.width(), rect.height());
+
+    QVERIFY(dstData == expectedData);
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
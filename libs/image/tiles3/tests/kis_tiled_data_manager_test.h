@@ -9,6 +9,7 @@
 #include <simpletest.h>
 
 class KisTiledDataManager;
+class KisTileSavingCache;
 
 class KisTiledDataManagerTest : public QObject
 {
@@ -30,10 +31,15 @@ private:
 
     void benchmarkCOWImpl();
 
+    static QByteArray writeDataManager(KisTiledDataManager &dm, KisTileSavingCache *cache);
+
 private Q_SLOTS:
     void testUndoingNewTiles();
     void testPurgedAndEmptyTransactions();
+    void testUniformTileData();
+    void testDropUnchangedTiles();
     void testUnversionedBitBlt();
+    void testShiftedBitBlt();
     void testVersionedBitBlt();
     void testBitBltOldData();
     void testBitBltRough();
@@ -41,6 +47,13 @@ private Q_SLOTS:
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
 
+    void testOpenAddressingHashTable();
+
+    void testReadWriteManyTiles();
+    void testTileSavingCache();
+    void testWriteDelta();
+    void testAddMissingTiles();
+
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
 
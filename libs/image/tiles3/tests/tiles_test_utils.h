@@ -72,7 +72,7 @@ bool memoryIsFilled(quint8 c, quint8 *mem, qint32 size)
     return true;
 }
 
-#define TILESIZE 64*64
+#define TILESIZE (KisTileData::WIDTH * KisTileData::HEIGHT)
 
 
 #endif /* TILES_TEST_UTILS_H */
@@ -67,6 +67,7 @@
 #include <kis_image_animation_interface.h>
 #include <kis_layer_utils.h>
 #include <kis_undo_adapter.h>
+#include <kis_memory_statistics_server.h>
 #include <commands/kis_set_global_selection_command.h>
 
 
@@ -320,6 +321,42 @@ void Document::setName(QString value)
 }
 
 
+QMap<QString, QVariant> Document::memoryStatistics() const
+{
+    QMap<QString, QVariant> result;
+    if (!d->document) return result;
+
+    KisMemoryStatisticsServer::Statistics stats =
+        KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(d->document->image());
+
+    result["imageSize"] = stats.imageSize;
+    result["layersSize"] = stats.layersSize;
+    result["projectionsSize"] = stats.projectionsSize;
+    result["lodSize"] = stats.lodSize;
+
+    QVariantList layers;
+    Q_FOREACH (const KisMemoryStatisticsServer::NodeStatistics &nodeStats, stats.nodes) {
+        QMap<QString, QVariant> layer;
+        layer["name"] = nodeStats.name;
+        layer["uuid"] = nodeStats.uuid.toString();
+        layer["layerSize"] = nodeStats.layerSize;
+        layer["projectionSize"] = nodeStats.projectionSize;
+        layer["lodSize"] = nodeStats.lodSize;
+        layers << layer;
+    }
+    result["layers"] = layers;
+
+    result["totalMemorySize"] = stats.totalMemorySize;
+    result["realMemorySize"] = stats.realMemorySize;
+    result["undoSize"] = stats.historicalMemorySize;
+    result["poolSize"] = stats.poolSize;
+    result["frameCacheSize"] = stats.frameCacheSize;
+    result["swapSize"] = stats.swapSize;
+    result["compressedSwapSize"] = stats.compressedPoolSize;
+
+    return result;
+}
+
 int Document::resolution() const
 {
     if (!d->document) return 0;
@@ -844,6 +881,29 @@ void Document::refreshProjection()
 
 }
 
+void Document::startBatchUpdate()
+{
+    if (!d->document || !d->document->image()) return;
+    LibKisUtils::startBatchUpdate(d->document->image());
+}
+
+void Document::finishBatchUpdate()
+{
+    if (!d->document || !d->document->image()) return;
+    KisImageSP image = d->document->image();
+
+    KisBatchNodeUpdate updates;
+    if (!LibKisUtils::finishBatchUpdate(image, &updates)) return;
+
+    // a single barrier for all the operations queued during the batch
+    image->waitForDone();
+
+    updates.compress();
+    for (auto it = updates.begin(); it != updates.end(); ++it) {
+        image->refreshGraphAsync(it->first, it->second);
+    }
+}
+
 QList<qreal> Document::horizontalGuides() const
 {
     warnScript << "DEPRECATED Document.horizontalGuides() - use Document.guidesConfig().horizontalGuides() instead";
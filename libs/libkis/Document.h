@@ -291,6 +291,24 @@ public Q_SLOTS:
      */
     void setName(QString value);
 
+    /**
+     * @brief memoryStatistics returns a breakdown of the memory used by the image
+     *
+     * All the sizes are in bytes. The map contains the following keys:
+     *
+     *  - "imageSize", "layersSize", "projectionsSize" and "lodSize":
+     *    the memory used by the paint devices of this image
+     *  - "layers": a list of maps with "name", "uuid", "layerSize",
+     *    "projectionSize" and "lodSize" keys for every node of the image,
+     *    sorted by size in descending order
+     *  - "totalMemorySize", "realMemorySize", "undoSize", "poolSize",
+     *    "frameCacheSize", "swapSize" and "compressedSwapSize": the memory
+     *    used by all the open images of Krita
+     *
+     * @return a map with the memory statistics
+     */
+    QMap<QString, QVariant> memoryStatistics() const;
+
     /**
      * @return the resolution in pixels per inch
      */
@@ -767,6 +785,35 @@ print(root.childNodes())
      */
     void refreshProjection();
 
+    /**
+     * @brief startBatchUpdate starts collecting the changes of the nodes of
+     * this document, so that they could be applied in one go.
+     *
+     * Until finishBatchUpdate() is called:
+     *
+     *  - the node operations that run as separate actions (e.g. setting
+     *    the blending mode, rotating or removing a node) do not wait for
+     *    the image to finish them. The wait happens only when the pixels
+     *    or the properties of a node are accessed directly next time.
+     *
+     *  - the pixel writes, moves and property changes of the nodes are
+     *    recorded and the affected parts of the nodes are refreshed by
+     *    finishBatchUpdate(), there is no need to call refreshProjection()
+     *
+     * The calls may be nested, only the outermost finishBatchUpdate()
+     * applies the changes.
+     */
+    void startBatchUpdate();
+
+    /**
+     * @brief finishBatchUpdate ends the batch started with startBatchUpdate().
+     *
+     * Waits for the queued node operations to complete and starts an
+     * asynchronous update of the changed nodes. Call waitForDone() if you
+     * need the updated projection right away.
+     */
+    void finishBatchUpdate();
+
     /**
      * @brief DEPRECATED - use guidesConfig() instead
      * replace all existing horizontal guides with the entries in the list.
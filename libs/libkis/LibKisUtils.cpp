@@ -6,6 +6,8 @@
 
 #include "LibKisUtils.h"
 
+#include <QHash>
+
 #include <kis_node.h>
 #include <kis_paint_layer.h>
 #include <kis_group_layer.h>
@@ -37,6 +39,30 @@
 #include "TransformMask.h"
 
 
+namespace {
+
+struct BatchUpdate
+{
+    int depth = 0;
+    bool hasQueuedStrokes = false;
+    KisBatchNodeUpdate updates;
+};
+
+/**
+ * libkis is used from the GUI thread only, so the batches
+ * need no locking
+ */
+Q_GLOBAL_STATIC(QHash<const KisImage*, BatchUpdate>, s_batchUpdates)
+
+BatchUpdate* activeBatchUpdate(KisImageSP image)
+{
+    if (!image) return nullptr;
+
+    auto it = s_batchUpdates->find(image.data());
+    return it != s_batchUpdates->end() ? &it.value() : nullptr;
+}
+
+}
 
 QList<Node *> LibKisUtils::createNodeList(KisNodeList kisnodes, KisImageWSP image)
 {
@@ -54,3 +80,54 @@ Document* LibKisUtils::findNodeInDocuments(KisNodeSP kisnode) {
 
     return 0;
 }
+
+void LibKisUtils::startBatchUpdate(KisImageSP image)
+{
+    if (!image) return;
+    (*s_batchUpdates)[image.data()].depth++;
+}
+
+bool LibKisUtils::finishBatchUpdate(KisImageSP image, KisBatchNodeUpdate *updates)
+{
+    BatchUpdate *batch = activeBatchUpdate(image);
+    if (!batch) return false;
+
+    if (--batch->depth > 0) return false;
+
+    *updates = batch->updates;
+    s_batchUpdates->remove(image.data());
+
+    return true;
+}
+
+void LibKisUtils::waitForDone(KisImageSP image)
+{
+    if (!image) return;
+
+    BatchUpdate *batch = activeBatchUpdate(image);
+
+    if (batch) {
+        batch->hasQueuedStrokes = true;
+    } else {
+        image->waitForDone();
+    }
+}
+
+void LibKisUtils::ensureStrokesDone(KisImageSP image)
+{
+    BatchUpdate *batch = activeBatchUpdate(image);
+
+    if (batch && batch->hasQueuedStrokes) {
+        image->waitForDone();
+        batch->hasQueuedStrokes = false;
+    }
+}
+
+bool LibKisUtils::addBatchUpdate(KisImageSP image, KisNodeSP node, const QRect &rc)
+{
+    BatchUpdate *batch = activeBatchUpdate(image);
+    if (!batch) return false;
+
+    batch->updates.addUpdate(node, rc);
+    return true;
+}
@@ -11,6 +11,7 @@ class Node;
 class Document;
 
 #include <kis_types.h>
+#include <KisBatchNodeUpdate.h>
 
 namespace LibKisUtils
 {
@@ -19,6 +20,41 @@ QList<Node *> createNodeList(KisNodeList kisnodes, KisImageWSP image);
 
 Document* findNodeInDocuments(KisNodeSP kisnode);
 
+/**
+ * Starts (or nests) a batch update of \p image,
+ * see Document::startBatchUpdate()
+ */
+void startBatchUpdate(KisImageSP image);
+
+/**
+ * Ends one level of the batch update of \p image. When the outermost
+ * level ends, returns true and passes the updates collected during
+ * the batch in \p updates.
+ */
+bool finishBatchUpdate(KisImageSP image, KisBatchNodeUpdate *updates);
+
+/**
+ * Called by the operations that have just queued a stroke. Outside of
+ * a batch update waits for the image to finish the stroke, during the
+ * batch the barrier is postponed until ensureStrokesDone() is called.
+ */
+void waitForDone(KisImageSP image);
+
+/**
+ * Called by the operations that access the nodes directly. Waits for
+ * the strokes queued during the active batch update, if any.
+ */
+void ensureStrokesDone(KisImageSP image);
+
+/**
+ * Records the update of \p rc of \p node if a batch update of
+ * \p image is active. The recorded updates are issued at the end
+ * of the batch.
+ *
+ * \return false if there is no batch update active
+ */
+bool addBatchUpdate(KisImageSP image, KisNodeSP node, const QRect &rc);
+
 }
 
 #endif // LIBKISUTILS_H
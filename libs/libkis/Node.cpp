@@ -42,6 +42,8 @@
 #include <kis_asl_layer_style_serializer.h>
 
 #include <kis_raster_keyframe_channel.h>
+#include <kis_paint_device_frames_interface.h>
+#include <kis_datamanager.h>
 #include <kis_keyframe.h>
 #include "kis_selection.h"
 
@@ -190,7 +192,7 @@ void Node::setBlendingMode(QString value)
                                                        value);
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 }
 
 
@@ -275,7 +277,7 @@ bool Node::addChildNode(Node *child, Node *above)
     }
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 
     return true;
 }
@@ -340,7 +342,7 @@ bool Node::setColorProfile(const QString &colorProfile)
     KisLayer *layer = qobject_cast<KisLayer*>(d->node.data());
     const KoColorProfile *profile = KoColorSpaceRegistry::instance()->profileByName(colorProfile);
     bool result = d->image->assignLayerProfile(layer, profile);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
     return result;
 }
 
@@ -354,7 +356,7 @@ bool Node::setColorSpace(const QString &colorModel, const QString &colorDepth, c
                                                                              colorDepth,
                                                                              profile);
     d->image->convertLayerColorSpace(d->node, dstCs, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
     return true;
 }
 
@@ -449,7 +451,9 @@ void Node::setOpacity(int value)
     if (!d->node) return;
     if (value < 0) value = 0;
     if (value > 255) value = 255;
+    LibKisUtils::ensureStrokesDone(d->image);
     d->node->setOpacity(value);
+    LibKisUtils::addBatchUpdate(d->image, d->node, d->node->extent());
 }
 
 
@@ -539,7 +543,9 @@ bool Node::hasKeyframeAtTime(int frameNumber)
 void Node::setVisible(bool visible)
 {
     if (!d->node) return;
+    LibKisUtils::ensureStrokesDone(d->image);
     d->node->setVisible(visible);
+    LibKisUtils::addBatchUpdate(d->image, d->node, d->node->extent());
 }
 
 
@@ -548,6 +554,7 @@ QByteArray Node::pixelData(int x, int y, int w, int h) const
     QByteArray ba;
 
     if (!d->node) return ba;
+    LibKisUtils::ensureStrokesDone(d->image);
 
     KisPaintDeviceSP dev = d->node->paintDevice();
     if (!dev) return ba;
@@ -562,13 +569,37 @@ QByteArray Node::pixelDataAtTime(int x, int y, int w, int h, int time) const
     QByteArray ba;
 
     if (!d->node || !d->node->isAnimated()) return ba;
+    LibKisUtils::ensureStrokesDone(d->image);
 
     //
     KisRasterKeyframeChannel *rkc = dynamic_cast<KisRasterKeyframeChannel*>(d->node->getKeyframeChannel(KisKeyframeChannel::Raster.id()));
     if (!rkc) return ba;
     KisRasterKeyframeSP frame = rkc->keyframeAt<KisRasterKeyframe>(time);
     if (!frame) return ba;
-    KisPaintDeviceSP dev = new KisPaintDevice(*d->node->paintDevice(), KritaUtils::DeviceCopyMode::CopySnapshot);
+
+    KisPaintDeviceSP nodeDevice = d->node->paintDevice();
+    if (!nodeDevice) return ba;
+
+    /**
+     * Read the frame right from its data manager instead of writing it
+     * into a snapshot of the device. The wrap-around mode needs the
+     * reading strategy of a real device though.
+     */
+    KisPaintDeviceSP frameDevice = rkc->paintDevice();
+
+    if (frameDevice && frameDevice->framesInterface() &&
+        !frameDevice->defaultBounds()->wrapAroundMode()) {
+
+        KisPaintDeviceFramesInterface *frames = frameDevice->framesInterface();
+        KisDataManagerSP dm = frames->frameDataManager(frame->frameID());
+        const QPoint offset = frames->frameOffset(frame->frameID());
+
+        ba.resize(w * h * frameDevice->pixelSize());
+        dm->readBytes(reinterpret_cast<quint8*>(ba.data()), x - offset.x(), y - offset.y(), w, h);
+        return ba;
+    }
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*nodeDevice, KritaUtils::DeviceCopyMode::CopySnapshot);
     if (!dev) return ba;
 
     frame->writeFrameToDevice(dev);
@@ -584,6 +615,7 @@ QByteArray Node::projectionPixelData(int x, int y, int w, int h) const
     QByteArray ba;
 
     if (!d->node) return ba;
+    LibKisUtils::ensureStrokesDone(d->image);
 
     KisPaintDeviceSP dev;
     if (const KisColorizeMask *mask = qobject_cast<const KisColorizeMask*>(d->node)) {
@@ -608,21 +640,27 @@ bool Node::setPixelData(QByteArray value, int x, int y, int w, int h)
         qWarning() << "Node::setPixelData: not enough data to write to the paint device";
         return false;
     }
+    LibKisUtils::ensureStrokesDone(d->image);
     dev->writeBytes((const quint8*)value.constData(), x, y, w, h);
+    LibKisUtils::addBatchUpdate(d->image, d->node, QRect(x, y, w, h));
     return true;
 }
 
 QRect Node::bounds() const
 {
     if (!d->node) return QRect();
+    LibKisUtils::ensureStrokesDone(d->image);
     return d->node->exactBounds();
 }
 
 void Node::move(int x, int y)
 {
     if (!d->node) return;
+    LibKisUtils::ensureStrokesDone(d->image);
+    const QRect oldExtent = d->node->extent();
     d->node->setX(x);
     d->node->setY(y);
+    LibKisUtils::addBatchUpdate(d->image, d->node, oldExtent | d->node->extent());
 }
 
 QPoint Node::position() const
@@ -639,7 +677,7 @@ bool Node::remove()
     KUndo2Command *cmd = new KisImageLayerRemoveCommand(d->image, d->node);
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 
     return true;
 }
@@ -710,7 +748,7 @@ void Node::scaleNode(QPointF origin, int width, int height, QString strategy)
                         qreal(width) / bounds.width(),
                         qreal(height) / bounds.height(),
                         actualStrategy, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 }
 
 void Node::rotateNode(double radians)
@@ -720,7 +758,7 @@ void Node::rotateNode(double radians)
     if (!d->node->parent()) return;
 
     d->image->rotateNode(d->node, radians, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 }
 
 void Node::cropNode(int x, int y, int w, int h)
@@ -731,7 +769,7 @@ void Node::cropNode(int x, int y, int w, int h)
 
     QRect rect = QRect(x, y, w, h);
     d->image->cropNode(d->node, rect);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 }
 
 void Node::shearNode(double angleX, double angleY)
@@ -741,7 +779,7 @@ void Node::shearNode(double angleX, double angleY)
     if (!d->node->parent()) return;
 
     d->image->shearNode(d->node, angleX, angleY, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 }
 
 QImage Node::thumbnail(int w, int h)
@@ -795,7 +833,7 @@ bool Node::setLayerStyleFromAsl(const QString &asl)
     KUndo2Command *cmd = new KisSetLayerStyleCommand(layer, layer->layerStyle(), newStyle);
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForDone(d->image);
 
     return true;
 }
@@ -433,5 +433,41 @@ void TestDocument::testNodeByUniqueId()
 
 class KisTransformMaskAdapter;
 
+void TestDocument::testMemoryStatistics()
+{
+    QScopedPointer<KisDocument> kisdoc(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer1 = new KisPaintLayer(image, "test1", 255);
+    KisNodeSP layer2 = new KisPaintLayer(image, "test2", 255);
+    KisFillPainter gc(layer2->paintDevice());
+    gc.fillRect(0, 0, 100, 100, KoColor(Qt::red, layer2->colorSpace()));
+    image->addNode(layer1);
+    image->addNode(layer2);
+    kisdoc->setCurrentImage(image);
+
+    Document d(kisdoc.data(), false);
+    d.refreshProjection();
+
+    QMap<QString, QVariant> stats = d.memoryStatistics();
+    QVERIFY(stats["imageSize"].toLongLong() > 0);
+    QVERIFY(stats["layersSize"].toLongLong() > 0);
+
+    QVariantList layers = stats["layers"].toList();
+    QVERIFY(!layers.isEmpty());
+
+    QMap<QString, QVariant> filledLayer;
+    Q_FOREACH (const QVariant &value, layers) {
+        QMap<QString, QVariant> layer = value.toMap();
+        if (layer["uuid"].toString() == layer2->uuid().toString()) {
+            filledLayer = layer;
+        }
+    }
+
+    QCOMPARE(filledLayer["name"].toString(), QString("test2"));
+    QVERIFY(filledLayer["layerSize"].toLongLong() > 0);
+
+    KisPart::instance()->removeDocument(kisdoc.data(), false);
+}
+
 KISTEST_MAIN(TestDocument)
 
@@ -23,6 +23,7 @@ private Q_SLOTS:
     void testAnnotations();
     void testNodeByName();
     void testNodeByUniqueId();
+    void testMemoryStatistics();
 };
 
 #endif
@@ -15,6 +15,8 @@
 
 #include <QDebug>
 
+#include "config-xsimd-avx512.h"
+
 KRITAMULTIARCH_EXPORT
 std::tuple<bool, bool> vectorizationConfiguration();
 
@@ -35,14 +37,24 @@ auto createOptimizedClass(Args &&...param)
     }
 
     if (disableAVXOptimizations
-        && (xsimd::available_architectures().fma3_avx2
+        && (xsimd::available_architectures().avx512bw
+            || xsimd::available_architectures().fma3_avx2
             || xsimd::available_architectures().avx)) {
-        qWarning() << "WARNING: AVX and AVX2 optimizations are disabled by the "
+        qWarning() << "WARNING: AVX, AVX2 and AVX-512 optimizations are disabled by the "
                       "\'disableAVXOptimizations\' option!";
     }
 
 #ifdef Q_PROCESSOR_X86
 
+#ifdef HAVE_XSIMD_AVX512
+    if (!disableAVXOptimizations &&
+        xsimd::available_architectures().avx512bw) {
+
+        return FactoryType::template create<xsimd::avx512bw>(
+            std::forward<Args>(param)...);
+    }
+#endif
+
     if (!disableAVXOptimizations &&
         xsimd::available_architectures().fma3_avx2) {
 
@@ -142,12 +142,27 @@ private:
 
         float s = scale();
 
+        /**
+         * Both dither matrices depend on the lowest 6 bits of the
+         * x coordinate only, so the factors of a row repeat with a
+         * period of 64 pixels. Precomputing them per row keeps the
+         * matrix lookups out of the pixel loop, which leaves only
+         * plain arithmetic there for the compiler to vectorize.
+         */
+        const int factorsPeriod = 64;
+        const int numFactors = qMin(columns, factorsPeriod);
+        float rowFactors[factorsPeriod];
+
         for (int a = 0; a < rows; ++a) {
             const srcChannelsType *srcPtr = srcCSTraits::nativeArray(nativeSrc);
             dstChannelsType *dstPtr = dstCSTraits::nativeArray(nativeDst);
 
+            for (int i = 0; i < numFactors; ++i) {
+                rowFactors[i] = factor(x + i, y + a);
+            }
+
             for (int b = 0; b < columns; ++b) {
-                float f = factor(x + b, y + a);
+                const float f = rowFactors[b & (factorsPeriod - 1)];
 
                 for (uint channelIndex = 0; channelIndex < srcCSTraits::channels_nb; ++channelIndex) {
                     float c = KoColorSpaceMaths<srcChannelsType, float>::scaleToA(srcPtr[channelIndex]);
@@ -9,7 +9,9 @@
 #include <QList>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QThread>
 #include <QThreadStorage>
+#include <QVector>
 
 #include <KoColorSpace.h>
 
@@ -63,13 +65,142 @@ struct KoColorConversionCache::CachedTransformation {
 
 typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
 
+namespace {
+
+/**
+ * The number of independently locked parts of the cache. Threads
+ * looking for different conversions almost never meet on the same
+ * mutex.
+ */
+const int numCacheShards = 16;
+
+/**
+ * The number of the most recently used conversions every thread
+ * keeps without locking anything. Painting with a color-managed
+ * brush usually needs two of them (to and from the painting color
+ * space) plus a couple for the display and the color selectors.
+ */
+const int numFastPathItems = 4;
+
+/**
+ * Per-thread MRU list of the transformations. Every item keeps
+ * its transformation referenced, so, while the item is alive,
+ * the transformation is not considered free by the other threads.
+ */
+struct FastPathCache {
+    FastPathCache(int _generation)
+        : generation(_generation)
+    {
+    }
+
+    ~FastPathCache() {
+        qDeleteAll(items);
+    }
+
+    QVector<FastPathCacheItem*> items;
+    int generation;
+};
+
+}
+
 struct KoColorConversionCache::Private {
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
-    QMutex cacheMutex;
+    struct Shard {
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
+        QMutex mutex;
+    };
+
+    Shard shards[numCacheShards];
+
+    /**
+     * Transformations dropped by colorSpaceIsDestroyed() while still
+     * referenced by the fast path caches of other threads. They are
+     * deleted as soon as nobody uses them anymore.
+     */
+    QList<CachedTransformation*> orphans;
+    QMutex orphansMutex;
+
+    /**
+     * Incremented every time a color space is destroyed, the fast path
+     * cache of a thread is dropped if it was filled with an older
+     * generation.
+     */
+    QAtomicInt generation;
+
+    QThreadStorage<FastPathCache*> fastStorage;
+
+    Shard& shardForKey(const KoColorConversionCacheKey &key) {
+        return shards[qHash(key) % numCacheShards];
+    }
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    /**
+     * Returns a transformation for \p key with its use counter already
+     * incremented, so that no other thread could pick it up as a free
+     * one before the caller wraps it into KoCachedColorConversionTransformation
+     */
+    CachedTransformation* acquireTransformation(const KoColorConversionCacheKey &key);
+    void purgeUnusedOrphans();
 };
 
+KoColorConversionCache::CachedTransformation* KoColorConversionCache::Private::acquireTransformation(const KoColorConversionCacheKey &key)
+{
+    Shard &shard = shardForKey(key);
+
+    QMutexLocker lock(&shard.mutex);
+
+    /**
+     * Prefer an instance no other thread is holding. If all of them
+     * are busy, create one more, until there is one per thread. The
+     * transformations are not cheap, so after that the least loaded
+     * instance is shared.
+     */
+    CachedTransformation *leastUsed = 0;
+    int numInstances = 0;
+
+    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = shard.cache.find(key);
+    for (; it != shard.cache.end() && it.key() == key; ++it) {
+        CachedTransformation *ct = it.value();
+
+        if (ct->isNotInUse() || ct->transfo->isReentrant()) {
+            leastUsed = ct;
+            break;
+        }
+
+        if (!leastUsed || ct->use.loadAcquire() < leastUsed->use.loadAcquire()) {
+            leastUsed = ct;
+        }
+        numInstances++;
+    }
+
+    if (leastUsed && (leastUsed->isNotInUse() ||
+                      leastUsed->transfo->isReentrant() ||
+                      numInstances >= QThread::idealThreadCount())) {
+        leastUsed->transfo->setSrcColorSpace(key.src);
+        leastUsed->transfo->setDstColorSpace(key.dst);
+        leastUsed->use.ref();
+        return leastUsed;
+    }
+
+    KoColorConversionTransformation* transfo = key.src->createColorConverter(key.dst, key.renderingIntent, key.conversionFlags);
+    CachedTransformation* ct = new CachedTransformation(transfo);
+    ct->use.ref();
+    shard.cache.insert(key, ct);
+    return ct;
+}
+
+void KoColorConversionCache::Private::purgeUnusedOrphans()
+{
+    QMutexLocker lock(&orphansMutex);
+
+    for (auto it = orphans.begin(); it != orphans.end();) {
+        if ((*it)->isNotInUse()) {
+            delete *it;
+            it = orphans.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 
 KoColorConversionCache::KoColorConversionCache() : d(new Private)
 {
@@ -77,9 +208,14 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
-    Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
+    d->fastStorage.setLocalData(0);
+
+    for (int i = 0; i < numCacheShards; i++) {
+        Q_FOREACH (CachedTransformation* transfo, d->shards[i].cache) {
+            delete transfo;
+        }
     }
+    qDeleteAll(d->orphans);
     delete d;
 }
 
@@ -90,54 +226,85 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    const int generation = d->generation.loadAcquire();
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
-        }
+    FastPathCache *fastCache = d->fastStorage.localData();
+
+    if (fastCache && fastCache->generation != generation) {
+        /**
+         * Some color space has been destroyed, the keys may contain
+         * dangling pointers now, so don't even compare them
+         */
+        d->fastStorage.setLocalData(0);
+        fastCache = 0;
     }
 
-    cacheItem = 0;
+    if (!fastCache) {
+        fastCache = new FastPathCache(generation);
+        d->fastStorage.setLocalData(fastCache);
+    }
 
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            ct->transfo->setSrcColorSpace(src);
-            ct->transfo->setDstColorSpace(dst);
+    QVector<FastPathCacheItem*> &items = fastCache->items;
 
-            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-            break;
+    for (int i = 0; i < items.size(); i++) {
+        if (items[i]->first == key) {
+            FastPathCacheItem *item = items[i];
+            if (i > 0) {
+                items.remove(i);
+                items.prepend(item);
+            }
+            return item->second;
         }
     }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
+
+    CachedTransformation *ct = d->acquireTransformation(key);
+    FastPathCacheItem *cacheItem =
+        new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
+    ct->use.deref();
+
+    if (items.size() >= numFastPathItems) {
+        // releasing the item returns its transformation to the pool
+        delete items.takeLast();
     }
+    items.prepend(cacheItem);
 
-    d->fastStorage.setLocalData(cacheItem);
     return cacheItem->second;
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
+    d->generation.ref();
     d->fastStorage.setLocalData(0);
 
-    QMutexLocker lock(&d->cacheMutex);
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
-    for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
-        if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->isNotInUse()); // That's terribly evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
-            it = d->cache.erase(it);
-        } else {
-            ++it;
+    QList<CachedTransformation*> stillInUse;
+
+    for (int i = 0; i < numCacheShards; i++) {
+        Private::Shard &shard = d->shards[i];
+
+        QMutexLocker lock(&shard.mutex);
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = shard.cache.end();
+        for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = shard.cache.begin(); it != endIt;) {
+            if (it.key().src == cs || it.key().dst == cs) {
+                if (it.value()->isNotInUse()) {
+                    delete it.value();
+                } else {
+                    // referenced by the fast path of some other thread,
+                    // which will drop it on the next lookup
+                    stillInUse.append(it.value());
+                }
+                it = shard.cache.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
+
+    if (!stillInUse.isEmpty()) {
+        QMutexLocker lock(&d->orphansMutex);
+        d->orphans.append(stillInUse);
+    }
+
+    d->purgeUnusedOrphans();
 }
 
 //--------- KoCachedColorConversionTransformation ----------//
@@ -122,6 +122,14 @@ public:
      */
     bool isValid() const override { return true; }
 
+    /**
+     * @return true if transform() can be called from several threads at
+     * the same time. KoColorConversionCache shares a single instance of
+     * such a transformation between all the threads instead of creating
+     * one per thread.
+     */
+    virtual bool isReentrant() const { return false; }
+
 private:
 
     void setSrcColorSpace(const KoColorSpace*) const;
@@ -0,0 +1,375 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLut3DColorConversionTransformation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QScopedPointer>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+#include <KoColorSpaceTraits.h>
+
+#include <kis_assert.h>
+
+namespace {
+
+template<typename channels_type>
+struct RgbTraitsForChannelType;
+
+template<>
+struct RgbTraitsForChannelType<quint8> {
+    using type = KoBgrU8Traits;
+};
+
+template<>
+struct RgbTraitsForChannelType<quint16> {
+    using type = KoBgrU16Traits;
+};
+
+#ifdef HAVE_OPENEXR
+template<>
+struct RgbTraitsForChannelType<half> {
+    using type = KoRgbF16Traits;
+};
+#endif
+
+template<>
+struct RgbTraitsForChannelType<float> {
+    using type = KoRgbF32Traits;
+};
+
+const float shaperGamma = 2.2f;
+const int shaperTableSize = 1024;
+
+struct Lattice
+{
+    Lattice(int _gridSize, bool isShaped)
+        : gridSize(_gridSize)
+        , nodes(3 * _gridSize * _gridSize * _gridSize)
+    {
+        if (isShaped) {
+            shaper.resize(shaperTableSize + 1);
+            for (int i = 0; i <= shaperTableSize; i++) {
+                shaper[i] = std::pow(float(i) / shaperTableSize, 1.0f / shaperGamma);
+            }
+        }
+    }
+
+    /**
+     * The value the source channel should have to land
+     * exactly at the lattice node \p index
+     */
+    float nodeValue(int index) const {
+        const float coordinate = float(index) / (gridSize - 1);
+        return shaper.empty() ? coordinate : std::pow(coordinate, shaperGamma);
+    }
+
+    /**
+     * The lattice and the shaper table cover exactly the [0, 1]
+     * range, the values outside of it never reach the lattice (see
+     * isInLatticeDomain()), the clamp only protects the lookups
+     */
+    float gridCoordinate(float value) const {
+        value = qBound(0.0f, value, 1.0f);
+
+        if (!shaper.empty()) {
+            const float pos = value * shaperTableSize;
+            const int index = std::min(static_cast<int>(pos), shaperTableSize - 1);
+            const float t = pos - index;
+            value = shaper[index] + t * (shaper[index + 1] - shaper[index]);
+        }
+
+        return value * (gridSize - 1);
+    }
+
+    float* node(int r, int g, int b) {
+        return &nodes[3 * ((r * gridSize + g) * gridSize + b)];
+    }
+
+    /**
+     * Tetrahedral interpolation: the lattice cube is split into six
+     * tetrahedrons along its main diagonal, and the color is a
+     * weighted sum of the four vertices of the tetrahedron the point
+     * falls into.
+     */
+    void interpolate(float r, float g, float b, float *result) const {
+        r = gridCoordinate(r);
+        g = gridCoordinate(g);
+        b = gridCoordinate(b);
+
+        const int ir = std::min(static_cast<int>(r), gridSize - 2);
+        const int ig = std::min(static_cast<int>(g), gridSize - 2);
+        const int ib = std::min(static_cast<int>(b), gridSize - 2);
+
+        const float rx = r - ir;
+        const float ry = g - ig;
+        const float rz = b - ib;
+
+        const int stepR = 3 * gridSize * gridSize;
+        const int stepG = 3 * gridSize;
+        const int stepB = 3;
+
+        const float *c000 = &nodes[3 * ((ir * gridSize + ig) * gridSize + ib)];
+        const float *c111 = c000 + stepR + stepG + stepB;
+
+        const float *c1;
+        const float *c2;
+        float w1, w2, w3;
+
+        if (rx >= ry) {
+            if (ry >= rz) {
+                c1 = c000 + stepR;
+                c2 = c000 + stepR + stepG;
+                w1 = rx; w2 = ry; w3 = rz;
+            } else if (rx >= rz) {
+                c1 = c000 + stepR;
+                c2 = c000 + stepR + stepB;
+                w1 = rx; w2 = rz; w3 = ry;
+            } else {
+                c1 = c000 + stepB;
+                c2 = c000 + stepR + stepB;
+                w1 = rz; w2 = rx; w3 = ry;
+            }
+        } else {
+            if (rz >= ry) {
+                c1 = c000 + stepB;
+                c2 = c000 + stepG + stepB;
+                w1 = rz; w2 = ry; w3 = rx;
+            } else if (rz >= rx) {
+                c1 = c000 + stepG;
+                c2 = c000 + stepG + stepB;
+                w1 = ry; w2 = rz; w3 = rx;
+            } else {
+                c1 = c000 + stepG;
+                c2 = c000 + stepR + stepG;
+                w1 = ry; w2 = rx; w3 = rz;
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            result[i] = c000[i] +
+                w1 * (c1[i] - c000[i]) +
+                w2 * (c2[i] - c1[i]) +
+                w3 * (c111[i] - c2[i]);
+        }
+    }
+
+    const int gridSize;
+    std::vector<float> nodes;
+    std::vector<float> shaper;
+};
+
+inline bool isInLatticeDomain(float value)
+{
+    // NaN fails both comparisons
+    return value >= 0.0f && value <= 1.0f;
+}
+
+class LutImplBase
+{
+public:
+    virtual ~LutImplBase() = default;
+    virtual void bake(const KoColorConversionTransformation *transformation, Lattice &lattice) const = 0;
+    virtual void apply(const Lattice &lattice, const KoColorConversionTransformation *exactTransformation,
+                       const quint8 *src, quint8 *dst, qint32 nPixels) const = 0;
+};
+
+template<typename src_channels_type, typename dst_channels_type>
+class LutImpl : public LutImplBase
+{
+    using SrcTraits = typename RgbTraitsForChannelType<src_channels_type>::type;
+    using DstTraits = typename RgbTraitsForChannelType<dst_channels_type>::type;
+
+public:
+    void bake(const KoColorConversionTransformation *transformation, Lattice &lattice) const override
+    {
+        const int gridSize = lattice.gridSize;
+        const int numNodes = gridSize * gridSize * gridSize;
+
+        std::vector<quint8> srcPixels(numNodes * SrcTraits::pixelSize);
+        std::vector<quint8> dstPixels(numNodes * DstTraits::pixelSize);
+
+        src_channels_type *srcPtr = reinterpret_cast<src_channels_type *>(srcPixels.data());
+
+        for (int r = 0; r < gridSize; r++) {
+            for (int g = 0; g < gridSize; g++) {
+                for (int b = 0; b < gridSize; b++) {
+                    srcPtr[SrcTraits::red_pos] = KoColorSpaceMaths<float, src_channels_type>::scaleToA(lattice.nodeValue(r));
+                    srcPtr[SrcTraits::green_pos] = KoColorSpaceMaths<float, src_channels_type>::scaleToA(lattice.nodeValue(g));
+                    srcPtr[SrcTraits::blue_pos] = KoColorSpaceMaths<float, src_channels_type>::scaleToA(lattice.nodeValue(b));
+                    srcPtr[SrcTraits::alpha_pos] = KoColorSpaceMathsTraits<src_channels_type>::unitValue;
+                    srcPtr += SrcTraits::channels_nb;
+                }
+            }
+        }
+
+        transformation->transform(srcPixels.data(), dstPixels.data(), numNodes);
+
+        const dst_channels_type *dstPtr = reinterpret_cast<const dst_channels_type *>(dstPixels.data());
+        float *node = lattice.nodes.data();
+
+        for (int i = 0; i < numNodes; i++) {
+            node[0] = KoColorSpaceMaths<dst_channels_type, float>::scaleToA(dstPtr[DstTraits::red_pos]);
+            node[1] = KoColorSpaceMaths<dst_channels_type, float>::scaleToA(dstPtr[DstTraits::green_pos]);
+            node[2] = KoColorSpaceMaths<dst_channels_type, float>::scaleToA(dstPtr[DstTraits::blue_pos]);
+
+            dstPtr += DstTraits::channels_nb;
+            node += 3;
+        }
+    }
+
+    void apply(const Lattice &lattice, const KoColorConversionTransformation *exactTransformation,
+               const quint8 *src, quint8 *dst, qint32 nPixels) const override
+    {
+        float result[3];
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            const src_channels_type *srcPixel = reinterpret_cast<const src_channels_type *>(src);
+            dst_channels_type *dstPixel = reinterpret_cast<dst_channels_type *>(dst);
+
+            const float r = KoColorSpaceMaths<src_channels_type, float>::scaleToA(srcPixel[SrcTraits::red_pos]);
+            const float g = KoColorSpaceMaths<src_channels_type, float>::scaleToA(srcPixel[SrcTraits::green_pos]);
+            const float b = KoColorSpaceMaths<src_channels_type, float>::scaleToA(srcPixel[SrcTraits::blue_pos]);
+
+            /**
+             * HDR (and negative) values are outside of the lattice,
+             * they are converted exactly instead of being clipped
+             */
+            if (!isInLatticeDomain(r) || !isInLatticeDomain(g) || !isInLatticeDomain(b)) {
+                exactTransformation->transform(src, dst, 1);
+
+                src += SrcTraits::pixelSize;
+                dst += DstTraits::pixelSize;
+                continue;
+            }
+
+            lattice.interpolate(r, g, b, result);
+
+            dstPixel[DstTraits::red_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(result[0]);
+            dstPixel[DstTraits::green_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(result[1]);
+            dstPixel[DstTraits::blue_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(result[2]);
+            dstPixel[DstTraits::alpha_pos] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(srcPixel[SrcTraits::alpha_pos]);
+
+            src += SrcTraits::pixelSize;
+            dst += DstTraits::pixelSize;
+        }
+    }
+};
+
+template<typename src_channels_type>
+struct CreateForSrcChannelType
+{
+    template<typename dst_channels_type>
+    struct CreateForDstChannelType
+    {
+        LutImplBase* operator()() {
+            return new LutImpl<src_channels_type, dst_channels_type>();
+        }
+    };
+
+    LutImplBase* operator()(const KoID &dstDepthId) {
+        return channelTypeForColorDepthId<CreateForDstChannelType>(dstDepthId);
+    }
+};
+
+/**
+ * LCMS precalculates the integer transformations itself, baking
+ * them would only lose precision
+ */
+bool isSupportedSourceColorSpace(const KoColorSpace *cs)
+{
+    if (cs->colorModelId() != RGBAColorModelID) return false;
+
+    const KoID depthId = cs->colorDepthId();
+
+    return
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+bool isSupportedColorSpace(const KoColorSpace *cs)
+{
+    if (cs->colorModelId() != RGBAColorModelID) return false;
+
+    const KoID depthId = cs->colorDepthId();
+
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+}
+
+struct KoLut3DColorConversionTransformation::Private
+{
+    Private(int gridSize, bool isShaped)
+        : lattice(gridSize, isShaped)
+    {
+    }
+
+    Lattice lattice;
+    QScopedPointer<LutImplBase> impl;
+    QScopedPointer<KoColorConversionTransformation> exactTransformation;
+};
+
+KoLut3DColorConversionTransformation::KoLut3DColorConversionTransformation(KoColorConversionTransformation *transformation,
+                                                                           int gridSize)
+    : KoColorConversionTransformation(transformation->srcColorSpace(),
+                                      transformation->dstColorSpace(),
+                                      transformation->renderingIntent(),
+                                      transformation->conversionFlags())
+    , d(new Private(qMax(2, gridSize),
+                    transformation->srcColorSpace()->profile() &&
+                    transformation->srcColorSpace()->profile()->isLinear()))
+{
+    KIS_ASSERT(canBake(transformation->srcColorSpace(), transformation->dstColorSpace()));
+
+    d->impl.reset(
+        channelTypeForColorDepthId<CreateForSrcChannelType>(srcColorSpace()->colorDepthId(),
+                                                            dstColorSpace()->colorDepthId()));
+
+    d->impl->bake(transformation, d->lattice);
+    d->exactTransformation.reset(transformation);
+}
+
+KoLut3DColorConversionTransformation::~KoLut3DColorConversionTransformation()
+{
+    delete d;
+}
+
+bool KoLut3DColorConversionTransformation::canBake(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace)
+{
+    return isSupportedSourceColorSpace(srcColorSpace) && isSupportedColorSpace(dstColorSpace);
+}
+
+KoColorConversionTransformation* KoLut3DColorConversionTransformation::tryBake(KoColorConversionTransformation *transformation,
+                                                                               int gridSize)
+{
+    if (!transformation ||
+        !canBake(transformation->srcColorSpace(), transformation->dstColorSpace())) {
+
+        return transformation;
+    }
+
+    return new KoLut3DColorConversionTransformation(transformation, gridSize);
+}
+
+void KoLut3DColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    d->impl->apply(d->lattice, d->exactTransformation.data(), src, dst, nPixels);
+}
@@ -0,0 +1,70 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+#define KOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+
+#include "KoColorConversionTransformation.h"
+
+#include "kritapigment_export.h"
+
+/**
+ * A color conversion transformation that samples another (usually very
+ * expensive) transformation on a regular RGB lattice once, and then
+ * converts the pixels with tetrahedral interpolation in this lattice.
+ *
+ * It is used for the chains LCMS cannot precalculate itself, e.g. a
+ * soft-proofing transformation from a floating point image into the
+ * display color space. Both color spaces must be RGBA ones, the source
+ * one must be floating point (LCMS already precalculates the integer
+ * ones), the alpha channel is copied as it is, LCMS-style.
+ *
+ * If the source color space is linear, the lattice is distributed
+ * perceptually (with a gamma 2.2 shaper), otherwise the dark colors
+ * would get only a couple of nodes. The lattice covers the [0, 1]
+ * range only, the pixels outside of it (HDR) are converted by the
+ * original transformation.
+ *
+ * The interpolation blends the colors of the neighbouring nodes, so
+ * the transformations with a sharp edge inside the cube (e.g. a gamut
+ * warning) should not be baked.
+ */
+class KRITAPIGMENT_EXPORT KoLut3DColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    static const int defaultGridSize = 33;
+
+    /**
+     * Bakes \p transformation into a lattice of \p gridSize
+     * nodes per channel. The object takes ownership of the
+     * transformation and uses it for the pixels outside of the
+     * lattice.
+     */
+    KoLut3DColorConversionTransformation(KoColorConversionTransformation *transformation,
+                                         int gridSize = defaultGridSize);
+    ~KoLut3DColorConversionTransformation() override;
+
+    /**
+     * @return true if the conversion between \p srcColorSpace and
+     *         \p dstColorSpace can be baked into a 3D LUT
+     */
+    static bool canBake(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace);
+
+    /**
+     * Wraps \p transformation into a baked LUT if possible. Otherwise
+     * returns \p transformation itself.
+     */
+    static KoColorConversionTransformation* tryBake(KoColorConversionTransformation *transformation,
+                                                    int gridSize = defaultGridSize);
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+private:
+    struct Private;
+    Private * const d;
+};
+
+#endif // KOLUT3DCOLORCONVERSIONTRANSFORMATION_H
@@ -0,0 +1,28 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoMixColorsOpFactory.h"
+
+#include <KoColorModelStandardIdsUtils.h>
+
+#include "KoMixColorsOpFactoryImpl.h"
+
+template <typename channels_type>
+struct CreateMixColorsOp
+{
+    KoMixColorsOp *operator() () {
+        return createOptimizedClass<KoMixColorsOpFactoryImpl<channels_type>>();
+    }
+};
+
+KoMixColorsOp *KoMixColorsOpFactory::createOptimized(KoID depthId, int numChannels, int alphaPos)
+{
+    if (numChannels != 4 || alphaPos != 3) {
+        return nullptr;
+    }
+
+    return channelTypeForColorDepthId<CreateMixColorsOp>(depthId);
+}
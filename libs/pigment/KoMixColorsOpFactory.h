@@ -0,0 +1,27 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOMIXCOLORSOPFACTORY_H
+#define KOMIXCOLORSOPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoMixColorsOp;
+
+class KRITAPIGMENT_EXPORT KoMixColorsOpFactory
+{
+public:
+    /**
+     * Creates a vectorized mixing op for the pixel layout if there is
+     * one, otherwise returns nullptr and the caller should fall back to
+     * the scalar KoMixColorsOpImpl.
+     */
+    static KoMixColorsOp* createOptimized(KoID depthId, int numChannels, int alphaPos);
+};
+
+#endif // KOMIXCOLORSOPFACTORY_H
@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoMixColorsOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedMixColorsOp.h"
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+template<typename _channels_type_>
+template<typename _impl>
+KoMixColorsOp *KoMixColorsOpFactoryImpl<_channels_type_>::create()
+{
+    return new KoOptimizedMixColorsOp<_channels_type_, _impl>();
+}
+
+template KoMixColorsOp *KoMixColorsOpFactoryImpl<quint8>::create<xsimd::current_arch>();
+template KoMixColorsOp *KoMixColorsOpFactoryImpl<quint16>::create<xsimd::current_arch>();
+#ifdef HAVE_OPENEXR
+template KoMixColorsOp *KoMixColorsOpFactoryImpl<half>::create<xsimd::current_arch>();
+#endif
+template KoMixColorsOp *KoMixColorsOpFactoryImpl<float>::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
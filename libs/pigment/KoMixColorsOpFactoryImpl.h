@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOMIXCOLORSOPFACTORYIMPL_H
+#define KOMIXCOLORSOPFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+
+class KoMixColorsOp;
+
+template<typename _channels_type_>
+class KRITAPIGMENT_EXPORT KoMixColorsOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoMixColorsOp *create();
+};
+
+#endif // KOMIXCOLORSOPFACTORYIMPL_H
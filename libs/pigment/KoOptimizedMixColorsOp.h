@@ -0,0 +1,476 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOP_H
+#define KOOPTIMIZEDMIXCOLORSOP_H
+
+#include "KoColorSpaceTraits.h"
+#include "KoMixColorsOpImpl.h"
+#include "KoMultiArchBuildSupport.h"
+
+/**
+ * Mixing op for 4-channel color spaces with alpha in the last channel
+ * (RGBA, LabA, XYZA, YCbCrA). The generic implementation is the usual
+ * scalar KoMixColorsOpImpl.
+ */
+template<typename _channels_type_,
+         typename _impl,
+         typename EnableDummyType = void>
+class KoOptimizedMixColorsOp : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, 4, 3>>
+{
+};
+
+#if !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include <algorithm>
+#include <limits>
+
+#include "KoStreamedMath.h"
+
+namespace KoOptimizedMixColorsOpDetail {
+
+/**
+ * How many pixels each lane of the accumulators may take
+ * before the sums stop being exact integers. The weights
+ * are qint16, so a single product is below unit^2 * 2^15.
+ */
+template<typename channels_type, int numLanes>
+constexpr qint64 maxPixelsPerLaneFlush()
+{
+    if constexpr (std::numeric_limits<channels_type>::is_integer) {
+        constexpr qint64 maxExactSum = qint64(1) << 53;
+        constexpr qint64 unitValue = std::numeric_limits<channels_type>::max();
+        return std::max(qint64(1), maxExactSum / (unitValue * unitValue * 32768 * numLanes));
+    } else {
+        return std::numeric_limits<int>::max();
+    }
+}
+
+}
+
+/**
+ * The vectorized version works in double precision for all the channel
+ * types. For the integer color spaces all the products and the partial
+ * sums are integers below 2^53, so they are exact and the result is
+ * bit-exact with the scalar version. For the floating point spaces the
+ * only difference is the order of the summation in the accumulators.
+ */
+template<typename _channels_type_, typename _impl>
+class KoOptimizedMixColorsOp<
+        _channels_type_, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoMixColorsOp
+{
+    using channels_type = _channels_type_;
+    using Traits = KoColorSpaceTrait<channels_type, 4, 3>;
+    using MathsTraits = KoColorSpaceMathsTraits<channels_type>;
+    using mix_type = typename MathsTraits::mixtype;
+    using double_v = xsimd::batch<double, _impl>;
+
+    static constexpr int numLanes = static_cast<int>(double_v::size);
+    static constexpr int alphaPos = Traits::alpha_pos;
+    static constexpr bool isInteger = std::numeric_limits<channels_type>::is_integer;
+
+public:
+    Mixer* createMixer() const override;
+
+    void mixColors(const quint8 * const* colors, const qint16 *weights, int nColors, quint8 *dst, int weightSum = 255) const override {
+        MixDataResult result;
+        result.accumulateColors(ArrayOfPointers(colors), WeightsWrapper(weights, weightSum), nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 *colors, const qint16 *weights, int nColors, quint8 *dst, int weightSum = 255) const override {
+        MixDataResult result;
+        result.accumulateColors(PointerToArray(colors), WeightsWrapper(weights, weightSum), nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 * const* colors, int nColors, quint8 *dst) const override {
+        MixDataResult result;
+        result.accumulateColors(ArrayOfPointers(colors), NoWeightsSurrogate(nColors), nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 *colors, int nColors, quint8 *dst) const override {
+        MixDataResult result;
+        result.accumulateColors(PointerToArray(colors), NoWeightsSurrogate(nColors), nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixTwoColorArrays(const quint8* colorsA, const quint8* colorsB, int nColors, qreal weight, quint8* dst) const override {
+        mixTwoArraysImpl(PointerToArray(colorsA), PointerToArray(colorsB), nColors, weight, dst);
+    }
+
+    void mixArrayWithColor(const quint8* colorArray, const quint8* color, int nColors, qreal weight, quint8* dst) const override {
+        mixTwoArraysImpl(PointerToArray(colorArray), SinglePixel(color), nColors, weight, dst);
+    }
+
+private:
+    class MixerImpl;
+
+    struct ArrayOfPointers {
+        ArrayOfPointers(const quint8 * const* colors)
+            : m_colors(colors)
+        {
+        }
+
+        const channels_type* getPixel() const {
+            return Traits::nativeArray(*m_colors);
+        }
+
+        void nextPixel() {
+            m_colors++;
+        }
+
+    private:
+        const quint8 * const * m_colors;
+    };
+
+    struct PointerToArray {
+        PointerToArray(const quint8 *colors)
+            : m_colors(colors)
+        {
+        }
+
+        const channels_type* getPixel() const {
+            return Traits::nativeArray(m_colors);
+        }
+
+        void nextPixel() {
+            m_colors += Traits::pixelSize;
+        }
+
+    private:
+        const quint8 *m_colors;
+    };
+
+    struct SinglePixel {
+        SinglePixel(const quint8 *color)
+            : m_color(color)
+        {
+        }
+
+        const channels_type* getPixel() const {
+            return Traits::nativeArray(m_color);
+        }
+
+        void nextPixel() {
+        }
+
+    private:
+        const quint8 *m_color;
+    };
+
+    struct WeightsWrapper
+    {
+        WeightsWrapper(const qint16 *weights, int weightSum)
+            : m_weights(weights), m_sumOfWeights(weightSum)
+        {
+        }
+
+        inline void nextPixel() {
+            m_weights++;
+        }
+
+        inline void premultiplyAlphaWithWeight(mix_type &alpha) const {
+            alpha *= *m_weights;
+        }
+
+        inline int normalizeFactor() const {
+            return m_sumOfWeights;
+        }
+
+    private:
+        const qint16 *m_weights;
+        int m_sumOfWeights {0};
+    };
+
+    struct NoWeightsSurrogate
+    {
+        NoWeightsSurrogate(int numPixels)
+            : m_numPixels(numPixels)
+        {
+        }
+
+        inline void nextPixel() {
+        }
+
+        inline void premultiplyAlphaWithWeight(mix_type &) const {
+        }
+
+        inline int normalizeFactor() const {
+            return m_numPixels;
+        }
+
+    private:
+        const int m_numPixels;
+    };
+
+    static inline channels_type clampedChannel(mix_type v) {
+        if (v > MathsTraits::max) {
+            v = MathsTraits::max;
+        }
+        if (v < MathsTraits::min) {
+            v = MathsTraits::min;
+        }
+        return v;
+    }
+
+    class MixDataResult {
+        mix_type totals[alphaPos] = {};
+        mix_type totalAlpha = 0;
+        qint64 normalizeFactor = 0;
+
+        static constexpr qint64 maxPixelsPerFlush =
+            KoOptimizedMixColorsOpDetail::maxPixelsPerLaneFlush<channels_type, numLanes>();
+
+    public:
+        void computeMixedColor(quint8 *dst) {
+            channels_type* dstColor = Traits::nativeArray(dst);
+
+            if (totalAlpha > 0) {
+                for (int i = 0; i < alphaPos; i++) {
+                    dstColor[i] = clampedChannel(safeDivideWithRound(totals[i], totalAlpha));
+                }
+                dstColor[alphaPos] = clampedChannel(safeDivideWithRound(totalAlpha, mix_type(normalizeFactor)));
+            } else {
+                memset(dst, 0, Traits::pixelSize);
+            }
+        }
+
+        template<class AbstractSource, class WeightsWrapper>
+        void accumulateColors(AbstractSource source, WeightsWrapper weightsWrapper, int nColors) {
+            alignas(64) double c0[numLanes];
+            alignas(64) double c1[numLanes];
+            alignas(64) double c2[numLanes];
+            alignas(64) double aw[numLanes];
+
+            double_v sum0(0.0);
+            double_v sum1(0.0);
+            double_v sum2(0.0);
+            double_v sumAlpha(0.0);
+
+            qint64 pixelsSinceFlush = 0;
+
+            while (nColors >= numLanes) {
+                for (int j = 0; j < numLanes; j++) {
+                    const channels_type* color = source.getPixel();
+
+                    mix_type alphaTimesWeight = color[alphaPos];
+                    weightsWrapper.premultiplyAlphaWithWeight(alphaTimesWeight);
+
+                    c0[j] = static_cast<double>(color[0]);
+                    c1[j] = static_cast<double>(color[1]);
+                    c2[j] = static_cast<double>(color[2]);
+                    aw[j] = static_cast<double>(alphaTimesWeight);
+
+                    source.nextPixel();
+                    weightsWrapper.nextPixel();
+                }
+
+                const double_v alphaTimesWeight = double_v::load_aligned(aw);
+
+                sum0 += double_v::load_aligned(c0) * alphaTimesWeight;
+                sum1 += double_v::load_aligned(c1) * alphaTimesWeight;
+                sum2 += double_v::load_aligned(c2) * alphaTimesWeight;
+                sumAlpha += alphaTimesWeight;
+
+                nColors -= numLanes;
+
+                if (++pixelsSinceFlush >= maxPixelsPerFlush) {
+                    flush(sum0, sum1, sum2, sumAlpha);
+                    pixelsSinceFlush = 0;
+                }
+            }
+
+            flush(sum0, sum1, sum2, sumAlpha);
+
+            while (nColors--) {
+                const channels_type* color = source.getPixel();
+
+                mix_type alphaTimesWeight = color[alphaPos];
+                weightsWrapper.premultiplyAlphaWithWeight(alphaTimesWeight);
+
+                for (int i = 0; i < alphaPos; i++) {
+                    totals[i] += color[i] * alphaTimesWeight;
+                }
+
+                totalAlpha += alphaTimesWeight;
+                source.nextPixel();
+                weightsWrapper.nextPixel();
+            }
+
+            normalizeFactor += weightsWrapper.normalizeFactor();
+        }
+
+        qint64 currentWeightsSum() const
+        {
+            return normalizeFactor;
+        }
+
+    private:
+        static inline mix_type reduceLanes(double_v &sum) {
+            alignas(64) double lanes[numLanes];
+            sum.store_aligned(lanes);
+            sum = double_v(0.0);
+
+            double result = 0.0;
+            for (int j = 0; j < numLanes; j++) {
+                result += lanes[j];
+            }
+            return static_cast<mix_type>(result);
+        }
+
+        inline void flush(double_v &sum0, double_v &sum1, double_v &sum2, double_v &sumAlpha) {
+            totals[0] += reduceLanes(sum0);
+            totals[1] += reduceLanes(sum1);
+            totals[2] += reduceLanes(sum2);
+            totalAlpha += reduceLanes(sumAlpha);
+        }
+    };
+
+    /**
+     * Every pixel is mixed independently here, so the vectors go
+     * along the pixels. All the values are integers well below 2^53
+     * for the integer spaces, so dividing them and taking the floor
+     * gives exactly the same result as the integer division of the
+     * scalar version.
+     */
+    template<class SourceA, class SourceB>
+    void mixTwoArraysImpl(SourceA sourceA, SourceB sourceB, int nColors, qreal weight, quint8* dst) const {
+        weight = qBound(0.0, weight, 1.0);
+
+        const qint16 weightB = qRound(weight * 255.0);
+        const qint16 weightA = 255 - weightB;
+
+        alignas(64) double colorA[alphaPos][numLanes];
+        alignas(64) double colorB[alphaPos][numLanes];
+        alignas(64) double awA[numLanes];
+        alignas(64) double awB[numLanes];
+        alignas(64) double result[alphaPos + 1][numLanes];
+
+        const double_v zero(0.0);
+
+        const int block1 = nColors / numLanes;
+        const int block2 = nColors % numLanes;
+
+        for (int i = 0; i < block1; i++) {
+            for (int j = 0; j < numLanes; j++) {
+                const channels_type* pixelA = sourceA.getPixel();
+                const channels_type* pixelB = sourceB.getPixel();
+
+                for (int ch = 0; ch < alphaPos; ch++) {
+                    colorA[ch][j] = static_cast<double>(pixelA[ch]);
+                    colorB[ch][j] = static_cast<double>(pixelB[ch]);
+                }
+                awA[j] = static_cast<double>(mix_type(pixelA[alphaPos]) * weightA);
+                awB[j] = static_cast<double>(mix_type(pixelB[alphaPos]) * weightB);
+
+                sourceA.nextPixel();
+                sourceB.nextPixel();
+            }
+
+            const double_v alphaA = double_v::load_aligned(awA);
+            const double_v alphaB = double_v::load_aligned(awB);
+            const double_v totalAlpha = alphaA + alphaB;
+            const auto hasAlpha = totalAlpha > zero;
+
+            // avoid division by zero for fully transparent pixels
+            const double_v divisor = xsimd::select(hasAlpha, totalAlpha, double_v(1.0));
+
+            for (int ch = 0; ch < alphaPos; ch++) {
+                double_v value = double_v::load_aligned(colorA[ch]) * alphaA +
+                    double_v::load_aligned(colorB[ch]) * alphaB;
+
+                value = roundedDivision(value, divisor);
+                xsimd::select(hasAlpha, value, zero).store_aligned(result[ch]);
+            }
+
+            xsimd::select(hasAlpha, roundedDivision(totalAlpha, double_v(255.0)), zero)
+                .store_aligned(result[alphaPos]);
+
+            for (int j = 0; j < numLanes; j++) {
+                channels_type* dstColor = Traits::nativeArray(dst);
+
+                for (int ch = 0; ch <= alphaPos; ch++) {
+                    dstColor[ch] = clampedChannel(static_cast<mix_type>(result[ch][j]));
+                }
+
+                dst += Traits::pixelSize;
+            }
+        }
+
+        for (int i = 0; i < block2; i++) {
+            MixDataResult result;
+
+            const quint8* colors[2];
+            colors[0] = reinterpret_cast<const quint8*>(sourceA.getPixel());
+            colors[1] = reinterpret_cast<const quint8*>(sourceB.getPixel());
+            const qint16 weights[2] = {weightA, weightB};
+
+            result.accumulateColors(ArrayOfPointers(colors), WeightsWrapper(weights, 255), 2);
+            result.computeMixedColor(dst);
+
+            sourceA.nextPixel();
+            sourceB.nextPixel();
+            dst += Traits::pixelSize;
+        }
+    }
+
+    static inline double_v roundedDivision(const double_v &dividend, const double_v &divisor) {
+        if constexpr (isInteger) {
+            // the same as (dividend + divisor / 2) / divisor in integers
+            return xsimd::floor((dividend + xsimd::floor(divisor * 0.5)) / divisor);
+        } else {
+            return dividend / divisor;
+        }
+    }
+};
+
+template<typename _channels_type_, typename _impl>
+class KoOptimizedMixColorsOp<
+        _channels_type_, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>::MixerImpl
+    : public KoMixColorsOp::Mixer
+{
+public:
+    void accumulate(const quint8 *data, const qint16 *weights, int weightSum, int nPixels) override
+    {
+        result.accumulateColors(PointerToArray(data), WeightsWrapper(weights, weightSum), nPixels);
+    }
+
+    void accumulateAverage(const quint8 *data, int nPixels) override
+    {
+        result.accumulateColors(PointerToArray(data), NoWeightsSurrogate(nPixels), nPixels);
+    }
+
+    void computeMixedColor(quint8 *data) override
+    {
+        result.computeMixedColor(data);
+    }
+
+    qint64 currentWeightsSum() const override
+    {
+        return result.currentWeightsSum();
+    }
+
+private:
+    MixDataResult result;
+};
+
+template<typename _channels_type_, typename _impl>
+KoMixColorsOp::Mixer *
+KoOptimizedMixColorsOp<
+    _channels_type_, _impl,
+    typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>::createMixer() const
+{
+    return new MixerImpl();
+}
+
+#endif /* !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+#endif // KOOPTIMIZEDMIXCOLORSOP_H
@@ -27,6 +27,17 @@ public:
     {
         const int numColorChannels = m_channelsPerPixel * numColumns;
 
+#if XSIMD_WITH_AVX512BW
+        using uint16_avx512_v = xsimd::batch<uint16_t, xsimd::avx512bw>;
+
+        const int channelsPerAvx512Block = 32;
+        const int avx512Block = numColorChannels / channelsPerAvx512Block;
+        const int avx512Rest = numColorChannels % channelsPerAvx512Block;
+#else
+        const int avx512Block = 0;
+        const int avx512Rest = numColorChannels;
+#endif
+
 #if XSIMD_WITH_AVX2
         using uint16_avx_v = xsimd::batch<uint16_t, xsimd::avx2>;
         using uint16_v = xsimd::batch<uint16_t, xsimd::sse4_1>;
@@ -34,8 +45,8 @@ public:
 
         const int channelsPerAvx2Block = 16;
         const int channelsPerSse2Block = 8;
-        const int avx2Block = numColorChannels / channelsPerAvx2Block;
-        const int rest = numColorChannels % channelsPerAvx2Block;
+        const int avx2Block = avx512Rest / channelsPerAvx2Block;
+        const int rest = avx512Rest % channelsPerAvx2Block;
         const int sse2Block = rest / channelsPerSse2Block;
         const int scalarBlock = rest % channelsPerSse2Block;
 #elif (XSIMD_WITH_SSE4_1 || XSIMD_WITH_NEON || XSIMD_WITH_NEON64)
@@ -52,12 +63,12 @@ public:
 
         const int channelsPerSse2Block = 8;
         const int avx2Block = 0;
-        const int sse2Block = numColorChannels / channelsPerSse2Block;
-        const int scalarBlock = numColorChannels % channelsPerSse2Block;
+        const int sse2Block = avx512Rest / channelsPerSse2Block;
+        const int scalarBlock = avx512Rest % channelsPerSse2Block;
 #else
         const int avx2Block = 0;
         const int sse2Block = 0;
-        const int scalarBlock = numColorChannels;
+        const int scalarBlock = avx512Rest;
 #endif
 
         // qWarning() << ppVar(avx2Block) << ppVar(sse2Block);
@@ -66,6 +77,24 @@ public:
             const quint8 *srcPtr = src;
             auto *dstPtr = reinterpret_cast<quint16 *>(dst);
 
+#if XSIMD_WITH_AVX512BW
+            for (int i = 0; i < avx512Block; i++) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(srcPtr));
+
+                uint16_avx512_v y(_mm512_cvtepu8_epi16(x));
+                const auto y_shifted = y << 8;
+                y |= y_shifted;
+
+                y.store_unaligned(
+                    reinterpret_cast<typename uint16_avx512_v::value_type *>(dstPtr));
+
+                srcPtr += channelsPerAvx512Block;
+                dstPtr += channelsPerAvx512Block;
+            }
+#else
+            Q_UNUSED(avx512Block);
+#endif
+
 #if XSIMD_WITH_AVX2
             for (int i = 0; i < avx2Block; i++) {
                 const auto x = uint8_v::load_unaligned(srcPtr);
@@ -128,14 +157,29 @@ public:
     {
         const int numColorChannels = m_channelsPerPixel * numColumns;
 
+#if XSIMD_WITH_AVX512BW
+        using uint16_avx512_v = xsimd::batch<uint16_t, xsimd::avx512bw>;
+
+        const int channelsPerAvx512Block = 64;
+        const int avx512Block = numColorChannels / channelsPerAvx512Block;
+        const int avx512Rest = numColorChannels % channelsPerAvx512Block;
+
+        const auto offset512 = uint16_avx512_v(128);
+        // packus works within 128-bit lanes, this index restores the order of the qwords
+        const __m512i packPermutation = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+#else
+        const int avx512Block = 0;
+        const int avx512Rest = numColorChannels;
+#endif
+
 #if XSIMD_WITH_AVX2
         using uint16_avx_v = xsimd::batch<uint16_t, xsimd::avx2>;
         using uint16_v = xsimd::batch<uint16_t, xsimd::sse4_1>;
 
         const int channelsPerAvx2Block = 32;
         const int channelsPerSse2Block = 16;
-        const int avx2Block = numColorChannels / channelsPerAvx2Block;
-        const int rest = numColorChannels % channelsPerAvx2Block;
+        const int avx2Block = avx512Rest / channelsPerAvx2Block;
+        const int rest = avx512Rest % channelsPerAvx2Block;
         const int sse2Block = rest / channelsPerSse2Block;
         const int scalarBlock = rest % channelsPerSse2Block;
 
@@ -155,14 +199,14 @@ public:
 
         const int channelsPerSse2Block = 16;
         const int avx2Block = 0;
-        const int sse2Block = numColorChannels / channelsPerSse2Block;
-        const int scalarBlock = numColorChannels % channelsPerSse2Block;
+        const int sse2Block = avx512Rest / channelsPerSse2Block;
+        const int scalarBlock = avx512Rest % channelsPerSse2Block;
 
         const auto offset2 = uint16_v(128);
 #else
         const int avx2Block = 0;
         const int sse2Block = 0;
-        const int scalarBlock = numColorChannels;
+        const int scalarBlock = avx512Rest;
 #endif
 
         // qWarning() << ppVar(avx2Block) << ppVar(sse2Block);
@@ -171,6 +215,34 @@ public:
             const quint16 *srcPtr = reinterpret_cast<const quint16 *>(src);
             quint8 *dstPtr = dst;
 
+#if XSIMD_WITH_AVX512BW
+            for (int i = 0; i < avx512Block; i++) {
+                auto x1 = uint16_avx512_v::load_unaligned(srcPtr);
+                auto x2 = uint16_avx512_v::load_unaligned(srcPtr + uint16_avx512_v::size);
+
+                const auto x1_shifted = x1 >> 8;
+                const auto x2_shifted = x2 >> 8;
+
+                x1 -= x1_shifted;
+                x1 += offset512;
+                x1 >>= 8;
+
+                x2 -= x2_shifted;
+                x2 += offset512;
+                x2 >>= 8;
+
+                x1.data = _mm512_packus_epi16(x1, x2);
+                x1.data = _mm512_permutexvar_epi64(packPermutation, x1);
+
+                x1.store_unaligned(reinterpret_cast<typename uint16_avx512_v::value_type *>(dstPtr));
+
+                srcPtr += channelsPerAvx512Block;
+                dstPtr += channelsPerAvx512Block;
+            }
+#else
+        Q_UNUSED(avx512Block);
+#endif
+
 #if XSIMD_WITH_AVX2
             for (int i = 0; i < avx2Block; i++) {
                 auto x1 = uint16_avx_v::load_unaligned(srcPtr);
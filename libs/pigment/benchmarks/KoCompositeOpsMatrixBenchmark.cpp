@@ -0,0 +1,195 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoCompositeOpsMatrixBenchmark.h"
+
+#include <QBitArray>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+
+#include <simpletest.h>
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOp.h>
+#include <KoMultiArchBuildSupport.h>
+
+namespace {
+
+const int TILE_SIZE = 64;
+const int TILES_IN_WIDTH = 4;
+const int TILES_IN_HEIGHT = 4;
+
+const int IMG_WIDTH = TILE_SIZE * TILES_IN_WIDTH;
+const int IMG_HEIGHT = TILE_SIZE * TILES_IN_HEIGHT;
+
+enum Variant {
+    Opaque,
+    HalfOpacity,
+    Mask,
+    MaskAndFlow,
+    ChannelFlags
+};
+
+struct VariantInfo {
+    Variant variant;
+    const char *name;
+};
+
+const VariantInfo variants[] = {
+    {Opaque, "opaque"},
+    {HalfOpacity, "opacity"},
+    {Mask, "mask"},
+    {MaskAndFlow, "mask-flow"},
+    {ChannelFlags, "channel-flags"}
+};
+
+struct ArchNameFactory {
+    template<typename _impl>
+    static QString create()
+    {
+        return QString::fromLatin1(_impl::name());
+    }
+};
+
+/**
+ * Random pixels with normalized channel values, so that the float
+ * color spaces don't get NaNs and denormals from random bytes
+ */
+void fillRandomPixels(const KoColorSpace *cs, quint8 *data, int numPixels, QRandomGenerator &rng)
+{
+    QVector<float> channels(cs->channelCount());
+
+    for (int i = 0; i < numPixels; i++) {
+        for (float &value : channels) {
+            value = float(rng.generateDouble());
+        }
+        cs->fromNormalisedChannelsValue(data + i * cs->pixelSize(), channels);
+    }
+}
+
+QBitArray channelFlagsWithoutFirstColorChannel(const KoColorSpace *cs)
+{
+    QBitArray flags(cs->channelCount(), true);
+
+    const QList<KoChannelInfo *> channels = cs->channels();
+    for (int i = 0; i < channels.size(); i++) {
+        if (channels[i]->channelType() == KoChannelInfo::COLOR) {
+            flags.clearBit(i);
+            break;
+        }
+    }
+
+    return flags;
+}
+
+} // namespace
+
+void KoCompositeOpsMatrixBenchmark::initTestCase()
+{
+    qInfo() << "Composite ops are built for:" << createOptimizedClass<ArchNameFactory>();
+}
+
+void KoCompositeOpsMatrixBenchmark::benchmarkCompositeOp_data()
+{
+    QTest::addColumn<QString>("modelId");
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<QString>("compositeOpId");
+    QTest::addColumn<int>("variant");
+
+    const QString filterString = qEnvironmentVariable("KRITA_COMPOSITE_BENCHMARK_FILTER");
+    const QRegularExpression filter(filterString);
+
+    const QList<const KoColorSpace *> colorSpaces =
+        KoColorSpaceRegistry::instance()->allColorSpaces(KoColorSpaceRegistry::AllColorSpaces,
+                                                         KoColorSpaceRegistry::OnlyDefaultProfile);
+
+    for (const KoColorSpace *cs : colorSpaces) {
+        const QList<KoCompositeOp *> ops = cs->compositeOps();
+
+        for (const KoCompositeOp *op : ops) {
+            for (const VariantInfo &info : variants) {
+                const QString rowName = QString("%1/%2/%3").arg(cs->id(), op->id(), info.name);
+
+                if (!filterString.isEmpty() && !filter.match(rowName).hasMatch()) {
+                    continue;
+                }
+
+                QTest::newRow(rowName.toLatin1().data())
+                    << cs->colorModelId().id()
+                    << cs->colorDepthId().id()
+                    << op->id()
+                    << int(info.variant);
+            }
+        }
+    }
+}
+
+void KoCompositeOpsMatrixBenchmark::benchmarkCompositeOp()
+{
+    QFETCH(QString, modelId);
+    QFETCH(QString, depthId);
+    QFETCH(QString, compositeOpId);
+    QFETCH(int, variant);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(modelId, depthId);
+    QVERIFY(cs);
+
+    const KoCompositeOp *op = cs->compositeOp(compositeOpId);
+    QVERIFY(op);
+
+    const int pixelSize = cs->pixelSize();
+    const int numPixels = IMG_WIDTH * IMG_HEIGHT;
+    const int rowStride = IMG_WIDTH * pixelSize;
+
+    QVector<quint8> srcBuffer(numPixels * pixelSize);
+    QVector<quint8> dstBuffer(numPixels * pixelSize);
+    QVector<quint8> maskBuffer(numPixels);
+
+    QRandomGenerator rng(42);
+    fillRandomPixels(cs, srcBuffer.data(), numPixels, rng);
+    fillRandomPixels(cs, dstBuffer.data(), numPixels, rng);
+    for (quint8 &value : maskBuffer) {
+        value = quint8(rng.bounded(256));
+    }
+
+    const bool useMask = variant == Mask || variant == MaskAndFlow;
+    const QBitArray channelFlags =
+        variant == ChannelFlags ? channelFlagsWithoutFirstColorChannel(cs) : QBitArray();
+
+    QBENCHMARK {
+        for (int y = 0; y < TILES_IN_HEIGHT; y++) {
+            for (int x = 0; x < TILES_IN_WIDTH; x++) {
+                const int bufOffset = y * TILE_SIZE * rowStride + x * TILE_SIZE * pixelSize;
+                const int maskOffset = y * TILE_SIZE * IMG_WIDTH + x * TILE_SIZE;
+
+                KoCompositeOp::ParameterInfo params;
+                params.dstRowStart = dstBuffer.data() + bufOffset;
+                params.dstRowStride = rowStride;
+                params.srcRowStart = srcBuffer.constData() + bufOffset;
+                params.srcRowStride = rowStride;
+                params.maskRowStart = useMask ? maskBuffer.constData() + maskOffset : nullptr;
+                params.maskRowStride = useMask ? IMG_WIDTH : 0;
+                params.rows = TILE_SIZE;
+                params.cols = TILE_SIZE;
+                params.channelFlags = channelFlags;
+
+                if (variant == HalfOpacity || variant == MaskAndFlow) {
+                    params.setOpacityAndAverage(0.5f, 0.7f);
+                }
+
+                if (variant == MaskAndFlow) {
+                    params.flow = 0.3f;
+                }
+
+                op->composite(params);
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KoCompositeOpsMatrixBenchmark)
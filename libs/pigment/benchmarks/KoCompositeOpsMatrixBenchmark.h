@@ -0,0 +1,34 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KO_COMPOSITEOPS_MATRIX_BENCHMARK_H_
+#define KO_COMPOSITEOPS_MATRIX_BENCHMARK_H_
+
+#include <QObject>
+
+/**
+ * Benchmarks every composite op of every color space registered in
+ * the system. Each row is named "<colorspace>/<op>/<variant>", so the
+ * results can be exported with QtTest's machine-readable loggers and
+ * compared per op between builds and architectures:
+ *
+ *   KoCompositeOpsMatrixBenchmark -o results.csv,csv
+ *   KoCompositeOpsMatrixBenchmark -o results.xml,xml
+ *
+ * Set KRITA_COMPOSITE_BENCHMARK_FILTER to a regular expression to
+ * measure only the matching rows.
+ */
+class KoCompositeOpsMatrixBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkCompositeOp_data();
+    void benchmarkCompositeOp();
+};
+
+#endif
@@ -57,6 +57,14 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return new KoCompositeOpCopy2<Traits>(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
 };
 
 template<>
@@ -74,6 +82,14 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp32(genericOp);
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOp32(genericOp);
+    }
 };
 
 template<>
@@ -90,6 +106,14 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
 };
 
 template<>
@@ -107,8 +131,43 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp128(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp128(genericOp);
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOp128(genericOp);
+    }
 };
 
+#ifdef HAVE_OPENEXR
+template<>
+struct OptimizedOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createAlphaDarkenOp(const KoColorSpace *cs) {
+        return useCreamyAlphaDarken() ?
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs) :
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(cs);
+
+    }
+    static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return genericOp;
+    }
+};
+#endif
+
 template<>
 struct OptimizedOpsSelector<KoBgrU16Traits>
 {
@@ -124,6 +183,14 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOpU64(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOpU64(genericOp);
+    }
+
+    static KoCompositeOp* createGenericHSLOp(KoCompositeOp *genericOp) {
+        return KoOptimizedCompositeOpFactory::createGenericHSLOpU64(genericOp);
+    }
 };
 
 
@@ -144,7 +211,8 @@ struct AddGeneralOps<Traits, true>
                 cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
             }
         } else {
-            cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+            cs->addCompositeOp(OptimizedOpsSelector<Traits>::createGenericSCOp(
+                new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category)));
         }
      }
 
@@ -157,7 +225,8 @@ struct AddGeneralOps<Traits, true>
                  cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
              }
          } else {
-             cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+             cs->addCompositeOp(OptimizedOpsSelector<Traits>::createGenericSCOp(
+                 new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category)));
          }
      }
 
@@ -321,7 +390,8 @@ struct AddRGBOps<Traits, true>
 
     template<typename Functor>
     static void add(KoColorSpace* cs, const QString& id, const QString& category) {
-        cs->addCompositeOp(new KoCompositeOpGenericHSLFunctor<Traits, Functor>(cs, id, category));
+        cs->addCompositeOp(OptimizedOpsSelector<Traits>::createGenericHSLOp(
+            new KoCompositeOpGenericHSLFunctor<Traits, Functor>(cs, id, category)));
     }
 
     static void add(KoColorSpace* cs) {
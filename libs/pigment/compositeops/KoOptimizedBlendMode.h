@@ -0,0 +1,101 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDBLENDMODE_H
+#define KOOPTIMIZEDBLENDMODE_H
+
+#include <QString>
+
+#include "KoCompositeOpRegistry.h"
+
+/**
+ * The blend functions that have a vectorized implementation in
+ * KoOptimizedCompositeOpGenericSC.h (separable ones) and
+ * KoOptimizedCompositeOpGenericHSL.h (non-separable ones). The lists are
+ * kept separately from the implementation, so that they could be checked
+ * without including any architecture-specific code.
+ */
+namespace KoOptimizedBlendMode
+{
+enum Mode {
+    Unsupported = 0,
+    Multiply,
+    Screen,
+    Darken,
+    Lighten,
+    Difference,
+    Addition,
+    Subtract,
+    HardLight,
+    Overlay,
+    SoftLight,
+    ColorDodge
+};
+
+inline Mode fromCompositeOpId(const QString &id)
+{
+    if (id == COMPOSITE_MULT) return Multiply;
+    if (id == COMPOSITE_SCREEN) return Screen;
+    if (id == COMPOSITE_DARKEN) return Darken;
+    if (id == COMPOSITE_LIGHTEN) return Lighten;
+    if (id == COMPOSITE_DIFF) return Difference;
+    if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) return Addition;
+    if (id == COMPOSITE_SUBTRACT) return Subtract;
+    if (id == COMPOSITE_HARD_LIGHT) return HardLight;
+    if (id == COMPOSITE_OVERLAY) return Overlay;
+    if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) return SoftLight;
+    if (id == COMPOSITE_DODGE) return ColorDodge;
+
+    return Unsupported;
+}
+
+enum HSLMode {
+    UnsupportedHSL = 0,
+    ColorHSY,
+    HueHSY,
+    SaturationHSY,
+    LightnessHSY,
+    ColorHSI,
+    HueHSI,
+    SaturationHSI,
+    LightnessHSI,
+    ColorHSL,
+    HueHSL,
+    SaturationHSL,
+    LightnessHSL,
+    ColorHSV,
+    HueHSV,
+    SaturationHSV,
+    LightnessHSV
+};
+
+inline HSLMode hslModeFromCompositeOpId(const QString &id)
+{
+    if (id == COMPOSITE_COLOR) return ColorHSY;
+    if (id == COMPOSITE_HUE) return HueHSY;
+    if (id == COMPOSITE_SATURATION) return SaturationHSY;
+    if (id == COMPOSITE_LUMINIZE) return LightnessHSY;
+
+    if (id == COMPOSITE_COLOR_HSI) return ColorHSI;
+    if (id == COMPOSITE_HUE_HSI) return HueHSI;
+    if (id == COMPOSITE_SATURATION_HSI) return SaturationHSI;
+    if (id == COMPOSITE_INTENSITY) return LightnessHSI;
+
+    if (id == COMPOSITE_COLOR_HSL) return ColorHSL;
+    if (id == COMPOSITE_HUE_HSL) return HueHSL;
+    if (id == COMPOSITE_SATURATION_HSL) return SaturationHSL;
+    if (id == COMPOSITE_LIGHTNESS) return LightnessHSL;
+
+    if (id == COMPOSITE_COLOR_HSV) return ColorHSV;
+    if (id == COMPOSITE_HUE_HSV) return HueHSV;
+    if (id == COMPOSITE_SATURATION_HSV) return SaturationHSV;
+    if (id == COMPOSITE_VALUE) return LightnessHSV;
+
+    return UnsupportedHSL;
+}
+} // namespace KoOptimizedBlendMode
+
+#endif // KOOPTIMIZEDBLENDMODE_H
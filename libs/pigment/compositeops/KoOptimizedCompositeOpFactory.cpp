@@ -6,6 +6,7 @@
 
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpFactory.h"
+#include "KoOptimizedBlendMode.h"
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
@@ -78,3 +79,91 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+#ifdef HAVE_OPENEXR
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOpF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16> >(cs);
+}
+#endif
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp32(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::fromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::Unsupported) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericSC32>>(genericOp);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOpU64(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::fromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::Unsupported) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericSCU64>>(genericOp);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp128(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::fromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::Unsupported) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericSC128>>(genericOp);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOp32(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::hslModeFromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::UnsupportedHSL) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericHSL32>>(genericOp);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOpU64(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::hslModeFromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::UnsupportedHSL) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericHSLU64>>(genericOp);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericHSLOp128(KoCompositeOp *genericOp)
+{
+    if (KoOptimizedBlendMode::hslModeFromCompositeOpId(genericOp->id()) == KoOptimizedBlendMode::UnsupportedHSL) {
+        return genericOp;
+    }
+
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArchWithFallback<
+            KoOptimizedCompositeOpGenericHSL128>>(genericOp);
+}
@@ -9,6 +9,8 @@
 
 #include "kritapigment_export.h"
 
+#include <KoConfig.h>
+
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -39,6 +41,32 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+#ifdef HAVE_OPENEXR
+    static KoCompositeOp* createAlphaDarkenOpHardF16(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamyF16(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createCopyOpF16(const KoColorSpace *cs);
+#endif
+
+    /**
+     * Wrap a separable KoCompositeOpGenericSC op of an RGBA color space
+     * into its vectorized version. The ownership of \p genericOp is
+     * passed to the returned op. If the blend function of the op has no
+     * vectorized version, \p genericOp itself is returned.
+     */
+    static KoCompositeOp* createGenericSCOp32(KoCompositeOp *genericOp);
+    static KoCompositeOp* createGenericSCOpU64(KoCompositeOp *genericOp);
+    static KoCompositeOp* createGenericSCOp128(KoCompositeOp *genericOp);
+
+    /**
+     * Same as createGenericSCOp32() and friends, but for the non-separable
+     * KoCompositeOpGenericHSLFunctor ops (Color, Hue, Saturation and
+     * Lightness families)
+     */
+    static KoCompositeOp* createGenericHSLOp32(KoCompositeOp *genericOp);
+    static KoCompositeOp* createGenericHSLOpU64(KoCompositeOp *genericOp);
+    static KoCompositeOp* createGenericHSLOp128(KoCompositeOp *genericOp);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -13,6 +13,8 @@
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
 #include "KoOptimizedCompositeOpCopy128.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
+#include "KoOptimizedCompositeOpGenericHSL.h"
 
 #include <KoCompositeOpRegistry.h>
 
@@ -124,4 +126,96 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoOptimizedCompositeOpAlphaDarkenCreamyU64<xsimd::current_arch>(param);
 }
 
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpAlphaDarkenHardF16<xsimd::current_arch>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpAlphaDarkenCreamyF16<xsimd::current_arch>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpOverF16<xsimd::current_arch>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpCopyF16<xsimd::current_arch>(param);
+}
+#endif
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSC32>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericSC32<xsimd::current_arch>(genericOp);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSCU64>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericSCU64<xsimd::current_arch>(genericOp);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSC128>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericSC128<xsimd::current_arch>(genericOp);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSL32>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericHSL32<xsimd::current_arch>(genericOp);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSLU64>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericHSLU64<xsimd::current_arch>(genericOp);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSL128>::create<
+    xsimd::current_arch>(KoCompositeOp *genericOp)
+{
+    return new KoOptimizedCompositeOpGenericHSL128<xsimd::current_arch>(genericOp);
+}
+
 #endif // XSIMD_UNIVERSAL_BUILD_PASS
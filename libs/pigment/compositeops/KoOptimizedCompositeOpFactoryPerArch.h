@@ -49,10 +49,52 @@ class KoOptimizedCompositeOpCopyU64;
 template<typename _impl>
 class KoOptimizedCompositeOpCopy32;
 
+template<typename _impl>
+class KoOptimizedCompositeOpAlphaDarkenHardF16;
+
+template<typename _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamyF16;
+
+template<typename _impl>
+class KoOptimizedCompositeOpOverF16;
+
+template<typename _impl>
+class KoOptimizedCompositeOpCopyF16;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSC32;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSCU64;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSC128;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSL32;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSLU64;
+
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSL128;
+
 template<template<typename I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch {
     template<typename _impl>
     static KoCompositeOp *create(const KoColorSpace *);
 };
 
+/**
+ * Creates an optimized version of a generic composite op. The generic
+ * op is owned by the optimized one and is used for the cases that are
+ * not optimized. If there is no optimized version for the architecture,
+ * \p genericOp is returned as it is.
+ */
+template<template<typename I> class CompositeOp>
+struct KoOptimizedCompositeOpFactoryPerArchWithFallback {
+    template<typename _impl>
+    static KoCompositeOp *create(KoCompositeOp *genericOp);
+};
+
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
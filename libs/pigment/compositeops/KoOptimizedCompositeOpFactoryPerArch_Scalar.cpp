@@ -121,3 +121,100 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpOver<KoRgbF16Traits>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpCopy2<KoRgbF16Traits>(param);
+}
+#endif
+
+/**
+ * There is no point in the separable and HSL ops running through
+ * KoStreamedMath without vector instructions, the generic
+ * ops are used instead
+ */
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSC32>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSCU64>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericSC128>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSL32>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSLU64>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArchWithFallback<KoOptimizedCompositeOpGenericHSL128>::create<
+    xsimd::generic>(KoCompositeOp *genericOp)
+{
+    return genericOp;
+}
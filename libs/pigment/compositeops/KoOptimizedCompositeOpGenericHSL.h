@@ -0,0 +1,613 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
+
+#include <limits>
+
+#include <QScopedPointer>
+
+#include <kis_assert.h>
+
+#include "KoOptimizedBlendMode.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
+
+/**
+ * Vectorized versions of the Color, Hue, Saturation and Lightness
+ * families of KoCompositeOpFunctions.h. The per-pixel branches of
+ * HSYType/HSIType/HSLType/HSVType, setSaturation() and ToneMapping()
+ * of KoColorSpaceMaths.h are replaced with selects, so the same code
+ * is used for both plain floats (head and tail of the row) and xsimd
+ * batches.
+ *
+ * The order of operations repeats the one of the scalar functions,
+ * so that the results stay as close as possible.
+ */
+namespace KoOptimizedHSLFunctions
+{
+
+using namespace KoOptimizedBlendFunctions;
+
+template<typename V>
+ALWAYS_INLINE V min3(const V &a, const V &b, const V &c)
+{
+    return blendMin(blendMin(a, b), c);
+}
+
+template<typename V>
+ALWAYS_INLINE V max3(const V &a, const V &b, const V &c)
+{
+    return blendMax(blendMax(a, b), c);
+}
+
+template<typename V>
+ALWAYS_INLINE V realEpsilon()
+{
+    return V(std::numeric_limits<float>::epsilon());
+}
+
+// \see HSYType
+struct HSY {
+    static constexpr bool lightnessIsAverage = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V getLightness(const V &r, const V &g, const V &b)
+    {
+        return V(0.299f) * r + V(0.587f) * g + V(0.114f) * b;
+    }
+
+    template<typename V>
+    static ALWAYS_INLINE V getSaturation(const V &r, const V &g, const V &b)
+    {
+        return max3(r, g, b) - min3(r, g, b);
+    }
+};
+
+// \see HSIType
+struct HSI {
+    static constexpr bool lightnessIsAverage = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V getLightness(const V &r, const V &g, const V &b)
+    {
+        return (r + g + b) * V(0.33333333333333333333f);
+    }
+
+    template<typename V>
+    static ALWAYS_INLINE V getSaturation(const V &r, const V &g, const V &b)
+    {
+        const V max = max3(r, g, b);
+        const V min = min3(r, g, b);
+        const V chroma = max - min;
+
+        return blendSelect(chroma > realEpsilon<V>(),
+                           V(1.0f) - min / getLightness(r, g, b),
+                           V(0.0f));
+    }
+};
+
+// \see HSLType
+struct HSL {
+    static constexpr bool lightnessIsAverage = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V getLightness(const V &r, const V &g, const V &b)
+    {
+        return (max3(r, g, b) + min3(r, g, b)) * V(0.5f);
+    }
+
+    template<typename V>
+    static ALWAYS_INLINE V getSaturation(const V &r, const V &g, const V &b)
+    {
+        const V max = max3(r, g, b);
+        const V min = min3(r, g, b);
+        const V chroma = max - min;
+        const V light = (max + min) * V(0.5f);
+        const V div = V(1.0f) - blendAbs(V(2.0f) * light - V(1.0f));
+
+        return blendSelect(div > realEpsilon<V>(), chroma / div, V(0.0f));
+    }
+};
+
+// \see HSVType
+struct HSV {
+    static constexpr bool lightnessIsAverage = false;
+
+    template<typename V>
+    static ALWAYS_INLINE V getLightness(const V &r, const V &g, const V &b)
+    {
+        return max3(r, g, b);
+    }
+
+    template<typename V>
+    static ALWAYS_INLINE V getSaturation(const V &r, const V &g, const V &b)
+    {
+        const V max = max3(r, g, b);
+        const V min = min3(r, g, b);
+
+        return blendSelect(max > realEpsilon<V>(), (max - min) / max, V(0.0f));
+    }
+};
+
+/**
+ * \see ToneMapping()
+ *
+ * Both the shadows and highlights passes use the lightness and the
+ * extremes of the incoming color, exactly like the scalar version does.
+ */
+template<class HSX, typename V>
+ALWAYS_INLINE void toneMapping(V &r, V &g, V &b)
+{
+    const V zero(0.0f);
+    const V one(1.0f);
+    const V eps = realEpsilon<V>();
+
+    const V l = HSX::getLightness(r, g, b);
+    const V n = min3(r, g, b);
+    const V x = max3(r, g, b);
+
+    const V shadowsStretch = l - n;
+    const V shadowsScale = l / shadowsStretch;
+
+    auto fixShadows = [&] (const V &c) {
+        const V stretched = blendSelect(shadowsStretch < eps, zero, l + (c - l) * shadowsScale);
+        return blendSelect(n < zero,
+                           blendSelect(l <= V(0.00001f), zero, stretched),
+                           c);
+    };
+
+    r = fixShadows(r);
+    g = fixShadows(g);
+    b = fixShadows(b);
+
+    const V highlightsStretch = x - l;
+    const V highlightsScale = (one - l) / highlightsStretch;
+
+    auto fixHighlights = [&] (const V &c) {
+        const V fallback = HSX::lightnessIsAverage ? one : blendMin(c, one);
+        const V stretched = blendSelect(highlightsStretch < eps, fallback, l + (c - l) * highlightsScale);
+        return blendSelect(x > one,
+                           blendSelect(l > one, fallback, stretched),
+                           c);
+    };
+
+    r = fixHighlights(r);
+    g = fixHighlights(g);
+    b = fixHighlights(b);
+}
+
+// \see setLightness()
+template<class HSX, typename V>
+ALWAYS_INLINE void setLightness(V &r, V &g, V &b, const V &light)
+{
+    const V delta = light - HSX::getLightness(r, g, b);
+
+    r += delta;
+    g += delta;
+    b += delta;
+
+    toneMapping<HSX>(r, g, b);
+}
+
+/**
+ * \see setSaturation()
+ *
+ * Instead of sorting the channels, every channel is stretched between
+ * the minimal and the maximal one, which gives the same result for max,
+ * mid and min channels.
+ */
+template<typename V>
+ALWAYS_INLINE void setSaturation(V &r, V &g, V &b, const V &sat)
+{
+    const V zero(0.0f);
+    const V min = min3(r, g, b);
+    const V chroma = max3(r, g, b) - min;
+    const auto isGray = !(chroma > realEpsilon<V>());
+
+    r = blendSelect(isGray, zero, ((r - min) * sat) / chroma);
+    g = blendSelect(isGray, zero, ((g - min) * sat) / chroma);
+    b = blendSelect(isGray, zero, ((b - min) * sat) / chroma);
+}
+
+// \see CFColor
+template<class HSX>
+struct Color {
+    template<typename V>
+    static ALWAYS_INLINE void compose(const V &srcR, const V &srcG, const V &srcB, V &dstR, V &dstG, V &dstB)
+    {
+        const V lum = HSX::getLightness(dstR, dstG, dstB);
+        dstR = srcR;
+        dstG = srcG;
+        dstB = srcB;
+        setLightness<HSX>(dstR, dstG, dstB, lum);
+    }
+};
+
+// \see CFHue
+template<class HSX>
+struct Hue {
+    template<typename V>
+    static ALWAYS_INLINE void compose(const V &srcR, const V &srcG, const V &srcB, V &dstR, V &dstG, V &dstB)
+    {
+        const V sat = HSX::getSaturation(dstR, dstG, dstB);
+        const V lum = HSX::getLightness(dstR, dstG, dstB);
+        dstR = srcR;
+        dstG = srcG;
+        dstB = srcB;
+        setSaturation(dstR, dstG, dstB, sat);
+        setLightness<HSX>(dstR, dstG, dstB, lum);
+    }
+};
+
+// \see CFSaturation
+template<class HSX>
+struct Saturation {
+    template<typename V>
+    static ALWAYS_INLINE void compose(const V &srcR, const V &srcG, const V &srcB, V &dstR, V &dstG, V &dstB)
+    {
+        const V sat = HSX::getSaturation(srcR, srcG, srcB);
+        const V light = HSX::getLightness(dstR, dstG, dstB);
+        setSaturation(dstR, dstG, dstB, sat);
+        setLightness<HSX>(dstR, dstG, dstB, light);
+    }
+};
+
+// \see CFLightness
+template<class HSX>
+struct Lightness {
+    template<typename V>
+    static ALWAYS_INLINE void compose(const V &srcR, const V &srcG, const V &srcB, V &dstR, V &dstG, V &dstB)
+    {
+        setLightness<HSX>(dstR, dstG, dstB, HSX::getLightness(srcR, srcG, srcB));
+    }
+};
+
+} // namespace KoOptimizedHSLFunctions
+
+/**
+ * A compositor for KoStreamedMath::genericComposite() that implements
+ * the logic of KoCompositeOpGenericHSLFunctor with all channel flags set.
+ *
+ * \p bgrOrder defines the order of the color channels in memory, it is
+ * needed for the blend functions that are not symmetric in R, G and B.
+ */
+template<typename channels_type, typename BlendFunction, bool bgrOrder>
+struct GenericHSLCompositor {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo &params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    static constexpr bool isInteger = std::numeric_limits<channels_type>::is_integer;
+
+    static constexpr float unitColor =
+        isInteger ? float(std::numeric_limits<channels_type>::max()) : 1.0f;
+
+    /**
+     * The blend function gets the channels clamped into SDR range (see
+     * KoClampedSourceAndDestinationCompositeOpGenericFunctorBase), but
+     * the mixing is done with the original values, like in the generic op
+     */
+    template<typename V>
+    static ALWAYS_INLINE void blendPixel(V src_c1, V src_c2, V src_c3,
+                                         V &dst_c1, V &dst_c2, V &dst_c3,
+                                         const V &srcWeight,
+                                         const V &dstWeight,
+                                         const V &blendWeight,
+                                         const V &newAlphaRec)
+    {
+        using namespace KoOptimizedBlendFunctions;
+
+        if (isInteger) {
+            const V unitRec(1.0f / unitColor);
+
+            src_c1 *= unitRec;
+            src_c2 *= unitRec;
+            src_c3 *= unitRec;
+            dst_c1 *= unitRec;
+            dst_c2 *= unitRec;
+            dst_c3 *= unitRec;
+        }
+
+        auto clampInput = [] (const V &c) {
+            return isInteger ? c : clampToSDR(c);
+        };
+
+        const V srcR = clampInput(bgrOrder ? src_c3 : src_c1);
+        const V srcG = clampInput(src_c2);
+        const V srcB = clampInput(bgrOrder ? src_c1 : src_c3);
+
+        V r = clampInput(bgrOrder ? dst_c3 : dst_c1);
+        V g = clampInput(dst_c2);
+        V b = clampInput(bgrOrder ? dst_c1 : dst_c3);
+
+        BlendFunction::compose(srcR, srcG, srcB, r, g, b);
+
+        /**
+         * Integer channels are clamped on conversion from float, the
+         * floating point ones get only their negative values fixed
+         * (see possiblyFixNegativeValuesNearZeroPoint())
+         */
+        auto clampResult = [] (const V &c) {
+            return isInteger ? clampToSDR(c) : blendMax(c, V(0.0f));
+        };
+
+        r = clampResult(r);
+        g = clampResult(g);
+        b = clampResult(b);
+
+        auto mix = [&] (const V &src, const V &dst, const V &result) {
+            const V mixed = (dstWeight * dst + srcWeight * src + blendWeight * result) * newAlphaRec;
+            return isInteger ? mixed * V(unitColor) : mixed;
+        };
+
+        dst_c1 = mix(src_c1, dst_c1, bgrOrder ? b : r);
+        dst_c2 = mix(src_c2, dst_c2, g);
+        dst_c3 = mix(src_c3, dst_c3, bgrOrder ? r : b);
+    }
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        Q_UNUSED(oparams);
+
+        float_v src_alpha;
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        // the pixels with transparent source are not changed
+        const float_m emptySrc = src_alpha <= float_v(0.0f);
+        if (xsimd::all(emptySrc)) {
+            return;
+        }
+
+        float_v dst_alpha;
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const float_v oneValue(1.0f);
+        const float_v blendWeight = src_alpha * dst_alpha;
+        const float_v srcWeight = src_alpha - blendWeight;
+        const float_v dstWeight = dst_alpha - blendWeight;
+        const float_v newAlpha = src_alpha + dstWeight;
+
+        // newAlpha is non-zero in all the lanes that are not empty
+        const float_v newAlphaRec = oneValue / xsimd::select(emptySrc, oneValue, newAlpha);
+
+        float_v c1 = dst_c1;
+        float_v c2 = dst_c2;
+        float_v c3 = dst_c3;
+
+        blendPixel(src_c1, src_c2, src_c3, c1, c2, c3, srcWeight, dstWeight, blendWeight, newAlphaRec);
+
+        if (xsimd::any(emptySrc)) {
+            c1 = xsimd::select(emptySrc, dst_c1, c1);
+            c2 = xsimd::select(emptySrc, dst_c2, c2);
+            c3 = xsimd::select(emptySrc, dst_c3, c3);
+        }
+
+        dataWrapper.write(dst, c1, c2, c3, xsimd::select(emptySrc, dst_alpha, newAlpha));
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha <= 0.0f) return;
+
+        float dstAlpha = d[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(dstAlpha);
+
+        const float blendWeight = srcAlpha * dstAlpha;
+        const float srcWeight = srcAlpha - blendWeight;
+        const float dstWeight = dstAlpha - blendWeight;
+        float newAlpha = srcAlpha + dstWeight;
+        const float newAlphaRec = 1.0f / newAlpha;
+
+        float c1 = d[0];
+        float c2 = d[1];
+        float c3 = d[2];
+
+        blendPixel(float(s[0]), float(s[1]), float(s[2]), c1, c2, c3,
+                   srcWeight, dstWeight, blendWeight, newAlphaRec);
+
+        d[0] = PixelWrapper<channels_type, _impl>::roundFloatToUint(c1);
+        d[1] = PixelWrapper<channels_type, _impl>::roundFloatToUint(c2);
+        d[2] = PixelWrapper<channels_type, _impl>::roundFloatToUint(c3);
+
+        PixelWrapper<channels_type, _impl>::denormalizeAlpha(newAlpha);
+        d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(newAlpha);
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericHSLFunctor for the blend
+ * functions of KoOptimizedHSLFunctions in RGBA color spaces. Like
+ * KoOptimizedCompositeOpGenericSCBase, only the case when all the channel
+ * flags are set is vectorized, all the other cases are passed to
+ * the generic op.
+ */
+template<typename channels_type, bool bgrOrder, typename _impl>
+class KoOptimizedCompositeOpGenericHSLBase : public KoCompositeOp
+{
+public:
+    /**
+     * Takes ownership of \p genericOp
+     */
+    KoOptimizedCompositeOpGenericHSLBase(KoCompositeOp *genericOp)
+        : KoCompositeOp(genericOp->colorSpace(), genericOp->id(), genericOp->category()),
+          m_genericOp(genericOp),
+          m_blendMode(KoOptimizedBlendMode::hslModeFromCompositeOpId(genericOp->id()))
+    {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_blendMode != KoOptimizedBlendMode::UnsupportedHSL);
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (m_blendMode == KoOptimizedBlendMode::UnsupportedHSL ||
+            (!params.channelFlags.isEmpty() &&
+             params.channelFlags != QBitArray(4, true))) {
+
+            m_genericOp->composite(params);
+            return;
+        }
+
+        if (params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+private:
+    template<bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        using namespace KoOptimizedHSLFunctions;
+
+        switch (m_blendMode) {
+        case KoOptimizedBlendMode::ColorHSY:
+            compositeImpl<haveMask, Color<HSY>>(params);
+            break;
+        case KoOptimizedBlendMode::HueHSY:
+            compositeImpl<haveMask, Hue<HSY>>(params);
+            break;
+        case KoOptimizedBlendMode::SaturationHSY:
+            compositeImpl<haveMask, Saturation<HSY>>(params);
+            break;
+        case KoOptimizedBlendMode::LightnessHSY:
+            compositeImpl<haveMask, Lightness<HSY>>(params);
+            break;
+        case KoOptimizedBlendMode::ColorHSI:
+            compositeImpl<haveMask, Color<HSI>>(params);
+            break;
+        case KoOptimizedBlendMode::HueHSI:
+            compositeImpl<haveMask, Hue<HSI>>(params);
+            break;
+        case KoOptimizedBlendMode::SaturationHSI:
+            compositeImpl<haveMask, Saturation<HSI>>(params);
+            break;
+        case KoOptimizedBlendMode::LightnessHSI:
+            compositeImpl<haveMask, Lightness<HSI>>(params);
+            break;
+        case KoOptimizedBlendMode::ColorHSL:
+            compositeImpl<haveMask, Color<HSL>>(params);
+            break;
+        case KoOptimizedBlendMode::HueHSL:
+            compositeImpl<haveMask, Hue<HSL>>(params);
+            break;
+        case KoOptimizedBlendMode::SaturationHSL:
+            compositeImpl<haveMask, Saturation<HSL>>(params);
+            break;
+        case KoOptimizedBlendMode::LightnessHSL:
+            compositeImpl<haveMask, Lightness<HSL>>(params);
+            break;
+        case KoOptimizedBlendMode::ColorHSV:
+            compositeImpl<haveMask, Color<HSV>>(params);
+            break;
+        case KoOptimizedBlendMode::HueHSV:
+            compositeImpl<haveMask, Hue<HSV>>(params);
+            break;
+        case KoOptimizedBlendMode::SaturationHSV:
+            compositeImpl<haveMask, Saturation<HSV>>(params);
+            break;
+        case KoOptimizedBlendMode::LightnessHSV:
+            compositeImpl<haveMask, Lightness<HSV>>(params);
+            break;
+        case KoOptimizedBlendMode::UnsupportedHSL:
+            m_genericOp->composite(params);
+            break;
+        }
+    }
+
+    template<bool haveMask, typename BlendFunction>
+    inline void compositeImpl(const KoCompositeOp::ParameterInfo& params) const
+    {
+        KoStreamedMath<_impl>::template genericComposite<haveMask, false,
+            GenericHSLCompositor<channels_type, BlendFunction, bgrOrder>,
+            4 * sizeof(channels_type)>(params);
+    }
+
+private:
+    const QScopedPointer<KoCompositeOp> m_genericOp;
+    const KoOptimizedBlendMode::HSLMode m_blendMode;
+};
+
+/**
+ * An optimized non-separable composite op for 32-bit BGRA color
+ * spaces (4 channels, 8 bits per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSL32 : public KoOptimizedCompositeOpGenericHSLBase<quint8, true, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericHSLBase<quint8, true, _impl>::KoOptimizedCompositeOpGenericHSLBase;
+};
+
+/**
+ * An optimized non-separable composite op for 64-bit BGRA color
+ * spaces (4 channels, 16 bits per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSLU64 : public KoOptimizedCompositeOpGenericHSLBase<quint16, true, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericHSLBase<quint16, true, _impl>::KoOptimizedCompositeOpGenericHSLBase;
+};
+
+/**
+ * An optimized non-separable composite op for 128-bit RGBA color
+ * spaces (4 channels, 32-bit float per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericHSL128 : public KoOptimizedCompositeOpGenericHSLBase<float, false, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericHSLBase<float, false, _impl>::KoOptimizedCompositeOpGenericHSLBase;
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICHSL_H
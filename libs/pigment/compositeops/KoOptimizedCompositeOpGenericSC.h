@@ -0,0 +1,526 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+
+#include <cmath>
+#include <limits>
+
+#include <QScopedPointer>
+
+#include <kis_assert.h>
+
+#include "KoOptimizedBlendMode.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized versions of the most popular separable blend functions
+ * of KoCompositeOpFunctions.h. Every function is written once, as a
+ * template, and is instantiated both for plain floats (for the unaligned
+ * head and tail of the row) and for xsimd batches, so the result of a
+ * pixel doesn't depend on its position in the row.
+ *
+ * All the channels are normalized into 0.0...1.0 range (integer color
+ * spaces), or passed as they are (floating point color spaces). The
+ * clampSource/clampDestination flags repeat the channel clamping policies
+ * of the scalar functions (see KoCompositeOpGenericFunctorBase).
+ */
+namespace KoOptimizedBlendFunctions
+{
+
+ALWAYS_INLINE float blendMin(float a, float b)
+{
+    return std::min(a, b);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> blendMin(const xsimd::batch<float, A> &a, const xsimd::batch<float, A> &b)
+{
+    return xsimd::min(a, b);
+}
+
+ALWAYS_INLINE float blendMax(float a, float b)
+{
+    return std::max(a, b);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> blendMax(const xsimd::batch<float, A> &a, const xsimd::batch<float, A> &b)
+{
+    return xsimd::max(a, b);
+}
+
+ALWAYS_INLINE float blendSqrt(float a)
+{
+    return std::sqrt(a);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> blendSqrt(const xsimd::batch<float, A> &a)
+{
+    return xsimd::sqrt(a);
+}
+
+ALWAYS_INLINE float blendAbs(float a)
+{
+    return std::abs(a);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> blendAbs(const xsimd::batch<float, A> &a)
+{
+    return xsimd::abs(a);
+}
+
+ALWAYS_INLINE float blendSelect(bool cond, float a, float b)
+{
+    return cond ? a : b;
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> blendSelect(const xsimd::batch_bool<float, A> &cond,
+                                                 const xsimd::batch<float, A> &a,
+                                                 const xsimd::batch<float, A> &b)
+{
+    return xsimd::select(cond, a, b);
+}
+
+template<typename V>
+ALWAYS_INLINE V clampToSDR(const V &a)
+{
+    return blendMin(blendMax(a, V(0.0f)), V(1.0f));
+}
+
+struct BlendFunctionBase {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+};
+
+// \see cfMultiply
+struct Multiply : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return src * dst;
+    }
+};
+
+// \see cfScreen
+struct Screen : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return src + dst - src * dst;
+    }
+};
+
+// \see cfDarkenOnly
+struct Darken : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return blendMin(src, dst);
+    }
+};
+
+// \see cfLightenOnly
+struct Lighten : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return blendMax(src, dst);
+    }
+};
+
+// \see cfDifference
+struct Difference : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return blendMax(src, dst) - blendMin(src, dst);
+    }
+};
+
+/**
+ * \see cfAddition
+ *
+ * The integer version clamps the result into the channel range,
+ * the floating point one leaves it unbounded.
+ */
+template<bool clampResult>
+struct Addition : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return clampResult ? clampToSDR(src + dst) : src + dst;
+    }
+};
+
+// \see cfSubtract
+template<bool clampResult>
+struct Subtract : BlendFunctionBase {
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return clampResult ? clampToSDR(dst - src) : dst - src;
+    }
+};
+
+// \see CFHardLight
+struct HardLight : BlendFunctionBase {
+    static constexpr bool clampSource = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        const V src2 = src + src;
+        const V screened = src2 - V(1.0f);
+
+        const V result = blendSelect(src > V(0.5f),
+                                     screened + dst - screened * dst,
+                                     src2 * dst);
+
+        return blendSelect(src == V(0.5f), dst, result);
+    }
+};
+
+// \see CFOverlay, it inherits the clamping policy of CFHardLight
+struct Overlay : BlendFunctionBase {
+    static constexpr bool clampSource = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        return HardLight::compose(dst, src);
+    }
+};
+
+// \see CFSoftLight
+struct SoftLight : BlendFunctionBase {
+    static constexpr bool clampSource = true;
+    static constexpr bool clampDestination = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        const V src2 = src + src;
+
+        return blendSelect(src > V(0.5f),
+                           dst + (src2 - V(1.0f)) * (blendSqrt(dst) - dst),
+                           dst - (V(1.0f) - src2) * dst * (V(1.0f) - dst));
+    }
+};
+
+// \see CFColorDodge with SDR clamping policy
+struct ColorDodge : BlendFunctionBase {
+    static constexpr bool clampSource = true;
+
+    template<typename V>
+    static ALWAYS_INLINE V compose(const V &src, const V &dst)
+    {
+        const V unitSrcResult = blendSelect(dst <= V(0.0f), V(0.0f), V(1.0f));
+
+        /**
+         * The lanes with src == 1.0 may produce inf or NaN here,
+         * but they are replaced with unitSrcResult anyway
+         */
+        const V result = clampToSDR(dst / (V(1.0f) - src));
+
+        return blendSelect(src >= V(1.0f), unitSrcResult, result);
+    }
+};
+
+} // namespace KoOptimizedBlendFunctions
+
+/**
+ * A compositor for KoStreamedMath::genericComposite() that implements
+ * the logic of KoCompositeOpGenericSCFunctor with all channel flags set
+ * and additive blending policy.
+ */
+template<typename channels_type, typename BlendFunction>
+struct GenericSCCompositor {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo &params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    static constexpr bool isInteger = std::numeric_limits<channels_type>::is_integer;
+
+    /**
+     * The floating point alpha is compared fuzzily, like in
+     * KoCompositeOpGenericSCFunctor
+     */
+    static constexpr float zeroAlphaThreshold = isInteger ? 0.0f : 0.00001f;
+
+    static constexpr float unitColor =
+        isInteger ? float(std::numeric_limits<channels_type>::max()) : 1.0f;
+
+    template<typename V>
+    static ALWAYS_INLINE V blendChannel(V src, V dst,
+                                        const V &srcWeight,
+                                        const V &dstWeight,
+                                        const V &blendWeight,
+                                        const V &newAlphaRec)
+    {
+        using namespace KoOptimizedBlendFunctions;
+
+        if (isInteger) {
+            src *= V(1.0f / unitColor);
+            dst *= V(1.0f / unitColor);
+        } else {
+            if (BlendFunction::clampSource) {
+                src = clampToSDR(src);
+            }
+            if (BlendFunction::clampDestination) {
+                dst = clampToSDR(dst);
+            }
+        }
+
+        const V result = BlendFunction::compose(src, dst);
+        const V mixed = (dstWeight * dst + srcWeight * src + blendWeight * result) * newAlphaRec;
+
+        return isInteger ? mixed * V(unitColor) : mixed;
+    }
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        Q_UNUSED(oparams);
+
+        float_v src_alpha;
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        // the pixels with transparent source are not changed
+        const float_m emptySrc = xsimd::abs(src_alpha) <= float_v(zeroAlphaThreshold);
+        if (xsimd::all(emptySrc)) {
+            return;
+        }
+
+        float_v dst_alpha;
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const float_v oneValue(1.0f);
+        const float_v blendWeight = src_alpha * dst_alpha;
+        const float_v srcWeight = src_alpha - blendWeight;
+        const float_v dstWeight = dst_alpha - blendWeight;
+        const float_v newAlpha = src_alpha + dstWeight;
+
+        // newAlpha is non-zero in all the lanes that are not empty
+        const float_v newAlphaRec = oneValue / xsimd::select(emptySrc, oneValue, newAlpha);
+
+        float_v c1 = blendChannel(src_c1, dst_c1, srcWeight, dstWeight, blendWeight, newAlphaRec);
+        float_v c2 = blendChannel(src_c2, dst_c2, srcWeight, dstWeight, blendWeight, newAlphaRec);
+        float_v c3 = blendChannel(src_c3, dst_c3, srcWeight, dstWeight, blendWeight, newAlphaRec);
+
+        if (xsimd::any(emptySrc)) {
+            c1 = xsimd::select(emptySrc, dst_c1, c1);
+            c2 = xsimd::select(emptySrc, dst_c2, c2);
+            c3 = xsimd::select(emptySrc, dst_c3, c3);
+        }
+
+        dataWrapper.write(dst, c1, c2, c3, xsimd::select(emptySrc, dst_alpha, newAlpha));
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (std::abs(srcAlpha) <= zeroAlphaThreshold) return;
+
+        float dstAlpha = d[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(dstAlpha);
+
+        const float blendWeight = srcAlpha * dstAlpha;
+        const float srcWeight = srcAlpha - blendWeight;
+        const float dstWeight = dstAlpha - blendWeight;
+        float newAlpha = srcAlpha + dstWeight;
+        const float newAlphaRec = 1.0f / newAlpha;
+
+        for (int i = 0; i < alpha_pos; i++) {
+            d[i] = PixelWrapper<channels_type, _impl>::roundFloatToUint(
+                blendChannel(float(s[i]), float(d[i]), srcWeight, dstWeight, blendWeight, newAlphaRec));
+        }
+
+        PixelWrapper<channels_type, _impl>::denormalizeAlpha(newAlpha);
+        d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(newAlpha);
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the separable blend
+ * functions of KoOptimizedBlendFunctions in RGBA color spaces. The case
+ * when all the channel flags are set is vectorized, all the other cases
+ * (locked alpha, disabled channels) are passed to the generic op the
+ * optimized one has been created from.
+ */
+template<typename channels_type, typename _impl>
+class KoOptimizedCompositeOpGenericSCBase : public KoCompositeOp
+{
+public:
+    /**
+     * Takes ownership of \p genericOp
+     */
+    KoOptimizedCompositeOpGenericSCBase(KoCompositeOp *genericOp)
+        : KoCompositeOp(genericOp->colorSpace(), genericOp->id(), genericOp->category()),
+          m_genericOp(genericOp),
+          m_blendMode(KoOptimizedBlendMode::fromCompositeOpId(genericOp->id()))
+    {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_blendMode != KoOptimizedBlendMode::Unsupported);
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (m_blendMode == KoOptimizedBlendMode::Unsupported ||
+            (!params.channelFlags.isEmpty() &&
+             params.channelFlags != QBitArray(4, true))) {
+
+            m_genericOp->composite(params);
+            return;
+        }
+
+        if (params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+private:
+    template<bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        static constexpr bool isInteger = std::numeric_limits<channels_type>::is_integer;
+
+        switch (m_blendMode) {
+        case KoOptimizedBlendMode::Multiply:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Multiply>(params);
+            break;
+        case KoOptimizedBlendMode::Screen:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Screen>(params);
+            break;
+        case KoOptimizedBlendMode::Darken:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Darken>(params);
+            break;
+        case KoOptimizedBlendMode::Lighten:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Lighten>(params);
+            break;
+        case KoOptimizedBlendMode::Difference:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Difference>(params);
+            break;
+        case KoOptimizedBlendMode::Addition:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Addition<isInteger>>(params);
+            break;
+        case KoOptimizedBlendMode::Subtract:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Subtract<isInteger>>(params);
+            break;
+        case KoOptimizedBlendMode::HardLight:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::HardLight>(params);
+            break;
+        case KoOptimizedBlendMode::Overlay:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::Overlay>(params);
+            break;
+        case KoOptimizedBlendMode::SoftLight:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::SoftLight>(params);
+            break;
+        case KoOptimizedBlendMode::ColorDodge:
+            compositeImpl<haveMask, KoOptimizedBlendFunctions::ColorDodge>(params);
+            break;
+        case KoOptimizedBlendMode::Unsupported:
+            m_genericOp->composite(params);
+            break;
+        }
+    }
+
+    template<bool haveMask, typename BlendFunction>
+    inline void compositeImpl(const KoCompositeOp::ParameterInfo& params) const
+    {
+        KoStreamedMath<_impl>::template genericComposite<haveMask, false,
+            GenericSCCompositor<channels_type, BlendFunction>,
+            4 * sizeof(channels_type)>(params);
+    }
+
+private:
+    const QScopedPointer<KoCompositeOp> m_genericOp;
+    const KoOptimizedBlendMode::Mode m_blendMode;
+};
+
+/**
+ * An optimized separable composite op for 32-bit RGBA color
+ * spaces (4 channels, 8 bits per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSC32 : public KoOptimizedCompositeOpGenericSCBase<quint8, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericSCBase<quint8, _impl>::KoOptimizedCompositeOpGenericSCBase;
+};
+
+/**
+ * An optimized separable composite op for 64-bit RGBA color
+ * spaces (4 channels, 16 bits per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSCU64 : public KoOptimizedCompositeOpGenericSCBase<quint16, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericSCBase<quint16, _impl>::KoOptimizedCompositeOpGenericSCBase;
+};
+
+/**
+ * An optimized separable composite op for 128-bit RGBA color
+ * spaces (4 channels, 32-bit float per channel, alpha is the last one)
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpGenericSC128 : public KoOptimizedCompositeOpGenericSCBase<float, _impl>
+{
+public:
+    using KoOptimizedCompositeOpGenericSCBase<float, _impl>::KoOptimizedCompositeOpGenericSCBase;
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
@@ -94,7 +94,12 @@ struct OverCompositor128 {
         float_v new_alpha;
 
         const float_v oneValue(1.0f);
-        if (xsimd::all(dst_alpha == oneValue)) {
+        if (alphaLocked) {
+            // the destination alpha is preserved, so the blend
+            // factor doesn't depend on it at all
+            new_alpha = dst_alpha;
+            src_blend = src_alpha;
+        } else if (xsimd::all(dst_alpha == oneValue)) {
             new_alpha = dst_alpha;
             src_blend = src_alpha;
         } else if (xsimd::all(dst_alpha == zeroValue)) {
@@ -271,7 +276,9 @@ public:
                 !params.channelFlags.at(3);
 
             if (allChannelsFlag && alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, OverCompositor128<float, true, true> >(params);
+                // painting with alpha lock is common enough to deserve
+                // the vectorized path
+                KoStreamedMath<_impl>::template genericComposite128<haveMask, false, OverCompositor128<float, true, true> >(params);
             } else if (!allChannelsFlag && !alphaLocked) {
                 KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, OverCompositor128<float, false, false> >(params);
             } else /*if (!allChannelsFlag && alphaLocked) */{
@@ -315,7 +322,9 @@ public:
                 !params.channelFlags.at(3);
 
             if (allChannelsFlag && alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<quint16, true, true> >(params);
+                // painting with alpha lock is common enough to deserve
+                // the vectorized path
+                KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor128<quint16, true, true> >(params);
             } else if (!allChannelsFlag && !alphaLocked) {
                 KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<quint16, false, false> >(params);
             } else /*if (!allChannelsFlag && alphaLocked) */{
@@ -325,4 +334,52 @@ public:
     }
 };
 
+#ifdef HAVE_OPENEXR
+template<typename _impl>
+class KoOptimizedCompositeOpOverF16 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOverF16(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor128<half, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                // painting with alpha lock is common enough to deserve
+                // the vectorized path
+                KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor128<half, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<half, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<half, true, false> >(params);
+            }
+        }
+    }
+};
+#endif
+
 #endif // KOOPTIMIZEDCOMPOSITEOPOVER128_H_
@@ -73,7 +73,12 @@ struct OverCompositor32 {
         float_v src_blend;
         float_v new_alpha;
 
-        if (xsimd::all(dst_alpha == uint8Max)) {
+        if (alphaLocked) {
+            // the destination alpha is preserved, so the blend
+            // factor doesn't depend on it at all
+            new_alpha = dst_alpha;
+            src_blend = src_alpha * uint8MaxRec1;
+        } else if (xsimd::all(dst_alpha == uint8Max)) {
             new_alpha = dst_alpha;
             src_blend = src_alpha * uint8MaxRec1;
         } else if (xsimd::all(dst_alpha == zeroValue)) {
@@ -102,12 +107,13 @@ struct OverCompositor32 {
             dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
 
         } else {
-            if (!haveMask && !haveOpacity) {
+            if (!haveMask && !haveOpacity && !alphaLocked) {
                 memcpy(dst, src, 4 * float_v::size);
                 return;
             } else {
-                // opacity has changed the alpha of the source,
-                // so we can't just memcpy the bytes
+                // opacity has changed the alpha of the source
+                // (or the alpha is locked), so we can't just
+                // memcpy the bytes
                 dst_c1 = src_c1;
                 dst_c2 = src_c2;
                 dst_c3 = src_c3;
@@ -231,7 +237,9 @@ public:
                 !params.channelFlags.at(3);
 
             if (allChannelsFlag && alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, OverCompositor32<quint8, quint32, true, true> >(params);
+                // painting with alpha lock is common enough to deserve
+                // the vectorized path
+                KoStreamedMath<_impl>::template genericComposite32<haveMask, false, OverCompositor32<quint8, quint32, true, true> >(params);
             } else if (!allChannelsFlag && !alphaLocked) {
                 KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, OverCompositor32<quint8, quint32, false, false> >(params);
             } else /*if (!allChannelsFlag && alphaLocked) */{
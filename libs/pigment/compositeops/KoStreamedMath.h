@@ -558,6 +558,13 @@ private:
     const float_v m_orig_c3;
 };
 
+#ifdef HAVE_OPENEXR
+template<class _impl>
+struct PixelStateRecoverHelper<half, _impl> : public PixelStateRecoverHelper<float, _impl> {
+    using PixelStateRecoverHelper<float, _impl>::PixelStateRecoverHelper;
+};
+#endif
+
 template<typename channels_type, class _impl>
 struct PixelWrapper
 {
@@ -842,6 +849,165 @@ struct PixelWrapper<float, _impl> {
     }
 };
 
+#ifdef HAVE_OPENEXR
+/**
+ * Half-float pixels are stored exactly like the 16-bit integer ones,
+ * but the channels are not normalized, they are converted into float
+ * values as they are. The conversion is done with plain integer vector
+ * instructions, so it doesn't depend on F16C/FP16 extensions and gives
+ * the same results on every architecture (rounding is done to the
+ * nearest even value, the same way Imath's half does it).
+ */
+template<class _impl>
+struct PixelWrapper<half, _impl> {
+    using int_v = xsimd::batch<int, _impl>;
+    using uint_v = xsimd::batch<unsigned int, _impl>;
+    using float_v = xsimd::batch<float, _impl>;
+
+    static_assert(int_v::size == uint_v::size, "the selected architecture does not guarantee vector size equality!");
+    static_assert(uint_v::size == float_v::size, "the selected architecture does not guarantee vector size equality!");
+
+    ALWAYS_INLINE
+    static half lerpMixedUintFloat(half a, half b, float alpha)
+    {
+        return half(Arithmetic::lerp(float(a), float(b), alpha));
+    }
+
+    ALWAYS_INLINE
+    static half roundFloatToUint(float x)
+    {
+        return half(x);
+    }
+
+    ALWAYS_INLINE
+    static void normalizeAlpha(float &alpha)
+    {
+        Q_UNUSED(alpha);
+    }
+
+    ALWAYS_INLINE
+    static void denormalizeAlpha(float &alpha)
+    {
+        Q_UNUSED(alpha);
+    }
+
+    PixelWrapper()
+        : mask(0xFFFF)
+    {
+    }
+
+    /**
+     * Converts the half-float bits stored in the lower 16 bits of
+     * every element of \p value into floats
+     */
+    ALWAYS_INLINE static float_v halfToFloat(const uint_v &value)
+    {
+        const int_v h = xsimd::bitwise_cast_compat<int>(value);
+        const int_v shiftedExp(0x7c00 << 13);
+
+        int_v o = (h & int_v(0x7fff)) << 13;
+        const int_v exp = o & shiftedExp;
+        o += int_v((127 - 15) << 23);
+
+        // Inf and NaN get the maximum float exponent
+        o = xsimd::select(exp == shiftedExp, o + int_v((128 - 16) << 23), o);
+
+        // zeros and subnormals are renormalized
+        const float_v magic = xsimd::bitwise_cast_compat<float>(int_v(113 << 23));
+        const int_v renormalized =
+            xsimd::bitwise_cast_compat<int>(xsimd::bitwise_cast_compat<float>(o + int_v(1 << 23)) - magic);
+        o = xsimd::select(exp == int_v(0), renormalized, o);
+
+        const uint_v sign = (value & uint_v(0x8000)) << 16;
+
+        return xsimd::bitwise_cast_compat<float>(xsimd::bitwise_cast_compat<unsigned int>(o) | sign);
+    }
+
+    /**
+     * Converts floats into half-float bits stored in the lower 16 bits
+     * of every element of the result
+     */
+    ALWAYS_INLINE static uint_v floatToHalf(const float_v &value)
+    {
+        const uint_v bits = xsimd::bitwise_cast_compat<unsigned int>(value);
+        const uint_v sign = bits & uint_v(0x80000000u);
+        const int_v f = xsimd::bitwise_cast_compat<int>(bits ^ sign);
+
+        // NaN becomes a quiet NaN, everything too big becomes Inf
+        const int_v infOrNan = xsimd::select(f > int_v(255 << 23), int_v(0x7e00), int_v(0x7c00));
+
+        // subnormal results are aligned with the help of float addition
+        const float_v denormMagic = xsimd::bitwise_cast_compat<float>(int_v(((127 - 15) + (23 - 10) + 1) << 23));
+        const int_v subnormal =
+            xsimd::bitwise_cast_compat<int>(xsimd::bitwise_cast_compat<float>(f) + denormMagic) -
+            xsimd::bitwise_cast_compat<int>(denormMagic);
+
+        // normal results are rounded to the nearest even value
+        const int_v mantissaOdd = (f >> 13) & int_v(1);
+        const int_v normal = (f + int_v(-(112 << 23) + 0xfff) + mantissaOdd) >> 13;
+
+        const int_v result =
+            xsimd::select(f >= int_v((127 + 16) << 23), infOrNan,
+                          xsimd::select(f < int_v(113 << 23), subnormal, normal));
+
+        return xsimd::bitwise_cast_compat<unsigned int>(result) | (sign >> 16);
+    }
+
+    ALWAYS_INLINE void read(const void *src, float_v &dst_c1, float_v &dst_c2, float_v &dst_c3, float_v &dst_alpha)
+    {
+#if XSIMD_VERSION_MAJOR < 10
+        uint_v pixelsC1C2;
+        uint_v pixelsC3Alpha;
+        KoRgbaInterleavers<16>::deinterleave(src, pixelsC1C2, pixelsC3Alpha);
+#else
+        const auto *srcPtr = static_cast<const typename uint_v::value_type *>(src);
+        const auto idx1 = xsimd::detail::make_sequence_as_batch<int_v>() * 2; // stride == 2
+        const auto idx2 = idx1 + 1; // offset 1 == 2nd members
+
+        const auto pixelsC1C2 = uint_v::gather(srcPtr, idx1);
+        const auto pixelsC3Alpha = uint_v::gather(srcPtr, idx2);
+#endif
+
+        dst_c1 = halfToFloat(pixelsC1C2 & mask); // r
+        dst_c2 = halfToFloat((pixelsC1C2 >> 16) & mask); // g
+        dst_c3 = halfToFloat(pixelsC3Alpha & mask); // b
+        dst_alpha = halfToFloat((pixelsC3Alpha >> 16) & mask); // a
+    }
+
+    ALWAYS_INLINE void write(void *dst, const float_v &c1, const float_v &c2, const float_v &c3, const float_v &a)
+    {
+        const auto c1c2 = (floatToHalf(c2) << 16) | floatToHalf(c1);
+        const auto c3ca = (floatToHalf(a) << 16) | floatToHalf(c3);
+
+#if XSIMD_VERSION_MAJOR < 10
+        KoRgbaInterleavers<16>::interleave(dst, c1c2, c3ca);
+#else
+        auto dstPtr = reinterpret_cast<typename int_v::value_type *>(dst);
+
+        const auto idx1 = xsimd::detail::make_sequence_as_batch<int_v>() * 2;
+        const auto idx2 = idx1 + 1;
+
+        c1c2.scatter(dstPtr, idx1);
+        c3ca.scatter(dstPtr, idx2);
+#endif
+    }
+
+    ALWAYS_INLINE
+    void clearPixels(quint8 *dataDst)
+    {
+        memset(dataDst, 0, float_v::size * sizeof(half) * 4);
+    }
+
+    ALWAYS_INLINE
+    void copyPixels(const quint8 *dataSrc, quint8 *dataDst)
+    {
+        memcpy(dataDst, dataSrc, float_v::size * sizeof(half) * 4);
+    }
+
+    const uint_v mask;
+};
+#endif
+
 namespace KoStreamedMathFunctions
 {
 template<int pixelSize>
@@ -16,6 +16,10 @@
 #include <testpigment.h>
 
 #include <QRandomGenerator>
+#include <QThread>
+
+#include <memory>
+#include <vector>
 
 TestColorConversionSystem::TestColorConversionSystem()
 {
@@ -501,5 +505,56 @@ void TestColorConversionSystem::testCmykBitnessConversion()
 
 }
 
+void TestColorConversionSystem::testConcurrentCachedConversions()
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *lab16 = KoColorSpaceRegistry::instance()->lab16();
+    const KoColorSpace *cmyk8 =
+        KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(),
+                                                     Integer8BitsColorDepthID.id(),
+                                                     QString());
+
+    QVERIFY(cmyk8);
+
+    /**
+     * More conversions than every thread keeps in its fast path,
+     * so that the threads keep returning the transformations to the
+     * shared pool and picking them up again
+     */
+    const QVector<const KoColorSpace*> dstColorSpaces = {rgb16, lab16, cmyk8, rgb16, lab16, cmyk8};
+
+    QVector<KoColor> expected;
+    Q_FOREACH (const KoColorSpace *dstCS, dstColorSpaces) {
+        expected << KoColor(QColor(177, 180, 42, 255), rgb8).convertedTo(dstCS);
+    }
+
+    const int numThreads = 8;
+    const int numIterations = 2000;
+
+    QAtomicInt numMismatches;
+    std::vector<std::unique_ptr<QThread>> threads;
+
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(QThread::create([&, i] () {
+            for (int j = 0; j < numIterations; j++) {
+                const int index = (i + j) % dstColorSpaces.size();
+                KoColor color(QColor(177, 180, 42, 255), rgb8);
+                color.convertTo(dstColorSpaces[index]);
+
+                if (color != expected[index]) {
+                    numMismatches.ref();
+                }
+            }
+        }));
+        threads.back()->start();
+    }
+
+    for (auto &thread : threads) {
+        thread->wait();
+    }
+
+    QCOMPARE(numMismatches.loadAcquire(), 0);
+}
 
 KISTEST_MAIN(TestColorConversionSystem)
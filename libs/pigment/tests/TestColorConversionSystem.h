@@ -40,6 +40,8 @@ private Q_SLOTS:
 
     void testCmykBitnessConversion();
 
+    void testConcurrentCachedConversions();
+
 private:
     std::vector<KoColorConversionSystem::NodeKey> calcPath(const std::vector<KoColorConversionSystem::NodeKey> &expectedPath);
 
@@ -7,7 +7,11 @@
 #include "KoColorSpaceAbstract.h"
 #include "KoColorSpaceTraits.h"
 
+#include "KoMixColorsOpFactory.h"
+#include "KoColorModelStandardIds.h"
+
 #include <cfloat>
+#include <random>
 
 #include <simpletest.h>
 
@@ -420,6 +424,153 @@ QBitArray makeChannelFlags(std::initializer_list<bool> flags)
     return result;
 }
 
+template <typename channels_type>
+void fillRandomPixels(QVector<channels_type> &pixels, std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    for (int i = 0; i < pixels.size(); i++) {
+        // every fifth pixel is fully transparent to exercise the empty-alpha branch
+        const bool isTransparent = (i % 4 == 3) && ((i / 4) % 5 == 0);
+        pixels[i] = isTransparent ?
+            KoColorSpaceMathsTraits<channels_type>::zeroValue :
+            KoColorSpaceMaths<float, channels_type>::scaleToA(dist(gen));
+    }
+}
+
+template <typename channels_type>
+bool pixelsAreEqual(const quint8 *a, const quint8 *b, int numPixels)
+{
+    const channels_type *pa = reinterpret_cast<const channels_type*>(a);
+    const channels_type *pb = reinterpret_cast<const channels_type*>(b);
+
+    for (int i = 0; i < 4 * numPixels; i++) {
+        if (std::numeric_limits<channels_type>::is_integer) {
+            if (pa[i] != pb[i]) return false;
+        } else {
+            // only the order of summation differs for the floating point spaces
+            if (qAbs(float(pa[i]) - float(pb[i])) > 1e-5f * qMax(1.0f, qAbs(float(pa[i])))) return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename channels_type>
+void testOptimizedMixColorsOpImpl()
+{
+    using Trait = KoColorSpaceTrait<channels_type, 4, 3>;
+
+    QScopedPointer<KoMixColorsOp> scalarOp(new KoMixColorsOpImpl<Trait>());
+    QScopedPointer<KoMixColorsOp> optimizedOp(
+        KoMixColorsOpFactory::createOptimized(colorDepthIdForChannelType<channels_type>(), 4, 3));
+
+    QVERIFY(optimizedOp);
+
+    std::mt19937 gen(42);
+
+    // an odd number to have a tail for any vector size
+    const int numPixels = 1037;
+
+    QVector<channels_type> colorsA(4 * numPixels);
+    QVector<channels_type> colorsB(4 * numPixels);
+    fillRandomPixels(colorsA, gen);
+    fillRandomPixels(colorsB, gen);
+
+    const quint8 *rawA = reinterpret_cast<const quint8*>(colorsA.constData());
+    const quint8 *rawB = reinterpret_cast<const quint8*>(colorsB.constData());
+
+    QVector<qint16> weights(numPixels);
+    std::uniform_int_distribution<int> weightDist(0, 255);
+    int weightSum = 0;
+    for (int i = 0; i < numPixels; i++) {
+        weights[i] = weightDist(gen);
+        weightSum += weights[i];
+    }
+
+    QVector<const quint8*> pointers(numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        pointers[i] = rawA + i * Trait::pixelSize;
+    }
+
+    QVector<channels_type> scalarResult(4 * numPixels);
+    QVector<channels_type> optimizedResult(4 * numPixels);
+
+    quint8 *rawScalar = reinterpret_cast<quint8*>(scalarResult.data());
+    quint8 *rawOptimized = reinterpret_cast<quint8*>(optimizedResult.data());
+
+    scalarOp->mixColors(rawA, weights.constData(), numPixels, rawScalar, weightSum);
+    optimizedOp->mixColors(rawA, weights.constData(), numPixels, rawOptimized, weightSum);
+    QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, 1));
+
+    scalarOp->mixColors(pointers.constData(), weights.constData(), numPixels, rawScalar, weightSum);
+    optimizedOp->mixColors(pointers.constData(), weights.constData(), numPixels, rawOptimized, weightSum);
+    QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, 1));
+
+    scalarOp->mixColors(rawA, numPixels, rawScalar);
+    optimizedOp->mixColors(rawA, numPixels, rawOptimized);
+    QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, 1));
+
+    {
+        QScopedPointer<KoMixColorsOp::Mixer> scalarMixer(scalarOp->createMixer());
+        QScopedPointer<KoMixColorsOp::Mixer> optimizedMixer(optimizedOp->createMixer());
+
+        // accumulate the data in a few uneven chunks
+        for (int offset = 0; offset < numPixels; offset += 333) {
+            const int chunk = qMin(333, numPixels - offset);
+            scalarMixer->accumulate(rawB + offset * Trait::pixelSize, weights.constData() + offset, 255, chunk);
+            optimizedMixer->accumulate(rawB + offset * Trait::pixelSize, weights.constData() + offset, 255, chunk);
+            scalarMixer->accumulateAverage(rawA + offset * Trait::pixelSize, chunk);
+            optimizedMixer->accumulateAverage(rawA + offset * Trait::pixelSize, chunk);
+        }
+
+        QCOMPARE(optimizedMixer->currentWeightsSum(), scalarMixer->currentWeightsSum());
+
+        scalarMixer->computeMixedColor(rawScalar);
+        optimizedMixer->computeMixedColor(rawOptimized);
+        QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, 1));
+    }
+
+    for (qreal weight : {0.0, 0.3, 0.5, 1.0}) {
+        scalarOp->mixTwoColorArrays(rawA, rawB, numPixels, weight, rawScalar);
+        optimizedOp->mixTwoColorArrays(rawA, rawB, numPixels, weight, rawOptimized);
+        QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, numPixels));
+
+        scalarOp->mixArrayWithColor(rawA, rawB + 7 * Trait::pixelSize, numPixels, weight, rawScalar);
+        optimizedOp->mixArrayWithColor(rawA, rawB + 7 * Trait::pixelSize, numPixels, weight, rawOptimized);
+        QVERIFY(pixelsAreEqual<channels_type>(rawScalar, rawOptimized, numPixels));
+    }
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp_data()
+{
+    QTest::addColumn<QString>("depthId");
+
+    QTest::newRow("u8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("u16") << Integer16BitsColorDepthID.id();
+#ifdef HAVE_OPENEXR
+    QTest::newRow("f16") << Float16BitsColorDepthID.id();
+#endif
+    QTest::newRow("f32") << Float32BitsColorDepthID.id();
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp()
+{
+    QFETCH(QString, depthId);
+
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        testOptimizedMixColorsOpImpl<quint8>();
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        testOptimizedMixColorsOpImpl<quint16>();
+#ifdef HAVE_OPENEXR
+    } else if (depthId == Float16BitsColorDepthID.id()) {
+        testOptimizedMixColorsOpImpl<half>();
+#endif
+    } else if (depthId == Float32BitsColorDepthID.id()) {
+        testOptimizedMixColorsOpImpl<float>();
+    }
+}
+
 void TestKoColorSpaceAbstract::testBitBltCrossColorSpaceWithChannelFlags_data()
 {
     QTest::addColumn<KoColor>("srcColor");
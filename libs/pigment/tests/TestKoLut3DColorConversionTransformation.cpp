@@ -0,0 +1,192 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoLut3DColorConversionTransformation.h"
+
+#include <simpletest.h>
+#include <testpigment.h>
+
+#include <QScopedPointer>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoLut3DColorConversionTransformation.h>
+
+#include <kis_debug.h>
+
+void TestKoLut3DColorConversionTransformation::testBakedConversion_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<float>("tolerance");
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const QString srgb = registry->p709SRGBProfile()->name();
+    const QString rec2020Linear = registry->p2020G10Profile()->name();
+    const QString rec709Linear = registry->p709G10Profile()->name();
+
+    QTest::newRow("srgb-f32 -> srgb-u8")
+        << Float32BitsColorDepthID.id() << srgb << Integer8BitsColorDepthID.id() << srgb << 1.01f / 255.0f;
+    QTest::newRow("rec709-linear-f32 -> srgb-u8")
+        << Float32BitsColorDepthID.id() << rec709Linear << Integer8BitsColorDepthID.id() << srgb << 2.01f / 255.0f;
+    QTest::newRow("rec709-linear-f32 -> srgb-u16")
+        << Float32BitsColorDepthID.id() << rec709Linear << Integer16BitsColorDepthID.id() << srgb << 2e-3f;
+    QTest::newRow("rec709-linear-f32 -> rec2020-linear-f32")
+        << Float32BitsColorDepthID.id() << rec709Linear << Float32BitsColorDepthID.id() << rec2020Linear << 2e-3f;
+}
+
+void TestKoLut3DColorConversionTransformation::testBakedConversion()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(float, tolerance);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCS = registry->colorSpace(RGBAColorModelID.id(), srcDepth, srcProfile);
+    const KoColorSpace *dstCS = registry->colorSpace(RGBAColorModelID.id(), dstDepth, dstProfile);
+    QVERIFY(srcCS);
+    QVERIFY(dstCS);
+
+    QVERIFY(KoLut3DColorConversionTransformation::canBake(srcCS, dstCS));
+
+    QScopedPointer<KoColorConversionTransformation> exact(
+        srcCS->createColorConverter(dstCS,
+                                    KoColorConversionTransformation::internalRenderingIntent(),
+                                    KoColorConversionTransformation::internalConversionFlags()));
+
+    QScopedPointer<KoColorConversionTransformation> baked(
+        KoLut3DColorConversionTransformation::tryBake(
+            srcCS->createColorConverter(dstCS,
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags())));
+
+    QVERIFY(dynamic_cast<KoLut3DColorConversionTransformation*>(baked.data()));
+
+    const int numPixels = 4096;
+
+    QByteArray srcData(numPixels * srcCS->pixelSize(), '\0');
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        // walk over the RGB cube with co-prime steps, so that the
+        // points do not coincide with the lattice nodes
+        channels[0] = float((i * 7) % 97) / 96.0f;
+        channels[1] = float((i * 13) % 89) / 88.0f;
+        channels[2] = float((i * 29) % 101) / 100.0f;
+        channels[3] = float(i % 17) / 16.0f;
+
+        srcCS->fromNormalisedChannelsValue(reinterpret_cast<quint8*>(srcData.data()) + i * srcCS->pixelSize(), channels);
+    }
+
+    QByteArray exactData(numPixels * dstCS->pixelSize(), '\0');
+    QByteArray bakedData(numPixels * dstCS->pixelSize(), '\0');
+
+    exact->transform(reinterpret_cast<const quint8*>(srcData.constData()), reinterpret_cast<quint8*>(exactData.data()), numPixels);
+    baked->transform(reinterpret_cast<const quint8*>(srcData.constData()), reinterpret_cast<quint8*>(bakedData.data()), numPixels);
+
+    QVector<float> exactChannels(4);
+    QVector<float> bakedChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(exactData.constData()) + i * dstCS->pixelSize(), exactChannels);
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(bakedData.constData()) + i * dstCS->pixelSize(), bakedChannels);
+
+        for (int ch = 0; ch < 4; ch++) {
+            if (qAbs(exactChannels[ch] - bakedChannels[ch]) > tolerance) {
+                qDebug() << "pixel" << i << "channel" << ch
+                         << "exact" << exactChannels[ch]
+                         << "baked" << bakedChannels[ch];
+                QFAIL("the baked conversion differs from the exact one");
+            }
+        }
+    }
+}
+
+void TestKoLut3DColorConversionTransformation::testHdrValuesAreNotClipped()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCS = registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p709G10Profile());
+    const KoColorSpace *dstCS = registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p2020G10Profile());
+    QVERIFY(srcCS);
+    QVERIFY(dstCS);
+
+    QScopedPointer<KoColorConversionTransformation> exact(
+        srcCS->createColorConverter(dstCS,
+                                    KoColorConversionTransformation::internalRenderingIntent(),
+                                    KoColorConversionTransformation::internalConversionFlags()));
+
+    QScopedPointer<KoColorConversionTransformation> baked(
+        KoLut3DColorConversionTransformation::tryBake(
+            srcCS->createColorConverter(dstCS,
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags())));
+
+    QVERIFY(dynamic_cast<KoLut3DColorConversionTransformation*>(baked.data()));
+
+    const float srcPixels[] = {
+        4.0f, 0.5f, 0.25f, 1.0f,
+        0.5f, 2.0f, 0.0f, 1.0f,
+        -0.1f, 0.3f, 0.6f, 0.5f
+    };
+    const int numPixels = 3;
+
+    float exactPixels[4 * numPixels];
+    float bakedPixels[4 * numPixels];
+
+    exact->transform(reinterpret_cast<const quint8*>(srcPixels), reinterpret_cast<quint8*>(exactPixels), numPixels);
+    baked->transform(reinterpret_cast<const quint8*>(srcPixels), reinterpret_cast<quint8*>(bakedPixels), numPixels);
+
+    for (int i = 0; i < 4 * numPixels; i++) {
+        QCOMPARE(bakedPixels[i], exactPixels[i]);
+    }
+
+    // the first channel of the first pixel is still out of [0, 1]
+    QVERIFY(bakedPixels[0] > 1.0f);
+}
+
+void TestKoLut3DColorConversionTransformation::testCannotBakeIntegerSource()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    QVERIFY(!KoLut3DColorConversionTransformation::canBake(registry->rgb8(), registry->rgb8()));
+    QVERIFY(!KoLut3DColorConversionTransformation::canBake(registry->rgb16(), registry->rgb8()));
+
+    KoColorConversionTransformation *transform =
+        registry->rgb16()->createColorConverter(registry->rgb8(),
+                                                KoColorConversionTransformation::internalRenderingIntent(),
+                                                KoColorConversionTransformation::internalConversionFlags());
+
+    QScopedPointer<KoColorConversionTransformation> result(KoLut3DColorConversionTransformation::tryBake(transform));
+    QCOMPARE(result.data(), transform);
+}
+
+void TestKoLut3DColorConversionTransformation::testCannotBakeNonRgb()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    QVERIFY(!KoLut3DColorConversionTransformation::canBake(registry->lab16(), registry->rgb8()));
+    const KoColorSpace *rgbF32 = registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id());
+    QVERIFY(!KoLut3DColorConversionTransformation::canBake(rgbF32, registry->alpha8()));
+
+    KoColorConversionTransformation *transform =
+        registry->lab16()->createColorConverter(registry->rgb8(),
+                                                KoColorConversionTransformation::internalRenderingIntent(),
+                                                KoColorConversionTransformation::internalConversionFlags());
+
+    QScopedPointer<KoColorConversionTransformation> result(KoLut3DColorConversionTransformation::tryBake(transform));
+    QCOMPARE(result.data(), transform);
+}
+
+KISTEST_MAIN(TestKoLut3DColorConversionTransformation)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+#define TESTKOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+
+#include <QObject>
+
+class TestKoLut3DColorConversionTransformation : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBakedConversion_data();
+    void testBakedConversion();
+    void testHdrValuesAreNotClipped();
+    void testCannotBakeIntegerSource();
+    void testCannotBakeNonRgb();
+};
+
+#endif // TESTKOLUT3DCOLORCONVERSIONTRANSFORMATION_H
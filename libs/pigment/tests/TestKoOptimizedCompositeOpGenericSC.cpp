@@ -0,0 +1,243 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "TestKoOptimizedCompositeOpGenericSC.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <simpletest.h>
+
+#include <QScopedPointer>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoBgrColorSpaceTraits.h>
+#include <KoRgbColorSpaceTraits.h>
+
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpFunctions.h>
+#include <compositeops/KoColorSpaceBlendingPolicy.h>
+#include <compositeops/KoCompositeOpClampPolicy.h>
+
+namespace {
+
+/**
+ * Creates the plain generic op (separable or HSL) the optimized one
+ * has been made from, exactly the way KoCompositeOps.h does it
+ */
+template <typename Traits>
+KoCompositeOp *createReferenceOp(const KoColorSpace *cs, const QString &id)
+{
+    using Arg = typename Traits::channels_type;
+    using Policy = KoAdditiveBlendingPolicy<Traits>;
+    const QString cat = KoCompositeOp::categoryMisc();
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfSubtract<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFHardLight<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFOverlay<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFSoftLight<Arg>, Policy>(cs, id, cat);
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoCompositeOpGenericSCFunctor<Traits, FunctorWithSDRClampPolicy<CFColorDodge, Arg>, Policy>(cs, id, cat);
+    }
+
+    if (id == COMPOSITE_COLOR) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFColor<HSYType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_HUE) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFHue<HSYType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_SATURATION) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFSaturation<HSYType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_LUMINIZE) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFLightness<HSYType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_COLOR_HSI) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFColor<HSIType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_HUE_HSI) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFHue<HSIType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_SATURATION_HSI) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFSaturation<HSIType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_INTENSITY) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFLightness<HSIType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_COLOR_HSL) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFColor<HSLType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_HUE_HSL) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFHue<HSLType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_SATURATION_HSL) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFSaturation<HSLType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_LIGHTNESS) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFLightness<HSLType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_COLOR_HSV) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFColor<HSVType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_HUE_HSV) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFHue<HSVType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_SATURATION_HSV) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFSaturation<HSVType, Arg>>(cs, id, cat);
+    } else if (id == COMPOSITE_VALUE) {
+        return new KoCompositeOpGenericHSLFunctor<Traits, CFLightness<HSVType, Arg>>(cs, id, cat);
+    }
+
+    return nullptr;
+}
+
+template <typename channels_type>
+void fillRandom(std::vector<channels_type> &pixels, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> dist(0, std::numeric_limits<channels_type>::max());
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = dist(rng);
+    }
+
+    // make sure the edge cases of the alpha channel are covered
+    pixels[3] = 0;
+    pixels[7] = std::numeric_limits<channels_type>::max();
+}
+
+template <>
+void fillRandom<float>(std::vector<float> &pixels, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = dist(rng);
+    }
+
+    pixels[3] = 0.0f;
+    pixels[7] = 1.0f;
+}
+
+template <typename Traits>
+void checkAgainstReference(const KoColorSpace *cs, const QString &id, qreal tolerance)
+{
+    using channels_type = typename Traits::channels_type;
+
+    const KoCompositeOp *op = cs->compositeOp(id);
+    QVERIFY(op);
+    QCOMPARE(op->id(), id);
+
+    QScopedPointer<KoCompositeOp> refOp(createReferenceOp<Traits>(cs, id));
+    QVERIFY(refOp);
+
+    // an odd number of columns makes sure both the vectorized
+    // body and the scalar tail of every row are exercised
+    const int cols = 67;
+    const int rows = 3;
+    const int channels = rows * cols * 4;
+
+    std::mt19937 rng(42);
+    std::vector<channels_type> src(channels);
+    std::vector<channels_type> dst(channels);
+    std::vector<quint8> mask(rows * cols);
+
+    fillRandom(src, rng);
+    fillRandom(dst, rng);
+
+    std::uniform_int_distribution<int> maskDist(0, 255);
+    for (auto &value : mask) {
+        value = maskDist(rng);
+    }
+
+    for (int useMask = 0; useMask <= 1; useMask++) {
+        for (int useSrcStride = 0; useSrcStride <= 1; useSrcStride++) {
+            std::vector<channels_type> optimizedDst(dst);
+            std::vector<channels_type> referenceDst(dst);
+
+            KoCompositeOp::ParameterInfo params;
+            params.dstRowStride = cols * cs->pixelSize();
+            params.srcRowStart = reinterpret_cast<const quint8*>(src.data());
+            params.srcRowStride = useSrcStride ? cols * cs->pixelSize() : 0;
+            params.maskRowStart = useMask ? mask.data() : nullptr;
+            params.maskRowStride = useMask ? cols : 0;
+            params.rows = rows;
+            params.cols = cols;
+            params.opacity = 0.8f;
+            params.flow = 1.0f;
+
+            params.dstRowStart = reinterpret_cast<quint8*>(optimizedDst.data());
+            op->composite(params);
+
+            params.dstRowStart = reinterpret_cast<quint8*>(referenceDst.data());
+            refOp->composite(params);
+
+            for (int i = 0; i < channels; i++) {
+                const qreal difference = qAbs(qreal(optimizedDst[i]) - qreal(referenceDst[i]));
+                if (difference > tolerance) {
+                    qWarning() << "Mismatch in" << id << "channel" << i
+                               << "mask" << useMask << "srcStride" << useSrcStride
+                               << "optimized" << optimizedDst[i]
+                               << "reference" << referenceDst[i];
+                    QFAIL("optimized op differs from the generic one");
+                }
+            }
+        }
+    }
+}
+
+}
+
+void TestKoOptimizedCompositeOpGenericSC::testMatchesGenericOp_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<QString>("compositeOpId");
+
+    const QStringList ids({COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_DARKEN,
+                           COMPOSITE_LIGHTEN, COMPOSITE_DIFF, COMPOSITE_ADD,
+                           COMPOSITE_SUBTRACT, COMPOSITE_HARD_LIGHT, COMPOSITE_OVERLAY,
+                           COMPOSITE_SOFT_LIGHT_PHOTOSHOP, COMPOSITE_DODGE,
+                           COMPOSITE_COLOR, COMPOSITE_HUE, COMPOSITE_SATURATION, COMPOSITE_LUMINIZE,
+                           COMPOSITE_COLOR_HSI, COMPOSITE_HUE_HSI, COMPOSITE_SATURATION_HSI, COMPOSITE_INTENSITY,
+                           COMPOSITE_COLOR_HSL, COMPOSITE_HUE_HSL, COMPOSITE_SATURATION_HSL, COMPOSITE_LIGHTNESS,
+                           COMPOSITE_COLOR_HSV, COMPOSITE_HUE_HSV, COMPOSITE_SATURATION_HSV, COMPOSITE_VALUE});
+
+    const QStringList depths({Integer8BitsColorDepthID.id(),
+                              Integer16BitsColorDepthID.id(),
+                              Float32BitsColorDepthID.id()});
+
+    Q_FOREACH (const QString &depth, depths) {
+        Q_FOREACH (const QString &id, ids) {
+            QTest::addRow("%s_%s", depth.toLatin1().data(), id.toLatin1().data()) << depth << id;
+        }
+    }
+}
+
+void TestKoOptimizedCompositeOpGenericSC::testMatchesGenericOp()
+{
+    QFETCH(QString, depthId);
+    QFETCH(QString, compositeOpId);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, QString());
+    QVERIFY(cs);
+
+    /**
+     * The optimized ops do all the math in floating point, so the integer
+     * color spaces may differ from the generic ops by a couple of LSBs
+     */
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        checkAgainstReference<KoBgrU8Traits>(cs, compositeOpId, 2.0);
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        checkAgainstReference<KoBgrU16Traits>(cs, compositeOpId, 3.0);
+    } else {
+        checkAgainstReference<KoRgbF32Traits>(cs, compositeOpId, 1e-4);
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKoOptimizedCompositeOpGenericSC)
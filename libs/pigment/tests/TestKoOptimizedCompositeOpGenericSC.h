@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef TESTKOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+#define TESTKOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+
+#include <QObject>
+
+class TestKoOptimizedCompositeOpGenericSC : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMatchesGenericOp_data();
+    void testMatchesGenericOp();
+};
+
+#endif // TESTKOOPTIMIZEDCOMPOSITEOPGENERICSC_H
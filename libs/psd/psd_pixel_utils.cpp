@@ -298,7 +298,7 @@ void readAlphaMaskPixelCommon(int channelSize, const QMap<quint16, QByteArray> &
     }
 }
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int row, int width, int channelSize, bool processMasks)
+QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int firstRow, int numRows, int width, int channelSize, bool processMasks)
 {
     const int uncompressedLength = width * channelSize;
 
@@ -312,12 +312,21 @@ QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo
         io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
 
         if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io.read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
+            channelBytes[channelInfo->channelId] = io.read(qint64(uncompressedLength) * numRows);
+            channelInfo->channelOffset += qint64(uncompressedLength) * numRows;
         } else if (channelInfo->compressionType == psd_compression_type::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io.read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
+            qint64 rleLength = 0;
+            for (int row = firstRow; row < firstRow + numRows; row++) {
+                rleLength += channelInfo->rleRowLengths.value(row);
+            }
+
+            const QByteArray compressedBytes = io.read(rleLength);
+            QByteArray uncompressedBytes(uncompressedLength * numRows, Qt::Uninitialized);
+
+            if (!Compression::uncompressRowsRLE(compressedBytes, channelInfo->rleRowLengths, firstRow, numRows, uncompressedLength, uncompressedBytes.data())) {
+                dbgFile << "WARNING: fetchChannelsBytes: corrupted RLE data in channel" << channelInfo->channelId << "rows" << firstRow << "-" << firstRow + numRows - 1;
+            }
+
             channelBytes.insert(channelInfo->channelId, uncompressedBytes);
             channelInfo->channelOffset += rleLength;
         } else {
@@ -383,21 +392,39 @@ void readCommon(KisPaintDeviceSP dev,
         }
 
     } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
+        /**
+         * The rows are fetched in blocks, so that the RLE rows of
+         * every block could be decompressed in parallel
+         */
+        const int rowSize = layerRect.width() * channelSize;
+        const int rowsPerBlock = qBound(1, (4 * 1024 * 1024) / rowSize, layerRect.height());
 
-            channelBytes = fetchChannelsBytes(io, infoRecords, i, layerRect.width(), channelSize, processMasks);
-
-            for (int col = 0; col < layerRect.width(); col++) {
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
-            }
-
-            /// don't write-access the row right after the
-            /// the end of the read area
-            if (i < layerRect.height() - 1) {
-                it->nextRow();
+        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
+        for (int firstRow = 0; firstRow < layerRect.height(); firstRow += rowsPerBlock) {
+            const int numRows = qMin(rowsPerBlock, layerRect.height() - firstRow);
+
+            const QMap<quint16, QByteArray> blockBytes =
+                fetchChannelsBytes(io, infoRecords, firstRow, numRows, layerRect.width(), channelSize, processMasks);
+
+            for (int blockRow = 0; blockRow < numRows; blockRow++) {
+                QMap<quint16, QByteArray> channelBytes;
+
+                for (auto channelIt = blockBytes.constBegin(); channelIt != blockBytes.constEnd(); ++channelIt) {
+                    channelBytes.insert(channelIt.key(),
+                                        QByteArray::fromRawData(channelIt.value().constData() + qint64(blockRow) * rowSize,
+                                                                qMax(0, qMin(rowSize, channelIt.value().size() - blockRow * rowSize))));
+                }
+
+                for (int col = 0; col < layerRect.width(); col++) {
+                    pixelFunc(channelSize, channelBytes, col, it->rawData());
+                    it->nextPixel();
+                }
+
+                /// don't write-access the row right after the
+                /// the end of the read area
+                if (firstRow + blockRow < layerRect.height() - 1) {
+                    it->nextRow();
+                }
             }
         }
     }
@@ -514,9 +541,11 @@ void writeChannelDataRLEImpl(QIODevice &io,
     }
 
     const int stride = channelSize * rc.width();
+    const QVector<QByteArray> compressedRows =
+        Compression::compressRowsRLE(reinterpret_cast<const char *>(plane), stride, rc.height());
+
     for (qint32 row = 0; row < rc.height(); ++row) {
-        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, psd_compression_type::RLE);
+        const QByteArray &compressed = compressedRows[row];
 
         KisAslWriterUtils::OffsetStreamPusher<quint16, byteOrder> rleExternalTag(io, 0, channelRLESizePos + row * static_cast<qint64>(sizeof(quint16)));
 
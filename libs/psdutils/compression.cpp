@@ -10,8 +10,11 @@
 #include "compression.h"
 
 #include <QBuffer>
+#include <QtAlgorithms>
+#include <QtConcurrent>
 #include <QtEndian>
 #include <algorithm>
+#include <cstring>
 #include <zlib.h>
 
 #include <kis_debug.h>
@@ -19,29 +22,47 @@
 
 namespace KisRLE
 {
-// from gimp's psd-save.c
-int compress(const QByteArray &src, QByteArray &dst)
+/**
+ * Returns the number of the bytes equal to the first one in
+ * [start, start + limit). The run is checked 8 bytes at a time.
+ */
+inline int runLength(const char *start, int limit)
 {
-    int length = src.size();
-    dst.resize(length * 2);
-    dst.fill(0, length * 2);
+    const quint64 pattern = quint64(static_cast<quint8>(start[0])) * Q_UINT64_C(0x0101010101010101);
 
-    int remaining = length;
-    quint8 i, j;
-    quint32 dest_ptr = 0;
-    const char *start = src.constData();
+    int i = 1;
+    while (i + 8 <= limit) {
+        quint64 word;
+        memcpy(&word, start + i, sizeof(word));
+
+        const quint64 diff = qFromLittleEndian(word) ^ pattern;
+        if (diff) {
+            return i + qCountTrailingZeroBits(diff) / 8;
+        }
+        i += 8;
+    }
+
+    while (i < limit && start[i] == start[0]) {
+        i++;
+    }
+
+    return i;
+}
+
+// from gimp's psd-save.c
+int compress(const char *start, int remaining, char *dst)
+{
+    int length = 0;
+    char *dest_ptr = dst;
 
-    length = 0;
     while (remaining > 0) {
         /* Look for characters matching the first */
-        i = 0;
-        while ((i < 128) && (remaining - i > 0) && (start[0] == start[i]))
-            i++;
+        int i = runLength(start, qMin(128, remaining));
 
         if (i > 1) /* Match found */
         {
-            dst[dest_ptr++] = static_cast<char>(-(i - 1));
-            dst[dest_ptr++] = *start;
+            *dest_ptr++ = static_cast<char>(-(i - 1));
+            *dest_ptr++ = *start;
 
             start += i;
             remaining -= i;
@@ -60,16 +81,23 @@ int compress(const QByteArray &src, QByteArray &dst)
 
             if (i > 0) /* Some distinct ones found */
             {
-                dst[dest_ptr++] = static_cast<char>(i - 1U);
-                for (j = 0; j < i; j++) {
-                    dst[dest_ptr++] = start[j];
-                }
+                *dest_ptr++ = static_cast<char>(i - 1U);
+                memcpy(dest_ptr, start, static_cast<size_t>(i));
+                dest_ptr += i;
+
                 start += i;
                 remaining -= i;
                 length += i + 1;
             }
         }
     }
+    return length;
+}
+
+int compress(const QByteArray &src, QByteArray &dst)
+{
+    dst.resize(src.size() * 2);
+    const int length = compress(src.constData(), src.size(), dst.data());
     dst.resize(length);
     return length;
 }
@@ -84,41 +112,40 @@ QByteArray compress(const QByteArray &data)
         return output;
 }
 
-QByteArray decompress(const QByteArray &input, int unpacked_len)
+bool decompress(const char *input, int packed_len, char *output, int unpacked_len)
 {
-    QByteArray output;
-    output.resize(unpacked_len);
+    const char *src = input;
+    const char *const srcEnd = input + packed_len;
+    char *dst = output;
+    char *const dstEnd = output + unpacked_len;
 
-    const auto *src = input.cbegin();
-    auto *dst = output.begin();
-
-    while (src < input.end() && dst < output.end()) {
+    while (src < srcEnd && dst < dstEnd) {
         // NOLINTNEXTLINE(*-reinterpret-cast,readability-identifier-length)
         const int8_t n = *reinterpret_cast<const int8_t *>(src);
         src += 1;
 
         if (n >= 0) { // copy next n+1 chars
             const int bytes = 1 + n;
-            if (src + bytes > input.cend()) {
-                errFile << "Input buffer exhausted in replicate of" << bytes << "chars, left" << (input.cend() - src);
-                return {};
+            if (src + bytes > srcEnd) {
+                errFile << "Input buffer exhausted in replicate of" << bytes << "chars, left" << (srcEnd - src);
+                return false;
             }
-            if (dst + bytes > output.end()) {
-                errFile << "Overrun in packbits replicate of" << bytes << "chars, left" << (output.end() - dst);
-                return {};
+            if (dst + bytes > dstEnd) {
+                errFile << "Overrun in packbits replicate of" << bytes << "chars, left" << (dstEnd - dst);
+                return false;
             }
             std::copy_n(src, bytes, dst);
             src += bytes;
             dst += bytes;
         } else if (n >= -127 && n <= -1) { // replicate next char -n+1 times
             const int bytes = 1 - n;
-            if (src >= input.cend()) {
+            if (src >= srcEnd) {
                 errFile << "Input buffer exhausted in copy";
-                return {};
+                return false;
             }
-            if (dst + bytes > output.end()) {
-                errFile << "Output buffer exhausted in copy of" << bytes << "chars, left" << (output.end() - dst);
-                return {};
+            if (dst + bytes > dstEnd) {
+                errFile << "Output buffer exhausted in copy of" << bytes << "chars, left" << (dstEnd - dst);
+                return false;
             }
             const auto byte = *src;
             std::fill_n(dst, bytes, byte);
@@ -129,21 +156,52 @@ QByteArray decompress(const QByteArray &input, int unpacked_len)
         }
     }
 
-    if (dst < output.end()) {
-        errFile << "Packbits decode - unpack left" << (output.end() - dst);
-        std::fill(dst, output.end(), 0);
+    if (dst < dstEnd) {
+        errFile << "Packbits decode - unpack left" << (dstEnd - dst);
+        std::fill(dst, dstEnd, 0);
     }
 
     // If the input line was odd width, there's a padding byte
-    if (src + 1 < input.cend()) {
-        QByteArray leftovers;
-        leftovers.resize(static_cast<int>(input.cend() - src));
-        std::copy(src, input.cend(), leftovers.begin());
+    if (src + 1 < srcEnd) {
+        const QByteArray leftovers = QByteArray::fromRawData(src, static_cast<int>(srcEnd - src));
         errFile << "Packbits decode - pack left" << leftovers.size() << leftovers.toHex();
     }
 
+    return true;
+}
+
+QByteArray decompress(const QByteArray &input, int unpacked_len)
+{
+    QByteArray output;
+    output.resize(unpacked_len);
+
+    if (!decompress(input.constData(), input.size(), output.data(), unpacked_len)) {
+        return {};
+    }
+
     return output;
 }
+
+/**
+ * The rows are split into blocks to give every worker thread
+ * a noticeable amount of work
+ */
+struct RowBlock {
+    int firstRow = 0;
+    int numRows = 0;
+};
+
+QVector<RowBlock> splitRows(int numRows, int rowSize)
+{
+    const int minBlockSize = 64 * 1024;
+    const int rowsPerBlock = qMax(1, minBlockSize / qMax(1, rowSize));
+
+    QVector<RowBlock> blocks;
+    for (int row = 0; row < numRows; row += rowsPerBlock) {
+        blocks.append({row, qMin(rowsPerBlock, numRows - row)});
+    }
+    return blocks;
+}
 } // namespace KisRLE
 
 namespace KisZip
@@ -414,3 +472,69 @@ QByteArray Compression::compress(QByteArray bytes, psd_compression_type compress
 
     return QByteArray();
 }
+
+
+QVector<QByteArray> Compression::compressRowsRLE(const char *plane, int rowSize, int numRows)
+{
+    QVector<QByteArray> rows(numRows);
+    if (rowSize <= 0) return rows;
+
+    QVector<KisRLE::RowBlock> blocks = KisRLE::splitRows(numRows, rowSize);
+
+    auto compressBlock = [plane, rowSize, &rows] (const KisRLE::RowBlock &block) {
+        for (int row = block.firstRow; row < block.firstRow + block.numRows; row++) {
+            QByteArray &dst = rows[row];
+            dst.resize(rowSize * 2);
+            const int length = KisRLE::compress(plane + qint64(row) * rowSize, rowSize, dst.data());
+            dst.resize(length);
+        }
+    };
+
+    if (blocks.size() > 1) {
+        QtConcurrent::blockingMap(blocks, compressBlock);
+    } else {
+        std::for_each(blocks.begin(), blocks.end(), compressBlock);
+    }
+
+    return rows;
+}
+
+bool Compression::uncompressRowsRLE(const QByteArray &bytes, const QVector<quint32> &rowLengths, int firstRow, int numRows, int rowSize, char *dst)
+{
+    if (firstRow < 0 || firstRow + numRows > rowLengths.size()) return false;
+
+    QVector<qint64> rowOffsets(numRows + 1);
+    rowOffsets[0] = 0;
+    for (int i = 0; i < numRows; i++) {
+        rowOffsets[i + 1] = rowOffsets[i] + rowLengths[firstRow + i];
+    }
+
+    if (rowOffsets[numRows] > bytes.size()) {
+        errFile << "Not enough RLE data for" << numRows << "rows:" <<  bytes.size() << "of" << rowOffsets[numRows];
+        return false;
+    }
+
+    QVector<KisRLE::RowBlock> blocks = KisRLE::splitRows(numRows, rowSize);
+    QAtomicInt failed(0);
+
+    auto uncompressBlock = [&bytes, &rowOffsets, rowSize, dst, &failed] (const KisRLE::RowBlock &block) {
+        for (int row = block.firstRow; row < block.firstRow + block.numRows; row++) {
+            char *dstRow = dst + qint64(row) * rowSize;
+
+            if (!KisRLE::decompress(bytes.constData() + rowOffsets[row],
+                                    static_cast<int>(rowOffsets[row + 1] - rowOffsets[row]),
+                                    dstRow, rowSize)) {
+                std::fill_n(dstRow, rowSize, 0);
+                failed.storeRelaxed(1);
+            }
+        }
+    };
+
+    if (blocks.size() > 1) {
+        QtConcurrent::blockingMap(blocks, uncompressBlock);
+    } else {
+        std::for_each(blocks.begin(), blocks.end(), uncompressBlock);
+    }
+
+    return !failed.loadRelaxed();
+}
@@ -10,6 +10,7 @@
 #include "kritapsdutils_export.h"
 
 #include <QByteArray>
+#include <QVector>
 #include <psd.h>
 
 class KRITAPSDUTILS_EXPORT Compression
@@ -17,6 +18,23 @@ class KRITAPSDUTILS_EXPORT Compression
 public:
     static QByteArray uncompress(int unpacked_len, QByteArray bytes, psd_compression_type compressionType, int row_size = 0, int color_depth = 0);
     static QByteArray compress(QByteArray bytes, psd_compression_type compressionType, int row_size = 0, int color_depth = 0);
+
+    /**
+     * Compresses every row of \p plane separately with PackBits, as
+     * the PSD channel data requires. The rows are compressed in parallel.
+     */
+    static QVector<QByteArray> compressRowsRLE(const char *plane, int rowSize, int numRows);
+
+    /**
+     * Decompresses \p numRows PackBits rows starting at \p firstRow into
+     * \p dst, \p rowSize bytes each. \p bytes contains the compressed
+     * rows one after another, their sizes are taken from \p rowLengths.
+     * The rows are decompressed in parallel.
+     *
+     * @return false if any of the rows is corrupted. The corrupted rows
+     *         are filled with zeroes.
+     */
+    static bool uncompressRowsRLE(const QByteArray &bytes, const QVector<quint32> &rowLengths, int firstRow, int numRows, int rowSize, char *dst);
 };
 
 #endif // PSD_COMPRESSION_H
@@ -41,6 +41,55 @@ void CompressionTest::testCompressionRLE()
     QVERIFY(qstrcmp(ba, uncompressed) == 0);
 }
 
+void CompressionTest::testCompressionRowsRLE()
+{
+    const int rowSize = 1000;
+    const int numRows = 500;
+
+    QByteArray plane(rowSize * numRows, '\0');
+    for (int row = 0; row < numRows; ++row) {
+        char *rowPtr = plane.data() + row * rowSize;
+        for (int i = 0; i < rowSize; ++i) {
+            // mix the runs of equal bytes with the noise
+            rowPtr[i] = (i / 37) % 2 ? char(row) : char(rand());
+        }
+    }
+
+    const QVector<QByteArray> compressedRows = Compression::compressRowsRLE(plane.constData(), rowSize, numRows);
+    QCOMPARE(compressedRows.size(), numRows);
+
+    QByteArray compressed;
+    QVector<quint32> rowLengths;
+
+    for (int row = 0; row < numRows; ++row) {
+        const QByteArray uncompressedRow = plane.mid(row * rowSize, rowSize);
+        QCOMPARE(compressedRows[row], Compression::compress(uncompressedRow, psd_compression_type::RLE));
+
+        compressed.append(compressedRows[row]);
+        rowLengths.append(compressedRows[row].size());
+    }
+
+    QByteArray uncompressed(plane.size(), '\0');
+    QVERIFY(Compression::uncompressRowsRLE(compressed, rowLengths, 0, numRows, rowSize, uncompressed.data()));
+    QCOMPARE(uncompressed, plane);
+
+    // decompress a block in the middle of the channel
+    const int firstRow = 100;
+    const int numBlockRows = 50;
+
+    int offset = 0;
+    for (int row = 0; row < firstRow; ++row) {
+        offset += rowLengths[row];
+    }
+
+    QByteArray block(numBlockRows * rowSize, '\0');
+    QVERIFY(Compression::uncompressRowsRLE(compressed.mid(offset), rowLengths, firstRow, numBlockRows, rowSize, block.data()));
+    QCOMPARE(block, plane.mid(firstRow * rowSize, numBlockRows * rowSize));
+
+    // truncated data is reported as an error
+    QVERIFY(!Compression::uncompressRowsRLE(compressed.left(compressed.size() / 2), rowLengths, 0, numRows, rowSize, uncompressed.data()));
+}
+
 void CompressionTest::testCompressionZIP()
 {
     QByteArray ba("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
@@ -10,6 +10,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDirIterator>
+#include <QCryptographicHash>
 
 #include <KisTag.h>
 #include "KisResourceStorage.h"
@@ -163,6 +164,20 @@ QString KisBundleStorage::resourceMd5(const QString &url)
     return result;
 }
 
+QString KisBundleStorage::fingerprint() const
+{
+    const QFileInfo fi(location());
+    if (!fi.exists()) return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(QString("%1:%2").arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).toUtf8());
+
+    // the resources modified by the user are stored next to the bundle
+    addFolderToFingerprint(location() + "_modified", hash);
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
 QSharedPointer<KisResourceStorage::ResourceIterator> KisBundleStorage::resources(const QString &resourceType)
 {
     QVector<VersionedResourceEntry> entries;
@@ -26,6 +26,7 @@ public:
     /// Note: this should find resources in a folder that override a resource in the bundle first
     bool loadVersionedResource(KoResourceSP resource) override;
     QString resourceMd5(const QString &url) override;
+    QString fingerprint() const override;
     QSharedPointer<KisResourceStorage::ResourceIterator> resources(const QString &resourceType) override;
     QSharedPointer<KisResourceStorage::TagIterator> tags(const QString &resourceType) override;
     QImage thumbnail() const override;
@@ -7,6 +7,7 @@
 #include "KisFolderStorage.h"
 
 #include <QDirIterator>
+#include <QCryptographicHash>
 #include <KisMimeDatabase.h>
 #include <kis_debug.h>
 #include <KisTag.h>
@@ -142,6 +143,23 @@ QString KisFolderStorage::resourceMd5(const QString &url)
     return result;
 }
 
+QString KisFolderStorage::fingerprint() const
+{
+    /**
+     * Only the resource type subfolders are taken into account: the
+     * resource folder also contains the database and the bundles, which
+     * change independently of the folder's resources.
+     */
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    Q_FOREACH (const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
+        hash.addData(resourceType.toUtf8());
+        addFolderToFingerprint(location() + "/" + resourceType, hash);
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
 QString KisFolderStorage::resourceFilePath(const QString &url)
 {
     QFileInfo file(location() + "/" + url);
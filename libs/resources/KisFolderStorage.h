@@ -40,6 +40,8 @@ public:
 
     QString resourceMd5(const QString &url) override;
     QString resourceFilePath(const QString &url) override;
+
+    QString fingerprint() const override;
 private:
     friend class FolderIterator;
 
@@ -19,6 +19,7 @@
 #include <QDataStream>
 #include <QByteArray>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 #include <KritaVersionWrapper.h>
 
@@ -42,8 +43,15 @@ const QString dbDriver = "QSQLITE";
 const QString METADATA_RESOURCES = "resources";
 const QString METADATA_STORAGES = "storages";
 
+// the table came in version 0.0.19
+const QString createStorageFingerprintsTable =
+    "CREATE TABLE IF NOT EXISTS storage_fingerprints (\n"
+    "    storage_id INTEGER PRIMARY KEY NOT NULL\n"
+    ",   fingerprint TEXT NOT NULL\n"
+    ");";
+
 const QString KisResourceCacheDb::resourceCacheDbFilename { "resourcecache.sqlite" };
-const QString KisResourceCacheDb::databaseVersion { "0.0.18" };
+const QString KisResourceCacheDb::databaseVersion { "0.0.19" };
 QStringList KisResourceCacheDb::storageTypes { QStringList() };
 QStringList KisResourceCacheDb::disabledBundles { QStringList() << "Krita_3_Default_Resources.bundle" };
 
@@ -139,6 +147,14 @@ QSqlError runUpdateScript(const QString &script, const QString &message)
     return QSqlError();
 }
 
+void executePragma(const QString &pragma)
+{
+    QSqlQuery q;
+    if (!q.exec(pragma)) {
+        qWarning() << "Could not execute" << pragma << q.lastError();
+    }
+}
+
 QSqlError createDatabase(const QString &location)
 {
     // NOTE: if the id's of Unknown and Memory in the database
@@ -180,6 +196,16 @@ QSqlError createDatabase(const QString &location)
             warnDbMigration << "Could not connect to resource cache database";
             return db.lastError();
         }
+
+        /**
+         * Several instances of Krita (e.g. the headless ones of a batch
+         * job) may share the database. In WAL mode the readers don't block
+         * the writer and vice versa, so the instances don't fail on the
+         * locks while one of them synchronizes the storages. The journal
+         * mode is persistent, it is stored in the database file itself.
+         */
+        executePragma("PRAGMA journal_mode = WAL");
+        executePragma("PRAGMA synchronous = NORMAL");
     } else {
         db = QSqlDatabase::database();
     }
@@ -249,11 +275,14 @@ QSqlError createDatabase(const QString &location)
                 infoDbMigration << "Old schema:" << schemaVersion << "New schema:" << newSchemaVersionNumber;
 
                 schemaIsOutDated = true;
+
+                // move all the changes from the WAL file into the database before backing it up
+                executePragma("PRAGMA wal_checkpoint(TRUNCATE)");
                 KisBackup::numberedBackupFile(location + "/" + KisResourceCacheDb::resourceCacheDbFilename);
 
-                if (newSchemaVersionNumber == QVersionNumber::fromString("0.0.18")
+                if (newSchemaVersionNumber == QVersionNumber::fromString("0.0.19")
                         && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.14")) >= 0
-                        && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.18")) < 0) {
+                        && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.19")) < 0) {
 
                     bool from14to15 = oldSchemaVersionNumber == QVersionNumber::fromString("0.0.14");
 
@@ -269,6 +298,9 @@ QSqlError createDatabase(const QString &location)
                             || oldSchemaVersionNumber == QVersionNumber::fromString("0.0.16")
                             || oldSchemaVersionNumber == QVersionNumber::fromString("0.0.17");
 
+                    bool from18to19 = from17to18
+                            || oldSchemaVersionNumber == QVersionNumber::fromString("0.0.18");
+
                     KisDatabaseTransactionLock transactionLock(QSqlDatabase::database());
 
                     bool success = true;
@@ -327,6 +359,14 @@ QSqlError createDatabase(const QString &location)
                         }
                     }
 
+                    if (success && from18to19) {
+                        QSqlError error = runUpdateScript(createStorageFingerprintsTable,
+                                                          "Create storage fingerprints table");
+                        if (error.type() != QSqlError::NoError) {
+                            success = false;
+                        }
+                    }
+
                     if (success) {
                         if (!updateSchemaVersion()) {
                             success = false;
@@ -421,6 +461,15 @@ QSqlError createDatabase(const QString &location)
         }
     }
 
+    {
+        // storage fingerprints table came in version 0.0.19
+        QSqlError error = runUpdateScript(createStorageFingerprintsTable,
+                                          "Create table storage_fingerprints");
+        if (error.type() != QSqlError::NoError) {
+            return error;
+        }
+    }
+
     // Fill lookup tables
     {
         QFile f(":/fill_storage_types.sql");
@@ -1178,11 +1227,141 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
     return true;
 
 
+}
+
+namespace {
+
+/**
+ * Calculates md5 sums of the resources at \p urls concurrently.
+ *
+ * Folder and bundle storages open a separate file (or zip store) for
+ * every request, so hashing is safe to do in the thread pool. For other
+ * storage types an empty hash is returned and the sums are calculated
+ * on demand.
+ *
+ * Note that the resources themselves are still loaded in the calling
+ * thread: some loaders (e.g. paintop presets) resolve their linked
+ * resources through the database, whose connection is bound to the
+ * thread that opened it.
+ */
+QHash<QString, QString> calculateResourceMd5s(KisResourceStorageSP storage, const QStringList &urls)
+{
+    QHash<QString, QString> result;
+
+    if (storage->type() != KisResourceStorage::StorageType::Folder &&
+        storage->type() != KisResourceStorage::StorageType::Bundle) {
+
+        return result;
+    }
+
+    struct Entry {
+        QString url;
+        QString md5;
+    };
+
+    QVector<Entry> entries;
+    entries.reserve(urls.size());
+    Q_FOREACH (const QString &url, urls) {
+        entries.append({url, QString()});
+    }
+
+    QtConcurrent::blockingMap(entries, [storage] (Entry &entry) {
+        entry.md5 = storage->resourceMd5(entry.url);
+    });
+
+    result.reserve(entries.size());
+    for (const Entry &entry : entries) {
+        result.insert(entry.url, entry.md5);
+    }
+
+    return result;
+}
+
+QString cachedResourceMd5(KisResourceStorageSP storage, const QHash<QString, QString> &md5s, const QString &url)
+{
+    auto it = md5s.constFind(url);
+    return it != md5s.constEnd() ? *it : storage->resourceMd5(url);
+}
+
+/**
+ * The fingerprint of the storage's files extended with the things that
+ * change the result of the synchronization even for the same files:
+ * Krita version and the set of the registered resource types. Empty
+ * if the storage doesn't support fingerprints.
+ */
+QString storageSynchronizationFingerprint(KisResourceStorageSP storage)
+{
+    const QString fingerprint = storage->fingerprint();
+    if (fingerprint.isEmpty()) return fingerprint;
+
+    return KritaVersionWrapper::versionString() + ";" +
+        KisResourceLoaderRegistry::instance()->resourceTypes().join(',') + ";" +
+        fingerprint;
+}
+
+QString loadStorageFingerprint(int storageId)
+{
+    QSqlQuery q;
+    if (!q.prepare("SELECT fingerprint\n"
+                   "FROM   storage_fingerprints\n"
+                   "WHERE  storage_id = :storage_id\n")) {
+        qWarning() << "Could not prepare storage fingerprint query" << q.lastError();
+        return QString();
+    }
+
+    q.bindValue(":storage_id", storageId);
+
+    if (!q.exec()) {
+        qWarning() << "Could not execute storage fingerprint query" << q.boundValues() << q.lastError();
+        return QString();
+    }
+
+    return q.first() ? q.value(0).toString() : QString();
+}
+
+bool saveStorageFingerprint(int storageId, const QString &fingerprint)
+{
+    QSqlQuery q;
+    if (!q.prepare("INSERT OR REPLACE INTO storage_fingerprints\n"
+                   "(storage_id, fingerprint)\n"
+                   "VALUES\n"
+                   "(:storage_id, :fingerprint)\n")) {
+        qWarning() << "Could not prepare update storage fingerprint query" << q.lastError();
+        return false;
+    }
+
+    q.bindValue(":storage_id", storageId);
+    q.bindValue(":fingerprint", fingerprint);
+
+    if (!q.exec()) {
+        qWarning() << "Could not execute update storage fingerprint query" << q.boundValues() << q.lastError();
+        return false;
+    }
+
+    return true;
+}
+
 }
 
 bool KisResourceCacheDb::addResources(KisResourceStorageSP storage, QString resourceType)
 {
-    QSqlDatabase::database().transaction();
+    QStringList urls;
+
+    {
+        QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
+        while (iter->hasNext()) {
+            iter->next();
+
+            QSharedPointer<KisResourceStorage::ResourceIterator> verIt = iter->versions();
+            while (verIt->hasNext()) {
+                verIt->next();
+                urls.append(verIt->url());
+            }
+        }
+    }
+
+    const QHash<QString, QString> md5s = calculateResourceMd5s(storage, urls);
+
     QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
     while (iter->hasNext()) {
         iter->next();
@@ -1198,7 +1377,7 @@ bool KisResourceCacheDb::addResources(KisResourceStorageSP storage, QString reso
             KoResourceSP resource = verIt->resource();
             if (resource && resource->valid()) {
                 resource->setVersion(verIt->guessedVersion());
-                resource->setMD5Sum(storage->resourceMd5(verIt->url()));
+                resource->setMD5Sum(cachedResourceMd5(storage, md5s, verIt->url()));
 
                 if (resourceId < 0) {
                     if (addResource(storage, iter->lastModified(), resource, iter->type())) {
@@ -1214,7 +1393,6 @@ bool KisResourceCacheDb::addResources(KisResourceStorageSP storage, QString reso
             }
         }
     }
-    QSqlDatabase::database().commit();
     return true;
 }
 
@@ -1670,6 +1848,15 @@ bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstal
         }
     }
 
+    /// Calculate the fingerprint before reading the resources, so that
+    /// the changes made while reading are picked up on the next start
+    const QString fingerprint = storageSynchronizationFingerprint(storage);
+
+    /// Add the resources of all the types in a single transaction,
+    /// SQLite is much faster this way
+
+    QSqlDatabase::database().transaction();
+
     Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
         if (!KisResourceCacheDb::addResources(storage, resourceType)) {
             qWarning() << "Failed to add all resources for storage" << storage;
@@ -1677,6 +1864,12 @@ bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstal
         }
     }
 
+    if (r && !fingerprint.isEmpty() && storage->storageId() >= 0) {
+        saveStorageFingerprint(storage->storageId(), fingerprint);
+    }
+
+    QSqlDatabase::database().commit();
+
     return r;
 }
 
@@ -1778,6 +1971,17 @@ bool KisResourceCacheDb::deleteStorage(QString location)
             loader.exec();
         }
 
+        {
+            KisSqlQueryLoader loader("inline://delete_storage_fingerprint",
+                                     "DELETE FROM storage_fingerprints\n"
+                                     "WHERE storage_id = (SELECT storages.id\n"
+                                     "                    FROM   storages\n"
+                                     "                    WHERE  storages.location = :location)",
+                                     KisSqlQueryLoader::single_statement_mode);
+            loader.query().bindValue(":location", changeToEmptyIfNull(location));
+            loader.exec();
+        }
+
         {
             KisSqlQueryLoader loader("inline://delete_storage",
                                      "DELETE FROM storages\n"
@@ -1884,6 +2088,16 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
 
     storage->setStorageId(q.value("id").toInt());
 
+    /// If no file of the storage has changed since the last
+    /// synchronization, there is nothing to compare, so we don't
+    /// even list the resources
+
+    const QString fingerprint = storageSynchronizationFingerprint(storage);
+    if (!fingerprint.isEmpty() && fingerprint == loadStorageFingerprint(storage->storageId())) {
+        debugResource << "Storage is unchanged since the last synchronization" << storage->location();
+        return success;
+    }
+
     /// Start the transaction that will add all the resources
     QSqlDatabase::database().transaction();
 
@@ -2010,6 +2224,12 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
         /// (negative) resourceId. These resources are obviously new
         /// resources and should be added to the cache database.
 
+        QStringList newResourceUrls;
+        for (auto it = itA; it != endA && it->resourceId < 0; ++it) {
+            newResourceUrls.append(it->url);
+        }
+        const QHash<QString, QString> md5s = calculateResourceMd5s(storage, newResourceUrls);
+
         while (itA != endA) {
             if (itA->resourceId >= 0) break;
 
@@ -2022,7 +2242,7 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
             }
 
             res->setVersion(itA->version);
-            res->setMD5Sum(storage->resourceMd5(itA->url));
+            res->setMD5Sum(cachedResourceMd5(storage, md5s, itA->url));
             if (!res->valid()) {
                 KisUsageLogger::log("Could not retrieve md5 for resource " + itA->url);
                 ++itA;
@@ -2047,7 +2267,7 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
             for (auto it = std::next(itA); it != nextResource; ++it) {
                 KoResourceSP res = storage->resource(it->url);
                 res->setVersion(it->version);
-                res->setMD5Sum(storage->resourceMd5(it->url));
+                res->setMD5Sum(cachedResourceMd5(storage, md5s, it->url));
                 if (!res->valid()) {
                     continue;
                 }
@@ -2114,6 +2334,10 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
         }
     }
 
+    if (success && !fingerprint.isEmpty()) {
+        saveStorageFingerprint(storage->storageId(), fingerprint);
+    }
+
     QSqlDatabase::database().commit();
     debugResource << "Synchronizing the storages took" << t.elapsed() << "milliseconds for" << storage->location();
 
@@ -6,6 +6,8 @@
 
 #include "KisResourceLocator.h"
 
+#include <algorithm>
+
 #include <QApplication>
 #include <QDebug>
 #include <QList>
@@ -17,6 +19,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QBuffer>
+#include <QtConcurrent>
 
 #include <kconfig.h>
 #include <kconfiggroup.h>
@@ -28,6 +31,7 @@
 #include <kis_assert.h>
 #include <kis_debug.h>
 #include <KisUsageLogger.h>
+#include <KisStartupProfiler.h>
 
 #include "KoResourcePaths.h"
 #include "KisResourceStorage.h"
@@ -47,17 +51,140 @@ const QString KisResourceLocator::resourceLocationKey {"ResourceDirectory"};
 
 class KisResourceLocator::Private {
 public:
+    using ResourceKey = QPair<QString, QString>;
+
     QString resourceLocation;
     QMap<QString, KisResourceStorageSP> storages;
-    QHash<QPair<QString, QString>, KoResourceSP> resourceCache;
     QMap<QPair<QString, QString>, KisTagSP> tagCache;
     QStringList errorMessages;
+
+    /**
+     * The loaded resources are kept in an LRU cache limited by
+     * their approximate memory usage. The evicted resources are
+     * still tracked with weak pointers: if somebody still uses
+     * such resource, it is revived on the next request, so there
+     * is never more than one object per resource.
+     *
+     * Dirty resources and the resources of the memory storage are
+     * never evicted, they cannot be reloaded from their storages.
+     */
+    struct CacheEntry {
+        KoResourceSP resource;
+        qint64 size = 0;
+        quint64 lastUse = 0;
+    };
+
+    QHash<ResourceKey, CacheEntry> resourceCache;
+    QHash<ResourceKey, QWeakPointer<KoResource>> evictedResources;
+    qint64 resourceCacheSize = 0;
+    qint64 resourceCacheLimit = 0;
+    quint64 resourceUseCounter = 0;
+
+    bool isResourceCached(const ResourceKey &key) const;
+    KoResourceSP cachedResource(const ResourceKey &key);
+    void cacheResource(const ResourceKey &key, KoResourceSP resource);
+    void removeCachedResource(const ResourceKey &key);
+    void clearResourceCache();
+    void evictUnusedResources();
 };
 
+bool KisResourceLocator::Private::isResourceCached(const ResourceKey &key) const
+{
+    if (resourceCache.contains(key)) return true;
+
+    auto it = evictedResources.constFind(key);
+    return it != evictedResources.constEnd() && !it->isNull();
+}
+
+KoResourceSP KisResourceLocator::Private::cachedResource(const ResourceKey &key)
+{
+    auto it = resourceCache.find(key);
+    if (it != resourceCache.end()) {
+        it->lastUse = ++resourceUseCounter;
+        return it->resource;
+    }
+
+    KoResourceSP resource = evictedResources.take(key).toStrongRef();
+    if (resource) {
+        cacheResource(key, resource);
+    }
+
+    return resource;
+}
+
+void KisResourceLocator::Private::cacheResource(const ResourceKey &key, KoResourceSP resource)
+{
+    removeCachedResource(key);
+
+    CacheEntry entry;
+    entry.resource = resource;
+    entry.size = resource->approximateMemoryUsage();
+    entry.lastUse = ++resourceUseCounter;
+
+    resourceCache.insert(key, entry);
+    resourceCacheSize += entry.size;
+
+    if (resourceCacheSize > resourceCacheLimit) {
+        evictUnusedResources();
+    }
+}
+
+void KisResourceLocator::Private::removeCachedResource(const ResourceKey &key)
+{
+    auto it = resourceCache.find(key);
+    if (it != resourceCache.end()) {
+        resourceCacheSize -= it->size;
+        resourceCache.erase(it);
+    }
+    evictedResources.remove(key);
+}
+
+void KisResourceLocator::Private::clearResourceCache()
+{
+    resourceCache.clear();
+    evictedResources.clear();
+    resourceCacheSize = 0;
+}
+
+void KisResourceLocator::Private::evictUnusedResources()
+{
+    // forget the evicted resources nobody uses anymore
+    for (auto it = evictedResources.begin(); it != evictedResources.end();) {
+        if (it->isNull()) {
+            it = evictedResources.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QVector<QPair<quint64, ResourceKey>> candidates;
+    for (auto it = resourceCache.constBegin(); it != resourceCache.constEnd(); ++it) {
+        if (it.key().first == "memory" || it->resource->isDirty()) continue;
+        candidates.append(qMakePair(it->lastUse, it.key()));
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [] (const QPair<quint64, ResourceKey> &lhs, const QPair<quint64, ResourceKey> &rhs) {
+                  return lhs.first < rhs.first;
+              });
+
+    // evict a bit more than necessary to not do that on every request
+    const qint64 targetSize = resourceCacheLimit * 3 / 4;
+
+    for (auto it = candidates.constBegin(); it != candidates.constEnd() && resourceCacheSize > targetSize; ++it) {
+        auto entry = resourceCache.find(it->second);
+        resourceCacheSize -= entry->size;
+        evictedResources.insert(it->second, entry->resource.toWeakRef());
+        resourceCache.erase(entry);
+    }
+}
+
 KisResourceLocator::KisResourceLocator(QObject *parent)
     : QObject(parent)
     , d(new Private())
 {
+    KConfigGroup cfg(KSharedConfig::openConfig(), "");
+    d->resourceCacheLimit = qint64(cfg.readEntry("ResourceCacheMemoryLimitMiB", 256)) * 1024 * 1024;
 }
 
 KisResourceLocator *KisResourceLocator::instance()
@@ -118,6 +245,7 @@ KisResourceLocator::LocatorError KisResourceLocator::initialize(const QString &i
     }
 
     if (initializationStatus != InitializationStatus::Initialized) {
+        KisStartupProfiler::Phase phase("First time installation of the resources");
         KisResourceLocator::LocatorError res = firstTimeInstallation(initializationStatus, installationResourcesLocation);
         if (res != LocatorError::Ok) {
             return res;
@@ -147,7 +275,7 @@ bool KisResourceLocator::resourceCached(QString storageLocation, const QString &
     storageLocation = makeStorageLocationAbsolute(storageLocation);
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + filename);
 
-    return d->resourceCache.contains(key);
+    return d->isResourceCached(key);
 }
 
 void KisResourceLocator::loadRequiredResources(KoResourceSP resource)
@@ -320,11 +448,8 @@ KoResourceSP KisResourceLocator::resource(QString storageLocation, const QString
 
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + filename);
 
-    KoResourceSP resource;
-    if (d->resourceCache.contains(key)) {
-        resource = d->resourceCache[key];
-    }
-    else {
+    KoResourceSP resource = d->cachedResource(key);
+    if (!resource) {
         KisResourceStorageSP storage = d->storages[storageLocation];
         if (!storage) {
             qWarning() << "Could not find storage" << storageLocation;
@@ -334,7 +459,7 @@ KoResourceSP KisResourceLocator::resource(QString storageLocation, const QString
         resource = storage->resource(resourceType + "/" + filename);
 
         if (resource) {
-            d->resourceCache[key] = resource;
+            d->cacheResource(key, resource);
             // load all the embedded resources into temporary "memory" storage
             loadRequiredResources(resource);
         }
@@ -418,7 +543,7 @@ bool KisResourceLocator::setResourceActive(int resourceId, bool active)
     ResourceStorage rs = getResourceStorage(resourceId);
     QPair<QString, QString> key = QPair<QString, QString> (rs.storageLocation, rs.resourceType + "/" + rs.resourceFileName);
 
-    d->resourceCache.remove(key);
+    d->removeCachedResource(key);
     if (!active) {
         KisResourceThumbnailCache::instance()->remove(key);
     }
@@ -590,7 +715,7 @@ KoResourceSP KisResourceLocator::importResource(const QString &resourceType, con
         const QString absoluteStorageLocation = makeStorageLocationAbsolute(resource->storageLocation());
         const QPair<QString, QString> key = {absoluteStorageLocation, resourceType + "/" + resource->filename()};
         // Add to the cache
-        d->resourceCache[key] = resource;
+        d->cacheResource(key, resource);
         KisResourceThumbnailCache::instance()->insert(key, resource->thumbnail());
 
         return resource;
@@ -646,7 +771,7 @@ bool KisResourceLocator::addResource(const QString &resourceType, const KoResour
     resource->setDirty(false);
     loadRequiredResources(resource);
 
-    d->resourceCache[QPair<QString, QString>(storageLocation, resourceType + "/" + resource->filename())] = resource;
+    d->cacheResource(QPair<QString, QString>(storageLocation, resourceType + "/" + resource->filename()), resource);
 
     /// And to the database.
     ///
@@ -703,7 +828,7 @@ bool KisResourceLocator::updateResource(const QString &resourceType, const KoRes
 
     // Update the resource in the cache
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename());
-    d->resourceCache[key] = resource;
+    d->cacheResource(key, resource);
     KisResourceThumbnailCache::instance()->insert(key, resource->thumbnail());
 
     return true;
@@ -730,7 +855,7 @@ bool KisResourceLocator::reloadResource(const QString &resourceType, const KoRes
 
     // We haven't changed the version of the resource, so the cache must be still valid
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename());
-    Q_ASSERT(d->resourceCache[key] == resource);
+    Q_ASSERT(d->isResourceCached(key));
 
     return true;
 }
@@ -775,9 +900,9 @@ void KisResourceLocator::setMetaDataForStorage(const QString &storageLocation, Q
 
 void KisResourceLocator::purge(const QString &storageLocation)
 {
-    Q_FOREACH(const auto key, d->resourceCache.keys()) {
+    Q_FOREACH(const auto key, d->resourceCache.keys() + d->evictedResources.keys()) {
         if (key.first == storageLocation) {
-            d->resourceCache.remove(key);
+            d->removeCachedResource(key);
             KisResourceThumbnailCache::instance()->remove(key);
         }
     }
@@ -1029,7 +1154,7 @@ KisResourceLocator::LocatorError KisResourceLocator::firstTimeInstallation(Initi
 void KisResourceLocator::findStorages()
 {
     d->storages.clear();
-    d->resourceCache.clear();
+    d->clearResourceCache();
 
     // Add the folder
     KisResourceStorageSP storage = QSharedPointer<KisResourceStorage>::create(d->resourceLocation);
@@ -1041,7 +1166,9 @@ void KisResourceLocator::findStorages()
     d->storages["memory"]->setMetaData(KisResourceStorage::s_meta_name, i18n("Temporary Resources"));
 
     // Add font storage
+    const int fontStoragePhase = KisStartupProfiler::instance()->beginPhase("Create font storage");
     auto fontStorage = QSharedPointer<KisResourceStorage>::create("fontregistry");
+    KisStartupProfiler::instance()->endPhase(fontStoragePhase);
     if (fontStorage && fontStorage->valid()) {
         d->storages["fontregistry"] = fontStorage;
         d->storages["fontregistry"]->setMetaData(KisResourceStorage::s_meta_name, i18n("Font Storage"));
@@ -1050,9 +1177,27 @@ void KisResourceLocator::findStorages()
     // And add bundles and adobe libraries
     QStringList filters = QStringList() << "*.bundle" << "*.abr" << "*.asl";
     QDirIterator iter(d->resourceLocation, filters, QDir::Files, QDirIterator::Subdirectories);
+
+    QVector<QPair<QString, KisResourceStorageSP>> fileStorages;
     while (iter.hasNext()) {
         iter.next();
-        KisResourceStorageSP storage = QSharedPointer<KisResourceStorage>::create(iter.filePath());
+        fileStorages.append(qMakePair(iter.filePath(), KisResourceStorageSP()));
+    }
+
+    /**
+     * Opening a bundle means unzipping its manifest, metadata and
+     * thumbnail, so the bundles are opened concurrently. Every bundle
+     * storage works with its own zip store, so it is safe. Adobe
+     * libraries are opened in the GUI thread as before.
+     */
+    QtConcurrent::blockingMap(fileStorages, [] (QPair<QString, KisResourceStorageSP> &item) {
+        if (item.first.endsWith(".bundle", Qt::CaseInsensitive)) {
+            item.second = QSharedPointer<KisResourceStorage>::create(item.first);
+        }
+    });
+
+    for (auto it = fileStorages.begin(); it != fileStorages.end(); ++it) {
+        KisResourceStorageSP storage = it->second ? it->second : QSharedPointer<KisResourceStorage>::create(it->first);
         if (!storage->valid()) {
             // we still add the storage to the list and try to read whatever possible
             qWarning() << "KisResourceLocator::findStorages: the storage is invalid" << storage->location();
@@ -1177,7 +1322,12 @@ bool KisResourceLocator::synchronizeDb()
     }
 
 
-    findStorages();
+    {
+        KisStartupProfiler::Phase phase("Find storages");
+        findStorages();
+    }
+
+    const int synchronizationPhase = KisStartupProfiler::instance()->beginPhase("Synchronize storages");
     Q_FOREACH(const KisResourceStorageSP storage, d->storages) {
         if (!KisResourceCacheDb::synchronizeStorage(storage)) {
             d->errorMessages.append(i18n("Could not synchronize %1 with the database", storage->location()));
@@ -1185,6 +1335,7 @@ bool KisResourceLocator::synchronizeDb()
             Q_EMIT storageResynchronized(storage->location(), true);
         }
     }
+    KisStartupProfiler::instance()->endPhase(synchronizationPhase);
 
     Q_FOREACH(const KisResourceStorageSP storage, d->storages) {
         if (!KisResourceCacheDb::addStorageTags(storage)) {
@@ -1230,7 +1381,7 @@ bool KisResourceLocator::synchronizeDb()
     d->errorMessages <<
         KisResourceLoaderRegistry::instance()->executeAllFixups();
 
-    d->resourceCache.clear();
+    d->clearResourceCache();
     return d->errorMessages.isEmpty();
 }
 
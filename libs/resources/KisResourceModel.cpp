@@ -642,6 +642,54 @@ QVector<KisTagSP> KisAllResourcesModel::tagsForResource(int resourceId) const
     return tags;
 }
 
+QHash<int, QStringList> KisAllResourcesModel::tagNamesForResources() const
+{
+    QHash<int, QStringList> tagNames;
+
+    QSqlQuery q;
+
+    bool r = q.prepare("SELECT resource_tags.resource_id\n"
+                       ",      tags.url\n"
+                       "FROM   tags\n"
+                       ",      resource_tags\n"
+                       ",      resource_types\n"
+                       "WHERE  tags.active > 0\n"
+                       "AND    tags.id = resource_tags.tag_id\n"
+                       "AND    resource_types.id = tags.resource_type_id\n"
+                       "AND    resource_types.name = :resource_type\n"
+                       "AND    resource_tags.active = 1\n");
+    if (!r)  {
+        qWarning() << "Could not prepare TagNamesForResources query" << q.lastError();
+        return tagNames;
+    }
+
+    q.bindValue(":resource_type", d->resourceType);
+    r = q.exec();
+    if (!r) {
+        qWarning() << "Could not select tags for" << d->resourceType << "resources" << q.lastError() << q.boundValues();
+        return tagNames;
+    }
+
+    // there are only a few tags, so resolve every url only once
+    QHash<QString, QString> tagNameForUrl;
+
+    while (q.next()) {
+        const QString url = q.value(1).toString();
+
+        auto it = tagNameForUrl.find(url);
+        if (it == tagNameForUrl.end()) {
+            KisTagSP tag = KisResourceLocator::instance()->tagForUrl(url, d->resourceType);
+            it = tagNameForUrl.insert(url, tag && tag->valid() ? tag->name() : QString());
+        }
+
+        if (!it->isEmpty()) {
+            tagNames[q.value(0).toInt()] << *it;
+        }
+    }
+
+    return tagNames;
+}
+
 
 int KisAllResourcesModel::rowCount(const QModelIndex &parent) const
 {
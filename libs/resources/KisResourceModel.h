@@ -9,6 +9,8 @@
 
 #include <QAbstractTableModel>
 #include <QSortFilterProxyModel>
+#include <QHash>
+#include <QStringList>
 
 #include <kritaresources_export.h>
 
@@ -349,6 +351,13 @@ public:
     QVector<KoResourceSP> resourcesForMD5(const QString &md5sum) const;
     QVector<KisTagSP> tagsForResource(int resourceId) const;
 
+    /**
+     * @return the names of the active tags of all the resources of this
+     * type, keyed by the resource id. It runs a single query, so it is
+     * much cheaper than calling tagsForResource() for every resource.
+     */
+    QHash<int, QStringList> tagNamesForResources() const;
+
 private:
 
     bool prepareQuery();
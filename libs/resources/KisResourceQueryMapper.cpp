@@ -17,6 +17,8 @@
 #include <QSqlError>
 #include <QString>
 #include <QVariant>
+#include <QVector>
+#include <QtConcurrent>
 
 #include "KisResourceLocator.h"
 #include "KisResourceMetaDataModel.h"
@@ -26,6 +28,93 @@
 #include "KisTag.h"
 #include "kis_assert.h"
 
+namespace {
+
+/**
+ * The number of thumbnails loaded together with the requested one. The
+ * resource models are sorted by id, so the following resources are the
+ * ones the chooser is going to show next.
+ */
+const int thumbnailPrefetchBatchSize = 64;
+
+struct PendingThumbnail
+{
+    QString storageLocation;
+    QString resourceType;
+    QString filename;
+    QByteArray data;
+    QImage image;
+};
+
+}
+
+void KisResourceQueryMapper::prefetchThumbnails(int resourceId)
+{
+    QSqlQuery q;
+    bool result = q.prepare("SELECT resources.filename\n"
+                            ",      resources.thumbnail\n"
+                            ",      storages.location\n"
+                            ",      resource_types.name AS resource_type\n"
+                            "FROM   resources\n"
+                            ",      storages\n"
+                            ",      resource_types\n"
+                            "WHERE  resources.storage_id = storages.id\n"
+                            "AND    resources.resource_type_id = resource_types.id\n"
+                            "AND    resources.resource_type_id = (SELECT resource_type_id FROM resources WHERE id = :resource_id)\n"
+                            "AND    resources.id >= :resource_id\n"
+                            "ORDER BY resources.id\n"
+                            "LIMIT  :batch_size");
+    if (!result) {
+        qWarning() << "Failed to prepare query for thumbnails of" << resourceId << q.lastError();
+        return;
+    }
+
+    q.bindValue(":resource_id", resourceId);
+    q.bindValue(":batch_size", thumbnailPrefetchBatchSize);
+
+    if (!q.exec()) {
+        qWarning() << "Failed to execute query for thumbnails of" << resourceId << q.lastError();
+        return;
+    }
+
+    KisResourceThumbnailCache *cache = KisResourceThumbnailCache::instance();
+    QVector<PendingThumbnail> pending;
+
+    while (q.next()) {
+        PendingThumbnail thumbnail;
+        thumbnail.storageLocation =
+            KisResourceLocator::instance()->makeStorageLocationAbsolute(q.value("location").toString());
+        thumbnail.resourceType = q.value("resource_type").toString();
+        thumbnail.filename = q.value("filename").toString();
+
+        if (cache->containsOriginalImage(thumbnail.storageLocation, thumbnail.resourceType, thumbnail.filename)) {
+            continue;
+        }
+
+        thumbnail.data = q.value("thumbnail").toByteArray();
+        pending.append(thumbnail);
+    }
+
+    if (pending.isEmpty()) {
+        qWarning() << "Failed to find thumbnail of" << resourceId;
+        return;
+    }
+
+    /**
+     * Decoding the PNG blobs is the expensive part, it doesn't touch the
+     * database, so it can be done concurrently. The cache itself is
+     * filled in the GUI thread afterwards.
+     */
+    QtConcurrent::blockingMap(pending, [] (PendingThumbnail &thumbnail) {
+        QBuffer buf(&thumbnail.data);
+        buf.open(QBuffer::ReadOnly);
+        thumbnail.image.load(&buf, "PNG");
+    });
+
+    Q_FOREACH (const PendingThumbnail &thumbnail, pending) {
+        cache->insert(thumbnail.storageLocation, thumbnail.resourceType, thumbnail.filename, thumbnail.image);
+    }
+}
 
 QImage KisResourceQueryMapper::getThumbnailFromQuery(const QSqlQuery &query, bool useResourcePrefix)
 {
@@ -44,35 +133,9 @@ QImage KisResourceQueryMapper::getThumbnailFromQuery(const QSqlQuery &query, boo
         const int resourceId = query.value(useResourcePrefix ? "resource_id" : "id").toInt();
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(resourceId >= 0, img);
 
-        bool result = false;
-        QSqlQuery thumbQuery;
-        result = thumbQuery.prepare("SELECT thumbnail FROM resources WHERE resources.id = :resource_id");
-        if (!result) {
-            qWarning() << "Failed to prepare query for thumbnail of" << resourceId << thumbQuery.lastError();
-            return img;
-        }
-
-        thumbQuery.bindValue(":resource_id", resourceId);
+        prefetchThumbnails(resourceId);
 
-        result = thumbQuery.exec();
-
-        if (!result) {
-            qWarning() << "Failed to execute query for thumbnail of" << resourceId << thumbQuery.lastError();
-            return img;
-        }
-
-        if (!thumbQuery.next()) {
-            qWarning() << "Failed to find thumbnail of" << resourceId;
-            return img;
-        }
-
-        QByteArray ba = thumbQuery.value("thumbnail").toByteArray();
-        QBuffer buf(&ba);
-        buf.open(QBuffer::ReadOnly);
-        img.load(&buf, "PNG");
-
-        KisResourceThumbnailCache::instance()->insert(storageLocation, resourceType, filename, img);
-        return img;
+        return KisResourceThumbnailCache::instance()->originalImage(storageLocation, resourceType, filename);
     }
 }
 
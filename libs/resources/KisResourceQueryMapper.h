@@ -21,6 +21,13 @@ public:
 
 private:
     static QImage getThumbnailFromQuery(const QSqlQuery &query, bool useResourcePrefix);
+
+    /**
+     * Loads the thumbnails of \p resourceId and of the resources of the
+     * same type that follow it into KisResourceThumbnailCache with a
+     * single query and decodes them concurrently.
+     */
+    static void prefetchThumbnails(int resourceId);
 };
 
 #endif // KISRESOURCEQUERYMAPPER_H
@@ -198,6 +198,11 @@ QDateTime KisResourceStorage::timestamp() const
     return d->storagePlugin->timestamp();
 }
 
+QString KisResourceStorage::fingerprint() const
+{
+    return d->storagePlugin->fingerprint();
+}
+
 QDateTime KisResourceStorage::timeStampForResource(const QString &resourceType, const QString &filename) const
 {
     QFileInfo li(d->location);
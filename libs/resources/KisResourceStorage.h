@@ -182,6 +182,9 @@ public:
     /// for memory storages.
     QDateTime timestamp() const;
 
+    /// A summary of the state of the storage's files, see KisStoragePlugin::fingerprint()
+    QString fingerprint() const;
+
     /// The time and date when the resource was last modified
     /// For filestorage
     QDateTime timeStampForResource(const QString &resourceType, const QString &filename) const;
@@ -126,6 +126,13 @@ QImage KisResourceThumbnailCache::originalImage(const QString &storageLocation,
     return m_d->containsOriginal(key) ? m_d->getOriginal(key) : QImage();
 }
 
+bool KisResourceThumbnailCache::containsOriginalImage(const QString &storageLocation,
+                                                      const QString &resourceType,
+                                                      const QString &filename) const
+{
+    return m_d->containsOriginal(m_d->key(storageLocation, resourceType, filename));
+}
+
 void KisResourceThumbnailCache::insert(const QString &storageLocation,
                                        const QString &resourceType,
                                        const QString &filename,
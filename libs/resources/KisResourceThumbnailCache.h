@@ -36,6 +36,7 @@ private:
      * Check if we have the original image in the cache.
      */
     QImage originalImage(const QString &storageLocation, const QString &resourceType, const QString &filename) const;
+    bool containsOriginalImage(const QString &storageLocation, const QString &resourceType, const QString &filename) const;
     void insert(const QString &storageLocation,
                 const QString &resourceType,
                 const QString &filename,
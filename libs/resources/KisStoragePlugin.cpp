@@ -7,6 +7,8 @@
 #include "KisStoragePlugin.h"
 #include <QFileInfo>
 #include <QDir>
+#include <QDirIterator>
+#include <QCryptographicHash>
 
 #include <KoResource.h>
 #include <KisMimeDatabase.h>
@@ -88,6 +90,32 @@ QDateTime KisStoragePlugin::timestamp()
     return d->timestamp;
 }
 
+void KisStoragePlugin::addFolderToFingerprint(const QString &path, QCryptographicHash &hash)
+{
+    const QDir dir(path);
+    if (!dir.exists()) return;
+
+    QStringList entries;
+
+    QDirIterator it(path, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        entries.append(QString("%1:%2:%3")
+                       .arg(dir.relativeFilePath(fi.filePath()))
+                       .arg(fi.size())
+                       .arg(fi.lastModified().toMSecsSinceEpoch()));
+    }
+
+    // QDirIterator doesn't guarantee any order
+    entries.sort();
+
+    hash.addData(dir.absolutePath().toUtf8());
+    Q_FOREACH (const QString &entry, entries) {
+        hash.addData(entry.toUtf8());
+    }
+}
+
 QString KisStoragePlugin::location() const
 {
     return d->location;
@@ -14,6 +14,7 @@
 #include "kritaresources_export.h"
 
 class QDir;
+class QCryptographicHash;
 
 /**
  * The KisStoragePlugin class is the base class
@@ -52,12 +53,25 @@ public:
 
     QDateTime timestamp();
 
+    /**
+     * A cheap summary of the state of the storage's files (sizes and
+     * modification times), which changes whenever any resource is added,
+     * removed or modified on disk. The resource cache uses it to skip
+     * synchronization of unchanged storages. An empty string means that
+     * the storage cannot tell, so it is always synchronized.
+     */
+    virtual QString fingerprint() const { return QString(); }
+
     virtual bool isValid() const;
 
 protected:
     friend class TestBundleStorage;
     QString location() const;
 
+    /// Adds names, sizes and modification times of all the files
+    /// in \p path and its subfolders to \p hash (in a stable order)
+    static void addFolderToFingerprint(const QString &path, QCryptographicHash &hash);
+
     /**
      * On some systems, e.g. Windows, the file names are case-insensitive,
      * therefore URLs will fetch the resource even when the casing is not
@@ -38,6 +38,19 @@ struct KisTagFilterResourceProxyModel::Private
     int storageId {-1};
     bool useStorageIdFilter {false};
 
+    /**
+     * The tags of all the resources of the type fetched with a single
+     * query while the search text is not empty. Requesting the Tags role
+     * of every row runs a separate query per resource, which made the
+     * search box lag on every keystroke with thousands of resources.
+     */
+    QHash<int, QStringList> searchTags;
+
+    void updateSearchTags() {
+        searchTags = filter->isEmpty() ?
+            QHash<int, QStringList>() :
+            KisResourceModelProvider::resourceModel(resourceType)->tagNamesForResources();
+    }
 };
 
 KisTagFilterResourceProxyModel::KisTagFilterResourceProxyModel(const QString &resourceType, QObject *parent)
@@ -244,6 +257,8 @@ void KisTagFilterResourceProxyModel::setStorageFilter(bool useFilter, int storag
 void KisTagFilterResourceProxyModel::updateTagFilter()
 {
     Q_EMIT beforeFilterChanges();
+    d->updateSearchTags();
+
     const bool ignoreTagFiltering =
         !d->filteringWithinCurrentTag && !d->filter->isEmpty();
 
@@ -326,12 +341,16 @@ bool KisTagFilterResourceProxyModel::filterInCurrentTag() const
 
 bool KisTagFilterResourceProxyModel::tagResources(const KisTagSP tag, const QVector<int> &resourceIds)
 {
-    return d->tagResourceModel->tagResources(tag, resourceIds);
+    const bool result = d->tagResourceModel->tagResources(tag, resourceIds);
+    d->updateSearchTags();
+    return result;
 }
 
 bool KisTagFilterResourceProxyModel::untagResources(const KisTagSP tag, const QVector<int> &resourceIds)
 {
-    return d->tagResourceModel->untagResources(tag, resourceIds);
+    const bool result = d->tagResourceModel->untagResources(tag, resourceIds);
+    d->updateSearchTags();
+    return result;
 }
 
 int KisTagFilterResourceProxyModel::isResourceTagged(const KisTagSP tag, const int resourceId)
@@ -380,7 +399,7 @@ bool KisTagFilterResourceProxyModel::filterAcceptsRow(int source_row, const QMod
     if (sourceModel()->data(idx, Qt::UserRole + KisAbstractResourceModel::ResourceType).toString() == ResourceType::PaintOpPresets) {
         resourceName = resourceName.replace("_", " ");
     }
-    QStringList resourceTags = sourceModel()->data(idx, Qt::UserRole + KisAbstractResourceModel::Tags).toStringList();
+    const QStringList resourceTags = d->searchTags.value(resourceId);
     bool resourceNameMatches = d->filter->matchesResource(resourceName, resourceTags);
     if (!resourceNameMatches) {
         resourceNameMatches = additionalResourceNameChecks(idx, d->filter.data());
@@ -133,6 +133,11 @@ QString KoResource::thumbnailPath() const
     return QString();
 }
 
+qint64 KoResource::approximateMemoryUsage() const
+{
+    return image().sizeInBytes();
+}
+
 void KoResource::setImage(const QImage &image)
 {
     d->image = image;
@@ -111,6 +111,13 @@ public:
      */
     virtual QString thumbnailPath() const;
 
+    /**
+     * @brief approximateMemoryUsage an estimation of the memory occupied
+     * by the loaded resource, used to limit the size of the resource cache
+     * @return the size in bytes. By default it's the size of image().
+     */
+    virtual qint64 approximateMemoryUsage() const;
+
     /**
      * @param generateIfEmpty: if the resource does not have an md5sum set,
      * if this is true, the resource saves itself into a buffer and calculates
@@ -139,6 +139,22 @@ void TestFolderStorage::testResourceCaseSensitivity()
 #endif
 }
 
+void TestFolderStorage::testFingerprint()
+{
+    KisFolderStorage folderStorage(m_dstLocation);
+
+    const QString fingerprint = folderStorage.fingerprint();
+    QVERIFY(!fingerprint.isEmpty());
+    QCOMPARE(folderStorage.fingerprint(), fingerprint);
+
+    KoResourceSP resource(new DummyResource("fingerprinttest.kpp", ResourceType::PaintOpPresets));
+    resource->setValid(true);
+    resource->setVersion(0);
+    QVERIFY(folderStorage.addResource(ResourceType::PaintOpPresets, resource));
+
+    QVERIFY(folderStorage.fingerprint() != fingerprint);
+}
+
 void TestFolderStorage::cleanupTestCase()
 {
     ResourceTestHelper::rmTestDb();
@@ -38,6 +38,7 @@
 #include <QWidget>
 #include <QImageReader>
 #include <QImageWriter>
+#include <QLockFile>
 #include <QThread>
 
 #include <klocalizedstring.h>
@@ -82,6 +83,7 @@
 #include "kis_document_aware_spin_box_unit_manager.h"
 #include "KisViewManager.h"
 #include <KisUsageLogger.h>
+#include <KisStartupProfiler.h>
 
 #include <KritaVersionWrapper.h>
 #include <dialogs/KisSessionManagerDialog.h>
@@ -111,6 +113,7 @@
 
 #include <dialogs/KisAsyncAnimationFramesSaveDialog.h>
 #include <kis_image_animation_interface.h>
+#include <kis_time_span.h>
 #include "kis_file_layer.h"
 #include "kis_group_layer.h"
 #include "kis_node_commands_adapter.h"
@@ -140,6 +143,50 @@ namespace {
 const QTime appStartTime(QTime::currentTime());
 }
 
+namespace {
+
+bool hasExportedLayers(KisNodeSP node, const QStringList &layerNames)
+{
+    if (layerNames.contains(node->name())) return true;
+
+    for (KisNodeSP child = node->firstChild(); child; child = child->nextSibling()) {
+        if (hasExportedLayers(child, layerNames)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Hides all the layers except the ones named in \p layerNames and the
+ * groups containing them. The layers inside a named layer (and all the
+ * masks) are kept as they are.
+ */
+void hideNotExportedLayers(KisNodeSP node, const QStringList &layerNames)
+{
+    for (KisNodeSP child = node->firstChild(); child; child = child->nextSibling()) {
+        if (!qobject_cast<KisLayer*>(child.data())) continue;
+        if (layerNames.contains(child->name())) continue;
+
+        if (hasExportedLayers(child, layerNames)) {
+            hideNotExportedLayers(child, layerNames);
+        } else {
+            child->setVisible(false);
+        }
+    }
+}
+
+KisTimeSpan exportChunkRange(const KisTimeSpan &range, int chunkIndex, int chunkCount)
+{
+    const int chunkDuration = (range.duration() + chunkCount - 1) / chunkCount;
+    const int start = range.start() + (chunkIndex - 1) * chunkDuration;
+
+    if (start > range.end()) return KisTimeSpan();
+
+    return KisTimeSpan::fromTimeToTime(start, qMin(range.end(), start + chunkDuration - 1));
+}
+
+}
+
 namespace {
 struct AppRecursionInfo {
     ~AppRecursionInfo() {
@@ -465,11 +512,51 @@ bool KisApplication::registerResources()
     QString databaseLocation = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
 #endif
 
-    if (!KisResourceCacheDb::initialize(databaseLocation)) {
-        QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita: Fatal error"), i18n("%1\n\nKrita will quit now.", KisResourceCacheDb::lastError()));
+    /**
+     * Only one instance may migrate and synchronize the shared resource
+     * database at a time. The instances started while it is busy wait
+     * for it and then find all the storage fingerprints up to date, so
+     * their synchronization is skipped. The lock is owned by a process,
+     * so the lock of a crashed instance is considered stale. We don't
+     * wait forever though: if the other instance hangs, we report it
+     * and initialize the database anyway, relying on SQLite's own
+     * locking.
+     */
+    const int resourceLockTimeout = 60000; // ms
+
+    QDir().mkpath(databaseLocation);
+    QLockFile resourceInitializationLock(databaseLocation + "/resourcecache.lock");
+    resourceInitializationLock.setStaleLockTime(0);
+
+    if (!resourceInitializationLock.tryLock(0)) {
+        setSplashScreenLoadingText(i18n("Waiting for another instance of Krita to initialize the resources..."));
+
+        if (!resourceInitializationLock.tryLock(resourceLockTimeout)) {
+            const QString lockError =
+                resourceInitializationLock.error() == QLockFile::LockFailedError ?
+                    i18n("Another instance of Krita has been initializing the resource database in \"%1\" for more than %2 seconds.",
+                         databaseLocation, resourceLockTimeout / 1000) :
+                    i18n("Could not create the resource database lock file in \"%1\".", databaseLocation);
+
+            qWarning() << "Could not lock the resource database for initialization" << resourceInitializationLock.error();
+
+            if (qApp->inherits("KisApplication")) {
+                QMessageBox::warning(qApp->activeWindow(), i18nc("@title:window", "Krita: Warning"),
+                                     i18n("%1\n\nKrita will continue loading, but the resources may be out of date until the next start.", lockError));
+            }
+        }
+    }
+
+    {
+        KisStartupProfiler::Phase phase("Initialize resource database");
+        if (!KisResourceCacheDb::initialize(databaseLocation)) {
+            QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita: Fatal error"), i18n("%1\n\nKrita will quit now.", KisResourceCacheDb::lastError()));
+        }
     }
 
+    const int locatorPhase = KisStartupProfiler::instance()->beginPhase("Initialize resource locator");
     KisResourceLocator::LocatorError r = KisResourceLocator::instance()->initialize(KoResourcePaths::getApplicationRoot() + "/share/krita");
+    KisStartupProfiler::instance()->endPhase(locatorPhase);
     connect(KisResourceLocator::instance(), SIGNAL(progressMessage(const QString&)), this, SLOT(setSplashScreenLoadingText(const QString&)));
     if (r != KisResourceLocator::LocatorError::Ok && qApp->inherits("KisApplication")) {
         QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita: Fatal error"), KisResourceLocator::instance()->errorMessages().join('\n') + i18n("\n\nKrita will quit now."));
@@ -478,20 +565,23 @@ bool KisApplication::registerResources()
     return true;
 }
 
-void KisApplication::loadPlugins()
+void KisApplication::loadPlugins(bool loadGuiPlugins)
 {
     //    qDebug() << "loadPlugins();";
 
     KoShapeRegistry* r = KoShapeRegistry::instance();
     r->add(new KisShapeSelectionFactory());
     KoColorSpaceRegistry::instance();
-    KisActionRegistry::instance();
     KisFilterRegistry::instance();
     KisGeneratorRegistry::instance();
     KisPaintOpRegistry::instance();
-    KoToolRegistry::instance();
-    KoDockRegistry::instance();
     KisMetadataBackendRegistry::instance();
+
+    if (loadGuiPlugins) {
+        KisActionRegistry::instance();
+        KoToolRegistry::instance();
+        KoDockRegistry::instance();
+    }
 }
 
 bool KisApplication::start(const KisApplicationArguments &args)
@@ -523,7 +613,11 @@ bool KisApplication::start(const KisApplicationArguments &args)
 
     setSplashScreenLoadingText(i18n("Initializing Globals..."));
     processEvents();
-    initializeGlobals(args);
+
+    {
+        KisStartupProfiler::Phase phase("Initialize globals");
+        initializeGlobals(args);
+    }
 
     const bool doNewImage = args.doNewImage();
     const bool doTemplate = args.doTemplate();
@@ -555,22 +649,33 @@ bool KisApplication::start(const KisApplicationArguments &args)
     // Make sure we can save resources and tags
     setSplashScreenLoadingText(i18n("Adding resource types..."));
     processEvents();
-    addResourceTypes();
+    {
+        KisStartupProfiler::Phase phase("Add resource types");
+        addResourceTypes();
+    }
 
     setSplashScreenLoadingText(i18n("Loading plugins..."));
     processEvents();
-    // Load the plugins
-    loadPlugins();
+    {
+        // Load the plugins
+        KisStartupProfiler::Phase phase("Load plugins");
+        loadPlugins(needsMainWindow);
+    }
 
     // Load all resources
     setSplashScreenLoadingText(i18n("Loading resources..."));
     processEvents();
-    if (!registerResources()) {
-        return false;
+    {
+        KisStartupProfiler::Phase phase("Register resources");
+        if (!registerResources()) {
+            return false;
+        }
     }
 
     KisPart *kisPart = KisPart::instance();
     if (needsMainWindow) {
+        KisStartupProfiler::Phase mainWindowPhase("Create main window");
+
         // show a mainWindow asap, if we want that
         setSplashScreenLoadingText(i18n("Loading Main Window..."));
         processEvents();
@@ -593,6 +698,7 @@ bool KisApplication::start(const KisApplicationArguments &args)
         }
 
         if (sessionNeeded) {
+            KisStartupProfiler::Phase phase("Start blank session");
             kisPart->startBlankSession();
         }
 
@@ -613,6 +719,7 @@ bool KisApplication::start(const KisApplicationArguments &args)
                 KoResourceServer<KisWorkspaceResource> * rserver = KisResourceServerProvider::instance()->workspaceServer();
                 KisWorkspaceResourceSP workspace = rserver->resource("", "", args.workspace());
                 if (workspace) {
+                    KisStartupProfiler::Phase phase("Restore workspace");
                     d->mainWindow->restoreWorkspace(workspace);
                 }
             }
@@ -658,6 +765,7 @@ bool KisApplication::start(const KisApplicationArguments &args)
 
     // Get the command line arguments which we have to parse
     int argsCount = args.filenames().count();
+    KisStartupProfiler::Phase openDocumentsPhase("Open documents");
     if (argsCount > 0) {
         // Loop through arguments
         for (int argNumber = 0; argNumber < argsCount; argNumber++) {
@@ -721,18 +829,47 @@ bool KisApplication::start(const KisApplicationArguments &args)
                     }
 
                     doc->setFileBatchMode(true);
-                    int sequenceStart = 0;
 
+                    KisTimeSpan fullRange = doc->image()->animationInterface()->documentPlaybackRange();
+                    if (args.hasExportFrameRange()) {
+                        fullRange = KisTimeSpan::fromTimeToTime(args.exportFrameRangeStart(), args.exportFrameRangeEnd());
+                    }
+
+                    const KisTimeSpan range = exportChunkRange(fullRange, args.exportChunkIndex(), args.exportChunkCount());
+                    if (!range.isValid()) {
+                        qDebug() << "The chunk" << args.exportChunkIndex() << "of" << args.exportChunkCount() << "has no frames to export";
+                        QTimer::singleShot(0, this, SLOT(quit()));
+                        return true;
+                    }
+
+                    const QStringList exportLayers = args.exportLayers();
+                    if (!exportLayers.isEmpty()) {
+                        if (!hasExportedLayers(doc->image()->root(), exportLayers)) {
+                            errKrita << "None of the layers" << exportLayers << "exist in" << fileName << Qt::endl;
+                            QTimer::singleShot(0, this, SLOT(quit()));
+                            return false;
+                        }
+
+                        hideNotExportedLayers(doc->image()->root(), exportLayers);
+                    }
+
+                    /**
+                     * The frames are numbered relative to the start of the
+                     * entire range, so every chunk writes the same files
+                     * as a single process would do for these frames
+                     */
+                    const int sequenceStart = range.start() - fullRange.start();
 
-                    qDebug() << ppVar(exportFileName);
+                    qDebug() << ppVar(exportFileName) << ppVar(range);
                     KisAsyncAnimationFramesSaveDialog exporter(doc->image(),
-                                               doc->image()->animationInterface()->documentPlaybackRange(),
+                                               range,
                                                exportFileName,
                                                sequenceStart,
                                                false,
                                                0);
 
                     exporter.setBatchMode(d->batchRun);
+                    exporter.setKeepOtherFrames(!(range == doc->image()->animationInterface()->documentPlaybackRange()));
 
                     KisAsyncAnimationFramesSaveDialog::Result result = exporter.regenerateRange(nullptr);
                     qDebug() << ppVar(result);
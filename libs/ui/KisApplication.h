@@ -85,7 +85,13 @@ public:
 
     void addResourceTypes();
     bool registerResources();
-    void loadPlugins();
+    /**
+     * Loads the plugins of the registries. The tools and dockers are
+     * needed only by the main window, so the headless export runs pass
+     * \p loadGuiPlugins = false to save loading their shared libraries.
+     * They are still loaded on demand if anything asks for them.
+     */
+    void loadPlugins(bool loadGuiPlugins = true);
     void initializeGlobals(const KisApplicationArguments &args);
     void processPostponedSynchronizationEvents();
 
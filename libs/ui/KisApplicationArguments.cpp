@@ -33,6 +33,11 @@ struct Q_DECL_HIDDEN KisApplicationArguments::Private
     bool exportAs {false};
     bool exportSequence {false};
     QString exportFileName;
+    int exportFrameRangeStart {-1};
+    int exportFrameRangeEnd {-1};
+    int exportChunkIndex {1};
+    int exportChunkCount {1};
+    QStringList exportLayers;
     QString workspace;
     QString windowLayout;
     QString session;
@@ -95,6 +100,9 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export"), i18n("Export to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-sequence"), i18n("Export animation to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-filename"), i18n("Filename for export"), QLatin1String("filename")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-frame-range"), i18n("Range of the frames to export with --export-sequence instead of the playback range of the document"), QLatin1String("start-end")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-chunk"), i18n("Split the exported range into 'count' equal parts and export only the part 'index' (1-based), keeping the files of the other parts. The frames are numbered the same way as if the entire range was exported"), QLatin1String("index/count")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-layers"), i18n("Comma-separated names of the layers to export with --export-sequence, all the other layers are hidden"), QLatin1String("names")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("file-layer"), i18n("File layer to be added to existing or new file"), QLatin1String("file-layer")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("resource-location"), i18n("A location that overrides the configured location for Krita's resources"), QLatin1String("file-layer")));
     parser.addPositionalArgument(QLatin1String("[file(s)]"), i18n("File(s) or URL(s) to open"));
@@ -186,6 +194,43 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     d->doTemplate = parser.isSet("template");
     d->exportAs = parser.isSet("export");
     d->exportSequence = parser.isSet("export-sequence");
+
+    QString frameRangeValues = parser.value("export-frame-range");
+    if (!frameRangeValues.isEmpty()) {
+        QStringList v = frameRangeValues.split("-");
+        bool startOk = false;
+        bool endOk = false;
+        const int start = v.size() == 2 ? v[0].toInt(&startOk) : -1;
+        const int end = v.size() == 2 ? v[1].toInt(&endOk) : -1;
+
+        if (startOk && endOk && start >= 0 && end >= start) {
+            d->exportFrameRangeStart = start;
+            d->exportFrameRangeEnd = end;
+        } else {
+            qWarning() << "Cannot use the frame range: please specify it as start-end.";
+        }
+    }
+
+    QString chunkValues = parser.value("export-chunk");
+    if (!chunkValues.isEmpty()) {
+        QStringList v = chunkValues.split("/");
+        bool indexOk = false;
+        bool countOk = false;
+        const int index = v.size() == 2 ? v[0].toInt(&indexOk) : -1;
+        const int count = v.size() == 2 ? v[1].toInt(&countOk) : -1;
+
+        if (indexOk && countOk && index >= 1 && index <= count) {
+            d->exportChunkIndex = index;
+            d->exportChunkCount = count;
+        } else {
+            qWarning() << "Cannot export the chunk: please specify it as index/count, where index is in the range 1...count.";
+        }
+    }
+
+    QString layersValue = parser.value("export-layers");
+    if (!layersValue.isEmpty()) {
+        d->exportLayers = layersValue.split(",", Qt::SkipEmptyParts);
+    }
     d->canvasOnly = parser.isSet("canvasonly");
     d->noSplash = parser.isSet("nosplash");
     d->fullScreen = parser.isSet("fullscreen");
@@ -207,6 +252,11 @@ KisApplicationArguments::KisApplicationArguments(const KisApplicationArguments &
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportFrameRangeStart = rhs.d->exportFrameRangeStart;
+    d->exportFrameRangeEnd = rhs.d->exportFrameRangeEnd;
+    d->exportChunkIndex = rhs.d->exportChunkIndex;
+    d->exportChunkCount = rhs.d->exportChunkCount;
+    d->exportLayers = rhs.d->exportLayers;
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
@@ -224,6 +274,11 @@ void KisApplicationArguments::operator=(const KisApplicationArguments &rhs)
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportFrameRangeStart = rhs.d->exportFrameRangeStart;
+    d->exportFrameRangeEnd = rhs.d->exportFrameRangeEnd;
+    d->exportChunkIndex = rhs.d->exportChunkIndex;
+    d->exportChunkCount = rhs.d->exportChunkCount;
+    d->exportLayers = rhs.d->exportLayers;
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
@@ -332,6 +387,36 @@ QString KisApplicationArguments::exportFileName() const
     return d->exportFileName;
 }
 
+bool KisApplicationArguments::hasExportFrameRange() const
+{
+    return d->exportFrameRangeStart >= 0;
+}
+
+int KisApplicationArguments::exportFrameRangeStart() const
+{
+    return d->exportFrameRangeStart;
+}
+
+int KisApplicationArguments::exportFrameRangeEnd() const
+{
+    return d->exportFrameRangeEnd;
+}
+
+int KisApplicationArguments::exportChunkIndex() const
+{
+    return d->exportChunkIndex;
+}
+
+int KisApplicationArguments::exportChunkCount() const
+{
+    return d->exportChunkCount;
+}
+
+QStringList KisApplicationArguments::exportLayers() const
+{
+    return d->exportLayers;
+}
+
 QString KisApplicationArguments::workspace() const
 {
     return d->workspace;
@@ -34,6 +34,27 @@ public:
     bool exportAs() const;
     bool exportSequence() const;
     QString exportFileName() const;
+
+    /**
+     * The range of the frames to export with exportSequence(). The
+     * playback range of the document is used when it is not set.
+     */
+    bool hasExportFrameRange() const;
+    int exportFrameRangeStart() const;
+    int exportFrameRangeEnd() const;
+
+    /**
+     * The part of the exported range to render, when the range is
+     * split between several processes (1-based index)
+     */
+    int exportChunkIndex() const;
+    int exportChunkCount() const;
+
+    /**
+     * The names of the layers to render with exportSequence(). Empty
+     * when all the layers should be rendered.
+     */
+    QStringList exportLayers() const;
     QString workspace() const;
     QString windowLayout() const;
     QString session() const;
@@ -14,6 +14,8 @@
 #include "kis_time_span.h"
 #include "kis_paint_layer.h"
 
+#include <QImage>
+
 
 struct KisAsyncAnimationFramesSavingRenderer::Private
 {
@@ -50,6 +52,7 @@ struct KisAsyncAnimationFramesSavingRenderer::Private
     int sequenceNumberingOffset = 0;
 
     bool onlyNeedsUniqueFrames;
+    bool pipeFrames = false;
 
     QString filenamePrefix;
     QString filenameSuffix;
@@ -83,6 +86,11 @@ KisAsyncAnimationFramesSavingRenderer::~KisAsyncAnimationFramesSavingRenderer()
 {
 }
 
+void KisAsyncAnimationFramesSavingRenderer::setPipeFrames(bool value)
+{
+    m_d->pipeFrames = value;
+}
+
 void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, const KisRegion &requestedRegion)
 {
     KisImageSP image = requestedImage();
@@ -93,6 +101,22 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
         return;
     }
 
+    if (m_d->pipeFrames) {
+        KisTimeSpan identicals = KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
+        identicals &= m_d->range;
+        const int numRepeats = identicals.isValid() ? identicals.end() - frame + 1 : 1;
+
+        const QImage frameImage =
+            image->projection()->convertToQImage(nullptr, image->bounds())
+                .convertToFormat(QImage::Format_RGBA8888);
+
+        Q_EMIT sigFrameDataReady(frame, numRepeats,
+                                 QByteArray(reinterpret_cast<const char*>(frameImage.constBits()),
+                                            frameImage.sizeInBytes()));
+        Q_EMIT sigCompleteRegenerationInternal(frame);
+        return;
+    }
+
     m_d->savingDevice->makeCloneFromRough(image->projection(), image->bounds());
 
     KisImportExportErrorCode status = ImportExportCodes::OK;
@@ -26,6 +26,12 @@ public:
                                           KisPropertiesConfigurationSP exportConfiguration);
     ~KisAsyncAnimationFramesSavingRenderer();
 
+    /**
+     * When enabled, the rendered frames are not saved into files, but
+     * are emitted with sigFrameDataReady() as raw RGBA pixels in sRGB.
+     */
+    void setPipeFrames(bool value);
+
 protected:
     void frameCompletedCallback(int frame, const KisRegion &requestedRegion) override;
     void frameCancelledCallback(int frame, CancelReason cancelReason) override;
@@ -34,6 +40,12 @@ Q_SIGNALS:
     void sigCompleteRegenerationInternal(int frame);
     void sigCancelRegenerationInternal(int frame, KisAsyncAnimationRendererBase::CancelReason cancelReason);
 
+    /**
+     * Emitted from the rendering thread in the piping mode. \p numRepeats is
+     * the number of the frames of the range that are identical to \p frame.
+     */
+    void sigFrameDataReady(int frame, int numRepeats, const QByteArray &data);
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
@@ -356,7 +356,9 @@ public:
     int autoSaveDelay = 300; // in seconds, 0 to disable.
     bool modifiedAfterAutosave = false;
     bool isAutosaving = false;
+    bool autoSaveCloningInProgress = false;
     bool disregardAutosaveFailure = false;
+    KisTileSavingCacheSP autosaveTileCache;
     int autoSaveFailureCount = 0;
 
     KUndo2Stack *undoStack = 0;
@@ -396,6 +398,8 @@ public:
     QVector<QFileInfo> audioTracks;
     qreal audioLevel = 1.0;
 
+    QImage storedLodComposite;
+
     QColor globalAssistantsColor;
     QList<KoColor> colorHistory;
 
@@ -1393,6 +1397,12 @@ KritaUtils::BackgroudSavingStartResult KisDocument::initiateSavingInBackground(c
 
     if (d->backgroundSaveJob.flags & KritaUtils::SaveInAutosaveMode) {
         d->backgroundSaveDocument->d->isAutosaving = true;
+
+        if (!d->autosaveTileCache) {
+            d->autosaveTileCache.reset(new KisTileSavingCache());
+        }
+        d->autosaveTileCache->beginPass();
+        d->backgroundSaveDocument->d->autosaveTileCache = d->autosaveTileCache;
     }
 
     connect(d->backgroundSaveDocument.data(),
@@ -1441,6 +1451,15 @@ void KisDocument::slotChildCompletedSavingInBackground(KisImportExportErrorCode
 
     if (d->backgroundSaveJob.flags & KritaUtils::SaveInAutosaveMode) {
         d->backgroundSaveDocument->d->isAutosaving = false;
+        d->backgroundSaveDocument->d->autosaveTileCache.clear();
+
+        /**
+         * Drop the tiles that have changed since the previous autosave,
+         * we don't need to keep the old versions of them anymore
+         */
+        if (d->autosaveTileCache) {
+            d->autosaveTileCache->endPass();
+        }
     }
 
     d->backgroundSaveDocument.take()->deleteLater();
@@ -1465,26 +1484,18 @@ void KisDocument::slotChildCompletedSavingInBackground(KisImportExportErrorCode
 void KisDocument::slotAutoSaveImpl(std::unique_ptr<KisDocument> &&optionalClonedDocument)
 {
     if (!d->modified || !d->modifiedAfterAutosave) return;
-    const QString autoSaveFileName = generateAutoSaveFileName(localFilePath());
 
-    Q_EMIT statusBarMessage(i18n("Autosaving... %1", autoSaveFileName), successMessageTimeout);
-
-    KisUsageLogger::log(QString("Autosaving: %1").arg(autoSaveFileName));
-
-    const bool hadClonedDocument = bool(optionalClonedDocument);
-    KritaUtils::BackgroudSavingStartResult result = KritaUtils::BackgroudSavingStartResult::Failure;
-
-    if (d->image->isIdle() || hadClonedDocument) {
-        result = initiateSavingInBackground(i18n("Autosaving..."),
-                                             this, SLOT(slotCompleteAutoSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString, QString)),
-                                             KritaUtils::ExportFileJob(autoSaveFileName, nativeFormatMimeType(), KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode),
-                                             0,
-                                             std::move(optionalClonedDocument));
-    } else {
-        Q_EMIT statusBarMessage(i18n("Autosaving postponed: document is busy..."), errorMessageTimeout);
-    }
+    if (!optionalClonedDocument) {
+        if (d->autoSaveCloningInProgress) return;
 
-    if (result != KritaUtils::BackgroudSavingStartResult::Success && !hadClonedDocument && d->autoSaveFailureCount >= 3) {
+        /**
+         * The snapshot of the document is taken in a stroke, which
+         * clones the document in a worker thread as soon as the strokes
+         * in progress are finished. The clone shares the tile data with
+         * the document (copy-on-write), so no pixel data is copied, the
+         * GUI thread is not blocked and the stroke of the user is not
+         * interrupted, as it would happen with lockAndCloneForSaving().
+         */
         KisCloneDocumentStroke *stroke = new KisCloneDocumentStroke(this);
         connect(stroke, SIGNAL(sigDocumentCloned(KisDocument*)),
                 this, SLOT(slotInitiateAsyncAutosaving(KisDocument*)),
@@ -1493,12 +1504,29 @@ void KisDocument::slotAutoSaveImpl(std::unique_ptr<KisDocument> &&optionalCloned
                 this, SLOT(slotDocumentCloningCancelled()),
                 Qt::BlockingQueuedConnection);
 
+        d->autoSaveCloningInProgress = true;
+
         KisStrokeId strokeId = d->image->startStroke(stroke);
         d->image->endStroke(strokeId);
 
         setInfiniteAutoSaveInterval();
+        return;
+    }
 
-    } else if (result != KritaUtils::BackgroudSavingStartResult::Success) {
+    const QString autoSaveFileName = generateAutoSaveFileName(localFilePath());
+
+    Q_EMIT statusBarMessage(i18n("Autosaving... %1", autoSaveFileName), successMessageTimeout);
+
+    KisUsageLogger::log(QString("Autosaving: %1").arg(autoSaveFileName));
+
+    KritaUtils::BackgroudSavingStartResult result =
+        initiateSavingInBackground(i18n("Autosaving..."),
+                                   this, SLOT(slotCompleteAutoSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString, QString)),
+                                   KritaUtils::ExportFileJob(autoSaveFileName, nativeFormatMimeType(), KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode),
+                                   0,
+                                   std::move(optionalClonedDocument));
+
+    if (result != KritaUtils::BackgroudSavingStartResult::Success) {
         setEmergencyAutoSaveInterval();
     } else {
         d->modifiedAfterAutosave = false;
@@ -1594,11 +1622,17 @@ void KisDocument::slotAutoSave()
 
 void KisDocument::slotInitiateAsyncAutosaving(KisDocument *clonedDocument)
 {
+    d->autoSaveCloningInProgress = false;
+
+    // the resources model can be accessed from the GUI thread only
+    clonedDocument->d->uploadLinkedResourcesFromLayersToStorage();
+
     slotAutoSaveImpl(std::unique_ptr<KisDocument>(clonedDocument));
 }
 
 void KisDocument::slotDocumentCloningCancelled()
 {
+    d->autoSaveCloningInProgress = false;
     setEmergencyAutoSaveInterval();
 }
 
@@ -2283,6 +2317,7 @@ void KisDocument::slotConfigChanged()
         }
         d->undoStack->setUndoLimit(cfg.undoStackLimit());
     }
+    d->undoStack->setUndoMemoryLimit(qint64(cfg.undoStackMemoryLimit()) * 1024 * 1024);
     d->undoStack->setUseCumulativeUndoRedo(cfg.useCumulativeUndoRedo());
     d->undoStack->setCumulativeUndoData(cfg.cumulativeUndoData());
 
@@ -2437,6 +2472,16 @@ qreal KisDocument::getAudioLevel()
     return d->audioLevel;
 }
 
+QImage KisDocument::storedLodComposite() const
+{
+    return d->storedLodComposite;
+}
+
+void KisDocument::setStoredLodComposite(const QImage &image)
+{
+    d->storedLodComposite = image;
+}
+
 const KisGuidesConfig& KisDocument::guidesConfig() const
 {
     return d->guidesConfig;
@@ -2859,6 +2904,11 @@ bool KisDocument::isAutosaving() const
     return d->isAutosaving;
 }
 
+KisTileSavingCacheSP KisDocument::tileSavingCache() const
+{
+    return d->isAutosaving ? d->autosaveTileCache : KisTileSavingCacheSP();
+}
+
 QString KisDocument::exportErrorToUserMessage(KisImportExportErrorCode status, const QString &errorMessage)
 {
     return errorMessage.isEmpty() ? status.errorMessage() : errorMessage;
@@ -11,6 +11,7 @@
 #include <QDateTime>
 #include <QList>
 #include <QFileInfo>
+#include <QImage>
 
 #include <klocalizedstring.h>
 
@@ -26,6 +27,7 @@
 #include <kis_debug.h>
 #include <KisImportExportUtils.h>
 #include <kis_config.h>
+#include <tiles3/KisTileSavingCache.h>
 #include "StoryboardItem.h"
 
 #include "kritaui_export.h"
@@ -408,6 +410,14 @@ public:
     void setAudioVolume(qreal level);
     qreal getAudioLevel();
 
+    /**
+     * The low-resolution composite of the image stored in the file
+     * (if any). It can be shown by the overview widgets while the
+     * projection of the just opened image is being recalculated.
+     */
+    QImage storedLodComposite() const;
+    void setStoredLodComposite(const QImage &image);
+
     const KisMirrorAxisConfig& mirrorAxisConfig() const;
     void setMirrorAxisConfig(const KisMirrorAxisConfig& config);
 
@@ -482,6 +492,13 @@ Q_SIGNALS:
 
     void sigLoadingFinished();
 
+    /**
+     * Emitted while the document is being imported by the filters
+     * that decode the image progressively, the GUI may show the
+     * preview until the loading is finished
+     */
+    void sigImportPreviewUpdated(const QImage &preview);
+
     void sigSavingFinished(const QString &filePath);
 
     void sigGuidesConfigChanged(const KisGuidesConfig &config);
@@ -577,6 +594,14 @@ public:
 
     bool isAutosaving() const;
 
+    /**
+     * The cache of the serialized tiles shared by the autosaves of
+     * the document, so that the autosave compresses only the tiles
+     * changed since the previous one. Returns null unless the document
+     * is the clone being autosaved.
+     */
+    KisTileSavingCacheSP tileSavingCache() const;
+
 public:
 
     QString localFilePath() const;
@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDocumentMemoryBudgeter.h"
+
+#include <KisDocument.h>
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_layer_utils.h>
+#include <kis_paint_layer.h>
+
+#include "kis_animation_frame_cache.h"
+
+
+KisDocumentMemoryBudgeter::KisDocumentMemoryBudgeter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+KisDocumentMemoryBudgeter::~KisDocumentMemoryBudgeter()
+{
+}
+
+void KisDocumentMemoryBudgeter::activeDocumentChanged(KisDocument *document)
+{
+    removeDeletedDocuments();
+
+    m_recentDocuments.removeAll(document);
+    m_recentDocuments.prepend(document);
+}
+
+bool KisDocumentMemoryBudgeter::isImageInactive(KisImageSP image) const
+{
+    Q_FOREACH (KisDocument *document, inactiveDocuments()) {
+        if (document->image() == image) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void KisDocumentMemoryBudgeter::slotDropInactiveCaches()
+{
+    removeDeletedDocuments();
+
+    Q_FOREACH (KisDocument *document, inactiveDocuments()) {
+        KisImageSP image = document->image();
+        if (!image) continue;
+
+        KisAnimationFrameCacheSP frameCache = KisAnimationFrameCache::cacheForImage(image);
+        if (frameCache) {
+            frameCache->dropAllFrames();
+        }
+
+        /**
+         * The onion skins are read by the update threads, so we can
+         * drop them only while the image is not being updated. It is
+         * not a problem to skip the image now, we will have another
+         * chance on the next idle event.
+         */
+        if (image->tryBarrierLock(true)) {
+            KisLayerUtils::recursiveApplyNodes(image->root(),
+                [] (KisNodeSP node) {
+                    KisPaintLayer *layer = dynamic_cast<KisPaintLayer*>(node.data());
+                    if (layer) {
+                        layer->flushOnionSkinCache();
+                    }
+                });
+
+            image->unlock();
+        }
+    }
+}
+
+void KisDocumentMemoryBudgeter::removeDeletedDocuments()
+{
+    m_recentDocuments.removeAll(QPointer<KisDocument>());
+}
+
+QList<KisDocument*> KisDocumentMemoryBudgeter::inactiveDocuments() const
+{
+    QList<KisDocument*> result;
+
+    const int numDocumentsWithCaches = KisImageConfig(true).numDocumentsWithCaches();
+    if (numDocumentsWithCaches <= 0) return result;
+
+    for (int i = numDocumentsWithCaches; i < m_recentDocuments.size(); i++) {
+        if (m_recentDocuments[i]) {
+            result << m_recentDocuments[i];
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,56 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDOCUMENTMEMORYBUDGETER_H
+#define KISDOCUMENTMEMORYBUDGETER_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+
+#include "kritaui_export.h"
+#include "kis_types.h"
+
+class KisDocument;
+
+/**
+ * Ranks the open documents by the time they were last activated and
+ * drops the optional caches (animation frames, onion skins) of the
+ * documents that fall out of the KisImageConfig::numDocumentsWithCaches()
+ * most recently used ones. The caches are dropped when Krita becomes
+ * idle; the animation cache populator doesn't regenerate them until
+ * the document is activated again.
+ */
+class KRITAUI_EXPORT KisDocumentMemoryBudgeter : public QObject
+{
+    Q_OBJECT
+public:
+    KisDocumentMemoryBudgeter(QObject *parent = nullptr);
+    ~KisDocumentMemoryBudgeter() override;
+
+    /**
+     * Moves \p document to the top of the ranking
+     */
+    void activeDocumentChanged(KisDocument *document);
+
+    /**
+     * @return true if \p image belongs to a document whose caches
+     *         may be dropped
+     */
+    bool isImageInactive(KisImageSP image) const;
+
+public Q_SLOTS:
+    void slotDropInactiveCaches();
+
+private:
+    void removeDeletedDocuments();
+    QList<KisDocument*> inactiveDocuments() const;
+
+private:
+    QList<QPointer<KisDocument>> m_recentDocuments;
+};
+
+#endif // KISDOCUMENTMEMORYBUDGETER_H
@@ -9,6 +9,7 @@
 #include "kis_update_info.h"
 #include "KisFrameDataSerializer.h"
 #include "opengl/KisOpenGLUpdateInfoBuilder.h"
+#include "kis_memory_statistics_server.h"
 
 #define SANITY_CHECK
 
@@ -120,6 +121,11 @@ struct KRITAUI_NO_EXPORT KisFrameCacheStore::Private
     {
     }
 
+    Private(KisFrameDataSerializer::StorageType storageType)
+        : serializer(storageType)
+    {
+    }
+
     // the serializer should be killed after *all* the frame info objects
     // got destroyed, because they use it in their own destruction
     KisFrameDataSerializer serializer;
@@ -131,8 +137,40 @@ struct KRITAUI_NO_EXPORT KisFrameCacheStore::Private
     FrameInfoSP lastLoadedBaseFrameInfo;
 
     QMap<int, FrameInfoSP> savedFrames;
+
+    qint64 reportedMemoryUsage = 0;
+
+    static qint64 frameMemoryUsage(const KisFrameDataSerializer::Frame &frame);
+    void updateMemoryUsage();
 };
 
+qint64 KisFrameCacheStore::Private::frameMemoryUsage(const KisFrameDataSerializer::Frame &frame)
+{
+    qint64 result = 0;
+
+    for (auto it = frame.frameTiles.begin(); it != frame.frameTiles.end(); ++it) {
+        result += qint64(frame.pixelSize) * it->rect.width() * it->rect.height();
+    }
+
+    return result;
+}
+
+void KisFrameCacheStore::Private::updateMemoryUsage()
+{
+    /**
+     * Only the two cached full frames are kept in RAM, the
+     * rest of the frames live in the serializer's files
+     */
+    const qint64 usage =
+        frameMemoryUsage(lastSavedFullFrame) +
+        frameMemoryUsage(lastLoadedBaseFrame);
+
+    if (usage != reportedMemoryUsage) {
+        KisMemoryStatisticsServer::instance()->addFrameCacheMemoryUsage(usage - reportedMemoryUsage);
+        reportedMemoryUsage = usage;
+    }
+}
+
 KisFrameCacheStore::KisFrameCacheStore()
     : KisFrameCacheStore(QString())
 {
@@ -143,9 +181,15 @@ KisFrameCacheStore::KisFrameCacheStore(const QString &frameCachePath)
 {
 }
 
+KisFrameCacheStore::KisFrameCacheStore(KisFrameDataSerializer::StorageType storageType)
+    : m_d(new Private(storageType))
+{
+}
+
 
 KisFrameCacheStore::~KisFrameCacheStore()
 {
+    KisMemoryStatisticsServer::instance()->addFrameCacheMemoryUsage(-m_d->reportedMemoryUsage);
 }
 
 void KisFrameCacheStore::saveFrame(int frameId, KisOpenGLUpdateInfoSP info, const QRect &imageBounds)
@@ -240,6 +284,8 @@ void KisFrameCacheStore::saveFrame(int frameId, KisOpenGLUpdateInfoSP info, cons
         m_d->lastSavedFullFrame = std::move(frame);
         m_d->lastSavedFullFrameId = frameId;
     }
+
+    m_d->updateMemoryUsage();
 }
 
 KisOpenGLUpdateInfoSP KisFrameCacheStore::loadFrame(int frameId, const KisOpenGLUpdateInfoBuilder &builder)
@@ -295,6 +341,8 @@ KisOpenGLUpdateInfoSP KisFrameCacheStore::loadFrame(int frameId, const KisOpenGL
     }
     }
 
+    m_d->updateMemoryUsage();
+
     for (auto it = frame.frameTiles.begin(); it != frame.frameTiles.end(); ++it) {
         KisFrameDataSerializer::FrameTile &tile = *it;
 
@@ -352,6 +400,8 @@ void KisFrameCacheStore::forgetFrame(int frameId)
     }
 
     m_d->savedFrames.remove(frameId);
+
+    m_d->updateMemoryUsage();
 }
 
 bool KisFrameCacheStore::hasFrame(int frameId) const
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 #include "opengl/kis_texture_tile_info_pool.h"
+#include "KisFrameDataSerializer.h"
 
 class KisOpenGLUpdateInfoBuilder;
 
@@ -40,6 +41,7 @@ class KRITAUI_EXPORT KisFrameCacheStore
 public:
     KisFrameCacheStore();
     KisFrameCacheStore(const QString &frameCachePath);
+    explicit KisFrameCacheStore(KisFrameDataSerializer::StorageType storageType);
 
     ~KisFrameCacheStore();
 
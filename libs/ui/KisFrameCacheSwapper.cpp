@@ -18,6 +18,12 @@ struct KisFrameCacheSwapper::Private
     {
     }
 
+    Private(const KisOpenGLUpdateInfoBuilder &_builder, KisFrameDataSerializer::StorageType storageType)
+        : frameStore(storageType),
+          builder(_builder)
+    {
+    }
+
     KisFrameCacheStore frameStore;
     const KisOpenGLUpdateInfoBuilder &builder;
 };
@@ -32,6 +38,11 @@ KisFrameCacheSwapper::KisFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &bui
 {
 }
 
+KisFrameCacheSwapper::KisFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder, KisFrameDataSerializer::StorageType storageType)
+    : m_d(new Private(builder, storageType))
+{
+}
+
 KisFrameCacheSwapper::~KisFrameCacheSwapper()
 {
 }
@@ -9,6 +9,7 @@
 #include <QScopedPointer>
 
 #include "KisAbstractFrameCacheSwapper.h"
+#include "KisFrameDataSerializer.h"
 
 class KisOpenGLUpdateInfoBuilder;
 
@@ -30,6 +31,7 @@ class KRITAUI_EXPORT KisFrameCacheSwapper : public KisAbstractFrameCacheSwapper
 public:
     KisFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder);
     KisFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder, const QString &frameCachePath);
+    KisFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder, KisFrameDataSerializer::StorageType storageType);
     ~KisFrameCacheSwapper();
 
     // WARNING: after transferring \p info to saveFrame() the object becomes invalid
@@ -7,22 +7,68 @@
 
 #include <cstring>
 
+#include <QBuffer>
+#include <QHash>
 #include <QTemporaryDir>
-#include <QElapsedTimer>
 
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "kis_memory_statistics_server.h"
+
+namespace {
+
+/**
+ * The values of RawTile and LzfTile coincide with the serialized
+ * false/true values of the old boolean compression flag
+ */
+enum TileEncoding : quint8 {
+    RawTile = 0,
+    LzfTile = 1,
+    ZeroTile = 2
+};
+
+/**
+ * The transparent areas of the full frames and the unchanged areas of
+ * the difference frames are filled with zeros, so such tiles are saved
+ * without any data at all
+ */
+bool isZeroData(const quint8 *data, int numBytes)
+{
+    const int numQWords = numBytes / 8;
+    const quint64 *qwordPtr = reinterpret_cast<const quint64*>(data);
+
+    for (int i = 0; i < numQWords; i++) {
+        if (qwordPtr[i]) return false;
+    }
+
+    for (int i = numQWords * 8; i < numBytes; i++) {
+        if (data[i]) return false;
+    }
+
+    return true;
+}
+
+}
 
 struct KRITAUI_NO_EXPORT KisFrameDataSerializer::Private
 {
-    Private(const QString &frameCachePath)
-        : framesDir(
-              (!frameCachePath.isEmpty() && QTemporaryDir(frameCachePath + "/KritaFrameCacheXXXXXX").isValid()
-               ? frameCachePath
-               : QDir::tempPath())
-              + "/KritaFrameCacheXXXXXX")
+    Private(const QString &frameCachePath, StorageType _storageType)
+        : storageType(_storageType)
+    {
+        if (storageType == OnDiskStorage) {
+            framesDir.reset(new QTemporaryDir(
+                (!frameCachePath.isEmpty() && QTemporaryDir(frameCachePath + "/KritaFrameCacheXXXXXX").isValid()
+                 ? frameCachePath
+                 : QDir::tempPath())
+                + "/KritaFrameCacheXXXXXX"));
+
+            framesDirObject = QDir(framesDir->path());
+            framesDirObject.makeAbsolute();
+        }
+    }
+
+    ~Private()
     {
-        framesDirObject = QDir(framesDir.path());
-        framesDirObject.makeAbsolute();
+        KisMemoryStatisticsServer::instance()->addFrameCacheMemoryUsage(-memoryFramesSize);
     }
 
     QString subfolderNameForFrame(int frameId)
@@ -54,52 +100,38 @@ struct KRITAUI_NO_EXPORT KisFrameDataSerializer::Private
         return reinterpret_cast<quint8*>(compressionBuffer.data());
     }
 
-    QTemporaryDir framesDir;
+    void addMemoryFrame(int frameId, const QByteArray &data) {
+        memoryFrames.insert(frameId, data);
+        memoryFramesSize += data.size();
+        KisMemoryStatisticsServer::instance()->addFrameCacheMemoryUsage(data.size());
+    }
+
+    void removeMemoryFrame(int frameId) {
+        const qint64 size = memoryFrames.take(frameId).size();
+        memoryFramesSize -= size;
+        KisMemoryStatisticsServer::instance()->addFrameCacheMemoryUsage(-size);
+    }
+
+    void writeFrame(QIODevice *device, int frameId, const Frame &frame);
+    Frame readFrame(QIODevice *device, int frameId, KisTextureTileInfoPoolSP pool);
+
+    StorageType storageType;
+
+    QScopedPointer<QTemporaryDir> framesDir;
     QDir framesDirObject;
     int nextFrameId = 0;
 
+    QHash<int, QByteArray> memoryFrames;
+    qint64 memoryFramesSize = 0;
+
     QByteArray compressionBuffer;
 };
 
-KisFrameDataSerializer::KisFrameDataSerializer()
-    : KisFrameDataSerializer(QString())
-{
-}
-
-KisFrameDataSerializer::KisFrameDataSerializer(const QString &frameCachePath)
-    : m_d(new Private(frameCachePath))
-{
-}
-
-KisFrameDataSerializer::~KisFrameDataSerializer()
-{
-}
-
-int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame)
+void KisFrameDataSerializer::Private::writeFrame(QIODevice *device, int frameId, const Frame &frame)
 {
     KisLzfCompression compression;
 
-    const int frameId = m_d->generateFrameId();
-
-    const QString frameSubfolder = m_d->subfolderNameForFrame(frameId);
-
-    if (!m_d->framesDirObject.exists(frameSubfolder)) {
-        m_d->framesDirObject.mkpath(frameSubfolder);
-    }
-
-    const QString frameRelativePath = frameSubfolder + '/' + m_d->fileNameForFrame(frameId);
-
-    if (m_d->framesDirObject.exists(frameRelativePath)) {
-        qWarning() << "WARNING: overwriting existing frame file!" << frameRelativePath;
-        forgetFrame(frameId);
-    }
-
-    const QString frameFilePath = m_d->framesDirObject.filePath(frameRelativePath);
-
-    QFile file(frameFilePath);
-    file.open(QFile::WriteOnly);
-
-    QDataStream stream(&file);
+    QDataStream stream(device);
     stream << frameId;
     stream << frame.pixelSize;
 
@@ -113,8 +145,15 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
         stream << tile.rect;
 
         const int frameByteSize = frame.pixelSize * tile.rect.width() * tile.rect.height();
+
+        if (isZeroData(tile.data.data(), frameByteSize)) {
+            stream << quint8(ZeroTile);
+            stream << 0;
+            continue;
+        }
+
         const int maxBufferSize = compression.outputBufferSize(frameByteSize);
-        quint8 *buffer = m_d->getCompressionBuffer(maxBufferSize);
+        quint8 *buffer = getCompressionBuffer(maxBufferSize);
 
         const int compressedSize =
             compression.compress(tile.data.data(), frameByteSize, buffer, maxBufferSize);
@@ -122,7 +161,7 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
         //ENTER_FUNCTION() << ppVar(compressedSize) << ppVar(frameByteSize);
 
         const bool isCompressed = compressedSize < frameByteSize;
-        stream << isCompressed;
+        stream << quint8(isCompressed ? LzfTile : RawTile);
 
         if (isCompressed) {
             stream << compressedSize;
@@ -132,31 +171,22 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
             stream.writeRawData((char*)tile.data.data(), frameByteSize);
         }
     }
-
-    file.close();
-
-    return frameId;
 }
 
-KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, KisTextureTileInfoPoolSP pool)
+KisFrameDataSerializer::Frame KisFrameDataSerializer::Private::readFrame(QIODevice *device, int frameId, KisTextureTileInfoPoolSP pool)
 {
     KisLzfCompression compression;
 
-    QElapsedTimer loadingTime;
-    loadingTime.start();
-
     int loadedFrameId = -1;
     KisFrameDataSerializer::Frame frame;
 
-    qint64 compressionTime = 0;
+    /**
+     * The in-memory frames are decompressed straight from the blob
+     * into the tile buffers, without copying the payload first
+     */
+    QBuffer *memoryDevice = qobject_cast<QBuffer*>(device);
 
-    const QString framePath = m_d->filePathForFrame(frameId);
-
-    QFile file(framePath);
-    KIS_SAFE_ASSERT_RECOVER_NOOP(file.exists());
-    if (!file.open(QFile::ReadOnly)) return frame;
-
-    QDataStream stream(&file);
+    QDataStream stream(device);
 
     int numTiles = 0;
 
@@ -165,8 +195,6 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
     stream >> numTiles;
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(loadedFrameId == frameId, KisFrameDataSerializer::Frame());
 
-
-
     for (int i = 0; i < numTiles; i++) {
         FrameTile tile(pool);
         stream >> tile.col;
@@ -177,26 +205,37 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(frameByteSize <= pool->chunkSize(frame.pixelSize),
                                              KisFrameDataSerializer::Frame());
 
-        bool isCompressed = false;
+        quint8 encoding = RawTile;
         int inputSize = -1;
 
-        stream >> isCompressed;
+        stream >> encoding;
         stream >> inputSize;
 
-        if (isCompressed) {
-            const int maxBufferSize = compression.outputBufferSize(inputSize);
-            quint8 *buffer = m_d->getCompressionBuffer(maxBufferSize);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(inputSize >= 0, KisFrameDataSerializer::Frame());
+
+        const quint8 *input = 0;
+
+        if (memoryDevice) {
+            KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(memoryDevice->pos() + inputSize <= memoryDevice->size(),
+                                                 KisFrameDataSerializer::Frame());
+
+            input = reinterpret_cast<const quint8*>(memoryDevice->data().constData()) + memoryDevice->pos();
+            stream.skipRawData(inputSize);
+        } else if (encoding == LzfTile) {
+            quint8 *buffer = getCompressionBuffer(compression.outputBufferSize(inputSize));
             stream.readRawData((char*)buffer, inputSize);
+            input = buffer;
+        }
 
-            tile.data.allocate(frame.pixelSize);
+        tile.data.allocate(frame.pixelSize);
 
-            QElapsedTimer compTime;
-            compTime.start();
+        if (encoding == ZeroTile) {
+            KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(inputSize == 0, KisFrameDataSerializer::Frame());
+            memset(tile.data.data(), 0, frameByteSize);
 
+        } else if (encoding == LzfTile) {
             const int decompressedSize =
-                compression.decompress(buffer, inputSize, tile.data.data(), frameByteSize);
-
-            compressionTime += compTime.nsecsElapsed();
+                compression.decompress(input, inputSize, tile.data.data(), frameByteSize);
 
             KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(frameByteSize == decompressedSize,
                                                  KisFrameDataSerializer::Frame());
@@ -205,15 +244,94 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
             KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(frameByteSize == inputSize,
                                                  KisFrameDataSerializer::Frame());
 
-            tile.data.allocate(frame.pixelSize);
-            stream.readRawData((char*)tile.data.data(), inputSize);
+            if (input) {
+                memcpy(tile.data.data(), input, inputSize);
+            } else {
+                stream.readRawData((char*)tile.data.data(), inputSize);
+            }
         }
 
         frame.frameTiles.push_back(std::move(tile));
     }
 
-    Q_UNUSED(compressionTime);
+    return frame;
+}
+
+KisFrameDataSerializer::KisFrameDataSerializer()
+    : KisFrameDataSerializer(QString())
+{
+}
+
+KisFrameDataSerializer::KisFrameDataSerializer(const QString &frameCachePath)
+    : m_d(new Private(frameCachePath, OnDiskStorage))
+{
+}
+
+KisFrameDataSerializer::KisFrameDataSerializer(StorageType storageType)
+    : m_d(new Private(QString(), storageType))
+{
+}
+
+KisFrameDataSerializer::~KisFrameDataSerializer()
+{
+}
+
+int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame)
+{
+    const int frameId = m_d->generateFrameId();
+
+    if (m_d->storageType == InMemoryStorage) {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        m_d->writeFrame(&buffer, frameId, frame);
+        buffer.close();
+
+        m_d->addMemoryFrame(frameId, data);
+        return frameId;
+    }
+
+    const QString frameSubfolder = m_d->subfolderNameForFrame(frameId);
 
+    if (!m_d->framesDirObject.exists(frameSubfolder)) {
+        m_d->framesDirObject.mkpath(frameSubfolder);
+    }
+
+    const QString frameRelativePath = frameSubfolder + '/' + m_d->fileNameForFrame(frameId);
+
+    if (m_d->framesDirObject.exists(frameRelativePath)) {
+        qWarning() << "WARNING: overwriting existing frame file!" << frameRelativePath;
+        forgetFrame(frameId);
+    }
+
+    const QString frameFilePath = m_d->framesDirObject.filePath(frameRelativePath);
+
+    QFile file(frameFilePath);
+    file.open(QFile::WriteOnly);
+    m_d->writeFrame(&file, frameId, frame);
+    file.close();
+
+    return frameId;
+}
+
+KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, KisTextureTileInfoPoolSP pool)
+{
+    if (m_d->storageType == InMemoryStorage) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->memoryFrames.contains(frameId), KisFrameDataSerializer::Frame());
+
+        QBuffer buffer;
+        buffer.setData(m_d->memoryFrames.value(frameId));
+        buffer.open(QIODevice::ReadOnly);
+        return m_d->readFrame(&buffer, frameId, pool);
+    }
+
+    const QString framePath = m_d->filePathForFrame(frameId);
+
+    QFile file(framePath);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(file.exists());
+    if (!file.open(QFile::ReadOnly)) return KisFrameDataSerializer::Frame();
+
+    KisFrameDataSerializer::Frame frame = m_d->readFrame(&file, frameId, pool);
     file.close();
 
     return frame;
@@ -221,6 +339,17 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
 
 void KisFrameDataSerializer::moveFrame(int srcFrameId, int dstFrameId)
 {
+    if (m_d->storageType == InMemoryStorage) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->memoryFrames.contains(srcFrameId));
+
+        KIS_SAFE_ASSERT_RECOVER(!m_d->memoryFrames.contains(dstFrameId)) {
+            m_d->removeMemoryFrame(dstFrameId);
+        }
+
+        m_d->memoryFrames.insert(dstFrameId, m_d->memoryFrames.take(srcFrameId));
+        return;
+    }
+
     const QString srcFramePath = m_d->filePathForFrame(srcFrameId);
     const QString dstFramePath = m_d->filePathForFrame(dstFrameId);
     KIS_SAFE_ASSERT_RECOVER_RETURN(QFileInfo(srcFramePath).exists());
@@ -234,12 +363,21 @@ void KisFrameDataSerializer::moveFrame(int srcFrameId, int dstFrameId)
 
 bool KisFrameDataSerializer::hasFrame(int frameId) const
 {
+    if (m_d->storageType == InMemoryStorage) {
+        return m_d->memoryFrames.contains(frameId);
+    }
+
     const QString framePath = m_d->filePathForFrame(frameId);
     return QFileInfo(framePath).exists();
 }
 
 void KisFrameDataSerializer::forgetFrame(int frameId)
 {
+    if (m_d->storageType == InMemoryStorage) {
+        m_d->removeMemoryFrame(frameId);
+        return;
+    }
+
     const QString framePath = m_d->filePathForFrame(frameId);
     QFile::remove(framePath);
 }
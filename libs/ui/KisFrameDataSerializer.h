@@ -27,7 +27,8 @@ class QString;
  *    which contains raw data in it (the data may be not a pixel data,
  *    but a preprocessed pixel differences)
  *
- * 2) Compress this data and save it on disk
+ * 2) Compress this data and save it on disk or in a compressed
+ *    in-memory blob
  */
 
 class KRITAUI_EXPORT KisFrameDataSerializer
@@ -94,9 +95,22 @@ public:
         }
     };
 
+    enum StorageType {
+        OnDiskStorage,
+        InMemoryStorage
+    };
+
 public:
     KisFrameDataSerializer();
     KisFrameDataSerializer(const QString &frameCachePath);
+
+    /**
+     * With InMemoryStorage the compressed frames are kept in RAM and are
+     * decompressed directly into the buffers of the texture tiles on
+     * loading. OnDiskStorage saves the frames into the system temporary
+     * directory.
+     */
+    explicit KisFrameDataSerializer(StorageType storageType);
     ~KisFrameDataSerializer();
 
     int saveFrame(const Frame &frame);
@@ -17,6 +17,7 @@ KisIdleTaskStrokeStrategy::KisIdleTaskStrokeStrategy(const QLatin1String &id, co
     setRequestsOtherStrokesToEnd(false);
     setClearsRedoOnStart(false);
     setCanForgetAboutMe(true);
+    setPriority(BACKGROUND_PRIORITY);
 }
 
 KisIdleTaskStrokeStrategy::~KisIdleTaskStrokeStrategy() = default;
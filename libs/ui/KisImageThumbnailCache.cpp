@@ -0,0 +1,106 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisImageThumbnailCache.h"
+
+#include <QMutexLocker>
+#include <QtMath>
+
+#include <kis_paint_device.h>
+#include "krita_utils.h"
+
+void KisImageThumbnailCache::addDirtyRect(const QRect &rc)
+{
+    QMutexLocker l(&m_mutex);
+
+    if (!m_device) return;
+
+    const QRect dirtyRect = rc & m_imageRect;
+    if (dirtyRect.isEmpty()) return;
+
+    /**
+     * Every pixel of the thumbnail samples a single pixel of the image,
+     * so the mapping is exact up to the rounding. One pixel of margin
+     * covers the rounding.
+     */
+    const qreal xScale = qreal(m_thumbnailSize.width()) / m_imageRect.width();
+    const qreal yScale = qreal(m_thumbnailSize.height()) / m_imageRect.height();
+
+    const QRect thumbnailRect =
+        QRect(QPoint(qFloor((dirtyRect.left() - m_imageRect.left()) * xScale) - 1,
+                     qFloor((dirtyRect.top() - m_imageRect.top()) * yScale) - 1),
+              QPoint(qCeil((dirtyRect.right() + 1 - m_imageRect.left()) * xScale) + 1,
+                     qCeil((dirtyRect.bottom() + 1 - m_imageRect.top()) * yScale) + 1))
+        & QRect(QPoint(), m_thumbnailSize);
+
+    if (thumbnailRect.isEmpty()) return;
+
+    const int firstColumn = thumbnailRect.left() / m_tileSize.width();
+    const int lastColumn = thumbnailRect.right() / m_tileSize.width();
+    const int firstRow = thumbnailRect.top() / m_tileSize.height();
+    const int lastRow = thumbnailRect.bottom() / m_tileSize.height();
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const int index = row * m_numColumns + column;
+            m_dirty[index] = true;
+            m_generations[index]++;
+        }
+    }
+}
+
+void KisImageThumbnailCache::invalidate()
+{
+    QMutexLocker l(&m_mutex);
+    m_device = 0;
+}
+
+KisPaintDeviceSP KisImageThumbnailCache::prepare(const QRect &imageRect,
+                                                 const QSize &thumbnailSize,
+                                                 const QSize &tileSize,
+                                                 const KoColorSpace *colorSpace,
+                                                 QVector<Tile> *dirtyTiles)
+{
+    QMutexLocker l(&m_mutex);
+
+    if (!m_device ||
+        m_imageRect != imageRect ||
+        m_thumbnailSize != thumbnailSize ||
+        m_tileSize != tileSize ||
+        m_colorSpace != colorSpace) {
+
+        m_imageRect = imageRect;
+        m_thumbnailSize = thumbnailSize;
+        m_tileSize = tileSize;
+        m_colorSpace = colorSpace;
+        m_epoch++;
+
+        m_device = new KisPaintDevice(colorSpace);
+        m_numColumns = (thumbnailSize.width() + tileSize.width() - 1) / tileSize.width();
+        m_tileRects = KritaUtils::splitRectIntoPatchesTight(QRect(QPoint(), thumbnailSize), tileSize);
+        m_generations.fill(0, m_tileRects.size());
+        m_dirty.fill(true, m_tileRects.size());
+    }
+
+    for (int i = 0; i < m_tileRects.size(); i++) {
+        if (m_dirty[i]) {
+            dirtyTiles->append({m_tileRects[i], i, m_generations[i], m_epoch});
+        }
+    }
+
+    return m_device;
+}
+
+void KisImageThumbnailCache::markClean(const Tile &tile)
+{
+    QMutexLocker l(&m_mutex);
+
+    // the cache has been reset while the tile was being regenerated
+    if (tile.epoch != m_epoch) return;
+
+    if (m_generations[tile.index] == tile.generation) {
+        m_dirty[tile.index] = false;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISIMAGETHUMBNAILCACHE_H
+#define KISIMAGETHUMBNAILCACHE_H
+
+#include <QMutex>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+#include "kritaui_export.h"
+#include "kis_types.h"
+
+class KoColorSpace;
+
+/**
+ * Keeps the downsampled copy of the image generated by
+ * KisImageThumbnailStrokeStrategyBase between its runs, so that every
+ * run regenerates only the tiles of the thumbnail that correspond to
+ * the updated areas of the image.
+ *
+ * The dirty rects are usually reported directly from the threads
+ * emitting KisImage::sigImageUpdated(), the tiles are marked clean
+ * from the threads of the stroke, so all the methods are thread-safe.
+ */
+class KRITAUI_EXPORT KisImageThumbnailCache
+{
+public:
+    struct Tile {
+        QRect rect;
+        int index {-1};
+        int generation {0};
+        int epoch {0};
+    };
+
+public:
+    /**
+     * Marks the tiles of the thumbnail covering \p rc (in image
+     * coordinates) for regeneration
+     */
+    void addDirtyRect(const QRect &rc);
+
+    /**
+     * Drops the cached thumbnail, e.g. when the updates of the image
+     * could not be tracked
+     */
+    void invalidate();
+
+    /**
+     * Resets the cache if the source rect, the size of the thumbnail or
+     * the color space has changed since the last run.
+     *
+     * @param tileSize the size of the tiles the thumbnail is generated in
+     * @param dirtyTiles [out] the tiles that need to be regenerated
+     * @return the device holding the cached thumbnail
+     */
+    KisPaintDeviceSP prepare(const QRect &imageRect,
+                             const QSize &thumbnailSize,
+                             const QSize &tileSize,
+                             const KoColorSpace *colorSpace,
+                             QVector<Tile> *dirtyTiles);
+
+    /**
+     * Marks \p tile clean unless it has been marked dirty again while
+     * being regenerated.
+     */
+    void markClean(const Tile &tile);
+
+private:
+    QMutex m_mutex;
+
+    QRect m_imageRect;
+    QSize m_thumbnailSize;
+    QSize m_tileSize;
+    const KoColorSpace *m_colorSpace {0};
+    int m_numColumns {0};
+    int m_epoch {0};
+
+    KisPaintDeviceSP m_device;
+    QVector<QRect> m_tileRects;
+    QVector<int> m_generations;
+    QVector<bool> m_dirty;
+};
+
+#endif // KISIMAGETHUMBNAILCACHE_H
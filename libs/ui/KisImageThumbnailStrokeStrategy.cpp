@@ -16,6 +16,7 @@
 #include <KoUpdater.h>
 #include "KisRunnableStrokeJobUtils.h"
 #include "KisRunnableStrokeJobsInterface.h"
+#include "KisImageThumbnailCache.h"
 
 const qreal oversample = 2.;
 const int thumbnailTileDim = 128;
@@ -44,6 +45,11 @@ KisImageThumbnailStrokeStrategyBase::~KisImageThumbnailStrokeStrategyBase()
 {
 }
 
+void KisImageThumbnailStrokeStrategyBase::setThumbnailCache(QSharedPointer<KisImageThumbnailCache> cache)
+{
+    m_thumbnailCache = cache;
+}
+
 void KisImageThumbnailStrokeStrategyBase::initStrokeCallback()
 {
     using KritaUtils::addJobConcurrent;
@@ -58,18 +64,33 @@ void KisImageThumbnailStrokeStrategyBase::initStrokeCallback()
         m_thumbnailOversampledSize.scale(imageRect.size(), Qt::KeepAspectRatio);
     }
 
-    m_thumbnailDevice = new KisPaintDevice(m_device->colorSpace());
-
     QVector<KisRunnableStrokeJobData*> jobs;
 
-    QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(QRect(QPoint(0, 0), m_thumbnailOversampledSize), QSize(thumbnailTileDim, thumbnailTileDim));
-    Q_FOREACH (const QRect &rc, tileRects) {
-        addJobConcurrent(jobs, [this, tileRect = rc] () {
-            //we aren't going to use oversample capability of createThumbnailDevice because it recomputes exact bounds for each small patch, which is
-            //slow. We'll handle scaling separately.
-            KisPaintDeviceSP thumbnailTile = m_device->createThumbnailDeviceOversampled(m_thumbnailOversampledSize.width(), m_thumbnailOversampledSize.height(), 1, m_device->defaultBounds()->bounds(), tileRect);
-            KisPainter::copyAreaOptimized(tileRect.topLeft(), thumbnailTile, m_thumbnailDevice, tileRect);
-        });
+    if (m_thumbnailCache) {
+        QVector<KisImageThumbnailCache::Tile> dirtyTiles;
+        m_thumbnailDevice = m_thumbnailCache->prepare(imageRect, m_thumbnailOversampledSize,
+                                                      QSize(thumbnailTileDim, thumbnailTileDim),
+                                                      m_device->colorSpace(), &dirtyTiles);
+
+        Q_FOREACH (const KisImageThumbnailCache::Tile &tile, dirtyTiles) {
+            addJobConcurrent(jobs, [this, tile] () {
+                KisPaintDeviceSP thumbnailTile = m_device->createThumbnailDeviceOversampled(m_thumbnailOversampledSize.width(), m_thumbnailOversampledSize.height(), 1, m_device->defaultBounds()->bounds(), tile.rect);
+                KisPainter::copyAreaOptimized(tile.rect.topLeft(), thumbnailTile, m_thumbnailDevice, tile.rect);
+                m_thumbnailCache->markClean(tile);
+            });
+        }
+    } else {
+        m_thumbnailDevice = new KisPaintDevice(m_device->colorSpace());
+
+        QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(QRect(QPoint(0, 0), m_thumbnailOversampledSize), QSize(thumbnailTileDim, thumbnailTileDim));
+        Q_FOREACH (const QRect &rc, tileRects) {
+            addJobConcurrent(jobs, [this, tileRect = rc] () {
+                //we aren't going to use oversample capability of createThumbnailDevice because it recomputes exact bounds for each small patch, which is
+                //slow. We'll handle scaling separately.
+                KisPaintDeviceSP thumbnailTile = m_device->createThumbnailDeviceOversampled(m_thumbnailOversampledSize.width(), m_thumbnailOversampledSize.height(), 1, m_device->defaultBounds()->bounds(), tileRect);
+                KisPainter::copyAreaOptimized(tileRect.topLeft(), thumbnailTile, m_thumbnailDevice, tileRect);
+            });
+        }
     }
 
     addJobSequential(jobs, [this] () {
@@ -77,11 +98,16 @@ void KisImageThumbnailStrokeStrategyBase::initStrokeCallback()
         qreal xscale = m_thumbnailSize.width() / (qreal)m_thumbnailOversampledSize.width();
         qreal yscale = m_thumbnailSize.height() / (qreal)m_thumbnailOversampledSize.height();
         QString algorithm = m_isPixelArt ? "Box" : "Bilinear";
-        KisTransformWorker worker(m_thumbnailDevice, xscale, yscale, 0.0, 0.0, 0.0, 0.0, 0.0,
+
+        // the cached device should stay oversampled for the next run
+        KisPaintDeviceSP thumbnailDevice =
+            m_thumbnailCache ? new KisPaintDevice(*m_thumbnailDevice) : m_thumbnailDevice;
+
+        KisTransformWorker worker(thumbnailDevice, xscale, yscale, 0.0, 0.0, 0.0, 0.0, 0.0,
                                   updaterHolder.updater(), KisFilterStrategyRegistry::instance()->value(algorithm));
         worker.run();
 
-        reportThumbnailGenerationCompleted(m_thumbnailDevice, QRect(QPoint(0,0), m_thumbnailSize));
+        reportThumbnailGenerationCompleted(thumbnailDevice, QRect(QPoint(0,0), m_thumbnailSize));
     });
 
     runnableJobsInterface()->addRunnableJobs(jobs);
@@ -12,6 +12,7 @@
 #include <QRect>
 #include <QSize>
 #include <QImage>
+#include <QSharedPointer>
 
 #include "kritaui_export.h"
 #include "kis_types.h"
@@ -19,6 +20,7 @@
 #include "KisIdleTaskStrokeStrategy.h"
 
 class KoColorProfile;
+class KisImageThumbnailCache;
 
 
 class KRITAUI_EXPORT KisImageThumbnailStrokeStrategyBase : public KisIdleTaskStrokeStrategy
@@ -34,6 +36,13 @@ public:
                                         KoColorConversionTransformation::ConversionFlags conversionFlags);
     ~KisImageThumbnailStrokeStrategyBase() override;
 
+    /**
+     * Makes the strategy regenerate only the dirty tiles of the
+     * thumbnail stored in \p cache. The cache should be shared by all
+     * the strategies generating the thumbnail of the same device.
+     */
+    void setThumbnailCache(QSharedPointer<KisImageThumbnailCache> cache);
+
 private:
     void initStrokeCallback() override;
 
@@ -47,6 +56,7 @@ private:
     QSize m_thumbnailOversampledSize;
     bool m_isPixelArt {false};
     KisPaintDeviceSP m_thumbnailDevice;
+    QSharedPointer<KisImageThumbnailCache> m_thumbnailCache;
 
 protected:
     const KoColorProfile *m_profile;
@@ -209,6 +209,13 @@ void KisImportExportFilter::setProgress(int value)
     }
 }
 
+void KisImportExportFilter::publishPreview(const QImage &preview)
+{
+    if (d->batchmode || preview.isNull()) return;
+
+    Q_EMIT sigPreviewUpdated(preview);
+}
+
 void KisImportExportFilter::initializeCapabilities()
 {
     // XXX: Initialize everything to fully supported?
@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QIODevice>
 #include <QMap>
+#include <QImage>
 #include <QPointer>
 #include <QString>
 #include <QPair>
@@ -130,6 +131,14 @@ public:
     /// Verify whether the given file is correct and readable
     virtual QString verify(const QString &fileName) const;
 
+Q_SIGNALS:
+    /**
+     * Emitted by the importers that decode the image progressively
+     * (see publishPreview()). The preview is a low-resolution or a
+     * partially decoded version of the image being loaded.
+     */
+    void sigPreviewUpdated(const QImage &preview);
+
 protected:
     /**
      * This is the constructor your filter has to call, obviously.
@@ -143,6 +152,16 @@ protected:
     QByteArray mimeType() const;
 
     void setProgress(int value);
+
+    /**
+     * Importers that can decode a low-resolution pass of the image
+     * (progressive JPEG-XL) or fill it region by region should call
+     * this method whenever a better preview becomes available, so that
+     * the user could see the image before the loading is finished.
+     * Does nothing in batch mode.
+     */
+    void publishPreview(const QImage &preview);
+
     virtual void initializeCapabilities();
     void addCapability(KisExportCheckBase *capability);
     void addSupportedColorModels(QList<QPair<KoID, KoID> > supportedColorModels, const QString &name, KisExportCheckBase::Level level = KisExportCheckBase::PARTIALLY);
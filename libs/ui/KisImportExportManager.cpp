@@ -740,8 +740,14 @@ KisImportExportErrorCode KisImportExportManager::doImport(const QString &locatio
         return KisImportExportErrorCode(KisImportExportErrorCannotRead(file.error()));
     }
 
+    connect(filter.data(), &KisImportExportFilter::sigPreviewUpdated,
+            m_document, &KisDocument::sigImportPreviewUpdated);
+
     KisImportExportErrorCode status = filter->convert(m_document, &file, KisPropertiesConfigurationSP());
 
+    disconnect(filter.data(), &KisImportExportFilter::sigPreviewUpdated,
+               m_document, &KisDocument::sigImportPreviewUpdated);
+
     if (file.isOpen()) {
         file.close();
     }
@@ -22,6 +22,7 @@
 #include <QDockWidget>
 #include <QIcon>
 #include <QInputDialog>
+#include <QLabel>
 #include <QLayout>
 #include <QMdiArea>
 #include <QMdiSubWindow>
@@ -140,6 +141,7 @@
 #include "animation/KisDlgImportVideoAnimation.h"
 #include <KisImageConfigNotifier.h>
 #include "KisWindowLayoutManager.h"
+#include "KisDocumentMemoryBudgeter.h"
 #include <KisUndoActionsUpdateManager.h>
 #include "KisWelcomePageWidget.h"
 #include "KisRecentDocumentsModelWrapper.h"
@@ -304,6 +306,7 @@ public:
 
     QMdiArea *mdiArea {nullptr};
     QMdiSubWindow *activeSubWindow  {nullptr};
+    QPointer<QLabel> importPreview;
     KisSignalMapper *windowMapper {nullptr};
     KisSignalMapper *documentMapper {nullptr};
     KisCanvasWindow *canvasWindow {nullptr};
@@ -1091,6 +1094,7 @@ bool KisMainWindow::openDocumentInternal(const QString &path, OpenFlags flags)
     d->firstTime = true;
     connect(newdoc, SIGNAL(completed()), this, SLOT(slotLoadCompleted()));
     connect(newdoc, SIGNAL(canceled(QString)), this, SLOT(slotLoadCanceled(QString)));
+    connect(newdoc, SIGNAL(sigImportPreviewUpdated(QImage)), this, SLOT(slotImportPreviewUpdated(QImage)));
 
     KisDocument::OpenFlags openFlags = KisDocument::None;
     // XXX: Why this duplication of OpenFlags...
@@ -1100,6 +1104,9 @@ bool KisMainWindow::openDocumentInternal(const QString &path, OpenFlags flags)
 
     bool openRet = !(flags & Import) ? newdoc->openPath(path, openFlags) : newdoc->importDocument(path);
 
+    disconnect(newdoc, SIGNAL(sigImportPreviewUpdated(QImage)), this, SLOT(slotImportPreviewUpdated(QImage)));
+    delete d->importPreview;
+
     if (!openRet) {
         delete newdoc;
         return false;
@@ -1192,6 +1199,27 @@ void KisMainWindow::slotLoadCanceled(const QString &errMsg)
     disconnect(doc, SIGNAL(canceled(QString)), this, SLOT(slotLoadCanceled(QString)));
 }
 
+void KisMainWindow::slotImportPreviewUpdated(const QImage &preview)
+{
+    if (!d->importPreview) {
+        d->importPreview = new QLabel(d->widgetStack);
+        d->importPreview->setAlignment(Qt::AlignCenter);
+        d->importPreview->setAutoFillBackground(true);
+    }
+
+    d->importPreview->setGeometry(d->widgetStack->rect());
+    d->importPreview->setPixmap(
+        QPixmap::fromImage(preview).scaled(d->widgetStack->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    d->importPreview->show();
+    d->importPreview->raise();
+
+    /**
+     * The document is loaded synchronously in the GUI thread, so
+     * the preview should be painted without waiting for the event loop
+     */
+    d->importPreview->repaint();
+}
+
 void KisMainWindow::slotSaveCanceled(const QString &errMsg)
 {
     if (!errMsg.isEmpty()) {   // empty when cancelled by user
@@ -1691,6 +1719,7 @@ void KisMainWindow::setActiveView(KisView* view)
     slotUpdateReadWriteMode(view->document()->isReadWrite());
 
     KisWindowLayoutManager::instance()->activeDocumentChanged(view->document());
+    KisPart::instance()->memoryBudgeter()->activeDocumentChanged(view->document());
 
     Q_EMIT activeViewChanged();
 }
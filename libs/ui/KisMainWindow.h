@@ -325,6 +325,7 @@ public Q_SLOTS:
 private Q_SLOTS:
     void slotLoadCompleted();
     void slotLoadCanceled(const QString &);
+    void slotImportPreviewUpdated(const QImage &preview);
     void slotSaveCompleted();
     void slotSaveCanceled(const QString &);
     void forceDockTabFonts();
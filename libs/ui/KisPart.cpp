@@ -60,6 +60,7 @@
 #include "kis_shape_controller.h"
 #include "KisResourceServerProvider.h"
 #include "kis_animation_cache_populator.h"
+#include "KisDocumentMemoryBudgeter.h"
 #include "kis_image_animation_interface.h"
 #include "kis_time_span.h"
 #include "kis_idle_watcher.h"
@@ -108,6 +109,7 @@ public:
     QList<QPointer<KisDocument> > documents;
     KisIdleWatcher idleWatcher;
     KisAnimationCachePopulator animationCachePopulator;
+    KisDocumentMemoryBudgeter memoryBudgeter;
     QScopedPointer<KisPlaybackEngine> playbackEngine;
 
     KisSessionResourceSP currentSession;
@@ -164,6 +166,8 @@ KisPart::KisPart()
             &d->animationCachePopulator, SLOT(slotRequestRegeneration()));
     connect(&d->idleWatcher, SIGNAL(startedIdleMode()),
             KisMemoryStatisticsServer::instance(), SLOT(tryForceUpdateMemoryStatisticsWhileIdle()));
+    connect(&d->idleWatcher, SIGNAL(startedIdleMode()),
+            &d->memoryBudgeter, SLOT(slotDropInactiveCaches()));
 
     // We start by loading the simple QTimer-based anim playback engine first.
     // To save RAM, the MLT-based engine will be loaded later, once the KisImage in question becomes animated.
@@ -522,6 +526,11 @@ KisAnimationCachePopulator* KisPart::cachePopulator() const
     return &d->animationCachePopulator;
 }
 
+KisDocumentMemoryBudgeter* KisPart::memoryBudgeter() const
+{
+    return &d->memoryBudgeter;
+}
+
 KisPlaybackEngine *KisPart::playbackEngine() const
 {
     return d->playbackEngine.data();
@@ -32,6 +32,7 @@ class KisView;
 class KisDocument;
 class KisIdleWatcher;
 class KisAnimationCachePopulator;
+class KisDocumentMemoryBudgeter;
 class KisMainWindow;
 class KisInputManager;
 class KisViewManager;
@@ -166,6 +167,12 @@ public:
      */
     KisAnimationCachePopulator *cachePopulator() const;
 
+    /**
+     * @return the application-wide ranking of the documents used
+     * for dropping the caches of the inactive ones
+     */
+    KisDocumentMemoryBudgeter *memoryBudgeter() const;
+
     class KisPlaybackEngine* playbackEngine() const;
 
     /**
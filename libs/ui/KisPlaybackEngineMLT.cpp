@@ -22,6 +22,9 @@
 #include "animation/KisFrameDisplayProxy.h"
 #include "KisViewManager.h"
 #include "kis_onion_skin_compositor.h"
+#include "kis_animation_frame_cache.h"
+#include "kis_config.h"
+#include "KisPart.h"
 
 #include <mlt++/Mlt.h>
 #include <mlt++/MltConsumer.h>
@@ -252,6 +255,52 @@ struct KisPlaybackEngineMLT::Private {
         return m_self->dropFrames();
     }
 
+    /**
+     * Asks the background cache populator to render the uncached frames
+     * the playback is going to reach soon. The frames are requested from
+     * the farthest to the nearest one, so the nearest frame ends up on
+     * the top of the populator's priority stack.
+     */
+    void requestLookAheadFrames(int frame) {
+        KisAnimationFrameCacheSP cache = activeCanvas()->frameCache();
+        if (!cache || !lookAheadFrames) return;
+
+        KisImageSP image = activeCanvas()->image();
+        const KisTimeSpan range = image->animationInterface()->activePlaybackRange();
+        if (!range.isValid() || range.isInfinite()) return;
+
+        for (int distance = qMin(lookAheadFrames, range.duration() - 1); distance > 0; distance--) {
+            int aheadFrame = frame + distance;
+
+            // the playback loops over the range
+            if (aheadFrame > range.end()) {
+                aheadFrame = range.start() + (aheadFrame - range.end() - 1) % range.duration();
+            }
+
+            if (cache->frameStatus(aheadFrame) != KisAnimationFrameCache::Cached) {
+                KisPart::instance()->prioritizeFrameForCache(image, aheadFrame);
+            }
+        }
+    }
+
+    /**
+     * In the frame dropping mode an uncached frame is not regenerated
+     * on the image (which would stall the playback and make it go out
+     * of sync with the audio). The last cached frame stays on the canvas
+     * instead, while the populator is rendering the frames ahead. The
+     * frame is held for the look-ahead distance at most, so the playback
+     * doesn't freeze when the populator cannot keep up.
+     */
+    bool shouldHoldFrame(int frame) {
+        if (!dropFrames() || !backgroundCaching || heldFrames >= lookAheadFrames) return false;
+
+        KisAnimationFrameCacheSP cache = activeCanvas()->frameCache();
+        if (!cache || cache->frameStatus(frame) == KisAnimationFrameCache::Cached) return false;
+
+        const int displayedFrame = activeCanvas()->animationState()->displayProxy()->activeFrame();
+        return cache->frameStatus(displayedFrame) == KisAnimationFrameCache::Cached;
+    }
+
 private:
     KisPlaybackEngineMLT* m_self;
 
@@ -277,6 +326,10 @@ public:
 
     FrameWaitingInterface frameWaitingInterface;
     FrameRenderingStats frameStats;
+
+    int lookAheadFrames {8};
+    bool backgroundCaching {true};
+    int heldFrames {0};
 };
 
 //=====
@@ -331,6 +384,13 @@ public:
 
             m_d->frameStats.reset();
 
+            {
+                KisConfig cfg(true);
+                m_d->lookAheadFrames = cfg.playbackLookAheadFrames();
+                m_d->backgroundCaching = cfg.calculateAnimationCacheInBackground();
+                m_d->heldFrames = 0;
+            }
+
             {
                 /**
                  * Make sure that **all** producer properties are initialized **before**
@@ -551,6 +611,22 @@ void KisPlaybackEngineMLT::throttledShowFrame(const int frame)
     if (activeCanvas() && activeCanvas()->animationState() &&
             m_d->activePlaybackMode() == PLAYBACK_PULL ) {
 
+        m_d->requestLookAheadFrames(frame);
+
+        if (m_d->shouldHoldFrame(frame)) {
+            /**
+             * The held frame is counted as dropped when the next
+             * frame is shown.
+             */
+            m_d->heldFrames++;
+
+            QMutexLocker l(&m_d->frameWaitingInterface.renderingControlMutex);
+            m_d->frameWaitingInterface.waitingForFrame = false;
+            m_d->frameWaitingInterface.renderingWaitCondition.wakeAll();
+            return;
+        }
+        m_d->heldFrames = 0;
+
         if (m_d->frameStats.lastRenderedFrame < 0) {
             m_d->frameStats.timeSinceLastFrame.start();
         } else {
@@ -16,6 +16,11 @@
 #include <QFileInfo>
 #include <QImageReader>
 #include <QUrl>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QGlobalStatic>
 
 #include <QColorSpace>
 
@@ -35,6 +40,75 @@
 
 #include "kis_clipboard.h"
 
+namespace {
+
+/**
+ * Decoded reference images and their mipmaps are shared between all the
+ * references showing the same file, even in different documents, so that
+ * every file is decoded and downsampled only once.
+ */
+class SharedReferenceImageCache
+{
+public:
+    static QString fileKey(const QString &filename) {
+        const QFileInfo info(filename);
+        return QString("%1:%2:%3")
+            .arg(info.canonicalFilePath())
+            .arg(info.lastModified().toMSecsSinceEpoch())
+            .arg(info.size());
+    }
+
+    QImage image(const QString &key) {
+        QMutexLocker l(&m_mutex);
+        return m_images.value(key);
+    }
+
+    void addImage(const QString &key, const QImage &image) {
+        QMutexLocker l(&m_mutex);
+
+        // drop the images not used by any reference anymore
+        for (auto it = m_images.begin(); it != m_images.end();) {
+            if (it.value().isDetached()) {
+                it = m_images.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        m_images.insert(key, image);
+    }
+
+    QSharedPointer<KisQImagePyramid> mipmap(const QImage &image) {
+        QMutexLocker l(&m_mutex);
+
+        QSharedPointer<KisQImagePyramid> result = m_mipmaps.value(image.cacheKey()).toStrongRef();
+
+        if (!result) {
+            for (auto it = m_mipmaps.begin(); it != m_mipmaps.end();) {
+                if (it.value().isNull()) {
+                    it = m_mipmaps.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            result.reset(new KisQImagePyramid(image, false));
+            m_mipmaps.insert(image.cacheKey(), result);
+        }
+
+        return result;
+    }
+
+private:
+    QMutex m_mutex;
+    QHash<QString, QImage> m_images;
+    QHash<qint64, QWeakPointer<KisQImagePyramid>> m_mipmaps;
+};
+
+Q_GLOBAL_STATIC(SharedReferenceImageCache, s_sharedCache)
+
+}
+
 struct KisReferenceImage::Private : public QSharedData
 {
     // Filename within .kra (for embedding)
@@ -45,7 +119,7 @@ struct KisReferenceImage::Private : public QSharedData
 
     QImage image;
     QImage cachedImage;
-    KisQImagePyramid mipmap;
+    QSharedPointer<KisQImagePyramid> mipmap;
 
     qreal saturation{1.0};
     int id{-1};
@@ -55,6 +129,13 @@ struct KisReferenceImage::Private : public QSharedData
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!externalFilename.isEmpty(), false);
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(QFileInfo(externalFilename).exists(), false);
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(QFileInfo(externalFilename).isReadable(), false);
+
+        const QString cacheKey = SharedReferenceImageCache::fileKey(externalFilename);
+        image = s_sharedCache->image(cacheKey);
+        if (!image.isNull()) {
+            return true;
+        }
+
         {
             QImageReader reader(externalFilename);
             reader.setDecideFormatFromContent(true);
@@ -84,6 +165,10 @@ struct KisReferenceImage::Private : public QSharedData
         // convert the colorspace of the QImage
         image.convertToColorSpace(QColorSpace(QColorSpace::SRgb));
 
+        if (!image.isNull()) {
+            s_sharedCache->addImage(cacheKey, image);
+        }
+
         return (!image.isNull());
     }
 
@@ -105,7 +190,7 @@ struct KisReferenceImage::Private : public QSharedData
             cachedImage = image;
         }
 
-        mipmap = KisQImagePyramid(cachedImage, false);
+        mipmap = s_sharedCache->mipmap(cachedImage);
     }
 };
 
@@ -243,7 +328,7 @@ void KisReferenceImage::paint(QPainter &gc) const
     QTransform devicePixelRatioFTransform = QTransform::fromScale(gc.device()->devicePixelRatioF(), gc.device()->devicePixelRatioF());
     // all three transformations: scale and rotation done by the user, scale from highDPI display, and zoom + rotation of the view
     // order: zoom/rotation of the view; scale to high res; scale and rotation done by the user
-    QImage prescaled = d->mipmap.getClosestWithoutWorkaroundBorder(transform * devicePixelRatioFTransform * gc.transform(), &scale);
+    QImage prescaled = d->mipmap->getClosestWithoutWorkaroundBorder(transform * devicePixelRatioFTransform * gc.transform(), &scale);
     transform.scale(1.0 / scale, 1.0 / scale);
 
     if (scale > 1.0) {
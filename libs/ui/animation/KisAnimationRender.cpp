@@ -19,6 +19,7 @@
 #include "dialogs/KisAsyncAnimationFramesSaveDialog.h"
 #include "kis_time_span.h"
 #include "KisMainWindow.h"
+#include "kis_config.h"
 
 #include "krita_container_utils.h"
 
@@ -61,6 +62,50 @@ bool KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
                                                encoderOptions.frameExportConfig);
     exporter.setBatchMode(batchMode);
 
+    if (shouldPipeFrames(encoderOptions)) {
+        /**
+         * The image sequence is going to be deleted anyway, so we can
+         * pipe the frames directly into ffmpeg and avoid encoding and
+         * decoding of the intermediate files
+         */
+        const QString videoOutputFilePath = encoderOptions.resolveAbsoluteVideoFilePath();
+        QDir().mkpath(QFileInfo(videoOutputFilePath).absolutePath());
+
+        if (!confirmVideoOverwrite(videoOutputFilePath)) {
+            return false;
+        }
+
+        KisAnimationVideoSaver encoder(doc, batchMode);
+        KisImportExportErrorCode encoderResult =
+            encoder.startPipedEncoding(encoderOptions, doc->image()->bounds().size());
+
+        if (encoderResult.isOk()) {
+            exporter.setFramesEncoder(&encoder);
+
+            KisAsyncAnimationFramesSaveDialog::Result result =
+                exporter.regenerateRange(viewManager->mainWindow()->viewManager());
+
+            encoderResult = encoder.finishPipedEncoding(result == KisAsyncAnimationFramesSaveDialog::RenderComplete);
+
+            if (result == KisAsyncAnimationFramesSaveDialog::RenderTimedOut) {
+                QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Rendering error"), "Animation frame rendering has timed out. Output files are incomplete.\nTry to increase \"Frame Rendering Timeout\" or reduce \"Frame Rendering Clones Limit\" in Krita settings");
+                return false;
+            } else if (result == KisAsyncAnimationFramesSaveDialog::RenderFailed) {
+                QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Rendering error"), i18n("Failed to render animation frames! Output files are incomplete."));
+                return false;
+            } else if (result != KisAsyncAnimationFramesSaveDialog::RenderComplete) {
+                return false;
+            }
+        }
+
+        if (!encoderResult.isOk()) {
+            QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita"), i18n("Could not render animation:\n%1", encoderResult.errorMessage()));
+            return false;
+        }
+
+        return true;
+    }
+
     KisAsyncAnimationFramesSaveDialog::Result result =
         exporter.regenerateRange(viewManager->mainWindow()->viewManager());
 
@@ -84,21 +129,8 @@ bool KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
             }
             KIS_SAFE_ASSERT_RECOVER_NOOP(outputDir.exists());
 
-            // If file exists at output path, prompt user for overwrite..
-            bool videoFileWriteAllowed = true;
-            if (videoOutputFile.exists()) {
-                QMessageBox videoOverwritePrompt;
-
-                videoOverwritePrompt.setText(i18n("Overwrite existing video?"));
-                videoOverwritePrompt.setInformativeText(i18n("A file already exists at the path where you want to render your video [%1]... \n\
-                                                              Are you sure you want to overwrite the existing file?", videoOutputFilePath));
-                videoOverwritePrompt.setStandardButtons(QMessageBox::Ok | QMessageBox::Abort);
-
-                videoFileWriteAllowed = videoOverwritePrompt.exec() == QMessageBox::Ok ? true : false;
-            }
-
             // Write the video..
-            if (videoFileWriteAllowed) {
+            if (confirmVideoOverwrite(videoOutputFilePath)) {
                 KisImportExportErrorCode result;
 
                 QFile videoOutputFile(videoOutputFilePath);
@@ -156,6 +188,35 @@ bool KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
     return delayReturnSuccess;
 }
 
+bool KisAnimationRender::confirmVideoOverwrite(const QString &videoOutputFilePath)
+{
+    // If file exists at output path, prompt user for overwrite..
+    if (!QFileInfo(videoOutputFilePath).exists()) {
+        return true;
+    }
+
+    QMessageBox videoOverwritePrompt;
+
+    videoOverwritePrompt.setText(i18n("Overwrite existing video?"));
+    videoOverwritePrompt.setInformativeText(i18n("A file already exists at the path where you want to render your video [%1]... \n\
+                                                  Are you sure you want to overwrite the existing file?", videoOutputFilePath));
+    videoOverwritePrompt.setStandardButtons(QMessageBox::Ok | QMessageBox::Abort);
+
+    return videoOverwritePrompt.exec() == QMessageBox::Ok;
+}
+
+bool KisAnimationRender::shouldPipeFrames(const KisAnimationRenderingOptions &options)
+{
+    const bool wantsHDR =
+        options.frameExportConfig &&
+        options.frameExportConfig->getBool("saveAsHDR", false);
+
+    return KisConfig(true).pipeAnimationFramesToFFmpeg() &&
+        options.renderMode() == KisAnimationRenderingOptions::RENDER_VIDEO_ONLY &&
+        KisAnimationVideoSaver::supportsPipedEncoding(options) &&
+        !wantsHDR;
+}
+
 bool KisAnimationRender::mustHaveEvenDimensions(const QString &mimeType, KisAnimationRenderingOptions::RenderMode renderMode)
 {
     return (mimeType == "video/mp4" || mimeType == "video/x-matroska") && renderMode != KisAnimationRenderingOptions::RENDER_FRAMES_ONLY;
@@ -20,6 +20,16 @@ namespace KisAnimationRender {
     **/
     KRITAUI_EXPORT bool render(KisDocument *doc, KisViewManager* viewManager, KisAnimationRenderingOptions encoderOptions);
 
+    /** Ask the user whether an existing video file can be overwritten.
+     *  returns TRUE if there is no such file or the user agreed.
+    **/
+    bool confirmVideoOverwrite(const QString &videoOutputFilePath);
+
+    /** Whether the frames can be piped into ffmpeg directly instead of
+     *  being saved into an intermediate image sequence.
+    **/
+    bool shouldPipeFrames(const KisAnimationRenderingOptions &options);
+
     bool mustHaveEvenDimensions(const QString &mimeType, KisAnimationRenderingOptions::RenderMode renderMode);
     bool hasEvenDimensions(int width, int height);
 
@@ -203,6 +203,28 @@ bool KisFFMpegWrapper::waitForFinished(int msecs)
     return false;
 }
 
+bool KisFFMpegWrapper::writeProcessInput(const QByteArray &data, int msecs)
+{
+    if (!m_process || m_process->state() != QProcess::Running) return false;
+
+    if (m_process->write(data) != data.size()) return false;
+
+    while (m_process->bytesToWrite() > 0) {
+        if (!m_process->waitForBytesWritten(msecs)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void KisFFMpegWrapper::closeProcessInput()
+{
+    if (!m_process) return;
+
+    m_process->closeWriteChannel();
+}
+
 void KisFFMpegWrapper::updateProgressDialog(int progressValue) {
     
     dbgFile << "Update Progress" << progressValue << "/" << m_processSettings.totalFrames;
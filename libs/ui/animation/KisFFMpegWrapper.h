@@ -55,6 +55,20 @@ public:
     bool waitForFinished(int msecs = FFMPEG_TIMEOUT);
     void reset();
 
+    /**
+     * Writes \p data into the stdin of the running process. The call
+     * blocks until the data is passed to the pipe, so the amount of
+     * data buffered on Krita's side stays limited.
+     * @return false if the process is not running or the write failed
+     */
+    bool writeProcessInput(const QByteArray &data, int msecs = FFMPEG_TIMEOUT);
+
+    /**
+     * Closes the stdin of the running process, which tells ffmpeg
+     * that the piped input is complete.
+     */
+    void closeProcessInput();
+
     static QJsonObject findProcessPath(const QString &processName, const QString &customLocation, bool processInfo);
     static QJsonObject findProcessInfo(const QString &processName, const QString &processPath, bool includeProcessInfo);
     static QStringList getSupportedCodecs(const QJsonObject& ffmpegJsonProcessInput);
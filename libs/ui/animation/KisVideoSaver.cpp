@@ -15,6 +15,7 @@
 #include <QTemporaryFile>
 #include <QTemporaryDir>
 #include <QTime>
+#include <QMap>
 
 #include <KisDocument.h>
 #include <kis_image.h>
@@ -30,6 +31,16 @@
 
 #include "KisPart.h"
 
+struct KisAnimationVideoSaver::PipedEncoding
+{
+    QScopedPointer<KisFFMpegWrapper> ffmpeg;
+    QMap<int, QPair<int, QByteArray>> pendingFrames;
+    int nextFrame = 0;
+    bool writeFailed = false;
+    bool finished = false;
+    QString error;
+};
+
 KisAnimationVideoSaver::KisAnimationVideoSaver(KisDocument *doc, bool batchMode)
     : m_image(doc->image())
     , m_doc(doc)
@@ -53,11 +64,144 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
         return ImportExportCodes::Failure;
     }
 
-    KisImportExportErrorCode resultOuter = ImportExportCodes::OK;
+    QStringList inputArgs;
+    inputArgs << "-r" << QString::number(options.frameRate) // Frame rate for video...
+              << "-start_number" << QString::number(options.sequenceStart) << "-start_number_range" << "1"
+              << "-i" << savedFilesMask; // Input frame(s) file mask..
+
+    dbgFile << "savedFilesMask" << savedFilesMask
+            << "save files offset" << options.sequenceStart;
+
+    QScopedPointer<KisFFMpegWrapper> ffmpegWrapper(new KisFFMpegWrapper(this));
+
+    KisFFMpegWrapperSettings ffmpegSettings;
+    KisImportExportErrorCode result = prepareEncoding(inputArgs, options, ffmpegWrapper.data(), &ffmpegSettings);
+
+    if (!result.isOk()) {
+        return result;
+    }
+
+    return ffmpegWrapper->start(ffmpegSettings);
+}
+
+KisImportExportErrorCode KisAnimationVideoSaver::startPipedEncoding(const KisAnimationRenderingOptions &options, const QSize &frameSize)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_piped, ImportExportCodes::InternalError);
+
+    if (!QFileInfo(options.ffmpegPath).exists()) {
+        m_doc->setErrorMessage(i18n("ffmpeg could not be found at %1", options.ffmpegPath));
+        return ImportExportCodes::Failure;
+    }
+
+    if (!supportsPipedEncoding(options)) {
+        return ImportExportCodes::FormatFeaturesUnsupported;
+    }
+
+    QStringList inputArgs;
+    inputArgs << "-f" << "rawvideo"
+              << "-pix_fmt" << "rgba"
+              << "-s" << QString("%1x%2").arg(frameSize.width()).arg(frameSize.height())
+              << "-r" << QString::number(options.frameRate)
+              << "-i" << "-";
+
+    m_piped.reset(new PipedEncoding());
+    m_piped->ffmpeg.reset(new KisFFMpegWrapper(this));
+    m_piped->nextFrame = options.firstFrame;
+
+    KisFFMpegWrapperSettings ffmpegSettings;
+    KisImportExportErrorCode result = prepareEncoding(inputArgs, options, m_piped->ffmpeg.data(), &ffmpegSettings);
+
+    if (!result.isOk()) {
+        m_piped.reset();
+        return result;
+    }
+
+    /**
+     * The frames are being rendered in the save dialog at the same time,
+     * so we cannot show the modal progress dialog of ffmpeg on top of it
+     */
+    ffmpegSettings.batchMode = true;
+
+    PipedEncoding *piped = m_piped.data();
+
+    connect(piped->ffmpeg.data(), &KisFFMpegWrapper::sigFinishedWithError, [piped](const QString &errMsg) {
+        piped->finished = true;
+        piped->error = errMsg;
+    });
+
+    connect(piped->ffmpeg.data(), &KisFFMpegWrapper::sigFinished, [piped]() {
+        piped->finished = true;
+    });
+
+    piped->ffmpeg->startNonBlocking(ffmpegSettings);
+
+    return ImportExportCodes::OK;
+}
+
+void KisAnimationVideoSaver::slotFrameDataReady(int frame, int numRepeats, const QByteArray &data)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_piped);
+
+    /**
+     * The frames are rendered on several image clones, so they come in
+     * an arbitrary order. Keep the early ones until the gap is filled.
+     */
+    m_piped->pendingFrames.insert(frame, qMakePair(numRepeats, data));
+
+    while (!m_piped->pendingFrames.isEmpty() &&
+           m_piped->pendingFrames.firstKey() == m_piped->nextFrame) {
+
+        const QPair<int, QByteArray> frameData = m_piped->pendingFrames.take(m_piped->nextFrame);
+
+        for (int i = 0; i < frameData.first && !m_piped->writeFailed; i++) {
+            m_piped->writeFailed = !m_piped->ffmpeg->writeProcessInput(frameData.second);
+        }
+
+        m_piped->nextFrame += frameData.first;
+    }
+}
+
+KisImportExportErrorCode KisAnimationVideoSaver::finishPipedEncoding(bool renderingComplete)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_piped, ImportExportCodes::InternalError);
+
+    QScopedPointer<PipedEncoding> piped(m_piped.take());
+
+    if (!renderingComplete) {
+        piped->ffmpeg->reset();
+        return ImportExportCodes::Cancelled;
+    }
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(piped->pendingFrames.isEmpty());
+
+    piped->ffmpeg->closeProcessInput();
+    piped->ffmpeg->waitForFinished(FFMPEG_TIMEOUT);
+
+    if (!piped->finished) {
+        piped->ffmpeg->reset(); // Ensure process isn't running before returning failure here.
+        return ImportExportCodes::Failure;
+    }
+
+    if (!piped->error.isEmpty() || piped->writeFailed) {
+        m_doc->setErrorMessage(piped->error);
+        return ImportExportCodes::Failure;
+    }
 
+    return ImportExportCodes::OK;
+}
+
+bool KisAnimationVideoSaver::supportsPipedEncoding(const KisAnimationRenderingOptions &options)
+{
+    return options.videoMimeType != "image/gif";
+}
+
+KisImportExportErrorCode KisAnimationVideoSaver::prepareEncoding(const QStringList &inputArgs,
+                                                                 const KisAnimationRenderingOptions &options,
+                                                                 KisFFMpegWrapper *ffmpegWrapper,
+                                                                 KisFFMpegWrapperSettings *settings)
+{
     KisImageAnimationInterface *animation = m_image->animationInterface();
 
-    const int sequenceStart = options.sequenceStart;
     const KisTimeSpan clipRange = KisTimeSpan::fromTimeToTime(options.firstFrame,
                                                               options.lastFrame);
 
@@ -80,8 +224,6 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
 
     QStringList additionalOptionsList = options.customFFMpegOptions.split(' ', Qt::SkipEmptyParts);
 
-    QScopedPointer<KisFFMpegWrapper> ffmpegWrapper(new KisFFMpegWrapper(this));
-    
     {
         QStringList paletteArgs;
         QStringList simpleFilterArgs;
@@ -89,9 +231,7 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
         QStringList args;
         
         args << "-y" // Auto Confirm...
-             << "-r" << QString::number(options.frameRate) // Frame rate for video...
-             << "-start_number" << QString::number(sequenceStart) << "-start_number_range" << "1"
-             << "-i" << savedFilesMask; // Input frame(s) file mask..
+             << inputArgs;
 
         const int lavfiOptionsIndex = additionalOptionsList.indexOf("-lavfi");
 
@@ -102,9 +242,7 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
         }                  
       
         if ( options.videoMimeType == "image/gif" ) {
-            paletteArgs << "-r" << QString::number(options.frameRate)
-                        << "-start_number" << QString::number(sequenceStart) << "-start_number_range" << "1"
-                        << "-i" << savedFilesMask;
+            paletteArgs << inputArgs;
             
             const int paletteOptionsIndex = additionalOptionsList.indexOf("-palettegen");
             QString palettegenString = "palettegen";
@@ -182,26 +320,20 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
         
         args << additionalOptionsList;
 
-        dbgFile << "savedFilesMask" << savedFilesMask
-                << "save files offset" << sequenceStart
-                << "start" << QString::number(clipRange.start()) 
+        dbgFile << "start" << QString::number(clipRange.start())
                 << "duration" << clipRange.duration();
 
 
-        KisFFMpegWrapperSettings ffmpegSettings;
-        ffmpegSettings.processPath = options.ffmpegPath;
-        ffmpegSettings.args = args;
-        ffmpegSettings.outputFile = resultFile;
-        ffmpegSettings.totalFrames = clipRange.duration();
-        ffmpegSettings.logPath = QDir::tempPath() + QDir::separator() + "krita" + QDir::separator() + "ffmpeg.log";
-        ffmpegSettings.progressMessage = i18nc("Animation export dialog for tracking ffmpeg progress. arg1: file-suffix, arg2: progress frame number, arg3: totalFrameCount.",
-                                               "Creating desired %1 file: %2/%3 frames.", "[suffix]", "[progress]", "[framecount]");
-
-        resultOuter = ffmpegWrapper->start(ffmpegSettings);
+        settings->processPath = options.ffmpegPath;
+        settings->args = args;
+        settings->outputFile = resultFile;
+        settings->totalFrames = clipRange.duration();
+        settings->logPath = QDir::tempPath() + QDir::separator() + "krita" + QDir::separator() + "ffmpeg.log";
+        settings->progressMessage = i18nc("Animation export dialog for tracking ffmpeg progress. arg1: file-suffix, arg2: progress frame number, arg3: totalFrameCount.",
+                                          "Creating desired %1 file: %2/%3 frames.", "[suffix]", "[progress]", "[framecount]");
     }
-     
 
-    return resultOuter;
+    return ImportExportCodes::OK;
 }
 
 KisImportExportErrorCode KisAnimationVideoSaver::convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode)
@@ -8,6 +8,7 @@
 #define VIDEO_SAVER_H_
 
 #include <QObject>
+#include <QScopedPointer>
 
 #include "kis_types.h"
 
@@ -15,6 +16,8 @@
 
 class KisDocument;
 class KisAnimationRenderingOptions;
+class KisFFMpegWrapper;
+struct KisFFMpegWrapperSettings;
 
 #include "kritaui_export.h"
 
@@ -49,10 +52,49 @@ public:
 
     static KisImportExportErrorCode convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode);
 
+    /**
+     * @brief startPipedEncoding starts ffmpeg reading raw RGBA frames from its stdin.
+     * The frames are passed to slotFrameDataReady() while they are being rendered,
+     * so no intermediate image sequence is written to disk.
+     * @param options the configuration
+     * @param frameSize the size of the frames that are going to be piped
+     * @return whether ffmpeg has been started
+     */
+    KisImportExportErrorCode startPipedEncoding(const KisAnimationRenderingOptions &options, const QSize &frameSize);
+
+    /**
+     * @brief finishPipedEncoding closes the input of ffmpeg and waits until the video is written.
+     * @param renderingComplete whether all the frames have been passed, if not, the encoding is aborted.
+     * @return whether the video has been written successfully.
+     */
+    KisImportExportErrorCode finishPipedEncoding(bool renderingComplete);
+
+    /**
+     * @return whether the format can be encoded from the piped frames. GIF
+     * cannot, because its palette pass needs to read the frames twice.
+     */
+    static bool supportsPipedEncoding(const KisAnimationRenderingOptions &options);
+
+public Q_SLOTS:
+    /**
+     * Pipes the rendered \p frame to ffmpeg \p numRepeats times. The frames
+     * may come in any order, they are reordered before being written.
+     */
+    void slotFrameDataReady(int frame, int numRepeats, const QByteArray &data);
+
+private:
+    KisImportExportErrorCode prepareEncoding(const QStringList &inputArgs,
+                                             const KisAnimationRenderingOptions &options,
+                                             KisFFMpegWrapper *ffmpegWrapper,
+                                             KisFFMpegWrapperSettings *settings);
+
 private:
     KisImageSP m_image;
     KisDocument* m_doc;
     bool m_batchMode;
+
+    struct PipedEncoding;
+    QScopedPointer<PipedEncoding> m_piped;
 };
 
 #endif
@@ -137,6 +137,11 @@ void populateComboWithKoIds(QComboBox *combo, const QVector<KoID> &ids, int defa
     combo->setEnabled(combo->count() > 1);
 }
 
+bool isHardwareEncoder(const QString &codec)
+{
+    return codec.endsWith("_nvenc") || codec.endsWith("_qsv") || codec.endsWith("_videotoolbox");
+}
+
 KisVideoExportOptionsDialog::KisVideoExportOptionsDialog(ContainerType containerType, const QStringList& validEncoders, QWidget *parent)
     : KisConfigWidget(parent),
       ui(new Ui::VideoExportOptionsDialog),
@@ -294,6 +299,16 @@ QVector<KoID> KisVideoExportOptionsDialog::encoderIdentifiers(ContainerType type
                                 KoID("libx265", i18nc("h265 codec name, check simplescreenrecorder for standard translations", "H.265, MPEG-H Part 2 (HEVC)"))
                                 };
     
+    // The hardware encoders are listed only if the ffmpeg build has them
+    QVector<KoID> hardwareEncoders = {
+                                KoID("h264_nvenc", i18nc("hardware codec name", "H.264 (NVIDIA NVENC)")),
+                                KoID("hevc_nvenc", i18nc("hardware codec name", "H.265 (NVIDIA NVENC)")),
+                                KoID("h264_qsv", i18nc("hardware codec name", "H.264 (Intel Quick Sync Video)")),
+                                KoID("hevc_qsv", i18nc("hardware codec name", "H.265 (Intel Quick Sync Video)")),
+                                KoID("h264_videotoolbox", i18nc("hardware codec name", "H.264 (Apple VideoToolbox)")),
+                                KoID("hevc_videotoolbox", i18nc("hardware codec name", "H.265 (Apple VideoToolbox)"))
+                                };
+
     KoID vp9Encoder =  KoID("libvpx-vp9", i18nc("VP9 codec name", "VP9"));
     
 
@@ -318,6 +333,7 @@ QVector<KoID> KisVideoExportOptionsDialog::encoderIdentifiers(ContainerType type
         default:
             encoders << h264Encoders;
             encoders << vp9Encoder;
+            encoders << hardwareEncoders;
             break;
     }
     
@@ -351,7 +367,8 @@ void KisVideoExportOptionsDialog::slotResetCustomLine()
 void KisVideoExportOptionsDialog::slotCodecSelected(int index)
 {
     const QString codec = m_d->encoders[index].id();
-    if (codec == "libopenh264") {
+    if (codec == "libopenh264" || isHardwareEncoder(codec)) {
+        // the hardware encoders are configured with the bitrate only
         ui->stackedWidget->setCurrentIndex(CODEC_OPENH264);
     } else if (codec == "libx264") {
         ui->stackedWidget->setCurrentIndex(CODEC_H264);
@@ -460,6 +477,12 @@ QStringList KisVideoExportOptionsDialog::generateCustomLine() const
     if (currentCodecId() == "libopenh264") {
         options << "-c:v" << "libopenh264";
         options << "-b:v" << QString::number(ui->intOpenH264bitrate->value()) + "k";
+    } else if (isHardwareEncoder(currentCodecId())) {
+        options << "-c:v" << currentCodecId();
+        options << "-b:v" << QString::number(ui->intOpenH264bitrate->value()) + "k";
+
+        // nv12 is the input format supported by all of them
+        options << "-pix_fmt" << "nv12";
     } else if (currentCodecId() == "libx264") {
         options << "-crf" << QString::number(ui->intCRFH264->value());
 
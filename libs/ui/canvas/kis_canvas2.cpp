@@ -84,6 +84,7 @@
 #include "kis_canvas_updates_compressor.h"
 
 #include <KisStrokeSpeedMonitor.h>
+#include <KisSchedulerTracer.h>
 #include "opengl/kis_opengl_canvas_debugger.h"
 
 #include "kis_wrapped_rect.h"
@@ -143,6 +144,7 @@ public:
         , inputActionGroupsMaskInterface(new CanvasInputActionGroupsMaskInterface(this))
         , regionOfInterestUpdateCompressor(100, KisSignalCompressor::FIRST_INACTIVE)
         , referencesBoundsUpdateCompressor(100, KisSignalCompressor::FIRST_INACTIVE)
+        , levelOfDetailChangeCompressor(250, KisSignalCompressor::POSTPONE)
     {
     }
 
@@ -196,6 +198,7 @@ public:
 
     KisSignalCompressor regionOfInterestUpdateCompressor;
     KisSignalCompressor referencesBoundsUpdateCompressor;
+    KisSignalCompressor levelOfDetailChangeCompressor;
     QRect regionOfInterest;
     qreal regionOfInterestMargin = 0.25;
 
@@ -324,6 +327,7 @@ void KisCanvas2::setup()
 
     connect(&m_d->regionOfInterestUpdateCompressor, SIGNAL(timeout()), SLOT(slotUpdateRegionOfInterest()));
     connect(&m_d->referencesBoundsUpdateCompressor, SIGNAL(timeout()), SLOT(slotUpdateReferencesBounds()));
+    connect(&m_d->levelOfDetailChangeCompressor, SIGNAL(timeout()), SLOT(slotUpdateLevelOfDetail()));
 
     connect(m_d->view->document(), SIGNAL(sigReferenceImagesChanged()), &m_d->referencesBoundsUpdateCompressor, SLOT(start()));
 
@@ -910,7 +914,18 @@ void KisCanvas2::finishResizingImage(qint32 w, qint32 h)
 
 void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 {
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    const qint64 traceStartTime = tracer->isEnabled() ? tracer->timestamp() : -1;
+
     KisUpdateInfoSP info = m_d->canvasWidget->startUpdateCanvasProjection(rc);
+    KisOpenglCanvasDebugger::instance()->notifyCanvasUpdateBuilt();
+
+    if (traceStartTime >= 0) {
+        tracer->addSpan("canvas", QStringLiteral("convert projection"), traceStartTime,
+                        {{"width", rc.width()}, {"height", rc.height()},
+                         {"lod", info ? info->levelOfDetail() : 0}});
+    }
+
     if (m_d->projectionUpdatesCompressor.putUpdateInfo(info)) {
         Q_EMIT sigCanvasCacheUpdated();
     }
@@ -943,6 +958,9 @@ void KisCanvas2::updateCanvasProjection()
         tryIssueCanvasUpdates(vRect);
     };
 
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    const qint64 traceStartTime = tracer->isEnabled() ? tracer->timestamp() : -1;
+
     bool shouldExplicitlyIssueUpdates = false;
 
     QVector<KisUpdateInfoSP> infoObjects;
@@ -986,6 +1004,15 @@ void KisCanvas2::updateCanvasProjection()
     } else if (shouldExplicitlyIssueUpdates) {
         tryIssueCanvasUpdates(m_d->coordinatesConverter->imageRectInImagePixels());
     }
+
+    if (!originalInfoObjects.isEmpty()) {
+        KisOpenglCanvasDebugger::instance()->notifyCanvasUpdateUploaded();
+    }
+
+    if (traceStartTime >= 0) {
+        tracer->addSpan("canvas", QStringLiteral("upload projection"), traceStartTime,
+                        {{"updates", originalInfoObjects.size()}});
+    }
 }
 
 void KisCanvas2::slotBeginUpdatesBatch()
@@ -1186,12 +1213,26 @@ void KisCanvas2::slotEffectiveZoomChanged(qreal newZoom)
         m_d->prescaledProjection->notifyZoomChanged();
     }
 
-    notifyLevelOfDetailChange();
+    /**
+     * While the user is zooming, the canvas is rendered from the
+     * mipmaps of the Lod0 textures, which are always available on the
+     * GPU. Switching the desired level of detail on every zoom step
+     * would restart the regeneration of the LodN planes on the CPU
+     * again and again, so we switch it only when the zoom settles
+     * down. The refined plane is uploaded to the textures as soon as
+     * it is ready.
+     */
+    m_d->levelOfDetailChangeCompressor.start();
     updateCanvas(); // update the canvas, because that isn't done when zooming using KoZoomAction
 
     m_d->regionOfInterestUpdateCompressor.start();
 }
 
+void KisCanvas2::slotUpdateLevelOfDetail()
+{
+    notifyLevelOfDetailChange();
+}
+
 QRect KisCanvas2::regionOfInterest() const
 {
     return m_d->regionOfInterest;
@@ -1210,6 +1251,15 @@ void KisCanvas2::slotUpdateRegionOfInterest()
 
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         Q_EMIT sigRegionOfInterestChanged(m_d->regionOfInterest);
+
+        /**
+         * When the user pans back to a swapped-out area, let the
+         * tiles engine load it before the canvas starts to fetch it
+         */
+        KisImageSP image = this->image();
+        if (image) {
+            image->requestTilePrefetch(m_d->regionOfInterest);
+        }
     }
 }
 
@@ -1289,6 +1339,14 @@ KisImageWSP KisCanvas2::image() const
 
 }
 
+void KisCanvas2::notifyFramePresented()
+{
+    KisImageSP image = this->image();
+    if (image) {
+        image->reportFramePresented();
+    }
+}
+
 KisImageWSP KisCanvas2::currentImage() const
 {
     return m_d->view->image();
@@ -163,6 +163,13 @@ public: // KisCanvas2 methods
     KisDisplayColorConverter *displayColorConverter() const;
     KisExposureGammaCorrectionInterface* exposureGammaCorrectionInterface() const;
 
+    /**
+     * Called by the canvas widget every time it has painted a frame,
+     * lets the image scheduler adjust the spontaneous jobs to the
+     * frame rate.
+     */
+    void notifyFramePresented();
+
     /**
      * @brief fetchProofingOptions
      * Get the options for softproofing, and apply the view-specific state without affecting
@@ -286,6 +293,7 @@ private Q_SLOTS:
     void slotSetLodUpdatesBlocked(bool value);
 
     void slotEffectiveZoomChanged(qreal newZoom);
+    void slotUpdateLevelOfDetail();
     void slotCanvasStateChanged();
 
     void viewportOffsetMoved(const QPointF &oldOffset, const QPointF &newOffset);
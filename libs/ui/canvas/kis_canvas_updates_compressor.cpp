@@ -15,6 +15,8 @@ bool KisCanvasUpdatesCompressor::putUpdateInfo(KisUpdateInfoSP info)
     QMutexLocker l(&m_mutex);
 
     if (info->canBeCompressed()) {
+        const KisOpenGLUpdateInfo *glInfo = dynamic_cast<const KisOpenGLUpdateInfo*>(info.data());
+
         KisUpdateInfoList::iterator it = m_updatesList.begin();
         while (it != m_updatesList.end()) {
             if ((*it)->canBeCompressed() &&
@@ -28,6 +30,17 @@ bool KisCanvasUpdatesCompressor::putUpdateInfo(KisUpdateInfoSP info)
                  */
                 it = m_updatesList.erase(it);
             } else {
+                /**
+                 * Partially overlapping updates (e.g. the dabs of mirrored or
+                 * multibrush strokes) still share many tiles with the new
+                 * update. The shared tiles come to the canvas with the new
+                 * update anyway, so the older one can skip them.
+                 */
+                KisOpenGLUpdateInfo *oldGLInfo = dynamic_cast<KisOpenGLUpdateInfo*>(it->data());
+                if (glInfo && oldGLInfo && (*it)->canBeCompressed()) {
+                    oldGLInfo->dropTilesOverriddenBy(*glInfo);
+                }
+
                 ++it;
             }
         }
@@ -19,6 +19,23 @@
 #include "kis_grid_config.h"
 #include "kis_coordinates_converter.h"
 
+namespace {
+
+/**
+ * Every pen change makes the OpenGL paint engine flush the
+ * vertices it has collected, so the lines of the grid are
+ * collected first and passed in a single call per pen
+ */
+void drawLinesBatch(QPainter &gc, const QPen &pen, const QVector<QLineF> &lines)
+{
+    if (lines.isEmpty()) return;
+
+    gc.setPen(pen);
+    gc.drawLines(lines);
+}
+
+}
+
 struct KisGridDecoration::Private
 {
     KisGridConfig config;
@@ -112,13 +129,19 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
                 subdivisionPen.setDashOffset(y1 * scale);
             }
 
+            QVector<QLineF> mainLines;
+            QVector<QLineF> subdivisionLines;
+
             for (int i = lineIndexFirst; i <= lineIndexLast; i++) {
                 int w = offset + i * step;
 
-                gc.setPen(i % subdivision == 0 ? mainPen : subdivisionPen);
                 // we adjusted y2 to draw the grid correctly, clip it now...
-                gc.drawLine(QPointF(w, y1),QPointF(w, qMin(y2, qreal(imageRectInImagePixels.bottom() + 1))));
+                (i % subdivision == 0 ? mainLines : subdivisionLines)
+                    .append(QLineF(QPointF(w, y1), QPointF(w, qMin(y2, qreal(imageRectInImagePixels.bottom() + 1)))));
             }
+
+            drawLinesBatch(gc, mainPen, mainLines);
+            drawLinesBatch(gc, subdivisionPen, subdivisionLines);
         }
 
         if (m_d->config.ySpacingActive()) {
@@ -138,13 +161,19 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
                 subdivisionPen.setDashOffset(x1 * scale);
             }
 
+            QVector<QLineF> mainLines;
+            QVector<QLineF> subdivisionLines;
+
             for (int i = lineIndexFirst; i <= lineIndexLast; i++) {
                 int w = offset + i * step;
 
-                gc.setPen(i % subdivision == 0 ? mainPen : subdivisionPen);
                 // we adjusted x2 to draw the grid correctly, clip it now...
-                gc.drawLine(QPointF(x1, w),QPointF(qMin(x2, qreal(imageRectInImagePixels.right() + 1)), w));
+                (i % subdivision == 0 ? mainLines : subdivisionLines)
+                    .append(QLineF(QPointF(x1, w), QPointF(qMin(x2, qreal(imageRectInImagePixels.right() + 1)), w)));
             }
+
+            drawLinesBatch(gc, mainPen, mainLines);
+            drawLinesBatch(gc, subdivisionPen, subdivisionLines);
         }
     } else if (gridType == KisGridConfig::GRID_ISOMETRIC_LEGACY)  {
         qreal x1, y1, x2, y2;
@@ -187,11 +216,11 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
             }
 
             qreal counter = qFloor((-(offset + offsetY)) / correctedAngleSpacing);
+            QVector<QLineF> lines;
 
             while (finalY < bottomRightOfImageY) {
 
                 const qreal w = (counter * correctedAngleSpacing) + offsetY + offset;
-                gc.setPen(mainPen);
 
                 // calculate where the ending point will be based off the angle
                 const qreal startingY = w;
@@ -202,10 +231,12 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
 
                 finalY = startingY - length2;
 
-                gc.drawLine(QPointF(x1, w), QPointF(horizontalDistance, finalY));
+                lines.append(QLineF(QPointF(x1, w), QPointF(horizontalDistance, finalY)));
 
                 counter = counter + 1.0;
             }
+
+            drawLinesBatch(gc, mainPen, lines);
         }
 
         // right angle (almost the same thing, except starting the lines on the right side)
@@ -236,21 +267,23 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
             const qreal additionalOffset = yLeftFirst - yHigher;
             qreal finalY = 0.0;
             qreal counter = qFloor((-(offsetY - offset)) / correctedAngleSpacing);
+            QVector<QLineF> lines;
 
             while (finalY < bottomLeftOfImageY) {
 
                 const qreal w = (counter * correctedAngleSpacing) + offsetY - offset + additionalOffset;
-                gc.setPen(mainPen);
 
                 // calculate where the ending point will be based off the angle
                 const qreal startingY = w;
 
                 finalY = startingY - length2;
 
-                gc.drawLine(QPointF(x2, w), QPointF(0.0, finalY));
+                lines.append(QLineF(QPointF(x2, w), QPointF(0.0, finalY)));
 
                 counter = counter + 1.0;
             }
+
+            drawLinesBatch(gc, mainPen, lines);
         }
     } else if (gridType == KisGridConfig::GRID_ISOMETRIC)  {
         qreal x1, y1, xRight, yBottom;
@@ -301,16 +334,22 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
 
             qreal startingY = yLeftFirst + offsetY + offsetX + additionalOffset;
 
+            QVector<QLineF> mainLines;
+            QVector<QLineF> subdivisionLines;
+
             while (finalY < yBottom) {
                 // calculate where the ending point will be based off the angle
                 finalY = startingY - length2;
 
-                gc.setPen(qAbs(subdivisionIndex) % subdivision == 0 ? mainPen : subdivisionPen);
-                gc.drawLine(QPointF(0.0, startingY), QPointF(xRight, finalY));
+                (qAbs(subdivisionIndex) % subdivision == 0 ? mainLines : subdivisionLines)
+                    .append(QLineF(QPointF(0.0, startingY), QPointF(xRight, finalY)));
 
                 subdivisionIndex++;
                 startingY += trigoCache.correctedAngleLeftCellSize;
             }
+
+            drawLinesBatch(gc, mainPen, mainLines);
+            drawLinesBatch(gc, subdivisionPen, subdivisionLines);
         }
 
         // right angle (almost the same thing, except starting the lines on the right side)
@@ -338,16 +377,22 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
 
             qreal startingY = yLeftFirst + offsetY - offsetX + additionalOffset;
 
+            QVector<QLineF> mainLines;
+            QVector<QLineF> subdivisionLines;
+
             while (finalY < yBottom) {
                 // calculate where the ending point will be based off the angle
                 finalY = startingY - length2;
 
-                gc.setPen(qAbs(subdivisionIndex) % subdivision == 0 ? mainPen : subdivisionPen);
-                gc.drawLine(QPointF(xRight, startingY), QPointF(0.0, finalY));
+                (qAbs(subdivisionIndex) % subdivision == 0 ? mainLines : subdivisionLines)
+                    .append(QLineF(QPointF(xRight, startingY), QPointF(0.0, finalY)));
 
                 subdivisionIndex++;
                 startingY += trigoCache.correctedAngleRightCellSize;
             }
+
+            drawLinesBatch(gc, mainPen, mainLines);
+            drawLinesBatch(gc, subdivisionPen, subdivisionLines);
         }
 
         // vertical
@@ -368,12 +413,16 @@ void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, c
             pX = offset + (pX - qFloor(pX)) * trigoCache.verticalSpace;
             pX = pX - trigoCache.verticalSpace * qFloor(pX/trigoCache.verticalSpace);
 
+            QVector<QLineF> lines;
+
             while(pX <= updateRectInImagePixels.right()) {
                 if (pX > updateRectInImagePixels.left()) {
-                    gc.drawLine(QPointF(pX, updateRectInImagePixels.top()),QPointF(pX, qMin(yBottom, qreal(updateRectInImagePixels.bottom() + 1))));
+                    lines.append(QLineF(QPointF(pX, updateRectInImagePixels.top()),QPointF(pX, qMin(yBottom, qreal(updateRectInImagePixels.bottom() + 1)))));
                 }
                 pX += trigoCache.verticalSpace;
             }
+
+            gc.drawLines(lines);
         }
     }
 
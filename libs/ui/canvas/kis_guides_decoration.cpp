@@ -51,6 +51,8 @@ void KisGuidesDecoration::drawDecoration(QPainter &painter, const QRectF& update
     painter.setRenderHints(QPainter::Antialiasing, false);
     painter.setRenderHints(QPainter::Antialiasing, false);
 
+    QVector<QLine> lines;
+
     Q_FOREACH (qreal guide, m_d->guidesConfig.horizontalGuideLines()) {
         if (guide < updateArea.top() - borderDelta ||
             guide > updateArea.bottom() + borderDelta) {
@@ -60,7 +62,7 @@ void KisGuidesDecoration::drawDecoration(QPainter &painter, const QRectF& update
 
         const QPoint p0 = converter->documentToWidget(QPointF(updateArea.left() - borderDelta, guide)).toPoint();
         const QPoint p1 = converter->documentToWidget(QPointF(updateArea.right() + borderDelta, guide)).toPoint();
-        painter.drawLine(p0, p1);
+        lines.append(QLine(p0, p1));
     }
 
     Q_FOREACH (qreal guide, m_d->guidesConfig.verticalGuideLines()) {
@@ -72,8 +74,11 @@ void KisGuidesDecoration::drawDecoration(QPainter &painter, const QRectF& update
 
         const QPoint p0 = converter->documentToWidget(QPointF(guide, updateArea.top() - borderDelta)).toPoint();
         const QPoint p1 = converter->documentToWidget(QPointF(guide, updateArea.bottom() + borderDelta)).toPoint();
-        painter.drawLine(p0, p1);
+        lines.append(QLine(p0, p1));
     }
 
+    // a single call lets the paint engine batch all the guides
+    painter.drawLines(lines);
+
     painter.restore();
 }
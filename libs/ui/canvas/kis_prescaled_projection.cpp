@@ -15,6 +15,7 @@
 #include <QPoint>
 #include <QSize>
 #include <QPainter>
+#include <QtConcurrent>
 
 #include <KoColorProfile.h>
 #include <KoViewConverter.h>
@@ -28,6 +29,7 @@
 #include "kis_coordinates_converter.h"
 #include "kis_projection_backend.h"
 #include "kis_image_pyramid.h"
+#include "kis_image_patch.h"
 #include "kis_display_filter.h"
 #include <KisDisplayConfig.h>
 
@@ -62,6 +64,13 @@ void copyQImage(qint32 deltaX, qint32 deltaY, QImage* dstImage, const QImage& sr
     }
 }
 
+namespace {
+struct PreparedPatch {
+    KisPPUpdateInfoSP info;
+    KisImagePatch patch;
+};
+}
+
 struct KisPrescaledProjection::Private {
     Private()
         : viewportSize(0, 0)
@@ -158,26 +167,19 @@ void KisPrescaledProjection::viewportMoved(const QPointF &offset)
         updateRegion -= savedArea;
     }
 
-    QPainter gc(&newImage);
+    QVector<QRect> patches;
     auto rc = updateRegion.begin();
     while (rc != updateRegion.end()) {
         QRect rect = *rc;
         QRect imageRect =
             m_d->coordinatesConverter->viewportToImage(rect).toAlignedRect();
-        QVector<QRect> patches =
-            KritaUtils::splitRectIntoPatches(imageRect, m_d->updatePatchSize);
-
-        Q_FOREACH (const QRect& rc, patches) {
-            QRect viewportPatch =
-                m_d->coordinatesConverter->imageToViewport(rc).toAlignedRect();
-
-            KisPPUpdateInfoSP info = getInitialUpdateInformation(QRect());
-            fillInUpdateInformation(viewportPatch, info);
-            drawUsingBackend(gc, info);
-        }
+        patches += KritaUtils::splitRectIntoPatches(imageRect, m_d->updatePatchSize);
         rc++;
     }
 
+    QPainter gc(&newImage);
+    drawPatchesUsingBackend(gc, patches);
+
     m_d->prescaledQImage = newImage;
 }
 
@@ -240,15 +242,9 @@ void KisPrescaledProjection::preScale()
     QVector<QRect> patches =
         KritaUtils::splitRectIntoPatches(imageRect, m_d->updatePatchSize);
 
-    Q_FOREACH (const QRect& rc, patches) {
-        QRect viewportPatch = m_d->coordinatesConverter->imageToViewport(rc).toAlignedRect();
-        KisPPUpdateInfoSP info = getInitialUpdateInformation(QRect());
-        fillInUpdateInformation(viewportPatch, info);
-        QPainter gc(&m_d->prescaledQImage);
-        gc.setCompositionMode(QPainter::CompositionMode_Source);
-        drawUsingBackend(gc, info);
-    }
-
+    QPainter gc(&m_d->prescaledQImage);
+    gc.setCompositionMode(QPainter::CompositionMode_Source);
+    drawPatchesUsingBackend(gc, patches);
 }
 
 void KisPrescaledProjection::setDisplayConfig(const KisDisplayConfig &config)
@@ -370,7 +366,21 @@ void KisPrescaledProjection::updateScaledImage(KisPPUpdateInfoSP info)
 {
     QPainter gc(&m_d->prescaledQImage);
     gc.setCompositionMode(QPainter::CompositionMode_Source);
-    drawUsingBackend(gc, info);
+
+    const QRect patchRect(info->imageRect.topLeft(), m_d->updatePatchSize);
+
+    if (patchRect.contains(info->imageRect)) {
+        drawUsingBackend(gc, info);
+    } else {
+        /**
+         * Big updates (filters, fills, undo of a large stroke) are
+         * split into the same patches as the full prescale to be
+         * able to scale them in parallel
+         */
+        drawPatchesUsingBackend(gc,
+            KritaUtils::splitRectIntoPatches(info->dirtyImageRectVar,
+                                             m_d->updatePatchSize));
+    }
 }
 
 void KisPrescaledProjection::drawUsingBackend(QPainter &gc, KisPPUpdateInfoSP info)
@@ -388,3 +398,45 @@ void KisPrescaledProjection::drawUsingBackend(QPainter &gc, KisPPUpdateInfoSP in
     }
 }
 
+void KisPrescaledProjection::drawPatchesUsingBackend(QPainter &gc, const QVector<QRect> &imagePatches)
+{
+    QVector<PreparedPatch> preparedPatches;
+    preparedPatches.reserve(imagePatches.size());
+
+    Q_FOREACH (const QRect &rc, imagePatches) {
+        QRect viewportPatch = m_d->coordinatesConverter->imageToViewport(rc).toAlignedRect();
+        KisPPUpdateInfoSP info = getInitialUpdateInformation(QRect());
+        fillInUpdateInformation(viewportPatch, info);
+
+        if (!info->imageRect.isEmpty()) {
+            preparedPatches.append({info, KisImagePatch()});
+        }
+    }
+
+    /**
+     * Fetching the pixels from the backend and smooth-scaling them
+     * is the expensive part of the update and the patches don't
+     * depend on each other, so it is done in the global thread pool.
+     * QImage::scaled() already uses the SIMD-optimized scalers of Qt.
+     *
+     * The painting itself stays sequential: the viewport rects of
+     * the neighbouring patches overlap by their borders.
+     */
+    auto preparePatch = [this] (PreparedPatch &p) {
+        p.patch = m_d->projectionBackend->getNearestPatch(p.info);
+
+        if (p.info->transfer == KisPPUpdateInfo::PATCH) {
+            p.patch.preScale(p.info->viewportRect);
+        }
+    };
+
+    if (preparedPatches.size() > 1) {
+        QtConcurrent::blockingMap(preparedPatches, preparePatch);
+    } else {
+        std::for_each(preparedPatches.begin(), preparedPatches.end(), preparePatch);
+    }
+
+    for (PreparedPatch &p : preparedPatches) {
+        p.patch.drawMe(gc, p.info->viewportRect, p.info->renderHints);
+    }
+}
@@ -161,6 +161,13 @@ private:
      */
     void drawUsingBackend(QPainter &gc, KisPPUpdateInfoSP info);
 
+    /**
+     * Draws the patches of the image that cover \p imagePatches. The
+     * patches are fetched and prescaled in parallel and then painted
+     * one by one on \p gc
+     */
+    void drawPatchesUsingBackend(QPainter &gc, const QVector<QRect> &imagePatches);
+
     struct Private;
     Private * const m_d;
 };
@@ -121,6 +121,8 @@ void KisQPainterCanvas::paintEvent(QPaintEvent * ev)
 
     gc.end();
     m_d->repaintDbg.paint(this, ev);
+
+    canvas()->notifyFramePresented();
 }
 
 void KisQPainterCanvas::drawImage(QPainter & gc, const QRect &updateWidgetRect) const
@@ -6,6 +6,11 @@
 #include "kis_update_info.h"
 #include <KisStaticInitializer.h>
 
+#include <algorithm>
+
+#include <QHash>
+#include <QPair>
+
 /**
  * The connection in KisCanvas2 uses queued signals
  * with an argument of KisNodeSP type, so we should
@@ -88,6 +93,27 @@ bool KisOpenGLUpdateInfo::tryMergeWith(const KisOpenGLUpdateInfo &rhs)
     return true;
 }
 
+int KisOpenGLUpdateInfo::dropTilesOverriddenBy(const KisOpenGLUpdateInfo &rhs)
+{
+    if (m_levelOfDetail != rhs.m_levelOfDetail) return 0;
+    if (!m_dirtyImageRect.intersects(rhs.m_dirtyImageRect)) return 0;
+
+    QHash<QPair<int, int>, QRect> newerPatches;
+    Q_FOREACH (const KisTextureTileUpdateInfoSP &tile, rhs.tileList) {
+        newerPatches.insert(qMakePair(tile->tileCol(), tile->tileRow()), tile->realPatchRect());
+    }
+
+    auto isOverridden = [&newerPatches] (const KisTextureTileUpdateInfoSP &tile) {
+        auto it = newerPatches.constFind(qMakePair(tile->tileCol(), tile->tileRow()));
+        return it != newerPatches.constEnd() && it->contains(tile->realPatchRect());
+    };
+
+    const int oldSize = tileList.size();
+    tileList.erase(std::remove_if(tileList.begin(), tileList.end(), isOverridden), tileList.end());
+
+    return oldSize - tileList.size();
+}
+
 KisMarkerUpdateInfo::KisMarkerUpdateInfo(KisMarkerUpdateInfo::Type type, const QRect &dirtyImageRect)
     : m_type(type),
       m_dirtyImageRect(dirtyImageRect)
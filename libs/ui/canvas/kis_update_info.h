@@ -70,6 +70,16 @@ public:
 
     bool tryMergeWith(const KisOpenGLUpdateInfo& rhs);
 
+    /**
+     * Removes the tiles whose patches are fully overwritten by the
+     * tiles of the newer update \p rhs, so that the same pixels are
+     * not uploaded twice. The dirty rect is kept as it is, so the
+     * update still repaints its area of the canvas.
+     *
+     * \return the number of the dropped tiles
+     */
+    int dropTilesOverriddenBy(const KisOpenGLUpdateInfo &rhs);
+
 private:
     QRect m_dirtyImageRect;
     int m_levelOfDetail;
@@ -13,12 +13,15 @@
 #include "kis_properties_configuration.h"
 
 #include "KisMimeDatabase.h"
+#include "animation/KisVideoSaver.h"
 
 #include <QFileInfo>
 #include <QDir>
 #include <QMessageBox>
 #include <QApplication>
 
+#include <algorithm>
+
 struct KisAsyncAnimationFramesSaveDialog::Private {
     Private(KisImageSP _image,
             const KisTimeSpan &_range,
@@ -53,6 +56,9 @@ struct KisAsyncAnimationFramesSaveDialog::Private {
 
     int sequenceNumberingOffset;
     KisPropertiesConfigurationSP exportConfiguration;
+
+    KisAnimationVideoSaver *framesEncoder = nullptr;
+    bool keepOtherFrames = false;
 };
 
 KisAsyncAnimationFramesSaveDialog::KisAsyncAnimationFramesSaveDialog(KisImageSP originalImage,
@@ -74,6 +80,11 @@ KisAsyncAnimationFramesSaveDialog::~KisAsyncAnimationFramesSaveDialog()
 
 KisAsyncAnimationRenderDialogBase::Result KisAsyncAnimationFramesSaveDialog::regenerateRange(KisViewManager *viewManager)
 {
+    // piped frames don't touch the files in the destination directory
+    if (m_d->framesEncoder) {
+        return KisAsyncAnimationRenderDialogBase::regenerateRange(viewManager);
+    }
+
     QFileInfo fileInfo(savedFilesMaskWildcard());
     QDir dir(fileInfo.absolutePath());
 
@@ -84,6 +95,15 @@ KisAsyncAnimationRenderDialogBase::Result KisAsyncAnimationFramesSaveDialog::reg
 
     // Check for overwrite. (Batch mode always overwrites.)
     QStringList preexistingFileNames = dir.entryList({ fileInfo.fileName() });
+
+    if (m_d->keepOtherFrames) {
+        const QStringList renderedFileNames = savedFiles();
+        preexistingFileNames.erase(
+            std::remove_if(preexistingFileNames.begin(), preexistingFileNames.end(),
+                           [&renderedFileNames] (const QString &file) {
+                               return !renderedFileNames.contains(file);
+                           }), preexistingFileNames.end());
+    }
     if (!preexistingFileNames.isEmpty() && !batchMode()) {
         QStringList truncatedList = preexistingFileNames;
 
@@ -174,14 +194,23 @@ QList<int> KisAsyncAnimationFramesSaveDialog::calcDirtyFrames() const
 
 KisAsyncAnimationRendererBase *KisAsyncAnimationFramesSaveDialog::createRenderer(KisImageSP image)
 {
-    return new KisAsyncAnimationFramesSavingRenderer(image,
-                                                     m_d->filenamePrefix,
-                                                     m_d->filenameSuffix,
-                                                     m_d->outputMimeType,
-                                                     m_d->range,
-                                                     m_d->sequenceNumberingOffset,
-                                                     m_d->onlyNeedsUniqueFrames,
-                                                     m_d->exportConfiguration);
+    KisAsyncAnimationFramesSavingRenderer *renderer =
+        new KisAsyncAnimationFramesSavingRenderer(image,
+                                                  m_d->filenamePrefix,
+                                                  m_d->filenameSuffix,
+                                                  m_d->outputMimeType,
+                                                  m_d->range,
+                                                  m_d->sequenceNumberingOffset,
+                                                  m_d->onlyNeedsUniqueFrames,
+                                                  m_d->exportConfiguration);
+
+    if (m_d->framesEncoder) {
+        renderer->setPipeFrames(true);
+        QObject::connect(renderer, &KisAsyncAnimationFramesSavingRenderer::sigFrameDataReady,
+                         m_d->framesEncoder, &KisAnimationVideoSaver::slotFrameDataReady);
+    }
+
+    return renderer;
 }
 
 void KisAsyncAnimationFramesSaveDialog::initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer, KisImageSP image, int frame)
@@ -235,3 +264,13 @@ QList<int> KisAsyncAnimationFramesSaveDialog::getUniqueFrames() const
 {
     return this->calcDirtyFrames();
 }
+
+void KisAsyncAnimationFramesSaveDialog::setFramesEncoder(KisAnimationVideoSaver *encoder)
+{
+    m_d->framesEncoder = encoder;
+}
+
+void KisAsyncAnimationFramesSaveDialog::setKeepOtherFrames(bool value)
+{
+    m_d->keepOtherFrames = value;
+}
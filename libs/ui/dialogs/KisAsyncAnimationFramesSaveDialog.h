@@ -10,6 +10,7 @@
 #include "KisAsyncAnimationRenderDialogBase.h"
 #include "kis_types.h"
 
+class KisAnimationVideoSaver;
 
 class KRITAUI_EXPORT KisAsyncAnimationFramesSaveDialog : public KisAsyncAnimationRenderDialogBase
 {
@@ -32,6 +33,20 @@ public:
 
     QList<int> getUniqueFrames() const;
 
+    /**
+     * Pipe the rendered frames into \p encoder instead of saving
+     * them into files. The encoder should be started with
+     * KisAnimationVideoSaver::startPipedEncoding() beforehand.
+     */
+    void setFramesEncoder(KisAnimationVideoSaver *encoder);
+
+    /**
+     * When set, only the files of the rendered range are overwritten
+     * and the other files of the sequence in the destination directory
+     * are kept. Used when the range is rendered in several parts.
+     */
+    void setKeepOtherFrames(bool value);
+
 protected:
     QList<int> calcDirtyFrames() const override;
     KisAsyncAnimationRendererBase* createRenderer(KisImageSP image) override;
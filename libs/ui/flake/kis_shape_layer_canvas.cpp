@@ -418,20 +418,14 @@ void KisShapeLayerCanvas::repaint()
     const qint32 MASK_IMAGE_WIDTH = 256;
     const qint32 MASK_IMAGE_HEIGHT = 256;
 
-    QImage image(MASK_IMAGE_WIDTH, MASK_IMAGE_HEIGHT, QImage::Format_ARGB32);
-    QPainter tempPainter(&image);
-
-    if(m_parentLayer->antialiased()) {
-        tempPainter.setRenderHint(QPainter::Antialiasing);
-        tempPainter.setRenderHint(QPainter::TextAntialiasing);
-    }
-
-    quint8 * dstData = new quint8[MASK_IMAGE_WIDTH * MASK_IMAGE_HEIGHT * m_projection->pixelSize()];
-
     QRect repaintRect = paintJobsOrder.uncroppedViewUpdateRect;
     m_projection->clear(repaintRect);
 
-    Q_FOREACH (const KoShapeManager::PaintJob &job, paintJobsOrder.jobs) {
+    QVector<const KoShapeManager::PaintJob*> jobs;
+
+    const QList<KoShapeManager::PaintJob> &allJobs = paintJobsOrder.jobs;
+
+    for (const KoShapeManager::PaintJob &job : allJobs) {
         if (job.isEmpty()) {
             m_projection->clear(job.viewUpdateRect);
             continue;
@@ -442,53 +436,59 @@ void KisShapeLayerCanvas::repaint()
             continue;
         }
 
+        jobs << &job;
+        repaintRect |= job.viewUpdateRect;
+    }
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstColorSpace = m_projection->colorSpace();
+    const bool needsConversion = !(*dstColorSpace == *srcColorSpace);
+    const bool antialiased = m_parentLayer->antialiased();
+    const QTransform documentToView = viewConverter()->documentToView();
+
+    /**
+     * The jobs share the same cloned shapes, whose lazily calculated
+     * caches are not thread-safe, so the tiles are rasterized one by one.
+     * Every tile is rendered into an image of its own size, so that it
+     * could be converted and written in one go.
+     */
+    auto renderJob = [&] (const KoShapeManager::PaintJob *job) {
+        const QRect &rc = job->viewUpdateRect;
+
+        QImage image(rc.size(), QImage::Format_ARGB32);
         image.fill(0);
 
-        tempPainter.setTransform(QTransform());
-        tempPainter.setClipRect(QRect(0,0,job.viewUpdateRect.width(), job.viewUpdateRect.height()));
-        tempPainter.setTransform(viewConverter()->documentToView() *
-                                 QTransform::fromTranslate(-job.viewUpdateRect.x(), -job.viewUpdateRect.y()));
+        {
+            QPainter tempPainter(&image);
 
-        m_shapeManager->paintJob(tempPainter, job);
+            if (antialiased) {
+                tempPainter.setRenderHint(QPainter::Antialiasing);
+                tempPainter.setRenderHint(QPainter::TextAntialiasing);
+            }
 
-        if (image.size() != job.viewUpdateRect.size()) {
-            const quint8 *imagePtr = image.constBits();
-            const int imageRowStride = 4 * image.width();
+            tempPainter.setClipRect(QRect(QPoint(), rc.size()));
+            tempPainter.setTransform(documentToView *
+                                     QTransform::fromTranslate(-rc.x(), -rc.y()));
 
-            for (int y = 0; y < job.viewUpdateRect.height(); y++) {
+            m_shapeManager->paintJob(tempPainter, *job);
+        }
 
-                KoColorSpaceRegistry::instance()->rgb8()
-                        ->convertPixelsTo(imagePtr, dstData, m_projection->colorSpace(),
-                                          job.viewUpdateRect.width(),
-                                          KoColorConversionTransformation::internalRenderingIntent(),
-                                          KoColorConversionTransformation::internalConversionFlags());
+        if (needsConversion) {
+            QVector<quint8> dstData(rc.width() * rc.height() * dstColorSpace->pixelSize());
 
-                m_projection->writeBytes(dstData,
-                                         job.viewUpdateRect.x(),
-                                         job.viewUpdateRect.y() + y,
-                                         job.viewUpdateRect.width(),
-                                         1);
+            srcColorSpace->convertPixelsTo(image.constBits(), dstData.data(), dstColorSpace,
+                                           rc.width() * rc.height(),
+                                           KoColorConversionTransformation::internalRenderingIntent(),
+                                           KoColorConversionTransformation::internalConversionFlags());
 
-                imagePtr += imageRowStride;
-            }
+            m_projection->writeBytes(dstData.constData(), rc);
         } else {
-            KoColorSpaceRegistry::instance()->rgb8()
-                    ->convertPixelsTo(image.constBits(), dstData, m_projection->colorSpace(),
-                                      MASK_IMAGE_WIDTH * MASK_IMAGE_HEIGHT,
-                                      KoColorConversionTransformation::internalRenderingIntent(),
-                                      KoColorConversionTransformation::internalConversionFlags());
-
-            m_projection->writeBytes(dstData,
-                                     job.viewUpdateRect.x(),
-                                     job.viewUpdateRect.y(),
-                                     MASK_IMAGE_WIDTH,
-                                     MASK_IMAGE_HEIGHT);
-
+            m_projection->writeBytes(image.constBits(), rc);
         }
-        repaintRect |= job.viewUpdateRect;
-    }
+    };
+
+    std::for_each(jobs.begin(), jobs.end(), renderJob);
 
-    delete[] dstData;
     m_projection->purgeDefaultPixels();
     m_parentLayer->setDirty(repaintRect);
 
@@ -47,6 +47,7 @@
 #include "kis_shortcut_configuration.h"
 
 #include <input/kis_tablet_debugger.h>
+#include <opengl/kis_opengl_canvas_debugger.h>
 #include <kis_signal_compressor.h>
 
 #include "kis_extended_modifiers_mapper.h"
@@ -500,6 +501,11 @@ bool KisInputManager::eventFilterImpl(QEvent * event)
         d->debugEvent<QMouseEvent, true>(event);
 
         QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+
+        if (mouseEvent->buttons() != Qt::NoButton) {
+            KisOpenglCanvasDebugger::instance()->notifyInputEvent(mouseEvent->timestamp());
+        }
+
         retval = compressMoveEventCommon(mouseEvent);
 
         break;
@@ -656,6 +662,11 @@ bool KisInputManager::eventFilterImpl(QEvent * event)
         d->debugEvent<QTabletEvent, false>(event);
 
         QTabletEvent *tabletEvent = static_cast<QTabletEvent*>(event);
+
+        if (tabletEvent->pressure() > 0.0) {
+            KisOpenglCanvasDebugger::instance()->notifyInputEvent(tabletEvent->timestamp());
+        }
+
         retval = compressMoveEventCommon(tabletEvent);
 
         if (d->tabletLatencyTracker) {
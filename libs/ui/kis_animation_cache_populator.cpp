@@ -6,17 +6,25 @@
 
 #include "kis_animation_cache_populator.h"
 
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include <QTimer>
+#include <QSet>
 #include <QStack>
+#include <QVector>
 
 #include "kis_config.h"
 #include "kis_config_notifier.h"
 #include "KisPart.h"
+#include "KisDocumentMemoryBudgeter.h"
 #include "KisDocument.h"
 #include "kis_image.h"
+#include "kis_image_config.h"
 #include "kis_image_animation_interface.h"
+#include "kis_memory_statistics_server.h"
 #include "kis_canvas2.h"
 #include "kis_time_span.h"
 #include "kis_animation_frame_cache.h"
@@ -30,8 +38,47 @@
 
 #include <KisLockFrameGenerationLock.h>
 #include "KisAsyncAnimationCacheRenderer.h"
-#include "dialogs/KisAsyncAnimationCacheRenderDialog.h"
+#include "KisRunnableBasedStrokeStrategy.h"
+#include "KisRunnableStrokeJobData.h"
 
+namespace {
+
+int calculateNumberMemoryAllowedClones(KisImageSP image)
+{
+    KisMemoryStatisticsServer::Statistics stats =
+        KisMemoryStatisticsServer::instance()
+        ->fetchMemoryStatistics(image);
+
+    const qint64 allowedMemory = 0.8 * stats.tilesHardLimit - stats.realMemorySize;
+    const qint64 cloneSize = stats.projectionsSize;
+
+    if (cloneSize > 0 && allowedMemory > 0) {
+        return allowedMemory / cloneSize;
+    }
+
+    return 0;
+}
+
+/**
+ * A stroke that just waits for the strokes of a dropped clone to
+ * finish. Its barrier job runs only when all the (cancelled) frame
+ * strokes of the clone have left the queue.
+ */
+class KisDropImageCloneStrokeStrategy : public KisRunnableBasedStrokeStrategy
+{
+public:
+    KisDropImageCloneStrokeStrategy()
+        : KisRunnableBasedStrokeStrategy(QLatin1String("drop-image-clone-stroke"))
+    {
+        enableJob(JOB_DOSTROKE, true, KisStrokeJobData::BARRIER);
+
+        setClearsRedoOnStart(false);
+        setRequestsOtherStrokesToEnd(false);
+        setCanForgetAboutMe(true);
+    }
+};
+
+}
 
 struct KisAnimationCachePopulator::Private
 {
@@ -51,6 +98,32 @@ struct KisAnimationCachePopulator::Private
 
     KisAsyncAnimationCacheRenderer regenerator;
     bool calculateAnimationCacheInBackground = true;
+    int speculativeFramesRadius = 2;
+
+    /**
+     * The direction the playhead of the active document has moved
+     * last time. The frames ahead of the playhead are rendered first.
+     */
+    KisImageWSP playheadImage;
+    int lastPlayheadTime = -1;
+    int playbackDirection = 1;
+
+    /**
+     * The clones of the image the dirty frames of the playback range are
+     * rendered on in parallel with the regenerator. The clones are made
+     * on the first request and are dropped as soon as the source image
+     * changes or all the frames have been cached.
+     */
+    struct CloneWorker {
+        std::unique_ptr<KisAsyncAnimationCacheRenderer> renderer;
+        KisImageSP image;
+        int frame = -1;
+    };
+    std::vector<CloneWorker> cloneWorkers;
+    QVector<KisImageSP> droppedClones;
+    KisImageWSP clonesSource;
+    KisSignalAutoConnectionsStore clonesSourceConnections;
+    bool renderOnImageClones = false;
 
     enum State {
         NotWaitingForAnything,
@@ -165,7 +238,7 @@ struct KisAnimationCachePopulator::Private
             }
 
             RegenerationRequestResult result =
-                tryRequestGeneration(cache, KisTimeSpan(), priorityFrame);
+                tryRequestGeneration(cache, KisTimeSpan(), priorityFrame, -1);
             if (result == RequestSuccessful) return result;
         }
 
@@ -183,11 +256,12 @@ struct KisAnimationCachePopulator::Private
 
                 // Let's skip frames affected by changes to the active node (on the active document)
                 // This avoids constant invalidation and regeneration while drawing
+                const int currentTime = activeCanvas->currentImage()->animationInterface()->currentUITime();
+                updatePlaybackDirection(activeCanvas->currentImage(), currentTime);
+
                 KisNodeSP activeNode = activeCanvas->viewManager()->nodeManager()->activeNode();
                 KisTimeSpan skipRange;
                 if (activeNode) {
-                    const int currentTime = activeCanvas->currentImage()->animationInterface()->currentUITime();
-
                     if (!activeNode->keyframeChannels().isEmpty()) {
                         Q_FOREACH (const KisKeyframeChannel *channel, activeNode->keyframeChannels()) {
                             skipRange |= channel->affectedFrames(currentTime);
@@ -198,7 +272,7 @@ struct KisAnimationCachePopulator::Private
                 }
 
                 RegenerationRequestResult result =
-                    tryRequestGeneration(activeDocumentCache, skipRange, -1);
+                    tryRequestGeneration(activeDocumentCache, skipRange, -1, currentTime);
                 if (result == RequestSuccessful) return result;
             }
         }
@@ -216,15 +290,81 @@ struct KisAnimationCachePopulator::Private
                 continue;
             }
 
+            if (part->memoryBudgeter()->isImageInactive(cache->image())) {
+                // The caches of this image have been dropped to save memory
+                continue;
+            }
+
             RegenerationRequestResult result =
-                tryRequestGeneration(cache, KisTimeSpan(), -1);
+                tryRequestGeneration(cache, KisTimeSpan(), -1, -1);
             if (result == RequestSuccessful) return result;
         }
 
         return RequestRejected;
     }
 
-    RegenerationRequestResult tryRequestGeneration(KisAnimationFrameCacheSP cache, KisTimeSpan skipRange, int priorityFrame)
+    void updatePlaybackDirection(KisImageSP image, int currentTime)
+    {
+        if (KisImageSP(playheadImage) == image && currentTime != lastPlayheadTime) {
+            playbackDirection = currentTime > lastPlayheadTime ? 1 : -1;
+        } else if (KisImageSP(playheadImage) != image) {
+            playbackDirection = 1;
+        }
+
+        playheadImage = image;
+        lastPlayheadTime = currentTime;
+    }
+
+    /**
+     * The frames near the playhead are the most likely to be requested
+     * next (when playing, stepping or scrubbing the timeline), so they
+     * are rendered in the order of the distance from the playhead. The
+     * few frames the playhead is moving to go before everything else.
+     * Without the playhead (\p currentTime is -1) the frames go in the
+     * order of the playback range.
+     */
+    QVector<int> framesByPriority(const KisTimeSpan &range, int currentTime) const
+    {
+        QVector<int> result;
+        if (!range.isValid() || range.isInfinite()) return result;
+
+        result.reserve(range.duration());
+
+        if (!range.contains(currentTime)) {
+            for (int frame = range.start(); frame <= range.end(); frame++) {
+                result.append(frame);
+            }
+            return result;
+        }
+
+        result.append(currentTime);
+
+        for (int distance = 1; distance <= speculativeFramesRadius; distance++) {
+            const int frame = currentTime + playbackDirection * distance;
+            if (range.contains(frame)) {
+                result.append(frame);
+            }
+        }
+
+        const int maxDistance = qMax(currentTime - range.start(), range.end() - currentTime);
+
+        for (int distance = 1; distance <= maxDistance; distance++) {
+            const int aheadFrame = currentTime + playbackDirection * distance;
+            const int behindFrame = currentTime - playbackDirection * distance;
+
+            if (distance > speculativeFramesRadius && range.contains(aheadFrame)) {
+                result.append(aheadFrame);
+            }
+
+            if (range.contains(behindFrame)) {
+                result.append(behindFrame);
+            }
+        }
+
+        return result;
+    }
+
+    RegenerationRequestResult tryRequestGeneration(KisAnimationFrameCacheSP cache, KisTimeSpan skipRange, int priorityFrame, int currentTime)
     {
         KisImageSP image = cache->image();
         if (!image) return RequestRejected;
@@ -241,15 +381,208 @@ struct KisAnimationCachePopulator::Private
 
         KisTimeSpan currentRange = animation->documentPlaybackRange();
 
-        const int frame = priorityFrame >= 0 ? priorityFrame : KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(cache, currentRange, skipRange);
+        if (priorityFrame >= 0) {
+            return regenerate(cache, priorityFrame);
+        }
+
+        if (renderOnImageClones) {
+            return regenerateOnClones(cache, currentRange, skipRange, currentTime);
+        }
+
+        const QList<int> frames = calcDirtyFrames(cache, currentRange, skipRange, 1, currentTime);
 
-        if (frame >= 0) {
-            return regenerate(cache, frame);
+        if (!frames.isEmpty()) {
+            return regenerate(cache, frames.first());
         }
 
         return RequestRejected;
     }
 
+    bool frameIsRenderedOnClone(const KisTimeSpan &stillFrameRange) const
+    {
+        for (const CloneWorker &worker : cloneWorkers) {
+            if (worker.renderer->isActive() && stillFrameRange.contains(worker.frame)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    QList<int> calcDirtyFrames(KisAnimationFrameCacheSP cache, const KisTimeSpan &range,
+                               const KisTimeSpan &skipRange, int maxFrames, int currentTime) const
+    {
+        QList<int> result;
+
+        KisImageSP image = cache->image();
+        if (!image) return result;
+
+        QSet<int> visitedStillFrames;
+
+        Q_FOREACH (int frame, framesByPriority(range, currentTime)) {
+            if (result.size() >= maxFrames) break;
+
+            if (skipRange.contains(frame) ||
+                cache->frameStatus(frame) == KisAnimationFrameCache::Cached) {
+
+                continue;
+            }
+
+            const KisTimeSpan stillFrameRange =
+                KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
+
+            KIS_SAFE_ASSERT_RECOVER_BREAK(stillFrameRange.isValid());
+
+            if (visitedStillFrames.contains(stillFrameRange.start())) continue;
+            visitedStillFrames.insert(stillFrameRange.start());
+
+            if (!frameIsRenderedOnClone(stillFrameRange)) {
+                result.append(frame);
+            }
+        }
+
+        return result;
+    }
+
+    bool hasActiveClones() const
+    {
+        return std::any_of(cloneWorkers.begin(), cloneWorkers.end(),
+                           [] (const CloneWorker &worker) {
+                               return worker.renderer->isActive();
+                           });
+    }
+
+    void dropClones()
+    {
+        for (CloneWorker &worker : cloneWorkers) {
+            QObject::disconnect(worker.renderer.get(), 0, q, 0);
+
+            if (worker.renderer->isActive()) {
+                worker.renderer->cancelCurrentFrameRendering(KisAsyncAnimationRendererBase::UserCancelled);
+            }
+
+            /**
+             * The frame strokes of the clones are cancellable, so they
+             * end soon, but we still shouldn't wait for them in the GUI
+             * thread. The clone is kept alive until the barrier job of
+             * its own stroke reports that its queue is empty, so that
+             * the destructor of the clone doesn't block either.
+             */
+            worker.image->requestStrokeCancellation();
+
+            KisImageSP clone = worker.image;
+            droppedClones.append(clone);
+
+            KisStrokeId strokeId = clone->startStroke(new KisDropImageCloneStrokeStrategy());
+            clone->addJob(strokeId,
+                          new KisRunnableStrokeJobData(
+                              [this, clone = KisImageWSP(clone)] () {
+                                  QMetaObject::invokeMethod(q,
+                                      [this, clone] () {
+                                          droppedClones.removeOne(KisImageSP(clone));
+                                      }, Qt::QueuedConnection);
+                              },
+                              KisStrokeJobData::BARRIER));
+            clone->endStroke(strokeId);
+        }
+
+        cloneWorkers.clear();
+        clonesSource = nullptr;
+        clonesSourceConnections.clear();
+    }
+
+    void tryCreateClones(KisImageSP image)
+    {
+        if (!cloneWorkers.empty() && KisImageSP(clonesSource) == image) return;
+
+        dropClones();
+
+        KisImageConfig cfg(true);
+
+        // the image itself is rendered by the regenerator
+        const int numClones =
+            qMin(cfg.frameRenderingClones() - 1, calculateNumberMemoryAllowedClones(image));
+
+        if (numClones <= 0) return;
+
+        /**
+         * The populator works in the background, so it shouldn't
+         * block the GUI if the image is busy. We will try again on
+         * the next request.
+         */
+        if (!image->tryBarrierLock(true)) return;
+        KisImageSP source = image->clone(true);
+        image->unlock();
+
+        const int numThreadsPerWorker = qMax(1, cfg.maxNumberOfThreads() / (numClones + 1));
+
+        for (int i = 0; i < numClones; i++) {
+            CloneWorker worker;
+            worker.image = i > 0 ? source->clone(true) : source;
+            worker.image->setWorkingThreadsLimit(numThreadsPerWorker);
+            worker.renderer.reset(new KisAsyncAnimationCacheRenderer());
+
+            // a cancelled frame is left for the regenerator
+            QObject::connect(worker.renderer.get(), SIGNAL(sigFrameCompleted(int)), q, SLOT(slotCloneFrameReady()));
+
+            cloneWorkers.push_back(std::move(worker));
+        }
+
+        clonesSource = image;
+
+        /**
+         * Any change of the image makes the clones outdated. The
+         * connection is queued the same way as the one of the frame
+         * cache, so the frames that are still in flight are either
+         * added before the cache invalidates them or not added at all.
+         */
+        clonesSourceConnections.addConnection(image->animationInterface(), SIGNAL(sigFramesChanged(KisTimeSpan,QRect)),
+                                              q, SLOT(slotCloneSourceChanged()));
+        clonesSourceConnections.addConnection(image.data(), SIGNAL(sigImageModified()),
+                                              q, SLOT(slotCloneSourceChanged()));
+    }
+
+    RegenerationRequestResult regenerateOnClones(KisAnimationFrameCacheSP cache, const KisTimeSpan &range, const KisTimeSpan &skipRange, int currentTime)
+    {
+        KisImageSP image = cache->image();
+        tryCreateClones(image);
+
+        const int numIdleClones =
+            std::count_if(cloneWorkers.begin(), cloneWorkers.end(),
+                          [] (const CloneWorker &worker) {
+                              return !worker.renderer->isActive();
+                          });
+
+        QList<int> frames = calcDirtyFrames(cache, range, skipRange, 1 + numIdleClones, currentTime);
+
+        if (frames.isEmpty()) {
+            if (!hasActiveClones()) {
+                dropClones();
+            }
+            return RequestRejected;
+        }
+
+        RegenerationRequestResult result = regenerate(cache, frames.takeFirst());
+
+        for (CloneWorker &worker : cloneWorkers) {
+            if (frames.isEmpty()) break;
+            if (worker.renderer->isActive()) continue;
+
+            worker.frame = frames.takeFirst();
+
+            KisLockFrameGenerationLock lock(worker.image->animationInterface());
+            worker.renderer->setFrameCache(cache);
+            worker.renderer->startFrameRegeneration(worker.image, worker.frame, KisAsyncAnimationRendererBase::Cancellable, std::move(lock));
+
+            /**
+             * The completion of the clone's frame restarts the populator,
+             * even when the regenerator has got no frame this time
+             */
+            result = RequestSuccessful;
+        }
+
+        return result;
+    }
+
     RegenerationRequestResult regenerate(KisAnimationFrameCacheSP cache, int frame)
     {
         if (state == WaitingForFrame) {
@@ -348,6 +681,7 @@ KisAnimationCachePopulator::KisAnimationCachePopulator(KisPart *part)
 KisAnimationCachePopulator::~KisAnimationCachePopulator()
 {
     m_d->priorityFrames.clear();
+    m_d->dropClones();
 }
 
 bool KisAnimationCachePopulator::regenerate(KisAnimationFrameCacheSP cache, int frame)
@@ -361,6 +695,18 @@ void KisAnimationCachePopulator::requestRegenerationWithPriorityFrame(KisImageSP
     if (!KisAnimationFrameCache::cacheForImage(image)) return;
     if (!image->animationInterface()->hasAnimation()) return;
 
+    /**
+     * The playback engine requests the frames ahead of the playhead on
+     * every tick, so the repeated request should just move the frame to
+     * the top of the stack instead of piling up its duplicates.
+     */
+    m_d->priorityFrames.erase(
+        std::remove_if(m_d->priorityFrames.begin(), m_d->priorityFrames.end(),
+                       [image, frameIndex] (auto requestPair) {
+                           return requestPair.second == frameIndex &&
+                               KisImageSP(requestPair.first) == image;
+                       }), m_d->priorityFrames.end());
+
     m_d->priorityFrames.append(qMakePair(image, frameIndex));
 
     if (m_d->state == Private::NotWaitingForAnything) {
@@ -392,9 +738,28 @@ void KisAnimationCachePopulator::slotRegeneratorFrameReady()
     m_d->enterState(Private::BetweenFrames);
 }
 
+void KisAnimationCachePopulator::slotCloneFrameReady()
+{
+    if (m_d->state != Private::WaitingForFrame) {
+        m_d->enterState(Private::BetweenFrames);
+    }
+}
+
+void KisAnimationCachePopulator::slotCloneSourceChanged()
+{
+    m_d->dropClones();
+}
+
 void KisAnimationCachePopulator::slotConfigChanged()
 {
     KisConfig cfg(true);
     m_d->calculateAnimationCacheInBackground = cfg.calculateAnimationCacheInBackground();
+    m_d->speculativeFramesRadius = cfg.speculativeAnimationCacheFrames();
+    m_d->renderOnImageClones = cfg.renderAnimationCacheOnImageClones();
+
+    if (!m_d->renderOnImageClones) {
+        m_d->dropClones();
+    }
+
     QTimer::singleShot(1000, Qt::CoarseTimer, this, SLOT(slotRequestRegeneration()));
 }
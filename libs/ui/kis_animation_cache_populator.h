@@ -37,6 +37,9 @@ private Q_SLOTS:
     void slotRegeneratorFrameCancelled();
     void slotRegeneratorFrameReady();
 
+    void slotCloneFrameReady();
+    void slotCloneSourceChanged();
+
     void slotConfigChanged();
 
 private:
@@ -372,6 +372,15 @@ void KisAnimationFrameCache::framesChanged(const KisTimeSpan &range, const QRect
     }
 }
 
+void KisAnimationFrameCache::dropAllFrames()
+{
+    bool cacheChanged = m_d->invalidate(KisTimeSpan::infinite(0));
+
+    if (cacheChanged) {
+        Q_EMIT changed();
+    }
+}
+
 void KisAnimationFrameCache::slotConfigChanged()
 {
     m_d->newFrames.clear();
@@ -380,6 +389,8 @@ void KisAnimationFrameCache::slotConfigChanged()
 
     if (cfg.useOnDiskAnimationCacheSwapping()) {
         m_d->swapper.reset(new KisFrameCacheSwapper(m_d->textures->updateInfoBuilder(), cfg.swapDir()));
+    } else if (cfg.compressInMemoryAnimationCache()) {
+        m_d->swapper.reset(new KisFrameCacheSwapper(m_d->textures->updateInfoBuilder(), KisFrameDataSerializer::InMemoryStorage));
     } else {
         m_d->swapper.reset(new KisInMemoryFrameCacheSwapper());
     }
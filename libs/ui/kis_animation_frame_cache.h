@@ -65,6 +65,12 @@ public:
 
     bool framesHaveValidRoi(const KisTimeSpan &range, const QRect &regionOfInterest);
 
+    /**
+     * Drops all the cached frames, e.g. to free memory used by
+     * a document the user doesn't work with at the moment
+     */
+    void dropAllFrames();
+
 Q_SIGNALS:
     void changed();
 
@@ -27,6 +27,7 @@
 
 // kritaimage
 #include <kis_annotation.h>
+#include <kis_default_bounds.h>
 #include <kis_layer_utils.h>
 #include <kis_paint_device.h>
 #include <kis_time_span.h>
@@ -44,6 +45,193 @@
 #include "kis_store_paintdevice_writer.h"
 #include "KisDisplayConfig.h"
 
+namespace {
+
+const QString selectionMimeType = QStringLiteral("application/x-krita-selection");
+const QString qtImageMimeType = QStringLiteral("application/x-qt-image");
+
+/**
+ * Holds the copied device as a copy-on-write clone and serializes it
+ * only when the data is actually requested, i.e. when the clip is
+ * pasted into another application. Pasting inside Krita takes the
+ * device directly, without the round-trip through the store.
+ *
+ * When the application quits, the clip is serialized eagerly (see
+ * serializeForExport()), because the clipboard manager may request
+ * the data after the color space registry is gone.
+ */
+class KisSelectionClipMimeData : public QMimeData
+{
+public:
+    KisSelectionClipMimeData(KisPaintDeviceSP dev, const QPoint &topLeft, const KisTimeSpan &range,
+                             const KisDisplayConfig &displayConfig)
+        : m_device(new KisPaintDevice(*dev, KritaUtils::CopySnapshot))
+        , m_topLeft(topLeft)
+        , m_range(range)
+        , m_profile(displayConfig.profile)
+        , m_intent(displayConfig.intent)
+        , m_conversionFlags(displayConfig.conversionFlags)
+    {
+        // the clip may outlive the image it has been copied from
+        m_device->setDefaultBounds(new KisDefaultBounds());
+    }
+
+    KisPaintDeviceSP device() const {
+        return m_device;
+    }
+
+    QPoint topLeft() const {
+        return m_topLeft;
+    }
+
+    KisTimeSpan range() const {
+        return m_range;
+    }
+
+    QStringList formats() const override {
+        return {selectionMimeType, qtImageMimeType};
+    }
+
+    /**
+     * Prepares all the formats, so that retrieveData() doesn't need
+     * the device (and the registries behind its color space) anymore
+     */
+    void serializeForExport() const {
+        if (m_serializedData.isNull()) {
+            m_serializedData = serializeDevice();
+        }
+        if (m_image.isNull()) {
+            m_image = m_device->convertToQImage(m_profile, m_intent, m_conversionFlags);
+        }
+    }
+
+protected:
+#if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    QVariant retrieveData(const QString &mimetype, QVariant::Type preferredType) const override
+#else
+    QVariant retrieveData(const QString &mimetype, QMetaType preferredType) const override
+#endif
+    {
+        Q_UNUSED(preferredType);
+
+        /**
+         * The data has not been prepared on quit, and the color
+         * spaces of the device might already be destroyed
+         */
+        const bool canAccessDevice =
+            QCoreApplication::instance() && !QCoreApplication::closingDown();
+
+        if (mimetype == selectionMimeType) {
+            if (m_serializedData.isNull()) {
+                if (!canAccessDevice) return QVariant();
+                m_serializedData = serializeDevice();
+            }
+            return m_serializedData;
+        } else if (mimetype == qtImageMimeType) {
+            // We also create a QImage so we can interchange with other applications
+            if (m_image.isNull()) {
+                if (!canAccessDevice) return QVariant();
+                m_image = m_device->convertToQImage(m_profile, m_intent, m_conversionFlags);
+            }
+            return m_image;
+        }
+
+        return QVariant();
+    }
+
+private:
+    QByteArray serializeDevice() const
+    {
+        KisPaintDeviceSP dev = m_device;
+        const QPoint &topLeft = m_topLeft;
+        const KisTimeSpan &range = m_range;
+        const QByteArray mimeType = selectionMimeType.toLatin1();
+
+        // We'll create a store (ZIP format) in memory
+        QBuffer buffer;
+        QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Write, mimeType));
+        KisStorePaintDeviceWriter writer(store.data());
+        Q_ASSERT(store);
+        Q_ASSERT(!store->bad());
+
+        // Layer data
+        if (store->open("layerdata")) {
+            if (!dev->write(writer)) {
+                dev->disconnect();
+                store->close();
+                return QByteArray();
+            }
+            store->close();
+        }
+
+        // copied frame time limits
+        if (range.isValid() && store->open("timeRange")) {
+            store->write(QString("%1 %2").arg(range.start()).arg(range.end()).toLatin1());
+            store->close();
+        }
+
+        // Coordinates
+        if (store->open("topLeft")) {
+            store->write(QString("%1 %2").arg(topLeft.x()).arg(topLeft.y()).toLatin1());
+            store->close();
+        }
+        // ColorSpace id of layer data
+        if (store->open("colormodel")) {
+            QString csName = dev->colorSpace()->colorModelId().id();
+            store->write(csName.toLatin1());
+            store->close();
+        }
+        if (store->open("colordepth")) {
+            QString csName = dev->colorSpace()->colorDepthId().id();
+            store->write(csName.toLatin1());
+            store->close();
+        }
+
+        if (dev->colorSpace()->profile()) {
+            const KoColorProfile *profile = dev->colorSpace()->profile();
+            KisAnnotationSP annotation;
+
+            if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
+                annotation = new KisAnnotation("icc", profile->name(), profile->rawData());
+
+                if (annotation) {
+                    // save layer profile
+                    if (store->open("profile.icc")) {
+                        store->write(annotation->annotation());
+                        store->close();
+                    }
+                }
+            }
+        }
+
+        return buffer.buffer();
+    }
+
+private:
+    KisPaintDeviceSP m_device;
+    QPoint m_topLeft;
+    KisTimeSpan m_range;
+    const KoColorProfile *m_profile;
+    KoColorConversionTransformation::Intent m_intent;
+    KoColorConversionTransformation::ConversionFlags m_conversionFlags;
+
+    mutable QByteArray m_serializedData;
+    mutable QImage m_image;
+};
+
+void moveClipIntoImage(KisPaintDeviceSP clip, const QRect &imageBounds)
+{
+    QRect clipBounds = clip->exactBounds();
+
+    if (!imageBounds.contains(clipBounds) && !imageBounds.intersects(clipBounds)) {
+        QPoint diff = imageBounds.center() - clipBounds.center();
+        clip->setX(clip->x() + diff.x());
+        clip->setY(clip->y() + diff.y());
+    }
+}
+
+} // namespace
+
 Q_GLOBAL_STATIC(KisClipboard, s_instance)
 
 struct ClipboardImageFormat {
@@ -72,6 +260,8 @@ KisClipboard::KisClipboard()
 
     // Make sure we are notified when clipboard changes
     connect(d->clipboard, &QClipboard::dataChanged, this, &KisClipboard::clipboardDataChanged, Qt::UniqueConnection);
+
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &KisClipboard::slotAboutToQuit, Qt::UniqueConnection);
 }
 
 KisClipboard::~KisClipboard()
@@ -85,6 +275,15 @@ KisClipboard *KisClipboard::instance()
     return s_instance;
 }
 
+void KisClipboard::slotAboutToQuit()
+{
+    // the system clipboard manager fetches the data only when QApplication is destroyed
+    const QMimeData *cbData = d->clipboard->mimeData();
+    if (const KisSelectionClipMimeData *clipData = dynamic_cast<const KisSelectionClipMimeData*>(cbData)) {
+        clipData->serializeForExport();
+    }
+}
+
 void KisClipboard::setClip(KisPaintDeviceSP dev, const QPoint &topLeft, const KisTimeSpan &range)
 {
     if (!dev)
@@ -92,87 +291,13 @@ void KisClipboard::setClip(KisPaintDeviceSP dev, const QPoint &topLeft, const Ki
 
     d->hasClip = true;
 
-    // We'll create a store (ZIP format) in memory
-    QBuffer buffer;
-    const auto mimeType = QByteArrayLiteral("application/x-krita-selection");
-    QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Write, mimeType));
-    KisStorePaintDeviceWriter writer(store.data());
-    Q_ASSERT(store);
-    Q_ASSERT(!store->bad());
-
-    // Layer data
-    if (store->open("layerdata")) {
-        if (!dev->write(writer)) {
-            dev->disconnect();
-            store->close();
-            return;
-        }
-        store->close();
-    }
-
-    // copied frame time limits
-    if (range.isValid() && store->open("timeRange")) {
-        store->write(QString("%1 %2").arg(range.start()).arg(range.end()).toLatin1());
-        store->close();
-    }
-
-    // Coordinates
-    if (store->open("topLeft")) {
-        store->write(QString("%1 %2").arg(topLeft.x()).arg(topLeft.y()).toLatin1());
-        store->close();
-    }
-    // ColorSpace id of layer data
-    if (store->open("colormodel")) {
-        QString csName = dev->colorSpace()->colorModelId().id();
-        store->write(csName.toLatin1());
-        store->close();
-    }
-    if (store->open("colordepth")) {
-        QString csName = dev->colorSpace()->colorDepthId().id();
-        store->write(csName.toLatin1());
-        store->close();
-    }
-
-    if (dev->colorSpace()->profile()) {
-        const KoColorProfile *profile = dev->colorSpace()->profile();
-        KisAnnotationSP annotation;
-
-        if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
-            annotation = new KisAnnotation("icc", profile->name(), profile->rawData());
-
-            if (annotation) {
-                // save layer profile
-                if (store->open("profile.icc")) {
-                    store->write(annotation->annotation());
-                    store->close();
-                }
-            }
-        }
-    }
-
-    QMimeData *mimeData = new QMimeData;
-    Q_CHECK_PTR(mimeData);
-
-    if (mimeData) {
-        mimeData->setData(mimeType, buffer.buffer());
-    }
-
-    // We also create a QImage so we can interchange with other applications
-    QImage qimage;
     KisConfig cfg(true);
     const KisDisplayConfig displayConfig(KisPortingUtils::getScreenNumberForWidget(QApplication::activeWindow()), cfg);
 
-    qimage = dev->convertToQImage(displayConfig.profile,
-                                  displayConfig.intent,
-                                  displayConfig.conversionFlags);
-    if (!qimage.isNull() && mimeData) {
-        mimeData->setImageData(qimage);
-    }
+    QMimeData *mimeData = new KisSelectionClipMimeData(dev, topLeft, range, displayConfig);
 
-    if (mimeData) {
-        d->pushedClipboard = true;
-        d->clipboard->setMimeData(mimeData);
-    }
+    d->pushedClipboard = true;
+    d->clipboard->setMimeData(mimeData);
 }
 
 void KisClipboard::setClip(KisPaintDeviceSP dev, const QPoint &topLeft)
@@ -226,6 +351,24 @@ KisPaintDeviceSP KisClipboard::clipFromKritaSelection(const QMimeData *cbData, c
         return nullptr;
     }
 
+    if (const KisSelectionClipMimeData *clipData = dynamic_cast<const KisSelectionClipMimeData*>(cbData)) {
+        clip = new KisPaintDevice(*clipData->device(), KritaUtils::CopySnapshot);
+
+        // the same placement as of the device loaded from the store
+        clip->moveTo(QPoint());
+
+        if (!imageBounds.isEmpty()) {
+            clip->moveTo(clipData->topLeft());
+            moveClipIntoImage(clip, imageBounds);
+
+            if (clipData->range().isValid() && clipRange) {
+                *clipRange = clipData->range();
+            }
+        }
+
+        return clip;
+    }
+
     if (cbData->hasFormat(mimeType)) {
         QByteArray encodedData = cbData->data(mimeType);
         QBuffer buffer(&encodedData);
@@ -282,13 +425,7 @@ KisPaintDeviceSP KisClipboard::clipFromKritaSelection(const QMimeData *cbData, c
                     }
                 }
 
-                QRect clipBounds = clip->exactBounds();
-
-                if (!imageBounds.contains(clipBounds) && !imageBounds.intersects(clipBounds)) {
-                    QPoint diff = imageBounds.center() - clipBounds.center();
-                    clip->setX(clip->x() + diff.x());
-                    clip->setY(clip->y() + diff.y());
-                }
+                moveClipIntoImage(clip, imageBounds);
 
                 if (store->hasFile("timeRange") && clipRange) {
                     store->open("timeRange");
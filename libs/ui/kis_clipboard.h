@@ -113,6 +113,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void clipboardDataChanged();
+    void slotAboutToQuit();
 
 private:
     Q_DISABLE_COPY(KisClipboard);
@@ -195,6 +195,16 @@ void KisConfig::setUndoStackLimit(int limit) const
     m_cfg.writeEntry("undoStackLimit", limit);
 }
 
+int KisConfig::undoStackMemoryLimit(bool defaultValue) const
+{
+    return (defaultValue ? 0 : m_cfg.readEntry("undoStackMemoryLimit", 0));
+}
+
+void KisConfig::setUndoStackMemoryLimit(int limit) const
+{
+    m_cfg.writeEntry("undoStackMemoryLimit", limit);
+}
+
 bool KisConfig::useCumulativeUndoRedo(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("useCumulativeUndoRedo",false));
@@ -993,6 +1003,16 @@ int KisConfig::textureOverlapBorder() const
     return 1 << qMax(0, numMipmapLevels());
 }
 
+int KisConfig::openGLTexturePoolSize(bool defaultValue) const
+{
+    return (defaultValue ? 0 : qMax(0, m_cfg.readEntry("openGLTexturePoolSize", 0)));
+}
+
+void KisConfig::setOpenGLTexturePoolSize(int value)
+{
+    m_cfg.writeEntry("openGLTexturePoolSize", value);
+}
+
 quint32 KisConfig::getGridMainStyle(bool defaultValue) const
 {
     int v = m_cfg.readEntry("gridmainstyle", 0);
@@ -1728,6 +1748,16 @@ void KisConfig::setUseOcio(bool useOCIO) const
     m_cfg.writeEntry("Krita/Ocio/UseOcio", useOCIO);
 }
 
+bool KisConfig::bakeSoftProofingLut(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("bakeSoftProofingLut", true));
+}
+
+void KisConfig::setBakeSoftProofingLut(bool value) const
+{
+    m_cfg.writeEntry("bakeSoftProofingLut", value);
+}
+
 int KisConfig::favoritePresets(bool defaultValue) const
 {
     return (defaultValue ? 10: m_cfg.readEntry("numFavoritePresets", 10));
@@ -2097,6 +2127,36 @@ void KisConfig::setTrackTabletEventLatency(bool value)
     m_cfg.writeEntry("trackTabletEventLatency", value);
 }
 
+bool KisConfig::strokePredictionEnabled(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("strokePredictionEnabled", false));
+}
+
+void KisConfig::setStrokePredictionEnabled(bool value)
+{
+    m_cfg.writeEntry("strokePredictionEnabled", value);
+}
+
+int KisConfig::strokePredictionTime(bool defaultValue) const
+{
+    return (defaultValue ? 12 : m_cfg.readEntry("strokePredictionTime", 12));
+}
+
+void KisConfig::setStrokePredictionTime(int value)
+{
+    m_cfg.writeEntry("strokePredictionTime", value);
+}
+
+QString KisConfig::strokeRecordingDirectory(bool defaultValue) const
+{
+    return (defaultValue ? QString() : m_cfg.readEntry("strokeRecordingDirectory", QString()));
+}
+
+void KisConfig::setStrokeRecordingDirectory(const QString &value)
+{
+    m_cfg.writeEntry("strokeRecordingDirectory", value);
+}
+
 bool KisConfig::ignoreHighFunctionKeys(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("ignoreHighFunctionKeys", true));
@@ -2157,6 +2217,36 @@ void KisConfig::setCompressKra(bool compress)
     m_cfg.writeEntry("compressLayersInKra", compress);
 }
 
+bool KisConfig::compressKraTiles(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("compressTilesInKra", true));
+}
+
+void KisConfig::setCompressKraTiles(bool compress)
+{
+    m_cfg.writeEntry("compressTilesInKra", compress);
+}
+
+bool KisConfig::shareFrameTilesInKra(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("shareFrameTilesInKra", false));
+}
+
+void KisConfig::setShareFrameTilesInKra(bool value)
+{
+    m_cfg.writeEntry("shareFrameTilesInKra", value);
+}
+
+bool KisConfig::saveLodCompositeInKra(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("saveLodCompositeInKra", false));
+}
+
+void KisConfig::setSaveLodCompositeInKra(bool value)
+{
+    m_cfg.writeEntry("saveLodCompositeInKra", value);
+}
+
 bool KisConfig::trimKra(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("TrimKra", false));
@@ -2303,6 +2393,16 @@ void KisConfig::setEnableOpenGLFramerateLogging(bool value) const
     m_cfg.writeEntry("enableOpenGLFramerateLogging", value);
 }
 
+QString KisConfig::canvasLatencyLogFile(bool defaultValue) const
+{
+    return (defaultValue ? QString() : m_cfg.readEntry("canvasLatencyLogFile", QString()));
+}
+
+void KisConfig::setCanvasLatencyLogFile(const QString &fileName) const
+{
+    m_cfg.writeEntry("canvasLatencyLogFile", fileName);
+}
+
 bool KisConfig::enableBrushSpeedLogging(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("enableBrushSpeedLogging", false));
@@ -2408,6 +2508,16 @@ bool KisConfig::animationDropFrames(bool defaultValue) const
     return (defaultValue ? true : m_cfg.readEntry("animationDropFrames", true));
 }
 
+int KisConfig::playbackLookAheadFrames(bool defaultValue) const
+{
+    return (defaultValue ? 8 : qMax(0, m_cfg.readEntry("playbackLookAheadFrames", 8)));
+}
+
+void KisConfig::setPlaybackLookAheadFrames(int value)
+{
+    m_cfg.writeEntry("playbackLookAheadFrames", value);
+}
+
 int KisConfig::scrubbingUpdatesDelay(bool defaultValue) const
 {
     return (defaultValue ? 30 : m_cfg.readEntry("scrubbingUpdatesDelay", 30));
@@ -2529,6 +2639,36 @@ void KisConfig::setCalculateAnimationCacheInBackground(bool value)
     m_cfg.writeEntry("calculateAnimationCacheInBackground", value);
 }
 
+int KisConfig::speculativeAnimationCacheFrames(bool defaultValue) const
+{
+    return defaultValue ? 2 : qMax(0, m_cfg.readEntry("speculativeAnimationCacheFrames", 2));
+}
+
+void KisConfig::setSpeculativeAnimationCacheFrames(int value)
+{
+    m_cfg.writeEntry("speculativeAnimationCacheFrames", value);
+}
+
+bool KisConfig::renderAnimationCacheOnImageClones(bool defaultValue) const
+{
+    return defaultValue ? false : m_cfg.readEntry("renderAnimationCacheOnImageClones", false);
+}
+
+void KisConfig::setRenderAnimationCacheOnImageClones(bool value)
+{
+    m_cfg.writeEntry("renderAnimationCacheOnImageClones", value);
+}
+
+bool KisConfig::pipeAnimationFramesToFFmpeg(bool defaultValue) const
+{
+    return defaultValue ? false : m_cfg.readEntry("pipeAnimationFramesToFFmpeg", false);
+}
+
+void KisConfig::setPipeAnimationFramesToFFmpeg(bool value)
+{
+    m_cfg.writeEntry("pipeAnimationFramesToFFmpeg", value);
+}
+
 QColor KisConfig::defaultAssistantsColor(bool defaultValue) const
 {
     static const QColor defaultColor = QColor(176, 176, 176, 255);
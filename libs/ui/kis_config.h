@@ -63,6 +63,13 @@ public:
     int undoStackLimit(bool defaultValue = false) const;
     void setUndoStackLimit(int limit) const;
 
+    /**
+     * The budget of the undo data of a document in MiB, the oldest
+     * commands are dropped when it is exceeded. Zero means no limit.
+     */
+    int undoStackMemoryLimit(bool defaultValue = false) const;
+    void setUndoStackMemoryLimit(int limit) const;
+
     bool useCumulativeUndoRedo(bool defaultValue = false) const;
     void setCumulativeUndoRedo(bool value);
 
@@ -245,6 +252,14 @@ public:
     int openGLTextureSize(bool defaultValue = false) const;
     int textureOverlapBorder() const;
 
+    /**
+     * The max amount of video memory (in MiB) the image textures of
+     * one canvas may take, zero means no limit. When limited, only the
+     * tiles that are actually painted are kept in video memory.
+     */
+    int openGLTexturePoolSize(bool defaultValue = false) const;
+    void setOpenGLTexturePoolSize(int value);
+
     quint32 getGridMainStyle(bool defaultValue = false) const;
     void setGridMainStyle(quint32 v) const;
 
@@ -444,6 +459,13 @@ public:
     bool useOcio(bool defaultValue = false) const;
     void setUseOcio(bool useOCIO) const;
 
+    /**
+     * Bake the soft-proofing transformation of the canvas into a 3D LUT
+     * (\see KoLut3DColorConversionTransformation)
+     */
+    bool bakeSoftProofingLut(bool defaultValue = false) const;
+    void setBakeSoftProofingLut(bool value) const;
+
     int favoritePresets(bool defaultValue = false) const;
     void setFavoritePresets(const int value);
 
@@ -560,6 +582,19 @@ public:
     bool trackTabletEventLatency(bool defaultValue = false) const;
     void setTrackTabletEventLatency(bool value);
 
+    bool strokePredictionEnabled(bool defaultValue = false) const;
+    void setStrokePredictionEnabled(bool value);
+
+    int strokePredictionTime(bool defaultValue = false) const;
+    void setStrokePredictionTime(int value);
+
+    /**
+     * The directory where the freehand strokes are recorded for the
+     * brush benchmarks. Empty string disables the recording.
+     */
+    QString strokeRecordingDirectory(bool defaultValue = false) const;
+    void setStrokeRecordingDirectory(const QString &value);
+
     bool ignoreHighFunctionKeys(bool defaultValue = false) const;
     void setIgnoreHighFunctionKeys(bool value);
 
@@ -600,6 +635,32 @@ public:
     bool compressKra(bool defaultValue = false) const;
     void setCompressKra(bool compress);
 
+    /**
+     * When disabled, the tiles of the layers are stored in .kra files
+     * raw, which makes saving much faster at the cost of a bigger file
+     */
+    bool compressKraTiles(bool defaultValue = false) const;
+    void setCompressKraTiles(bool compress);
+
+    /**
+     * When enabled, a raster frame of an animated layer is stored in
+     * .kra files as the difference against a previous frame it shares
+     * tiles with (e.g. a hold frame or its slightly edited duplicate).
+     * Such frames are loaded incompletely by the older versions, so
+     * the option is disabled by default.
+     */
+    bool shareFrameTilesInKra(bool defaultValue = false) const;
+    void setShareFrameTilesInKra(bool value);
+
+    /**
+     * When enabled, a quarter-resolution copy of the composite is stored
+     * in .kra files along with the merged image. It is shown by the
+     * overview of the opened document until the real projection of the
+     * image is ready.
+     */
+    bool saveLodCompositeInKra(bool defaultValue = false) const;
+    void setSaveLodCompositeInKra(bool value);
+
     bool trimKra(bool defaultValue = false) const;
     void setTrimKra(bool trim);
 
@@ -633,6 +694,13 @@ public:
     void setEnableOpenGLFramerateLogging(bool value) const;
     bool enableOpenGLFramerateLogging(bool defaultValue = false) const;
 
+    /**
+     * The file the canvas latency histograms are saved to while
+     * the framerate logging is enabled. Empty means no file.
+     */
+    QString canvasLatencyLogFile(bool defaultValue = false) const;
+    void setCanvasLatencyLogFile(const QString &fileName) const;
+
     void setEnableBrushSpeedLogging(bool value) const;
     bool enableBrushSpeedLogging(bool defaultValue = false) const;
 
@@ -648,6 +716,16 @@ public:
     bool animationDropFrames(bool defaultValue = false) const;
     void setAnimationDropFrames(bool value);
 
+    /**
+     * The number of frames ahead of the playhead that the playback
+     * engine asks the background cache populator to render first. With
+     * frame dropping enabled, an uncached frame is skipped (the last
+     * cached one stays on the canvas) for at most that many frames
+     * instead of stalling the playback on its regeneration.
+     */
+    int playbackLookAheadFrames(bool defaultValue = false) const;
+    void setPlaybackLookAheadFrames(int value);
+
     bool autoPinLayersToTimeline(bool defaultValue = false) const;
     void setAutoPinLayersToTimeline(bool value);
 
@@ -696,6 +774,33 @@ public:
     bool calculateAnimationCacheInBackground(bool defaultValue = false) const;
     void setCalculateAnimationCacheInBackground(bool value);
 
+    /**
+     * The number of frames ahead of the current time, in the direction
+     * the playhead moved last, that the background cache populator
+     * renders before any other dirty frame. The rest of the dirty frames
+     * are rendered in the order of their distance from the current time.
+     */
+    int speculativeAnimationCacheFrames(bool defaultValue = false) const;
+    void setSpeculativeAnimationCacheFrames(int value);
+
+    /**
+     * When enabled, the background cache populator renders the dirty
+     * frames of the playback range on several clones of the image at
+     * the same time. The number of the clones is limited by
+     * KisImageConfig::frameRenderingClones() and by the available memory.
+     */
+    bool renderAnimationCacheOnImageClones(bool defaultValue = false) const;
+    void setRenderAnimationCacheOnImageClones(bool value);
+
+    /**
+     * When enabled, the rendered frames of a video export are streamed
+     * to the stdin of ffmpeg as raw pixels instead of being saved into
+     * an intermediate image sequence. It is used only when the image
+     * sequence is not kept and the format doesn't need a palette pass.
+     */
+    bool pipeAnimationFramesToFFmpeg(bool defaultValue = false) const;
+    void setPipeAnimationFramesToFFmpeg(bool value);
+
     QColor defaultAssistantsColor(bool defaultValue = false) const;
     void setDefaultAssistantsColor(const QColor &color) const;
 
@@ -16,6 +16,8 @@
 #include "kis_types.h"
 #include "commands_new/kis_node_move_command2.h"
 #include "kis_default_bounds.h"
+#include "kis_painter.h"
+#include "kis_random_accessor_ng.h"
 #include "kis_layer_properties_icons.h"
 #include <KisPart.h>
 #include <KisDocument.h>
@@ -256,6 +258,70 @@ void KisFileLayer::setScalingFilter(QString filter)
     m_scalingFilter = filter;
 }
 
+namespace {
+
+/**
+ * Compares the two devices tile by tile and returns the blocks
+ * of \p rc where their pixels differ. The devices must have the
+ * same color space.
+ */
+QVector<QRect> changedBlocks(KisPaintDeviceSP lhs, KisPaintDeviceSP rhs, const QRect &rc)
+{
+    QVector<QRect> result;
+    if (rc.isEmpty()) return result;
+
+    KisRandomConstAccessorSP lhsIt = lhs->createRandomConstAccessorNG();
+    KisRandomConstAccessorSP rhsIt = rhs->createRandomConstAccessorNG();
+
+    const int pixelSize = lhs->pixelSize();
+
+    qint32 y = rc.y();
+    qint32 rowsRemaining = rc.height();
+
+    while (rowsRemaining > 0) {
+        const qint32 rows = std::min({rowsRemaining,
+                                      lhsIt->numContiguousRows(y),
+                                      rhsIt->numContiguousRows(y)});
+
+        qint32 x = rc.x();
+        qint32 columnsRemaining = rc.width();
+
+        while (columnsRemaining > 0) {
+            const qint32 columns = std::min({columnsRemaining,
+                                             lhsIt->numContiguousColumns(x),
+                                             rhsIt->numContiguousColumns(x)});
+
+            const qint32 lhsRowStride = lhsIt->rowStride(x, y);
+            const qint32 rhsRowStride = rhsIt->rowStride(x, y);
+
+            lhsIt->moveTo(x, y);
+            rhsIt->moveTo(x, y);
+
+            const quint8 *lhsPtr = lhsIt->rawDataConst();
+            const quint8 *rhsPtr = rhsIt->rawDataConst();
+
+            for (int i = 0; i < rows; i++) {
+                if (memcmp(lhsPtr, rhsPtr, columns * pixelSize)) {
+                    result.append(QRect(x, y, columns, rows));
+                    break;
+                }
+                lhsPtr += lhsRowStride;
+                rhsPtr += rhsRowStride;
+            }
+
+            x += columns;
+            columnsRemaining -= columns;
+        }
+
+        y += rows;
+        rowsRemaining -= rows;
+    }
+
+    return result;
+}
+
+}
+
 void KisFileLayer::slotLoadingFinished(KisPaintDeviceSP projection,
                                        qreal xRes, qreal yRes,
                                        const QSize &size)
@@ -264,9 +330,12 @@ void KisFileLayer::slotLoadingFinished(KisPaintDeviceSP projection,
     qint32 oldY = y();
     const QRect oldLayerExtent = m_paintDevice->extent();
 
-
-    m_paintDevice->makeCloneFrom(projection, projection->extent());
-    m_paintDevice->setDefaultBounds(new KisDefaultBounds(image()));
+    /**
+     * The loader passes us its own copy of the loaded image, so we can
+     * prepare it in place and replace only the parts of the layer that
+     * have actually changed in the linked file.
+     */
+    projection->setDefaultBounds(new KisDefaultBounds(image()));
 
     /**
      * This method can be transitively called from KisFileLayer::setImage(),
@@ -287,7 +356,7 @@ void KisFileLayer::slotLoadingFinished(KisPaintDeviceSP projection,
             qreal xscale = image->xRes() / xRes;
             qreal yscale = image->yRes() / yRes;
 
-            KisTransformWorker worker(m_paintDevice, xscale, yscale, 0.0, 0, 0, 0, 0, 0, KisFilterStrategyRegistry::instance()->get(m_scalingFilter));
+            KisTransformWorker worker(projection, xscale, yscale, 0.0, 0, 0, 0, 0, 0, KisFilterStrategyRegistry::instance()->get(m_scalingFilter));
             worker.run();
         }
         else if (m_scalingMethod == ToImageSize && size != image->size()) {
@@ -296,7 +365,7 @@ void KisFileLayer::slotLoadingFinished(KisPaintDeviceSP projection,
             qreal xscale =  (qreal)sz.width() / (qreal)size.width();
             qreal yscale = (qreal)sz.height() / (qreal)size.height();
 
-            KisTransformWorker worker(m_paintDevice, xscale, yscale, 0.0, 0, 0, 0, 0, 0, KisFilterStrategyRegistry::instance()->get(m_scalingFilter));
+            KisTransformWorker worker(projection, xscale, yscale, 0.0, 0, 0, 0, 0, 0, KisFilterStrategyRegistry::instance()->get(m_scalingFilter));
             worker.run();
         }
 
@@ -305,11 +374,33 @@ void KisFileLayer::slotLoadingFinished(KisPaintDeviceSP projection,
         m_generatedForYRes = image->yRes();
     }
 
-    m_paintDevice->setX(oldX);
-    m_paintDevice->setY(oldY);
+    projection->setX(oldX);
+    projection->setY(oldY);
 
-    changeState(FileLoaded);
-    setDirty(m_paintDevice->extent() | oldLayerExtent);
+    const bool canUpdateIncrementally =
+        *m_paintDevice->colorSpace() == *projection->colorSpace() &&
+        m_paintDevice->defaultPixel() == projection->defaultPixel();
+
+    if (canUpdateIncrementally) {
+        const QVector<QRect> changedRects =
+            changedBlocks(m_paintDevice, projection, projection->extent() | oldLayerExtent);
+
+        Q_FOREACH (const QRect &rc, changedRects) {
+            KisPainter::copyAreaOptimized(rc.topLeft(), projection, m_paintDevice, rc);
+        }
+
+        changeState(FileLoaded);
+
+        if (!changedRects.isEmpty()) {
+            setDirty(changedRects);
+        }
+    } else {
+        m_paintDevice->makeCloneFrom(projection, projection->extent());
+        m_paintDevice->setDefaultBounds(new KisDefaultBounds(image));
+
+        changeState(FileLoaded);
+        setDirty(m_paintDevice->extent() | oldLayerExtent);
+    }
 }
 
 void KisFileLayer::slotLoadingFailed()
@@ -113,6 +113,12 @@ QString KisFpsDecoration::getText() const
                 .arg(monitor->lastStrokeSaturated() ? " (!)" : "");
         lines << QString("Last brush framerate: %1 fps")
                 .arg(monitor->lastFps(), 0, 'f', 1);
+        lines << QString("Last stroke jobs: %1, avg. job time: %2 ms")
+                .arg(monitor->lastPaintJobs())
+                .arg(monitor->lastAvgPaintJobTime(), 0, 'f', 2);
+        lines << QString("Last stroke max backlog: %1 jobs, updates: %2")
+                .arg(monitor->lastMaxQueueBacklog())
+                .arg(monitor->lastUpdates());
 
         lines << QString("Average cursor/brush speed (px/ms): %1/%2")
                 .arg(monitor->avgCursorSpeed(), 0, 'f', 1)
@@ -11,6 +11,9 @@
 #include <QMimeData>
 #include <QBuffer>
 #include <QPointer>
+#include <QHash>
+
+#include <algorithm>
 
 #include <KoColorSpaceConstants.h>
 #include <KoCompositeOpRegistry.h>
@@ -63,7 +66,8 @@ struct KisNodeModel::Private
 
     KisSignalAutoConnectionsStore nodeDisplayModeAdapterConnections;
 
-    QList<KisNodeDummy*> updateQueue;
+    QSet<KisNodeDummy*> updateQueue;
+    QSet<KisNodeDummy*> thumbnailUpdateQueue;
     KisSignalCompressor updateCompressor;
 
     KisModelIndexConverterBase *indexConverter = 0;
@@ -228,10 +232,14 @@ void KisNodeModel::progressPercentageChanged(int, const KisNodeSP node)
 
 void KisNodeModel::slotLayerThumbnailUpdated(KisNodeSP node)
 {
-    QModelIndex index = indexFromNode(node);
-    if (!index.isValid()) return;
+    if (!m_d->dummiesFacade || !m_d->dummiesFacade->hasDummyForNode(node)) return;
 
-    Q_EMIT dataChanged(index, index);
+    /**
+     * The thumbnails of all the changed layers arrive one-by-one after
+     * every change of the image, so they are passed to the view in batches
+     */
+    m_d->thumbnailUpdateQueue.insert(m_d->dummiesFacade->dummyForNode(node));
+    m_d->updateCompressor.start();
 }
 
 KisModelIndexConverterBase * KisNodeModel::indexConverter() const
@@ -282,6 +290,11 @@ void KisNodeModel::setDummiesFacade(KisDummiesFacadeBase *dummiesFacade,
     QPointer<KisDummiesFacadeBase> oldDummiesFacade(m_d->dummiesFacade);
     KisShapeController  *oldShapeController = m_d->shapeController;
 
+    // the queued dummies belong to the old facade
+    m_d->updateCompressor.stop();
+    m_d->updateQueue.clear();
+    m_d->thumbnailUpdateQueue.clear();
+
     m_d->shapeController = shapeController;
     m_d->nodeManager = nodeManager;
     m_d->nodeSelectionAdapter = nodeManager ? nodeManager->nodeSelectionAdapter() : nullptr;
@@ -380,9 +393,9 @@ void KisNodeModel::slotBeginRemoveDummy(KisNodeDummy *dummy)
 {
     if (!dummy) return;
 
-    // FIXME: is it really what we want?
+    // the queued dummies are still valid, so deliver their updates before the removal
     m_d->updateCompressor.stop();
-    m_d->updateQueue.clear();
+    processUpdateQueue();
 
     m_d->parentOfRemovedNode = dummy->parent();
 
@@ -413,9 +426,7 @@ void KisNodeModel::slotEndRemoveDummy()
 
 void KisNodeModel::slotDummyChanged(KisNodeDummy *dummy)
 {
-    if (!m_d->updateQueue.contains(dummy)) {
-        m_d->updateQueue.append(dummy);
-    }
+    m_d->updateQueue.insert(dummy);
     m_d->updateCompressor.start();
 }
 
@@ -434,6 +445,8 @@ void addChangedIndex(const QModelIndex &idx, QSet<QModelIndex> *indexes)
 
 void KisNodeModel::processUpdateQueue()
 {
+    if (m_d->updateQueue.isEmpty() && m_d->thumbnailUpdateQueue.isEmpty()) return;
+
     QSet<QModelIndex> indexes;
 
     Q_FOREACH (KisNodeDummy *dummy, m_d->updateQueue) {
@@ -441,11 +454,41 @@ void KisNodeModel::processUpdateQueue()
         addChangedIndex(index, &indexes);
     }
 
-    Q_FOREACH (const QModelIndex &index, indexes) {
-        Q_EMIT dataChanged(index.siblingAtColumn(0), index.siblingAtColumn(m_d->dummyColumns));
+    Q_FOREACH (KisNodeDummy *dummy, m_d->thumbnailUpdateQueue) {
+        QModelIndex index = m_d->indexConverter->indexFromDummy(dummy);
+        if (index.isValid()) {
+            indexes.insert(index);
+        }
     }
 
     m_d->updateQueue.clear();
+    m_d->thumbnailUpdateQueue.clear();
+
+    /**
+     * Every dataChanged() signal makes the view recalculate the
+     * geometry of the changed rows, so the rows are reported in
+     * contiguous ranges of siblings instead of one-by-one.
+     */
+    QHash<QModelIndex, QVector<int>> rowsByParent;
+
+    Q_FOREACH (const QModelIndex &index, indexes) {
+        rowsByParent[index.parent()].append(index.row());
+    }
+
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        for (int i = 0; i < rows.size();) {
+            int last = i;
+            while (last + 1 < rows.size() && rows[last + 1] == rows[last] + 1) {
+                last++;
+            }
+
+            Q_EMIT dataChanged(index(rows[i], 0, it.key()), index(rows[last], m_d->dummyColumns, it.key()));
+            i = last + 1;
+        }
+    }
 }
 
 QModelIndex KisNodeModel::index(int row, int col, const QModelIndex &parent) const
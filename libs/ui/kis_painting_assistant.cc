@@ -318,6 +318,12 @@ bool KisPaintingAssistant::canBeLocal() const
     return false;
 }
 
+bool KisPaintingAssistant::canSnapStrokeFrom(const QPointF &strokeBegin) const
+{
+    Q_UNUSED(strokeBegin);
+    return true;
+}
+
 bool KisPaintingAssistant::isLocal() const
 {
     return d->s->isLocal;
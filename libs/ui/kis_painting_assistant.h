@@ -114,6 +114,16 @@ public:
      */
     virtual QPointF adjustPosition(const QPointF& point, const QPointF& strokeBegin, bool snapToAny, qreal moveThresholdPt) = 0;
     virtual void adjustLine(QPointF& point, QPointF& strokeBegin) = 0;
+
+    /**
+     * @return false if the assistant is known to never snap a stroke
+     *         started at \p strokeBegin, whatever the further points of
+     *         the stroke are. KisPaintingAssistantsDecoration uses it to
+     *         skip the irrelevant assistants for the whole stroke. The
+     *         default implementation returns true.
+     */
+    virtual bool canSnapStrokeFrom(const QPointF &strokeBegin) const;
+
     virtual void endStroke();
     virtual void setAdjustedBrushPosition(const QPointF position);
     virtual void setFollowBrushPosition(bool follow);
@@ -47,6 +47,17 @@ struct KisPaintingAssistantsDecoration::Private {
     bool useCache;
     KisPaintingAssistantSP firstAssistant;
     KisPaintingAssistantSP selectedAssistant;
+
+    /**
+     * The assistants that can snap the current stroke, see
+     * KisPaintingAssistant::canSnapStrokeFrom(). They are selected
+     * once per stroke, so that the cost of snapping does not grow
+     * with the number of the assistants that are out of the game.
+     */
+    QList<KisPaintingAssistantSP> strokeCandidates;
+    QList<KisPaintingAssistantSP> strokeCandidatesSource;
+    QPointF strokeCandidatesBegin;
+    bool strokeCandidatesValid = false;
     bool m_isEditingAssistants = false;
     int m_handleSize; // size of editor handles on assistants
 
@@ -192,7 +203,24 @@ QPointF KisPaintingAssistantsDecoration::adjustPosition(const QPointF& point, co
         int numSuitableAssistants = 0;
         KisPaintingAssistantSP bestAssistant;
 
-        Q_FOREACH (KisPaintingAssistantSP assistant, assistants()) {
+        const QList<KisPaintingAssistantSP> allAssistants = assistants();
+
+        if (!d->strokeCandidatesValid ||
+            d->strokeCandidatesBegin != strokeBegin ||
+            d->strokeCandidatesSource != allAssistants) {
+
+            d->strokeCandidates.clear();
+            Q_FOREACH (KisPaintingAssistantSP assistant, allAssistants) {
+                if (assistant->canSnapStrokeFrom(strokeBegin)) {
+                    d->strokeCandidates.append(assistant);
+                }
+            }
+            d->strokeCandidatesSource = allAssistants;
+            d->strokeCandidatesBegin = strokeBegin;
+            d->strokeCandidatesValid = true;
+        }
+
+        Q_FOREACH (KisPaintingAssistantSP assistant, d->strokeCandidates) {
             if (assistant->isSnappingActive() == true){ // the toggle button with eye icon to disable assistants
                 QPointF newpoint = assistant->adjustPosition(point, strokeBegin, true, moveThresholdPt);
                 // Assistants that can't or don't want to snap return NaN values (aside from possible numeric issues)
@@ -296,6 +324,9 @@ void KisPaintingAssistantsDecoration::adjustLine(QPointF &point, QPointF &stroke
 void KisPaintingAssistantsDecoration::endStroke()
 {
     d->firstAssistant.clear();
+    d->strokeCandidates.clear();
+    d->strokeCandidatesSource.clear();
+    d->strokeCandidatesValid = false;
 
     Q_FOREACH (KisPaintingAssistantSP assistant, assistants()) {
         assistant->endStroke();
@@ -280,14 +280,34 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.projectionsSize),
                   format.formatByteSize(stats.lodSize));
 
+    QString nodeStatsMsg;
+    const int maxReportedNodes = 5;
+
+    for (int i = 0; i < qMin(maxReportedNodes, stats.nodes.size()); i++) {
+        const KisMemoryStatisticsServer::NodeStatistics &nodeStats = stats.nodes[i];
+
+        nodeStatsMsg +=
+            i18nc("tooltip on statusbar memory reporting button (per-layer stats)",
+                  "  %1:\t %2 (projection: %3, instant preview: %4)\n",
+                  nodeStats.name,
+                  format.formatByteSize(nodeStats.totalSize()),
+                  format.formatByteSize(nodeStats.projectionSize),
+                  format.formatByteSize(nodeStats.lodSize));
+    }
+
+    if (!nodeStatsMsg.isEmpty()) {
+        nodeStatsMsg =
+            i18nc("tooltip on statusbar memory reporting button (per-layer stats)",
+                  "Largest layers:\n") + nodeStatsMsg;
+    }
+
     const QString memoryStatsMsg =
             i18nc("tooltip on statusbar memory reporting button (total stats)",
                   "Memory used:\t %1 / %2\n"
                   "  image data:\t %3 / %4\n"
                   "  pool:\t\t %5 / %6\n"
                   "  undo data:\t %7\n"
-                  "\n"
-                  "Swap used:\t %8",
+                  "  frame cache:\t %8",
                   format.formatByteSize(stats.totalMemorySize),
                   format.formatByteSize(stats.totalMemoryLimit),
 
@@ -298,9 +318,20 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.tilesPoolLimit),
 
                   format.formatByteSize(stats.historicalMemorySize),
-                  format.formatByteSize(stats.swapSize));
-
-    QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
+                  format.formatByteSize(stats.frameCacheSize));
+
+    const QString swapStatsMsg =
+            i18nc("tooltip on statusbar memory reporting button (swap stats)",
+                  "Swap used:\t %1\n"
+                  "  compressed in RAM:\t %2",
+                  format.formatByteSize(stats.swapSize),
+                  format.formatByteSize(stats.compressedPoolSize));
+
+    QString longStats = imageStatsMsg + "\n";
+    if (!nodeStatsMsg.isEmpty()) {
+        longStats += nodeStatsMsg + "\n";
+    }
+    longStats += memoryStatsMsg + "\n\n" + swapStatsMsg;
 
     QString shortStats = format.formatByteSize(stats.imageSize);
     QIcon icon;
@@ -7,12 +7,14 @@
 #define KIS_STORE_PAINTDEVICE_WRITER_H
 
 #include <kis_paint_device_writer.h>
+#include "tiles3/KisTileSavingCache.h"
 #include <KoStore.h>
 
 class KisStorePaintDeviceWriter : public KisPaintDeviceWriter {
 public:
-    KisStorePaintDeviceWriter(KoStore *store)
+    KisStorePaintDeviceWriter(KoStore *store, KisTileSavingCacheSP tileSavingCache = KisTileSavingCacheSP())
         : m_store(store)
+        , m_tileSavingCache(tileSavingCache)
     {
     }
 
@@ -28,7 +30,25 @@ public:
         return (length == len);
     }
 
+    KisTileSavingCache* tileSavingCache() const override {
+        return m_tileSavingCache.data();
+    }
+
+    void setTileSavingCache(KisTileSavingCacheSP cache) {
+        m_tileSavingCache = cache;
+    }
+
+    bool tileCompressionEnabled() const override {
+        return m_tileCompressionEnabled;
+    }
+
+    void setTileCompressionEnabled(bool value) {
+        m_tileCompressionEnabled = value;
+    }
+
     KoStore *m_store;
+    KisTileSavingCacheSP m_tileSavingCache;
+    bool m_tileCompressionEnabled = true;
 
 };
 
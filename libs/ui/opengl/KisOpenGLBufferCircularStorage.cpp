@@ -8,14 +8,45 @@
 
 #include <QtMath>
 
+#include <cstring>
+#include <memory>
+
 #include "kis_assert.h"
 #include "kis_opengl.h"
+#include "KisOpenGLSync.h"
 
 KisOpenGLBufferCircularStorage::BufferBinder::BufferBinder(KisOpenGLBufferCircularStorage *bufferStorage, const void **dataPtr, int dataSize) {
     if (bufferStorage) {
+        m_bufferStorage = bufferStorage;
+
+        /**
+         * An idle buffer can be written without any implicit sync
+         * in the driver. The busy one is orphaned instead: the driver
+         * gives us fresh storage and keeps the old one alive until
+         * the pending glTexSubImage2D() is done with it.
+         */
+        const bool bufferIsIdle = KisOpenGL::supportsFenceSync() && bufferStorage->nextBufferIsIdle();
+
         m_buffer = bufferStorage->getNextBuffer();
         m_buffer->bind();
-        m_buffer->write(0, *dataPtr, dataSize);
+
+        void *mappedData = nullptr;
+
+        if (KisOpenGL::supportsBufferMapping()) {
+            const QOpenGLBuffer::RangeAccessFlags flags =
+                QOpenGLBuffer::RangeWrite |
+                (bufferIsIdle ? QOpenGLBuffer::RangeUnsynchronized : QOpenGLBuffer::RangeInvalidateBuffer);
+
+            mappedData = m_buffer->mapRange(0, dataSize, flags);
+        }
+
+        if (mappedData) {
+            memcpy(mappedData, *dataPtr, static_cast<size_t>(dataSize));
+            m_buffer->unmap();
+        } else {
+            m_buffer->write(0, *dataPtr, dataSize);
+        }
+
         *dataPtr = nullptr;
     }
 
@@ -28,12 +59,15 @@ KisOpenGLBufferCircularStorage::BufferBinder::~BufferBinder() {
         if (KisOpenGL::useTextureBufferInvalidation()) {
             KisOpenGL::glInvalidateBufferData(m_buffer->bufferId());
         }
+
+        m_bufferStorage->fenceBuffer(m_buffer);
     }
 }
 
 struct Q_DECL_HIDDEN KisOpenGLBufferCircularStorage::Private
 {
     std::vector<QOpenGLBuffer> buffers;
+    std::vector<std::unique_ptr<KisOpenGLSync>> fences;
     decltype(buffers)::size_type nextBuffer = 0;
     int bufferSize = 0;
     QOpenGLBuffer::Type type = QOpenGLBuffer::QOpenGLBuffer::VertexBuffer;
@@ -70,6 +104,31 @@ QOpenGLBuffer *KisOpenGLBufferCircularStorage::getNextBuffer()
     return buffer;
 }
 
+bool KisOpenGLBufferCircularStorage::nextBufferIsIdle() const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(isValid(), true);
+
+    std::unique_ptr<KisOpenGLSync> &fence = m_d->fences[m_d->nextBuffer];
+
+    if (fence && fence->isSignaled()) {
+        fence.reset();
+    }
+
+    return !fence;
+}
+
+void KisOpenGLBufferCircularStorage::fenceBuffer(QOpenGLBuffer *buffer)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(isValid());
+
+    const auto index = static_cast<decltype(m_d->buffers)::size_type>(buffer - m_d->buffers.data());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(index < m_d->buffers.size());
+
+    if (KisOpenGL::supportsFenceSync()) {
+        m_d->fences[index].reset(new KisOpenGLSync());
+    }
+}
+
 bool KisOpenGLBufferCircularStorage::isValid() const
 {
     return !m_d->buffers.empty();
@@ -82,6 +141,7 @@ int KisOpenGLBufferCircularStorage::size() const
 
 void KisOpenGLBufferCircularStorage::reset()
 {
+    m_d->fences.clear();
     m_d->buffers.clear();
     m_d->nextBuffer = 0;
     m_d->bufferSize = 0;
@@ -108,6 +168,9 @@ void KisOpenGLBufferCircularStorage::allocateMoreBuffers()
     auto end = m_d->buffers.end();
 
     std::rotate(begin, middle, end);
+    std::rotate(m_d->fences.begin(),
+                std::next(m_d->fences.begin(), std::distance(begin, middle)),
+                m_d->fences.end());
 
     m_d->nextBuffer = m_d->buffers.size();
 
@@ -130,6 +193,7 @@ void KisOpenGLBufferCircularStorage::addBuffersImpl(size_t buffersToAdd, int buf
 
     for (size_t i = 0; i < buffersToAdd; i++) {
         m_d->buffers.emplace_back(m_d->type);
+        m_d->fences.emplace_back();
 
         QOpenGLBuffer &buf = m_d->buffers.back();
 
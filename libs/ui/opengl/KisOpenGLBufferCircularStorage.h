@@ -14,6 +14,13 @@
  * A simple storage class that owns a fixed amount of
  * QOpenGLBuffer objects and returns them sequentially.
  * Using multiple distinct buffers lets us avoid blocks
+ *
+ * The buffers that are filled via BufferBinder are fenced
+ * after the upload, so the next time the ring comes to the
+ * same buffer we know whether the GPU has finished reading
+ * from it. Idle buffers are mapped without any driver-side
+ * synchronization, busy ones are orphaned on mapping, so the
+ * GUI thread never waits for the GPU in either case.
  */
 class KisOpenGLBufferCircularStorage
 {
@@ -40,6 +47,7 @@ public:
         BufferBinder &operator=(BufferBinder &&) = delete;
 
     private:
+        KisOpenGLBufferCircularStorage *m_bufferStorage = nullptr;
         QOpenGLBuffer *m_buffer = nullptr;
     };
 
@@ -54,6 +62,21 @@ public:
 
     void allocate(int numBuffers, int bufferSize);
     QOpenGLBuffer* getNextBuffer();
+
+    /**
+     * @return true if the buffer that will be returned by
+     * getNextBuffer() is not used by any pending GPU command
+     * anymore. When the driver doesn't support fence sync,
+     * all the buffers are reported as idle.
+     */
+    bool nextBufferIsIdle() const;
+
+    /**
+     * Puts a fence after the GPU commands that read from
+     * \p buffer, which should be the one most recently
+     * returned by getNextBuffer()
+     */
+    void fenceBuffer(QOpenGLBuffer *buffer);
     bool isValid() const;
     int size() const;
 
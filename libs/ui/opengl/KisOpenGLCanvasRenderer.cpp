@@ -58,6 +58,117 @@
 // so we can keep the number really low
 static constexpr int NumberOfBuffers = 2;
 
+namespace {
+
+/**
+ * Converts the polygons of the tool outline into vertices. Every
+ * polygon gets its own range of \p vertices: a line strip for
+ * the thin outlines, or a list of triangles for the thick ones.
+ */
+void tessellateToolOutline(const QVector<QPolygonF> &polygons,
+                           int thickness, qreal devicePixelRatio,
+                           QVector<QVector3D> *vertices,
+                           QVector<QPair<int, int>> *ranges)
+{
+    vertices->clear();
+    ranges->clear();
+
+    if (thickness > 1) {
+        // Because glLineWidth is not supported on all versions of OpenGL (or rather,
+        // is limited to 1, as returned by GL_ALIASED_LINE_WIDTH_RANGE),
+        // we'll instead generate mitered-triangles.
+
+        const qreal halfWidth = (thickness * 0.5) / devicePixelRatio;
+        const qreal miterLimit = (5 * thickness) / devicePixelRatio;
+
+        for (const QPolygonF &polygon : polygons) {
+            if (KisAlgebra2D::maxDimension(polygon.boundingRect()) < 0.5 * thickness) {
+                continue;
+            }
+
+            const int firstVertex = vertices->size();
+            const bool closed = polygon.isClosed();
+
+            for( int i = 1; i < polygon.count(); i++) {
+                bool adjustFirst = closed? true: i > 1;
+                bool adjustSecond = closed? true: i + 1 < polygon.count();
+
+                QPointF p1 = polygon.at(i - 1);
+                QPointF p2 = polygon.at(i);
+                QPointF normal = p2 - p1;
+                normal = KisAlgebra2D::normalize(QPointF(-normal.y(), normal.x()));
+
+                QPointF c1 = p1 - (normal * halfWidth);
+                QPointF c2 = p1 + (normal * halfWidth);
+                QPointF c3 = p2 - (normal * halfWidth);
+                QPointF c4 = p2 + (normal * halfWidth);
+
+                // Add miter
+                if (adjustFirst) {
+                    QPointF pPrev = i >= 2 ?
+                        QPointF(polygon.at(i-2)) :
+                        QPointF(polygon.at(qMax(polygon.count() - 2, 0)));
+
+                    pPrev = p1 - pPrev;
+
+                    QPointF miter =
+                        KisAlgebra2D::normalize(normal +
+                                                KisAlgebra2D::normalize(
+                                                    QPointF(-pPrev.y(), pPrev.x())));
+
+                    const qreal dot = KisAlgebra2D::dotProduct(miter, normal);
+
+                    if (KisAlgebra2D::norm((miter * halfWidth) / dot) < miterLimit) {
+                        c1 = p1 + ((miter * -halfWidth) / dot);
+                        c2 = p1 + ((miter * halfWidth) / dot);
+                    }
+                }
+
+                if (adjustSecond) {
+                    QPointF pNext = i + 1 < polygon.count()? QPointF(polygon.at(i+1))
+                                                             : QPointF(polygon.at(qMin(polygon.count(), 1)));
+                    pNext = pNext - p2;
+                    QPointF miter =
+                        KisAlgebra2D::normalize(
+                            normal + KisAlgebra2D::normalize(QPointF(-pNext.y(), pNext.x())));
+                    const qreal dot = KisAlgebra2D::dotProduct(miter, normal);
+
+                    if (KisAlgebra2D::norm((miter * halfWidth) / dot) < miterLimit) {
+                        c3 = p2 + ((miter * -halfWidth) / dot);
+                        c4 = p2 + (miter * halfWidth) / dot;
+                    }
+                }
+
+                vertices->append(QVector3D(c1));
+                vertices->append(QVector3D(c3));
+                vertices->append(QVector3D(c2));
+                vertices->append(QVector3D(c4));
+                vertices->append(QVector3D(c2));
+                vertices->append(QVector3D(c3));
+            }
+
+            ranges->append(qMakePair(firstVertex, vertices->size() - firstVertex));
+        }
+    } else {
+        // Convert every disjointed subpath to a line strip
+        for (const QPolygonF &polygon : polygons) {
+            if (KisAlgebra2D::maxDimension(polygon.boundingRect()) < 0.5) {
+                continue;
+            }
+
+            const int firstVertex = vertices->size();
+
+            for (const QPointF &point : polygon) {
+                vertices->append(QVector3D(point.x(), point.y(), 0));
+            }
+
+            ranges->append(qMakePair(firstVertex, polygon.count()));
+        }
+    }
+}
+
+}
+
 struct KisOpenGLCanvasRenderer::Private
 {
 public:
@@ -102,6 +213,15 @@ public:
     QOpenGLVertexArrayObject outlineVAO;
     QOpenGLBuffer lineVertexBuffer;
 
+    // Stores the tessellated tool outline between the frames
+    QOpenGLVertexArrayObject toolOutlineVAO;
+    QOpenGLBuffer toolOutlineVertexBuffer;
+    QVector<QPolygonF> toolOutlinePolygons;
+    QVector<QVector3D> toolOutlineVertices;
+    QVector<QPair<int, int>> toolOutlineRanges;
+    int toolOutlineThickness {-1};
+    qreal toolOutlineDevicePixelRatio {0.0};
+
     QVector3D vertices[6];
     QVector2D texCoords[6];
 
@@ -276,6 +396,19 @@ void KisOpenGLCanvasRenderer::initializeGL()
         d->lineVertexBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
         d->lineVertexBuffer.bind();
         glVertexAttribPointer(PROGRAM_VERTEX_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+        // The tool outline is re-uploaded only when the outline changes
+        d->toolOutlineVAO.create();
+        d->toolOutlineVAO.bind();
+
+        glEnableVertexAttribArray(PROGRAM_VERTEX_ATTRIBUTE);
+
+        d->toolOutlineVertexBuffer.create();
+        d->toolOutlineVertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+        d->toolOutlineVertexBuffer.bind();
+        glVertexAttribPointer(PROGRAM_VERTEX_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+        d->toolOutlinePolygons.clear();
     }
 
     d->canvasInitialized = true;
@@ -429,141 +562,52 @@ void KisOpenGLCanvasRenderer::paintToolOutline(const KisOptimizedBrushOutline &p
         glEnable(GL_SCISSOR_TEST);
     }
 
-    // Paint the tool outline
-    if (KisOpenGL::supportsVAO()) {
-        d->outlineVAO.bind();
-        d->lineVertexBuffer.bind();
+    QVector<QPolygonF> polygons;
+    for (auto it = path.begin(); it != path.end(); ++it) {
+        polygons.append(*it);
     }
 
-    QVector<QVector3D> verticesBuffer;
-
-    if (thickness > 1) {
-        // Because glLineWidth is not supported on all versions of OpenGL (or rather,
-        // is limited to 1, as returned by GL_ALIASED_LINE_WIDTH_RANGE),
-        // we'll instead generate mitered-triangles.
-
-        const qreal halfWidth = (thickness * 0.5) / devicePixelRatioF();
-        const qreal miterLimit = (5 * thickness) / devicePixelRatioF();
-
-        for (auto it = path.begin(); it != path.end(); ++it) {
-            const QPolygonF& polygon = *it;
-
-            if (KisAlgebra2D::maxDimension(polygon.boundingRect()) < 0.5 * thickness) {
-                continue;
-            }
-
-            int triangleCount = 0;
-            verticesBuffer.clear();
-            const bool closed = polygon.isClosed();
-
-            for( int i = 1; i < polygon.count(); i++) {
-                bool adjustFirst = closed? true: i > 1;
-                bool adjustSecond = closed? true: i + 1 < polygon.count();
-
-                QPointF p1 = polygon.at(i - 1);
-                QPointF p2 = polygon.at(i);
-                QPointF normal = p2 - p1;
-                normal = KisAlgebra2D::normalize(QPointF(-normal.y(), normal.x()));
-
-                QPointF c1 = p1 - (normal * halfWidth);
-                QPointF c2 = p1 + (normal * halfWidth);
-                QPointF c3 = p2 - (normal * halfWidth);
-                QPointF c4 = p2 + (normal * halfWidth);
-
-                // Add miter
-                if (adjustFirst) {
-                    QPointF pPrev = i >= 2 ?
-                        QPointF(polygon.at(i-2)) :
-                        QPointF(polygon.at(qMax(polygon.count() - 2, 0)));
-
-                    pPrev = p1 - pPrev;
-
-                    QPointF miter =
-                        KisAlgebra2D::normalize(normal +
-                                                KisAlgebra2D::normalize(
-                                                    QPointF(-pPrev.y(), pPrev.x())));
-
-                    const qreal dot = KisAlgebra2D::dotProduct(miter, normal);
-
-                    if (KisAlgebra2D::norm((miter * halfWidth) / dot) < miterLimit) {
-                        c1 = p1 + ((miter * -halfWidth) / dot);
-                        c2 = p1 + ((miter * halfWidth) / dot);
-                    }
-                }
-
-                if (adjustSecond) {
-                    QPointF pNext = i + 1 < polygon.count()? QPointF(polygon.at(i+1))
-                                                             : QPointF(polygon.at(qMin(polygon.count(), 1)));
-                    pNext = pNext - p2;
-                    QPointF miter =
-                        KisAlgebra2D::normalize(
-                            normal + KisAlgebra2D::normalize(QPointF(-pNext.y(), pNext.x())));
-                    const qreal dot = KisAlgebra2D::dotProduct(miter, normal);
-
-                    if (KisAlgebra2D::norm((miter * halfWidth) / dot) < miterLimit) {
-                        c3 = p2 + ((miter * -halfWidth) / dot);
-                        c4 = p2 + (miter * halfWidth) / dot;
-                    }
-                }
-
-                verticesBuffer.append(QVector3D(c1));
-                verticesBuffer.append(QVector3D(c3));
-                verticesBuffer.append(QVector3D(c2));
-                verticesBuffer.append(QVector3D(c4));
-                verticesBuffer.append(QVector3D(c2));
-                verticesBuffer.append(QVector3D(c3));
-                triangleCount += 2;
-            }
-
-            if (KisOpenGL::supportsVAO()) {
-                d->lineVertexBuffer.bind();
-                d->lineVertexBuffer.allocate(verticesBuffer.constData(), 3 * verticesBuffer.size() * sizeof(float));
-            }
-            else {
-                d->solidColorShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
-                d->solidColorShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, verticesBuffer.constData());
-            }
-
-            glDrawArrays(GL_TRIANGLES, 0, triangleCount * 3);
+    /**
+     * The outline is painted in flake coordinates, so panning, zooming
+     * and rotating the canvas doesn't change its geometry. Tessellate
+     * and upload it only when the outline itself changes.
+     */
+    if (polygons != d->toolOutlinePolygons ||
+        thickness != d->toolOutlineThickness ||
+        !qFuzzyCompare(devicePixelRatioF(), d->toolOutlineDevicePixelRatio)) {
+
+        d->toolOutlinePolygons = polygons;
+        d->toolOutlineThickness = thickness;
+        d->toolOutlineDevicePixelRatio = devicePixelRatioF();
+
+        tessellateToolOutline(polygons, thickness, devicePixelRatioF(),
+                              &d->toolOutlineVertices, &d->toolOutlineRanges);
+
+        if (KisOpenGL::supportsVAO()) {
+            d->toolOutlineVertexBuffer.bind();
+            d->toolOutlineVertexBuffer.allocate(d->toolOutlineVertices.constData(),
+                                                3 * d->toolOutlineVertices.size() * sizeof(float));
         }
-    } else {
-        // Convert every disjointed subpath to a polygon and draw that polygon
-        for (auto it = path.begin(); it != path.end(); ++it) {
-            const QPolygonF& polygon = *it;
-
-            if (KisAlgebra2D::maxDimension(polygon.boundingRect()) < 0.5) {
-                continue;
-            }
-
-            const int verticesCount = polygon.count();
-
-            if (verticesBuffer.size() < verticesCount) {
-                verticesBuffer.resize(verticesCount);
-            }
-
-            for (int vertIndex = 0; vertIndex < verticesCount; vertIndex++) {
-                QPointF point = polygon.at(vertIndex);
-                verticesBuffer[vertIndex].setX(point.x());
-                verticesBuffer[vertIndex].setY(point.y());
-            }
-            if (KisOpenGL::supportsVAO()) {
-                d->lineVertexBuffer.bind();
-                d->lineVertexBuffer.allocate(verticesBuffer.constData(), 3 * verticesCount * sizeof(float));
-            }
-            else {
-                d->solidColorShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
-                d->solidColorShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, verticesBuffer.constData());
-            }
+    }
 
+    // Paint the tool outline
+    if (KisOpenGL::supportsVAO()) {
+        d->toolOutlineVAO.bind();
+        d->toolOutlineVertexBuffer.bind();
+    } else {
+        d->solidColorShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
+        d->solidColorShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, d->toolOutlineVertices.constData());
+    }
 
+    const GLenum mode = thickness > 1 ? GL_TRIANGLES : GL_LINE_STRIP;
 
-            glDrawArrays(GL_LINE_STRIP, 0, verticesCount);
-        }
+    for (const QPair<int, int> &range : qAsConst(d->toolOutlineRanges)) {
+        glDrawArrays(mode, range.first, range.second);
     }
 
     if (KisOpenGL::supportsVAO()) {
-        d->lineVertexBuffer.release();
-        d->outlineVAO.release();
+        d->toolOutlineVertexBuffer.release();
+        d->toolOutlineVAO.release();
     }
 
     if (!viewportUpdateRect.isEmpty()) {
@@ -824,6 +868,8 @@ void KisOpenGLCanvasRenderer::drawImage(const QRect &updateRect)
     QRect ir = d->openGLImageTextures->storedImageBounds();
     QRect wr = widgetRectInImagePixels.toAlignedRect();
 
+    d->openGLImageTextures->startFrame();
+
     if (!d->wrapAroundMode) {
         // if we don't want to paint wrapping images, just limit the
         // processing area, and the code will handle all the rest
@@ -875,6 +921,8 @@ void KisOpenGLCanvasRenderer::drawImage(const QRect &updateRect)
         }
     }
 
+    d->openGLImageTextures->finishFrame();
+
     d->displayShader->release();
 
     glDisable(GL_BLEND);
@@ -913,7 +961,7 @@ void KisOpenGLCanvasRenderer::drawImageTiles(int firstCol, int lastCol, int firs
         for (int row = firstRow; row <= lastRow; row++) {
 
             KisTextureTile *tile =
-                    d->openGLImageTextures->getTextureTileCR(col, row);
+                    d->openGLImageTextures->useTextureTileCR(col, row);
 
             if (!tile) {
                 warnUI << "OpenGL: Trying to paint texture tile but it has not been created yet.";
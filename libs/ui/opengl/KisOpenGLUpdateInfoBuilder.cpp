@@ -10,10 +10,16 @@
 #include "opengl/kis_texture_tile_info_pool.h"
 
 #include "KisProofingConfiguration.h"
+#include "kis_config.h"
+
+#include <KoLut3DColorConversionTransformation.h>
+
+#include <algorithm>
 
 #include <QReadWriteLock>
 #include <QReadLocker>
 #include <QWriteLocker>
+#include <QtConcurrent>
 
 
 struct KRITAUI_NO_EXPORT KisOpenGLUpdateInfoBuilder::Private
@@ -26,6 +32,7 @@ struct KRITAUI_NO_EXPORT KisOpenGLUpdateInfoBuilder::Private
 
     int textureBorder = 0;
     QSize effectiveTextureSize;
+    int numMipmapLevels = 0;
 
     KisProofingConfigurationSP proofingConfig;
     QScopedPointer<KoColorConversionTransformation> proofingTransform;
@@ -77,16 +84,34 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
             KoColorConversionTransformation::Intent displayIntent = m_d->proofingConfig->determineDisplayIntent(m_d->conversionOptions.m_renderingIntent);
             KoColorConversionTransformation::ConversionFlags displayFlags =  m_d->proofingConfig->determineDisplayFlags(m_d->conversionOptions.m_conversionFlags);
 
-            m_d->proofingTransform.reset(KisTextureTileUpdateInfo::generateProofingTransform(
-                                             projection->colorSpace(),
-                                             m_d->conversionOptions.m_destinationColorSpace,
-                                             proofingSpace,
-                                             m_d->proofingConfig->conversionIntent,
-                                             displayIntent,
-                                             m_d->proofingConfig->useBlackPointCompensationFirstTransform,
-                                             m_d->proofingConfig->warningColor,
-                                             m_d->proofingConfig->determineAdaptationState(),
-                                             displayFlags));
+            KoColorConversionTransformation *transform =
+                KisTextureTileUpdateInfo::generateProofingTransform(
+                    projection->colorSpace(),
+                    m_d->conversionOptions.m_destinationColorSpace,
+                    proofingSpace,
+                    m_d->proofingConfig->conversionIntent,
+                    displayIntent,
+                    m_d->proofingConfig->useBlackPointCompensationFirstTransform,
+                    m_d->proofingConfig->warningColor,
+                    m_d->proofingConfig->determineAdaptationState(),
+                    displayFlags);
+
+            /**
+             * The proofing transformation goes through four profiles and
+             * LCMS cannot precalculate it for floating point images, so
+             * we bake it ourselves. The LUT lives as long as the proofing
+             * configuration and the display profile stay the same.
+             *
+             * The gamut warning is a hard edge the lattice would blur into
+             * tinted blends, so the warning is always computed exactly.
+             */
+            if (KisConfig(true).bakeSoftProofingLut() &&
+                !displayFlags.testFlag(KoColorConversionTransformation::GamutCheck)) {
+
+                transform = KoLut3DColorConversionTransformation::tryBake(transform);
+            }
+
+            m_d->proofingTransform.reset(transform);
         }
     }
 
@@ -142,16 +167,6 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                                                      m_d->pool));
             // Don't update empty tiles
             if (tileInfo->valid()) {
-                tileInfo->retrieveData(projection, channelFlags, m_d->onlyOneChannelSelected, m_d->selectedChannelIndex);
-
-                if (convertColorSpace) {
-                    if (m_d->proofingTransform) {
-                        tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->displayFlags, m_d->proofingTransform.data());
-                    } else {
-                        tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags);
-                    }
-                }
-
                 info->tileList.append(tileInfo);
             }
             else {
@@ -160,6 +175,37 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
         }
     }
 
+    const bool showSingleChannelAsColor = KisConfig(true).showSingleChannelAsColor();
+
+    auto prepareTile = [&] (KisTextureTileUpdateInfoSP &tileInfo) {
+        tileInfo->alignPatchToMipmapLevels(m_d->numMipmapLevels);
+        tileInfo->retrieveData(projection, channelFlags, m_d->onlyOneChannelSelected, m_d->selectedChannelIndex, showSingleChannelAsColor);
+
+        if (convertColorSpace) {
+            if (m_d->proofingTransform) {
+                tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->displayFlags, m_d->proofingTransform.data());
+            } else {
+                tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags);
+            }
+        }
+
+        tileInfo->generateMipmapLevels();
+    };
+
+    /**
+     * Big updates (canvas resize, filters, strokes on 4K+ images)
+     * touch dozens of tiles and the pixels of every tile are read
+     * and converted independently, so let the pool convert them
+     * in parallel. The proofing transform is already shared between
+     * the threads that request updates, so there is no new sharing
+     * introduced here.
+     */
+    if (info->tileList.size() > 1) {
+        QtConcurrent::blockingMap(info->tileList, prepareTile);
+    } else {
+        std::for_each(info->tileList.begin(), info->tileList.end(), prepareTile);
+    }
+
     info->assignDirtyImageRect(rect);
     info->assignLevelOfDetail(levelOfDetail);
     return info;
@@ -236,6 +282,13 @@ void KisOpenGLUpdateInfoBuilder::setEffectiveTextureSize(const QSize &size)
     m_d->effectiveTextureSize = size;
 }
 
+void KisOpenGLUpdateInfoBuilder::setNumMipmapLevels(int value)
+{
+    QWriteLocker lock(&m_d->lock);
+
+    m_d->numMipmapLevels = value;
+}
+
 void KisOpenGLUpdateInfoBuilder::setTextureInfoPool(KisTextureTileInfoPoolSP pool)
 {
     QWriteLocker lock(&m_d->lock);
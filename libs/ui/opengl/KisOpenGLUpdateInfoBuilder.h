@@ -54,6 +54,13 @@ public:
     void setTextureBorder(int value);
     void setEffectiveTextureSize(const QSize &size);
 
+    /**
+     * Sets the number of mipmap levels the partial updates of the
+     * tiles should prepare on the CPU. Zero means the tiles regenerate
+     * their mipmaps on the GPU.
+     */
+    void setNumMipmapLevels(int value);
+
     void setTextureInfoPool(KisTextureTileInfoPoolSP pool);
     KisTextureTileInfoPoolSP textureInfoPool() const;
 
@@ -93,6 +93,9 @@ KisOpenGLCanvas2::KisOpenGLCanvas2(KisCanvas2 *canvas,
             SIGNAL(sigShowFloatingMessage(QString, int, bool)),
             SLOT(slotShowFloatingMessage(QString, int, bool)));
 
+    connect(this, SIGNAL(frameSwapped()),
+            KisOpenglCanvasDebugger::instance(), SLOT(notifyFrameSwapped()));
+
     setAcceptDrops(true);
     setAutoFillBackground(false);
 
@@ -258,6 +261,8 @@ void KisOpenGLCanvas2::paintGL()
     // rendering, which a QtQuick2-based canvas will need.
     d->glSyncObject.reset(new KisOpenGLSync());
 
+    canvas()->notifyFramePresented();
+
     if (!OPENGL_SUCCESS) {
         KisConfig cfg(false);
         cfg.writeEntry("canvasState", "OPENGL_SUCCESS");
@@ -6,14 +6,89 @@
 
 #include "kis_opengl_canvas_debugger.h"
 
+#include <array>
+#include <atomic>
+
 #include <QGlobalStatic>
 
 #include <QElapsedTimer>
 #include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QVector>
+#include <QtMath>
 
 #include "kis_config.h"
 #include <kis_config_notifier.h>
 
+namespace {
+
+/**
+ * Durations in 1 ms bins, the last bin collects all the longer ones
+ */
+struct LatencyHistogram
+{
+    static const int numBins = 101;
+
+    void add(qint64 msec) {
+        bins[qBound(0, int(msec), numBins - 1)]++;
+        count++;
+    }
+
+    int percentile(qreal portion) const {
+        const int threshold = qCeil(portion * count);
+
+        int accumulated = 0;
+        for (int i = 0; i < numBins; i++) {
+            accumulated += bins[i];
+            if (accumulated >= threshold) return i;
+        }
+        return numBins - 1;
+    }
+
+    void reset() {
+        bins.fill(0);
+        count = 0;
+    }
+
+    std::array<int, numBins> bins {};
+    int count = 0;
+};
+
+struct InputRecord
+{
+    qint64 inputTime = 0;
+    qint64 builtTime = 0;
+    qint64 uploadedTime = 0;
+};
+
+/**
+ * The inputs that have not produced any update for this long were
+ * not painting anything (e.g. a stroke of a tool that doesn't update
+ * the image), they must not be attributed to the next update
+ */
+const qint64 maxInputAge = 500;
+
+/**
+ * The pauses between the frames longer than that are idle time,
+ * not the frame pacing
+ */
+const qint64 maxFrameInterval = 250;
+
+const int framesPerReport = 500;
+
+qint64 currentTimestamp()
+{
+    // same clock as the one used for the timestamps of the tablet events
+    QElapsedTimer elapsed;
+    elapsed.start();
+    return elapsed.msecsSinceReference();
+}
+
+}
+
 struct KisOpenglCanvasDebugger::Private
 {
 
@@ -32,7 +107,37 @@ struct KisOpenglCanvasDebugger::Private
     int syncFlaggedCounter;
     int syncFlaggedSum;
 
-    bool isEnabled;
+    std::atomic<bool> isEnabled;
+
+    mutable QMutex latencyMutex;
+    QVector<qint64> pendingInputs;
+    QVector<InputRecord> builtInputs;
+    QVector<InputRecord> uploadedInputs;
+
+    LatencyHistogram inputToUpdate;
+    LatencyHistogram updateToUpload;
+    LatencyHistogram uploadToSwap;
+    LatencyHistogram inputToSwap;
+    LatencyHistogram frameInterval;
+
+    qint64 lastSwapTime = -1;
+    int framesSinceReport = 0;
+    QString latencyLogFile;
+
+    void resetLatency() {
+        pendingInputs.clear();
+        builtInputs.clear();
+        uploadedInputs.clear();
+
+        inputToUpdate.reset();
+        updateToUpload.reset();
+        uploadToSwap.reset();
+        inputToSwap.reset();
+        frameInterval.reset();
+
+        lastSwapTime = -1;
+        framesSinceReport = 0;
+    }
 };
 
 Q_GLOBAL_STATIC(KisOpenglCanvasDebugger, s_instance)
@@ -73,11 +178,19 @@ qreal KisOpenglCanvasDebugger::accumulatedFps()
 void KisOpenglCanvasDebugger::slotConfigChanged()
 {
     KisConfig cfg(true);
+    const bool wasEnabled = m_d->isEnabled;
     m_d->isEnabled = cfg.enableOpenGLFramerateLogging();
 
     if (m_d->isEnabled) {
         m_d->time.start();
     }
+
+    QMutexLocker l(&m_d->latencyMutex);
+    m_d->latencyLogFile = cfg.canvasLatencyLogFile();
+
+    if (m_d->isEnabled && !wasEnabled) {
+        m_d->resetLatency();
+    }
 }
 
 void KisOpenglCanvasDebugger::notifyPaintRequested()
@@ -107,3 +220,125 @@ void KisOpenglCanvasDebugger::notifySyncStatus(bool isBusy)
         m_d->syncFlaggedCounter = 0;
     }
 }
+
+void KisOpenglCanvasDebugger::notifyInputEvent(qint64 eventTimestamp)
+{
+    if (!m_d->isEnabled) return;
+
+    const qint64 now = currentTimestamp();
+    const qint64 inputTime =
+        eventTimestamp > 0 && eventTimestamp <= now && now - eventTimestamp < maxInputAge ?
+            eventTimestamp : now;
+
+    QMutexLocker l(&m_d->latencyMutex);
+    m_d->pendingInputs.append(inputTime);
+}
+
+void KisOpenglCanvasDebugger::notifyCanvasUpdateBuilt()
+{
+    if (!m_d->isEnabled) return;
+
+    const qint64 now = currentTimestamp();
+
+    QMutexLocker l(&m_d->latencyMutex);
+
+    Q_FOREACH (qint64 inputTime, m_d->pendingInputs) {
+        if (now - inputTime > maxInputAge) continue;
+
+        InputRecord record;
+        record.inputTime = inputTime;
+        record.builtTime = now;
+        m_d->builtInputs.append(record);
+    }
+
+    m_d->pendingInputs.clear();
+}
+
+void KisOpenglCanvasDebugger::notifyCanvasUpdateUploaded()
+{
+    if (!m_d->isEnabled) return;
+
+    const qint64 now = currentTimestamp();
+
+    QMutexLocker l(&m_d->latencyMutex);
+
+    for (auto it = m_d->builtInputs.begin(); it != m_d->builtInputs.end(); ++it) {
+        it->uploadedTime = now;
+        m_d->uploadedInputs.append(*it);
+    }
+
+    m_d->builtInputs.clear();
+}
+
+void KisOpenglCanvasDebugger::notifyFrameSwapped()
+{
+    if (!m_d->isEnabled) return;
+
+    const qint64 now = currentTimestamp();
+
+    QMutexLocker l(&m_d->latencyMutex);
+
+    if (m_d->lastSwapTime >= 0 && now - m_d->lastSwapTime < maxFrameInterval) {
+        m_d->frameInterval.add(now - m_d->lastSwapTime);
+    }
+    m_d->lastSwapTime = now;
+
+    Q_FOREACH (const InputRecord &record, m_d->uploadedInputs) {
+        m_d->inputToUpdate.add(record.builtTime - record.inputTime);
+        m_d->updateToUpload.add(record.uploadedTime - record.builtTime);
+        m_d->uploadToSwap.add(now - record.uploadedTime);
+        m_d->inputToSwap.add(now - record.inputTime);
+    }
+    m_d->uploadedInputs.clear();
+
+    if (++m_d->framesSinceReport < framesPerReport || !m_d->inputToSwap.count) return;
+    m_d->framesSinceReport = 0;
+
+    auto percentiles = [] (const LatencyHistogram &histogram) {
+        return QString("p50 %1 p90 %2 p99 %3")
+            .arg(histogram.percentile(0.5))
+            .arg(histogram.percentile(0.9))
+            .arg(histogram.percentile(0.99));
+    };
+
+    qDebug() << "Canvas latency (ms), input to update:" << qUtf8Printable(percentiles(m_d->inputToUpdate));
+    qDebug() << "    update to upload:" << qUtf8Printable(percentiles(m_d->updateToUpload));
+    qDebug() << "    upload to swap:" << qUtf8Printable(percentiles(m_d->uploadToSwap));
+    qDebug() << "    input to swap:" << qUtf8Printable(percentiles(m_d->inputToSwap));
+    qDebug() << "    frame interval:" << qUtf8Printable(percentiles(m_d->frameInterval));
+
+    const QString fileName = m_d->latencyLogFile;
+
+    if (!fileName.isEmpty()) {
+        l.unlock();
+
+        if (!saveLatencyHistograms(fileName)) {
+            qWarning() << "Failed to save canvas latency histograms to" << fileName;
+        }
+    }
+}
+
+bool KisOpenglCanvasDebugger::saveLatencyHistograms(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    QMutexLocker l(&m_d->latencyMutex);
+
+    stream << "msec,input_to_update,update_to_upload,upload_to_swap,input_to_swap,frame_interval\n";
+
+    for (int i = 0; i < LatencyHistogram::numBins; i++) {
+        stream << i << ","
+               << m_d->inputToUpdate.bins[i] << ","
+               << m_d->updateToUpload.bins[i] << ","
+               << m_d->uploadToSwap.bins[i] << ","
+               << m_d->inputToSwap.bins[i] << ","
+               << m_d->frameInterval.bins[i] << "\n";
+    }
+
+    return stream.status() == QTextStream::Ok;
+}
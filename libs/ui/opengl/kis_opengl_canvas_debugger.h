@@ -9,8 +9,29 @@
 
 #include <QScopedPointer>
 #include <QObject>
+#include <QString>
 
 
+/**
+ * Collects the framerate of the canvas and, while the framerate logging
+ * is enabled, the latency of the painting pipeline. The latency is
+ * split into the stages:
+ *
+ * - input to update: from the tablet or mouse event to the projection
+ *   update being converted for the canvas (includes the stroke jobs
+ *   and the merge of the layers)
+ *
+ * - update to upload: the time the update spends in the canvas updates
+ *   compressor before being uploaded into the textures
+ *
+ * - upload to swap: painting of the frame and the buffer swap
+ *
+ * The input events are attributed to the first update built after
+ * them, so the numbers are an approximation, good enough for comparing
+ * the changes of the pipeline. The histograms are printed into the
+ * debug output every few hundred frames and saved into
+ * KisConfig::canvasLatencyLogFile().
+ */
 class KisOpenglCanvasDebugger : public QObject
 {
     Q_OBJECT
@@ -26,6 +47,30 @@ public:
     void notifySyncStatus(bool value);
     qreal accumulatedFps();
 
+    /**
+     * Registers a painting input event. \p eventTimestamp is the
+     * timestamp of the Qt event, the arrival time is used instead
+     * if it doesn't look like a QElapsedTimer reference time.
+     */
+    void notifyInputEvent(qint64 eventTimestamp);
+
+    /**
+     * Called when a projection update has been converted for the canvas.
+     * May be called from any thread.
+     */
+    void notifyCanvasUpdateBuilt();
+
+    void notifyCanvasUpdateUploaded();
+
+    /**
+     * Saves the latency histograms as CSV, one column per stage
+     * and one row per millisecond
+     */
+    bool saveLatencyHistograms(const QString &fileName) const;
+
+public Q_SLOTS:
+    void notifyFrameSwapped();
+
 private Q_SLOTS:
     void slotConfigChanged();
 
@@ -24,11 +24,12 @@
 #include <KoColorModelStandardIds.h>
 
 #include "kis_image.h"
+#include "kis_lod_transform.h"
+#include "kis_spontaneous_job.h"
 #include "kis_config.h"
 #include "KisPart.h"
 #include "KisOpenGLModeProber.h"
 #include "kis_fixed_paint_device.h"
-#include "KisOpenGLSync.h"
 #include <QVector3D>
 #include "kis_painting_tweaks.h"
 #include "KisOpenGLBufferCreationGuard.h"
@@ -66,6 +67,60 @@
 
 //#define DEBUG_BUFFER_REALLOCATION
 
+namespace {
+
+/**
+ * Asks the canvases of the image to refetch the texture tiles that
+ * have just become resident. The tiles get their data through the
+ * usual asynchronous canvas update path: the update info is built in
+ * the image thread and uploaded in the next canvas frame.
+ */
+class KisRefetchTextureTilesJob : public KisSpontaneousJob
+{
+public:
+    KisRefetchTextureTilesJob(KisImageSP image, const QVector<QRect> &rects)
+        : m_image(image),
+          m_rects(rects),
+          m_levelOfDetail(image->currentLevelOfDetail())
+    {
+    }
+
+    bool overrides(const KisSpontaneousJob *otherJob) override {
+        Q_UNUSED(otherJob);
+        return false;
+    }
+
+    void run() override {
+        KisImageSP image = m_image;
+        if (!image) return;
+
+        // the image expects the rects in the coordinates of the current LoD plane
+        Q_FOREACH (const QRect &rc, m_rects) {
+            image->notifyProjectionUpdated(
+                KisLodTransform::scaledRect(KisLodTransform::alignedRect(rc, m_levelOfDetail),
+                                            m_levelOfDetail));
+        }
+    }
+
+    int levelOfDetail() const override {
+        return m_levelOfDetail;
+    }
+
+    QString debugName() const override {
+        QString result;
+        QDebug dbg(&result);
+        dbg << "KisRefetchTextureTilesJob" << ppVar(m_rects.size());
+        return result;
+    }
+
+private:
+    KisImageWSP m_image;
+    QVector<QRect> m_rects;
+    int m_levelOfDetail;
+};
+
+}
+
 
 KisOpenGLImageTextures::ImageTexturesMap KisOpenGLImageTextures::imageTexturesMap;
 
@@ -123,8 +178,11 @@ void KisOpenGLImageTextures::initGL(QOpenGLFunctions *f)
     m_glFuncs->glGenTextures(1, &(*m_checkerTexture));
     recreateImageTextureTiles();
 
-    KisOpenGLUpdateInfoSP info = updateCache(m_image->bounds(), m_image);
-    recalculateCache(info, false);
+    // the paged tiles fetch their data when they are painted for the first time
+    if (!m_maxResidentTiles) {
+        KisOpenGLUpdateInfoSP info = updateCache(m_image->bounds(), m_image);
+        recalculateCache(info, false);
+    }
 }
 
 KisOpenGLImageTextures::~KisOpenGLImageTextures()
@@ -235,6 +293,27 @@ void KisOpenGLImageTextures::recreateImageTextureTiles()
 
     initBufferStorage(KisOpenGL::shouldUseTextureBuffers(config.useOpenGLTextureBuffer()));
 
+    m_tilesUseMipmaps =
+        mode == KisOpenGL::TrilinearFilterMode ||
+        mode == KisOpenGL::HighQualityFiltering;
+    m_updateInfoBuilder.setNumMipmapLevels(m_tilesUseMipmaps ? config.numMipmapLevels() : 0);
+
+    const int numTiles = (lastRow + 1) * m_numCols;
+    const qint64 poolSize = qint64(config.openGLTexturePoolSize()) * 1024 * 1024;
+
+    // the mipmap takes one third of the base level
+    const qint64 tileTextureSize = qint64(emptyTileData.size()) * 4 / 3;
+
+    m_maxResidentTiles =
+        poolSize > 0 && poolSize / tileTextureSize < numTiles ?
+            qMax(1, int(poolSize / tileTextureSize)) : 0;
+
+    if (m_maxResidentTiles) {
+        m_emptyTileData = emptyTileData;
+        m_tileResidency.resize(numTiles);
+        dbgUI << "OpenGL: paging" << numTiles << "texture tiles through a pool of" << m_maxResidentTiles;
+    }
+
     QOpenGLContext *ctx = QOpenGLContext::currentContext();
     if (ctx) {
         QOpenGLFunctions *f = ctx->functions();
@@ -256,7 +335,7 @@ void KisOpenGLImageTextures::recreateImageTextureTiles()
 
                 KisTextureTile *tile = new KisTextureTile(tileRect,
                                                           &m_texturesInfo,
-                                                          emptyTileData,
+                                                          m_maxResidentTiles ? QByteArray() : emptyTileData,
                                                           mode,
                                                           m_bufferStorage.isValid() ? &m_bufferStorage : 0,
                                                           config.numMipmapLevels(),
@@ -308,6 +387,11 @@ void KisOpenGLImageTextures::destroyImageTextureTiles()
         delete tile;
     }
     m_textureTiles.clear();
+    m_residentTiles.clear();
+    m_tileResidency.clear();
+    m_emptyTileData.clear();
+    m_tilesPendingRefetch.clear();
+    m_maxResidentTiles = 0;
     m_tileVertexBuffer.destroy();
     m_tileTexCoordBuffer.destroy();
     m_storedImageBounds = QRect();
@@ -340,19 +424,25 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
     KisOpenGLUpdateInfoSP glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
     if(!glInfo) return;
 
-    QScopedPointer<KisOpenGLSync> sync;
-    int numProcessedTiles = 0;
-
     KisTextureTileUpdateInfoSP tileInfo;
     Q_FOREACH (tileInfo, glInfo->tileList) {
         KisTextureTile *tile = getTextureTileCR(tileInfo->tileCol(), tileInfo->tileRow());
         KIS_ASSERT_RECOVER_RETURN(tile);
 
-        if (m_bufferStorage.isValid() && numProcessedTiles > m_bufferStorage.size() &&
-            sync && !sync->isSignaled()) {
+        // an evicted tile will be fully refetched when it is painted again
+        if (!tile->isResident()) continue;
+
+        /**
+         * If the GPU hasn't finished reading from the buffer we used
+         * a whole ring ago, the ring is too short for the current
+         * upload rate. The busy buffer would just be orphaned, but
+         * the orphaned storage is reallocated by the driver every
+         * time, so we'd better have more buffers.
+         */
+        if (m_bufferStorage.isValid() && !m_bufferStorage.nextBufferIsIdle()) {
 
 #ifdef DEBUG_BUFFER_REALLOCATION
-            qDebug() << "Still unsignalled after processed" << numProcessedTiles << "tiles";
+            qDebug() << "Next buffer is still busy";
 #endif
 
             m_bufferStorage.allocateMoreBuffers();
@@ -362,19 +452,78 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
 #endif
         }
 
-
         tile->update(*tileInfo, blockMipmapRegeneration);
+    }
+}
 
-        if (m_bufferStorage.isValid()) {
-            if (!sync) {
-                sync.reset(new KisOpenGLSync());
-                numProcessedTiles = 0;
-            } else if (sync && sync->isSignaled()) {
-                sync.reset();
-            }
-            numProcessedTiles++;
-        }
+void KisOpenGLImageTextures::startFrame()
+{
+    m_currentFrame++;
+}
+
+void KisOpenGLImageTextures::finishFrame()
+{
+    if (m_tilesPendingRefetch.isEmpty()) return;
+
+    KisImageSP image = m_image;
+    if (image) {
+        image->addSpontaneousJob(new KisRefetchTextureTilesJob(image, m_tilesPendingRefetch));
+    }
+
+    m_tilesPendingRefetch.clear();
+}
+
+KisTextureTile *KisOpenGLImageTextures::useTextureTileCR(int col, int row)
+{
+    KisTextureTile *tile = getTextureTileCR(col, row);
+    if (!tile || !m_maxResidentTiles) return tile;
+
+    const int tileIndex = getTextureBufferIndexCR(col, row);
+
+    if (tile->isResident()) {
+        m_residentTiles.splice(m_residentTiles.begin(), m_residentTiles,
+                               m_tileResidency[tileIndex].lruPosition);
+    } else {
+        makeTileResident(tileIndex);
     }
+
+    m_tileResidency[tileIndex].lastUsedFrame = m_currentFrame;
+
+    return tile;
+}
+
+void KisOpenGLImageTextures::makeTileResident(int tileIndex)
+{
+    /**
+     * The tiles painted in the current frame are not evicted even when
+     * the pool is full (e.g. the whole huge image is zoomed out), the
+     * pool just gets overcommitted until the next frame.
+     */
+    while (int(m_residentTiles.size()) >= m_maxResidentTiles &&
+           m_tileResidency[m_residentTiles.back()].lastUsedFrame != m_currentFrame) {
+
+        m_textureTiles[m_residentTiles.back()]->evict();
+        m_residentTiles.pop_back();
+    }
+
+    // the tiles are updated via the currently active texture unit
+    m_glFuncs->glActiveTexture(GL_TEXTURE0);
+
+    KisTextureTile *tile = m_textureTiles[tileIndex];
+    tile->makeResident(m_emptyTileData);
+
+    m_residentTiles.push_front(tileIndex);
+    m_tileResidency[tileIndex].lruPosition = m_residentTiles.begin();
+
+    /**
+     * Converting the tile's pixels right here would stall the frame, so
+     * the tile is painted transparent (i.e. the checkers show through)
+     * until its data arrives via the asynchronous update path. The
+     * texture rect includes the border, so the tile gets all its pixels
+     * at once. The resident neighbours get their borders updated with
+     * the same data they already have, which is harmless.
+     */
+    m_tilesPendingRefetch.append(tile->textureRectInImagePixels());
 }
 
 void KisOpenGLImageTextures::generateCheckerTexture(const QImage &checkImage)
@@ -458,6 +607,8 @@ void KisOpenGLImageTextures::updateConfig(bool useBuffer, int NumMipmapLevels)
         tile->setBufferStorage(effectiveUseBuffer ? &m_bufferStorage : 0);
         tile->setNumMipmapLevels(NumMipmapLevels);
     }
+
+    m_updateInfoBuilder.setNumMipmapLevels(m_tilesUseMipmaps ? NumMipmapLevels : 0);
 }
 
 void KisOpenGLImageTextures::testingForceInitialized()
@@ -721,7 +872,26 @@ void KisOpenGLImageTextures::updateTextureFormat()
             initializeRGBA16FTextures(ctx, m_texturesInfo, destinationColorDepthId);
         }
         else if (colorDepthId == Float32BitsColorDepthID) {
-            if (KisOpenGL::hasOpenGLES() || KisOpenGL::hasOpenGL3()) {
+            /**
+             * When the tiles have to be converted into the monitor profile
+             * anyway, the conversion can write half floats directly. It
+             * costs the same as the float-to-float conversion, but halves
+             * the upload bandwidth and the VRAM taken by the textures,
+             * and half float still keeps all the HDR values the display
+             * can show.
+             *
+             * The conversion into the monitor profile itself still runs
+             * on the CPU, in KisOpenGLUpdateInfoBuilder. Only the OCIO
+             * path transforms the colors in the display shader.
+             */
+            const bool tilesAreConvertedAnyway =
+                m_internalColorManagementActive &&
+                m_monitorProfile &&
+                !(*m_monitorProfile == *m_image->colorSpace()->profile());
+
+            if (tilesAreConvertedAnyway) {
+                initializeRGBA16FTextures(ctx, m_texturesInfo, destinationColorDepthId);
+            } else if (KisOpenGL::hasOpenGLES() || KisOpenGL::hasOpenGL3()) {
 #ifndef QT_OPENGL_ES_2
                 m_texturesInfo.internalFormat = GL_RGBA32F;
                 dbgUI << "Using float (GLES or GL3)";
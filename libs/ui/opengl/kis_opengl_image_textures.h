@@ -6,6 +6,8 @@
 #ifndef KIS_OPENGL_IMAGE_TEXTURES_H_
 #define KIS_OPENGL_IMAGE_TEXTURES_H_
 
+#include <list>
+
 #include <QVector>
 #include <QMap>
 #include <QOpenGLFunctions>
@@ -139,6 +141,25 @@ public:
         return -1;
     }
 
+    /**
+     * Marks the beginning of a new canvas frame. The tiles painted
+     * during the current frame are never evicted from the texture pool.
+     */
+    void startFrame();
+
+    /**
+     * Marks the end of the canvas frame. The tiles that became resident
+     * during the frame are refetched from the image asynchronously.
+     */
+    void finishFrame();
+
+    /**
+     * \return the tile at (\p col, \p row) ready to be painted. When the
+     * texture pool is limited, the tile is made resident, possibly
+     * evicting the tiles that have not been painted for the longest time.
+     */
+    KisTextureTile* useTextureTileCR(int col, int row);
+
     QOpenGLBuffer* tileVertexBuffer() {
         return &m_tileVertexBuffer;
     }
@@ -186,6 +207,8 @@ private:
     void updateTextureFormat();
     KisOpenGLUpdateInfoSP updateCacheImpl(const QRect& rect, KisImageSP srcImage, bool convertColorSpace);
 
+    void makeTileResident(int tileIndex);
+
 private:
     KisImageWSP m_image;
     QRect m_storedImageBounds;
@@ -212,8 +235,27 @@ private:
     QOpenGLBuffer m_tileVertexBuffer;
     QOpenGLBuffer m_tileTexCoordBuffer;
 
+    struct TileResidency {
+        std::list<int>::iterator lruPosition;
+        quint64 lastUsedFrame {0};
+    };
+
+    /**
+     * When the textures of the whole image don't fit into the texture
+     * pool (KisConfig::openGLTexturePoolSize()), only the painted tiles
+     * are kept resident, and m_maxResidentTiles is non-zero
+     */
+    int m_maxResidentTiles {0};
+    std::list<int> m_residentTiles; // most recently used come first
+    QVector<TileResidency> m_tileResidency;
+    quint64 m_currentFrame {0};
+    QByteArray m_emptyTileData;
+    QVector<QRect> m_tilesPendingRefetch;
+
     QOpenGLFunctions *m_glFuncs {nullptr};
 
+    // the tiles were created with a filter that samples their mipmaps
+    bool m_tilesUseMipmaps {false};
     bool m_useOcio {false};
     bool m_initialized {false};
 
@@ -83,8 +83,6 @@ KisTextureTile::KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *
     , f(fcn)
     , m_bufferStorage(bufferStorage)
 {
-    const GLvoid *fd = fillData.constData();
-
     m_textureRectInImagePixels =
             kisGrowRect(m_tileRectInImagePixels, texturesInfo->border);
 
@@ -92,6 +90,22 @@ KisTextureTile::KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *
                                              m_tileRectInImagePixels,
                                              m_texturesInfo);
 
+    if (!fillData.isEmpty()) {
+        makeResident(fillData);
+    }
+}
+
+KisTextureTile::~KisTextureTile()
+{
+    evict();
+}
+
+void KisTextureTile::makeResident(const QByteArray &fillData)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_textureId);
+
+    const GLvoid *fd = fillData.constData();
+
     f->glGenTextures(1, &m_textureId);
     f->glBindTexture(GL_TEXTURE_2D, m_textureId);
 
@@ -112,9 +126,16 @@ KisTextureTile::KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *
     setNeedsMipmapRegeneration();
 }
 
-KisTextureTile::~KisTextureTile()
+void KisTextureTile::evict()
 {
+    if (!m_textureId) return;
+
     f->glDeleteTextures(1, &m_textureId);
+    m_textureId = 0;
+
+    m_needsMipmapRegeneration = false;
+    m_mipmapHasBeenAllocated = false;
+    m_preparedLodPlane = 0;
 }
 
 int KisTextureTile::bindToActiveTexture(bool blockMipmapRegeneration)
@@ -201,6 +222,22 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
         regenerateMipmap();
     }
 
+    /**
+     * Small Lod0 updates come with the dirty parts of the mipmap
+     * levels already downsampled by the update info builder. If the
+     * mipmap of the tile is up-to-date, we can just patch it instead
+     * of marking the whole chain for regeneration.
+     */
+    const int levelsAlignment = 1 << m_numMipmapLevels;
+    const bool updateMipmapPartially =
+        !patchLevelOfDetail &&
+        m_numMipmapLevels > 0 &&
+        updateInfo.numMipmapLevels() == m_numMipmapLevels &&
+        m_mipmapHasBeenAllocated &&
+        !m_needsMipmapRegeneration &&
+        !m_preparedLodPlane &&
+        m_texturesInfo->width % levelsAlignment == 0 &&
+        m_texturesInfo->height % levelsAlignment == 0;
 
     if (updateInfo.isEntireTileUpdated()) {
         KisOpenGLBufferCircularStorage::BufferBinder b(
@@ -345,6 +382,23 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
         }
     }
 
+    if (updateMipmapPartially) {
+        for (int level = 1; level <= m_numMipmapLevels; level++) {
+            const QByteArray &levelData = updateInfo.mipmapLevelData(level);
+
+            const GLvoid *fd = levelData.constData();
+            KisOpenGLBufferCircularStorage::BufferBinder b(
+                m_bufferStorage, &fd, levelData.size());
+
+            f->glTexSubImage2D(GL_TEXTURE_2D, level,
+                               patchOffset.x() >> level, patchOffset.y() >> level,
+                               patchSize.width() >> level, patchSize.height() >> level,
+                               m_texturesInfo->format,
+                               m_texturesInfo->type,
+                               fd);
+        }
+    }
+
     //// Uncomment this warning if you see any weird flickering when
     //// Instant Preview updates
     // if (!updateInfo.isEntireTileUpdated() &&
@@ -357,7 +411,9 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
     restoreTextureParameters();
 
     if (!patchLevelOfDetail) {
-        if (m_mipmapHasBeenAllocated &&
+        if (updateMipmapPartially) {
+            setPreparedLodPlane(0);
+        } else if (m_mipmapHasBeenAllocated &&
                 (m_filter == KisOpenGL::BilinearFilterMode ||
                  m_filter == KisOpenGL::NearestFilterMode)) {
             /**
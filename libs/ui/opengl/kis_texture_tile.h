@@ -40,6 +40,11 @@ struct KisGLTexturesInfo {
 class KisTextureTile
 {
 public:
+    /**
+     * Creates the tile and allocates its texture filled with \p fillData.
+     * An empty \p fillData creates a non-resident tile, which gets its
+     * texture only after makeResident() is called.
+     */
     KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *texturesInfo,
                    const QByteArray &fillData, KisOpenGL::FilterMode mode,
                    KisOpenGLBufferCircularStorage *bufferStorage, int numMipmapLevels, QOpenGLFunctions *f);
@@ -55,6 +60,22 @@ public:
 
     void update(const KisTextureTileUpdateInfo &updateInfo, bool blockMipmapRegeneration);
 
+    /**
+     * Allocates the texture of a non-resident tile and fills it
+     * with \p fillData
+     */
+    void makeResident(const QByteArray &fillData);
+
+    /**
+     * Frees the texture of the tile. The content of the tile is lost,
+     * so it should be fully updated after the next makeResident().
+     */
+    void evict();
+
+    inline bool isResident() const {
+        return m_textureId != 0;
+    }
+
     inline QRect tileRectInImagePixels() {
         return m_tileRectInImagePixels;
     }
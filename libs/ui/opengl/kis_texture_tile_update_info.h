@@ -10,6 +10,13 @@
 #include <QThreadStorage>
 #include <QScopedArrayPointer>
 
+#include <limits>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
 #include "kis_config.h"
 #include "kis_image.h"
 #include "kis_paint_device.h"
@@ -110,6 +117,36 @@ private:
     KisTextureTileInfoPoolSP m_pool;
 };
 
+/**
+ * Averages 2x2 blocks of \p src into \p dst, the same way
+ * glGenerateMipmap() does for power-of-two textures
+ */
+template <typename channel_type, typename compose_type>
+inline void downsampleMipmapLevel(const quint8 *src, quint8 *dst, const QSize &dstSize, int channelCount)
+{
+    const channel_type *srcPtr = reinterpret_cast<const channel_type*>(src);
+    channel_type *dstPtr = reinterpret_cast<channel_type*>(dst);
+
+    const int dstRowLength = dstSize.width() * channelCount;
+    const int srcRowLength = 2 * dstRowLength;
+
+    for (int y = 0; y < dstSize.height(); y++) {
+        const channel_type *row0 = srcPtr + 2 * y * srcRowLength;
+        const channel_type *row1 = row0 + srcRowLength;
+
+        for (int x = 0; x < dstRowLength; x++) {
+            const int i = (x / channelCount) * 2 * channelCount + x % channelCount;
+
+            const compose_type sum =
+                compose_type(row0[i]) + compose_type(row0[i + channelCount]) +
+                compose_type(row1[i]) + compose_type(row1[i + channelCount]);
+
+            *dstPtr++ = std::numeric_limits<channel_type>::is_integer ?
+                channel_type((sum + 2) / 4) : channel_type(sum / 4);
+        }
+    }
+}
+
 class KisTextureTileUpdateInfo
 {
 public:
@@ -148,7 +185,12 @@ public:
     ~KisTextureTileUpdateInfo() {
     }
 
-    void retrieveData(KisPaintDeviceSP projectionDevice, const QBitArray &channelFlags, bool onlyOneChannelSelected, int selectedChannelIndex)
+    /**
+     * Reads the patch from \p projectionDevice and applies the channel
+     * flags to it. The method is reentrant, so the patches of different
+     * tiles can be retrieved in parallel.
+     */
+    void retrieveData(KisPaintDeviceSP projectionDevice, const QBitArray &channelFlags, bool onlyOneChannelSelected, int selectedChannelIndex, bool showSingleChannelAsColor)
     {
         m_patchColorSpace = projectionDevice->colorSpace();
         m_patchPixels.allocate(m_patchColorSpace->pixelSize());
@@ -164,9 +206,7 @@ public:
 
             quint32 numPixels = m_patchRect.width() * m_patchRect.height();
 
-            KisConfig cfg(true);
-
-            if (onlyOneChannelSelected && !cfg.showSingleChannelAsColor()) {
+            if (onlyOneChannelSelected && !showSingleChannelAsColor) {
                 m_patchColorSpace->convertChannelToVisualRepresentation(m_patchPixels.data(), conversionCache.data(), numPixels, selectedChannelIndex);
             } else {
                 m_patchColorSpace->convertChannelToVisualRepresentation(m_patchPixels.data(), conversionCache.data(), numPixels, channelFlags);
@@ -177,6 +217,88 @@ public:
 
     }
 
+    /**
+     * Grows the patch of a partial Lod0 update to be aligned to
+     * \p numLevels mipmap levels of the texture, so that the dirty
+     * part of every level can be downsampled from the patch itself
+     * in generateMipmapLevels(). Must be called before retrieveData().
+     *
+     * The patches that touch the image boundaries (they also update
+     * the border stripes) or cover the entire tile are left intact,
+     * the tile regenerates the whole mipmap for them.
+     */
+    void alignPatchToMipmapLevels(int numLevels)
+    {
+        if (m_patchLevelOfDetail || numLevels <= 0 || isEntireTileUpdated()) return;
+
+        const int mask = (1 << numLevels) - 1;
+        const QPoint offset = realPatchOffset();
+
+        const int x1 = offset.x() & ~mask;
+        const int y1 = offset.y() & ~mask;
+        const int x2 = (offset.x() + m_patchRect.width() + mask) & ~mask;
+        const int y2 = (offset.y() + m_patchRect.height() + mask) & ~mask;
+
+        const QRect alignedRect(m_tileRect.x() + x1, m_tileRect.y() + y1, x2 - x1, y2 - y1);
+        const QRect innerImageRect = m_currentImageRect.adjusted(1, 1, -1, -1);
+
+        if (alignedRect == m_tileRect ||
+            !m_tileRect.contains(alignedRect) ||
+            !innerImageRect.contains(alignedRect)) {
+
+            return;
+        }
+
+        m_patchRect = alignedRect;
+        m_originalPatchRect = alignedRect;
+        m_numMipmapLevels = numLevels;
+    }
+
+    /**
+     * Downsamples the final (converted) pixels of the patch into the
+     * mipmap levels requested by alignPatchToMipmapLevels()
+     */
+    void generateMipmapLevels()
+    {
+        if (!m_numMipmapLevels || !m_patchPixels.data()) return;
+
+        const KoChannelInfo::enumChannelValueType channelType =
+            m_patchColorSpace->channels().first()->channelValueType();
+        const int channelCount = m_patchColorSpace->channelCount();
+        const int channelSize = m_patchColorSpace->pixelSize() / channelCount;
+
+        m_mipmapLevels.clear();
+        m_mipmapLevels.reserve(m_numMipmapLevels);
+
+        const quint8 *src = m_patchPixels.data();
+        QSize size = m_patchRect.size();
+
+        for (int level = 1; level <= m_numMipmapLevels; level++) {
+            size /= 2;
+            QByteArray levelData(size.width() * size.height() * m_patchColorSpace->pixelSize(), Qt::Uninitialized);
+            quint8 *dst = reinterpret_cast<quint8*>(levelData.data());
+
+            if (channelType == KoChannelInfo::UINT8 && channelSize == 1) {
+                downsampleMipmapLevel<quint8, quint32>(src, dst, size, channelCount);
+            } else if (channelType == KoChannelInfo::UINT16 && channelSize == 2) {
+                downsampleMipmapLevel<quint16, quint32>(src, dst, size, channelCount);
+#ifdef HAVE_OPENEXR
+            } else if (channelType == KoChannelInfo::FLOAT16 && channelSize == 2) {
+                downsampleMipmapLevel<half, float>(src, dst, size, channelCount);
+#endif
+            } else if (channelType == KoChannelInfo::FLOAT32 && channelSize == 4) {
+                downsampleMipmapLevel<float, float>(src, dst, size, channelCount);
+            } else {
+                m_mipmapLevels.clear();
+                m_numMipmapLevels = 0;
+                return;
+            }
+
+            m_mipmapLevels.append(levelData);
+            src = reinterpret_cast<const quint8*>(m_mipmapLevels.last().constData());
+        }
+    }
+
     void convertTo(const KoColorSpace* dstCS,
                    KoColorConversionTransformation::Intent renderingIntent,
                    KoColorConversionTransformation::ConversionFlags conversionFlags)
@@ -275,6 +397,22 @@ public:
         return m_patchRect == m_tileRect;
     }
 
+    /**
+     * The number of mipmap levels prepared by generateMipmapLevels(),
+     * zero if the tile should regenerate its mipmap itself
+     */
+    inline int numMipmapLevels() const {
+        return m_mipmapLevels.size();
+    }
+
+    /**
+     * The dirty part of mipmap \p level, its offset and size are
+     * realPatchOffset() and realPatchSize() divided by 2^level
+     */
+    inline const QByteArray& mipmapLevelData(int level) const {
+        return m_mipmapLevels[level - 1];
+    }
+
     inline qint32 tileCol() const {
         return m_tileCol;
     }
@@ -323,6 +461,8 @@ private:
     QRect m_realPatchOffset;
     QRect m_realTileSize;
     int m_patchLevelOfDetail {0};
+    int m_numMipmapLevels {0};
+    QVector<QByteArray> m_mipmapLevels;
 
     QRect m_originalPatchRect;
     QRect m_originalTileRect;
@@ -0,0 +1,249 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "FreehandStrokeReplayBenchmark.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtMath>
+
+#include "KisAsynchronousStrokeUpdateHelper.h"
+#include "KisRunnableStrokeJobData.h"
+#include "KisStrokeRecording.h"
+#include "kis_distance_information.h"
+#include "kis_image.h"
+#include "kis_resources_snapshot.h"
+#include "stroke_testing_utils.h"
+#include "strokes/KisFreehandStrokeInfo.h"
+#include "strokes/freehand_stroke.h"
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <KisGlobalResourcesInterface.h>
+#include <testutil.h>
+
+
+namespace {
+
+QString corpusDirectory()
+{
+    return qEnvironmentVariable("KRITA_STROKE_CORPUS");
+}
+
+QString presetsDirectory()
+{
+    const QString dir = qEnvironmentVariable("KRITA_BENCHMARK_PRESETS");
+    return !dir.isEmpty() ? dir : QString(KRITA_SOURCE_DIR) + "/krita/data/paintoppresets";
+}
+
+qreal percentile(QVector<qreal> values, qreal fraction)
+{
+    if (values.isEmpty()) return 0.0;
+
+    std::sort(values.begin(), values.end());
+    const int index = qBound(0, qCeil(fraction * values.size()) - 1, values.size() - 1);
+    return values[index];
+}
+
+}
+
+class FreehandStrokeReplayTester : public utils::StrokeTester
+{
+public:
+    FreehandStrokeReplayTester(const QString &presetFilename,
+                               const KisStrokeRecording &recording,
+                               const QSize &imageSize,
+                               const QPointF &offset)
+        : StrokeTester("freehand_replay", imageSize, presetFilename),
+          m_recording(recording),
+          m_offset(offset)
+    {
+    }
+
+    /**
+     * In real-time mode the events are sent to the stroke at the
+     * pace they were recorded with, which gives the latency a user
+     * would get. Otherwise all the events are sent at once, which
+     * gives the max throughput of the brush.
+     */
+    void setRealTime(bool value) {
+        m_realTime = value;
+    }
+
+    int numDabs() const {
+        return m_numDabs;
+    }
+
+    /**
+     * @return the time between sending an event to the stroke and
+     *         finishing its painting, in milliseconds
+     */
+    QVector<qreal> latencies() const {
+        QVector<qreal> result;
+        for (int i = 0; i < m_submitTimes.size(); i++) {
+            result.append((m_completionTimes[i] - m_submitTimes[i]) / 1e6);
+        }
+        return result;
+    }
+
+protected:
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        m_strokeInfo = new KisFreehandStrokeInfo();
+
+        return new FreehandStrokeStrategy(resources, m_strokeInfo, kundo2_noi18n("Replayed Stroke"));
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources, int iteration) override {
+        Q_UNUSED(resources);
+        Q_UNUSED(iteration);
+
+        const int numEvents = m_recording.size();
+
+        m_submitTimes.fill(0, numEvents);
+        m_completionTimes.fill(0, numEvents);
+        m_numDabs = 0;
+
+        m_clock.start();
+        const qreal startTime = m_recording.events().first().time;
+
+        KisPaintInformation prevPi;
+
+        for (int i = 0; i < numEvents; i++) {
+            KisPaintInformation pi = m_recording.paintInformation(i);
+            pi.setPos(pi.pos() + m_offset);
+
+            if (m_realTime) {
+                const qint64 delay = qint64(pi.currentTime() - startTime) - m_clock.elapsed();
+                if (delay > 0) {
+                    QThread::msleep(delay);
+                }
+            }
+
+            m_submitTimes[i] = m_clock.nsecsElapsed();
+
+            if (i == 0) {
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, pi));
+            } else {
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, prevPi, pi));
+            }
+
+            // the job can start only when the painting of the event is finished
+            image->addJob(strokeId(),
+                new KisRunnableStrokeJobData(
+                    [this, i] () {
+                        m_completionTimes[i] = m_clock.nsecsElapsed();
+                    },
+                    KisStrokeJobData::UNIQUELY_CONCURRENT));
+
+            prevPi = pi;
+        }
+
+        image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
+
+        image->addJob(strokeId(),
+            new KisRunnableStrokeJobData(
+                [this] () {
+                    m_numDabs = m_strokeInfo->dragDistance->currentDabSeqNo();
+                },
+                KisStrokeJobData::SEQUENTIAL));
+    }
+
+private:
+    const KisStrokeRecording m_recording;
+    const QPointF m_offset;
+    bool m_realTime {false};
+
+    KisFreehandStrokeInfo *m_strokeInfo {nullptr};
+    QElapsedTimer m_clock;
+    QVector<qint64> m_submitTimes;
+    QVector<qint64> m_completionTimes;
+    int m_numDabs {0};
+};
+
+void FreehandStrokeReplayBenchmark::testReplay_data()
+{
+    QTest::addColumn<QString>("presetFileName");
+    QTest::addColumn<QString>("recordingFileName");
+
+    if (corpusDirectory().isEmpty()) {
+        return;
+    }
+
+    const QFileInfoList recordings =
+        QDir(corpusDirectory()).entryInfoList({"*" + KisStrokeRecording::fileExtension()}, QDir::Files, QDir::Name);
+
+    const QFileInfoList presets =
+        QDir(presetsDirectory()).entryInfoList({"*.kpp"}, QDir::Files, QDir::Name);
+
+    Q_FOREACH (const QFileInfo &preset, presets) {
+        Q_FOREACH (const QFileInfo &recording, recordings) {
+            const QString name = preset.completeBaseName() + "/" + recording.completeBaseName();
+            QTest::newRow(name.toUtf8()) << preset.absoluteFilePath() << recording.absoluteFilePath();
+        }
+    }
+}
+
+void FreehandStrokeReplayBenchmark::testReplay()
+{
+    if (corpusDirectory().isEmpty()) {
+        QSKIP("Set KRITA_STROKE_CORPUS to the directory with the stroke recordings");
+    }
+
+    QFETCH(QString, presetFileName);
+    QFETCH(QString, recordingFileName);
+
+    {
+        // some bundled presets need resources the test environment doesn't have
+        KisPaintOpPresetSP preset(new KisPaintOpPreset(presetFileName));
+        if (!preset->load(KisGlobalResourcesInterface::instance()) || !preset->valid()) {
+            QSKIP("The preset cannot be loaded");
+        }
+    }
+
+    KisStrokeRecording recording;
+    QVERIFY(recording.load(recordingFileName));
+    if (recording.isEmpty()) {
+        QSKIP("The recording is empty");
+    }
+
+    QRectF bounds;
+    Q_FOREACH (const KisStrokeRecording::Event &e, recording.events()) {
+        bounds |= QRectF(e.pos, QSizeF(1, 1));
+    }
+
+    const int margin = 500;
+    const QSize imageSize = bounds.toAlignedRect().size() + QSize(2 * margin, 2 * margin);
+    const QPointF offset = QPointF(margin, margin) - bounds.topLeft();
+
+    FreehandStrokeReplayTester tester(presetFileName, recording, imageSize, offset);
+
+    tester.setRealTime(false);
+    tester.benchmark();
+
+    const qreal strokeTime = qMax(1, tester.lastStrokeTime()) / 1000.0;
+
+    tester.setRealTime(true);
+    tester.benchmark();
+
+    const QVector<qreal> latencies = tester.latencies();
+
+    qDebug() << qPrintable(QString("Events: %1 Dabs: %2 Events/s: %3 Dabs/s: %4 Latency p50: %5 p90: %6 p99: %7 (ms)")
+                           .arg(recording.size())
+                           .arg(tester.numDabs())
+                           .arg(recording.size() / strokeTime, 0, 'f', 1)
+                           .arg(tester.numDabs() / strokeTime, 0, 'f', 1)
+                           .arg(percentile(latencies, 0.5), 0, 'f', 2)
+                           .arg(percentile(latencies, 0.9), 0, 'f', 2)
+                           .arg(percentile(latencies, 0.99), 0, 'f', 2));
+}
+
+SIMPLE_TEST_MAIN(FreehandStrokeReplayBenchmark)
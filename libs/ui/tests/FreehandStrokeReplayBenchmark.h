@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef FREEHANDSTROKEREPLAYBENCHMARK_H
+#define FREEHANDSTROKEREPLAYBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Replays the recorded real-world strokes (see KisStrokeRecording)
+ * with all the bundled presets and reports the throughput and the
+ * latency of the brush engines.
+ *
+ * The corpus of the recordings is read from the directory set in
+ * KRITA_STROKE_CORPUS environment variable, the presets from
+ * KRITA_BENCHMARK_PRESETS (the bundled presets by default).
+ */
+class FreehandStrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testReplay_data();
+    void testReplay();
+};
+
+#endif // FREEHANDSTROKEREPLAYBENCHMARK_H
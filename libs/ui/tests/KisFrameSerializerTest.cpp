@@ -67,13 +67,23 @@ bool verifyTestFrame(int frameSeed, const KisFrameDataSerializer::Frame &frame)
 
 
 
+void KisFrameSerializerTest::testFrameDataSerialization_data()
+{
+    QTest::addColumn<int>("storageType");
+
+    QTest::newRow("on-disk") << int(KisFrameDataSerializer::OnDiskStorage);
+    QTest::newRow("in-memory") << int(KisFrameDataSerializer::InMemoryStorage);
+}
+
 void KisFrameSerializerTest::testFrameDataSerialization()
 {
+    QFETCH(int, storageType);
+
     KisTextureTileInfoPoolRegistry poolRegistry;
     KisTextureTileInfoPoolSP pool = poolRegistry.getPool(maxTileSize, maxTileSize);
 
 
-    KisFrameDataSerializer serializer;
+    KisFrameDataSerializer serializer(KisFrameDataSerializer::StorageType(storageType));
 
     KisFrameDataSerializer::Frame testFrame1 = generateTestFrame(2, pool);
     KisFrameDataSerializer::Frame testFrame2 = generateTestFrame(3, pool);
@@ -119,6 +129,34 @@ void KisFrameSerializerTest::testFrameDataSerialization()
     QCOMPARE(serializer.hasFrame(testFrameId3), false);
 }
 
+void KisFrameSerializerTest::testZeroTileSerialization_data()
+{
+    testFrameDataSerialization_data();
+}
+
+void KisFrameSerializerTest::testZeroTileSerialization()
+{
+    QFETCH(int, storageType);
+
+    KisTextureTileInfoPoolRegistry poolRegistry;
+    KisTextureTileInfoPoolSP pool = poolRegistry.getPool(maxTileSize, maxTileSize);
+
+    KisFrameDataSerializer serializer(KisFrameDataSerializer::StorageType(storageType));
+
+    KisFrameDataSerializer::Frame frame1 = generateTestFrame(3, pool);
+    KisFrameDataSerializer::Frame frame2 = frame1.clone();
+
+    // the difference of the same frames consists of zero tiles only
+    QVERIFY(KisFrameDataSerializer::subtractFrames(frame2, frame1));
+
+    const int frameId = serializer.saveFrame(frame2);
+    KisFrameDataSerializer::Frame loadedFrame = serializer.loadFrame(frameId, pool);
+    QCOMPARE(int(loadedFrame.frameTiles.size()), int(frame1.frameTiles.size()));
+
+    KisFrameDataSerializer::addFrames(loadedFrame, frame1);
+    QVERIFY(verifyTestFrame(3, loadedFrame));
+}
+
 #include "kis_random_source.h"
 
 void randomizeFrame(KisFrameDataSerializer::Frame &frame, qreal portion)
@@ -14,7 +14,10 @@ class KisFrameSerializerTest : public QObject
     Q_OBJECT
 
 private Q_SLOTS:
+    void testFrameDataSerialization_data();
     void testFrameDataSerialization();
+    void testZeroTileSerialization_data();
+    void testZeroTileSerialization();
     void testFrameUniquenessEstimation();
     void testFrameArithmetics();
 
@@ -0,0 +1,75 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokePathPredictorTest.h"
+
+#include "KisStrokePathPredictor.h"
+
+void KisStrokePathPredictorTest::testSteadyMovement()
+{
+    KisStrokePathPredictor predictor;
+
+    // 1 px/ms to the right, 1000 Hz tablet
+    for (int i = 0; i < 20; i++) {
+        predictor.addEvent(QPointF(i, 10), i);
+    }
+
+    std::optional<QPointF> pos = predictor.predict(10);
+    QVERIFY(pos);
+    QCOMPARE(*pos, QPointF(29, 10));
+}
+
+void KisStrokePathPredictorTest::testNotEnoughEvents()
+{
+    KisStrokePathPredictor predictor;
+    QVERIFY(!predictor.predict(10));
+
+    predictor.addEvent(QPointF(0, 0), 0);
+    QVERIFY(!predictor.predict(10));
+
+    predictor.addEvent(QPointF(1, 0), 1);
+    QVERIFY(!predictor.predict(10));
+
+    predictor.addEvent(QPointF(2, 0), 2);
+    QVERIFY(predictor.predict(10));
+
+    predictor.clear();
+    QVERIFY(!predictor.predict(10));
+}
+
+void KisStrokePathPredictorTest::testSharpTurn()
+{
+    KisStrokePathPredictor predictor;
+
+    for (int i = 0; i < 20; i++) {
+        predictor.addEvent(QPointF(i, 0), i);
+    }
+    QVERIFY(predictor.predict(10));
+
+    // the pen turns by 90 degrees
+    predictor.addEvent(QPointF(19, 1), 20);
+    QVERIFY(!predictor.predict(10));
+}
+
+void KisStrokePathPredictorTest::testPenStopped()
+{
+    KisStrokePathPredictor predictor;
+
+    for (int i = 0; i < 20; i++) {
+        predictor.addEvent(QPointF(i, 0), i);
+    }
+    QVERIFY(predictor.predict(10));
+
+    // the pen stays still
+    predictor.addEvent(QPointF(19, 0), 20);
+    QVERIFY(!predictor.predict(10));
+
+    // no events for a long time
+    predictor.addEvent(QPointF(20, 0), 200);
+    QVERIFY(!predictor.predict(10));
+}
+
+SIMPLE_TEST_MAIN(KisStrokePathPredictorTest)
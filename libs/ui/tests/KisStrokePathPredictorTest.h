@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEPATHPREDICTORTEST_H
+#define KISSTROKEPATHPREDICTORTEST_H
+
+#include <simpletest.h>
+
+class KisStrokePathPredictorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSteadyMovement();
+    void testNotEnoughEvents();
+    void testSharpTurn();
+    void testPenStopped();
+};
+
+#endif // KISSTROKEPATHPREDICTORTEST_H
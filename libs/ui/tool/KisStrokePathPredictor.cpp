@@ -0,0 +1,86 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokePathPredictor.h"
+
+#include <cmath>
+
+#include "kis_algebra_2d.h"
+
+namespace {
+
+// The time constant of the velocity smoothing, in milliseconds
+const qreal velocitySmoothingTime = 8.0;
+
+// The pen is considered stopped when there were no events for that long
+const qreal maxEventsGap = 50.0;
+
+// The pen is considered turning when the direction of its movement
+// changes by more than ~45 degrees during one event
+const qreal minSteadyDirectionCos = 0.7;
+
+// The prediction further than that is not reliable
+const qreal maxLookAheadTime = 30.0;
+
+}
+
+void KisStrokePathPredictor::addEvent(const QPointF &pos, qreal time)
+{
+    if (!m_hasLastEvent) {
+        m_hasLastEvent = true;
+        m_lastPos = pos;
+        m_lastTime = time;
+        return;
+    }
+
+    const qreal dt = time - m_lastTime;
+
+    if (dt <= 0.0) {
+        // the tablet sent a few events with the same timestamp, the
+        // later ones override the position
+        m_lastPos = pos;
+        return;
+    }
+
+    if (dt > maxEventsGap) {
+        m_hasVelocity = false;
+        m_isSteady = false;
+    }
+
+    const QPointF velocity = (pos - m_lastPos) / dt;
+
+    if (!m_hasVelocity) {
+        m_velocity = velocity;
+        m_hasVelocity = true;
+        m_isSteady = false;
+    } else {
+        const qreal speed = KisAlgebra2D::norm(velocity);
+        const qreal smoothedSpeed = KisAlgebra2D::norm(m_velocity);
+
+        m_isSteady = speed > 0.0 && smoothedSpeed > 0.0 &&
+            KisAlgebra2D::dotProduct(velocity, m_velocity) / (speed * smoothedSpeed) > minSteadyDirectionCos;
+
+        const qreal alpha = 1.0 - std::exp(-dt / velocitySmoothingTime);
+        m_velocity += alpha * (velocity - m_velocity);
+    }
+
+    m_lastPos = pos;
+    m_lastTime = time;
+}
+
+std::optional<QPointF> KisStrokePathPredictor::predict(qreal lookAheadTime) const
+{
+    if (!m_isSteady || lookAheadTime <= 0.0) {
+        return std::nullopt;
+    }
+
+    return m_lastPos + m_velocity * qMin(lookAheadTime, maxLookAheadTime);
+}
+
+void KisStrokePathPredictor::clear()
+{
+    *this = KisStrokePathPredictor();
+}
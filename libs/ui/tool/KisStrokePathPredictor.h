@@ -0,0 +1,55 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEPATHPREDICTOR_H
+#define KISSTROKEPATHPREDICTOR_H
+
+#include <optional>
+
+#include <QPointF>
+
+#include "kritaui_export.h"
+
+/**
+ * @brief Extrapolates the path of the pen a few milliseconds ahead
+ *
+ * The predictor keeps an exponentially smoothed velocity of the pen
+ * and extrapolates the last position linearly. The prediction is
+ * only given when the pen moves steadily, i.e. when it doesn't stop
+ * and doesn't turn sharply, otherwise a wrong prediction would be
+ * more distracting than the latency it hides.
+ *
+ * The predicted position is used only for the throwaway preview of
+ * the stroke, it never gets into the real stroke.
+ */
+class KRITAUI_EXPORT KisStrokePathPredictor
+{
+public:
+    /**
+     * Adds the position of the pen at \p time (in milliseconds)
+     */
+    void addEvent(const QPointF &pos, qreal time);
+
+    /**
+     * @return the predicted position of the pen \p lookAheadTime
+     *         milliseconds after the last event, or nothing if the
+     *         pen movement is not predictable
+     */
+    std::optional<QPointF> predict(qreal lookAheadTime) const;
+
+    void clear();
+
+private:
+    bool m_hasLastEvent {false};
+    bool m_hasVelocity {false};
+    bool m_isSteady {false};
+
+    QPointF m_lastPos;
+    qreal m_lastTime {0.0};
+    QPointF m_velocity;
+};
+
+#endif // KISSTROKEPATHPREDICTOR_H
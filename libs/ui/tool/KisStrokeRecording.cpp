@@ -0,0 +1,153 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeRecording.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include <kis_debug.h>
+#include <brushengine/kis_paint_information.h>
+
+namespace {
+const QString formatHeader = "krita-stroke-recording 1";
+const int numFields = 10;
+}
+
+QString KisStrokeRecording::fileExtension()
+{
+    return ".kstroke";
+}
+
+void KisStrokeRecording::addEvent(const KisPaintInformation &pi)
+{
+    Event event;
+    event.time = pi.currentTime();
+    event.pos = pi.pos();
+    event.pressure = pi.pressure();
+    event.xTilt = pi.xTilt();
+    event.yTilt = pi.yTilt();
+    event.rotation = pi.rotation();
+    event.tangentialPressure = pi.tangentialPressure();
+    event.perspective = pi.perspective();
+    event.speed = pi.drawingSpeed();
+
+    m_events.append(event);
+}
+
+void KisStrokeRecording::clear()
+{
+    m_events.clear();
+}
+
+bool KisStrokeRecording::isEmpty() const
+{
+    return m_events.isEmpty();
+}
+
+int KisStrokeRecording::size() const
+{
+    return m_events.size();
+}
+
+const QVector<KisStrokeRecording::Event> &KisStrokeRecording::events() const
+{
+    return m_events;
+}
+
+KisPaintInformation KisStrokeRecording::paintInformation(int index) const
+{
+    const Event &e = m_events[index];
+
+    return KisPaintInformation(e.pos, e.pressure,
+                               e.xTilt, e.yTilt,
+                               e.rotation, e.tangentialPressure,
+                               e.perspective, e.time, e.speed);
+}
+
+bool KisStrokeRecording::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        warnKrita << "Failed to open stroke recording for writing:" << fileName;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream.setRealNumberPrecision(9);
+
+    stream << formatHeader << "\n";
+
+    Q_FOREACH (const Event &e, m_events) {
+        stream << e.time << " "
+               << e.pos.x() << " " << e.pos.y() << " "
+               << e.pressure << " "
+               << e.xTilt << " " << e.yTilt << " "
+               << e.rotation << " "
+               << e.tangentialPressure << " "
+               << e.perspective << " "
+               << e.speed << "\n";
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+bool KisStrokeRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        warnKrita << "Failed to open stroke recording:" << fileName;
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    if (stream.readLine() != formatHeader) {
+        warnKrita << "Unsupported stroke recording format:" << fileName;
+        return false;
+    }
+
+    QVector<Event> events;
+
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.size() != numFields) {
+            warnKrita << "Corrupted stroke recording:" << fileName << "line:" << line;
+            return false;
+        }
+
+        qreal values[numFields];
+        for (int i = 0; i < numFields; i++) {
+            bool ok = false;
+            values[i] = fields[i].toDouble(&ok);
+            if (!ok) {
+                warnKrita << "Corrupted stroke recording:" << fileName << "line:" << line;
+                return false;
+            }
+        }
+
+        Event e;
+        e.time = values[0];
+        e.pos = QPointF(values[1], values[2]);
+        e.pressure = values[3];
+        e.xTilt = values[4];
+        e.yTilt = values[5];
+        e.rotation = values[6];
+        e.tangentialPressure = values[7];
+        e.perspective = values[8];
+        e.speed = values[9];
+
+        events.append(e);
+    }
+
+    m_events = events;
+    return true;
+}
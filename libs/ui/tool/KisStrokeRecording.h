@@ -0,0 +1,70 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKERECORDING_H
+#define KISSTROKERECORDING_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "kritaui_export.h"
+
+class KisPaintInformation;
+
+/**
+ * @brief A replayable record of the input events of a freehand stroke
+ *
+ * KisToolFreehandHelper can record the paint information of the
+ * strokes the user paints (see KisConfig::strokeRecordingDirectory()),
+ * the recordings are then replayed by the brush benchmarks to get
+ * the real-world load on the brush engines.
+ *
+ * The file format is plain text: the "krita-stroke-recording 1"
+ * header line followed by one line per event with the space
+ * separated values of the fields of Event, in the order of the
+ * declaration.
+ */
+class KRITAUI_EXPORT KisStrokeRecording
+{
+public:
+    struct Event {
+        qreal time {0.0}; // ms since the start of the stroke
+        QPointF pos;
+        qreal pressure {1.0};
+        qreal xTilt {0.0};
+        qreal yTilt {0.0};
+        qreal rotation {0.0};
+        qreal tangentialPressure {0.0};
+        qreal perspective {1.0};
+        qreal speed {0.0};
+    };
+
+public:
+    static QString fileExtension();
+
+    void addEvent(const KisPaintInformation &pi);
+    void clear();
+
+    bool isEmpty() const;
+    int size() const;
+
+    const QVector<Event>& events() const;
+
+    /**
+     * @return the paint information of the event \p index. The random
+     *         sources are not set, the stroke strategy sets them itself.
+     */
+    KisPaintInformation paintInformation(int index) const;
+
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+private:
+    QVector<Event> m_events;
+};
+
+#endif // KISSTROKERECORDING_H
@@ -45,6 +45,7 @@ struct KisStrokeSpeedMonitor::Private
     qreal lastRenderingSpeed = 0;
     qreal lastFps = 0;
     bool lastStrokeSaturated = false;
+    StrokeStats lastStrokeStats;
 
     QByteArray lastPresetMd5;
     QString lastPresetName;
@@ -99,7 +100,8 @@ void KisStrokeSpeedMonitor::slotConfigChanged()
     Q_EMIT sigStatsUpdated();
 }
 
-void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal renderingSpeed, qreal fps, KisPaintOpPresetSP preset)
+void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal renderingSpeed, qreal fps, KisPaintOpPresetSP preset,
+                                                 const StrokeStats &stats)
 {
     if (qFuzzyCompare(cursorSpeed, 0.0) || qFuzzyCompare(renderingSpeed, 0.0)) return;
 
@@ -120,6 +122,7 @@ void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal render
     m_d->lastCursorSpeed = cursorSpeed;
     m_d->lastRenderingSpeed = renderingSpeed;
     m_d->lastFps = fps;
+    m_d->lastStrokeStats = stats;
 
 
     static const qreal saturationSpeedThreshold = 0.30; // cursor speed should be at least 30% higher
@@ -150,6 +153,12 @@ void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal render
             .arg(m_d->cachedAvgCursorSpeed, 5)
             .arg(m_d->cachedAvgRenderingSpeed, 5)
             .arg(m_d->cachedAvgFps, 5);
+    ENTER_FUNCTION() <<
+        QString("JOBS: %1 AJT: %2 ms BACKLOG: %3 UPDATES: %4")
+            .arg(stats.paintJobs, 5)
+            .arg(stats.avgPaintJobTime, 5)
+            .arg(stats.maxQueueBacklog, 5)
+            .arg(stats.updates, 5);
 }
 
 QString KisStrokeSpeedMonitor::lastPresetName() const
@@ -182,6 +191,26 @@ bool KisStrokeSpeedMonitor::lastStrokeSaturated() const
     return m_d->lastStrokeSaturated;
 }
 
+int KisStrokeSpeedMonitor::lastPaintJobs() const
+{
+    return m_d->lastStrokeStats.paintJobs;
+}
+
+qreal KisStrokeSpeedMonitor::lastAvgPaintJobTime() const
+{
+    return m_d->lastStrokeStats.avgPaintJobTime;
+}
+
+int KisStrokeSpeedMonitor::lastMaxQueueBacklog() const
+{
+    return m_d->lastStrokeStats.maxQueueBacklog;
+}
+
+int KisStrokeSpeedMonitor::lastUpdates() const
+{
+    return m_d->lastStrokeStats.updates;
+}
+
 qreal KisStrokeSpeedMonitor::avgCursorSpeed() const
 {
     return m_d->cachedAvgCursorSpeed;
@@ -25,6 +25,11 @@ class KRITAUI_EXPORT KisStrokeSpeedMonitor : public QObject
 
     Q_PROPERTY(bool lastStrokeSaturated READ lastCursorSpeed NOTIFY sigStatsUpdated)
 
+    Q_PROPERTY(int lastPaintJobs READ lastPaintJobs NOTIFY sigStatsUpdated)
+    Q_PROPERTY(qreal lastAvgPaintJobTime READ lastAvgPaintJobTime NOTIFY sigStatsUpdated)
+    Q_PROPERTY(int lastMaxQueueBacklog READ lastMaxQueueBacklog NOTIFY sigStatsUpdated)
+    Q_PROPERTY(int lastUpdates READ lastUpdates NOTIFY sigStatsUpdated)
+
     Q_PROPERTY(qreal avgCursorSpeed READ avgCursorSpeed NOTIFY sigStatsUpdated)
     Q_PROPERTY(qreal avgRenderingSpeed READ avgRenderingSpeed NOTIFY sigStatsUpdated)
     Q_PROPERTY(qreal avgFps READ avgFps NOTIFY sigStatsUpdated)
@@ -37,7 +42,19 @@ public:
 
     bool haveStrokeSpeedMeasurement() const;
 
-    void notifyStrokeFinished(qreal cursorSpeed, qreal renderingSpeed, qreal fps, KisPaintOpPresetSP preset);
+    /**
+     * Per-stroke statistics of the rendering, reported in addition
+     * to the speed values
+     */
+    struct StrokeStats {
+        int paintJobs = 0;
+        qreal avgPaintJobTime = 0; // ms
+        int maxQueueBacklog = 0;
+        int updates = 0;
+    };
+
+    void notifyStrokeFinished(qreal cursorSpeed, qreal renderingSpeed, qreal fps, KisPaintOpPresetSP preset,
+                              const StrokeStats &stats = StrokeStats());
 
 
     QString lastPresetName() const;
@@ -48,6 +65,11 @@ public:
     qreal lastFps() const;
     bool lastStrokeSaturated() const;
 
+    int lastPaintJobs() const;
+    qreal lastAvgPaintJobTime() const;
+    int lastMaxQueueBacklog() const;
+    int lastUpdates() const;
+
     qreal avgCursorSpeed() const;
     qreal avgRenderingSpeed() const;
     qreal avgFps() const;
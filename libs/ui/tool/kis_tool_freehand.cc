@@ -52,6 +52,11 @@
 
 using namespace std::placeholders; // For _1 placeholder
 
+namespace {
+// the brush outline is not updated more often than ~120 times per second
+const int outlineUpdateInterval = 8; // ms
+}
+
 
 KisToolFreehand::KisToolFreehand(KoCanvasBase * canvas, const QCursor & cursor,
                                  const KUndo2MagicString &transactionText, bool useSavedSmoothing)
@@ -70,6 +75,9 @@ KisToolFreehand::KisToolFreehand(KoCanvasBase * canvas, const QCursor & cursor,
 
     connect(m_helper, SIGNAL(requestExplicitUpdateOutline()), SLOT(explicitUpdateOutline()));
 
+    m_delayedOutlineUpdateTimer.setSingleShot(true);
+    connect(&m_delayedOutlineUpdateTimer, SIGNAL(timeout()), SLOT(slotDelayedOutlineUpdate()));
+
     connect(qobject_cast<KisCanvas2*>(canvas)->viewManager(), SIGNAL(brushOutlineToggled()), SLOT(explicitUpdateOutline()));
 
     KisCanvasResourceProvider *provider = qobject_cast<KisCanvas2*>(canvas)->viewManager()->canvasResourceProvider();
@@ -190,6 +198,7 @@ void KisToolFreehand::doStroke(KoPointerEvent *event)
 
 void KisToolFreehand::endStroke()
 {
+    clearPredictedSegment();
     m_helper->endPaint();
     bool paintOpIgnoredEvent = currentPaintOpPreset()->settings()->mouseReleaseEvent();
     Q_UNUSED(paintOpIgnoredEvent);
@@ -234,6 +243,9 @@ void KisToolFreehand::beginPrimaryAction(KoPointerEvent *event)
         canvas2->viewManager()->disableControls();
     }
 
+    KisConfig cfg(true);
+    m_strokePredictionTime = cfg.strokePredictionEnabled() ? cfg.strokePredictionTime() : 0;
+
     initStroke(event);
 }
 
@@ -241,12 +253,103 @@ void KisToolFreehand::continuePrimaryAction(KoPointerEvent *event)
 {
     CHECK_MODE_SANITY_OR_RETURN(KisTool::PAINT_MODE);
 
-    requestUpdateOutline(event->point, event);
+    updateOutlineWhilePainting(event);
 
     /**
      * Actual painting
      */
     doStroke(event);
+
+    if (m_strokePredictionTime > 0) {
+        updatePredictedSegment();
+    }
+}
+
+void KisToolFreehand::updateOutlineWhilePainting(KoPointerEvent *event)
+{
+    /**
+     * Modern tablets deliver several hundreds of events per second, which
+     * is much more than the display can show. All the events still go to
+     * the freehand helper, so the stroke gets the full set of samples, but
+     * the brush outline is recalculated at most once per frame. The last
+     * skipped event is remembered and its outline is shown when the
+     * interval ends, so the outline never lags behind the pen.
+     */
+    if (!m_outlineUpdateTime.isValid() ||
+        m_outlineUpdateTime.elapsed() >= outlineUpdateInterval) {
+
+        m_delayedOutlineUpdateTimer.stop();
+        m_pendingOutlineEvent.reset();
+        m_outlineUpdateTime.start();
+
+        requestUpdateOutline(event->point, event);
+    } else {
+        m_pendingOutlineEvent = event->deepCopyEvent();
+
+        if (!m_delayedOutlineUpdateTimer.isActive()) {
+            m_delayedOutlineUpdateTimer.start(
+                qMax(0, outlineUpdateInterval - int(m_outlineUpdateTime.elapsed())));
+        }
+    }
+}
+
+void KisToolFreehand::slotDelayedOutlineUpdate()
+{
+    if (!m_pendingOutlineEvent) return;
+
+    m_outlineUpdateTime.start();
+    requestUpdateOutline(m_pendingOutlineEvent->event.point, &m_pendingOutlineEvent->event);
+    m_pendingOutlineEvent.reset();
+}
+
+void KisToolFreehand::paint(QPainter &gc, const KoViewConverter &converter)
+{
+    KisToolPaint::paint(gc, converter);
+
+    if (m_predictedSegment) {
+        const QLineF viewSegment(pixelToView(m_predictedSegment->p1()),
+                                 pixelToView(m_predictedSegment->p2()));
+        const qreal viewWidth =
+            qMax(1.0, pixelToView(QRectF(0, 0, m_predictedSegmentWidth, m_predictedSegmentWidth)).width());
+
+        gc.save();
+        gc.setRenderHint(QPainter::Antialiasing);
+        gc.setPen(QPen(currentFgColor().toQColor(), viewWidth, Qt::SolidLine, Qt::RoundCap));
+        gc.drawLine(viewSegment);
+        gc.restore();
+    }
+}
+
+void KisToolFreehand::updatePredictedSegment()
+{
+    const QRectF oldRect = m_predictedSegmentRect;
+
+    m_predictedSegment = m_helper->predictedStrokeSegment(m_strokePredictionTime);
+    m_predictedSegmentRect = QRectF();
+
+    if (m_predictedSegment) {
+        m_predictedSegmentWidth =
+            currentPaintOpPreset() ? currentPaintOpPreset()->settings()->paintOpSize() : 1.0;
+
+        const qreal margin = 0.5 * m_predictedSegmentWidth + 2.0;
+        m_predictedSegmentRect =
+            QRectF(m_predictedSegment->p1(), m_predictedSegment->p2()).normalized()
+                .adjusted(-margin, -margin, margin, margin);
+    }
+
+    if (!oldRect.isEmpty() || !m_predictedSegmentRect.isEmpty()) {
+        updateCanvasPixelRect(oldRect | m_predictedSegmentRect);
+    }
+}
+
+void KisToolFreehand::clearPredictedSegment()
+{
+    if (!m_predictedSegmentRect.isEmpty()) {
+        updateCanvasPixelRect(m_predictedSegmentRect);
+    }
+
+    m_predictedSegment = std::nullopt;
+    m_predictedSegmentRect = QRectF();
 }
 
 void KisToolFreehand::endPrimaryAction(KoPointerEvent *event)
@@ -254,6 +357,10 @@ void KisToolFreehand::endPrimaryAction(KoPointerEvent *event)
     Q_UNUSED(event);
     CHECK_MODE_SANITY_OR_RETURN(KisTool::PAINT_MODE);
 
+    m_delayedOutlineUpdateTimer.stop();
+    m_pendingOutlineEvent.reset();
+    m_outlineUpdateTime.invalidate();
+
     endStroke();
 
     if (m_assistant && static_cast<KisCanvas2*>(canvas())->paintingAssistantsDecoration()) {
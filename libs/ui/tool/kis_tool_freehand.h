@@ -7,6 +7,10 @@
 #ifndef KIS_TOOL_FREEHAND_H_
 #define KIS_TOOL_FREEHAND_H_
 
+#include <QElapsedTimer>
+#include <QLineF>
+#include <QTimer>
+
 #include <brushengine/kis_paint_information.h>
 #include <brushengine/kis_paintop_settings.h>
 #include <kis_distance_information.h>
@@ -37,6 +41,7 @@ public:
     ~KisToolFreehand() override;
     int flags() const override;
     void mouseMoveEvent(KoPointerEvent *event) override;
+    void paint(QPainter &gc, const KoViewConverter &converter) override;
     
 
 public Q_SLOTS:
@@ -95,14 +100,29 @@ private:
      */
     QPointF adjustPosition(const QPointF& point, const QPointF& strokeBegin);
 
+    /**
+     * Updates the throwaway preview of the predicted part of the
+     * stroke. The preview is replaced by the real stroke on the
+     * next event.
+     */
+    void updatePredictedSegment();
+    void clearPredictedSegment();
+
     /**
      * Calculates a coefficient for KisPaintInformation
      * according to perspective grid values
      */
     qreal calculatePerspective(const QPointF &documentPoint);
 
+    /**
+     * Updates the brush outline while painting, but not more often
+     * than the screen can show it
+     */
+    void updateOutlineWhilePainting(KoPointerEvent *event);
+
 private Q_SLOTS:
     void updateMaskSyntheticEventsFromTouch();
+    void slotDelayedOutlineUpdate();
 
 protected:
     friend class KisViewManager;
@@ -126,6 +146,15 @@ private:
     KisSignalCompressorWithParam<qreal> m_brushResizeCompressor;
 
     std::optional<KoPointerEventWrapper> m_beginAlternateActionEvent;
+
+    QElapsedTimer m_outlineUpdateTime;
+    QTimer m_delayedOutlineUpdateTimer;
+    std::optional<KoPointerEventWrapper> m_pendingOutlineEvent;
+
+    int m_strokePredictionTime {0};
+    std::optional<QLineF> m_predictedSegment;
+    QRectF m_predictedSegmentRect;
+    qreal m_predictedSegmentWidth {0.0};
 };
 
 
@@ -9,6 +9,8 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QQueue>
+#include <QDateTime>
+#include <QDir>
 
 #include <klocalizedstring.h>
 
@@ -26,6 +28,8 @@
 #include "kis_update_time_monitor.h"
 #include "kis_stabilized_events_sampler.h"
 #include "KisStabilizerDelayedPaintHelper.h"
+#include "KisStrokePathPredictor.h"
+#include "KisStrokeRecording.h"
 #include "kis_config.h"
 
 #include "kis_random_source.h"
@@ -54,6 +58,15 @@ const qreal SPACING_UPDATE_INTERVAL = 50.0;
 // used when airbrushing.
 const qreal TIMING_UPDATE_INTERVAL = 50.0;
 
+// The number of the paint jobs waiting in the stroke queue that means
+// that the stroke falls behind the input events. When it happens, the
+// consecutive lines are coalesced into a single job.
+const int COALESCING_BACKLOG_THRESHOLD = 3;
+
+// The max amount of time, in milliseconds, the lines may wait for
+// being coalesced before they are sent to the stroke.
+const int COALESCING_LATENCY_BUDGET = 8;
+
 struct KisToolFreehandHelper::Private
 {
     KoCanvasResourceProvider *resourceManager;
@@ -80,6 +93,7 @@ struct KisToolFreehandHelper::Private
 
     QPointF lastDrawnPixel;
     QPointF waitingPixel;
+    QPointF lastPrefetchPos;
     bool hasLastDrawnPixel;
     int pixelInLineCount;
 
@@ -108,9 +122,31 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    KisStrokePathPredictor pathPredictor;
+
+    // Recording of the strokes for the brush benchmarks
+    QString strokeRecordingDirectory;
+    KisStrokeRecording strokeRecording;
+
+    // Lines coalescing data
+    QSharedPointer<QAtomicInt> pendingJobsCounter;
+    QVector<KisPaintInformation> coalescedLines;
+    int coalescedStrokeInfoId {0};
+    QElapsedTimer coalescingTime;
+    QTimer coalescingTimer;
+
     qreal effectiveSmoothnessDistance(qreal speed) const;
+    void addPaintJob(FreehandStrokeStrategy::Data *data);
 };
 
+void KisToolFreehandHelper::Private::addPaintJob(FreehandStrokeStrategy::Data *data)
+{
+    data->pendingJobsCounter = pendingJobsCounter;
+    pendingJobsCounter->ref();
+
+    strokesFacade->addJob(strokeId, data);
+}
+
 
 KisToolFreehandHelper::KisToolFreehandHelper(KisPaintingInformationBuilder *infoBuilder,
                                              KoCanvasResourceProvider *resourceManager,
@@ -127,8 +163,12 @@ KisToolFreehandHelper::KisToolFreehandHelper(KisPaintingInformationBuilder *info
     m_d->fakeDabRandomSource = new KisRandomSource();
     m_d->fakeStrokeRandomSource = new KisPerStrokeRandomSource();
 
+    m_d->pendingJobsCounter.reset(new QAtomicInt(0));
+
     m_d->strokeTimeoutTimer.setSingleShot(true);
     connect(&m_d->strokeTimeoutTimer, SIGNAL(timeout()), SLOT(finishStroke()));
+    m_d->coalescingTimer.setSingleShot(true);
+    connect(&m_d->coalescingTimer, SIGNAL(timeout()), SLOT(flushCoalescedLines()));
     connect(&m_d->airbrushingTimer, SIGNAL(timeout()), SLOT(doAirbrushing()));
     connect(&m_d->stabilizerPollTimer, SIGNAL(timeout()), SLOT(stabilizerPollAndPaint()));
     connect(m_d->smoothingOptions.data(), SIGNAL(sigSmoothingTypeChanged()), SLOT(slotSmoothingTypeChanged()));
@@ -291,6 +331,16 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
     m_d->hasPaintAtLeastOnce = false;
 
     m_d->previousPaintInformation = pi;
+    m_d->lastPrefetchPos = pi.pos();
+
+    m_d->pathPredictor.clear();
+    m_d->pathPredictor.addEvent(pi.pos(), pi.currentTime());
+
+    m_d->strokeRecordingDirectory = KisConfig(true).strokeRecordingDirectory();
+    m_d->strokeRecording.clear();
+    if (!m_d->strokeRecordingDirectory.isEmpty()) {
+        m_d->strokeRecording.addEvent(pi);
+    }
 
     m_d->resources = new KisResourcesSnapshot(image,
                                               currentNode,
@@ -321,6 +371,7 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
                                    FreehandStrokeStrategy::SupportsTimedMergeId);
 
     m_d->strokeId = m_d->strokesFacade->startStroke(stroke);
+    m_d->pendingJobsCounter.reset(new QAtomicInt(0));
 
     m_d->history.clear();
     m_d->distanceHistory.clear();
@@ -465,9 +516,72 @@ void KisToolFreehandHelper::paintEvent(KoPointerEvent *event)
                                              elapsedStrokeTime());
     KisUpdateTimeMonitor::instance()->reportMouseMove(info.pos());
 
+    prefetchStrokePath(info);
+    m_d->pathPredictor.addEvent(info.pos(), info.currentTime());
+
+    if (!m_d->strokeRecordingDirectory.isEmpty()) {
+        m_d->strokeRecording.addEvent(info);
+    }
+
     paint(info);
 }
 
+std::optional<QLineF> KisToolFreehandHelper::predictedStrokeSegment(qreal lookAheadTime) const
+{
+    /**
+     * The stabilizer lags behind the pen on purpose, predicting
+     * where the pen goes would defeat its purpose
+     */
+    if (!isRunning() ||
+        m_d->smoothingOptions->smoothingType() == KisSmoothingOptions::STABILIZER) {
+
+        return std::nullopt;
+    }
+
+    std::optional<QPointF> predictedPos = m_d->pathPredictor.predict(lookAheadTime);
+    if (!predictedPos) {
+        return std::nullopt;
+    }
+
+    return QLineF(m_d->previousPaintInformation.pos(), *predictedPos);
+}
+
+void KisToolFreehandHelper::prefetchStrokePath(const KisPaintInformation &info)
+{
+    /**
+     * Ask the image to swap in the tiles the stroke is heading to,
+     * so that the stroke would not stop on disk I/O when entering a
+     * swapped-out area. We update the hint only every half a tile,
+     * because the direction of the stroke doesn't change that fast.
+     */
+    const qreal hintStep = 32.0;
+    const qreal lookAheadDistance = 256.0;
+
+    const QPointF offset = info.pos() - m_d->lastPrefetchPos;
+    if (KisAlgebra2D::norm(offset) < hintStep) return;
+
+    const QPointF direction = info.pos() - m_d->previousPaintInformation.pos();
+    const qreal directionLength = KisAlgebra2D::norm(direction);
+    if (directionLength < 1e-3) return;
+
+    m_d->lastPrefetchPos = info.pos();
+
+    const QPointF predictedPos = info.pos() + direction / directionLength * lookAheadDistance;
+
+    qreal brushSize = 0.0;
+    KisPaintOpPresetSP preset = m_d->resources->currentPaintOpPreset();
+    if (preset && preset->settings()) {
+        brushSize = preset->settings()->paintOpSize();
+    }
+
+    const QRect hotRect =
+        QRectF(info.pos(), predictedPos).normalized()
+            .adjusted(-brushSize, -brushSize, brushSize, brushSize)
+            .toAlignedRect();
+
+    m_d->resources->image()->requestTilePrefetch(hotRect, m_d->resources->currentNode());
+}
+
 
 void KisToolFreehandHelper::paint(KisPaintInformation &info)
 { 
@@ -707,6 +821,8 @@ void KisToolFreehandHelper::endPaint()
      */
     m_d->strokeInfos.clear();
 
+    flushCoalescedLines();
+
     // last update to complete rendering if there is still something pending
     m_d->strokesFacade->addJob(m_d->strokeId,
        new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
@@ -714,6 +830,17 @@ void KisToolFreehandHelper::endPaint()
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
     m_d->infoBuilder->reset();
+
+    if (!m_d->strokeRecordingDirectory.isEmpty() && !m_d->strokeRecording.isEmpty()) {
+        const QString fileName =
+            QDir(m_d->strokeRecordingDirectory).filePath(
+                "stroke-" +
+                QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") +
+                KisStrokeRecording::fileExtension());
+
+        m_d->strokeRecording.save(fileName);
+        m_d->strokeRecording.clear();
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -738,6 +865,10 @@ void KisToolFreehandHelper::cancelPaint()
         m_d->stabilizerDelayedPaintHelper.cancel();
     }
 
+    m_d->coalescingTimer.stop();
+    m_d->coalescedLines.clear();
+    m_d->strokeRecording.clear();
+
     // see a comment in endPaint()
     m_d->strokeInfos.clear();
 
@@ -982,12 +1113,30 @@ qreal KisToolFreehandHelper::currentPhysicalZoom() const
     return m_d->resourceManager ? m_d->resourceManager->resource(KoCanvasResource::EffectivePhysicalZoom).toReal() : 1.0;
 }
 
+void KisToolFreehandHelper::flushCoalescedLines()
+{
+    m_d->coalescingTimer.stop();
+
+    if (m_d->coalescedLines.isEmpty()) return;
+
+    if (m_d->coalescedLines.size() == 2) {
+        m_d->addPaintJob(new FreehandStrokeStrategy::Data(m_d->coalescedStrokeInfoId,
+                                                     m_d->coalescedLines[0],
+                                                     m_d->coalescedLines[1]));
+    } else {
+        m_d->addPaintJob(new FreehandStrokeStrategy::Data(m_d->coalescedStrokeInfoId,
+                                                     m_d->coalescedLines));
+    }
+
+    m_d->coalescedLines.clear();
+}
+
 void KisToolFreehandHelper::paintAt(int strokeInfoId,
                                     const KisPaintInformation &pi)
 {
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId, pi));
+    flushCoalescedLines();
+    m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
 }
 
@@ -996,9 +1145,45 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
                                       const KisPaintInformation &pi2)
 {
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
+    /**
+     * When the stroke keeps up with the input events, every line is
+     * sent to it right away. Otherwise the consecutive lines are
+     * collected into a chain, which is sent as a single job when the
+     * stroke catches up or the latency budget is exhausted. The lines
+     * of the chain are painted one by one with the same distance
+     * information, so the dabs stay exactly the same.
+     */
+
+    if (!m_d->coalescedLines.isEmpty() &&
+        (m_d->coalescedStrokeInfoId != strokeInfoId ||
+         m_d->coalescedLines.last().pos() != pi1.pos())) {
+
+        flushCoalescedLines();
+    }
+
+    const bool strokeFallsBehind =
+        m_d->pendingJobsCounter->loadAcquire() >= COALESCING_BACKLOG_THRESHOLD;
+
+    if (m_d->coalescedLines.isEmpty()) {
+        if (!strokeFallsBehind) {
+            m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
+            return;
+        }
+
+        m_d->coalescedStrokeInfoId = strokeInfoId;
+        m_d->coalescedLines.append(pi1);
+        m_d->coalescingTime.start();
+        m_d->coalescingTimer.start(COALESCING_LATENCY_BUDGET);
+    }
+
+    m_d->coalescedLines.append(pi2);
+
+    if (!strokeFallsBehind ||
+        m_d->coalescingTime.elapsed() >= COALESCING_LATENCY_BUDGET) {
+
+        flushCoalescedLines();
+    }
 }
 
 void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
@@ -1033,9 +1218,9 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
 #endif
 
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId,
-                                                                pi1, control1, control2, pi2));
+    flushCoalescedLines();
+    m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId,
+                                                 pi1, control1, control2, pi2));
 
 }
 
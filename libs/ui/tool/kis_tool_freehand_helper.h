@@ -7,9 +7,12 @@
 #ifndef __KIS_TOOL_FREEHAND_HELPER_H
 #define __KIS_TOOL_FREEHAND_HELPER_H
 
+#include <QLineF>
 #include <QObject>
 #include <QVector>
 
+#include <optional>
+
 #include "kis_types.h"
 #include "kritaui_export.h"
 #include <brushengine/kis_paint_information.h>
@@ -81,6 +84,15 @@ Q_SIGNALS:
      */
     void requestExplicitUpdateOutline();
 
+    /**
+     * @return the segment from the last painted position to the
+     *         position of the pen predicted \p lookAheadTime
+     *         milliseconds ahead, or nothing if the pen movement
+     *         is not predictable. The segment is meant for a
+     *         throwaway preview only.
+     */
+    std::optional<QLineF> predictedStrokeSegment(qreal lookAheadTime) const;
+
 protected:
     void cancelPaint();
     int elapsedStrokeTime() const;
@@ -139,11 +151,14 @@ private:
                                                const KisPaintInformation &lastPaintInfo);
     int computeAirbrushTimerInterval() const;
 
+    void prefetchStrokePath(const KisPaintInformation &info);
+
     qreal currentZoom() const;
     qreal currentPhysicalZoom() const;
 
 private Q_SLOTS:
     void finishStroke();
+    void flushCoalescedLines();
     void doAirbrushing();
     void stabilizerPollAndPaint();
     void slotSmoothingTypeChanged();
@@ -10,7 +10,7 @@
 #include <KoMixColorsOp.h>
 #include <kis_group_layer.h>
 #include <kis_transaction.h>
-#include <kis_sequential_iterator.h>
+#include <kis_random_accessor_ng.h>
 #include <kis_properties_configuration.h>
 #include <kconfiggroup.h>
 #include <ksharedconfig.h>
@@ -34,6 +34,7 @@
 #include "KisAnimAutoKey.h"
 
 #include <QApplication>
+#include <QtMath>
 
 namespace KisToolUtils {
 
@@ -61,20 +62,34 @@ namespace KisToolUtils {
         if (!pure && radius > 1) {
             QScopedPointer<KoMixColorsOp::Mixer> mixer(cs->mixColorsOp()->createMixer());
 
-            QVector<const quint8*> pixels;
             const int effectiveRadius = radius - 1;
-
-            const QRect sampleRect(pos.x() - effectiveRadius, pos.y() - effectiveRadius,
-                                 2 * effectiveRadius + 1, 2 * effectiveRadius + 1);
-            KisSequentialConstIterator it(dev, sampleRect);
-
             const int radiusSq = pow2(effectiveRadius);
 
-            int nConseqPixels = it.nConseqPixels();
-            while (it.nextPixels(nConseqPixels)) {
-                const QPoint realPos(it.x(),  it.y());
-                if (kisSquareDistance(realPos, pos) < radiusSq) {
-                    mixer->accumulateAverage(it.oldRawData(), nConseqPixels);
+            /**
+             * Every row of the sampled circle is a contiguous chord, so
+             * the pixels are passed to the mixer in runs limited by the
+             * chord and the tile borders only. The mixer accumulates the
+             * whole run in a single call.
+             */
+            KisRandomConstAccessorSP accessor = dev->createRandomConstAccessorNG();
+
+            for (int dy = -effectiveRadius; dy <= effectiveRadius; dy++) {
+                const int maxDxSq = radiusSq - pow2(dy);
+                if (maxDxSq <= 0) continue;
+
+                // the largest dx such that dx^2 + dy^2 < radius^2
+                int halfWidth = qFloor(std::sqrt(qreal(maxDxSq - 1)));
+                while (pow2(halfWidth + 1) < maxDxSq) halfWidth++;
+                while (halfWidth > 0 && pow2(halfWidth) >= maxDxSq) halfWidth--;
+
+                const int y = pos.y() + dy;
+                const int right = pos.x() + halfWidth;
+
+                for (int x = pos.x() - halfWidth; x <= right;) {
+                    const int numPixels = qMin(accessor->numContiguousColumns(x), right - x + 1);
+                    accessor->moveTo(x, y);
+                    mixer->accumulateAverage(accessor->oldRawData(), numPixels);
+                    x += numPixels;
                 }
             }
 
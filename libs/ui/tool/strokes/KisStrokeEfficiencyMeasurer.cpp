@@ -30,6 +30,10 @@ struct KisStrokeEfficiencyMeasurer::Private
 
     int framesCount = 0;
 
+    int paintJobsCount = 0;
+    qint64 paintJobsTime = 0; // ns
+    int maxQueueBacklog = 0;
+    int updatesCount = 0;
 };
 
 KisStrokeEfficiencyMeasurer::KisStrokeEfficiencyMeasurer()
@@ -98,6 +102,42 @@ void KisStrokeEfficiencyMeasurer::notifyFrameRenderingStarted()
     m_d->framesCount++;
 }
 
+void KisStrokeEfficiencyMeasurer::addPaintJob(qint64 nsecs, int queueBacklog)
+{
+    if (!m_d->isEnabled) return;
+
+    m_d->paintJobsCount++;
+    m_d->paintJobsTime += nsecs;
+    m_d->maxQueueBacklog = qMax(m_d->maxQueueBacklog, queueBacklog);
+}
+
+void KisStrokeEfficiencyMeasurer::notifyUpdateIssued()
+{
+    if (!m_d->isEnabled) return;
+
+    m_d->updatesCount++;
+}
+
+int KisStrokeEfficiencyMeasurer::paintJobsCount() const
+{
+    return m_d->paintJobsCount;
+}
+
+qreal KisStrokeEfficiencyMeasurer::averagePaintJobTime() const
+{
+    return m_d->paintJobsCount ? m_d->paintJobsTime / 1e6 / m_d->paintJobsCount : 0.0;
+}
+
+int KisStrokeEfficiencyMeasurer::maxQueueBacklog() const
+{
+    return m_d->maxQueueBacklog;
+}
+
+int KisStrokeEfficiencyMeasurer::updatesCount() const
+{
+    return m_d->updatesCount;
+}
+
 qreal KisStrokeEfficiencyMeasurer::averageCursorSpeed() const
 {
     return m_d->cursorMoveTime ? m_d->distance / m_d->cursorMoveTime : 0.0;
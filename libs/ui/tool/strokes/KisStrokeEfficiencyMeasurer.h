@@ -38,6 +38,23 @@ public:
 
     void notifyFrameRenderingStarted();
 
+    /**
+     * Accounts a single paint job of the stroke (a line, a curve etc.)
+     * that took \p nsecs to render, while \p queueBacklog jobs of the
+     * stroke were still waiting in the queue.
+     */
+    void addPaintJob(qint64 nsecs, int queueBacklog);
+
+    /**
+     * Accounts a batch of dirty rects passed to the image for merging
+     */
+    void notifyUpdateIssued();
+
+    int paintJobsCount() const;
+    qreal averagePaintJobTime() const; // ms
+    int maxQueueBacklog() const;
+    int updatesCount() const;
+
     void reset();
 
 private:
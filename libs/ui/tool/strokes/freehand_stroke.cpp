@@ -97,10 +97,17 @@ FreehandStrokeStrategy::FreehandStrokeStrategy(const FreehandStrokeStrategy &rhs
 
 FreehandStrokeStrategy::~FreehandStrokeStrategy()
 {
+    KisStrokeSpeedMonitor::StrokeStats stats;
+    stats.paintJobs = m_d->efficiencyMeasurer.paintJobsCount();
+    stats.avgPaintJobTime = m_d->efficiencyMeasurer.averagePaintJobTime();
+    stats.maxQueueBacklog = m_d->efficiencyMeasurer.maxQueueBacklog();
+    stats.updates = m_d->efficiencyMeasurer.updatesCount();
+
     KisStrokeSpeedMonitor::instance()->notifyStrokeFinished(m_d->efficiencyMeasurer.averageCursorSpeed(),
                                                             m_d->efficiencyMeasurer.averageRenderingSpeed(),
                                                             m_d->efficiencyMeasurer.averageFps(),
-                                                            m_d->resources->currentPaintOpPreset());
+                                                            m_d->resources->currentPaintOpPreset(),
+                                                            stats);
 
     KisUpdateTimeMonitor::instance()->endStrokeMeasure();
 }
@@ -155,6 +162,11 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         KisRandomSourceSP rnd = m_d->randomSource.source();
         KisPerStrokeRandomSourceSP strokeRnd = m_d->randomSource.perStrokeSource();
 
+        QElapsedTimer jobTime;
+        if (m_d->efficiencyMeasurer.isEnabled()) {
+            jobTime.start();
+        }
+
         switch(d->type) {
         case Data::POINT:
             d->pi1.setRandomSource(rnd);
@@ -170,6 +182,16 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             maskedPainter->paintLine(d->pi1, d->pi2);
             m_d->efficiencyMeasurer.addSample(d->pi2.pos());
             break;
+        case Data::LINE_CHAIN:
+            for (int i = 0; i < d->paintInfos.size(); i++) {
+                d->paintInfos[i].setRandomSource(rnd);
+                d->paintInfos[i].setPerStrokeRandomSource(strokeRnd);
+            }
+            for (int i = 1; i < d->paintInfos.size(); i++) {
+                maskedPainter->paintLine(d->paintInfos[i - 1], d->paintInfos[i]);
+                m_d->efficiencyMeasurer.addSample(d->paintInfos[i].pos());
+            }
+            break;
         case Data::CURVE:
             d->pi1.setRandomSource(rnd);
             d->pi2.setRandomSource(rnd);
@@ -212,6 +234,15 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             break;
         };
 
+        if (jobTime.isValid()) {
+            m_d->efficiencyMeasurer.addPaintJob(jobTime.nsecsElapsed(),
+                d->pendingJobsCounter ? d->pendingJobsCounter->loadAcquire() - 1 : 0);
+        }
+
+        if (d->pendingJobsCounter) {
+            d->pendingJobsCounter->deref();
+        }
+
         tryDoUpdate();
     } else {
         KisPainterBasedStrokeStrategy::doStrokeCallback(data);
@@ -280,6 +311,8 @@ void FreehandStrokeStrategy::tryDoUpdate(bool forceEnd)
 
 void FreehandStrokeStrategy::issueSetDirtySignals()
 {
+    m_d->efficiencyMeasurer.notifyUpdateIssued();
+
     QVector<QRect> dirtyRects;
 
     for (int i = 0; i < numMaskedPainters(); i++) {
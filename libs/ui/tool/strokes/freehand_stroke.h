@@ -8,7 +8,10 @@
 #define __FREEHAND_STROKE_H
 
 
+#include <QAtomicInt>
 #include <QPen>
+#include <QSharedPointer>
+#include <QVector>
 #include "kritaui_export.h"
 #include "kis_types.h"
 #include "kis_node.h"
@@ -36,6 +39,7 @@ public:
         enum DabType {
             POINT,
             LINE,
+            LINE_CHAIN,
             CURVE,
             POLYLINE,
             POLYGON,
@@ -61,6 +65,17 @@ public:
               type(LINE), pi1(_pi1), pi2(_pi2)
         {}
 
+        /**
+         * A chain of consecutive lines, painted exactly as if every
+         * line were passed in a separate LINE job
+         */
+        Data(int _strokeInfoId,
+             const QVector<KisPaintInformation> &_paintInfos)
+            : KisStrokeJobData(KisStrokeJobData::UNIQUELY_CONCURRENT),
+              strokeInfoId(_strokeInfoId),
+              type(LINE_CHAIN), paintInfos(_paintInfos)
+        {}
+
         Data(int _strokeInfoId,
              const KisPaintInformation &_pi1,
              const QPointF &_control1,
@@ -107,7 +122,13 @@ public:
         {}
 
         KisStrokeJobData* createLodClone(int levelOfDetail) override {
-            return new Data(*this, levelOfDetail);
+            Data *clone = new Data(*this, levelOfDetail);
+
+            // the lod clone is executed first, so it is the one
+            // which reports that the job is not pending anymore
+            clone->pendingJobsCounter.swap(pendingJobsCounter);
+
+            return clone;
         }
 
     private:
@@ -126,6 +147,12 @@ public:
                 pi1 = t.map(rhs.pi1);
                 pi2 = t.map(rhs.pi2);
                 break;
+            case Data::LINE_CHAIN:
+                paintInfos.reserve(rhs.paintInfos.size());
+                Q_FOREACH (const KisPaintInformation &pi, rhs.paintInfos) {
+                    paintInfos.append(t.map(pi));
+                }
+                break;
             case Data::CURVE:
                 pi1 = t.map(rhs.pi1);
                 pi2 = t.map(rhs.pi2);
@@ -164,6 +191,7 @@ public:
         DabType type;
         KisPaintInformation pi1;
         KisPaintInformation pi2;
+        QVector<KisPaintInformation> paintInfos;
         QPointF control1;
         QPointF control2;
 
@@ -172,6 +200,14 @@ public:
         QPainterPath path;
         QPen pen;
         KoColor customColor;
+
+        /**
+         * The counter of the jobs that have been added to the stroke,
+         * but not yet executed. It is decremented when the job is
+         * executed. The freehand helper uses it to detect that the
+         * stroke falls behind the input events.
+         */
+        QSharedPointer<QAtomicInt> pendingJobsCounter;
     };
 
 public:
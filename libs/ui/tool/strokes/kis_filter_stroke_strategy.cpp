@@ -22,6 +22,9 @@
 #include "KisAnimAutoKey.h"
 #include <commands_new/KisDisableDirtyRequestsCommand.h>
 
+#include <QMutex>
+#include <QMutexLocker>
+
 
 struct KisFilterStrokeStrategy::Private {
     Private()
@@ -57,6 +60,15 @@ struct KisFilterStrokeStrategy::Private {
     ExternalCancelUpdatesStorageSP cancelledUpdates;
     QRect nextExternalUpdateRect;
     bool hasBeenLodCloned = false;
+
+    /**
+     * The progress helper of the frame being processed right now. It
+     * is accessed by the GUI thread on the cancellation, so it is
+     * guarded by the lock.
+     */
+    QMutex progressHelperLock;
+    QSharedPointer<KisProcessingVisitor::ProgressHelper> progressHelper;
+    QAtomicInt isCancelled;
 };
 
 struct SubTaskSharedData {
@@ -205,6 +217,12 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         QSharedPointer<SubTaskSharedData> shared( new SubTaskSharedData(m_d->image, m_d->node, m_d->levelOfDetail,
                                                                         m_d->activeSelection, m_d->filter, m_d->filterConfig, filterFrameData) );
         QSharedPointer<KisProcessingVisitor::ProgressHelper> progress( new KisProcessingVisitor::ProgressHelper(m_d->node) );
+
+        {
+            QMutexLocker l(&m_d->progressHelperLock);
+            m_d->progressHelper = progress;
+        }
+
         addJobSequential(jobs, [this, shared, progress](){
             // Switch time if necessary..
             if (shared->shouldSwitchTime()) {
@@ -253,7 +271,15 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
 
                 Q_FOREACH (const QRect &patch, patches) {
                     if (!patch.isEmpty()) {
-                        addJobConcurrent(processJobs, [patch, shared, progress](){
+                        addJobConcurrent(processJobs, [this, patch, shared, progress](){
+                            /**
+                             * The queued patches are dropped on the cancellation,
+                             * but the ones that have already been picked up by
+                             * the workers would still be processed, delaying the
+                             * preview with the new settings.
+                             */
+                            if (m_d->isCancelled.loadAcquire()) return;
+
                             shared->filter()->processImpl(shared->filterDevice, patch,
                                                           shared->filterConfig().data(),
                                                           progress->updater());
@@ -279,6 +305,8 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             runAndSaveCommand(toQShared(shared->filterDeviceTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::NORMAL);
             shared->filterDeviceTransaction.reset();
 
+            if (m_d->isCancelled.loadAcquire()) return;
+
             if (!shared->filterDeviceBounds.intersects(
                     shared->filter()->neededRect(shared->processRect, shared->filterConfig().data(), shared->levelOfDetail()))) {
                 return;
@@ -363,6 +391,23 @@ void KisFilterStrokeStrategy::cancelStrokeCallback()
     addMutatedJobs(jobs);
 }
 
+void KisFilterStrokeStrategy::tryCancelCurrentStrokeJobAsync()
+{
+    // NOTE: this method may be called by the GUI thread asynchronously!
+    m_d->isCancelled.ref();
+
+    QSharedPointer<KisProcessingVisitor::ProgressHelper> helper;
+
+    {
+        QMutexLocker l(&m_d->progressHelperLock);
+        helper = m_d->progressHelper;
+    }
+
+    if (helper) {
+        helper->cancel();
+    }
+}
+
 void KisFilterStrokeStrategy::finishStrokeCallback()
 {
     KisStrokeStrategyUndoCommandBased::finishStrokeCallback();
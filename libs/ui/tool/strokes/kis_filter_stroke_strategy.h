@@ -95,6 +95,8 @@ public:
     void cancelStrokeCallback() override;
     void finishStrokeCallback() override;
 
+    void tryCancelCurrentStrokeJobAsync() override;
+
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
 private:
@@ -115,6 +115,17 @@ void PerspectiveAssistant::adjustLine(QPointF &point, QPointF &strokeBegin)
     point = project(point, strokeBegin, true, 0.0);
 }
 
+bool PerspectiveAssistant::canSnapStrokeFrom(const QPointF &strokeBegin) const
+{
+    // the grid snaps only the strokes started inside it, see project()
+    QPolygonF poly;
+    QTransform transform;
+
+    return isAssistantComplete() &&
+        getTransform(poly, transform) &&
+        poly.containsPoint(strokeBegin, Qt::OddEvenFill);
+}
+
 void PerspectiveAssistant::endStroke()
 {
     m_snapLine = QLineF();
@@ -27,6 +27,7 @@ public:
 
     QPointF adjustPosition(const QPointF& point, const QPointF& strokeBegin, const bool snapToAny, qreal moveThresholdPt) override;
     void adjustLine(QPointF &point, QPointF& strokeBegin) override;
+    bool canSnapStrokeFrom(const QPointF &strokeBegin) const override;
     void endStroke() override;
 
     QPointF getDefaultEditorPosition() const override;
@@ -13,6 +13,7 @@
 #include <kis_assert.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsMatrixShaperTransformation.h"
 
 // -- KoLcmsColorConversionTransformation --
 
@@ -37,12 +38,28 @@ public:
         }
         conversionFlags |= KoColorConversionTransformation::CopyAlpha;
 
+        /**
+         * The transformations from and to CMYK are built on a 4D lookup
+         * table, which is very expensive to create. Without the 1-pixel
+         * cache LCMS can run the transformation from any number of
+         * threads at once, so a single instance can be shared by all the
+         * threads instead of creating one per thread.
+         */
+        cmsUInt32Number cmsFlags = conversionFlags;
+
+        if (srcCs->colorModelId() == CMYKAColorModelID ||
+            dstCs->colorModelId() == CMYKAColorModelID) {
+
+            cmsFlags |= cmsFLAGS_NOCACHE;
+            m_isReentrant = true;
+        }
+
         m_transform = cmsCreateTransform(srcProfile->lcmsProfile(),
                                          srcColorSpaceType,
                                          dstProfile->lcmsProfile(),
                                          dstColorSpaceType,
                                          renderingIntent,
-                                         conversionFlags);
+                                         cmsFlags);
 
         Q_ASSERT(m_transform);
     }
@@ -61,8 +78,15 @@ public:
         cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
 
     }
+
+    bool isReentrant() const override
+    {
+        return m_isReentrant;
+    }
+
 private:
     mutable cmsHTRANSFORM m_transform;
+    bool m_isReentrant {false};
 };
 
 class KoLcmsColorProofingConversionTransformation : public KoColorProofingConversionTransformation
@@ -255,6 +279,17 @@ KoColorConversionTransformation *IccColorSpaceEngine::createColorTransformation(
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(srcColorSpace->profile()));
     KIS_ASSERT(dynamic_cast<const IccColorProfile *>(dstColorSpace->profile()));
 
+    /**
+     * Conversions between two RGB matrix-shaper profiles are just
+     * a matrix and a couple of curves, which we can do much faster
+     * than LCMS does
+     */
+    KoColorConversionTransformation *matrixShaperTransform =
+        createLcmsMatrixShaperTransformation(srcColorSpace, dstColorSpace, renderingIntent, conversionFlags);
+    if (matrixShaperTransform) {
+        return matrixShaperTransform;
+    }
+
     return new KoLcmsColorConversionTransformation(
                 srcColorSpace, computeColorSpaceType(srcColorSpace),
                 dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
@@ -16,6 +16,7 @@
 
 #include "colorprofiles/LcmsColorProfileContainer.h"
 #include "kis_assert.h"
+#include "LcmsPerChannelLutTransformation.h"
 
 
 class LcmsColorProfileContainer;
@@ -356,7 +357,8 @@ public:
 
         delete [] transferFunctions;
         delete [] alphaTransferFunctions;
-        return adj;
+
+        return bakePerChannelAdjustment<typename _CSTraits::channels_type>(adj, _CSTraits::channels_nb);
     }
 
     quint8 difference(const quint8 *src1, const quint8 *src2) const override
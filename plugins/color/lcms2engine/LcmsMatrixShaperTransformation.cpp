@@ -0,0 +1,273 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "LcmsMatrixShaperTransformation.h"
+
+#include <lcms2.h>
+
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+
+#include "IccColorProfile.h"
+#include "LcmsColorProfileContainer.h"
+#include "LcmsMatrixShaperTransformationFactoryImpl.h"
+
+namespace {
+
+/**
+ * The curves we can evaluate in closed form. Profiles with any other
+ * TRC (tabulated curves which are not close to one of these, PQ-like
+ * curves stored as LUTs, etc.) keep going through LCMS.
+ */
+const LcmsParametricCurve knownCurves[] = {
+    // linear
+    LcmsParametricCurve::fromParameters(1.0f, 1.0f, 0.0f, 1.0f, 0.0f),
+    // sRGB (IEC 61966-2.1)
+    LcmsParametricCurve::fromParameters(2.4f, 1.0f / 1.055f, 0.055f / 1.055f, 1.0f / 12.92f, 0.04045f),
+    // Rec. 709 / Rec. 2020 10-bit
+    LcmsParametricCurve::fromParameters(1.0f / 0.45f, 1.0f / 1.099f, 0.099f / 1.099f, 1.0f / 4.5f, 0.081f),
+    // ProPhoto
+    LcmsParametricCurve::fromParameters(1.8f, 1.0f, 0.0f, 1.0f / 16.0f, 16.0f / 512.0f),
+    // pure gamma curves
+    LcmsParametricCurve::fromParameters(1.8f, 1.0f, 0.0f, 0.0f, 0.0f),
+    LcmsParametricCurve::fromParameters(2.2f, 1.0f, 0.0f, 0.0f, 0.0f),
+    LcmsParametricCurve::fromParameters(563.0f / 256.0f, 1.0f, 0.0f, 0.0f, 0.0f),
+    LcmsParametricCurve::fromParameters(2.4f, 1.0f, 0.0f, 0.0f, 0.0f),
+};
+
+/**
+ * Max allowed difference between the profile's curve and the
+ * closed form one. Two 16-bit LSBs are enough for the tabulated
+ * versions of the curves to be recognized too.
+ */
+const float curveTolerance = 2.0f / 65535.0f;
+
+bool curveMatches(const cmsToneCurve *trc, const LcmsParametricCurve &curve)
+{
+    const int numSamples = 64;
+
+    for (int i = 0; i < numSamples; i++) {
+        const float x = float(i) / (numSamples - 1);
+        if (std::fabs(cmsEvalToneCurveFloat(trc, x) - curve.linearize(x)) > curveTolerance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool detectCurve(cmsHPROFILE profile, LcmsParametricCurve *curve)
+{
+    const cmsToneCurve *redTRC = static_cast<const cmsToneCurve *>(cmsReadTag(profile, cmsSigRedTRCTag));
+    const cmsToneCurve *greenTRC = static_cast<const cmsToneCurve *>(cmsReadTag(profile, cmsSigGreenTRCTag));
+    const cmsToneCurve *blueTRC = static_cast<const cmsToneCurve *>(cmsReadTag(profile, cmsSigBlueTRCTag));
+
+    if (!redTRC || !greenTRC || !blueTRC) {
+        return false;
+    }
+
+    for (const LcmsParametricCurve &knownCurve : knownCurves) {
+        if (curveMatches(redTRC, knownCurve) &&
+            curveMatches(greenTRC, knownCurve) &&
+            curveMatches(blueTRC, knownCurve)) {
+
+            *curve = knownCurve;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Reads the RGB -> PCS (D50) matrix of a matrix-shaper profile.
+ * The result is row-major, i.e. the columns are the colorants.
+ */
+bool readColorantMatrix(cmsHPROFILE profile, double *m)
+{
+    const cmsCIEXYZ *red = static_cast<const cmsCIEXYZ *>(cmsReadTag(profile, cmsSigRedColorantTag));
+    const cmsCIEXYZ *green = static_cast<const cmsCIEXYZ *>(cmsReadTag(profile, cmsSigGreenColorantTag));
+    const cmsCIEXYZ *blue = static_cast<const cmsCIEXYZ *>(cmsReadTag(profile, cmsSigBlueColorantTag));
+
+    if (!red || !green || !blue) {
+        return false;
+    }
+
+    m[0] = red->X; m[1] = green->X; m[2] = blue->X;
+    m[3] = red->Y; m[4] = green->Y; m[5] = blue->Y;
+    m[6] = red->Z; m[7] = green->Z; m[8] = blue->Z;
+
+    return true;
+}
+
+bool invertMatrix(const double *m, double *inv)
+{
+    const double det =
+        m[0] * (m[4] * m[8] - m[5] * m[7]) -
+        m[1] * (m[3] * m[8] - m[5] * m[6]) +
+        m[2] * (m[3] * m[7] - m[4] * m[6]);
+
+    if (std::fabs(det) < 1e-9) {
+        return false;
+    }
+
+    const double invDet = 1.0 / det;
+
+    inv[0] = (m[4] * m[8] - m[5] * m[7]) * invDet;
+    inv[1] = (m[2] * m[7] - m[1] * m[8]) * invDet;
+    inv[2] = (m[1] * m[5] - m[2] * m[4]) * invDet;
+    inv[3] = (m[5] * m[6] - m[3] * m[8]) * invDet;
+    inv[4] = (m[0] * m[8] - m[2] * m[6]) * invDet;
+    inv[5] = (m[2] * m[3] - m[0] * m[5]) * invDet;
+    inv[6] = (m[3] * m[7] - m[4] * m[6]) * invDet;
+    inv[7] = (m[1] * m[6] - m[0] * m[7]) * invDet;
+    inv[8] = (m[0] * m[4] - m[1] * m[3]) * invDet;
+
+    return true;
+}
+
+bool isSupportedColorSpace(const KoColorSpace *cs)
+{
+    if (cs->colorModelId() != RGBAColorModelID) return false;
+
+    const KoID depthId = cs->colorDepthId();
+
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+bool isIntegerColorSpace(const KoColorSpace *cs)
+{
+    const KoID depthId = cs->colorDepthId();
+    return depthId == Integer8BitsColorDepthID || depthId == Integer16BitsColorDepthID;
+}
+
+cmsHPROFILE lcmsProfileForColorSpace(const KoColorSpace *cs)
+{
+    const IccColorProfile *profile = dynamic_cast<const IccColorProfile *>(cs->profile());
+    return profile && profile->asLcms() ? profile->asLcms()->lcmsProfile() : nullptr;
+}
+
+bool isPlainMatrixShaper(cmsHPROFILE profile, KoColorConversionTransformation::Intent intent, int direction)
+{
+    return cmsGetColorSpace(profile) == cmsSigRgbData &&
+        cmsIsMatrixShaper(profile) &&
+        !cmsIsCLUT(profile, intent, direction);
+}
+
+template<typename src_channels_type>
+struct CreateForSrcChannelType
+{
+    template<typename dst_channels_type>
+    struct CreateForDstChannelType
+    {
+        KoColorConversionTransformation *operator()(const KoColorSpace *srcColorSpace,
+                                                    const KoColorSpace *dstColorSpace,
+                                                    KoColorConversionTransformation::Intent renderingIntent,
+                                                    KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                                    const LcmsMatrixShaperParams *params)
+        {
+            return createOptimizedClass<
+                LcmsMatrixShaperTransformationFactoryImpl<src_channels_type, dst_channels_type>>(
+                srcColorSpace, dstColorSpace, renderingIntent, conversionFlags, *params);
+        }
+    };
+
+    KoColorConversionTransformation *operator()(const KoColorSpace *srcColorSpace,
+                                                const KoColorSpace *dstColorSpace,
+                                                KoColorConversionTransformation::Intent renderingIntent,
+                                                KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                                const LcmsMatrixShaperParams *params)
+    {
+        return channelTypeForColorDepthId<CreateForDstChannelType>(dstColorSpace->colorDepthId(),
+                                                                   srcColorSpace, dstColorSpace,
+                                                                   renderingIntent, conversionFlags,
+                                                                   params);
+    }
+};
+
+} // namespace
+
+KoColorConversionTransformation *createLcmsMatrixShaperTransformation(const KoColorSpace *srcColorSpace,
+                                                                      const KoColorSpace *dstColorSpace,
+                                                                      KoColorConversionTransformation::Intent renderingIntent,
+                                                                      KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    /**
+     * Absolute colorimetric intent needs the white point adaptation,
+     * all the other intents of two matrix-shaper profiles resolve to
+     * the same plain matrix in LCMS
+     */
+    if (renderingIntent == KoColorConversionTransformation::IntentAbsoluteColorimetric) {
+        return nullptr;
+    }
+
+    if (!isSupportedColorSpace(srcColorSpace) || !isSupportedColorSpace(dstColorSpace)) {
+        return nullptr;
+    }
+
+    /**
+     * Float-to-float conversions stay in LCMS: its pipeline keeps
+     * the values unbounded in double precision and gives bit-exact
+     * round trips, which our single precision matrix doesn't
+     */
+    if (!isIntegerColorSpace(srcColorSpace) && !isIntegerColorSpace(dstColorSpace)) {
+        return nullptr;
+    }
+
+    cmsHPROFILE srcProfile = lcmsProfileForColorSpace(srcColorSpace);
+    cmsHPROFILE dstProfile = lcmsProfileForColorSpace(dstColorSpace);
+
+    if (!srcProfile || !dstProfile ||
+        !isPlainMatrixShaper(srcProfile, renderingIntent, LCMS_USED_AS_INPUT) ||
+        !isPlainMatrixShaper(dstProfile, renderingIntent, LCMS_USED_AS_OUTPUT)) {
+
+        return nullptr;
+    }
+
+    LcmsMatrixShaperParams params;
+
+    /**
+     * All the known curves map black to zero, so black point
+     * compensation is a noop for them and can be safely ignored
+     */
+    if (!detectCurve(srcProfile, &params.srcCurve) ||
+        !detectCurve(dstProfile, &params.dstCurve)) {
+
+        return nullptr;
+    }
+
+    double srcToPcs[9];
+    double pcsToDst[9];
+    double dstToPcs[9];
+
+    if (!readColorantMatrix(srcProfile, srcToPcs) ||
+        !readColorantMatrix(dstProfile, dstToPcs) ||
+        !invertMatrix(dstToPcs, pcsToDst)) {
+
+        return nullptr;
+    }
+
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            double value = 0.0;
+            for (int i = 0; i < 3; i++) {
+                value += pcsToDst[row * 3 + i] * srcToPcs[i * 3 + col];
+            }
+            params.matrix[row * 3 + col] = static_cast<float>(value);
+        }
+    }
+
+    return channelTypeForColorDepthId<CreateForSrcChannelType>(srcColorSpace->colorDepthId(),
+                                                               srcColorSpace, dstColorSpace,
+                                                               renderingIntent, conversionFlags,
+                                                               &params);
+}
@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef LCMSMATRIXSHAPERTRANSFORMATION_H
+#define LCMSMATRIXSHAPERTRANSFORMATION_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <KoAlwaysInline.h>
+#include <KoColorConversionTransformation.h>
+
+/**
+ * An ICC parametric curve of type 4 (IEC 61966-2.1 style):
+ *
+ *   Y = (a * X + b) ^ g, for X >= d
+ *   Y = c * X,           for X < d
+ *
+ * Pure gamma curves are represented with c = 0 and d = 0, which
+ * makes negative values clip to zero exactly the way LCMS does.
+ */
+struct LcmsParametricCurve
+{
+    float g {1.0f};
+    float a {1.0f};
+    float b {0.0f};
+    float c {1.0f};
+    float d {0.0f};
+
+    // precalculated values for the inverse curve
+    float invG {1.0f};
+    float invA {1.0f};
+    float invC {1.0f};
+    float threshold {0.0f};
+
+    static LcmsParametricCurve fromParameters(float g, float a, float b, float c, float d)
+    {
+        LcmsParametricCurve curve;
+        curve.g = g;
+        curve.a = a;
+        curve.b = b;
+        curve.c = c;
+        curve.d = d;
+        curve.invG = 1.0f / g;
+        curve.invA = 1.0f / a;
+        curve.invC = c > 0.0f ? 1.0f / c : 0.0f;
+        curve.threshold = c * d;
+        return curve;
+    }
+
+    bool isLinear() const
+    {
+        return g == 1.0f && a == 1.0f && b == 0.0f && c == 1.0f && d == 0.0f;
+    }
+
+    ALWAYS_INLINE float linearize(float x) const
+    {
+        return x < d ? c * x : std::pow(std::max(a * x + b, 0.0f), g);
+    }
+
+    ALWAYS_INLINE float delinearize(float y) const
+    {
+        return y < threshold ? y * invC : (std::pow(std::max(y, 0.0f), invG) - b) * invA;
+    }
+};
+
+/**
+ * Everything needed to convert a pixel between two RGB matrix-shaper
+ * profiles: linearize with the source curve, multiply by the matrix
+ * (source RGB -> PCS -> destination RGB) and apply the inverse of
+ * the destination curve.
+ */
+struct LcmsMatrixShaperParams
+{
+    LcmsParametricCurve srcCurve;
+    LcmsParametricCurve dstCurve;
+
+    /// row-major, linear source RGB -> linear destination RGB
+    std::array<float, 9> matrix {};
+};
+
+/**
+ * Creates a vectorized transformation between two RGBA color spaces
+ * when both of them use matrix-shaper profiles with a TRC we know in
+ * closed form. The conversion bypasses LCMS completely.
+ *
+ * @return nullptr if the pair cannot be converted with the fast path,
+ *         in which case the caller should fall back to LCMS
+ */
+KoColorConversionTransformation *createLcmsMatrixShaperTransformation(const KoColorSpace *srcColorSpace,
+                                                                      const KoColorSpace *dstColorSpace,
+                                                                      KoColorConversionTransformation::Intent renderingIntent,
+                                                                      KoColorConversionTransformation::ConversionFlags conversionFlags);
+
+#endif // LCMSMATRIXSHAPERTRANSFORMATION_H
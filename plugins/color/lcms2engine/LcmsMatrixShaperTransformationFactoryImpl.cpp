@@ -0,0 +1,312 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "LcmsMatrixShaperTransformationFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+
+#include <type_traits>
+#include <vector>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include <KoColorSpaceMaths.h>
+#include <KoColorSpaceTraits.h>
+
+namespace {
+
+template<typename channels_type>
+struct RgbTraitsForChannelType;
+
+template<>
+struct RgbTraitsForChannelType<quint8> {
+    using type = KoBgrU8Traits;
+};
+
+template<>
+struct RgbTraitsForChannelType<quint16> {
+    using type = KoBgrU16Traits;
+};
+
+#ifdef HAVE_OPENEXR
+template<>
+struct RgbTraitsForChannelType<half> {
+    using type = KoRgbF16Traits;
+};
+#endif
+
+template<>
+struct RgbTraitsForChannelType<float> {
+    using type = KoRgbF32Traits;
+};
+
+/**
+ * The scalar part of the conversion, shared by the generic and the
+ * vectorized implementations. The vectorized one uses it for the
+ * tails of the pixel runs.
+ */
+template<typename src_channels_type, typename dst_channels_type>
+class LcmsMatrixShaperTransformationBase : public KoColorConversionTransformation
+{
+protected:
+    using SrcTraits = typename RgbTraitsForChannelType<src_channels_type>::type;
+    using DstTraits = typename RgbTraitsForChannelType<dst_channels_type>::type;
+
+    static constexpr bool srcHasLut = std::is_same<src_channels_type, quint8>::value;
+
+public:
+    LcmsMatrixShaperTransformationBase(const KoColorSpace *srcCs,
+                                       const KoColorSpace *dstCs,
+                                       Intent renderingIntent,
+                                       ConversionFlags conversionFlags,
+                                       const LcmsMatrixShaperParams &params)
+        : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+        , m_params(params)
+        , m_srcIsLinear(params.srcCurve.isLinear())
+        , m_dstIsLinear(params.dstCurve.isLinear())
+    {
+        if (srcHasLut) {
+            // 8-bit source has so few values that it is cheaper
+            // to linearize them once in advance
+            m_srcLut.resize(256);
+            for (int i = 0; i < 256; i++) {
+                m_srcLut[i] = m_params.srcCurve.linearize(KoColorSpaceMaths<quint8, float>::scaleToA(quint8(i)));
+            }
+        }
+    }
+
+protected:
+    ALWAYS_INLINE float loadChannel(src_channels_type value) const
+    {
+        if (srcHasLut) {
+            return m_srcLut[static_cast<int>(value)];
+        }
+        return KoColorSpaceMaths<src_channels_type, float>::scaleToA(value);
+    }
+
+    ALWAYS_INLINE void loadPixel(const quint8 *src, float &r, float &g, float &b) const
+    {
+        const src_channels_type *pixel = reinterpret_cast<const src_channels_type *>(src);
+        r = loadChannel(pixel[SrcTraits::red_pos]);
+        g = loadChannel(pixel[SrcTraits::green_pos]);
+        b = loadChannel(pixel[SrcTraits::blue_pos]);
+    }
+
+    ALWAYS_INLINE void storePixel(const quint8 *src, quint8 *dst, float r, float g, float b) const
+    {
+        const src_channels_type srcAlpha =
+            reinterpret_cast<const src_channels_type *>(src)[SrcTraits::alpha_pos];
+        dst_channels_type *pixel = reinterpret_cast<dst_channels_type *>(dst);
+
+        pixel[DstTraits::red_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(r);
+        pixel[DstTraits::green_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(g);
+        pixel[DstTraits::blue_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(b);
+        pixel[DstTraits::alpha_pos] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(srcAlpha);
+    }
+
+    void transformScalar(const quint8 *src, quint8 *dst, qint32 nPixels) const
+    {
+        const std::array<float, 9> &m = m_params.matrix;
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            float r, g, b;
+            loadPixel(src, r, g, b);
+
+            if (!srcHasLut && !m_srcIsLinear) {
+                r = m_params.srcCurve.linearize(r);
+                g = m_params.srcCurve.linearize(g);
+                b = m_params.srcCurve.linearize(b);
+            }
+
+            float dr = m[0] * r + m[1] * g + m[2] * b;
+            float dg = m[3] * r + m[4] * g + m[5] * b;
+            float db = m[6] * r + m[7] * g + m[8] * b;
+
+            if (!m_dstIsLinear) {
+                dr = m_params.dstCurve.delinearize(dr);
+                dg = m_params.dstCurve.delinearize(dg);
+                db = m_params.dstCurve.delinearize(db);
+            }
+
+            storePixel(src, dst, dr, dg, db);
+
+            src += SrcTraits::pixelSize;
+            dst += DstTraits::pixelSize;
+        }
+    }
+
+protected:
+    const LcmsMatrixShaperParams m_params;
+    const bool m_srcIsLinear;
+    const bool m_dstIsLinear;
+    std::vector<float> m_srcLut;
+};
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         typename _impl,
+         typename EnableDummyType = void>
+class LcmsMatrixShaperTransformation
+    : public LcmsMatrixShaperTransformationBase<src_channels_type, dst_channels_type>
+{
+    using BaseClass = LcmsMatrixShaperTransformationBase<src_channels_type, dst_channels_type>;
+
+public:
+    using BaseClass::BaseClass;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override
+    {
+        this->transformScalar(src, dst, nPixels);
+    }
+};
+
+} // namespace
+
+#if !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include <KoStreamedMath.h>
+
+namespace {
+
+template<typename src_channels_type, typename dst_channels_type, typename _impl>
+class LcmsMatrixShaperTransformation<
+        src_channels_type, dst_channels_type, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public LcmsMatrixShaperTransformationBase<src_channels_type, dst_channels_type>
+{
+    using BaseClass = LcmsMatrixShaperTransformationBase<src_channels_type, dst_channels_type>;
+    using SrcTraits = typename BaseClass::SrcTraits;
+    using DstTraits = typename BaseClass::DstTraits;
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+
+public:
+    using BaseClass::BaseClass;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override
+    {
+        constexpr int vectorSize = static_cast<int>(float_v::size);
+
+        const int block1 = nPixels / vectorSize;
+        const int block2 = nPixels % vectorSize;
+
+        const std::array<float, 9> &m = this->m_params.matrix;
+        const LcmsParametricCurve &srcCurve = this->m_params.srcCurve;
+        const LcmsParametricCurve &dstCurve = this->m_params.dstCurve;
+
+        /**
+         * Loading and storing the pixels is done per-pixel into planar
+         * buffers, all the heavy math (TRC evaluation and the matrix)
+         * runs on full vectors
+         */
+        alignas(64) float r[vectorSize];
+        alignas(64) float g[vectorSize];
+        alignas(64) float b[vectorSize];
+
+        for (int i = 0; i < block1; i++) {
+            for (int j = 0; j < vectorSize; j++) {
+                this->loadPixel(src + j * SrcTraits::pixelSize, r[j], g[j], b[j]);
+            }
+
+            float_v vr = float_v::load_aligned(r);
+            float_v vg = float_v::load_aligned(g);
+            float_v vb = float_v::load_aligned(b);
+
+            if (!BaseClass::srcHasLut && !this->m_srcIsLinear) {
+                vr = linearize(vr, srcCurve);
+                vg = linearize(vg, srcCurve);
+                vb = linearize(vb, srcCurve);
+            }
+
+            float_v dr = vr * m[0] + vg * m[1] + vb * m[2];
+            float_v dg = vr * m[3] + vg * m[4] + vb * m[5];
+            float_v db = vr * m[6] + vg * m[7] + vb * m[8];
+
+            if (!this->m_dstIsLinear) {
+                dr = delinearize(dr, dstCurve);
+                dg = delinearize(dg, dstCurve);
+                db = delinearize(db, dstCurve);
+            }
+
+            dr.store_aligned(r);
+            dg.store_aligned(g);
+            db.store_aligned(b);
+
+            for (int j = 0; j < vectorSize; j++) {
+                this->storePixel(src + j * SrcTraits::pixelSize,
+                                 dst + j * DstTraits::pixelSize,
+                                 r[j], g[j], b[j]);
+            }
+
+            src += vectorSize * SrcTraits::pixelSize;
+            dst += vectorSize * DstTraits::pixelSize;
+        }
+
+        this->transformScalar(src, dst, block2);
+    }
+
+private:
+    static ALWAYS_INLINE float_v linearize(const float_v &x, const LcmsParametricCurve &curve)
+    {
+        const float_v linear = x * curve.c;
+        const float_v curved = xsimd::pow(xsimd::max(x * curve.a + curve.b, float_v(0.0f)), float_v(curve.g));
+        return xsimd::select(x < float_v(curve.d), linear, curved);
+    }
+
+    static ALWAYS_INLINE float_v delinearize(const float_v &y, const LcmsParametricCurve &curve)
+    {
+        const float_v linear = y * curve.invC;
+        const float_v curved = (xsimd::pow(xsimd::max(y, float_v(0.0f)), float_v(curve.invG)) - curve.b) * curve.invA;
+        return xsimd::select(y < float_v(curve.threshold), linear, curved);
+    }
+};
+
+} // namespace
+
+#endif /* !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+template<typename src_channels_type, typename dst_channels_type>
+template<typename _impl>
+KoColorConversionTransformation *
+LcmsMatrixShaperTransformationFactoryImpl<src_channels_type, dst_channels_type>::create(
+    const KoColorSpace *srcColorSpace,
+    const KoColorSpace *dstColorSpace,
+    KoColorConversionTransformation::Intent renderingIntent,
+    KoColorConversionTransformation::ConversionFlags conversionFlags,
+    const LcmsMatrixShaperParams &params)
+{
+    return new LcmsMatrixShaperTransformation<src_channels_type, dst_channels_type, _impl>(
+        srcColorSpace, dstColorSpace, renderingIntent, conversionFlags, params);
+}
+
+#define DECLARE_MATRIX_SHAPER_FACTORY(src_type, dst_type) \
+    template KoColorConversionTransformation * \
+    LcmsMatrixShaperTransformationFactoryImpl<src_type, dst_type>::create<xsimd::current_arch>( \
+        const KoColorSpace *, const KoColorSpace *, \
+        KoColorConversionTransformation::Intent, \
+        KoColorConversionTransformation::ConversionFlags, \
+        const LcmsMatrixShaperParams &)
+
+#define DECLARE_MATRIX_SHAPER_FACTORIES_FOR_DST(dst_type) \
+    DECLARE_MATRIX_SHAPER_FACTORY(quint8, dst_type); \
+    DECLARE_MATRIX_SHAPER_FACTORY(quint16, dst_type); \
+    DECLARE_MATRIX_SHAPER_FACTORY(float, dst_type)
+
+DECLARE_MATRIX_SHAPER_FACTORIES_FOR_DST(quint8);
+DECLARE_MATRIX_SHAPER_FACTORIES_FOR_DST(quint16);
+DECLARE_MATRIX_SHAPER_FACTORIES_FOR_DST(float);
+
+#ifdef HAVE_OPENEXR
+DECLARE_MATRIX_SHAPER_FACTORIES_FOR_DST(half);
+DECLARE_MATRIX_SHAPER_FACTORY(half, quint8);
+DECLARE_MATRIX_SHAPER_FACTORY(half, quint16);
+DECLARE_MATRIX_SHAPER_FACTORY(half, half);
+DECLARE_MATRIX_SHAPER_FACTORY(half, float);
+#endif
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef LCMSMATRIXSHAPERTRANSFORMATIONFACTORYIMPL_H
+#define LCMSMATRIXSHAPERTRANSFORMATIONFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "LcmsMatrixShaperTransformation.h"
+
+template<typename src_channels_type, typename dst_channels_type>
+class LcmsMatrixShaperTransformationFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoColorConversionTransformation *create(const KoColorSpace *srcColorSpace,
+                                                   const KoColorSpace *dstColorSpace,
+                                                   KoColorConversionTransformation::Intent renderingIntent,
+                                                   KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                                   const LcmsMatrixShaperParams &params);
+};
+
+#endif // LCMSMATRIXSHAPERTRANSFORMATIONFACTORYIMPL_H
@@ -0,0 +1,105 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef LCMSPERCHANNELLUTTRANSFORMATION_H
+#define LCMSPERCHANNELLUTTRANSFORMATION_H
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <KoColorTransformation.h>
+
+/**
+ * A per-channel adjustment of an integer color space baked into a
+ * lookup table per channel.
+ *
+ * The per-channel adjustments (curves, levels) go through an LCMS
+ * linearization device link, which evaluates the tabulated tone
+ * curve for every channel of every pixel. In integer color spaces
+ * every channel of the result depends on the same channel of the
+ * source only, so it is enough to pass every possible value through
+ * the original transformation once.
+ */
+template<typename channels_type>
+class LcmsPerChannelLutTransformation : public KoColorTransformation
+{
+public:
+    static const int numValues = int(std::numeric_limits<channels_type>::max()) + 1;
+
+    LcmsPerChannelLutTransformation(const KoColorTransformation *transformation, int channelsNb)
+        : m_channelsNb(channelsNb)
+        , m_lut(size_t(numValues) * channelsNb)
+    {
+        std::vector<channels_type> ramp(size_t(numValues) * channelsNb);
+        std::vector<channels_type> result(ramp.size());
+
+        for (int i = 0; i < numValues; i++) {
+            for (int c = 0; c < channelsNb; c++) {
+                ramp[size_t(i) * channelsNb + c] = channels_type(i);
+            }
+        }
+
+        transformation->transform(reinterpret_cast<const quint8*>(ramp.data()),
+                                  reinterpret_cast<quint8*>(result.data()),
+                                  numValues);
+
+        for (int c = 0; c < channelsNb; c++) {
+            for (int i = 0; i < numValues; i++) {
+                m_lut[size_t(c) * numValues + i] = result[size_t(i) * channelsNb + c];
+            }
+        }
+    }
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override
+    {
+        const channels_type *srcPixel = reinterpret_cast<const channels_type*>(src);
+        channels_type *dstPixel = reinterpret_cast<channels_type*>(dst);
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            const channels_type *lut = m_lut.data();
+
+            for (int c = 0; c < m_channelsNb; c++) {
+                dstPixel[c] = lut[srcPixel[c]];
+                lut += numValues;
+            }
+
+            srcPixel += m_channelsNb;
+            dstPixel += m_channelsNb;
+        }
+    }
+
+private:
+    const int m_channelsNb;
+    std::vector<channels_type> m_lut;
+};
+
+/**
+ * Replaces \p transformation with its baked version when the channel
+ * type is small enough to be tabulated. Float color spaces keep the
+ * original transformation.
+ */
+template<typename channels_type>
+typename std::enable_if<std::numeric_limits<channels_type>::is_integer && sizeof(channels_type) <= 2,
+                        KoColorTransformation*>::type
+bakePerChannelAdjustment(KoColorTransformation *transformation, int channelsNb)
+{
+    KoColorTransformation *lutTransformation =
+        new LcmsPerChannelLutTransformation<channels_type>(transformation, channelsNb);
+    delete transformation;
+    return lutTransformation;
+}
+
+template<typename channels_type>
+typename std::enable_if<!(std::numeric_limits<channels_type>::is_integer && sizeof(channels_type) <= 2),
+                        KoColorTransformation*>::type
+bakePerChannelAdjustment(KoColorTransformation *transformation, int channelsNb)
+{
+    Q_UNUSED(channelsNb);
+    return transformation;
+}
+
+#endif // LCMSPERCHANNELLUTTRANSFORMATION_H
@@ -0,0 +1,155 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLcmsMatrixShaperTransformation.h"
+
+#include <simpletest.h>
+#include <testpigment.h>
+
+#include "kis_debug.h"
+
+#include <lcms2.h>
+
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+
+namespace {
+
+cmsUInt32Number lcmsTypeForDepth(const QString &depthId)
+{
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        return TYPE_BGRA_8;
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        return TYPE_BGRA_16;
+    }
+    return TYPE_RGBA_FLT;
+}
+
+void fillTestPixels(const KoColorSpace *cs, QByteArray &data, int numPixels)
+{
+    data.resize(numPixels * cs->pixelSize());
+
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        // walk over the RGB cube with co-prime steps
+        channels[0] = float((i * 7) % 97) / 96.0f;
+        channels[1] = float((i * 13) % 89) / 88.0f;
+        channels[2] = float((i * 29) % 101) / 100.0f;
+        channels[3] = 1.0f;
+
+        cs->fromNormalisedChannelsValue(reinterpret_cast<quint8 *>(data.data()) + i * cs->pixelSize(), channels);
+    }
+}
+
+} // namespace
+
+void TestLcmsMatrixShaperTransformation::testConversion_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const QString srgb = registry->p709SRGBProfile()->name();
+    const QString rec2020Linear = registry->p2020G10Profile()->name();
+    const QString rec709Linear = registry->p709G10Profile()->name();
+
+    QTest::newRow("srgb-u8 -> rec2020-linear-f32")
+        << Integer8BitsColorDepthID.id() << srgb << Float32BitsColorDepthID.id() << rec2020Linear;
+    QTest::newRow("srgb-u8 -> rec2020-linear-u16")
+        << Integer8BitsColorDepthID.id() << srgb << Integer16BitsColorDepthID.id() << rec2020Linear;
+    QTest::newRow("srgb-u16 -> rec709-linear-u16")
+        << Integer16BitsColorDepthID.id() << srgb << Integer16BitsColorDepthID.id() << rec709Linear;
+    QTest::newRow("rec709-linear-f32 -> srgb-u8")
+        << Float32BitsColorDepthID.id() << rec709Linear << Integer8BitsColorDepthID.id() << srgb;
+    QTest::newRow("rec2020-linear-f32 -> srgb-u16")
+        << Float32BitsColorDepthID.id() << rec2020Linear << Integer16BitsColorDepthID.id() << srgb;
+    QTest::newRow("rec2020-linear-u16 -> srgb-u8")
+        << Integer16BitsColorDepthID.id() << rec2020Linear << Integer8BitsColorDepthID.id() << srgb;
+}
+
+void TestLcmsMatrixShaperTransformation::testConversion()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCS = registry->colorSpace(RGBAColorModelID.id(), srcDepth, srcProfile);
+    const KoColorSpace *dstCS = registry->colorSpace(RGBAColorModelID.id(), dstDepth, dstProfile);
+    QVERIFY(srcCS);
+    QVERIFY(dstCS);
+
+    // an odd number of pixels to exercise the scalar tail as well
+    const int numPixels = 1031;
+
+    QByteArray srcData;
+    fillTestPixels(srcCS, srcData, numPixels);
+
+    QByteArray result(numPixels * dstCS->pixelSize(), '\0');
+    srcCS->convertPixelsTo(reinterpret_cast<const quint8 *>(srcData.constData()),
+                           reinterpret_cast<quint8 *>(result.data()),
+                           dstCS, numPixels,
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           KoColorConversionTransformation::internalConversionFlags());
+
+    /**
+     * The reference is a plain unoptimized LCMS transformation
+     * created directly from the profiles' data
+     */
+    const QByteArray srcProfileData = srcCS->profile()->rawData();
+    const QByteArray dstProfileData = dstCS->profile()->rawData();
+
+    cmsHPROFILE srcLcmsProfile = cmsOpenProfileFromMem(srcProfileData.constData(), srcProfileData.size());
+    cmsHPROFILE dstLcmsProfile = cmsOpenProfileFromMem(dstProfileData.constData(), dstProfileData.size());
+    QVERIFY(srcLcmsProfile);
+    QVERIFY(dstLcmsProfile);
+
+    cmsHTRANSFORM transform = cmsCreateTransform(srcLcmsProfile, lcmsTypeForDepth(srcDepth),
+                                                 dstLcmsProfile, lcmsTypeForDepth(dstDepth),
+                                                 INTENT_PERCEPTUAL,
+                                                 cmsFLAGS_NOOPTIMIZE | cmsFLAGS_BLACKPOINTCOMPENSATION);
+    QVERIFY(transform);
+
+    QByteArray reference(numPixels * dstCS->pixelSize(), '\0');
+    cmsDoTransform(transform, srcData.constData(), reference.data(), numPixels);
+
+    cmsDeleteTransform(transform);
+    cmsCloseProfile(srcLcmsProfile);
+    cmsCloseProfile(dstLcmsProfile);
+
+    const float tolerance =
+        dstDepth == Integer8BitsColorDepthID.id() ? 1.01f / 255.0f : 1e-3f;
+
+    QVector<float> resultChannels(4);
+    QVector<float> referenceChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8 *>(result.constData()) + i * dstCS->pixelSize(), resultChannels);
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8 *>(reference.constData()) + i * dstCS->pixelSize(), referenceChannels);
+
+        // LCMS doesn't touch alpha when not asked to, so it is checked separately
+        for (int ch = 0; ch < 3; ch++) {
+            if (qAbs(resultChannels[ch] - referenceChannels[ch]) > tolerance) {
+                qDebug() << "pixel" << i << "channel" << ch
+                         << "result" << resultChannels[ch]
+                         << "reference" << referenceChannels[ch];
+                QFAIL("the converted color differs from the LCMS reference");
+            }
+        }
+
+        QCOMPARE(resultChannels[3], 1.0f);
+    }
+}
+
+KISTEST_MAIN(TestLcmsMatrixShaperTransformation)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLCMSMATRIXSHAPERTRANSFORMATION_H
+#define TESTLCMSMATRIXSHAPERTRANSFORMATION_H
+
+#include <QObject>
+
+class TestLcmsMatrixShaperTransformation : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testConversion_data();
+    void testConversion();
+};
+
+#endif // TESTLCMSMATRIXSHAPERTRANSFORMATION_H
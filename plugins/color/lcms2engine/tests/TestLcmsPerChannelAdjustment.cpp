@@ -0,0 +1,102 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLcmsPerChannelAdjustment.h"
+
+#include <cmath>
+
+#include <simpletest.h>
+#include <testpigment.h>
+
+#include "kis_debug.h"
+
+#include <lcms2.h>
+
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorTransformation.h"
+
+void TestLcmsPerChannelAdjustment::testAdjustment_data()
+{
+    QTest::addColumn<QString>("depth");
+
+    QTest::newRow("u8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("u16") << Integer16BitsColorDepthID.id();
+    QTest::newRow("f32") << Float32BitsColorDepthID.id();
+}
+
+void TestLcmsPerChannelAdjustment::testAdjustment()
+{
+    QFETCH(QString, depth);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depth, QString());
+    QVERIFY(cs);
+
+    QVector<quint16> curve(256);
+    QVector<quint16> identity(256);
+
+    for (int i = 0; i < 256; i++) {
+        curve[i] = quint16(qRound(std::pow(i / 255.0, 0.6) * 65535.0));
+        identity[i] = quint16(qRound(i / 255.0 * 65535.0));
+    }
+
+    // adjust the color channels, keep alpha
+    const quint16 *transfers[] = {curve.constData(), curve.constData(), curve.constData(), identity.constData()};
+
+    QScopedPointer<KoColorTransformation> transformation(cs->createPerChannelAdjustment(transfers));
+    QVERIFY(transformation);
+
+    const int numPixels = 1031;
+
+    QByteArray src(numPixels * cs->pixelSize(), '\0');
+    QByteArray dst(numPixels * cs->pixelSize(), '\0');
+
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        channels[0] = float((i * 7) % 97) / 96.0f;
+        channels[1] = float((i * 13) % 89) / 88.0f;
+        channels[2] = float((i * 29) % 101) / 100.0f;
+        channels[3] = float((i * 3) % 61) / 60.0f;
+
+        cs->fromNormalisedChannelsValue(reinterpret_cast<quint8 *>(src.data()) + i * cs->pixelSize(), channels);
+    }
+
+    transformation->transform(reinterpret_cast<const quint8 *>(src.constData()),
+                              reinterpret_cast<quint8 *>(dst.data()),
+                              numPixels);
+
+    cmsToneCurve *toneCurve = cmsBuildTabulatedToneCurve16(0, 256, curve.constData());
+    QVERIFY(toneCurve);
+
+    const float tolerance =
+        depth == Integer8BitsColorDepthID.id() ? 1.01f / 255.0f : 2e-3f;
+
+    QVector<float> srcChannels(4);
+    QVector<float> dstChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        cs->normalisedChannelsValue(reinterpret_cast<const quint8 *>(src.constData()) + i * cs->pixelSize(), srcChannels);
+        cs->normalisedChannelsValue(reinterpret_cast<const quint8 *>(dst.constData()) + i * cs->pixelSize(), dstChannels);
+
+        for (int ch = 0; ch < 4; ch++) {
+            const float expected = ch < 3 ?
+                cmsEvalToneCurveFloat(toneCurve, srcChannels[ch]) : srcChannels[ch];
+
+            if (qAbs(dstChannels[ch] - expected) > tolerance) {
+                qDebug() << "pixel" << i << "channel" << ch
+                         << "result" << dstChannels[ch]
+                         << "expected" << expected;
+                QFAIL("the adjusted color differs from the curve");
+            }
+        }
+    }
+
+    cmsFreeToneCurve(toneCurve);
+}
+
+KISTEST_MAIN(TestLcmsPerChannelAdjustment)
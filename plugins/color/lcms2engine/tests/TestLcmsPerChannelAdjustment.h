@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLCMSPERCHANNELADJUSTMENT_H
+#define TESTLCMSPERCHANNELADJUSTMENT_H
+
+#include <QObject>
+
+class TestLcmsPerChannelAdjustment : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAdjustment_data();
+    void testAdjustment();
+};
+
+#endif // TESTLCMSPERCHANNELADJUSTMENT_H
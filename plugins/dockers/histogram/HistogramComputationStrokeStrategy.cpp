@@ -6,11 +6,28 @@
  */
 #include "HistogramComputationStrokeStrategy.h"
 
+#include <limits>
+
 #include "KoColorSpace.h"
+#include "KoChannelInfo.h"
 
-#include "krita_utils.h"
 #include "kis_image.h"
 #include "kis_sequential_iterator.h"
+#include "HistogramPatchCache.h"
+
+namespace {
+
+bool isU8ColorSpace(const KoColorSpace *cs)
+{
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        if (channel->channelValueType() != KoChannelInfo::UINT8) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
 
 struct HistogramComputationStrokeStrategy::Private
 {
@@ -18,26 +35,26 @@ struct HistogramComputationStrokeStrategy::Private
     class ProcessData : public KisStrokeJobData
     {
     public:
-        ProcessData(QRect rect, int _jobId)
+        ProcessData(const HistogramPatchCache::Patch &_patch)
             : KisStrokeJobData(CONCURRENT)
-            , rectToCalculate(rect)
-            , jobId(_jobId)
+            , patch(_patch)
         {}
 
-        QRect rectToCalculate;
-        int jobId; // id in the list of results
+        HistogramPatchCache::Patch patch;
     };
 
     KisImageSP image;
-    std::vector<HistVector> results;
+    QSharedPointer<HistogramPatchCache> cache;
+    int samplingStep {1};
 };
 
 
-HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image)
+HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image, QSharedPointer<HistogramPatchCache> cache)
     : KisIdleTaskStrokeStrategy(QLatin1String("ComputeHistogram"), kundo2_i18n("Update histogram"))
     , m_d(new Private)
 {
     m_d->image = image;
+    m_d->cache = cache;
 }
 
 HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
@@ -48,14 +65,17 @@ void HistogramComputationStrokeStrategy::initStrokeCallback()
 {
     KisIdleTaskStrokeStrategy::initStrokeCallback();
 
+    const QRect imageBounds = m_d->image->bounds();
+    const int imageSize = imageBounds.width() * imageBounds.height();
+    m_d->samplingStep = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+
+    const QVector<HistogramPatchCache::Patch> dirtyPatches =
+        m_d->cache->prepare(imageBounds, m_d->image->projection()->colorSpace(), m_d->samplingStep);
+
     QVector<KisStrokeJobData*> jobsData;
-    int i = 0;
-    QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(m_d->image->bounds(), KritaUtils::optimalPatchSize());
-    m_d->results.resize(tileRects.size());
 
-    Q_FOREACH (const QRect &tileRectangle, tileRects) {
-        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(tileRectangle, i);
-        i++;
+    Q_FOREACH (const HistogramPatchCache::Patch &patch, dirtyPatches) {
+        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(patch);
     }
     addMutatedJobs(jobsData);
 }
@@ -69,24 +89,27 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
         return;
     }
 
-    QRect calculate = d_pd->rectToCalculate;
+    const QRect calculate = d_pd->patch.rect;
+    if (calculate.isEmpty())
+        return;
 
     KisPaintDeviceSP m_dev = m_d->image->projection();
-    QRect imageBounds = m_d->image->bounds();
 
     const KoColorSpace *cs = m_dev->colorSpace();
-    quint32 channelCount = m_dev->channelCount();
-    quint32 pixelSize = m_dev->pixelSize();
+    const int channelCount = m_dev->channelCount();
+    const int pixelSize = m_dev->pixelSize();
+    const int nSkip = m_d->samplingStep;
 
-    int imageSize = imageBounds.width() * imageBounds.height();
-    int nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    HistVector result(channelCount, std::vector<quint32>(std::numeric_limits<quint8>::max() + 1, 0));
 
-    if (calculate.isEmpty())
-        return;
-
-    initiateVector(m_d->results[d_pd->jobId], cs);
+    /**
+     * In 8-bit color spaces the channel values are the bin indexes
+     * already, so we can avoid calling virtual scaleToU8() for every
+     * channel of every sampled pixel.
+     */
+    const bool isU8 = isU8ColorSpace(cs);
 
-    quint32 toSkip = nSkip;
+    int toSkip = nSkip;
 
     KisSequentialConstIterator it(m_dev, calculate);
 
@@ -94,54 +117,40 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
     while (it.nextPixels(numConseqPixels)) {
 
         numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    m_d->results[d_pd->jobId][chan][cs->scaleToU8(pixel, chan)]++;
+        const quint8* pixels = it.rawDataConst();
+
+        // jump straight to the next sampled pixel of the run
+        int k = toSkip - 1;
+
+        if (isU8) {
+            for (; k < numConseqPixels; k += nSkip) {
+                const quint8 *pixel = pixels + k * pixelSize;
+                for (int chan = 0; chan < channelCount; ++chan) {
+                    result[chan][pixel[chan]]++;
+                }
+            }
+        } else {
+            for (; k < numConseqPixels; k += nSkip) {
+                const quint8 *pixel = pixels + k * pixelSize;
+                for (int chan = 0; chan < channelCount; ++chan) {
+                    result[chan][cs->scaleToU8(pixel, chan)]++;
                 }
-                toSkip = nSkip;
             }
-            pixel += pixelSize;
         }
+
+        toSkip = k - numConseqPixels + 1;
     }
+
+    m_d->cache->commit(d_pd->patch, std::move(result));
 }
 
 void HistogramComputationStrokeStrategy::finishStrokeCallback()
 {
     HistogramData hisData;
     hisData.colorSpace = m_d->image->projection()->colorSpace();
+    hisData.bins = m_d->cache->totalHistogram();
 
-    if (m_d->results.size() == 1) {
-        hisData.bins = m_d->results[0];
-        Q_EMIT computationResultReady(hisData);
-    } else {
-
-        quint32 channelCount = m_d->image->projection()->channelCount();
-
-        initiateVector(hisData.bins, hisData.colorSpace);
-
-        for (int chan = 0; chan < (int)channelCount; chan++) {
-            int bsize = hisData.bins[chan].size();
-
-            for (int bi = 0; bi < bsize; bi++) {
-                hisData.bins[chan][bi] = 0;
-                for (int i = 0; i < (int)m_d->results.size(); i++) {
-                    hisData.bins[chan][bi] += m_d->results[i][chan][bi];
-                }
-            }
-        }
-
-        Q_EMIT computationResultReady(hisData);
-    }
+    Q_EMIT computationResultReady(hisData);
 
     KisIdleTaskStrokeStrategy::finishStrokeCallback();
 }
-
-void HistogramComputationStrokeStrategy::initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
-{
-    vec.resize(colorSpace->channelCount());
-    for (auto &bin : vec) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
-    }
-}
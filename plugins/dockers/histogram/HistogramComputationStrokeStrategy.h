@@ -8,9 +8,11 @@
 #define HISTOGRAMCOMPUTATIONSTROKESTRATEGY_H
 
 #include <KisIdleTaskStrokeStrategy.h>
+#include <QSharedPointer>
 #include <vector>
 
 class KoColorSpace;
+class HistogramPatchCache;
 
 
 using HistVector = std::vector<std::vector<quint32> >; //Don't use QVector here - it's too slow for this purpose
@@ -23,11 +25,16 @@ struct HistogramData
 Q_DECLARE_METATYPE(HistogramData)
 
 
+/**
+ * Calculates the histogram of the image projection. Only the patches
+ * marked dirty in \p cache are recalculated, the rest of the histogram
+ * is taken from the cache.
+ */
 class HistogramComputationStrokeStrategy : public KisIdleTaskStrokeStrategy
 {
     Q_OBJECT
 public:
-    HistogramComputationStrokeStrategy(KisImageSP image);
+    HistogramComputationStrokeStrategy(KisImageSP image, QSharedPointer<HistogramPatchCache> cache);
     ~HistogramComputationStrokeStrategy() override;
 
 private:
@@ -35,8 +42,6 @@ private:
     void doStrokeCallback(KisStrokeJobData *data) override;
     void finishStrokeCallback() override;
 
-    void initiateVector(HistVector &vec, const KoColorSpace* colorSpace);
-
 Q_SIGNALS:
     //Emitted when thumbnail is updated and overviewImage is fully generated.
     void computationResultReady(HistogramData data);
@@ -0,0 +1,122 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "HistogramPatchCache.h"
+
+#include <QMutexLocker>
+#include <limits>
+
+#include "KoColorSpace.h"
+
+#include "krita_utils.h"
+
+void HistogramPatchCache::addDirtyRect(const QRect &rc)
+{
+    QMutexLocker l(&m_mutex);
+
+    if (!m_colorSpace) return;
+
+    const QRect dirtyRect = rc & m_imageBounds;
+    if (dirtyRect.isEmpty()) return;
+
+    const int firstColumn = (dirtyRect.left() - m_imageBounds.left()) / m_patchSize.width();
+    const int lastColumn = (dirtyRect.right() - m_imageBounds.left()) / m_patchSize.width();
+    const int firstRow = (dirtyRect.top() - m_imageBounds.top()) / m_patchSize.height();
+    const int lastRow = (dirtyRect.bottom() - m_imageBounds.top()) / m_patchSize.height();
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const int index = row * m_numColumns + column;
+            m_dirty[index] = true;
+            m_generations[index]++;
+        }
+    }
+}
+
+void HistogramPatchCache::invalidate()
+{
+    QMutexLocker l(&m_mutex);
+    m_colorSpace = 0;
+}
+
+QVector<HistogramPatchCache::Patch> HistogramPatchCache::prepare(const QRect &imageBounds, const KoColorSpace *colorSpace, int samplingStep)
+{
+    QMutexLocker l(&m_mutex);
+
+    if (!m_colorSpace ||
+        m_imageBounds != imageBounds ||
+        m_colorSpace != colorSpace ||
+        m_samplingStep != samplingStep) {
+
+        m_imageBounds = imageBounds;
+        m_colorSpace = colorSpace;
+        m_samplingStep = samplingStep;
+        resetUnlocked();
+    }
+
+    QVector<Patch> patches;
+
+    for (int i = 0; i < m_patchRects.size(); i++) {
+        if (m_dirty[i]) {
+            patches.append({i, m_patchRects[i], m_generations[i], m_epoch});
+        }
+    }
+
+    return patches;
+}
+
+void HistogramPatchCache::commit(const Patch &patch, HistVector &&bins)
+{
+    QMutexLocker l(&m_mutex);
+
+    // the cache has been reset while the patch was being calculated
+    if (patch.epoch != m_epoch) return;
+
+    HistVector &oldBins = m_patchBins[patch.index];
+
+    for (size_t chan = 0; chan < m_total.size(); chan++) {
+        std::vector<quint32> &total = m_total[chan];
+
+        if (!oldBins.empty()) {
+            for (size_t bin = 0; bin < total.size(); bin++) {
+                total[bin] -= oldBins[chan][bin];
+            }
+        }
+
+        for (size_t bin = 0; bin < total.size(); bin++) {
+            total[bin] += bins[chan][bin];
+        }
+    }
+
+    oldBins = std::move(bins);
+
+    if (m_generations[patch.index] == patch.generation) {
+        m_dirty[patch.index] = false;
+    }
+}
+
+HistVector HistogramPatchCache::totalHistogram() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_total;
+}
+
+void HistogramPatchCache::resetUnlocked()
+{
+    m_epoch++;
+
+    m_patchSize = KritaUtils::optimalPatchSize();
+    m_numColumns = (m_imageBounds.width() + m_patchSize.width() - 1) / m_patchSize.width();
+    m_patchRects = KritaUtils::splitRectIntoPatchesTight(m_imageBounds, m_patchSize);
+
+    m_generations.fill(0, m_patchRects.size());
+    m_dirty.fill(true, m_patchRects.size());
+
+    m_patchBins.clear();
+    m_patchBins.resize(m_patchRects.size());
+
+    m_total.assign(m_colorSpace->channelCount(),
+                   std::vector<quint32>(std::numeric_limits<quint8>::max() + 1, 0));
+}
@@ -0,0 +1,88 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef HISTOGRAMPATCHCACHE_H
+#define HISTOGRAMPATCHCACHE_H
+
+#include <QMutex>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+#include "HistogramComputationStrokeStrategy.h"
+
+class KoColorSpace;
+
+/**
+ * Keeps the histograms of the patches of the image projection between
+ * the runs of HistogramComputationStrokeStrategy, so that every run
+ * recalculates only the patches touched by the updates of the image.
+ * The total histogram is updated by subtracting the old histogram of
+ * a recalculated patch and adding the new one.
+ *
+ * The dirty rects are reported from the threads emitting
+ * KisImage::sigImageUpdated(), the patches are committed from the
+ * threads of the stroke, so all the methods are thread-safe.
+ */
+class HistogramPatchCache
+{
+public:
+    struct Patch {
+        int index {-1};
+        QRect rect;
+        int generation {0};
+        int epoch {0};
+    };
+
+public:
+    /**
+     * Marks the patches intersecting \p rc for recalculation
+     */
+    void addDirtyRect(const QRect &rc);
+
+    /**
+     * Drops all the cached histograms, e.g. when the updates
+     * of the image could not be tracked
+     */
+    void invalidate();
+
+    /**
+     * Resets the cache if the bounds, the color space or the sampling
+     * step of the projection has changed since the last run.
+     *
+     * @return the patches that need to be recalculated
+     */
+    QVector<Patch> prepare(const QRect &imageBounds, const KoColorSpace *colorSpace, int samplingStep);
+
+    /**
+     * Replaces the histogram of \p patch with \p bins. The patch
+     * becomes clean unless it has been marked dirty again while
+     * being calculated.
+     */
+    void commit(const Patch &patch, HistVector &&bins);
+
+    HistVector totalHistogram() const;
+
+private:
+    void resetUnlocked();
+
+private:
+    mutable QMutex m_mutex;
+
+    QRect m_imageBounds;
+    const KoColorSpace *m_colorSpace {0};
+    int m_samplingStep {0};
+    QSize m_patchSize;
+    int m_numColumns {0};
+    int m_epoch {0};
+
+    QVector<QRect> m_patchRects;
+    QVector<int> m_generations;
+    QVector<bool> m_dirty;
+    std::vector<HistVector> m_patchBins;
+    HistVector m_total;
+};
+
+#endif // HISTOGRAMPATCHCACHE_H
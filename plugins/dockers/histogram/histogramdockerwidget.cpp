@@ -17,11 +17,15 @@
 #include "KoChannelInfo.h"
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_image.h"
+#include "kis_image_animation_interface.h"
+#include "HistogramPatchCache.h"
 
 
 
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
     : KisWidgetWithIdleTask<QLabel>(parent, f)
+    , m_patchCache(new HistogramPatchCache)
 {
     setObjectName(name);
     qRegisterMetaType<HistogramData>();
@@ -42,11 +46,43 @@ KisIdleTasksManager::TaskGuard HistogramDockerWidget::registerIdleTask(KisCanvas
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(canvas, KisIdleTasksManager::TaskGuard());
 
+    Q_FOREACH (const QMetaObject::Connection &connection, m_imageConnections) {
+        disconnect(connection);
+    }
+    m_imageConnections.clear();
+    m_patchCache->invalidate();
+
+    /**
+     * The projection is updated in the worker threads, so the dirty
+     * rects should reach the cache before the image becomes idle and
+     * the next histogram computation starts, hence the direct
+     * connection.
+     */
+    QSharedPointer<HistogramPatchCache> cache = m_patchCache;
+    KisImageSP image = canvas->image();
+
+    if (image) {
+        m_imageConnections <<
+            connect(image.data(), &KisImage::sigImageUpdated, this,
+                    [cache] (const QRect &rc) { cache->addDirtyRect(rc); },
+                    Qt::DirectConnection);
+
+        // external frames are rendered with the UI updates disabled
+        m_imageConnections <<
+            connect(image->animationInterface(), &KisImageAnimationInterface::sigFrameReady, this,
+                    [cache] () { cache->invalidate(); },
+                    Qt::DirectConnection);
+        m_imageConnections <<
+            connect(image->animationInterface(), &KisImageAnimationInterface::sigFrameCancelled, this,
+                    [cache] () { cache->invalidate(); },
+                    Qt::DirectConnection);
+    }
+
     return
         canvas->viewManager()->idleTasksManager()->
         addIdleTaskWithGuard([this](KisImageSP image) {
             HistogramComputationStrokeStrategy* strategy =
-                new HistogramComputationStrokeStrategy(image);
+                new HistogramComputationStrokeStrategy(image, m_patchCache);
 
             connect(strategy, SIGNAL(computationResultReady(HistogramData)), this, SLOT(receiveNewHistogram(HistogramData)));
 
@@ -58,6 +94,7 @@ void HistogramDockerWidget::clearCachedState()
 {
     m_colorSpace = 0;
     m_histogramData.clear();
+    m_patchCache->invalidate();
 }
 
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
@@ -12,10 +12,13 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QSharedPointer>
+#include <QVector>
 #include "HistogramComputationStrokeStrategy.h"
 #include "KisWidgetWithIdleTask.h"
 
 class KoColorSpace;
+class HistogramPatchCache;
 
 class HistogramDockerWidget : public KisWidgetWithIdleTask<QLabel>
 {
@@ -37,6 +40,9 @@ private:
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace {0};
     bool m_smoothHistogram {false};
+
+    QSharedPointer<HistogramPatchCache> m_patchCache;
+    QVector<QMetaObject::Connection> m_imageConnections;
 };
 
 #endif // HISTOGRAMDOCKERWIDGET_H
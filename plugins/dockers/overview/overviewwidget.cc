@@ -21,15 +21,20 @@
 #include <kis_config.h>
 #include <QApplication>
 #include "KisImageThumbnailStrokeStrategy.h"
+#include "KisImageThumbnailCache.h"
+#include <kis_image_animation_interface.h>
 #include <kis_display_color_converter.h>
 #include <KisMainWindow.h>
 #include "KisIdleTasksManager.h"
 #include <KisDisplayConfig.h>
+#include <KisDocument.h>
+#include <KisView.h>
 
 
 OverviewWidget::OverviewWidget(QWidget * parent)
     : KisWidgetWithIdleTask<QWidget>(parent)
     , m_dragging(false)
+    , m_thumbnailCache(new KisImageThumbnailCache)
 {
     setMouseTracking(true);
     KisConfig cfg(true);
@@ -45,12 +50,31 @@ void OverviewWidget::setCanvas(KisCanvas2 *canvas)
 {
     if (m_canvas) {
         m_canvas->image()->disconnect(this);
+        m_canvas->image()->animationInterface()->disconnect(this);
         m_canvas->displayColorConverter()->disconnect(this);
     }
 
     KisWidgetWithIdleTask<QWidget>::setCanvas(canvas);
 
     if (m_canvas) {
+        /**
+         * The projection is updated in the worker threads, so the dirty
+         * rects should reach the cache before the image becomes idle and
+         * the next thumbnail is generated, hence the direct connection.
+         */
+        QSharedPointer<KisImageThumbnailCache> cache = m_thumbnailCache;
+        connect(m_canvas->image().data(), &KisImage::sigImageUpdated, this,
+                [cache] (const QRect &rc) { cache->addDirtyRect(rc); },
+                Qt::DirectConnection);
+
+        // external frames are rendered with the UI updates disabled
+        connect(m_canvas->image()->animationInterface(), &KisImageAnimationInterface::sigFrameReady, this,
+                [cache] () { cache->invalidate(); },
+                Qt::DirectConnection);
+        connect(m_canvas->image()->animationInterface(), &KisImageAnimationInterface::sigFrameCancelled, this,
+                [cache] () { cache->invalidate(); },
+                Qt::DirectConnection);
+
         connect(m_canvas->displayColorConverter(), SIGNAL(displayConfigurationChanged()), SLOT(startUpdateCanvasProjection()));
         connect(m_canvas->canvasController()->proxyObject, SIGNAL(canvasStateChanged()), this, SLOT(update()), Qt::UniqueConnection);
         connect(m_canvas->viewManager()->mainWindow(), SIGNAL(themeChanged()), this, SLOT(slotThemeChanged()), Qt::UniqueConnection);
@@ -92,6 +116,8 @@ KisIdleTasksManager::TaskGuard OverviewWidget::registerIdleTask(KisCanvas2 *canv
             KisImageThumbnailStrokeStrategy *strategy =
                 new KisImageThumbnailStrokeStrategy(image->projection(), image->bounds(), thumbnailSize, isPixelArt(), config.profile, config.intent, config.conversionFlags);
 
+            strategy->setThumbnailCache(m_thumbnailCache);
+
             connect(strategy, SIGNAL(thumbnailUpdated(QImage)), this, SLOT(updateThumbnail(QImage)));
 
             return strategy;
@@ -102,6 +128,20 @@ void OverviewWidget::clearCachedState()
 {
     m_pixmap = QPixmap();
     m_oldPixmap = QPixmap();
+    m_thumbnailCache->invalidate();
+
+    /**
+     * Until the first thumbnail is generated from the projection (which
+     * happens only when the just opened image has been fully
+     * recalculated), show the low-resolution composite stored in the
+     * file.
+     */
+    if (m_canvas && m_canvas->imageView() && m_canvas->imageView()->document()) {
+        const QImage composite = m_canvas->imageView()->document()->storedLodComposite();
+        if (!composite.isNull()) {
+            m_pixmap = QPixmap::fromImage(composite);
+        }
+    }
 }
 
 bool OverviewWidget::isPixelArt()
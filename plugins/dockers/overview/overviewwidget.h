@@ -11,12 +11,14 @@
 #include <QObject>
 #include <QWidget>
 #include <QPixmap>
+#include <QSharedPointer>
 
 #include "KisWidgetWithIdleTask.h"
 
 #include <kis_canvas2.h>
 
 class KisSignalCompressor;
+class KisImageThumbnailCache;
 class KoCanvasBase;
 
 class OverviewWidget : public KisWidgetWithIdleTask<QWidget>
@@ -86,6 +88,8 @@ private:
     QPointF m_lastPos {QPointF(0, 0)};
 
     QColor m_outlineColor;
+
+    QSharedPointer<KisImageThumbnailCache> m_thumbnailCache;
 };
 
 
@@ -14,6 +14,7 @@
 #include <KoToolProxy.h>
 #include "kis_tool_proxy.h"
 #include <KisMainWindow.h>
+#include <KoMixColorsOp.h>
 
 #include <QDir>
 #include <QDirIterator>
@@ -26,6 +27,7 @@
 #include <QTimer>
 #include <QVector>
 #include <QSharedPointer>
+#include <QThread>
 #include <atomic>
 
 namespace
@@ -142,6 +144,7 @@ public:
     QByteArray imageBuffer;
     int imageBufferWidth = 0;
     int imageBufferHeight = 0;
+    int imageBufferResolution = 0;                         // Halvings already applied to the buffer
     QImage frame;
     int frameResolution = -1;
     int partIndex = 0;                                     // Consecutive file number
@@ -181,7 +184,13 @@ public:
             return true;
         }();
 
-        if (targetCs && needSrgbConversion) {
+        /**
+         * When the frame is downscaled, it is much cheaper to convert the
+         * downscaled pixels than to convert the entire projection first.
+         */
+        const bool convertDownscaled = targetCs && needSrgbConversion && settings->resolution > 0;
+
+        if (targetCs && needSrgbConversion && !convertDownscaled) {
             device->convertTo(targetCs);
         }
 
@@ -189,7 +198,7 @@ public:
         const quint32 bitmask = ~(0xFFFFFFFFu >> (31 - settings->resolution));
         const quint32 width = image->width() & bitmask;
         const quint32 height = image->height() & bitmask;
-        const int bufferSize = device->pixelSize() * width * height;
+        const int bufferSize = (convertDownscaled ? targetCs->pixelSize() : device->pixelSize()) * width * height;
 
         bool resize = imageBuffer.size() != bufferSize;
         if (resize)
@@ -204,10 +213,55 @@ public:
             frame = QImage(outData, outWidth, outHeight, QImage::Format_ARGB32);
         }
 
-        device->readBytes(reinterpret_cast<quint8 *>(imageBuffer.data()), 0, 0, width, height);
+        if (convertDownscaled) {
+            readDownscaledConverted(device, width, height);
+        } else {
+            device->readBytes(reinterpret_cast<quint8 *>(imageBuffer.data()), 0, 0, width, height);
+
+            imageBufferWidth = width;
+            imageBufferHeight = height;
+            imageBufferResolution = 0;
+        }
+    }
+
+    // Averages every divider x divider block of the device in its own color space
+    // and converts only the averaged pixels into the target color space
+    void readDownscaledConverted(KisPaintDeviceSP device, int width, int height)
+    {
+        const KoColorSpace *cs = device->colorSpace();
+        const int pixelSize = cs->pixelSize();
+        const int divider = 1 << settings->resolution;
+        const int outWidth = width / divider;
+        const int outHeight = height / divider;
+
+        QVector<quint8> band(width * divider * pixelSize);
+        QVector<quint8> mixedRow(outWidth * pixelSize);
+        QVector<const quint8*> blockPixels(divider * divider);
+        quint8 *dst = reinterpret_cast<quint8 *>(imageBuffer.data());
+
+        for (int y = 0; y < outHeight; y++) {
+            device->readBytes(band.data(), 0, y * divider, width, divider);
+
+            for (int x = 0; x < outWidth; x++) {
+                int i = 0;
+                for (int row = 0; row < divider; row++) {
+                    for (int col = 0; col < divider; col++) {
+                        blockPixels[i++] = band.constData() + (row * width + x * divider + col) * pixelSize;
+                    }
+                }
+                cs->mixColorsOp()->mixColors(blockPixels.constData(), blockPixels.size(),
+                                             mixedRow.data() + x * pixelSize);
+            }
+
+            cs->convertPixelsTo(mixedRow.constData(), dst, targetCs, outWidth,
+                                KoColorConversionTransformation::internalRenderingIntent(),
+                                KoColorConversionTransformation::internalConversionFlags());
+            dst += outWidth * targetCs->pixelSize();
+        }
 
-        imageBufferWidth = width;
-        imageBufferHeight = height;
+        imageBufferWidth = outWidth;
+        imageBufferHeight = outHeight;
+        imageBufferResolution = settings->resolution;
     }
 
     // Calculate ARGB average value using carry save adder:
@@ -323,9 +377,12 @@ void  RecorderWriter::onCaptureImage(int writerId, int index)
     d->captureImage();
 
     // downscale image buffer
-    for (int res = 0; res < d->settings->resolution; ++res)
+    for (int res = d->imageBufferResolution; res < d->settings->resolution; ++res)
         d->halfSizeImageBuffer();
 
+    // the encoding doesn't need the image anymore, let it yield to painting
+    QThread::currentThread()->setPriority(QThread::IdlePriority);
+
     d->removeFrameTransparency();
 
     d->partIndex = index;
@@ -21,14 +21,25 @@ KisAsyncStoryboardThumbnailRenderer::~KisAsyncStoryboardThumbnailRenderer()
 {
 }
 
+void KisAsyncStoryboardThumbnailRenderer::setThumbnailSize(const QSize &size)
+{
+    m_thumbnailSize = size;
+}
+
 void KisAsyncStoryboardThumbnailRenderer::frameCompletedCallback(int frameTime, const KisRegion &/*requestedRegion*/)
 {
     KisImageSP image = requestedImage();
-    KisPaintDeviceSP requestedFrame = image ? new KisPaintDevice(*image->projection(), KritaUtils::CopySnapshot) : nullptr;
 
-    if (requestedFrame) {
+    if (image) {
+        const QSize thumbnailSize = m_thumbnailSize.isEmpty() ?
+            image->size() :
+            image->size().scaled(m_thumbnailSize, Qt::KeepAspectRatio).boundedTo(image->size()).expandedTo(QSize(1, 1));
+
+        const QImage thumbnail =
+            image->projection()->createThumbnail(thumbnailSize.width(), thumbnailSize.height(), image->bounds());
+
         Q_EMIT sigNotifyFrameCompleted(frameTime);
-        Q_EMIT sigNotifyFrameCompleted(frameTime, requestedFrame);
+        Q_EMIT sigNotifyFrameCompleted(frameTime, thumbnail);
     } else {
         Q_EMIT sigNotifyFrameCancelled(frameTime, KisAsyncAnimationRendererBase::RenderingFailed);
     }
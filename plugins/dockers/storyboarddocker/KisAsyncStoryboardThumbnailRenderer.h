@@ -7,6 +7,8 @@
 #ifndef KISASYNCSTORYBOARDTHUMBNAILRENDERER_H
 #define KISASYNCSTORYBOARDTHUMBNAILRENDERER_H
 
+#include <QImage>
+
 #include <KisAsyncAnimationRendererBase.h>
 
 class KisPaintDevice;
@@ -23,16 +25,26 @@ public:
     KisAsyncStoryboardThumbnailRenderer(QObject *parent);
     ~KisAsyncStoryboardThumbnailRenderer();
 
+    /**
+     * @brief Sets the size the rendered frames are scaled down to. The
+     * frames are downscaled in the worker thread, right after the
+     * regeneration, so that only the thumbnail reaches the GUI thread.
+     * Should be set only when the renderer is not active.
+     */
+    void setThumbnailSize(const QSize &size);
+
 protected:
     void frameCompletedCallback(int frame, const KisRegion &requestedRegion) override;
     void frameCancelledCallback(int frame, CancelReason cancelReason) override;
     void clearFrameRegenerationState(bool isCancelled) override;
 
 Q_SIGNALS:
-    void sigNotifyFrameCompleted(int frameTime, KisPaintDeviceSP frameContents);
+    void sigNotifyFrameCompleted(int frameTime, const QImage &thumbnail);
     void sigNotifyFrameCompleted(int frameTime);
     void sigNotifyFrameCancelled(int frame, KisAsyncAnimationRendererBase::CancelReason cancelReason);
 
+private:
+    QSize m_thumbnailSize;
 };
 
 #endif
@@ -18,7 +18,7 @@ KisStoryboardThumbnailRenderScheduler::KisStoryboardThumbnailRenderScheduler(QOb
     , m_currentFrame(-1)
 {
     //connect signals to the renderer.
-    connect(m_renderer, SIGNAL(sigNotifyFrameCompleted(int,KisPaintDeviceSP)), this, SLOT(slotFrameRegenerationCompleted(int, KisPaintDeviceSP)));
+    connect(m_renderer, SIGNAL(sigNotifyFrameCompleted(int,QImage)), this, SLOT(slotFrameRegenerationCompleted(int,QImage)));
     connect(m_renderer, SIGNAL(sigFrameCancelled(int, KisAsyncAnimationRendererBase::CancelReason)), this, SLOT(slotFrameRegenerationCancelled(int)));
 }
 
@@ -33,7 +33,28 @@ void KisStoryboardThumbnailRenderScheduler::setImage(KisImageSP image)
         return;
     }
     cancelAllFrameRendering();
+
+    if (m_image) {
+        m_image->disconnect(this);
+    }
+
     m_image = image;
+    m_imageClone = 0;
+
+    if (m_image) {
+        connect(m_image, SIGNAL(sigImageModified()), this, SLOT(slotImageModified()));
+        connect(m_image, SIGNAL(sigImageModifiedWithoutUndo()), this, SLOT(slotImageModified()));
+    }
+}
+
+void KisStoryboardThumbnailRenderScheduler::setThumbnailSize(const QSize &size)
+{
+    m_thumbnailSize = size;
+}
+
+void KisStoryboardThumbnailRenderScheduler::slotImageModified()
+{
+    m_imageClone = 0;
 }
 
 void KisStoryboardThumbnailRenderScheduler::scheduleFrameForRegeneration(int frame, bool affected)
@@ -95,9 +116,9 @@ void KisStoryboardThumbnailRenderScheduler::slotStartFrameRendering()
 }
 
 
-void KisStoryboardThumbnailRenderScheduler::slotFrameRegenerationCompleted(int frame, KisPaintDeviceSP contents)
+void KisStoryboardThumbnailRenderScheduler::slotFrameRegenerationCompleted(int frame, const QImage &thumbnail)
 {
-    Q_EMIT sigFrameCompleted(frame, contents);
+    Q_EMIT sigFrameCompleted(frame, thumbnail);
     renderNextFrame();
 }
 
@@ -133,13 +154,17 @@ void KisStoryboardThumbnailRenderScheduler::renderNextFrame()
         return;
     }
 
-    KisImageSP image = m_image->clone(false);
+    if (!m_imageClone) {
+        m_imageClone = m_image->clone(false);
+    }
+    KisImageSP image = m_imageClone;
     KIS_SAFE_ASSERT_RECOVER_RETURN(image);
 
     int frame = !m_changedFramesQueue.isEmpty() ? m_changedFramesQueue.takeFirst() : m_affectedFramesQueue.takeFirst();;
 
     KisLockFrameGenerationLock lock(image->animationInterface());
 
+    m_renderer->setThumbnailSize(m_thumbnailSize);
     m_renderer->startFrameRegeneration(image, frame, KisAsyncAnimationRendererBase::None, std::move(lock));
     m_currentFrame = frame;
 }
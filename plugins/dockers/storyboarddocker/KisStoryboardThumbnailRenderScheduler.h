@@ -18,8 +18,12 @@ class KisAsyncStoryboardThumbnailRenderer;
 /**
  * @class KisStoryboardThumbnailRenderScheduler
  * @brief This class maintains queues of dirty frames sorted in the order of proximity
- * to the last changed frame. It regenerates the frames emits the paintdevice for each
+ * to the last changed frame. It regenerates the frames emits the thumbnail for each
  * of the frames. The m_changedFramesQueue list is given preference.
+ *
+ * All the frames are regenerated on the same clone of the image until the
+ * image is modified, so that regenerating a long board doesn't clone the
+ * whole layer stack once per panel.
  */
 class KisStoryboardThumbnailRenderScheduler : public QObject
 {
@@ -53,6 +57,12 @@ public:
      */
     void cancelFrameRendering(int frame);
 
+    /**
+     * @brief Sets the size of the thumbnails emitted in @c sigFrameCompleted().
+     * The change takes effect from the next frame rendered.
+     */
+    void setThumbnailSize(const QSize &size);
+
 public Q_SLOTS:
     void slotStartFrameRendering();
 
@@ -61,7 +71,13 @@ private Q_SLOTS:
      * @brief Emits @c sigFrameCompleted(int,KisPaintDeviceSP) if the regeneration was complete
      * and calls regeneration of the next frame in queue.
      */
-    void slotFrameRegenerationCompleted(int frame, KisPaintDeviceSP contents);
+    void slotFrameRegenerationCompleted(int frame, const QImage &thumbnail);
+
+    /**
+     * @brief Drops the cached clone of the image, the next frame will be
+     * rendered on a fresh one.
+     */
+    void slotImageModified();
 
     /**
      * @brief Emits @c sigFrameCancelled(int) and schedules the next frame for regeneration.
@@ -82,7 +98,7 @@ private:
     void renderNextFrame();
 
 Q_SIGNALS:
-    void sigFrameCompleted(int frame, KisPaintDeviceSP dev);
+    void sigFrameCompleted(int frame, const QImage &thumbnail);
     void sigFrameCancelled(int frame);
 
 private:
@@ -90,6 +106,8 @@ private:
     QVector<int> m_affectedFramesQueue;
     KisAsyncStoryboardThumbnailRenderer *m_renderer;
     KisImageSP m_image;
+    KisImageSP m_imageClone;
+    QSize m_thumbnailSize;
     int m_currentFrame;
 };
 
@@ -36,7 +36,7 @@ StoryboardModel::StoryboardModel(QObject *parent)
         , m_renderScheduler(new KisStoryboardThumbnailRenderScheduler(this))
         , m_renderSchedulingCompressor(1000,KisSignalCompressor::FIRST_ACTIVE)
 {
-    connect(m_renderScheduler, SIGNAL(sigFrameCompleted(int, KisPaintDeviceSP)), this, SLOT(slotFrameRenderCompleted(int, KisPaintDeviceSP)));
+    connect(m_renderScheduler, SIGNAL(sigFrameCompleted(int,QImage)), this, SLOT(slotFrameRenderCompleted(int,QImage)));
     connect(m_renderScheduler, SIGNAL(sigFrameCancelled(int)), this, SLOT(slotFrameRenderCancelled(int)));
     connect(&m_renderSchedulingCompressor, SIGNAL(timeout()), this, SLOT(slotUpdateThumbnails()));
     connect(&m_imageIdleWatcher, SIGNAL(startedIdleMode()), m_renderScheduler, SLOT(slotStartFrameRendering()));
@@ -268,15 +268,16 @@ bool StoryboardModel::setCommentScrollData(const QModelIndex & index, const QVar
     return false;
 }
 
-bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, const KisPaintDeviceSP & dev)
+bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, const QImage & thumbnail)
 {
     QModelIndex index = this->index(0, 0, parentIndex);
-    QRect thumbnailRect = m_view->visualRect(parentIndex);
-    float scale = qMin(thumbnailRect.height() / (float)m_image->height(), (float)thumbnailRect.width() / m_image->width());
 
-    QImage image = dev->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(), m_image->bounds());
-    QPixmap pxmap = QPixmap::fromImage(image);
-    pxmap = pxmap.scaled((1.5)*scale*m_image->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPixmap pxmap = QPixmap::fromImage(thumbnail);
+    const QSize size = m_image->size().scaled(thumbnailSize(parentIndex), Qt::KeepAspectRatio);
+    if (!size.isEmpty() && pxmap.size() != size) {
+        // the view has been resized while the frame was being rendered
+        pxmap = pxmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
 
     if (isValidBoard(index))
         return false;
@@ -292,6 +293,16 @@ bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, co
     return false;
 }
 
+QSize StoryboardModel::thumbnailSize(const QModelIndex &parentIndex) const
+{
+    if (!m_view || !m_image) return QSize();
+
+    QRect thumbnailRect = m_view->visualRect(parentIndex);
+    float scale = qMin(thumbnailRect.height() / (float)m_image->height(), (float)thumbnailRect.width() / m_image->width());
+
+    return (1.5) * scale * m_image->size();
+}
+
 bool StoryboardModel::updateDurationData(const QModelIndex& parentIndex)
 {
     if (!parentIndex.isValid()) {
@@ -1143,6 +1154,7 @@ void StoryboardModel::slotUpdateThumbnailForFrame(int frame, bool delay)
     QModelIndex index = indexFromFrame(frame);
     bool affected = true;
     if (index.isValid() && !isLocked()) {
+        m_renderScheduler->setThumbnailSize(thumbnailSize(index));
         m_renderScheduler->scheduleFrameForRegeneration(frame, affected);
         m_renderScheduler->slotStartFrameRendering();
     }
@@ -1188,11 +1200,11 @@ void StoryboardModel::slotUpdateThumbnails()
     }
 }
 
-void StoryboardModel::slotFrameRenderCompleted(int frame, KisPaintDeviceSP dev)
+void StoryboardModel::slotFrameRenderCompleted(int frame, const QImage &thumbnail)
 {
     QModelIndex index = indexFromFrame(frame);
     if (index.isValid()) {
-        setThumbnailPixmapData(index, dev);
+        setThumbnailPixmapData(index, thumbnail);
     }
 }
 
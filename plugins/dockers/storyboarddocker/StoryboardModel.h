@@ -80,11 +80,11 @@ public:
     /**
      * @brief Sets the Pixmap data.
      * @param parentIndex The index of item whose thumbnail changed.
-     * @param dev Projection of the new pixmap.
+     * @param thumbnail The downscaled projection of the frame.
      * @return @c True if data was set
      * @sa ThumbnailData
      */
-    bool setThumbnailPixmapData(const QModelIndex & parentIndex, const KisPaintDeviceSP & dev);
+    bool setThumbnailPixmapData(const QModelIndex & parentIndex, const QImage & thumbnail);
 
     /**
      * @brief updates the duration data of item at @c parentIndex to the number
@@ -277,6 +277,12 @@ private:
     bool moveRowsImpl(const QModelIndex &sourceParent, int sourceRow, int count,
                     const QModelIndex &destinationParent, int destinationChild, KUndo2Command *parentCMD = nullptr);
 
+    /**
+     * @brief The size of the thumbnail pixmap of the item at @c parentIndex,
+     * depends on the size of the item in the view.
+     */
+    QSize thumbnailSize(const QModelIndex &parentIndex) const;
+
 private Q_SLOTS:
     /**
      * @brief called when currentUiTime changes
@@ -304,9 +310,9 @@ private Q_SLOTS:
     /**
      * @brief called @c KisStoryboardThumbnailRenderScheduler when frame render is complete
      * @param frame The frame whose regeneration was requested
-     * @param dev The projection of the frame
+     * @param thumbnail The downscaled projection of the frame
      */
-    void slotFrameRenderCompleted(int frame, KisPaintDeviceSP dev);
+    void slotFrameRenderCompleted(int frame, const QImage &thumbnail);
 
     /**
      * @brief called @c KisStoryboardThumbnailRenderScheduler when frame render is cancelled.
@@ -30,6 +30,25 @@
 
 K_PLUGIN_FACTORY_WITH_JSON(KritaHalftoneFactory, "KritaHalftone.json", registerPlugin<KritaHalftone>();)
 
+namespace {
+
+/**
+ * Combines the value of the pixel with the value of the screen and
+ * applies the hardness.
+ *
+ * The values are inverted by xor-ing them with 0xFF, which is the same
+ * as subtracting them from 255, so the callers can switch between the
+ * inverted and non-inverted modes without branching in the loops.
+ */
+inline quint8 combineWithScreen(int value, int screen, int screenAlpha,
+                                const quint8 *noiseWeightLut, const quint8 *hardnessLut)
+{
+    const int result = qBound(0, value + (screen - 128) * noiseWeightLut[value] * screenAlpha / 0xFE01, 255);
+    return hardnessLut[result];
+}
+
+}
+
 KritaHalftone::KritaHalftone(QObject *parent, const QVariantList &)
     : QObject(parent)
 {
@@ -217,37 +236,35 @@ void KisHalftoneFilter::processIntensity(KisPaintDeviceSP device,
     {
         const bool invert = config->invert(prefix);
 
+        const KoColorSpace *colorSpace = device->colorSpace();
+        const int pixelSize = colorSpace->pixelSize();
+
+        const int flipMask = invert ? 0x00 : 0xFF;
+
         KisSequentialIterator maskIterator(maskDevice->pixelSelection(), applyRect);
         KisSequentialIterator dstIterator(device, applyRect);
         KisSequentialIterator srcIterator(generatorDevice, applyRect);
 
-        if (!invert) {
-            while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
+        int conseq = dstIterator.nConseqPixels();
+        while (dstIterator.nextPixels(conseq)) {
+            maskIterator.nextPixels(conseq);
+            srcIterator.nextPixels(conseq);
 
-                // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+            conseq = qMin(dstIterator.nConseqPixels(),
+                          qMin(maskIterator.nConseqPixels(), srcIterator.nConseqPixels()));
 
-                // Apply hardness
-                result = hardnessLut[result];
+            quint8 *maskPtr = maskIterator.rawData();
+            const quint8 *dstPtr = dstIterator.rawDataConst();
+            const quint8 *srcPtr = srcIterator.rawDataConst();
 
-                *maskIterator.rawData() = 255 - result;
-            }
-        } else {
-            while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+            for (int i = 0; i < conseq; i++) {
+                const int dstGray = colorSpace->intensity8(dstPtr);
 
-                // Apply hardness
-                result = hardnessLut[result];
+                maskPtr[i] = combineWithScreen(dstGray, srcPtr[0], srcPtr[1],
+                                               noiseWeightLut.constData(), hardnessLut.constData()) ^ flipMask;
 
-                *maskIterator.rawData() = result;
+                dstPtr += pixelSize;
+                srcPtr += 2;
             }
         }
         m_grayDevicesCache.putDevice(generatorDevice);
@@ -324,88 +341,57 @@ void KisHalftoneFilter::processChannel(KisPaintDeviceSP device,
 
     // Fill the device
     const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
+    const int flipMask = invert ? 0x00 : 0xFF;
 
     const KoColorSpace *colorSpace = device->colorSpace();
+    const int pixelSize = colorSpace->pixelSize();
+    const ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
+    const ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
+
+    /**
+     * In linear color spaces the screen is converted into the color
+     * space of the device. The conversion of the gray and the opacity
+     * values is independent, so it is done with a couple of LUTs
+     * instead of converting every pixel.
+     */
+    QVector<quint8> screenLut(256);
+    QVector<quint8> screenAlphaLut(256);
 
-    if (colorSpace->profile()->isLinear()) {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
+    for (int i = 0; i < 256; ++i) {
+        if (colorSpace->profile()->isLinear()) {
+            KoColor gray(QColor(i, i, i), colorSpace);
+            KoColor alpha(QColor(0, 0, 0, i), colorSpace);
+            screenLut[i] = colorSpace->scaleToU8(gray.data(), 0);
+            screenAlphaLut[i] = colorSpace->scaleToU8(alpha.data(), colorSpace->alphaPos());
         } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
+            screenLut[i] = i;
+            screenAlphaLut[i] = i;
         }
-    } else {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
-        } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
+    }
 
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+    KisSequentialIterator dstIterator(device, applyRect);
+    KisSequentialIterator srcIterator(generatorDevice, applyRect);
 
-                // Apply hardness
-                result = hardnessLut[result];
+    int conseq = dstIterator.nConseqPixels();
+    while (dstIterator.nextPixels(conseq)) {
+        srcIterator.nextPixels(conseq);
 
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
+        conseq = qMin(dstIterator.nConseqPixels(), srcIterator.nConseqPixels());
+
+        quint8 *dstPtr = dstIterator.rawData();
+        const quint8 *srcPtr = srcIterator.rawDataConst();
+
+        for (int i = 0; i < conseq; i++) {
+            const int dst = colorSpace->scaleToU8(dstPtr, channelPos) ^ flipMask;
+
+            const int result = combineWithScreen(dst, screenLut[srcPtr[0]], screenAlphaLut[srcPtr[1]],
+                                                 noiseWeightLut.constData(), hardnessLut.constData()) ^ flipMask;
+
+            ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstPtr);
+            dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
+
+            dstPtr += pixelSize;
+            srcPtr += 2;
         }
     }
 }
@@ -522,36 +508,33 @@ void KisHalftoneFilter::processAlpha(KisPaintDeviceSP device,
 
     // Fill the device
     const bool invert = config->invert(prefix);
+    const int flipMask = invert ? 0x00 : 0xFF;
+
+    const KoColorSpace *colorSpace = device->colorSpace();
+    const int pixelSize = colorSpace->pixelSize();
+
     KisSequentialIterator dstIterator(device, applyRect);
     KisSequentialIterator srcIterator(generatorDevice, applyRect);
 
-    if (!invert) {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
+    int conseq = dstIterator.nConseqPixels();
+    while (dstIterator.nextPixels(conseq)) {
+        srcIterator.nextPixels(conseq);
 
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+        conseq = qMin(dstIterator.nConseqPixels(), srcIterator.nConseqPixels());
 
-            // Apply hardness
-            result = hardnessLut[result];
+        quint8 *dstPtr = dstIterator.rawData();
+        const quint8 *srcPtr = srcIterator.rawDataConst();
 
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(255 - result), 1);
-        }
-    } else {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
+        for (int i = 0; i < conseq; i++) {
+            const int dst = colorSpace->opacityU8(dstPtr) ^ flipMask;
 
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+            const int result = combineWithScreen(dst, srcPtr[0], srcPtr[1],
+                                                 noiseWeightLut.constData(), hardnessLut.constData()) ^ flipMask;
 
-            // Apply hardness
-            result = hardnessLut[result];
+            colorSpace->setOpacity(dstPtr, static_cast<quint8>(result), 1);
 
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(result), 1);
+            dstPtr += pixelSize;
+            srcPtr += 2;
         }
     }
     m_grayDevicesCache.putDevice(generatorDevice);
@@ -588,34 +571,29 @@ void KisHalftoneFilter::processMask(KisPaintDeviceSP device,
 
     // Fill the device
     const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
+    const int flipMask = invert ? 0x00 : 0xFF;
 
-    if (!invert) {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - *dstIterator.rawData();
-            int src = *srcIterator.rawData();
+    const int pixelSize = device->colorSpace()->pixelSize();
 
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
+    KisSequentialIterator dstIterator(device, applyRect);
+    KisSequentialIterator srcIterator(generatorDevice, applyRect);
 
-            // Apply hardness
-            result = hardnessLut[result];
+    int conseq = dstIterator.nConseqPixels();
+    while (dstIterator.nextPixels(conseq)) {
+        srcIterator.nextPixels(conseq);
 
-            *dstIterator.rawData() = static_cast<quint8>(255 - result);
-        }
-    } else {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = *dstIterator.rawData();
-            int src = *srcIterator.rawData();
+        conseq = qMin(dstIterator.nConseqPixels(), srcIterator.nConseqPixels());
 
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
+        quint8 *dstPtr = dstIterator.rawData();
+        const quint8 *srcPtr = srcIterator.rawDataConst();
 
-            // Apply hardness
-            result = hardnessLut[result];
+        for (int i = 0; i < conseq; i++) {
+            // the opacity of the screen is ignored for the masks
+            *dstPtr = combineWithScreen(*dstPtr ^ flipMask, *srcPtr, 0xFF,
+                                        noiseWeightLut.constData(), hardnessLut.constData()) ^ flipMask;
 
-            *dstIterator.rawData() =  static_cast<quint8>(result);
+            dstPtr += pixelSize;
+            srcPtr += 2;
         }
     }
     m_grayDevicesCache.putDevice(generatorDevice);
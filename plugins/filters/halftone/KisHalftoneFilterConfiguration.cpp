@@ -10,6 +10,8 @@
 #include <generator/kis_generator_registry.h>
 #include <KoResourceLoadResult.h>
 
+#include <QMutexLocker>
+
 #include "KisHalftoneFilterConfiguration.h"
 
 KisHalftoneFilterConfiguration::KisHalftoneFilterConfiguration(const QString & name,
@@ -21,6 +23,8 @@ KisHalftoneFilterConfiguration::KisHalftoneFilterConfiguration(const QString & n
 KisHalftoneFilterConfiguration::KisHalftoneFilterConfiguration(const KisHalftoneFilterConfiguration &rhs)
     : KisFilterConfiguration(rhs)
 {
+    QMutexLocker l(&rhs.m_generatorConfigurationsCacheMutex);
+
     QHashIterator<QString, KisFilterConfigurationSP> it(rhs.m_generatorConfigurationsCache);
     while (it.hasNext()) {
         it.next();
@@ -46,14 +50,14 @@ void KisHalftoneFilterConfiguration::setResourcesInterface(KisResourcesInterface
             const QString fullPrefix = prefix + QString::number(i) + "_";
             KisFilterConfigurationSP generatorConfig = generatorConfiguration(fullPrefix);
             if (generatorConfig) {
-                m_generatorConfigurationsCache[fullPrefix]->setResourcesInterface(resourcesInterface);
+                generatorConfig->setResourcesInterface(resourcesInterface);
             }
         }
     } else {
         const QString prefix = mode() + "_";
         KisFilterConfigurationSP generatorConfig = generatorConfiguration(prefix);
         if (generatorConfig) {
-            m_generatorConfigurationsCache[prefix]->setResourcesInterface(resourcesInterface);
+            generatorConfig->setResourcesInterface(resourcesInterface);
         }
     }
 }
@@ -123,6 +127,13 @@ QString KisHalftoneFilterConfiguration::generatorId(const QString &prefix) const
 
 KisFilterConfigurationSP KisHalftoneFilterConfiguration::generatorConfiguration(const QString &prefix) const
 {
+    /**
+     * The configuration is shared by the concurrent jobs of the
+     * filter stroke, and the cache is filled lazily, so it needs
+     * a lock
+     */
+    QMutexLocker l(&m_generatorConfigurationsCacheMutex);
+
     if (m_generatorConfigurationsCache.contains(prefix)) {
         return m_generatorConfigurationsCache[prefix];
     } else {
@@ -194,6 +205,8 @@ void KisHalftoneFilterConfiguration::setGeneratorConfiguration(const QString &pr
     QString generatorId = this->generatorId(prefix);
     QString fullGeneratorId = prefix + "generator_" + generatorId;
     setPrefixedProperties(fullGeneratorId + "_", config);
+
+    QMutexLocker l(&m_generatorConfigurationsCacheMutex);
     m_generatorConfigurationsCache[prefix] = config;
 }
 
@@ -248,6 +261,9 @@ void KisHalftoneFilterConfiguration::setProperty(const QString &name, const QVar
     if (nameParts[generatorKeywordIndex] != "generator") {
         return;
     }
+
+    QMutexLocker l(&m_generatorConfigurationsCacheMutex);
+
     if (generatorKeywordIndex == 1) {
         m_generatorConfigurationsCache.remove(nameParts[0] + "_");
     } else {
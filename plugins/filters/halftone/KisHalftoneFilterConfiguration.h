@@ -10,6 +10,7 @@
 #define KIS_HALFTONE_FILTER_CONFIGURATION_H
 
 #include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 
@@ -107,6 +108,7 @@ public:
 
 private:
     mutable QHash<QString, KisFilterConfigurationSP> m_generatorConfigurationsCache;
+    mutable QMutex m_generatorConfigurationsCacheMutex;
 };
 
 #endif
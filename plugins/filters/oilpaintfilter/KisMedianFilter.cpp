@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMedianFilter.h"
+
+#include <klocalizedstring.h>
+
+#include <filter/kis_filter_category_ids.h>
+#include <filter/kis_filter_configuration.h>
+#include <kis_paint_device.h>
+#include "widgets/kis_multi_integer_filter_widget.h"
+#include <KisGlobalResourcesInterface.h>
+
+#include "KisSlidingIntensityHistogram.h"
+
+namespace {
+int configRadius(const KisFilterConfigurationSP config)
+{
+    return config ? config->getInt("radius", 2) : 2;
+}
+}
+
+KisMedianFilter::KisMedianFilter()
+    : KisFilter(id(), FiltersCategoryEnhanceId, i18n("&Median..."))
+{
+    setSupportsPainting(true);
+    setSupportsThreading(true);
+    setSupportsAdjustmentLayers(true);
+}
+
+void KisMedianFilter::processImpl(KisPaintDeviceSP device,
+                                  const QRect& applyRect,
+                                  const KisFilterConfigurationSP config,
+                                  KoUpdater* progressUpdater) const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(device);
+
+    auto medianIntensity = [] (const int *counts, int numBins, int numPixels) {
+        if (!numPixels) return -1;
+
+        const int medianPosition = (numPixels + 1) / 2;
+        int numPixelsBelow = 0;
+
+        for (int i = 0; i < numBins; i++) {
+            numPixelsBelow += counts[i];
+            if (numPixelsBelow >= medianPosition) {
+                return i;
+            }
+        }
+
+        return -1;
+    };
+
+    KisSlidingIntensityHistogram::process(device, applyRect, configRadius(config), 256,
+                                          medianIntensity, progressUpdater);
+}
+
+QRect KisMedianFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
+{
+    const int radius = configRadius(_config);
+    return rect.adjusted(-radius, -radius, radius, radius);
+}
+
+QRect KisMedianFilter::changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
+{
+    const int radius = configRadius(_config);
+    return rect.adjusted(-radius, -radius, radius, radius);
+}
+
+KisConfigWidget * KisMedianFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP, bool) const
+{
+    vKisIntegerWidgetParam param;
+    param.push_back(KisIntegerWidgetParam(1, 50, 2, i18n("Radius"), "radius"));
+    KisMultiIntegerFilterWidget * w = new KisMultiIntegerFilterWidget(id().id(),  parent,  id().id(),  param);
+    w->setConfiguration(defaultConfiguration(KisGlobalResourcesInterface::instance()));
+    return w;
+}
+
+KisFilterConfigurationSP KisMedianFilter::defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const
+{
+    KisFilterConfigurationSP config = factoryConfiguration(resourcesInterface);
+    config->setProperty("radius", 2);
+    return config;
+}
@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMEDIANFILTER_H
+#define KISMEDIANFILTER_H
+
+#include "filter/kis_filter.h"
+#include "kis_config_widget.h"
+
+/**
+ * Replaces every pixel with the median of its neighborhood.
+ *
+ * The neighbors are ordered by their intensity, so the result is the
+ * average color of the neighbors with the median intensity rather than
+ * a per-channel median, which would produce colors that are not
+ * present in the neighborhood.
+ */
+class KisMedianFilter : public KisFilter
+{
+public:
+    KisMedianFilter();
+
+    void processImpl(KisPaintDeviceSP device,
+                     const QRect& applyRect,
+                     const KisFilterConfigurationSP config,
+                     KoUpdater* progressUpdater) const override;
+
+    static inline KoID id() {
+        return KoID("median", i18n("Median"));
+    }
+
+    QRect neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const override;
+    QRect changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const override;
+
+    KisFilterConfigurationSP defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
+    KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
+};
+
+#endif // KISMEDIANFILTER_H
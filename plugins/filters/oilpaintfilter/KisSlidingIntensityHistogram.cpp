@@ -0,0 +1,256 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingIntensityHistogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <QRect>
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+
+namespace {
+
+struct SourceBand
+{
+    SourceBand(const KoColorSpace *cs, const QRect &rect, int numBins)
+        : rect(rect)
+        , pixelSize(cs->pixelSize())
+        , numChannels(cs->channelCount())
+        , bytes(size_t(rect.width()) * rect.height() * pixelSize)
+        , bins(size_t(rect.width()) * rect.height())
+        , channels(size_t(rect.width()) * rect.height() * numChannels)
+        , binScale((numBins - 1) / 255.0)
+    {
+    }
+
+    void read(KisPaintDeviceSP device, const KoColorSpace *cs)
+    {
+        KisSequentialConstIterator it(device, rect);
+        quint8 *dstPtr = bytes.data();
+
+        int conseq = it.nConseqPixels();
+        while (it.nextPixels(conseq)) {
+            conseq = it.nConseqPixels();
+            memcpy(dstPtr, it.oldRawData(), size_t(conseq) * pixelSize);
+            dstPtr += size_t(conseq) * pixelSize;
+        }
+
+        QVector<float> pixelChannels(numChannels);
+        const size_t numPixels = bins.size();
+
+        for (size_t i = 0; i < numPixels; i++) {
+            const quint8 *pixel = bytes.data() + i * pixelSize;
+
+            if (cs->opacityU8(pixel) == 0) {
+                // if the pixel is transparent, it's not going to provide any useful information
+                bins[i] = -1;
+                continue;
+            }
+
+            bins[i] = int(cs->intensity8(pixel) * binScale);
+
+            cs->normalisedChannelsValue(pixel, pixelChannels);
+            std::copy(pixelChannels.constBegin(), pixelChannels.constEnd(),
+                      channels.begin() + i * numChannels);
+        }
+    }
+
+    QRect rect;
+    int pixelSize;
+    int numChannels;
+    std::vector<quint8> bytes;
+    std::vector<int> bins;
+    std::vector<float> channels;
+    double binScale;
+};
+
+struct Histogram
+{
+    Histogram(int numBins, int numChannels)
+        : numChannels(numChannels)
+        , counts(numBins)
+        , sums(size_t(numBins) * numChannels)
+    {
+    }
+
+    void reset()
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        std::fill(sums.begin(), sums.end(), 0.0);
+        numPixels = 0;
+    }
+
+    void addColumn(const SourceBand &src, int column, int firstRow, int numRows)
+    {
+        for (int row = firstRow; row < firstRow + numRows; row++) {
+            const size_t index = size_t(row) * src.rect.width() + column;
+            const int bin = src.bins[index];
+            if (bin < 0) continue;
+
+            counts[bin]++;
+            numPixels++;
+
+            double *binSums = sums.data() + size_t(bin) * numChannels;
+            const float *pixelChannels = src.channels.data() + index * numChannels;
+
+            for (int i = 0; i < numChannels; i++) {
+                binSums[i] += pixelChannels[i];
+            }
+        }
+    }
+
+    void removeColumn(const SourceBand &src, int column, int firstRow, int numRows)
+    {
+        for (int row = firstRow; row < firstRow + numRows; row++) {
+            const size_t index = size_t(row) * src.rect.width() + column;
+            const int bin = src.bins[index];
+            if (bin < 0) continue;
+
+            counts[bin]--;
+            numPixels--;
+
+            double *binSums = sums.data() + size_t(bin) * numChannels;
+
+            /**
+             * Reset the emptied bins explicitly to avoid accumulating
+             * the rounding errors of the subtractions
+             */
+            if (!counts[bin]) {
+                std::fill(binSums, binSums + numChannels, 0.0);
+                continue;
+            }
+
+            const float *pixelChannels = src.channels.data() + index * numChannels;
+
+            for (int i = 0; i < numChannels; i++) {
+                binSums[i] -= pixelChannels[i];
+            }
+        }
+    }
+
+    int numChannels;
+    std::vector<int> counts;
+    std::vector<double> sums;
+    int numPixels = 0;
+};
+
+void processBand(const SourceBand &src, const QRect &band, int radius,
+                 const KoColorSpace *cs, const KisSlidingIntensityHistogram::BinPicker &picker,
+                 Histogram &histogram, std::vector<quint8> &result)
+{
+    const int windowSize = 2 * radius + 1;
+    const int numBins = histogram.counts.size();
+    const int pixelSize = src.pixelSize;
+
+    QVector<float> channel(src.numChannels);
+
+    result.resize(size_t(band.width()) * band.height() * pixelSize);
+    quint8 *dst = result.data();
+
+    for (int y = 0; y < band.height(); y++) {
+        histogram.reset();
+
+        for (int column = 0; column < windowSize - 1; column++) {
+            histogram.addColumn(src, column, y, windowSize);
+        }
+
+        for (int x = 0; x < band.width(); x++, dst += pixelSize) {
+            histogram.addColumn(src, x + windowSize - 1, y, windowSize);
+
+            const size_t centerIndex = size_t(y + radius) * src.rect.width() + x + radius;
+            const qreal middlePointAlpha = cs->opacityF(src.bytes.data() + centerIndex * pixelSize);
+
+            // if the current pixel is transparent, the result must be transparent, too.
+            const int bin = middlePointAlpha > 0 ?
+                picker(histogram.counts.data(), numBins, histogram.numPixels) : -1;
+
+            if (bin >= 0) {
+                const double *binSums = histogram.sums.data() + size_t(bin) * src.numChannels;
+                const int count = histogram.counts[bin];
+
+                for (int i = 0; i < src.numChannels; i++) {
+                    channel[i] = binSums[i] / count;
+                }
+
+                cs->fromNormalisedChannelsValue(dst, channel);
+            } else {
+                memset(dst, 0, pixelSize);
+            }
+
+            if (middlePointAlpha >= 1.0) {
+                cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
+            }
+
+            histogram.removeColumn(src, x, y, windowSize);
+        }
+    }
+}
+
+}
+
+namespace KisSlidingIntensityHistogram
+{
+
+void process(KisPaintDeviceSP device, const QRect &applyRect,
+             int radius, int numBins,
+             const BinPicker &picker,
+             KoUpdater *progressUpdater)
+{
+    if (applyRect.isEmpty()) return;
+
+    const KoColorSpace *cs = device->colorSpace();
+
+    /**
+     * The rect is processed in horizontal bands to limit the size of
+     * the buffers. The result of a band is written only after the
+     * source of the next band has been read, so the device can be
+     * filtered in-place even without a transaction. That is safe as
+     * long as the bands are not thinner than the radius.
+     */
+    const int bandHeight = qMax(64, radius);
+    const int numBands = (applyRect.height() + bandHeight - 1) / bandHeight;
+
+    Histogram histogram(numBins, cs->channelCount());
+
+    std::vector<quint8> result;
+    QRect resultRect;
+
+    for (int i = 0; i < numBands; i++) {
+        if (progressUpdater && progressUpdater->interrupted()) {
+            return;
+        }
+
+        const int bandTop = applyRect.y() + i * bandHeight;
+        const QRect band(applyRect.x(), bandTop,
+                         applyRect.width(), qMin(bandHeight, applyRect.y() + applyRect.height() - bandTop));
+
+        SourceBand src(cs, band.adjusted(-radius, -radius, radius, radius), numBins);
+        src.read(device, cs);
+
+        if (!resultRect.isEmpty()) {
+            device->writeBytes(result.data(), resultRect);
+        }
+
+        processBand(src, band, radius, cs, picker, histogram, result);
+        resultRect = band;
+
+        if (progressUpdater) {
+            progressUpdater->setProgress(100 * (i + 1) / numBands);
+        }
+    }
+
+    device->writeBytes(result.data(), resultRect);
+}
+
+}
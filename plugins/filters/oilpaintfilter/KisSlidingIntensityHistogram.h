@@ -0,0 +1,57 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSLIDINGINTENSITYHISTOGRAM_H
+#define KISSLIDINGINTENSITYHISTOGRAM_H
+
+#include <functional>
+
+#include <kis_types.h>
+
+class QRect;
+class KoUpdater;
+
+/**
+ * The engine of the neighborhood filters that pick the color of a
+ * pixel from the histogram of the intensities of its neighbors (oil
+ * paint, median).
+ *
+ * Every pixel of the window falls into one of \p numBins intensity
+ * bins, every bin keeps the number of its pixels and the sums of their
+ * normalized channels. The resulting color is the average color of
+ * the bin chosen by the picker.
+ *
+ * The histogram slides along the rows of the image (Huang's algorithm),
+ * so every step adds and removes one column of the window instead of
+ * rebuilding the entire histogram, i.e. the cost per pixel is O(radius)
+ * instead of O(radius^2).
+ */
+namespace KisSlidingIntensityHistogram
+{
+
+/**
+ * Chooses the bin the resulting color is taken from.
+ *
+ * @param counts the number of the pixels in every bin
+ * @param numPixels the total number of the pixels in the histogram
+ * @return the index of the bin or -1 if there is no suitable bin
+ */
+using BinPicker = std::function<int(const int *counts, int numBins, int numPixels)>;
+
+/**
+ * Filters \p applyRect of \p device in-place. The source pixels are
+ * read with oldRawData(), so the device may be processed in several
+ * concurrent patches when it has a transaction open. Fully transparent
+ * pixels don't contribute to the histogram.
+ */
+void process(KisPaintDeviceSP device, const QRect &applyRect,
+             int radius, int numBins,
+             const BinPicker &picker,
+             KoUpdater *progressUpdater);
+
+}
+
+#endif // KISSLIDINGINTENSITYHISTOGRAM_H
@@ -40,11 +40,13 @@
 #include "widgets/kis_multi_integer_filter_widget.h"
 #include <KisGlobalResourcesInterface.h>
 
+#include "KisSlidingIntensityHistogram.h"
+
 
 KisOilPaintFilter::KisOilPaintFilter() : KisFilter(id(), FiltersCategoryArtisticId, i18n("&Oilpaint..."))
 {
     setSupportsPainting(true);
-    setSupportsThreading(false);
+    setSupportsThreading(true);
     setSupportsAdjustmentLayers(true);
 }
 
@@ -60,129 +62,41 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
     const quint32 brushSize = config ? config->getInt("brushSize", 1) : 1;
     const quint32 smooth = config ? config->getInt("smooth", 30) : 30;
 
-    OilPaint(device, device, applyRect, brushSize, smooth, progressUpdater);
+    OilPaint(device, applyRect, brushSize, smooth, progressUpdater);
 }
 
 // This method have been ported from Pieter Z. Voloshyn algorithm code.
 
 /* Function to apply the OilPaint effect.
  *
- * data             => The image data in RGBA mode.
- * w                => Width of image.
- * h                => Height of image.
  * BrushSize        => Brush size.
  * Smoothness       => Smooth value.
  *
- * Theory           => Using MostFrequentColor function we take the main color in
- *                     a matrix and simply write at the original position.
+ * Theory           => Using the most frequent intensity in a matrix with the
+ *                     analyzed pixel in the center of this matrix, we take the
+ *                     average color of the pixels with this intensity and simply
+ *                     write it at the original position.
  */
 
-void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
+void KisOilPaintFilter::OilPaint(KisPaintDeviceSP device, const QRect &applyRect,
                                  int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
 {
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
-
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
-    }
-}
-
-// This method has been ported from Pieter Z. Voloshyn's algorithm code in Digikam.
-
-/* Function to determine the most frequent color in a matrix
- *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
- *
- * Theory           => This function creates a matrix with the analyzed pixel in
- *                     the center of this matrix and find the most frequent color
- */
-
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& /*bounds*/, int X, int Y, int Radius, int Intensity) const
-{
-    uint I;
-
-    double Scale = Intensity / 255.0;
-
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1)];
-
-    const KoColorSpace* cs = src->colorSpace();
-
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
-
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
-
-    int startx = X - Radius;
-    int starty = Y - Radius;
-    int width = (2 * Radius) + 1;
-    int height = (2 * Radius) + 1;
-
-    qreal middlePointAlpha = 1;
-    {
-        // if the current pixel is transparent, the result must be transparent, too.
-        KisSequentialConstIterator middlePointIt(src, QRect(X, Y, 1, 1));
-        middlePointIt.nextPixel();
-        middlePointAlpha = cs->opacityF(middlePointIt.oldRawData());
-    }
-
-
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (middlePointAlpha > 0 && srcIt.nextPixel()) {
-
-        cs->normalisedChannelsValue(srcIt.oldRawData(), channel);
-
-        if (cs->opacityU8(srcIt.oldRawData()) == 0) {
-            // if the pixel is transparent, it's not going to provide any useful information
-            continue;
-        }
-
-        I = (uint)(cs->intensity8(srcIt.oldRawData()) * Scale);
-
-        IntensityCount[I]++;
-
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
+    auto mostFrequentIntensity = [] (const int *counts, int numBins, int /*numPixels*/) {
+        int I = -1;
+        int MaxInstance = 0;
+
+        for (int i = 0 ; i < numBins ; ++i) {
+            if (counts[i] > MaxInstance) {
+                I = i;
+                MaxInstance = counts[i];
             }
         }
-    }
-
-    I = 0;
-    int MaxInstance = 0;
-
-    for (int i = 0 ; i <= Intensity ; ++i) {
-        if (IntensityCount[i] > MaxInstance) {
-            I = i;
-            MaxInstance = IntensityCount[i];
-        }
-    }
-
-    if (MaxInstance != 0) {
-        channel = AverageChannels[I];
-        for (int i = 0; i < channel.size(); i++) {
-            channel[i] /= MaxInstance;
-        }
-        cs->fromNormalisedChannelsValue(dst, channel);
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    } else {
-        memset(dst, 0, cs->pixelSize());
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    }
 
+        return I;
+    };
 
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
+    KisSlidingIntensityHistogram::process(device, applyRect, BrushSize, Smoothness + 1,
+                                          mostFrequentIntensity, progressUpdater);
 }
 
 QRect KisOilPaintFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
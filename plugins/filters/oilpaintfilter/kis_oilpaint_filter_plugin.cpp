@@ -11,6 +11,7 @@
 #include <kpluginfactory.h>
 
 #include "kis_oilpaint_filter.h"
+#include "KisMedianFilter.h"
 #include "kis_global.h"
 #include "filter/kis_filter_registry.h"
 
@@ -19,6 +20,7 @@ K_PLUGIN_FACTORY_WITH_JSON(KisOilPaintFilterPluginFactory, "kritaoilpaintfilter.
 KisOilPaintFilterPlugin::KisOilPaintFilterPlugin(QObject *parent, const QVariantList &) : QObject(parent)
 {
     KisFilterRegistry::instance()->add(new KisOilPaintFilter());
+    KisFilterRegistry::instance()->add(new KisMedianFilter());
 
 }
 
@@ -0,0 +1,230 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingIntensityHistogramTest.h"
+
+#include <simpletest.h>
+
+#include <QRandomGenerator>
+
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_transaction.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include <KisGlobalResourcesInterface.h>
+#include <krita_utils.h>
+
+namespace {
+
+const QRect imageRect(0, 0, 97, 150);
+
+KisPaintDeviceSP createRandomDevice()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    QRandomGenerator random(17);
+    QVector<quint8> bytes(imageRect.width() * imageRect.height() * 4);
+
+    for (int i = 0; i < bytes.size(); i += 4) {
+        // few intensity levels to have the bins with many pixels
+        bytes[i] = quint8(random.bounded(8) * 32);
+        bytes[i + 1] = quint8(random.bounded(8) * 32);
+        bytes[i + 2] = quint8(random.bounded(8) * 32);
+
+        // a few transparent and semi-transparent pixels
+        const int alpha = random.bounded(10);
+        bytes[i + 3] = alpha == 0 ? 0 : alpha == 1 ? 128 : 255;
+    }
+
+    dev->writeBytes(bytes.constData(), imageRect);
+    return dev;
+}
+
+/**
+ * The straightforward implementation that rebuilds the histogram for
+ * every pixel, as the oil paint filter used to do
+ */
+template<typename Picker>
+KisPaintDeviceSP referenceFilter(KisPaintDeviceSP src, const QRect &rect,
+                                 int radius, int numBins, Picker picker)
+{
+    const KoColorSpace *cs = src->colorSpace();
+    KisPaintDeviceSP dst = new KisPaintDevice(*src);
+
+    const QRect srcRect = rect.adjusted(-radius, -radius, radius, radius);
+    QVector<quint8> srcBytes(srcRect.width() * srcRect.height() * 4);
+    src->readBytes(srcBytes.data(), srcRect);
+
+    QVector<quint8> dstBytes(rect.width() * rect.height() * 4);
+    QVector<float> channels(4);
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            QVector<int> counts(numBins);
+            QVector<double> sums(numBins * 4);
+            int numPixels = 0;
+
+            for (int wy = y; wy < y + 2 * radius + 1; wy++) {
+                for (int wx = x; wx < x + 2 * radius + 1; wx++) {
+                    const quint8 *pixel = srcBytes.constData() + (wy * srcRect.width() + wx) * 4;
+                    if (!cs->opacityU8(pixel)) continue;
+
+                    const int bin = int(cs->intensity8(pixel) * (numBins - 1) / 255.0);
+                    cs->normalisedChannelsValue(pixel, channels);
+
+                    counts[bin]++;
+                    numPixels++;
+                    for (int i = 0; i < 4; i++) {
+                        sums[bin * 4 + i] += channels[i];
+                    }
+                }
+            }
+
+            const quint8 *center = srcBytes.constData() + ((y + radius) * srcRect.width() + x + radius) * 4;
+            quint8 *result = dstBytes.data() + (y * rect.width() + x) * 4;
+
+            const qreal centerAlpha = cs->opacityF(center);
+            const int bin = centerAlpha > 0 ? picker(counts, numPixels) : -1;
+
+            if (bin >= 0) {
+                for (int i = 0; i < 4; i++) {
+                    channels[i] = sums[bin * 4 + i] / counts[bin];
+                }
+                cs->fromNormalisedChannelsValue(result, channels);
+            } else {
+                memset(result, 0, 4);
+            }
+
+            if (centerAlpha >= 1.0) {
+                cs->setOpacity(result, OPACITY_OPAQUE_U8, 1);
+            }
+        }
+    }
+
+    dst->writeBytes(dstBytes.constData(), rect);
+    return dst;
+}
+
+void compareWithTolerance(KisPaintDeviceSP dev, KisPaintDeviceSP ref, const QRect &rect)
+{
+    QVector<quint8> devBytes(rect.width() * rect.height() * 4);
+    QVector<quint8> refBytes(devBytes.size());
+
+    dev->readBytes(devBytes.data(), rect);
+    ref->readBytes(refBytes.data(), rect);
+
+    for (int i = 0; i < devBytes.size(); i++) {
+        if (qAbs(int(devBytes[i]) - int(refBytes[i])) > 1) {
+            qDebug() << "Pixel" << (i / 4) % rect.width() << (i / 4) / rect.width()
+                     << "channel" << i % 4 << devBytes[i] << refBytes[i];
+            QFAIL("The result differs from the reference one");
+        }
+    }
+}
+
+KisFilterConfigurationSP filterConfig(KisFilterSP filter, const QString &key, int radius)
+{
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty(key, radius);
+    return config->cloneWithResourcesSnapshot();
+}
+
+}
+
+void KisSlidingIntensityHistogramTest::testOilPaint()
+{
+    KisFilterSP filter = KisFilterRegistry::instance()->value("oilpaint");
+    QVERIFY(filter);
+
+    const int radius = 3;
+    const int smooth = 30;
+
+    KisFilterConfigurationSP config = filterConfig(filter, "brushSize", radius);
+    config->setProperty("smooth", smooth);
+
+    KisPaintDeviceSP src = createRandomDevice();
+    KisPaintDeviceSP ref = referenceFilter(src, imageRect, radius, smooth + 1,
+        [] (const QVector<int> &counts, int) {
+            int result = -1;
+            int maxCount = 0;
+            for (int i = 0; i < counts.size(); i++) {
+                if (counts[i] > maxCount) {
+                    result = i;
+                    maxCount = counts[i];
+                }
+            }
+            return result;
+        });
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*src);
+    filter->process(dev, imageRect, config);
+
+    compareWithTolerance(dev, ref, imageRect);
+}
+
+void KisSlidingIntensityHistogramTest::testMedian()
+{
+    KisFilterSP filter = KisFilterRegistry::instance()->value("median");
+    QVERIFY(filter);
+
+    const int radius = 4;
+    KisFilterConfigurationSP config = filterConfig(filter, "radius", radius);
+
+    KisPaintDeviceSP src = createRandomDevice();
+    KisPaintDeviceSP ref = referenceFilter(src, imageRect, radius, 256,
+        [] (const QVector<int> &counts, int numPixels) {
+            if (!numPixels) return -1;
+
+            int numPixelsBelow = 0;
+            for (int i = 0; i < counts.size(); i++) {
+                numPixelsBelow += counts[i];
+                if (numPixelsBelow >= (numPixels + 1) / 2) {
+                    return i;
+                }
+            }
+            return -1;
+        });
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*src);
+    filter->process(dev, imageRect, config);
+
+    compareWithTolerance(dev, ref, imageRect);
+}
+
+void KisSlidingIntensityHistogramTest::testPatches()
+{
+    KisFilterSP filter = KisFilterRegistry::instance()->value("median");
+    QVERIFY(filter);
+    QVERIFY(filter->supportsThreading());
+
+    KisFilterConfigurationSP config = filterConfig(filter, "radius", 5);
+
+    KisPaintDeviceSP src = createRandomDevice();
+
+    KisPaintDeviceSP whole = new KisPaintDevice(*src);
+    filter->process(whole, imageRect, config);
+
+    /**
+     * The filter stroke processes the patches of a device with an
+     * open transaction, the patches must not see the results of
+     * each other
+     */
+    KisPaintDeviceSP patched = new KisPaintDevice(*src);
+    KisTransaction transaction(patched);
+
+    Q_FOREACH (const QRect &patch, KritaUtils::splitRectIntoPatches(imageRect, QSize(32, 40))) {
+        filter->processImpl(patched, patch, config, 0);
+    }
+
+    transaction.end();
+
+    compareWithTolerance(patched, whole, imageRect);
+}
+
+SIMPLE_TEST_MAIN(KisSlidingIntensityHistogramTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSLIDINGINTENSITYHISTOGRAMTEST_H
+#define KISSLIDINGINTENSITYHISTOGRAMTEST_H
+
+#include <simpletest.h>
+
+class KisSlidingIntensityHistogramTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOilPaint();
+    void testMedian();
+    void testPatches();
+};
+
+#endif // KISSLIDINGINTENSITYHISTOGRAMTEST_H
@@ -9,6 +9,8 @@
 #include "kis_unsharp_filter.h"
 #include <QBitArray>
 
+#include <vector>
+
 #include <kis_mask_generator.h>
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
@@ -162,21 +164,34 @@ void KisUnsharpFilter::processLightnessOnly(KisPaintDeviceSP device,
     const KoColorSpace *cs = device->colorSpace();
     const int pixelSize = cs->pixelSize();
 
-    quint16 labColorSrc[4];
-    quint16 labColorDst[4];
-
     const int posL = 0;
     const int posAlpha = 3;
 
     const qreal factorInv = 1.0 / factor;
 
+    /**
+     * The conversions to and from Lab are done for the whole runs of
+     * consecutive pixels, converting them one-by-one costs more than
+     * the filter itself
+     */
+    std::vector<quint16> labColorsSrc;
+    std::vector<quint16> labColorsDst;
+
     KisSequentialIteratorProgress dstIt(device, rect, progressUpdater);
 
-    while (dstIt.nextPixel()) {
-        quint8 diff = cs->differenceA(dstIt.oldRawData(), dstIt.rawDataConst());
-        if (diff >= threshold) {
-            cs->toLabA16(dstIt.oldRawData(), (quint8*)labColorSrc, 1);
-            cs->toLabA16(dstIt.rawDataConst(), (quint8*)labColorDst, 1);
+    int conseq = dstIt.nConseqPixels();
+    while (dstIt.nextPixels(conseq)) {
+        conseq = dstIt.nConseqPixels();
+
+        labColorsSrc.resize(4 * conseq);
+        labColorsDst.resize(4 * conseq);
+
+        cs->toLabA16(dstIt.oldRawData(), reinterpret_cast<quint8*>(labColorsSrc.data()), conseq);
+        cs->toLabA16(dstIt.rawDataConst(), reinterpret_cast<quint8*>(labColorsDst.data()), conseq);
+
+        for (int i = 0; i < conseq; i++) {
+            quint16 *labColorSrc = labColorsSrc.data() + 4 * i;
+            const quint16 *labColorDst = labColorsDst.data() + 4 * i;
 
             qint32 valueL = (labColorSrc[posL] * weights[0] + labColorDst[posL] * weights[1]) * factorInv;
             labColorSrc[posL] = CLAMP(valueL,
@@ -187,10 +202,25 @@ void KisUnsharpFilter::processLightnessOnly(KisPaintDeviceSP device,
             labColorSrc[posAlpha] = CLAMP(valueAlpha,
                                           KoColorSpaceMathsTraits<quint16>::min,
                                           KoColorSpaceMathsTraits<quint16>::max);
+        }
 
-            cs->fromLabA16((quint8*)labColorSrc, dstIt.rawData(), 1);
+        if (threshold == 0) {
+            cs->fromLabA16(reinterpret_cast<const quint8*>(labColorsSrc.data()), dstIt.rawData(), conseq);
         } else {
-            memcpy(dstIt.rawData(), dstIt.oldRawData(), pixelSize);
+            const quint8 *oldPixel = dstIt.oldRawData();
+            quint8 *pixel = dstIt.rawData();
+
+            for (int i = 0; i < conseq; i++) {
+                quint8 diff = cs->differenceA(oldPixel, pixel);
+                if (diff >= threshold) {
+                    cs->fromLabA16(reinterpret_cast<const quint8*>(labColorsSrc.data() + 4 * i), pixel, 1);
+                } else {
+                    memcpy(pixel, oldPixel, pixelSize);
+                }
+
+                oldPixel += pixelSize;
+                pixel += pixelSize;
+            }
         }
     }
 }
@@ -331,17 +331,39 @@ void KisScreentoneGenerator::generate(KisProcessingInformation dst,
     KisSelectionSP selection = new KisSelection(device->defaultBounds(), KisImageResolutionProxy::identity());
     KisSequentialIterator it(selection->pixelSelection(), bounds);
 
-    if (!config->invert()) {
-        while (it.nextPixel()) {
-            qreal v = std::round(sampler(it.x(), it.y()) * 10000.0) / 10000.0;
+    const bool invert = config->invert();
+    auto valueToSelectionByte =
+        [invert, &postprocessingFunction](qreal v) -> quint8
+        {
             v = qBound(0.0, postprocessingFunction(v), 1.0);
-            *it.rawData() = 255 - static_cast<quint8>(qRound(v * 255.0));
-        }
-    } else {
-        while (it.nextPixel()) {
-            qreal v = std::round(sampler(it.x(), it.y()) * 10000.0) / 10000.0;
-            v = qBound(0.0, postprocessingFunction(v), 1.0);
-            *it.rawData() = static_cast<quint8>(qRound(v * 255.0));
+            const quint8 byte = static_cast<quint8>(qRound(v * 255.0));
+            return invert ? byte : 255 - byte;
+        };
+
+    /**
+     * The sampled values are quantized to 1/10000 before postprocessing,
+     * so the resulting selection bytes can be tabulated once instead of
+     * evaluating the brightness/contrast function for every pixel
+     */
+    const int numQuantizationSteps = 10000;
+    QVector<quint8> selectionBytes(numQuantizationSteps + 1);
+    for (int i = 0; i <= numQuantizationSteps; ++i) {
+        selectionBytes[i] = valueToSelectionByte(i / static_cast<qreal>(numQuantizationSteps));
+    }
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
+
+        quint8 *dstPtr = it.rawData();
+        const int y = it.y();
+        const int x = it.x();
+
+        for (int i = 0; i < conseq; ++i) {
+            const qreal step = std::round(sampler(x + i, y) * numQuantizationSteps);
+            dstPtr[i] = step >= 0.0 && step <= numQuantizationSteps
+                        ? selectionBytes[static_cast<int>(step)]
+                        : valueToSelectionByte(step / numQuantizationSteps);
         }
     }
     checkUpdaterInterruptedAndSetPercent(progressUpdater, 25);
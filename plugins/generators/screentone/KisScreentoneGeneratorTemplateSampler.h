@@ -19,32 +19,41 @@ class KisScreentoneGeneratorAlignedTemplateSampler
 public:
     KisScreentoneGeneratorAlignedTemplateSampler(const Template &the_template)
         : m_template(the_template)
+        , m_screenPosition(std::round(the_template.screenPosition().x()),
+                           std::round(the_template.screenPosition().y()))
+        , m_macrocellWidth(static_cast<qreal>(the_template.macrocellSize().width()))
+        , m_macrocellHeight(static_cast<qreal>(the_template.macrocellSize().height()))
+        , m_templateWidth(the_template.templateSize().width())
+        , m_templateData(the_template.templateData().constData())
     {}
 
     qreal operator()(qreal x, qreal y) const
     {
         // Get the coordinates in template space
-        QPointF p(
-            x + std::round(m_template.screenPosition().x()),
-            y + std::round(m_template.screenPosition().y())
-        );
+        QPointF p(x + m_screenPosition.x(), y + m_screenPosition.y());
         // Get the coordinates in screen space
         const QPointF screenPos = m_template.templateToScreenTransform().map(p);
         // Get x/y indices in macrocell units or the current macrocell tile
         // position
-        const qreal a = -std::floor(screenPos.x() / static_cast<qreal>(m_template.macrocellSize().width()));
-        const qreal b = -std::floor(screenPos.y() / static_cast<qreal>(m_template.macrocellSize().height()));
+        const qreal a = -std::floor(screenPos.x() / m_macrocellWidth);
+        const qreal b = -std::floor(screenPos.y() / m_macrocellHeight);
         // Get the correspondent point in the (0, 0) macrocell tile
         p += QPointF(a * m_template.v1().x() + b * m_template.v2().x(), a * m_template.v1().y() + b * m_template.v2().y());
 
         const int i = static_cast<int>(std::floor(p.x())) + m_template.originOffset().x();
         const int j = static_cast<int>(std::floor(p.y())) + m_template.originOffset().y();
-        const int macrocellPointIndex = j * m_template.templateSize().width() + i;
-        return m_template.templateData()[macrocellPointIndex];
+        const int macrocellPointIndex = j * m_templateWidth + i;
+        return m_templateData[macrocellPointIndex];
     }
 
 private:
     const Template& m_template;
+    // Cached template properties used for every sample
+    const QPointF m_screenPosition;
+    const qreal m_macrocellWidth;
+    const qreal m_macrocellHeight;
+    const int m_templateWidth;
+    const qreal *m_templateData;
 };
 
 template <typename Template>
@@ -53,6 +62,11 @@ class KisScreentoneGeneratorUnAlignedTemplateSampler
 public:
     KisScreentoneGeneratorUnAlignedTemplateSampler(const Template &the_template)
         : m_template(the_template)
+        , m_macrocellWidth(the_template.macrocellSize().width())
+        , m_macrocellHeight(the_template.macrocellSize().height())
+        , m_templateWidth(the_template.templateSize().width())
+        , m_templateHeight(the_template.templateSize().height())
+        , m_templateData(the_template.templateData().constData())
     {}
 
     qreal operator()(qreal x, qreal y) const
@@ -61,32 +75,34 @@ public:
         qreal xx, yy;
         m_template.imageToScreenTransform().map(x, y, &xx, &yy);
         // Convert to coordinate inside the macrocell
-        xx -= std::floor(xx / m_template.macrocellSize().width()) * m_template.macrocellSize().width();
-        yy -= std::floor(yy / m_template.macrocellSize().height()) * m_template.macrocellSize().height();
+        xx -= std::floor(xx / m_macrocellWidth) * m_macrocellWidth;
+        yy -= std::floor(yy / m_macrocellHeight) * m_macrocellHeight;
         // Get template coordinates
         QPointF templatePoint = m_template.screenToTemplateTransform().map(QPointF(xx, yy)) +
                                 m_template.originOffset();
         
         // Bilinear interpolation
         // Get integer coordinates of the template points to use in the interpolation
+        const qreal floorX = std::floor(templatePoint.x());
+        const qreal floorY = std::floor(templatePoint.y());
         const int ix0 =
-            templatePoint.x() < 0.0 ? m_template.templateSize().width() - 1 :
-                (templatePoint.x() >= m_template.templateSize().width() ? 0.0 :
-                    static_cast<int>(std::floor(templatePoint.x())));
+            templatePoint.x() < 0.0 ? m_templateWidth - 1 :
+                (templatePoint.x() >= m_templateWidth ? 0 : static_cast<int>(floorX));
         const int iy0 =
-            templatePoint.y() < 0.0 ? m_template.templateSize().height() - 1 :
-                (templatePoint.y() >= m_template.templateSize().height() ? 0.0 :
-                    static_cast<int>(std::floor(templatePoint.y())));
-        const int ix1 = ix0 == m_template.templateSize().width() - 1 ? 0 : ix0 + 1;
-        const int iy1 = iy0 == m_template.templateSize().height() - 1 ? 0 : iy0 + 1;
+            templatePoint.y() < 0.0 ? m_templateHeight - 1 :
+                (templatePoint.y() >= m_templateHeight ? 0 : static_cast<int>(floorY));
+        const int ix1 = ix0 == m_templateWidth - 1 ? 0 : ix0 + 1;
+        const int iy1 = iy0 == m_templateHeight - 1 ? 0 : iy0 + 1;
         // Get the template values for the points
-        const qreal topLeftValue = m_template.templateData()[iy0 * m_template.templateSize().width() + ix0];
-        const qreal topRightValue = m_template.templateData()[iy0 * m_template.templateSize().width() + ix1];
-        const qreal bottomLeftValue = m_template.templateData()[iy1 * m_template.templateSize().width() + ix0];
-        const qreal bottomRightValue = m_template.templateData()[iy1 * m_template.templateSize().width() + ix1];
+        const qreal *topRow = m_templateData + iy0 * m_templateWidth;
+        const qreal *bottomRow = m_templateData + iy1 * m_templateWidth;
+        const qreal topLeftValue = topRow[ix0];
+        const qreal topRightValue = topRow[ix1];
+        const qreal bottomLeftValue = bottomRow[ix0];
+        const qreal bottomRightValue = bottomRow[ix1];
         // Get the fractional part of the point to use in the interpolation
-        const qreal fractionalX = templatePoint.x() - std::floor(templatePoint.x());
-        const qreal fractionalY = templatePoint.y() - std::floor(templatePoint.y());
+        const qreal fractionalX = templatePoint.x() - floorX;
+        const qreal fractionalY = templatePoint.y() - floorY;
         // Perform bilinear interpolation
         const qreal a = topLeftValue * (1.0 - fractionalX) + topRightValue * fractionalX;
         const qreal b = bottomLeftValue * (1.0 - fractionalX) + bottomRightValue * fractionalX;
@@ -97,6 +113,12 @@ public:
 
 private:
     const Template& m_template;
+    // Cached template properties used for every sample
+    const int m_macrocellWidth;
+    const int m_macrocellHeight;
+    const int m_templateWidth;
+    const int m_templateHeight;
+    const qreal *m_templateData;
 };
 
 #endif
@@ -21,6 +21,7 @@ public:
     VariableMap m_vars;
 
     SeExprExpressionContext(const QString &expr);
+    ~SeExprExpressionContext() override;
 
     virtual KSeExpr::ExprVarRef *resolveVar(const std::string &name) const override;
 };
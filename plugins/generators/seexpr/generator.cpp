@@ -8,6 +8,7 @@
 
 #include <KisSequentialIteratorProgress.h>
 #include <KoUpdater.h>
+#include <QVector>
 #include <cstring>
 #include <filter/kis_filter_configuration.h>
 #include <generator/kis_generator_registry.h>
@@ -129,19 +130,34 @@ void KisSeExprGenerator::generate(KisProcessingInformation dstInfo, const QSize
 
             KisSequentialIteratorProgress it(device, bounds, progressUpdater);
 
-            while (it.nextPixel()) {
-                u = pixel_stride_x * (it.x() + .5);
+            /**
+             * The expression is evaluated into a row of RGBA-F32 pixels
+             * first, so that every run of the iterator is converted into
+             * the color space of the device with a single call to the
+             * color converter
+             */
+            QVector<float> row;
+
+            int conseq = it.nConseqPixels();
+            while (it.nextPixels(conseq)) {
+                conseq = it.nConseqPixels();
+                row.resize(4 * conseq);
+
                 v = pixel_stride_y * (it.y() + .5);
 
-                const double *value = expression.evalFP();
+                float *pixel = row.data();
+                for (int i = 0; i < conseq; i++, pixel += 4) {
+                    u = pixel_stride_x * (it.x() + i + .5);
+
+                    const double *value = expression.evalFP();
 
-                KoColor c(src);
-                reinterpret_cast<float *>(c.data())[0] = value[0];
-                reinterpret_cast<float *>(c.data())[1] = value[1];
-                reinterpret_cast<float *>(c.data())[2] = value[2];
-                c.setOpacity(OPACITY_OPAQUE_F);
+                    pixel[0] = value[0];
+                    pixel[1] = value[1];
+                    pixel[2] = value[2];
+                    pixel[3] = OPACITY_OPAQUE_F;
+                }
 
-                conv->transform(c.data(), it.rawData(), 1);
+                conv->transform(reinterpret_cast<const quint8 *>(row.constData()), it.rawData(), conseq);
             }
             delete conv;
         }
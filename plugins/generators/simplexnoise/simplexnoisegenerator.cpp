@@ -15,6 +15,7 @@
 #include <KisSequentialIteratorProgress.h>
 #include <KoUpdater.h>
 #include <QCryptographicHash>
+#include <QVector>
 #include <filter/kis_filter_configuration.h>
 #include <generator/kis_generator_registry.h>
 #include <KoColorModelStandardIds.h>
@@ -72,37 +73,56 @@ void KisSimplexNoiseGenerator::generate(KisProcessingInformation dst, const QSiz
 
     bool looping = (config && config->getProperty("looping", property)) ? property.toBool() : false;
 
+    /**
+     * The noise is written into a row of GrayA-F32 pixels first, so
+     * that every run of the iterator is converted into the color space
+     * of the device with a single call to the color converter
+     */
+    QVector<float> row;
+
+    int conseq = it.nConseqPixels();
+
     if( looping ){
         float major_radius = 0.5f * frequency * ratio_x;
         float minor_radius = 0.5f * frequency * ratio_y;
-        while(it.nextPixel()){
-            double x_phase = (double)it.x() / (double)whole_image_bounds.width() * M_PI * 2;
+        while(it.nextPixels(conseq)){
+            conseq = it.nConseqPixels();
+            row.resize(2 * conseq);
+
             double y_phase = (double)it.y() / (double)(whole_image_bounds.height()) * M_PI * 2;
-            double x_coordinate = major_radius * map_range(cos(x_phase), -1.0, 1.0, 0.0, 1.0);
-            double y_coordinate = major_radius * map_range(sin(x_phase), -1.0, 1.0, 0.0, 1.0);
             double z_coordinate = minor_radius * map_range(cos(y_phase), -1.0, 1.0, 0.0, 1.0);
             double w_coordinate = minor_radius * map_range(sin(y_phase), -1.0, 1.0, 0.0, 1.0);
-            double value = open_simplex_noise4(noise_context, x_coordinate, y_coordinate, z_coordinate, w_coordinate);
-            value = map_range(value, -1.0, 1.0, 0.0, 1.0);
 
-            KoColor c(src);
-            reinterpret_cast<float *>(c.data())[0] = value;
-            c.setOpacity(OPACITY_OPAQUE_F);
+            for (int i = 0; i < conseq; i++) {
+                double x_phase = (double)(it.x() + i) / (double)whole_image_bounds.width() * M_PI * 2;
+                double x_coordinate = major_radius * map_range(cos(x_phase), -1.0, 1.0, 0.0, 1.0);
+                double y_coordinate = major_radius * map_range(sin(x_phase), -1.0, 1.0, 0.0, 1.0);
+                double value = open_simplex_noise4(noise_context, x_coordinate, y_coordinate, z_coordinate, w_coordinate);
+                value = map_range(value, -1.0, 1.0, 0.0, 1.0);
 
-            conv->transform(c.data(), it.rawData(), 1);
+                row[2 * i] = value;
+                row[2 * i + 1] = OPACITY_OPAQUE_F;
+            }
+
+            conv->transform(reinterpret_cast<const quint8*>(row.constData()), it.rawData(), conseq);
         }
     } else {
-        while(it.nextPixel()){
-            double x_phase = (double)it.x() / (double)(whole_image_bounds.width()) * ratio_x;
+        while(it.nextPixels(conseq)){
+            conseq = it.nConseqPixels();
+            row.resize(2 * conseq);
+
             double y_phase = (double)it.y() / (double)(whole_image_bounds.height()) * ratio_y;
-            double value = open_simplex_noise4(noise_context, x_phase * frequency, y_phase * frequency, x_phase * frequency, y_phase * frequency);
-            value = map_range(value, -1.0, 1.0, 0.0, 1.0);
 
-            KoColor c(src);
-            reinterpret_cast<float *>(c.data())[0] = value;
-            c.setOpacity(OPACITY_OPAQUE_F);
+            for (int i = 0; i < conseq; i++) {
+                double x_phase = (double)(it.x() + i) / (double)(whole_image_bounds.width()) * ratio_x;
+                double value = open_simplex_noise4(noise_context, x_phase * frequency, y_phase * frequency, x_phase * frequency, y_phase * frequency);
+                value = map_range(value, -1.0, 1.0, 0.0, 1.0);
+
+                row[2 * i] = value;
+                row[2 * i + 1] = OPACITY_OPAQUE_F;
+            }
 
-            conv->transform(c.data(), it.rawData(), 1);
+            conv->transform(reinterpret_cast<const quint8*>(row.constData()), it.rawData(), conseq);
         }
     }
     delete conv;
@@ -15,6 +15,7 @@
 #include <ImfHeader.h>
 #include <ImfInputFile.h>
 #include <ImfOutputFile.h>
+#include <ImfTiledOutputFile.h>
 
 #include <ImfStringAttribute.h>
 #include "exr_extra_tags.h"
@@ -31,6 +32,7 @@
 #include <KoColorModelStandardIds.h>
 #include <KoColor.h>
 #include <KoColorProfile.h>
+#include <KoColorConversionTransformation.h>
 
 #include <KisDocument.h>
 #include <kis_group_layer.h>
@@ -118,6 +120,7 @@ void ExrPaintLayerInfo::updateImageType(ImageType channelType)
 struct ExrPaintLayerSaveInfo {
     QString name; ///< name of the layer with a "." at the end (ie "group1.group2.layer1.")
     KisPaintDeviceSP layerDevice;
+    const KoColorSpace *colorSpace = nullptr; ///< the color space the device is converted to on writing
     KisPaintLayerSP layer;
     QList<QString> channels;
     Imf::PixelType pixelType;
@@ -128,6 +131,8 @@ struct EXRConverter::Private {
         : doc(0)
         , alphaWasModified(false)
         , showNotifications(false)
+        , tiledOutput(false)
+        , compression(Imf::ZIP_COMPRESSION)
     {}
 
     KisImageSP image;
@@ -135,6 +140,8 @@ struct EXRConverter::Private {
 
     bool alphaWasModified;
     bool showNotifications;
+    bool tiledOutput;
+    Imf::Compression compression;
 
     QString errorMessage;
 
@@ -154,6 +161,7 @@ struct EXRConverter::Private {
     void recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveInfo>& informationObjects, const QString& name, KisGroupLayerSP parent);
     void reportLayersNotSaved(const QSet<KisNodeSP> &layersNotSaved);
     QString fetchExtraLayersInfo(QList<ExrPaintLayerSaveInfo>& informationObjects);
+    KisImportExportErrorCode writeFile(const QString &filename, Imf::Header &header, const QList<ExrPaintLayerSaveInfo>& informationObjects);
 };
 
 EXRConverter::EXRConverter(KisDocument *doc, bool showNotifications)
@@ -949,6 +957,29 @@ KisImportExportErrorCode EXRConverter::buildImage(const QString &filename)
 }
 
 
+void EXRConverter::setTiledOutput(bool value)
+{
+    d->tiledOutput = value;
+}
+
+void EXRConverter::setCompression(const QString &name)
+{
+    static const QMap<QString, Imf::Compression> compressions = {
+        {"none", Imf::NO_COMPRESSION},
+        {"rle", Imf::RLE_COMPRESSION},
+        {"zips", Imf::ZIPS_COMPRESSION},
+        {"zip", Imf::ZIP_COMPRESSION},
+        {"piz", Imf::PIZ_COMPRESSION},
+        {"pxr24", Imf::PXR24_COMPRESSION},
+        {"b44", Imf::B44_COMPRESSION},
+        {"b44a", Imf::B44A_COMPRESSION},
+        {"dwaa", Imf::DWAA_COMPRESSION},
+        {"dwab", Imf::DWAB_COMPRESSION}
+    };
+
+    d->compression = compressions.value(name.toLower(), Imf::ZIP_COMPRESSION);
+}
+
 KisImageSP EXRConverter::image()
 {
     return d->image;
@@ -968,8 +999,8 @@ class Encoder
 {
 public:
     virtual ~Encoder() {}
-    virtual void prepareFrameBuffer(Imf::FrameBuffer*, int line) = 0;
-    virtual void encodeData(int line) = 0;
+    virtual void prepareFrameBuffer(Imf::FrameBuffer*, const QRect &rect) = 0;
+    virtual void encodeData(const QRect &rect) = 0;
 
 };
 
@@ -977,83 +1008,92 @@ template<typename _T_, int size, int alphaPos>
 class EncoderImpl : public Encoder
 {
 public:
-    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width), m_width(width) {}
+    EncoderImpl(const ExrPaintLayerSaveInfo* _info) : info(_info) {}
     ~EncoderImpl() override {}
-    void prepareFrameBuffer(Imf::FrameBuffer*, int line) override;
-    void encodeData(int line) override;
+    void prepareFrameBuffer(Imf::FrameBuffer*, const QRect &rect) override;
+    void encodeData(const QRect &rect) override;
 private:
     typedef ExrPixel_<_T_, size> ExrPixel;
-    Imf::OutputFile* file;
     const ExrPaintLayerSaveInfo* info;
     QVector<ExrPixel> pixels;
-    int m_width;
+    QVector<quint8> sourceBytes;
 };
 
 template<typename _T_, int size, int alphaPos>
-void EncoderImpl<_T_, size, alphaPos>::prepareFrameBuffer(Imf::FrameBuffer* frameBuffer, int line)
+void EncoderImpl<_T_, size, alphaPos>::prepareFrameBuffer(Imf::FrameBuffer* frameBuffer, const QRect &rect)
 {
-    int xstart = 0;
-    int ystart = 0;
-    ExrPixel* frameBufferData = (pixels.data()) - xstart - (ystart + line) * m_width;
+    pixels.resize(rect.width() * rect.height());
+
+    ExrPixel* frameBufferData = (pixels.data()) - rect.x() - rect.y() * rect.width();
     for (int k = 0; k < size; ++k) {
         frameBuffer->insert(info->channels[k].toUtf8(),
                             Imf::Slice(info->pixelType, (char *) &frameBufferData->data[k],
                                        sizeof(ExrPixel) * 1,
-                                       sizeof(ExrPixel) * m_width));
+                                       sizeof(ExrPixel) * rect.width()));
     }
 }
 
 template<typename _T_, int size, int alphaPos>
-void EncoderImpl<_T_, size, alphaPos>::encodeData(int line)
+void EncoderImpl<_T_, size, alphaPos>::encodeData(const QRect &rect)
 {
-    ExrPixel *rgba = pixels.data();
-    KisHLineConstIteratorSP it = info->layerDevice->createHLineConstIteratorNG(0, line, m_width);
-    do {
-        const _T_* dst = reinterpret_cast < const _T_* >(it->oldRawData());
-
-        for (int i = 0; i < size; ++i) {
-            rgba->data[i] = dst[i];
-        }
+    const int numPixels = rect.width() * rect.height();
+    const KoColorSpace *srcColorSpace = info->layerDevice->colorSpace();
+    quint8 *dstBytes = reinterpret_cast<quint8*>(pixels.data());
+
+    /**
+     * The device is converted into the color space of the file strip
+     * by strip, so that we wouldn't need a converted copy of the
+     * entire layer
+     */
+    if (*srcColorSpace == *info->colorSpace) {
+        info->layerDevice->readBytes(dstBytes, rect);
+    } else {
+        sourceBytes.resize(numPixels * srcColorSpace->pixelSize());
+        info->layerDevice->readBytes(sourceBytes.data(), rect);
+        srcColorSpace->convertPixelsTo(sourceBytes.data(), dstBytes, info->colorSpace, numPixels,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    }
 
-        if (alphaPos != -1) {
+    if (alphaPos != -1) {
+        ExrPixel *rgba = pixels.data();
+        for (int i = 0; i < numPixels; ++i, ++rgba) {
             multiplyAlpha<_T_, ExrPixel, size, alphaPos>(rgba);
         }
-
-        ++rgba;
-    } while (it->nextPixel());
+    }
 }
 
-Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int width)
+Encoder* encoder(const ExrPaintLayerSaveInfo& info)
 {
-    dbgFile << "Create encoder for" << info.name << info.channels << info.layerDevice->colorSpace()->channelCount();
-    switch (info.layerDevice->colorSpace()->channelCount()) {
+    dbgFile << "Create encoder for" << info.name << info.channels << info.colorSpace->channelCount();
+    switch (info.colorSpace->channelCount()) {
     case 1: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.colorSpace->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl < half, 1, -1 > (&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+            return new EncoderImpl < half, 1, -1 > (&info);
+        } else if (info.colorSpace->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl < float, 1, -1 > (&file, &info, width);
+            return new EncoderImpl < float, 1, -1 > (&info);
         }
         break;
     }
     case 2: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.colorSpace->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl<half, 2, 1>(&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+            return new EncoderImpl<half, 2, 1>(&info);
+        } else if (info.colorSpace->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl<float, 2, 1>(&file, &info, width);
+            return new EncoderImpl<float, 2, 1>(&info);
         }
         break;
     }
     case 4: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.colorSpace->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl<half, 4, 3>(&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+            return new EncoderImpl<half, 4, 3>(&info);
+        } else if (info.colorSpace->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl<float, 4, 3>(&file, &info, width);
+            return new EncoderImpl<float, 4, 3>(&info);
         }
         break;
     }
@@ -1063,31 +1103,63 @@ Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int w
     return 0;
 }
 
-void encodeData(Imf::OutputFile& file, const QList<ExrPaintLayerSaveInfo>& informationObjects, int width, int height)
+/**
+ * The scanline file gets the data in strips of several lines, so that
+ * OpenEXR could compress its line blocks in its own thread pool
+ */
+int stripHeight(Imf::OutputFile &/*file*/)
+{
+    return 64;
+}
+
+void writeStrip(Imf::OutputFile &file, const QRect &rect)
+{
+    file.writePixels(rect.height());
+}
+
+/**
+ * The tiled file gets the data in rows of tiles, all the tiles of
+ * the row are compressed in parallel by OpenEXR
+ */
+int stripHeight(Imf::TiledOutputFile &file)
+{
+    return file.tileYSize();
+}
+
+void writeStrip(Imf::TiledOutputFile &file, const QRect &rect)
+{
+    const int tileRow = rect.y() / file.tileYSize();
+    file.writeTiles(0, file.numXTiles() - 1, tileRow, tileRow);
+}
+
+template<class OutputFileType>
+void encodeData(OutputFileType& file, const QList<ExrPaintLayerSaveInfo>& informationObjects, int width, int height)
 {
     QList<Encoder*> encoders;
     Q_FOREACH (const ExrPaintLayerSaveInfo& info, informationObjects) {
-        encoders.push_back(encoder(file, info, width));
+        encoders.push_back(encoder(info));
     }
 
-    for (int y = 0; y < height; ++y) {
+    const int linesPerStrip = stripHeight(file);
+
+    for (int y = 0; y < height; y += linesPerStrip) {
+        const QRect strip(0, y, width, qMin(linesPerStrip, height - y));
+
         Imf::FrameBuffer frameBuffer;
         Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->prepareFrameBuffer(&frameBuffer, y);
+            encoder->prepareFrameBuffer(&frameBuffer, strip);
         }
         file.setFrameBuffer(frameBuffer);
         Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->encodeData(y);
+            encoder->encodeData(strip);
         }
-        file.writePixels(1);
+        writeStrip(file, strip);
     }
     qDeleteAll(encoders);
 }
 
-KisPaintDeviceSP wrapLayerDevice(KisPaintDeviceSP device)
+const KoColorSpace* exrColorSpace(const KoColorSpace *cs)
 {
-    const KoColorSpace *cs = device->colorSpace();
-
     if (cs->colorDepthId() != Float16BitsColorDepthID && cs->colorDepthId() != Float32BitsColorDepthID) {
         /**
          * We should try to keep the same profile of the space when possible
@@ -1111,12 +1183,36 @@ KisPaintDeviceSP wrapLayerDevice(KisPaintDeviceSP device)
             cs->colorDepthId().id());
     }
 
-    if (*cs != *device->colorSpace()) {
-        device = new KisPaintDevice(*device);
-        device->convertTo(cs);
-    }
+    return cs;
+}
+
+KisImportExportErrorCode EXRConverter::Private::writeFile(const QString &filename, Imf::Header &header, const QList<ExrPaintLayerSaveInfo>& informationObjects)
+{
+    const int width = header.dataWindow().max.x - header.dataWindow().min.x + 1;
+    const int height = header.dataWindow().max.y - header.dataWindow().min.y + 1;
 
-    return device;
+    header.compression() = compression;
+
+    // Open file for writing
+    try {
+        if (tiledOutput) {
+            header.setTileDescription(Imf::TileDescription(64, 64, Imf::ONE_LEVEL));
+
+            Imf::TiledOutputFile file(filename.toUtf8(), header);
+            encodeData(file, informationObjects, width, height);
+        } else {
+            Imf::OutputFile file(filename.toUtf8(), header);
+            encodeData(file, informationObjects, width, height);
+        }
+        return ImportExportCodes::OK;
+
+    } catch(std::exception &e) {
+        dbgFile << "Exception while writing to exr file: " << e.what();
+        if (!KisImportExportAdditionalChecks::isFileWritable(filename)) {
+            return ImportExportCodes::NoAccessToWrite;
+        }
+        return ImportExportCodes::ErrorWhileWriting;
+    }
 }
 
 KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPaintLayerSP layer)
@@ -1134,18 +1230,19 @@ KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPai
 
     ExrPaintLayerSaveInfo info;
     info.layer = layer;
-    info.layerDevice = wrapLayerDevice(layer->paintDevice());
+    info.layerDevice = layer->paintDevice();
+    info.colorSpace = exrColorSpace(info.layerDevice->colorSpace());
     Imf::PixelType pixelType = Imf::NUM_PIXELTYPES;
-    if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+    if (info.colorSpace->colorDepthId() == Float16BitsColorDepthID) {
         pixelType = Imf::HALF;
     }
-    else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+    else if (info.colorSpace->colorDepthId() == Float32BitsColorDepthID) {
         pixelType = Imf::FLOAT;
     }
 
     info.pixelType = pixelType;
 
-    if (info.layerDevice->colorSpace()->colorModelId() == RGBAColorModelID) {
+    if (info.colorSpace->colorModelId() == RGBAColorModelID) {
         header.channels().insert("R", Imf::Channel(pixelType));
         header.channels().insert("G", Imf::Channel(pixelType));
         header.channels().insert("B", Imf::Channel(pixelType));
@@ -1155,13 +1252,13 @@ KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPai
         info.channels.push_back("G");
         info.channels.push_back("B");
         info.channels.push_back("A");
-    } else if (info.layerDevice->colorSpace()->colorModelId() == GrayAColorModelID) {
+    } else if (info.colorSpace->colorModelId() == GrayAColorModelID) {
         header.channels().insert("Y", Imf::Channel(pixelType));
         header.channels().insert("A", Imf::Channel(pixelType));
 
         info.channels.push_back("Y");
         info.channels.push_back("A");
-    } else if (info.layerDevice->colorSpace()->colorModelId() == XYZAColorModelID) {
+    } else if (info.colorSpace->colorModelId() == XYZAColorModelID) {
         header.channels().insert("X", Imf::Channel(pixelType));
         header.channels().insert("Y", Imf::Channel(pixelType));
         header.channels().insert("Z", Imf::Channel(pixelType));
@@ -1173,23 +1270,9 @@ KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPai
         info.channels.push_back("A");
     }
 
-    // Open file for writing
-    try {
-        Imf::OutputFile file(filename.toUtf8(), header);
-
-        QList<ExrPaintLayerSaveInfo> informationObjects;
-        informationObjects.push_back(info);
-        encodeData(file, informationObjects, width, height);
-        return ImportExportCodes::OK;
-
-    } catch(std::exception &e) {
-        dbgFile << "Exception while writing to exr file: " << e.what();
-        if (!KisImportExportAdditionalChecks::isFileWritable(filename)) {
-            return ImportExportCodes::NoAccessToWrite;
-        }
-        return ImportExportCodes::ErrorWhileWriting;
-    }
-
+    QList<ExrPaintLayerSaveInfo> informationObjects;
+    informationObjects.push_back(info);
+    return d->writeFile(filename, header, informationObjects);
 }
 
 QString remap(const QMap<QString, QString>& current2original, const QString& current)
@@ -1270,7 +1353,8 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
             ExrPaintLayerSaveInfo info;
             info.name = name + paintLayer->name() + '.';
             info.layer = paintLayer;
-            info.layerDevice = wrapLayerDevice(paintLayer->paintDevice());
+            info.layerDevice = paintLayer->paintDevice();
+            info.colorSpace = exrColorSpace(info.layerDevice->colorSpace());
 
             if (info.name == QString(HDR_LAYER) + ".") {
                 info.channels.push_back("R");
@@ -1280,16 +1364,16 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
             }
             else {
 
-                if (info.layerDevice->colorSpace()->colorModelId() == RGBAColorModelID) {
+                if (info.colorSpace->colorModelId() == RGBAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "R"));
                     info.channels.push_back(info.name + remap(current2original, "G"));
                     info.channels.push_back(info.name + remap(current2original, "B"));
                     info.channels.push_back(info.name + remap(current2original, "A"));
                 }
-                else if (info.layerDevice->colorSpace()->colorModelId() == GrayAColorModelID) {
+                else if (info.colorSpace->colorModelId() == GrayAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "Y"));
                     info.channels.push_back(info.name + remap(current2original, "A"));
-                } else if (info.layerDevice->colorSpace()->colorModelId() == XYZAColorModelID) {
+                } else if (info.colorSpace->colorModelId() == XYZAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "X"));
                     info.channels.push_back(info.name + remap(current2original, "Y"));
                     info.channels.push_back(info.name + remap(current2original, "Z"));
@@ -1297,10 +1381,10 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
                 }
             }
 
-            if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+            if (info.colorSpace->colorDepthId() == Float16BitsColorDepthID) {
                 info.pixelType = Imf::HALF;
             }
-            else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+            else if (info.colorSpace->colorDepthId() == Float32BitsColorDepthID) {
                 info.pixelType = Imf::FLOAT;
             }
             else {
@@ -1425,18 +1509,7 @@ KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisGro
             }
         }
 
-        // Open file for writing
-        try {
-            Imf::OutputFile file(filename.toUtf8(), header);
-            encodeData(file, informationObjects, width, height);
-            return ImportExportCodes::OK;
-        } catch(std::exception &e) {
-            dbgFile << "Exception while writing to exr file: " << e.what();
-            if (!KisImportExportAdditionalChecks::isFileWritable(filename.toUtf8())) {
-                return ImportExportCodes::NoAccessToWrite;
-            }
-            return ImportExportCodes::ErrorWhileWriting;
-        }
+        return d->writeFile(filename, header, informationObjects);
 
     }
 }
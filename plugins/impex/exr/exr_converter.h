@@ -26,6 +26,21 @@ public:
     KisImportExportErrorCode buildImage(const QString &filename);
     KisImportExportErrorCode buildFile(const QString &filename, KisPaintLayerSP layer);
     KisImportExportErrorCode buildFile(const QString &filename, KisGroupLayerSP layer, bool flatten=false);
+
+    /**
+     * Write the file as a tiled EXR instead of a scanline one. The
+     * importers of the compositing applications can then read the
+     * regions of the image without decoding the entire file.
+     */
+    void setTiledOutput(bool value);
+
+    /**
+     * Set the compression of the file: "none", "rle", "zips", "zip",
+     * "piz", "pxr24", "b44", "b44a", "dwaa" or "dwab". Unknown names
+     * fall back to "zip".
+     */
+    void setCompression(const QString &name);
+
     /**
      * Retrieve the constructed image
      */
@@ -7,6 +7,7 @@
 #include "exr_export.h"
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QSlider>
 #include <QApplication>
 
@@ -44,6 +45,8 @@ KisPropertiesConfigurationSP EXRExport::defaultConfiguration(const QByteArray &/
 {
     KisPropertiesConfigurationSP cfg = new KisPropertiesConfiguration();
     cfg->setProperty("flatten", false);
+    cfg->setProperty("tiled", false);
+    cfg->setProperty("compression", "zip");
     return cfg;
 }
 
@@ -61,6 +64,8 @@ KisImportExportErrorCode EXRExport::convert(KisDocument *document, QIODevice */*
     Q_ASSERT(image);
 
     EXRConverter exrConverter(document, !batchMode());
+    exrConverter.setTiledOutput(configuration->getBool("tiled", false));
+    exrConverter.setCompression(configuration->getString("compression", "zip"));
 
     KisImportExportErrorCode res;
 
@@ -106,12 +111,18 @@ void EXRExport::initializeCapabilities()
 void KisWdgOptionsExr::setConfiguration(const KisPropertiesConfigurationSP cfg)
 {
     chkFlatten->setChecked(cfg->getBool("flatten", false));
+    chkTiled->setChecked(cfg->getBool("tiled", false));
+
+    const int compressionIndex = cmbCompression->findData(cfg->getString("compression", "zip"));
+    cmbCompression->setCurrentIndex(compressionIndex >= 0 ? compressionIndex : cmbCompression->findData("zip"));
 }
 
 KisPropertiesConfigurationSP KisWdgOptionsExr::configuration() const
 {
     KisPropertiesConfigurationSP cfg = new KisPropertiesConfiguration();
     cfg->setProperty("flatten", chkFlatten->isChecked());
+    cfg->setProperty("tiled", chkTiled->isChecked());
+    cfg->setProperty("compression", cmbCompression->currentData().toString());
     return cfg;
 }
 
@@ -9,6 +9,8 @@
 
 #include <QVariant>
 
+#include <klocalizedstring.h>
+
 #include <KisImportExportFilter.h>
 #include <kis_config_widget.h>
 #include "ui_exr_export_widget.h"
@@ -22,6 +24,17 @@ public:
         : KisConfigWidget(parent)
     {
         setupUi(this);
+
+        cmbCompression->addItem(i18nc("EXR compression", "None"), "none");
+        cmbCompression->addItem(i18nc("EXR compression", "RLE"), "rle");
+        cmbCompression->addItem(i18nc("EXR compression", "ZIP, single scanline"), "zips");
+        cmbCompression->addItem(i18nc("EXR compression", "ZIP"), "zip");
+        cmbCompression->addItem(i18nc("EXR compression", "PIZ"), "piz");
+        cmbCompression->addItem(i18nc("EXR compression", "PXR24 (lossy)"), "pxr24");
+        cmbCompression->addItem(i18nc("EXR compression", "B44 (lossy)"), "b44");
+        cmbCompression->addItem(i18nc("EXR compression", "B44A (lossy)"), "b44a");
+        cmbCompression->addItem(i18nc("EXR compression", "DWAA (lossy)"), "dwaa");
+        cmbCompression->addItem(i18nc("EXR compression", "DWAB (lossy)"), "dwab");
     }
 
     void setConfiguration(const KisPropertiesConfigurationSP  cfg) override;
@@ -13,6 +13,7 @@
 
 #include <half.h>
 #include <KisMimeDatabase.h>
+#include <kis_properties_configuration.h>
 #include "filestest.h"
 
 #ifndef FILES_DATA_DIR
@@ -93,6 +94,41 @@ void KisExrTest::testRoundTrip()
 
 }
 
+void KisExrTest::testRoundTripTiled()
+{
+    QString inputFileName(TestUtil::fetchDataFileLazy("CandleGlass.exr"));
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->importDocument(inputFileName));
+    QVERIFY(doc1->image());
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".exr"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+
+    KisPropertiesConfigurationSP exportConfiguration = new KisPropertiesConfiguration();
+    exportConfiguration->setProperty("flatten", false);
+    exportConfiguration->setProperty("tiled", true);
+    exportConfiguration->setProperty("compression", "piz");
+
+    QVERIFY(doc1->exportDocumentSync(savedFileName, ExrMimetype.toLatin1(), exportConfiguration));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->errorMessage().isEmpty());
+    QVERIFY(doc2->image());
+
+    QVERIFY(TestUtil::comparePaintDevicesClever<half>(
+                doc1->image()->root()->firstChild()->paintDevice(),
+                doc2->image()->root()->firstChild()->paintDevice(),
+                0.01 /* meaningless alpha */));
+}
+
 KISTEST_MAIN(KisExrTest)
 
 
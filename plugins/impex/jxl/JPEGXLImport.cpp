@@ -485,13 +485,27 @@ JPEGXLImport::convert(KisDocument *document, QIODevice *io, KisPropertiesConfigu
         return ImportExportCodes::InternalError;
     }
 
-    if (JXL_DEC_SUCCESS
-        != JxlDecoderSubscribeEvents(dec.get(),
-                                     JXL_DEC_COLOR_ENCODING | JXL_DEC_FULL_IMAGE | JXL_DEC_BOX | JXL_DEC_FRAME)) {
+    /**
+     * A single-frame image can be previewed while it is being decoded:
+     * the decoder gives us the low-resolution (DC) pass first and we
+     * show it to the user until the full image is ready
+     */
+    const bool publishProgressivePass = !batchMode() && !isAnimated && !isMultilayer && !isMultipage && !d.isCMYK;
+
+    int events = JXL_DEC_COLOR_ENCODING | JXL_DEC_FULL_IMAGE | JXL_DEC_BOX | JXL_DEC_FRAME;
+    if (publishProgressivePass) {
+        events |= JXL_DEC_FRAME_PROGRESSION;
+    }
+
+    if (JXL_DEC_SUCCESS != JxlDecoderSubscribeEvents(dec.get(), events)) {
         errFile << "JxlDecoderSubscribeEvents failed";
         return ImportExportCodes::InternalError;
     }
 
+    if (publishProgressivePass && JXL_DEC_SUCCESS != JxlDecoderSetProgressiveDetail(dec.get(), kDC)) {
+        warnFile << "JxlDecoderSetProgressiveDetail failed, the preview will not be shown";
+    }
+
     if (JXL_DEC_SUCCESS != JxlDecoderSetParallelRunner(dec.get(), JxlResizableParallelRunner, runner.get())) {
         errFile << "JxlDecoderSetParallelRunner failed";
         return ImportExportCodes::InternalError;
@@ -888,6 +902,11 @@ JPEGXLImport::convert(KisDocument *document, QIODevice *io, KisPropertiesConfigu
                     }
                 }
             }
+        } else if (status == JXL_DEC_FRAME_PROGRESSION) {
+            if (JXL_DEC_SUCCESS == JxlDecoderFlushImage(dec.get())) {
+                generateCallback(d);
+                publishPreview(d.m_currentFrame->createThumbnail(1024, 1024));
+            }
         } else if (status == JXL_DEC_FULL_IMAGE) {
             // Parse raw data using existing callback function
             generateCallback(d);
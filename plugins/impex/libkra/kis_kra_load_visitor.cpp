@@ -553,6 +553,19 @@ struct FramedDevicePolicy
     int m_frameId;
 };
 
+struct SharedTilesFramedDeviceLoadPolicy : FramedDevicePolicy
+{
+    SharedTilesFramedDeviceLoadPolicy(int frameId, int baseFrameId)
+        : FramedDevicePolicy(frameId),
+          m_baseFrameId(baseFrameId) {}
+
+    bool read(KisPaintDeviceSP dev, QIODevice *stream) {
+        return dev->framesInterface()->readFrame(stream, m_frameId, m_baseFrameId);
+    }
+
+    int m_baseFrameId;
+};
+
 bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location)
 {
     // Layer data
@@ -566,26 +579,63 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
     if (!frameInterface || frames.count() <= 1) {
         return loadPaintDeviceFrame(device, location, SimpleDevicePolicy());
     } else {
-        KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+        QSet<int> visitedFrames;
 
         for (int i = 0; i < frames.count(); i++) {
-            int id = frames[i];
-            if (keyframeChannel->frameFilename(id).isEmpty()) {
-                m_warningMessages << i18n("Could not find keyframe pixel data for frame %1 in %2.", id, location);
-            }
-            else {
-                Q_ASSERT(!keyframeChannel->frameFilename(id).isEmpty());
-                QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
-                Q_ASSERT(!frameFilename.isEmpty());
+            loadRasterFrame(device, frames[i], location, visitedFrames);
+        }
+    }
 
-                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
-                    m_warningMessages << i18n("Could not load keyframe pixel data for frame %1 in %2.", id, location);
-                }
+    return true;
+}
+
+void KisKraLoadVisitor::loadRasterFrame(KisPaintDeviceSP device, int id, const QString &location, QSet<int> &visitedFrames)
+{
+    if (visitedFrames.contains(id)) return;
+    visitedFrames.insert(id);
+
+    KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+
+    if (keyframeChannel->frameFilename(id).isEmpty()) {
+        m_warningMessages << i18n("Could not find keyframe pixel data for frame %1 in %2.", id, location);
+        return;
+    }
+
+    QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
+    Q_ASSERT(!frameFilename.isEmpty());
+
+    /**
+     * The frame may be stored as the difference against another frame
+     * it shares tiles with. The base frame is loaded first, and the
+     * tiles missing in the file are shared with it.
+     */
+    int baseFrameId = -1;
+
+    if (m_store->hasFile(frameFilename + ".baseframe") && m_store->open(frameFilename + ".baseframe")) {
+        const QString baseFilename = QString::fromUtf8(m_store->read(m_store->size()));
+        m_store->close();
+
+        Q_FOREACH (int frame, device->framesInterface()->frames()) {
+            if (frame != id && keyframeChannel->frameFilename(frame) == baseFilename) {
+                baseFrameId = frame;
+                break;
             }
         }
+
+        if (baseFrameId >= 0) {
+            loadRasterFrame(device, baseFrameId, location, visitedFrames);
+        } else {
+            m_warningMessages << i18n("Could not find the base frame %1 of keyframe pixel data %2.", baseFilename, frameFilename);
+        }
     }
 
-    return true;
+    const bool result = baseFrameId >= 0 ?
+        loadPaintDeviceFrame(device, frameFilename, SharedTilesFramedDeviceLoadPolicy(id, baseFrameId)) :
+        loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id));
+
+    if (!result) {
+        m_warningMessages << i18n("Could not load keyframe pixel data for frame %1 in %2.", id, location);
+    }
 }
 
 template<class DevicePolicy>
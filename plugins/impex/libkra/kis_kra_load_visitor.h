@@ -9,6 +9,7 @@
 #define KIS_KRA_LOAD_VISITOR_H_
 
 #include <QStringList>
+#include <QSet>
 
 // kritaimage
 #include "kis_types.h"
@@ -63,6 +64,8 @@ private:
     template<class DevicePolicy>
     bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy);
 
+    void loadRasterFrame(KisPaintDeviceSP device, int id, const QString &location, QSet<int> &visitedFrames);
+
     bool loadProfile(KisPaintDeviceSP device,  const QString& location);
     bool loadFilterConfiguration(KisFilterConfigurationSP kfc, const QString& location);
     const KoColorProfile* loadProfile(const QString& location, const QString &colorModelId, const QString &colorDepthId);
@@ -665,6 +665,22 @@ void KisKraLoader::loadAudio(KoStore *store, KisDocument *kisDoc)
     }
 }
 
+void KisKraLoader::loadLodComposite(KoStore *store, KisDocument *kisDoc)
+{
+    if (!store->hasFile("mergedimage_lod.png")) return;
+
+    if (store->open("mergedimage_lod.png")) {
+        QImage composite;
+        composite.loadFromData(store->read(store->size()), "PNG");
+        store->close();
+
+        // the composite is optional, so a broken one is just ignored
+        if (!composite.isNull()) {
+            kisDoc->setStoredLodComposite(composite);
+        }
+    }
+}
+
 void KisKraLoader::backCompat_loadAudio(const QDomElement& elem, KisImageSP image, KisDocument *document)
 {
     QDomDocument dom;
@@ -12,6 +12,9 @@
 #include <QBuffer>
 #include <QByteArray>
 
+#include <algorithm>
+#include <limits>
+
 #include <KoColorProfile.h>
 #include <KoStore.h>
 #include <KoColorSpace.h>
@@ -78,6 +81,16 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setTileSavingCache(KisTileSavingCacheSP cache)
+{
+    m_writer->setTileSavingCache(cache);
+}
+
+void KisKraSaveVisitor::setTileCompressionEnabled(bool value)
+{
+    m_writer->setTileCompressionEnabled(value);
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -334,6 +347,46 @@ struct FramedDevicePolicy
     int m_frameId;
 };
 
+struct SharedTilesFramedDeviceSavePolicy : FramedDevicePolicy
+{
+    SharedTilesFramedDeviceSavePolicy(int frameId, int baseFrameId)
+        : FramedDevicePolicy(frameId),
+          m_baseFrameId(baseFrameId) {}
+
+    bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
+        return dev->framesInterface()->writeFrame(store, m_frameId, m_baseFrameId);
+    }
+
+    int m_baseFrameId;
+};
+
+namespace {
+
+/**
+ * The number of the previously saved frames that are checked for
+ * the tiles shared with the frame being saved
+ */
+const int MAX_BASE_FRAME_CANDIDATES = 4;
+
+int findBaseFrame(KisPaintDeviceFramesInterface *frameInterface, int frameId, const QList<int> &savedFrames)
+{
+    int baseFrameId = -1;
+    int maxSharedTiles = 0;
+
+    for (int i = savedFrames.size() - 1; i >= qMax(0, savedFrames.size() - MAX_BASE_FRAME_CANDIDATES); i--) {
+        const int numSharedTiles = frameInterface->numSharedFrameTiles(frameId, savedFrames[i]);
+
+        if (numSharedTiles > maxSharedTiles) {
+            maxSharedTiles = numSharedTiles;
+            baseFrameId = savedFrames[i];
+        }
+    }
+
+    return baseFrameId;
+}
+
+}
+
 bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
                                         QString location)
 {
@@ -352,6 +405,24 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
         savePaintDeviceFrame(device, location, SimpleDevicePolicy());
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+        const bool shareFrameTiles = cfg.shareFrameTilesInKra();
+
+        /**
+         * The frames are saved in the order of their time, so that the
+         * frames that are likely to share tiles (the hold frames and
+         * their edited duplicates) are saved one after another
+         */
+        auto frameTime = [keyframeChannel] (int id) {
+            const QSet<int> times = keyframeChannel->timesForFrameID(id);
+            return times.isEmpty() ? std::numeric_limits<int>::max() : *std::min_element(times.begin(), times.end());
+        };
+
+        std::stable_sort(frames.begin(), frames.end(),
+                         [frameTime] (int lhs, int rhs) {
+                             return frameTime(lhs) < frameTime(rhs);
+                         });
+
+        QList<int> savedFrames;
 
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
@@ -359,9 +430,22 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
             QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
             Q_ASSERT(!frameFilename.isEmpty());
 
-            if (!savePaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
+            const int baseFrameId = shareFrameTiles ? findBaseFrame(frameInterface, id, savedFrames) : -1;
+
+            if (baseFrameId >= 0) {
+                if (!savePaintDeviceFrame(device, frameFilename, SharedTilesFramedDeviceSavePolicy(id, baseFrameId))) {
+                    return false;
+                }
+
+                if (m_store->open(frameFilename + ".baseframe")) {
+                    m_store->write(keyframeChannel->frameFilename(baseFrameId).toUtf8());
+                    m_store->close();
+                }
+            } else if (!savePaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
                 return false;
             }
+
+            savedFrames.append(id);
         }
     }
 
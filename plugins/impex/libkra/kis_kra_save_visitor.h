@@ -11,11 +11,12 @@
 #include <QStringList>
 
 #include "kis_types.h"
+#include "tiles3/KisTileSavingCache.h"
 #include "kis_node_visitor.h"
 #include "kis_image.h"
 #include "kritalibkra_export.h"
 
-class KisPaintDeviceWriter;
+class KisStorePaintDeviceWriter;
 class KoStore;
 
 class KRITALIBKRA_EXPORT KisKraSaveVisitor : public KisNodeVisitor
@@ -28,6 +29,19 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * Lets the paint devices reuse the tiles serialized by the previous
+     * saving of the same document, the cache should be shared between
+     * the savings (e.g. autosaves)
+     */
+    void setTileSavingCache(KisTileSavingCacheSP cache);
+
+    /**
+     * Disabling the compression of the tiles makes the saving much
+     * faster, but the file becomes several times bigger
+     */
+    void setTileCompressionEnabled(bool value);
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -79,7 +93,7 @@ private:
     QString m_uri;
     QString m_name;
     QMap<const KisNode*, QString> m_nodeFileNames;
-    KisPaintDeviceWriter *m_writer;
+    KisStorePaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
 };
 
@@ -478,6 +478,9 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
     if (external)
         visitor.setExternalUri(uri);
 
+    visitor.setTileSavingCache(m_d->doc->tileSavingCache());
+    visitor.setTileCompressionEnabled(KisConfig(true).compressKraTiles());
+
     image->rootLayer()->accept(visitor);
 
     m_d->errorMessages.append(visitor.errorMessages());
@@ -651,6 +654,30 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
         store->setCompressionEnabled(KisConfig(true).compressKra());
     }
 
+    if (addMergedImage && KisConfig(true).saveLodCompositeInKra()) {
+        /**
+         * The composite is stored at the resolution of LoD2, which is
+         * enough for fit-to-view zoom levels of huge images
+         */
+        const QRect bounds = image->bounds();
+        const QImage composite =
+            image->projection()->createThumbnail(qMax(1, bounds.width() / 4),
+                                                 qMax(1, bounds.height() / 4),
+                                                 bounds);
+
+        store->setCompressionEnabled(false);
+        if (store->open("mergedimage_lod.png")) {
+            KoStoreDevice io(store);
+            r = io.open(QIODevice::WriteOnly) && composite.save(&io, "PNG");
+            io.close();
+            r = store->close() && r;
+            savingMergedImageSuccess = savingMergedImageSuccess && r;
+        } else {
+            savingMergedImageSuccess = false;
+        }
+        store->setCompressionEnabled(KisConfig(true).compressKra());
+    }
+
     if (!savingMergedImageSuccess) {
         m_d->errorMessages.append(i18nc("Saving .kra file error message", "Could not save merged image."));
     }
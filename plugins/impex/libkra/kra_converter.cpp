@@ -441,6 +441,7 @@ bool KraConverter::completeLoading(KoStore* store)
     m_kraLoader->loadStoryboards(store, m_doc);
     m_kraLoader->loadAnimationMetadata(store, m_image);
     m_kraLoader->loadAudio(store, m_doc);
+    m_kraLoader->loadLodComposite(store, m_doc);
 
     if (!m_kraLoader->errorMessages().isEmpty()) {
         m_doc->setErrorMessage(m_kraLoader->errorMessages().join("\n"));
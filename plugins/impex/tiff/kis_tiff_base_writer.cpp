@@ -5,15 +5,82 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <cstring>
+#include <memory>
+
+#include <zlib.h>
+
 #include <KoColorModelStandardIdsUtils.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoID.h>
+#include <kis_assert.h>
 #include <kis_iterator_ng.h>
+#include <kis_paint_device.h>
 
 #include "kis_tiff_base_writer.h"
 #include "kis_tiff_converter.h"
 
+namespace {
+
+/**
+ * The size of an uncompressed strip in the parallel path, it is also
+ * the amount of work a single thread gets
+ */
+const int stripSizeForParallelWriting = 256 * 1024;
+
+template<typename T>
+void applyHorizontalPredictor(quint8 *row, int rowSize, int stride)
+{
+    T *samples = reinterpret_cast<T *>(row);
+    const int numSamples = rowSize / static_cast<int>(sizeof(T));
+
+    for (int i = numSamples - 1; i >= stride; i--) {
+        samples[i] -= samples[i - stride];
+    }
+}
+
+/**
+ * The same transformation as libtiff's fpDiff(): the bytes of the
+ * samples get split into the planes starting from the most significant
+ * one, then the bytes are differenced horizontally.
+ */
+void applyFloatingPointPredictor(quint8 *row, int rowSize, int bytesPerSample, int stride, QVector<quint8> &tmp)
+{
+    const int numSamples = rowSize / bytesPerSample;
+
+    tmp.resize(rowSize);
+    memcpy(tmp.data(), row, static_cast<size_t>(rowSize));
+
+    for (int i = 0; i < numSamples; i++) {
+        for (int byte = 0; byte < bytesPerSample; byte++) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            row[byte * numSamples + i] = tmp[bytesPerSample * i + byte];
+#else
+            row[(bytesPerSample - byte - 1) * numSamples + i] = tmp[bytesPerSample * i + byte];
+#endif
+        }
+    }
+
+    for (int i = rowSize - 1; i >= stride; i--) {
+        row[i] -= row[i - stride];
+    }
+}
+
+struct StripJob {
+    tstrip_t index = 0;
+    qint32 firstRow = 0;
+    qint32 numRows = 0;
+    QByteArray data;
+    bool success = false;
+};
+
+} // namespace
+
 KisTIFFBaseWriter::KisTIFFBaseWriter(TIFF *image, KisTIFFOptions *options)
     : m_image(image)
     , m_options(options)
@@ -151,3 +218,185 @@ bool KisTIFFBaseWriter::copyDataToStrips(KisHLineConstIteratorSP it,
     }
     return false;
 }
+
+bool KisTIFFBaseWriter::copyRow(KisPaintDeviceSP pd, qint32 y, qint32 width, quint8 *dst,
+                                uint16_t color_type, uint32_t depth, uint16_t sample_format)
+{
+    KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
+
+    switch (color_type) {
+    case PHOTOMETRIC_MINISBLACK: {
+        const std::array<quint8, 5> poses = {0, 1};
+        return copyDataToStrips(it, dst, depth, sample_format, 1, poses);
+    }
+    case PHOTOMETRIC_RGB: {
+        const auto poses = [&]() -> std::array<quint8, 5> {
+            if (sample_format == SAMPLEFORMAT_IEEEFP) {
+                return {0, 1, 2, 3};
+            } else {
+                return {2, 1, 0, 3};
+            }
+        }();
+        return copyDataToStrips(it, dst, depth, sample_format, 3, poses);
+    }
+    case PHOTOMETRIC_SEPARATED: {
+        const std::array<quint8, 5> poses = {0, 1, 2, 3, 4};
+        return copyDataToStrips(it, dst, depth, sample_format, 4, poses);
+    }
+    case PHOTOMETRIC_ICCLAB:
+    case PHOTOMETRIC_YCBCR: {
+        const std::array<quint8, 5> poses = {0, 1, 2, 3};
+        return copyDataToStrips(it, dst, depth, sample_format, 3, poses);
+    }
+    }
+
+    return true;
+}
+
+bool KisTIFFBaseWriter::canWriteStripsInParallel(uint16_t color_type, uint16_t sample_format)
+{
+    if (m_options->compressionType != COMPRESSION_NONE
+        && m_options->compressionType != COMPRESSION_ADOBE_DEFLATE) {
+        return false;
+    }
+
+    // the raw strips are written as they are, so no swapping is possible
+    if (TIFFIsByteSwapped(image())) {
+        return false;
+    }
+
+    // YCbCr needs subsampling support from libtiff
+    if (color_type == PHOTOMETRIC_YCBCR) {
+        return false;
+    }
+
+    if (m_options->compressionType == COMPRESSION_ADOBE_DEFLATE) {
+        if (m_options->predictor == PREDICTOR_HORIZONTAL) {
+            return sample_format == SAMPLEFORMAT_UINT;
+        } else if (m_options->predictor == PREDICTOR_FLOATINGPOINT) {
+            return sample_format == SAMPLEFORMAT_IEEEFP;
+        }
+        return m_options->predictor == PREDICTOR_NONE;
+    }
+
+    return true;
+}
+
+bool KisTIFFBaseWriter::writeStripsInParallel(KisPaintDeviceSP pd, qint32 width, qint32 height,
+                                              uint16_t color_type, uint32_t depth, uint16_t sample_format)
+{
+    const tmsize_t scanlineSize = TIFFScanlineSize(image());
+    KIS_ASSERT_RECOVER_RETURN_VALUE(scanlineSize > 0, false);
+
+    const uint32_t rowsPerStrip =
+        static_cast<uint32_t>(qBound<tmsize_t>(1, stripSizeForParallelWriting / scanlineSize, height));
+    TIFFSetField(image(), TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+
+    const tstrip_t numStrips = TIFFNumberOfStrips(image());
+    const int rowSize = static_cast<int>(scanlineSize);
+    const int bytesPerSample = static_cast<int>(depth / 8);
+    const int samplesPerPixel = rowSize / width / bytesPerSample;
+
+    const bool useDeflate = m_options->compressionType == COMPRESSION_ADOBE_DEFLATE;
+    const quint16 predictor = useDeflate ? m_options->predictor : quint16(PREDICTOR_NONE);
+    const int deflateLevel = m_options->deflateCompress;
+
+    auto prepareStrip = [&] (StripJob &job) {
+        QByteArray uncompressed(rowSize * job.numRows, Qt::Uninitialized);
+        QVector<quint8> tmp;
+
+        for (qint32 row = 0; row < job.numRows; row++) {
+            quint8 *dst = reinterpret_cast<quint8 *>(uncompressed.data()) + row * rowSize;
+
+            if (!copyRow(pd, job.firstRow + row, width, dst, color_type, depth, sample_format)) {
+                return;
+            }
+
+            if (predictor == PREDICTOR_HORIZONTAL) {
+                if (bytesPerSample == 1) {
+                    applyHorizontalPredictor<quint8>(dst, rowSize, samplesPerPixel);
+                } else if (bytesPerSample == 2) {
+                    applyHorizontalPredictor<quint16>(dst, rowSize, samplesPerPixel);
+                } else {
+                    applyHorizontalPredictor<quint32>(dst, rowSize, samplesPerPixel);
+                }
+            } else if (predictor == PREDICTOR_FLOATINGPOINT) {
+                applyFloatingPointPredictor(dst, rowSize, bytesPerSample, samplesPerPixel, tmp);
+            }
+        }
+
+        if (useDeflate) {
+            uLongf compressedSize = compressBound(static_cast<uLong>(uncompressed.size()));
+            job.data.resize(static_cast<int>(compressedSize));
+
+            if (compress2(reinterpret_cast<Bytef *>(job.data.data()), &compressedSize,
+                          reinterpret_cast<const Bytef *>(uncompressed.constData()),
+                          static_cast<uLong>(uncompressed.size()), deflateLevel) != Z_OK) {
+                return;
+            }
+            job.data.resize(static_cast<int>(compressedSize));
+        } else {
+            job.data = uncompressed;
+        }
+
+        job.success = true;
+    };
+
+    /**
+     * The strips are prepared in batches to limit the amount of memory
+     * occupied by the compressed data waiting to be written
+     */
+    const tstrip_t batchSize = static_cast<tstrip_t>(4 * QThread::idealThreadCount());
+    QVector<StripJob> jobs;
+
+    for (tstrip_t firstStrip = 0; firstStrip < numStrips; firstStrip += batchSize) {
+        jobs.clear();
+
+        for (tstrip_t strip = firstStrip; strip < qMin(numStrips, firstStrip + batchSize); strip++) {
+            StripJob job;
+            job.index = strip;
+            job.firstRow = static_cast<qint32>(strip * rowsPerStrip);
+            job.numRows = qMin(static_cast<qint32>(rowsPerStrip), height - job.firstRow);
+            jobs.append(job);
+        }
+
+        QtConcurrent::blockingMap(jobs, prepareStrip);
+
+        for (const StripJob &job : jobs) {
+            if (!job.success
+                || TIFFWriteRawStrip(image(), job.index, const_cast<char *>(job.data.constData()), job.data.size()) < 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool KisTIFFBaseWriter::writeImageData(KisPaintDeviceSP pd, qint32 width, qint32 height,
+                                       uint16_t color_type, uint32_t depth, uint16_t sample_format)
+{
+    if (canWriteStripsInParallel(color_type, sample_format)) {
+        return writeStripsInParallel(pd, width, height, color_type, depth, sample_format);
+    }
+
+    tsize_t stripsize = TIFFStripSize(image());
+    std::unique_ptr<std::remove_pointer_t<tdata_t>, decltype(&_TIFFfree)> buff(
+        _TIFFmalloc(stripsize),
+        &_TIFFfree);
+    KIS_ASSERT_RECOVER_RETURN_VALUE(
+        buff && "Unable to allocate buffer for TIFF!",
+        false);
+
+    for (qint32 y = 0; y < height; y++) {
+        if (!copyRow(pd, y, width, reinterpret_cast<quint8 *>(buff.get()), color_type, depth, sample_format)) {
+            return false;
+        }
+        TIFFWriteScanline(image(),
+                          buff.get(),
+                          static_cast<uint32_t>(y),
+                          (tsample_t)-1);
+    }
+
+    return true;
+}
@@ -42,6 +42,28 @@ protected:
                           uint8_t nbcolorssamples,
                           const std::array<quint8, 5> &poses);
 
+    /**
+     * Writes the pixels of \p pd into the current directory. All the
+     * tags of the directory except TIFFTAG_ROWSPERSTRIP must already
+     * be set.
+     *
+     * When the compression can be done outside libtiff (none or
+     * Deflate, with any predictor), the strips are prepared and
+     * compressed in parallel and written with TIFFWriteRawStrip().
+     * Otherwise the data is passed to libtiff scanline by scanline.
+     */
+    bool writeImageData(KisPaintDeviceSP pd, qint32 width, qint32 height,
+                        uint16_t color_type, uint32_t depth, uint16_t sample_format);
+
+private:
+    bool copyRow(KisPaintDeviceSP pd, qint32 y, qint32 width, quint8 *dst,
+                 uint16_t color_type, uint32_t depth, uint16_t sample_format);
+    bool canWriteStripsInParallel(uint16_t color_type, uint16_t sample_format);
+    bool writeStripsInParallel(KisPaintDeviceSP pd, qint32 width, qint32 height,
+                               uint16_t color_type, uint32_t depth, uint16_t sample_format);
+
+protected:
+
     TIFF *m_image;
     KisTIFFOptions *m_options;
 };
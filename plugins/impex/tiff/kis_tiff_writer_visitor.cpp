@@ -166,73 +166,10 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
         }
     }
 
-    tsize_t stripsize = TIFFStripSize(image());
-    std::unique_ptr<std::remove_pointer_t<tdata_t>, decltype(&_TIFFfree)> buff(
-        _TIFFmalloc(stripsize),
-        &_TIFFfree);
-    KIS_ASSERT_RECOVER_RETURN_VALUE(
-        buff && "Unable to allocate buffer for TIFF!",
-        false);
-    qint32 height = layer->image()->height();
-    qint32 width = layer->image()->width();
-    bool r = true;
-    for (int y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
-        switch (color_type) {
-        case PHOTOMETRIC_MINISBLACK: {
-            const std::array<quint8, 5> poses = {0, 1};
-            r = copyDataToStrips(it,
-                                 buff.get(),
-                                 depth,
-                                 sample_format,
-                                 1,
-                                 poses);
-            }
-            break;
-        case PHOTOMETRIC_RGB: {
-            const auto poses = [&]() -> std::array<quint8, 5> {
-                if (sample_format == SAMPLEFORMAT_IEEEFP) {
-                    return {0, 1, 2, 3};
-                } else {
-                    return {2, 1, 0, 3};
-                }
-            }();
-            r = copyDataToStrips(it,
-                                 buff.get(),
-                                 depth,
-                                 sample_format,
-                                 3,
-                                 poses);
-            }
-            break;
-        case PHOTOMETRIC_SEPARATED: {
-            const std::array<quint8, 5> poses = {0, 1, 2, 3, 4};
-            r = copyDataToStrips(it,
-                                 buff.get(),
-                                 depth,
-                                 sample_format,
-                                 4,
-                                 poses);
-            }
-            break;
-            case PHOTOMETRIC_ICCLAB:
-            case PHOTOMETRIC_YCBCR: {
-                const std::array<quint8, 5> poses = {0, 1, 2, 3};
-                r = copyDataToStrips(it,
-                                     buff.get(),
-                                     depth,
-                                     sample_format,
-                                     3,
-                                     poses);
-            } break;
-        }
-        if (!r) return false;
-        TIFFWriteScanline(image(),
-                          buff.get(),
-                          static_cast<uint32_t>(y),
-                          (tsample_t)-1);
+    if (!writeImageData(pd, layer->image()->width(), layer->image()->height(),
+                        color_type, depth, sample_format)) {
+        return false;
     }
-    buff.reset();
 
     return TIFFWriteDirectory(image());
 }
@@ -23,6 +23,16 @@
 
 #include <KoConfig.h>
 
+#include <QTemporaryFile>
+
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_properties_configuration.h>
+#include <kis_sequential_iterator.h>
+#include <KoColorSpaceRegistry.h>
+
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
 #endif
@@ -120,6 +130,77 @@ void KisTiffTest::testSaveTiffYCbCrAColorSpace()
                            profile);
 }
 
+void KisTiffTest::testRoundTripDeflate_data()
+{
+    QTest::addColumn<QString>("colorDepth");
+    QTest::addColumn<int>("predictor");
+
+    QTest::newRow("u8-none") << Integer8BitsColorDepthID.id() << 1;
+    QTest::newRow("u8-horizontal") << Integer8BitsColorDepthID.id() << 2;
+    QTest::newRow("u16-none") << Integer16BitsColorDepthID.id() << 1;
+    QTest::newRow("u16-horizontal") << Integer16BitsColorDepthID.id() << 2;
+    QTest::newRow("f32-floating") << Float32BitsColorDepthID.id() << 3;
+}
+
+void KisTiffTest::testRoundTripDeflate()
+{
+    QFETCH(QString, colorDepth);
+    QFETCH(int, predictor);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepth, "");
+    QVERIFY(cs);
+
+    // a few strips of the parallel writer, the last one is partial
+    const QRect rc(0, 0, 517, 733);
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc1->createUndoStore(), rc.width(), rc.height(), cs, "tiff test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8);
+    image->addNode(layer, image->root());
+
+    {
+        KisSequentialIterator it(layer->paintDevice(), rc);
+        QVector<float> channels(4);
+
+        while (it.nextPixel()) {
+            channels[0] = float(it.x()) / rc.width();
+            channels[1] = float(it.y()) / rc.height();
+            channels[2] = float((it.x() * it.y()) % 97) / 97.0f;
+            channels[3] = 1.0f;
+            cs->fromNormalisedChannelsValue(it.rawData(), channels);
+        }
+    }
+
+    doc1->setCurrentImage(image);
+    image->initialRefreshGraph();
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".tif"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+    const QString savedFileName(savedFile.fileName());
+
+    KisPropertiesConfigurationSP exportConfiguration = new KisPropertiesConfiguration();
+    exportConfiguration->setProperty("compressiontype", 2); // Deflate
+    exportConfiguration->setProperty("predictor", predictor - 1);
+    exportConfiguration->setProperty("alpha", true);
+    exportConfiguration->setProperty("flatten", true);
+    exportConfiguration->setProperty("saveAsPhotoshop", false);
+
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->exportDocumentSync(savedFileName, TiffMimetype.toLatin1(), exportConfiguration));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->image());
+
+    KisPaintDeviceSP dev2 = doc2->image()->root()->firstChild()->paintDevice();
+    QCOMPARE(dev2->colorSpace()->colorDepthId().id(), colorDepth);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, image->projection(), dev2));
+}
+
 void KisTiffTest::testImportFromWriteonly()
 {
     TestUtil::testImportFromWriteonly(TiffMimetype);
@@ -22,6 +22,9 @@ private Q_SLOTS:
     void testSaveTiffLabColorSpace();
     void testSaveTiffYCbCrAColorSpace();
 
+    void testRoundTripDeflate_data();
+    void testRoundTripDeflate();
+
     void testImportFromWriteonly();
     void testExportToReadonly();
     void testImportIncorrectFormat();
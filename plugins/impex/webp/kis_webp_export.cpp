@@ -12,6 +12,8 @@
 #include <webp/mux_types.h>
 
 #include <QBuffer>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <cmath>
 #include <memory>
@@ -281,130 +283,145 @@ KisImportExportErrorCode KisWebPExport::convert(KisDocument *document, QIODevice
                             / static_cast<double>(
                                 image->animationInterface()->framerate()));
 
-            for (const int i : times) {
-                const int timestamp_ms = i * duration;
+            auto framePixels = [&](int i) {
+                const KisRasterKeyframeSP frameData =
+                    frames->keyframeAt<KisRasterKeyframe>(i);
+                KisPaintDeviceSP dev = new KisPaintDevice(
+                    *image->projection(),
+                    KritaUtils::DeviceCopyMode::CopySnapshot);
+                frameData->writeFrameToDevice(dev);
 
-                WebPPictureSP currentFrame;
-                if (!WebPPictureInit(currentFrame.get())) {
-                    errFile << "WebP picture initialization failure";
-                    return ImportExportCodes::InternalError;
-                }
+                KisPaintDeviceSP dst;
+                if ((cs->colorModelId() == RGBAColorModelID && cs->colorDepthId() == Integer8BitsColorDepthID)
+                    || !enableDithering) {
+                    dst = dev;
+                } else {
+                    // We need to use gradient painter code's:
+                    //    to convert to RGBA samedepth;
+                    //    then dither to RGBA8
+                    //    then convert from ARGB32 to RGBA8888
+                    const KisPaintDeviceSP src = dev;
+                    const KoID depthId = src->colorSpace()->colorDepthId();
+                    const KoColorSpace *destCs = KoColorSpaceRegistry::instance()->rgb8();
+                    if (cs->colorModelId() == RGBAColorModelID && !needSrgbConversion) {
+                        // Preserve color profile if model is RGB and force convert sRGB is off
+                        destCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                                              Integer8BitsColorDepthID.id(),
+                                                                              src->colorSpace()->profile());
+                    }
+                    const KoColorSpace *mixCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                                                             depthId.id(),
+                                                                                             destCs->profile());
 
-                currentFrame.get()->width = bounds.width();
-                currentFrame.get()->height = bounds.height();
+                    KisPaintDeviceSP tmp = new KisPaintDevice(*src);
+                    tmp->convertTo(mixCs);
+                    dst = new KisPaintDevice(destCs);
 
-                // Use ARGB in lossless mode
-                if (config.lossless == 1) {
-                    currentFrame.get()->use_argb = 1;
-                }
+                    const KisDitherOp *op =
+                        mixCs->ditherOp(destCs->colorDepthId().id(), enableDithering ? DITHER_BEST : DITHER_NONE);
 
-                const QImage pixels = [&]() {
-                    const KisRasterKeyframeSP frameData =
-                        frames->keyframeAt<KisRasterKeyframe>(i);
-                    KisPaintDeviceSP dev = new KisPaintDevice(
-                        *image->projection(),
-                        KritaUtils::DeviceCopyMode::CopySnapshot);
-                    frameData->writeFrameToDevice(dev);
-
-                    KisPaintDeviceSP dst;
-                    if ((cs->colorModelId() == RGBAColorModelID && cs->colorDepthId() == Integer8BitsColorDepthID)
-                        || !enableDithering) {
-                        dst = dev;
-                    } else {
-                        // We need to use gradient painter code's:
-                        //    to convert to RGBA samedepth;
-                        //    then dither to RGBA8
-                        //    then convert from ARGB32 to RGBA8888
-                        const KisPaintDeviceSP src = dev;
-                        const KoID depthId = src->colorSpace()->colorDepthId();
-                        const KoColorSpace *destCs = KoColorSpaceRegistry::instance()->rgb8();
-                        if (cs->colorModelId() == RGBAColorModelID && !needSrgbConversion) {
-                            // Preserve color profile if model is RGB and force convert sRGB is off
-                            destCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
-                                                                                  Integer8BitsColorDepthID.id(),
-                                                                                  src->colorSpace()->profile());
-                        }
-                        const KoColorSpace *mixCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
-                                                                                                 depthId.id(),
-                                                                                                 destCs->profile());
+                    KisRandomConstAccessorSP srcIt = tmp->createRandomConstAccessorNG();
+                    KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
 
-                        KisPaintDeviceSP tmp = new KisPaintDevice(*src);
-                        tmp->convertTo(mixCs);
-                        dst = new KisPaintDevice(destCs);
+                    int rows = 1;
+                    int columns = 1;
 
-                        const KisDitherOp *op =
-                            mixCs->ditherOp(destCs->colorDepthId().id(), enableDithering ? DITHER_BEST : DITHER_NONE);
+                    for (int y = bounds.y(); y <= bounds.bottom(); y += rows) {
+                        rows = qMin(srcIt->numContiguousRows(y),
+                                    qMin(dstIt->numContiguousRows(y), bounds.bottom() - y + 1));
 
-                        KisRandomConstAccessorSP srcIt = tmp->createRandomConstAccessorNG();
-                        KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
+                        for (int x = bounds.x(); x <= bounds.right(); x += columns) {
+                            columns = qMin(srcIt->numContiguousColumns(x),
+                                           qMin(dstIt->numContiguousColumns(x), bounds.right() - x + 1));
+
+                            srcIt->moveTo(x, y);
+                            dstIt->moveTo(x, y);
 
-                        int rows = 1;
-                        int columns = 1;
+                            const qint32 srcRowStride = srcIt->rowStride(x, y);
+                            const qint32 dstRowStride = dstIt->rowStride(x, y);
+                            const quint8 *srcPtr = srcIt->rawDataConst();
+                            quint8 *dstPtr = dstIt->rawData();
 
-                        for (int y = bounds.y(); y <= bounds.bottom(); y += rows) {
-                            rows = qMin(srcIt->numContiguousRows(y),
-                                        qMin(dstIt->numContiguousRows(y), bounds.bottom() - y + 1));
+                            op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
+                        }
+                    }
+                }
+
+                // Convert to sRGB for non-RGBA color model
+                const KoColorProfile *imageProfile = (dst->colorSpace()->colorModelId() == RGBAColorModelID)
+                    ? dst->colorSpace()->profile()
+                    : nullptr;
 
-                            for (int x = bounds.x(); x <= bounds.right(); x += columns) {
-                                columns = qMin(srcIt->numContiguousColumns(x),
-                                               qMin(dstIt->numContiguousColumns(x), bounds.right() - x + 1));
+                if (needSrgbConversion) {
+                    imageProfile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+                }
 
-                                srcIt->moveTo(x, y);
-                                dstIt->moveTo(x, y);
+                const QImage imageOut = dst->convertToQImage(imageProfile, 0, 0, bounds.width(), bounds.height())
+                                            .convertToFormat(QImage::Format_RGBA8888);
 
-                                const qint32 srcRowStride = srcIt->rowStride(x, y);
-                                const qint32 dstRowStride = dstIt->rowStride(x, y);
-                                const quint8 *srcPtr = srcIt->rawDataConst();
-                                quint8 *dstPtr = dstIt->rawData();
+                return imageOut;
+            };
+
+            /**
+             * Preparing the pixels of a frame (copying its content, the
+             * color conversion and dithering) doesn't depend on the other
+             * frames, so it is done for a batch of frames in parallel. Only
+             * the calls to the encoder itself have to be sequential.
+             */
+            struct FrameJob {
+                int time {0};
+                QImage pixels;
+            };
+
+            const int batchSize = qMax(1, QThread::idealThreadCount());
+
+            for (int batchStart = 0; batchStart < times.size(); batchStart += batchSize) {
+                QVector<FrameJob> batch;
+                for (int j = batchStart; j < qMin(batchStart + batchSize, times.size()); j++) {
+                    batch.append({times[j], QImage()});
+                }
 
-                                op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
-                            }
-                        }
-                    }
+                QtConcurrent::blockingMap(batch, [&] (FrameJob &job) {
+                    job.pixels = framePixels(job.time);
+                });
 
-                    // Convert to sRGB for non-RGBA color model
-                    const KoColorProfile *imageProfile = (dst->colorSpace()->colorModelId() == RGBAColorModelID)
-                        ? dst->colorSpace()->profile()
-                        : nullptr;
+                for (const FrameJob &job : batch) {
+                    const int i = job.time;
+                    const int timestamp_ms = i * duration;
+                    const QImage &pixels = job.pixels;
 
-                    if (needSrgbConversion) {
-                        imageProfile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+                    WebPPictureSP currentFrame;
+                    if (!WebPPictureInit(currentFrame.get())) {
+                        errFile << "WebP picture initialization failure";
+                        return ImportExportCodes::InternalError;
                     }
 
-                    const QImage imageOut = dst->convertToQImage(imageProfile, 0, 0, bounds.width(), bounds.height())
-                                                .convertToFormat(QImage::Format_RGBA8888);
-
-                    return imageOut;
-                }();
+                    currentFrame.get()->width = bounds.width();
+                    currentFrame.get()->height = bounds.height();
 
-                if (!WebPPictureImportRGBA(currentFrame.get(),
-                                           pixels.constBits(),
-                                           bounds.width() * 4)) {
-                    errFile << "WebP picture conversion failure:"
-                            << currentFrame.get()->error_code;
-                    return ImportExportCodes::InternalError;
-                }
+                    // Use ARGB in lossless mode
+                    if (config.lossless == 1) {
+                        currentFrame.get()->use_argb = 1;
+                    }
 
-                WebPMemoryWriter writer;
-                WebPMemoryWriterInit(&writer);
-                currentFrame.get()->writer = WebPMemoryWrite;
-                currentFrame.get()->custom_ptr = &writer;
+                    if (!WebPPictureImportRGBA(currentFrame.get(),
+                                               pixels.constBits(),
+                                               bounds.width() * 4)) {
+                        errFile << "WebP picture conversion failure:"
+                                << currentFrame.get()->error_code;
+                        return ImportExportCodes::InternalError;
+                    }
 
-                if (!WebPEncode(&config, currentFrame.get())) {
-                    errFile << "WebP encoding failure:"
-                            << currentFrame.get()->error_code;
-                    return ImportExportCodes::ErrorWhileWriting;
-                }
+                    if (!WebPAnimEncoderAdd(enc.get(),
+                                            currentFrame.get(),
+                                            timestamp_ms,
+                                            &config)) {
+                        errFile << "WebPAnimEncoderAdd failed";
+                        return ImportExportCodes::InternalError;
+                    }
 
-                if (!WebPAnimEncoderAdd(enc.get(),
-                                        currentFrame.get(),
-                                        timestamp_ms,
-                                        &config)) {
-                    errFile << "WebPAnimEncoderAdd failed";
-                    return ImportExportCodes::InternalError;
+                    dbgFile << "Added frame @" << i << timestamp_ms << "ms";
                 }
-
-                dbgFile << "Added frame @" << i << timestamp_ms << "ms";
             }
 
             const int timestamp_ms =
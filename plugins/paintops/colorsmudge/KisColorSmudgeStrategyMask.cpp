@@ -37,3 +37,9 @@ void KisColorSmudgeStrategyMask::updateMask(KisDabCache *dabCache, const KisPain
 
     m_shouldPreserveMaskDab = !dabCache->needSeparateOriginal();
 }
+
+void KisColorSmudgeStrategyMask::setMaskDab(KisFixedPaintDeviceSP maskDab)
+{
+    m_maskDab = maskDab;
+    m_shouldPreserveMaskDab = true;
+}
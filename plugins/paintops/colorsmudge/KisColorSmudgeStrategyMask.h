@@ -27,6 +27,14 @@ public:
                     QRect *dstDabRect, 
                     qreal lightnessStrength) override;
 
+    /**
+     * Sets the mask dab that has been rendered outside of
+     * updateMask(), e.g. ahead of time by KisColorSmudgeOp. Such
+     * masks may be shared between several dabs, so they are always
+     * preserved.
+     */
+    void setMaskDab(KisFixedPaintDeviceSP maskDab);
+
 private:
     DabColoringStrategyMask m_coloringStrategy;
 };
@@ -9,12 +9,14 @@
 #include <QRect>
 
 #include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
 
 #include <kis_brush.h>
 #include <kis_image.h>
 #include <kis_selection.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
+#include <kis_painter.h>
 #include <kis_spacing_information.h>
 #include "kis_paintop_plugin_utils.h"
 
@@ -22,6 +24,11 @@
 #include "KisInterstrokeDataFactory.h"
 
 #include "kis_brush_option.h"
+#include "kis_dab_cache_base.h"
+#include "krita_utils.h"
+
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
 
 #include "KisColorSmudgeInterstrokeData.h"
 #include "KisColorSmudgeStrategyLightness.h"
@@ -45,6 +52,22 @@ struct ColorSmudgeInterstrokeDataFactory : public KisInterstrokeDataFactory
     }
 };
 
+/**
+ * Calculates the generation info for the masks of the pipelined
+ * dabs. The info must be fetched in order, because the cache
+ * remembers the parameters of the last generated dab.
+ */
+class KisColorSmudgeOp::MaskGenerationCache : public KisDabCacheBase
+{
+public:
+    using KisDabCacheBase::fetchDabGenerationInfo;
+};
+
+struct KisColorSmudgeOp::UpdateSharedState
+{
+    QVector<PendingDab> dabs;
+};
+
 KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
     : KisBrushBasedPaintOp(settings, painter)
     , m_firstRun(true)
@@ -90,11 +113,12 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
                                                              thicknessMode));
     } else if (m_smudgeRateOption.useNewEngine() &&
                m_brush->brushApplication() == ALPHAMASK) {
-        m_strategy.reset(new KisColorSmudgeStrategyMask(painter,
+        m_maskStrategy = new KisColorSmudgeStrategyMask(painter,
                                                         image,
                                                         useSmearAlpha,
                                                         useDullingMode,
-                                                        useOverlayMode));
+                                                        useOverlayMode);
+        m_strategy.reset(m_maskStrategy);
     } else if (m_brush->brushApplication() == IMAGESTAMP ||
                m_brush->brushApplication() == GRADIENTMAP) {
         m_strategy.reset(new KisColorSmudgeStrategyStamp(painter,
@@ -124,11 +148,35 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
             m_hsvTransform = m_paintColor.colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
         }
     }
+
+    /**
+     * The masks of the plain alpha-mask brushes don't depend on the
+     * canvas, so they can be rendered ahead of time on the worker
+     * threads. Textured dabs and painter's mirroring modify the mask
+     * while painting, so they are still rendered in paintAt().
+     */
+    m_useMaskPipelining =
+        settings->needsAsynchronousUpdates() &&
+        m_maskStrategy &&
+        !m_dabCache->needSeparateOriginal() &&
+        !painter->hasMirroring();
+
+    if (m_useMaskPipelining) {
+        m_brush->notifyBrushIsGoingToBeClonedForStroke();
+
+        m_maskGenerationCache.reset(new MaskGenerationCache());
+        m_maskGenerationCache->setPrecisionOption(&m_precisionOption);
+        m_maskGenerationCache->setMirrorPostprocessing(&m_mirrorOption);
+
+        m_maskInfoResources.reset(new KisDabCacheUtils::DabRenderingResources());
+        m_maskInfoResources->brush = m_brush;
+    }
 }
 
 KisColorSmudgeOp::~KisColorSmudgeOp()
 {
     qDeleteAll(m_hsvOptions);
+    qDeleteAll(m_maskResourcesPool);
     delete m_hsvTransform;
 }
 
@@ -152,6 +200,10 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         * and you only notice the lack of subpixel precision in the dulling methods.
         */
         m_dabCache->disableSubpixelPrecision();
+
+        if (m_maskGenerationCache) {
+            m_maskGenerationCache->disableSubpixelPrecision();
+        }
     }
 
     // get the scaling factor calculated by the size option
@@ -179,7 +231,14 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
 
     const qreal paintThickness = m_paintThicknessOption.apply(info);
-    m_strategy->updateMask(m_dabCache, info, shape, scatteredPos, &m_dstDabRect, paintThickness);
+
+    PendingDab pendingDab;
+
+    if (m_useMaskPipelining) {
+        m_dstDabRect = calculateMaskGenerationInfo(info, shape, scatteredPos, paintThickness, &pendingDab);
+    } else {
+        m_strategy->updateMask(m_dabCache, info, shape, scatteredPos, &m_dstDabRect, paintThickness);
+    }
 
     QPointF newCenterPos = QRectF(m_dstDabRect).center();
     /**
@@ -213,6 +272,27 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
     }
 
+    if (m_useMaskPipelining) {
+        pendingDab.srcDabRect = srcDabRect;
+        pendingDab.dstDabRect = m_dstDabRect;
+        pendingDab.paintColor = paintColor;
+        pendingDab.opacity = fpOpacity;
+        pendingDab.colorRate = colorRate;
+        pendingDab.smudgeRate = smudgeRate;
+        pendingDab.maxSmudgeRate = maxSmudgeRate;
+        pendingDab.paintThickness = paintThickness;
+        pendingDab.smudgeRadius = smudgeRadiusPortion;
+
+        if (!pendingDab.reuseLastMask) {
+            m_hasGeneratedMask = true;
+            m_lastGeneratedMaskSize = pendingDab.generationInfo.dstDabRect.size();
+        }
+
+        m_pendingDabs.append(pendingDab);
+
+        return spacingInfo;
+    }
+
     const QVector<QRect> dirtyRects =
             m_strategy->paintDab(srcDabRect, m_dstDabRect,
                                  paintColor,
@@ -227,6 +307,137 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
     return spacingInfo;
 }
 
+QRect KisColorSmudgeOp::calculateMaskGenerationInfo(const KisPaintInformation &info,
+                                                    const KisDabShape &shape,
+                                                    const QPointF &cursorPoint,
+                                                    qreal lightnessStrength,
+                                                    PendingDab *dab)
+{
+    static const KoColorSpace* cs = KoColorSpaceRegistry::instance()->alpha8();
+    static KoColor color(Qt::black, cs);
+
+    dab->seqNo = m_maskSeqNo++;
+    m_maskInfoResources->syncResourcesToSeqNo(dab->seqNo, info);
+
+    bool shouldUseCache = false;
+
+    m_maskGenerationCache->fetchDabGenerationInfo(m_hasGeneratedMask,
+                                                  m_maskInfoResources.data(),
+                                                  KisDabCacheUtils::DabRequestInfo(
+                                                      color,
+                                                      cursorPoint,
+                                                      shape,
+                                                      info,
+                                                      1.0,
+                                                      lightnessStrength),
+                                                  &dab->generationInfo,
+                                                  &shouldUseCache);
+
+    dab->reuseLastMask = shouldUseCache;
+
+    return shouldUseCache ?
+        KisDabCacheUtils::correctDabRectWhenFetchedFromCache(dab->generationInfo.dstDabRect,
+                                                             m_lastGeneratedMaskSize) :
+        dab->generationInfo.dstDabRect;
+}
+
+KisDabCacheUtils::DabRenderingResources *KisColorSmudgeOp::fetchMaskResources()
+{
+    QMutexLocker l(&m_maskResourcesPoolLock);
+
+    if (!m_maskResourcesPool.isEmpty()) {
+        return m_maskResourcesPool.takeLast();
+    }
+
+    KisDabCacheUtils::DabRenderingResources *resources = new KisDabCacheUtils::DabRenderingResources();
+    resources->brush = m_brush->clone().dynamicCast<KisBrush>();
+    return resources;
+}
+
+void KisColorSmudgeOp::putMaskResources(KisDabCacheUtils::DabRenderingResources *resources)
+{
+    QMutexLocker l(&m_maskResourcesPoolLock);
+    m_maskResourcesPool.append(resources);
+}
+
+void KisColorSmudgeOp::renderPendingMask(PendingDab *dab)
+{
+    KisDabCacheUtils::DabRenderingResources *resources = fetchMaskResources();
+
+    resources->syncResourcesToSeqNo(dab->seqNo, dab->generationInfo.info);
+    KisDabCacheUtils::generateDab(dab->generationInfo, resources, &dab->mask);
+
+    putMaskResources(resources);
+}
+
+std::pair<int, bool> KisColorSmudgeOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    if (!m_useMaskPipelining) {
+        return KisBrushBasedPaintOp::doAsynchronousUpdate(jobs);
+    }
+
+    if (m_updateSharedState || m_pendingDabs.isEmpty()) {
+        // the previous batch is still being smudged, so the new dabs
+        // should wait for the next update
+        return std::make_pair(m_currentUpdatePeriod, m_updateSharedState && !m_pendingDabs.isEmpty());
+    }
+
+    m_updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_updateSharedState;
+
+    std::swap(state->dabs, m_pendingDabs);
+
+    const KoColorSpace *maskColorSpace = KoColorSpaceRegistry::instance()->alpha8();
+
+    /**
+     * The masks don't depend on each other, so all of them are rendered
+     * concurrently. The dabs that reuse the previous mask just share the
+     * device with it.
+     */
+    for (PendingDab &dab : state->dabs) {
+        if (!dab.reuseLastMask) {
+            dab.mask = new KisFixedPaintDevice(maskColorSpace);
+            m_lastGeneratedMask = dab.mask;
+
+            PendingDab *dabPtr = &dab;
+            KritaUtils::addJobConcurrent(jobs,
+                [this, state, dabPtr] () {
+                    renderPendingMask(dabPtr);
+                }
+            );
+        } else {
+            dab.mask = m_lastGeneratedMask;
+        }
+    }
+
+    /**
+     * Every dab picks up the color painted by the previous ones, so the
+     * smudging itself stays strictly ordered.
+     */
+    KritaUtils::addJobSequential(jobs,
+        [this, state] () {
+            for (const PendingDab &dab : state->dabs) {
+                m_maskStrategy->setMaskDab(dab.mask);
+
+                const QVector<QRect> dirtyRects =
+                    m_strategy->paintDab(dab.srcDabRect, dab.dstDabRect,
+                                         dab.paintColor,
+                                         dab.opacity, dab.colorRate,
+                                         dab.smudgeRate,
+                                         dab.maxSmudgeRate,
+                                         dab.paintThickness,
+                                         dab.smudgeRadius);
+
+                painter()->addDirtyRects(dirtyRects);
+            }
+
+            m_updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(m_currentUpdatePeriod, false);
+}
+
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     const qreal scale = m_sizeOption.apply(info) * KisLodTransform::lodToScale(painter()->device());
@@ -7,13 +7,17 @@
 #ifndef _KIS_COLORSMUDGEOP_H_
 #define _KIS_COLORSMUDGEOP_H_
 
+#include <QMutex>
 #include <QRect>
+#include <QSharedPointer>
+#include <QVector>
 
 #include "KoColorTransformation.h"
 #include <KoAbstractGradient.h>
 
 #include <kis_brush_based_paintop.h>
 #include <kis_types.h>
+#include <KisDabCacheUtils.h>
 
 #include "KisOverlayPaintDeviceWrapper.h"
 #include <KisOpacityOption.h>
@@ -37,6 +41,8 @@ class KoColorSpace;
 class KisInterstrokeDataFactory;
 
 class KisColorSmudgeStrategy;
+class KisColorSmudgeStrategyMask;
+class KisRunnableStrokeJobData;
 
 class KisColorSmudgeOp: public KisBrushBasedPaintOp
 {
@@ -46,12 +52,53 @@ public:
 
     static KisInterstrokeDataFactory* createInterstrokeDataFactory(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    /**
+     * A dab whose mask is still to be rendered. In the pipelined mode
+     * paintAt() only calculates the dab parameters, the masks of all the
+     * queued dabs are rendered concurrently in doAsynchronousUpdate() and
+     * only the smudging itself is done in order.
+     */
+    struct PendingDab {
+        KisDabCacheUtils::DabGenerationInfo generationInfo;
+        int seqNo = 0;
+        bool reuseLastMask = false;
+        KisFixedPaintDeviceSP mask;
+
+        QRect srcDabRect;
+        QRect dstDabRect;
+        KoColor paintColor;
+        qreal opacity = 1.0;
+        qreal colorRate = 0.0;
+        qreal smudgeRate = 1.0;
+        qreal maxSmudgeRate = 1.0;
+        qreal paintThickness = 1.0;
+        qreal smudgeRadius = 0.0;
+    };
+
+    struct UpdateSharedState;
+    typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
+    class MaskGenerationCache;
+
+    QRect calculateMaskGenerationInfo(const KisPaintInformation &info,
+                                      const KisDabShape &shape,
+                                      const QPointF &cursorPoint,
+                                      qreal lightnessStrength,
+                                      PendingDab *dab);
+    void renderPendingMask(PendingDab *dab);
+
+    KisDabCacheUtils::DabRenderingResources* fetchMaskResources();
+    void putMaskResources(KisDabCacheUtils::DabRenderingResources *resources);
+
 private:
     bool                      m_firstRun;
 
@@ -79,6 +126,21 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     QScopedPointer<KisColorSmudgeStrategy> m_strategy;
+
+    // pipelined rendering of the masks
+    KisColorSmudgeStrategyMask *m_maskStrategy {0};
+    bool m_useMaskPipelining {false};
+    QScopedPointer<MaskGenerationCache> m_maskGenerationCache;
+    QScopedPointer<KisDabCacheUtils::DabRenderingResources> m_maskInfoResources;
+    QVector<KisDabCacheUtils::DabRenderingResources*> m_maskResourcesPool;
+    QMutex m_maskResourcesPoolLock;
+    QVector<PendingDab> m_pendingDabs;
+    UpdateSharedStateSP m_updateSharedState;
+    KisFixedPaintDeviceSP m_lastGeneratedMask;
+    QSize m_lastGeneratedMaskSize;
+    bool m_hasGeneratedMask {false};
+    int m_maskSeqNo {0};
+    int m_currentUpdatePeriod {20};
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
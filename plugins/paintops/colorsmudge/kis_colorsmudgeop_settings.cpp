@@ -6,6 +6,8 @@
 
 #include "kis_colorsmudgeop_settings.h"
 
+#include "kis_brush_option.h"
+
 struct KisColorSmudgeOpSettings::Private
 {
     QList<KisUniformPaintOpPropertyWSP> uniformProperties;
@@ -21,6 +23,19 @@ KisColorSmudgeOpSettings::~KisColorSmudgeOpSettings()
 {
 }
 
+bool KisColorSmudgeOpSettings::needsAsynchronousUpdates() const
+{
+    /**
+     * Only the new engine with a plain alpha-mask brush can render
+     * the dab masks ahead of the smudging, see KisColorSmudgeOp
+     */
+    const bool useNewEngine = getBool(QString("SmudgeRate") + "UseNewEngine", false);
+
+    KisBrushOptionProperties brushOption;
+    return useNewEngine &&
+        brushOption.brushApplication(this, resourcesInterface()) == ALPHAMASK;
+}
+
 #include <brushengine/kis_slider_based_paintop_property.h>
 #include <brushengine/kis_combo_based_paintop_property.h>
 #include "kis_paintop_preset.h"
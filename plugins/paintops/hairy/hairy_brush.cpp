@@ -51,6 +51,8 @@ void HairyBrush::initAndCache()
         m_transfo = m_dab->colorSpace()->createColorTransformation("hsv_adjustment", m_params);
         if (m_transfo) {
             m_saturationId = m_transfo->parameterId("s");
+            m_hueId = m_transfo->parameterId("h");
+            m_valueId = m_transfo->parameterId("v");
         }
     }
 }
@@ -90,6 +92,89 @@ void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
             dabPointer += pixelSize;
         }
     }
+
+    const int bristleCount = m_bristles.size();
+
+    m_bristlePositions.resize(bristleCount);
+    m_prevPositions.resize(bristleCount);
+    m_randomOffsets.resize(bristleCount);
+    m_startPositions.resize(bristleCount);
+    m_endPositions.resize(bristleCount);
+
+    for (int i = 0; i < bristleCount; i++) {
+        m_bristlePositions.x[i] = m_bristles[i]->x();
+        m_bristlePositions.y[i] = m_bristles[i]->y();
+        m_prevPositions.x[i] = m_bristles[i]->prevX();
+        m_prevPositions.y[i] = m_bristles[i]->prevY();
+    }
+}
+
+void HairyBrush::calculateBristlePositions(KisRandomSourceSP randomSource, qreal scale, qreal angle, qreal shear,
+                                           const QPointF &start, const QPointF &end)
+{
+    const int bristleCount = m_bristles.size();
+
+    // the random offsets are generated in the same order as before,
+    // so the strokes stay reproducible
+    for (int i = 0; i < bristleCount; i++) {
+        if (!m_bristles[i]->enabled()) continue;
+
+        m_randomOffsets.x[i] = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+        m_randomOffsets.y[i] = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+    }
+
+    /**
+     * The old per-bristle transform was rotate * scale * translate(random) * shear.
+     * Only the translation differs between the bristles, so it is split out:
+     *
+     *     pos = bristleTransform(bristle) + offsetTransform(random)
+     */
+    QTransform offsetTransform;
+    offsetTransform.rotateRadians(-angle);
+    offsetTransform.scale(scale, scale);
+
+    QTransform bristleTransform = offsetTransform;
+    bristleTransform.shear(shear, shear);
+
+    const qreal b11 = bristleTransform.m11();
+    const qreal b12 = bristleTransform.m12();
+    const qreal b21 = bristleTransform.m21();
+    const qreal b22 = bristleTransform.m22();
+
+    const qreal o11 = offsetTransform.m11();
+    const qreal o12 = offsetTransform.m12();
+    const qreal o21 = offsetTransform.m21();
+    const qreal o22 = offsetTransform.m22();
+
+    const qreal *bx = m_bristlePositions.x.constData();
+    const qreal *by = m_bristlePositions.y.constData();
+    const qreal *rx = m_randomOffsets.x.constData();
+    const qreal *ry = m_randomOffsets.y.constData();
+    qreal *ex = m_endPositions.x.data();
+    qreal *ey = m_endPositions.y.data();
+
+    for (int i = 0; i < bristleCount; i++) {
+        ex[i] = b11 * bx[i] + b21 * by[i] + o11 * rx[i] + o21 * ry[i];
+        ey[i] = b12 * bx[i] + b22 * by[i] + o12 * rx[i] + o22 * ry[i];
+    }
+
+    qreal *sx = m_startPositions.x.data();
+    qreal *sy = m_startPositions.y.data();
+    qreal *px = m_prevPositions.x.data();
+    qreal *py = m_prevPositions.y.data();
+
+    const bool continuePath = !firstStroke() && m_properties->connectedPath;
+
+    // continue the path of the bristle from the previous position
+    // and remember the new end point
+    for (int i = 0; i < bristleCount; i++) {
+        sx[i] = (continuePath ? px[i] : ex[i]) + start.x();
+        sy[i] = (continuePath ? py[i] : ey[i]) + start.y();
+        px[i] = ex[i];
+        py[i] = ey[i];
+        ex[i] += end.x();
+        ey[i] += end.y();
+    }
 }
 
 
@@ -146,9 +231,9 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
 
     KisRandomSourceSP randomSource = pi2.randomSource();
 
-    qreal fx1, fy1, fx2, fy2;
-    qreal randomX, randomY;
-    qreal shear;
+    const qreal shear = pressure * m_properties->shearFactor;
+
+    calculateBristlePositions(randomSource, scale, angle, shear, QPointF(x1, y1), QPointF(x2, y2));
 
     float inkDepletion = 0.0;
     int inkDepletionSize = m_properties->inkDepletionCurve.size();
@@ -160,43 +245,14 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         if (!m_bristles.at(i)->enabled()) continue;
         bristle = m_bristles[i];
 
-        randomX = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
-        randomY = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
-
-        shear = pressure * m_properties->shearFactor;
-
-        m_transform.reset();
-        m_transform.rotateRadians(-angle);
-        m_transform.scale(scale, scale);
-        m_transform.translate(randomX, randomY);
-        m_transform.shear(shear, shear);
-
-        if (firstStroke() || (!m_properties->connectedPath)) {
-            // transform start dab
-            m_transform.map(bristle->x(), bristle->y(), &fx1, &fy1);
-            // transform end dab
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
-        }
-        else {
-            // continue the path of the bristle from the previous position
-            fx1 = bristle->prevX();
-            fy1 = bristle->prevY();
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
-        }
-        // remember the end point
-        bristle->setPrevX(fx2);
-        bristle->setPrevY(fy2);
-
-        // all coords relative to device position
-        fx1 += x1;
-        fy1 += y1;
-
-        fx2 += x2;
-        fy2 += y2;
+        const qreal fx1 = m_startPositions.x[i];
+        const qreal fy1 = m_startPositions.y[i];
+        const qreal fx2 = m_endPositions.x[i];
+        const qreal fy2 = m_endPositions.y[i];
 
         if (m_properties->threshold && (bristle->length() < threshold)) continue;
         // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
+        const QVector<QPointF> &bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
         bristlePathSize = m_trajectory.size();
 
         // avoid overlapping bristle caps with antialias on
@@ -266,8 +322,8 @@ void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, q
                          (1.0 - inkDepletion)) - 1.0;
 
     }
-    m_transfo->setParameter(m_transfo->parameterId("h"), 0.0);
-    m_transfo->setParameter(m_transfo->parameterId("v"), 0.0);
+    m_transfo->setParameter(m_hueId, 0.0);
+    m_transfo->setParameter(m_valueId, 0.0);
     m_transfo->setParameter(m_saturationId, saturation);
     m_transfo->setParameter(3, 1);//sets the type to
     m_transfo->setParameter(4, false);//sets the colorize to none.
@@ -420,17 +476,23 @@ void HairyBrush::colorifyBristles(KisPaintDeviceSP source, QPointF point)
     KoColor bristleColor(m_dab->colorSpace());
     KisCrossDeviceColorSamplerInt colorSampler(source, bristleColor);
 
-    Bristle *b = 0;
-    int size = m_bristles.size();
-    for (int i = 0; i < size; i++) {
-        b = m_bristles[i];
-        int x = qRound(b->x() + point.x());
-        int y = qRound(b->y() + point.y());
+    const int size = m_bristles.size();
+    const int pixelSize = bristleColor.colorSpace()->pixelSize();
 
-        colorSampler.sampleOldColor(x, y, bristleColor.data());
-        b->setColor(bristleColor);
+    QVector<QPoint> points(size);
+    for (int i = 0; i < size; i++) {
+        const Bristle *b = m_bristles[i];
+        points[i] = QPoint(qRound(b->x() + point.x()), qRound(b->y() + point.y()));
     }
 
+    // sample all the bristles at once to convert the colors in one go
+    QVector<quint8> colors(size * pixelSize);
+    colorSampler.sampleOldColors(points.constData(), size, colors.data());
+
+    for (int i = 0; i < size; i++) {
+        memcpy(bristleColor.data(), colors.constData() + i * pixelSize, pixelSize);
+        m_bristles[i]->setColor(bristleColor);
+    }
 }
 
 
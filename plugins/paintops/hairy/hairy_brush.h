@@ -18,6 +18,7 @@
 #include <kis_paint_device.h>
 #include <brushengine/kis_paint_information.h>
 #include <kis_random_accessor_ng.h>
+#include <kis_random_source.h>
 
 class KoCompositeOp;
 
@@ -87,6 +88,9 @@ private:
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
     void repositionBristles(double angle, double slope);
+    /// calculate the start and end positions of all the bristles for the current line
+    void calculateBristlePositions(KisRandomSourceSP randomSource, qreal scale, qreal angle, qreal shear,
+                                   const QPointF &start, const QPointF &end);
     /// compute mouse pressure according distance
     double computeMousePressure(double distance);
 
@@ -103,7 +107,27 @@ private:
     const KisHairyProperties * m_properties {nullptr};
 
     QVector<Bristle*> m_bristles;
-    QTransform m_transform;
+
+    /**
+     * The positions of the bristles are kept in structure-of-arrays
+     * buffers, so that the transformation of all the bristles can be
+     * done in one tight (auto-vectorized) loop in paintLine()
+     */
+    struct BristlePositions {
+        void resize(int size) {
+            x.resize(size);
+            y.resize(size);
+        }
+
+        QVector<qreal> x;
+        QVector<qreal> y;
+    };
+
+    BristlePositions m_bristlePositions;
+    BristlePositions m_prevPositions;
+    BristlePositions m_randomOffsets;
+    BristlePositions m_startPositions;
+    BristlePositions m_endPositions;
 
     // used for interpolation the path of bristles
     Trajectory m_trajectory;
@@ -121,6 +145,8 @@ private:
     KoColor m_color;
 
     int m_saturationId {-1};
+    int m_hueId {-1};
+    int m_valueId {-1};
     KoColorTransformation * m_transfo {nullptr};
 
     // internal counter counts the calls of paint, the counter is 1 when the first call occurs
@@ -0,0 +1,128 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "HairyBrushBenchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_device.h>
+#include <kis_random_source.h>
+#include <brushengine/kis_paint_information.h>
+
+#include "../hairy_brush.h"
+
+namespace {
+
+KisFixedPaintDeviceSP createRoundDab(const KoColorSpace *cs, int diameter)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, diameter, diameter));
+    dab->initialize();
+
+    const KoColor color(Qt::black, cs);
+    const qreal radius = 0.5 * diameter;
+    quint8 *ptr = dab->data();
+
+    for (int y = 0; y < diameter; y++) {
+        for (int x = 0; x < diameter; x++) {
+            const qreal dx = x + 0.5 - radius;
+            const qreal dy = y + 0.5 - radius;
+
+            if (dx * dx + dy * dy <= radius * radius) {
+                memcpy(ptr, color.data(), cs->pixelSize());
+            }
+
+            ptr += cs->pixelSize();
+        }
+    }
+
+    return dab;
+}
+
+KisHairyProperties createProperties(bool inkDepletion, bool antialias)
+{
+    KisHairyProperties properties;
+
+    properties.radius = 0;
+    properties.inkAmount = 1024;
+    properties.sigma = 0;
+    properties.inkDepletionCurve = QVector<qreal>(properties.inkAmount, 0.5);
+    properties.inkDepletionEnabled = inkDepletion;
+    properties.isbrushDimension1D = false;
+    properties.useMousePressure = false;
+    properties.useSaturation = inkDepletion;
+    properties.useOpacity = inkDepletion;
+    properties.useWeights = false;
+    properties.useSoakInk = false;
+    properties.connectedPath = true;
+    properties.antialias = antialias;
+    properties.useCompositing = true;
+    properties.pressureWeight = 50;
+    properties.bristleLengthWeight = 50;
+    properties.bristleInkAmountWeight = 50;
+    properties.inkDepletionWeight = 50;
+    properties.shearFactor = 0.5;
+    properties.randomFactor = 2.0;
+    properties.scaleFactor = 1.0;
+    properties.threshold = 0.0;
+
+    return properties;
+}
+
+}
+
+void HairyBrushBenchmark::benchmarkPaintLine_data()
+{
+    QTest::addColumn<int>("diameter");
+    QTest::addColumn<bool>("inkDepletion");
+    QTest::addColumn<bool>("antialias");
+
+    Q_FOREACH (int diameter, QList<int>({50, 200, 400})) {
+        QTest::addRow("%dpx", diameter) << diameter << false << false;
+        QTest::addRow("%dpx-aa", diameter) << diameter << false << true;
+        QTest::addRow("%dpx-ink", diameter) << diameter << true << true;
+    }
+}
+
+void HairyBrushBenchmark::benchmarkPaintLine()
+{
+    QFETCH(int, diameter);
+    QFETCH(bool, inkDepletion);
+    QFETCH(bool, antialias);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisHairyProperties properties = createProperties(inkDepletion, antialias);
+
+    HairyBrush brush;
+    brush.fromDabWithDensity(createRoundDab(cs, diameter), 1.0);
+    brush.setInkColor(KoColor(Qt::black, cs));
+    brush.setProperties(&properties);
+
+    KisPaintDeviceSP dab = new KisPaintDevice(cs);
+
+    KisRandomSourceSP randomSource(new KisRandomSource(0));
+
+    QVector<KisPaintInformation> points;
+    for (int i = 0; i < 32; i++) {
+        KisPaintInformation pi(QPointF(100 + 5 * i, 100 + 3 * i), 0.8);
+        pi.setRandomSource(randomSource);
+        points << pi;
+    }
+
+    QBENCHMARK {
+        for (int i = 1; i < points.size(); i++) {
+            brush.paintLine(dab, nullptr, points[i - 1], points[i], 1.0, 0.3);
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(HairyBrushBenchmark)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef HAIRYBRUSHBENCHMARK_H
+#define HAIRYBRUSHBENCHMARK_H
+
+#include <QObject>
+
+class HairyBrushBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkPaintLine_data();
+    void benchmarkPaintLine();
+};
+
+#endif // HAIRYBRUSHBENCHMARK_H
@@ -9,6 +9,8 @@
 #include "KisCurveOptionData.h"
 #include "kis_algebra_2d.h"
 
+#include <QVarLengthArray>
+
 #include <sensors/KisDynamicSensors.h>
 #include <sensors/KisDynamicSensorDrawingAngle.h>
 #include <sensors/KisDynamicSensorDistance.h>
@@ -97,6 +99,17 @@ KisCurveOption::KisCurveOption(const KisCurveOptionData &data)
     , m_strengthMaxValue(data.strengthMaxValue)
     , m_sensors(generateSensors(data))
 {
+    /**
+     * The kind of the sensor never changes, so resolve it once
+     * instead of doing two virtual calls per sensor for every dab
+     */
+    m_sensorKinds.reserve(m_sensors.size());
+    for (auto it = m_sensors.cbegin(); it != m_sensors.cend(); ++it) {
+        const KisDynamicSensor *sensor = it->get();
+        m_sensorKinds.push_back(sensor->isAdditive() ? AdditiveSensor :
+                                sensor->isAbsoluteRotation() ? AbsoluteRotationSensor :
+                                ScalingSensor);
+    }
 }
 
 KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const KisPaintInformation& info, bool useStrengthValue) const
@@ -104,15 +117,16 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
     ValueComponents components;
 
     if (m_useCurve) {
-        QList<double> sensorValues;
-        for (auto i = m_sensors.cbegin(); i != m_sensors.cend(); ++i) {
-            KisDynamicSensor *s(i->get());
+        // there are at most a couple of dozen sensors, avoid heap allocations per dab
+        QVarLengthArray<qreal, 16> sensorValues;
+        for (size_t i = 0; i < m_sensors.size(); ++i) {
+            const SensorKind kind = m_sensorKinds[i];
 
-            qreal valueFromCurve = s->parameter(info);
-            if (s->isAdditive()) {
+            qreal valueFromCurve = m_sensors[i]->parameter(info);
+            if (kind == AdditiveSensor) {
                 components.additive += valueFromCurve;
                 components.hasAdditive = true;
-            } else if (s->isAbsoluteRotation()) {
+            } else if (kind == AbsoluteRotationSensor) {
                 components.absoluteOffset = valueFromCurve;
                 components.hasAbsoluteOffset =true;
             } else {
@@ -121,15 +135,14 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
             }
         }
 
-        if (sensorValues.count() == 1) {
+        if (sensorValues.size() == 1) {
             components.scaling = sensorValues.first();
-        } else if (sensorValues.count() > 1) {
+        } else if (sensorValues.size() > 1) {
 
             if (m_curveMode == 1){           // add
                 components.scaling = 0;
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling += i;
+                for (qreal value : sensorValues) {
+                    components.scaling += value;
                 }
             } else if (m_curveMode == 2){    //max
                 components.scaling = *std::max_element(sensorValues.begin(), sensorValues.end());
@@ -143,9 +156,8 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
                 components.scaling = max-min;
 
             } else {                         //multiply - default
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling *= i;
+                for (qreal value : sensorValues) {
+                    components.scaling *= value;
                 }
             }
         }
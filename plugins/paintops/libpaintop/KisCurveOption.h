@@ -62,6 +62,13 @@ public:
     bool isChecked() const;
     bool isRandom() const;
 
+private:
+    enum SensorKind {
+        ScalingSensor,
+        AdditiveSensor,
+        AbsoluteRotationSensor
+    };
+
 private:
     bool m_isChecked;
     bool m_useCurve;
@@ -70,6 +77,7 @@ private:
     qreal m_strengthMinValue;
     qreal m_strengthMaxValue;
     std::vector<std::unique_ptr<KisDynamicSensor>> m_sensors;
+    std::vector<SensorKind> m_sensorKinds;
 };
 
 #endif // KISCURVEOPTION_H
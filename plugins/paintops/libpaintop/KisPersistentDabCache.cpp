@@ -0,0 +1,173 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPersistentDabCache.h"
+
+#include <limits>
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <kis_brush.h>
+#include <kis_fixed_paint_device.h>
+
+Q_GLOBAL_STATIC(KisPersistentDabCache, s_instance)
+
+namespace {
+
+/**
+ * QCache counts the cost in int, so we count it in KiB to be able
+ * to have more than 2 GiB of dabs
+ */
+int dabCost(KisFixedPaintDeviceSP dab)
+{
+    const qint64 bytes = qint64(dab->bounds().width()) * dab->bounds().height() * dab->pixelSize();
+    return qMax(1, int((bytes + 1023) / 1024));
+}
+
+const qint64 defaultMemoryLimit = 64 * 1024 * 1024;
+
+}
+
+bool KisPersistentDabCache::Key::operator==(const Key &rhs) const
+{
+    return width == rhs.width &&
+        height == rhs.height &&
+        brushIndex == rhs.brushIndex &&
+        precisionLevel == rhs.precisionLevel &&
+        angle == rhs.angle &&
+        subPixelX == rhs.subPixelX &&
+        subPixelY == rhs.subPixelY &&
+        softnessFactor == rhs.softnessFactor &&
+        lightnessStrength == rhs.lightnessStrength &&
+        ratio == rhs.ratio &&
+        horizontalMirror == rhs.horizontalMirror &&
+        verticalMirror == rhs.verticalMirror &&
+        normalizedImageStamp == rhs.normalizedImageStamp &&
+        color == rhs.color &&
+        colorSpaceId == rhs.colorSpaceId &&
+        brushHash == rhs.brushHash;
+}
+
+uint qHash(const KisPersistentDabCache::Key &key, uint seed)
+{
+    return qHash(key.brushHash, seed) ^
+        qHash(key.colorSpaceId) ^
+        qHash(key.color) ^
+        qHash(key.width) ^
+        qHash(key.height << 16) ^
+        qHash(key.brushIndex) ^
+        qHash(key.angle) ^
+        qHash(key.subPixelX << 8) ^
+        qHash(key.subPixelY << 24) ^
+        qHash(key.softnessFactor) ^
+        qHash(key.lightnessStrength) ^
+        qHash(key.ratio) ^
+        qHash(key.precisionLevel) ^
+        uint(key.horizontalMirror) ^
+        (uint(key.verticalMirror) << 1) ^
+        (uint(key.normalizedImageStamp) << 2);
+}
+
+struct KisPersistentDabCache::Private
+{
+    mutable QMutex mutex;
+    QCache<Key, KisFixedPaintDevice> dabs;
+};
+
+KisPersistentDabCache::KisPersistentDabCache()
+    : m_d(new Private)
+{
+    setMemoryLimit(defaultMemoryLimit);
+}
+
+KisPersistentDabCache::~KisPersistentDabCache()
+{
+}
+
+KisPersistentDabCache *KisPersistentDabCache::instance()
+{
+    return s_instance;
+}
+
+QByteArray KisPersistentDabCache::brushHash(KisBrushSP brush)
+{
+    if (!brush || !brush->supportsCaching()) {
+        return QByteArray();
+    }
+
+    /**
+     * The XML representation covers the generated brushes, which have
+     * no md5 sum, and the per-preset properties of the resource-based
+     * ones (scale, angle, spacing, etc.)
+     */
+    QDomDocument doc;
+    QDomElement element = doc.createElement("Brush");
+    brush->toXML(doc, element);
+    doc.appendChild(element);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(doc.toByteArray());
+    hash.addData(brush->md5Sum(false).toLatin1());
+    hash.addData(QByteArray::number(int(brush->brushApplication())));
+
+    return hash.result();
+}
+
+KisFixedPaintDeviceSP KisPersistentDabCache::fetch(const Key &key)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    KisFixedPaintDevice *dab = m_d->dabs.object(key);
+    return dab ? new KisFixedPaintDevice(*dab) : nullptr;
+}
+
+void KisPersistentDabCache::insert(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dab);
+
+    const int cost = dabCost(dab);
+    KisFixedPaintDevice *copy = new KisFixedPaintDevice(*dab);
+
+    QMutexLocker l(&m_d->mutex);
+
+    // QCache deletes the object itself if it doesn't fit
+    m_d->dabs.insert(key, copy, cost);
+}
+
+void KisPersistentDabCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.clear();
+}
+
+void KisPersistentDabCache::setMemoryLimit(qint64 bytes)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.setMaxCost(int(qBound(qint64(0), bytes / 1024, qint64(std::numeric_limits<int>::max()))));
+}
+
+qint64 KisPersistentDabCache::memoryLimit() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return qint64(m_d->dabs.maxCost()) * 1024;
+}
+
+qint64 KisPersistentDabCache::memoryUsage() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return qint64(m_d->dabs.totalCost()) * 1024;
+}
+
+int KisPersistentDabCache::numDabs() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->dabs.count();
+}
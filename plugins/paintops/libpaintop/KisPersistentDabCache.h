@@ -0,0 +1,111 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERSISTENTDABCACHE_H
+#define KISPERSISTENTDABCACHE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KisBrush;
+typedef QSharedPointer<KisBrush> KisBrushSP;
+
+
+/**
+ * @brief A process-wide LRU cache of the generated dabs that lives
+ *        across the strokes
+ *
+ * KisDabCache can only reuse the dab generated for the previous
+ * request of the same stroke. Brushes with low jitter, hatching and
+ * repeated stamps generate the same handful of dabs over and over
+ * again, so KisDabCache also looks up the dabs it has missed in this
+ * cache before asking the brush to generate them.
+ *
+ * The parameters of the dab are quantized to the tolerances of the
+ * precision level the dab was requested with, so the cache never
+ * returns a dab that the per-stroke cache would not have reused.
+ *
+ * The cache stores its own copies of the dabs and is thread-safe.
+ */
+class PAINTOP_EXPORT KisPersistentDabCache
+{
+public:
+    struct PAINTOP_EXPORT Key
+    {
+        QByteArray brushHash;
+        QString colorSpaceId;
+        QByteArray color;
+
+        int width {0};
+        int height {0};
+        int brushIndex {0};
+        int precisionLevel {0};
+
+        qint64 angle {0};
+        qint64 subPixelX {0};
+        qint64 subPixelY {0};
+        qint64 softnessFactor {0};
+        qint64 lightnessStrength {0};
+        qint64 ratio {0};
+
+        bool horizontalMirror {false};
+        bool verticalMirror {false};
+        bool normalizedImageStamp {false};
+
+        bool operator==(const Key &rhs) const;
+    };
+
+public:
+    KisPersistentDabCache();
+    ~KisPersistentDabCache();
+
+    static KisPersistentDabCache* instance();
+
+    /**
+     * Calculates the part of the key that identifies the brush. The
+     * value is rather expensive to calculate, so it should be done
+     * once per stroke.
+     *
+     * @return an empty array if the dabs of the brush cannot be
+     *         shared between the strokes
+     */
+    static QByteArray brushHash(KisBrushSP brush);
+
+    /**
+     * @return a copy of the cached dab or null if the cache has no dab
+     *         for \p key. The found dab becomes the most recently used one.
+     */
+    KisFixedPaintDeviceSP fetch(const Key &key);
+
+    /**
+     * Stores a copy of \p dab in the cache, possibly evicting the least
+     * recently used dabs.
+     */
+    void insert(const Key &key, KisFixedPaintDeviceSP dab);
+
+    void clear();
+
+    /**
+     * Sets the max total size of the cached dabs. Zero disables the cache.
+     */
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const;
+
+    qint64 memoryUsage() const;
+    int numDabs() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+PAINTOP_EXPORT uint qHash(const KisPersistentDabCache::Key &key, uint seed = 0);
+
+#endif // KISPERSISTENTDABCACHE_H
@@ -108,6 +108,14 @@ QRect KisTextureMaskInfo::maskBounds() const {
     return m_maskBounds;
 }
 
+const quint8* KisTextureMaskInfo::maskData() const {
+    return m_maskData.constData();
+}
+
+const KoColorSpace* KisTextureMaskInfo::maskDataColorSpace() const {
+    return m_maskDataColorSpace;
+}
+
 bool KisTextureMaskInfo::fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface, bool invertAdditionally)
 {
     KisTextureOptionData data;
@@ -241,6 +249,20 @@ void KisTextureMaskInfo::recalculateMask()
         m_mask->convertFromQImage(mask, 0);
     }
     m_maskBounds = QRect(0, 0, width, height);
+
+    m_maskDataColorSpace = m_preserveAlpha ? KoColorSpaceRegistry::instance()->rgb8() : cs;
+    m_maskData.resize(width * height * m_maskDataColorSpace->pixelSize());
+
+    if (m_maskDataColorSpace == cs) {
+        m_mask->readBytes(m_maskData.data(), m_maskBounds);
+    } else {
+        QVector<quint8> rawData(width * height * cs->pixelSize());
+        m_mask->readBytes(rawData.data(), m_maskBounds);
+        cs->convertPixelsTo(rawData.constData(), m_maskData.data(), m_maskDataColorSpace,
+                            width * height,
+                            KoColorConversionTransformation::internalRenderingIntent(),
+                            KoColorConversionTransformation::internalConversionFlags());
+    }
 }
 
 bool KisTextureMaskInfo::hasAlpha() {
@@ -19,6 +19,7 @@
 
 class KisTextureMaskInfo;
 class KisResourcesInterface;
+class KoColorSpace;
 
 class KisTextureMaskInfo : public boost::equality_comparable<KisTextureMaskInfo>
 {
@@ -42,6 +43,16 @@ public:
 
     QRect maskBounds() const;
 
+    /**
+     * The pixels of mask() packed into a single buffer with the rows
+     * of maskBounds() following each other, so that the texture could
+     * be sampled without any iterators or locking. The pixels are in
+     * rgb8 when alpha is preserved and in alpha8 otherwise.
+     */
+    const quint8* maskData() const;
+
+    const KoColorSpace* maskDataColorSpace() const;
+
     bool fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface, bool invertAdditionally);
 
     void recalculateMask();
@@ -66,6 +77,8 @@ private:
 
     KisPaintDeviceSP m_mask;
     QRect m_maskBounds;
+    QVector<quint8> m_maskData;
+    const KoColorSpace *m_maskDataColorSpace = 0;
 
 };
 
@@ -8,6 +8,8 @@
 #include <kis_paint_device.h>
 
 #include <resources/KoAbstractGradient.h>
+#include <resources/KoCachedGradient.h>
+#include <kis_pointer_utils.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorTransformation.h>
 #include <KoMixColorsOp.h>
@@ -42,9 +44,14 @@ void KisUniformColorSource::resize(double , double)
 void KisUniformColorSource::colorize(KisPaintDeviceSP dev, const QRect& size, const QPoint&) const
 {
     Q_UNUSED(size);
-    KoColor c(dev->colorSpace());
-    c.fromKoColor(m_color);
-    dev->dataManager()->setDefaultPixel(c.data());
+
+    if (*dev->colorSpace() == *m_color.colorSpace()) {
+        dev->dataManager()->setDefaultPixel(m_color.data());
+    } else {
+        KoColor c(dev->colorSpace());
+        c.fromKoColor(m_color);
+        dev->dataManager()->setDefaultPixel(c.data());
+    }
     dev->clear();
 }
 
@@ -110,6 +117,15 @@ KisGradientColorSource::KisGradientColorSource(const KoAbstractGradientSP gradie
     m_color = KoColor(workingCS);
 
     Q_ASSERT(gradient);
+
+    /**
+     * The color is selected for every dab, so the gradient is sampled
+     * in the working color space only once. Otherwise every dab would
+     * convert both surrounding stops of the gradient.
+     */
+    if (m_gradient) {
+        m_cachedGradient = toQShared(new KoCachedGradient(m_gradient, 256, m_color.colorSpace()));
+    }
 }
 
 KisGradientColorSource::~KisGradientColorSource()
@@ -119,8 +135,8 @@ KisGradientColorSource::~KisGradientColorSource()
 void KisGradientColorSource::selectColor(double mix, const KisPaintInformation &pi)
 {
     Q_UNUSED(pi);
-    if (m_gradient) {
-        m_gradient->colorAt(m_color, mix);
+    if (m_cachedGradient) {
+        memcpy(m_color.data(), m_cachedGradient->cachedAt(qBound(0.0, mix, 1.0)), m_color.colorSpace()->pixelSize());
     }
 }
 
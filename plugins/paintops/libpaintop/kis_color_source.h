@@ -18,6 +18,7 @@
 #include <kritapaintop_export.h>
 
 class KoColorTransformation;
+class KoCachedGradient;
 class KisPaintInformation;
 
 /**
@@ -83,6 +84,7 @@ public:
     void selectColor(double mix, const KisPaintInformation &pi) override;
 private:
     const KoAbstractGradientSP m_gradient;
+    QSharedPointer<KoCachedGradient> m_cachedGradient;
 };
 
 class PAINTOP_EXPORT KisUniformRandomColorSource : public KisUniformColorSource
@@ -19,7 +19,8 @@
 struct KisDabCache::Private {
 
     Private(KisBrushSP brush)
-        : brush(brush)
+        : brush(brush),
+          brushHash(KisPersistentDabCache::brushHash(brush))
     {}
 
     int seqNo = 0;
@@ -30,6 +31,9 @@ struct KisDabCache::Private {
     KisBrushSP brush;
     KisPaintDeviceSP colorSourceDevice;
 
+    /// empty if the dabs of the brush cannot be shared between strokes
+    QByteArray brushHash;
+
     KisSharpnessOption *sharpnessOption = 0;
     KisTextureOption *textureOption = 0;
 };
@@ -215,10 +219,32 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
         return fetchFromCache(&resources, info, dstDabRect);
     }
 
-    // 3. Generate new dab
+    // 3. Try to fetch the dab generated by one of the previous strokes,
+    //    or generate a new one
+
+    const bool usePersistentCache =
+        !m_d->brushHash.isEmpty() && di.solidColorFill && !di.needsPostprocessing;
+
+    KisPersistentDabCache::Key persistentKey;
+    KisFixedPaintDeviceSP persistentDab;
+
+    if (usePersistentCache) {
+        persistentKey = persistentCacheKey(m_d->brushHash, cs, forceNormalizedRGBAImageStamp);
+        persistentDab = KisPersistentDabCache::instance()->fetch(persistentKey);
+    }
+
+    if (persistentDab) {
+        m_d->dab = persistentDab;
+        *dstDabRect = KisDabCacheUtils::correctDabRectWhenFetchedFromCache(*dstDabRect, m_d->dab->bounds().size());
+        return m_d->dab;
+    }
 
     generateDab(di, &resources, &m_d->dab, forceNormalizedRGBAImageStamp);
 
+    if (usePersistentCache) {
+        KisPersistentDabCache::instance()->insert(persistentKey, m_d->dab);
+    }
+
     // 4. Do postprocessing
     if (di.needsPostprocessing) {
         if (!m_d->dabOriginal || *cs != *m_d->dabOriginal->colorSpace()) {
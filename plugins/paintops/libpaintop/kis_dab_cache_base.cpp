@@ -6,7 +6,11 @@
 
 #include "kis_dab_cache_base.h"
 
+#include <cmath>
+
 #include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorProfile.h>
 #include "kis_color_source.h"
 #include "kis_paint_device.h"
 #include "kis_brush.h"
@@ -81,6 +85,7 @@ struct KisDabCacheBase::Private {
     bool subPixelPrecisionDisabled;
 
     SavedDabParameters lastSavedDabParameters;
+    int lastPrecisionLevel = 4;
 
     static qreal positiveFraction(qreal x);
 };
@@ -281,8 +286,53 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
 
     if (!*shouldUseCache) {
         m_d->lastSavedDabParameters = newParams;
+        m_d->lastPrecisionLevel = precisionLevel;
     }
 
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
+
+namespace {
+inline qint64 quantize(qreal value, qreal step)
+{
+    return qint64(std::floor(value / step));
+}
+}
+
+KisPersistentDabCache::Key
+KisDabCacheBase::persistentCacheKey(const QByteArray &brushHash,
+                                    const KoColorSpace *cs,
+                                    bool normalizedImageStamp) const
+{
+    const SavedDabParameters &params = m_d->lastSavedDabParameters;
+    const PrecisionValues &prec = precisionLevels[m_d->lastPrecisionLevel];
+
+    /**
+     * Any two values falling into the same bucket differ less than
+     * the tolerance of SavedDabParameters::compare(), so the shared
+     * dab is always one the per-stroke cache could have reused. The
+     * size is kept exact, because the dab rect is calculated from it.
+     */
+    KisPersistentDabCache::Key key;
+    key.brushHash = brushHash;
+    key.colorSpaceId = cs->id() + (cs->profile() ? cs->profile()->name() : QString());
+    key.color = params.color.colorSpace() ?
+        QByteArray(reinterpret_cast<const char*>(params.color.data()), params.color.colorSpace()->pixelSize()) + params.color.colorSpace()->id().toLatin1() :
+        QByteArray();
+    key.width = params.width;
+    key.height = params.height;
+    key.brushIndex = params.index;
+    key.precisionLevel = m_d->lastPrecisionLevel;
+    key.angle = quantize(params.angle, prec.angle);
+    key.subPixelX = quantize(params.subPixelX, prec.subPixel);
+    key.subPixelY = quantize(params.subPixelY, prec.subPixel);
+    key.softnessFactor = quantize(params.softnessFactor, prec.softnessFactor);
+    key.lightnessStrength = quantize(params.lightnessStrength, prec.lightnessStrength);
+    key.ratio = quantize(params.ratio, prec.ratio);
+    key.horizontalMirror = params.mirrorProperties.horizontalMirror;
+    key.verticalMirror = params.mirrorProperties.verticalMirror;
+    key.normalizedImageStamp = normalizedImageStamp;
+
+    return key;
+}
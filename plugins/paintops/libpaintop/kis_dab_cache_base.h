@@ -11,6 +11,7 @@
 #include "kis_brush.h"
 
 #include "KisDabCacheUtils.h"
+#include "KisPersistentDabCache.h"
 
 class KisColorSource;
 class KisSharpnessOption;
@@ -86,6 +87,18 @@ protected:
                                 KisDabCacheUtils::DabGenerationInfo *di,
                                 bool *shouldUseCache);
 
+    /**
+     * Calculates the key of the dab returned by the last cache-missing
+     * call to fetchDabGenerationInfo() in KisPersistentDabCache. The
+     * parameters are quantized with the tolerances of the precision
+     * level used for the dab.
+     *
+     * @param brushHash KisPersistentDabCache::brushHash() of the brush
+     */
+    KisPersistentDabCache::Key persistentCacheKey(const QByteArray &brushHash,
+                                                  const KoColorSpace *cs,
+                                                  bool normalizedImageStamp) const;
+
 private:
     struct SavedDabParameters;
     struct DabPosition;
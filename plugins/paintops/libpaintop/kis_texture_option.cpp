@@ -21,14 +21,10 @@
 #include <KoResource.h>
 #include <KoResourceServerProvider.h>
 #include <kis_paint_device.h>
-#include <kis_fill_painter.h>
-#include <kis_painter.h>
-#include <kis_iterator_ng.h>
 #include <kis_fixed_paint_device.h>
 #include "KoMixColorsOp.h"
 #include <strokes/KisMaskingBrushCompositeOpBase.h>
 #include <strokes/KisMaskingBrushCompositeOpFactory.h>
-#include <kis_random_accessor_ng.h>
 #include <KoCompositeOpRegistry.h>
 
 #include <KoCanvasResourcesIds.h>
@@ -169,37 +165,81 @@ bool KisTextureOption::requiresEffectiveCompositeOp(const KisPropertiesConfigura
 }
 
 
+namespace {
+
+/**
+ * Walks through \p rc of the texture tiled over the whole plane in
+ * blocks that do not cross the borders of the pattern, so that every
+ * block is a contiguous part of the pattern's buffer. \p func receives
+ * the position of the block in the pattern, its position relative
+ * to the top-left corner of \p rc and its size.
+ */
+template <typename Func>
+void forEachPatternBlock(const QSize &patternSize, const QRect &rc, Func func)
+{
+    auto wrap = [] (int value, int size) {
+        const int result = value % size;
+        return result >= 0 ? result : result + size;
+    };
+
+    int dstY = 0;
+    while (dstY < rc.height()) {
+        const int srcY = wrap(rc.y() + dstY, patternSize.height());
+        const int rows = qMin(patternSize.height() - srcY, rc.height() - dstY);
+
+        int dstX = 0;
+        while (dstX < rc.width()) {
+            const int srcX = wrap(rc.x() + dstX, patternSize.width());
+            const int columns = qMin(patternSize.width() - srcX, rc.width() - dstX);
+
+            func(QPoint(srcX, srcY), QPoint(dstX, dstY), columns, rows);
+
+            dstX += columns;
+        }
+        dstY += rows;
+    }
+}
+
+}
+
 void KisTextureOption::applyLightness(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info) {
     if (!m_enabled) return;
     if (!m_maskInfo->isValid()) return;
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataColorSpace()->pixelSize() == sizeof(QRgb));
 
     const QRect rect = dab->bounds();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->rgb8(), m_cachedPaintDevice);
-    KisPaintDeviceSP fillMaskDevice = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillMaskPainter(fillMaskDevice);
-    fillMaskPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillMaskPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillMaskPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
-    quint8* dabData = dab->data();
 
-    KisSequentialConstIterator it(fillMaskDevice, QRect(x, y, rect.width(), rect.height()));
-    while (it.nextPixel()) {
-        const QRgb *maskQRgb = reinterpret_cast<const QRgb*>(it.oldRawData());
-        dab->colorSpace()->fillGrayBrushWithColorAndLightnessWithStrength(dabData, maskQRgb, dabData, pressure, 1);
-        dabData += dab->pixelSize();
-    }
+    const KoColorSpace *dabCs = dab->colorSpace();
+    const int dabPixelSize = dab->pixelSize();
+    const int dabRowStride = rect.width() * dabPixelSize;
+    const QRgb *maskData = reinterpret_cast<const QRgb*>(m_maskInfo->maskData());
+
+    /**
+     * The texture is sampled right from the buffer of the pattern,
+     * without tiling it into a temporary device first
+     */
+    forEachPatternBlock(maskBounds.size(), maskPatchRect,
+        [&] (const QPoint &src, const QPoint &dst, int columns, int rows) {
+            for (int row = 0; row < rows; row++) {
+                const QRgb *maskQRgb = maskData + (src.y() + row) * maskBounds.width() + src.x();
+                quint8 *dabData = dab->data() + (dst.y() + row) * dabRowStride + dst.x() * dabPixelSize;
+
+                for (int col = 0; col < columns; col++) {
+                    dabCs->fillGrayBrushWithColorAndLightnessWithStrength(dabData, maskQRgb, dabData, pressure, 1);
+                    maskQRgb++;
+                    dabData += dabPixelSize;
+                }
+            }
+        });
 }
 
 void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info) {
@@ -207,26 +247,17 @@ void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& of
     if (!m_maskInfo->isValid()) return;
 
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_gradient && m_gradient->valid());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataColorSpace()->pixelSize() == sizeof(QRgb));
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
     QRect rect = dab->bounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->rgb8(), m_cachedPaintDevice);
-    KisPaintDeviceSP fillDevice = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillPainter(fillDevice);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
-    quint8* dabData = dab->data();
 
     //for gradient textures...
     KoMixColorsOp* colorMix = dab->colorSpace()->mixColorsOp();
@@ -236,26 +267,34 @@ void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& of
     quint8* colors[2];
     m_cachedGradient.setColorSpace(dab->colorSpace()); //Change colorspace here so we don't have to convert each pixel drawn
 
-    KisHLineIteratorSP iter = fillDevice->createHLineIteratorNG(x, y, rect.width());
-    for (int row = 0; row < rect.height(); ++row) {
-        for (int col = 0; col < rect.width(); ++col) {
-
-            const QRgb* maskQRgb = reinterpret_cast<const QRgb*>(iter->oldRawData());
-            qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;//qreal(*iter->oldRawData()) / 255.0;
-            KoColor paintcolor;
-            paintcolor.setColor(m_cachedGradient.cachedAt(gradientvalue), dab->colorSpace());
-            qreal paintOpacity = paintcolor.opacityF() * (qreal(qAlpha(*maskQRgb)) / 255.0);
-            paintcolor.setOpacity(qMin(paintOpacity, dab->colorSpace()->opacityF(dabData)));
-            colors[0] = paintcolor.data();
-            KoColor dabColor(dabData, dab->colorSpace());
-            colors[1] = dabColor.data();
-            colorMix->mixColors(colors, colorWeights, 2, dabData);
-
-            iter->nextPixel();
-            dabData += dab->pixelSize();
-        }
-        iter->nextRow();
-    }
+    const int dabPixelSize = dab->pixelSize();
+    const int dabRowStride = rect.width() * dabPixelSize;
+    const QRgb *maskData = reinterpret_cast<const QRgb*>(m_maskInfo->maskData());
+
+    KoColor paintcolor(dab->colorSpace());
+    KoColor dabColor(dab->colorSpace());
+
+    forEachPatternBlock(maskBounds.size(), maskPatchRect,
+        [&] (const QPoint &src, const QPoint &dst, int columns, int rows) {
+            for (int row = 0; row < rows; row++) {
+                const QRgb *maskQRgb = maskData + (src.y() + row) * maskBounds.width() + src.x();
+                quint8 *dabData = dab->data() + (dst.y() + row) * dabRowStride + dst.x() * dabPixelSize;
+
+                for (int col = 0; col < columns; col++) {
+                    qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;
+                    paintcolor.setColor(m_cachedGradient.cachedAt(gradientvalue), dab->colorSpace());
+                    qreal paintOpacity = paintcolor.opacityF() * (qreal(qAlpha(*maskQRgb)) / 255.0);
+                    paintcolor.setOpacity(qMin(paintOpacity, dab->colorSpace()->opacityF(dabData)));
+                    colors[0] = paintcolor.data();
+                    memcpy(dabColor.data(), dabData, dabPixelSize);
+                    colors[1] = dabColor.data();
+                    colorMix->mixColors(colors, colorWeights, 2, dabData);
+
+                    maskQRgb++;
+                    dabData += dabPixelSize;
+                }
+            }
+        });
 }
 
 void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, const KisPaintInformation & info)
@@ -272,23 +311,16 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
         return;
     }
 
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataColorSpace()->pixelSize() == 1);
+
     QRect rect = dab->bounds();
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), m_cachedPaintDevice);
-    KisPaintDeviceSP maskPatch = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillPainter(maskPatch);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
-
     // Compute final strength
     qreal strength = m_strengthOption.apply(info);
 
@@ -334,45 +366,19 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
                         compositeOpId, alphaChannelType, dab->pixelSize(),
                         alphaChannelOffset, strength, m_useSoftTexturing));
 
-    // Apply the mask to the dab
-    {
-        quint8 *dabIt = nullptr;
-        KisRandomConstAccessorSP maskPatchIt = maskPatch->createRandomConstAccessorNG();
-
-        qint32 dabY = dab->bounds().y();
-        qint32 maskPatchY = maskPatchRect.y();
-        qint32 rowsRemaining = dab->bounds().height();
-        const qint32 dabRowStride = dab->bounds().width() * dab->pixelSize();
-
-        while (rowsRemaining > 0) {
-            qint32 dabX = dab->bounds().x();
-            qint32 maskPatchX = maskPatchRect.x();
-            const qint32 numContiguousMaskPatchRows = maskPatchIt->numContiguousRows(maskPatchY);
-            const qint32 rows = std::min(rowsRemaining, numContiguousMaskPatchRows);
-            qint32 columnsRemaining = dab->bounds().width();
-
-            while (columnsRemaining > 0) {
-                const qint32 numContiguousMaskPatchColumns = maskPatchIt->numContiguousColumns(maskPatchX);
-                const qint32 columns = std::min(columnsRemaining, numContiguousMaskPatchColumns);
-
-                const qint32 maskPatchRowStride = maskPatchIt->rowStride(maskPatchX, maskPatchY);
-
-                dabIt = dab->data() + (dabY * dab->bounds().width() + dabX) * dab->pixelSize();
-                maskPatchIt->moveTo(maskPatchX, maskPatchY);
-
-                compositeOp->composite(maskPatchIt->rawDataConst(), maskPatchRowStride,
-                                       dabIt, dabRowStride,
-                                       columns, rows);
-
-                dabX += columns;
-                maskPatchX += columns;
-                columnsRemaining -= columns;
-
-            }
-
-            dabY += rows;
-            maskPatchY += rows;
-            rowsRemaining -= rows;
-        }
-    }
+    /**
+     * Apply the mask to the dab right from the buffer of the pattern,
+     * there is no need to tile it into a temporary device first
+     */
+    const int dabPixelSize = dab->pixelSize();
+    const int dabRowStride = rect.width() * dabPixelSize;
+    const int maskRowStride = maskBounds.width();
+    const quint8 *maskData = m_maskInfo->maskData();
+
+    forEachPatternBlock(maskBounds.size(), maskPatchRect,
+        [&] (const QPoint &src, const QPoint &dst, int columns, int rows) {
+            compositeOp->composite(maskData + src.y() * maskRowStride + src.x(), maskRowStride,
+                                   dab->data() + dst.y() * dabRowStride + dst.x() * dabPixelSize, dabRowStride,
+                                   columns, rows);
+        });
 }
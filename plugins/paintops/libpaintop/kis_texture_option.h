@@ -11,7 +11,6 @@
 #include <kritapaintop_export.h>
 
 #include <kis_paint_device.h>
-#include <kis_cached_paint_device.h>
 #include <kis_types.h>
 #include <resources/KoAbstractGradient.h>
 #include <resources/KoCachedGradient.h>
@@ -71,7 +70,6 @@ private:
     KisStrengthOption m_strengthOption;
     KisTextureMaskInfoSP m_maskInfo;
     KisBrushTextureFlags m_flags;
-    KisCachedPaintDevice m_cachedPaintDevice;
 };
 
 #endif // KIS_TEXTURE_OPTION_H
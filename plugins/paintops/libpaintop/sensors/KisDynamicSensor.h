@@ -43,7 +43,12 @@ public:
 
 private:
     KoID m_id;
-    std::optional<KisCubicCurve> m_curve;
+
+    /**
+     * The transfer table of the curve is calculated once on
+     * construction, it is empty for the identity curve
+     */
+    QVector<qreal> m_curveTransfer;
 };
 
 #endif // KISDYNAMICSENSOR_H
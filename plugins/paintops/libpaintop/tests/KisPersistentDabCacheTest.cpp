@@ -0,0 +1,120 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPersistentDabCacheTest.h"
+
+#include <simpletest.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_fixed_paint_device.h>
+
+#include "KisPersistentDabCache.h"
+
+namespace {
+
+KisFixedPaintDeviceSP createDab(int size, quint8 value)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    dab->setRect(QRect(0, 0, size, size));
+    dab->initialize(value);
+    return dab;
+}
+
+KisPersistentDabCache::Key createKey(int size, qint64 angle = 0)
+{
+    KisPersistentDabCache::Key key;
+    key.brushHash = "brush";
+    key.colorSpaceId = KoColorSpaceRegistry::instance()->alpha8()->id();
+    key.width = size;
+    key.height = size;
+    key.angle = angle;
+    return key;
+}
+
+}
+
+void KisPersistentDabCacheTest::testFetchReturnsCopy()
+{
+    KisPersistentDabCache cache;
+
+    KisFixedPaintDeviceSP dab = createDab(64, 128);
+    cache.insert(createKey(64), dab);
+
+    // modifying the original doesn't change the cached version
+    dab->initialize(0);
+
+    KisFixedPaintDeviceSP fetched = cache.fetch(createKey(64));
+    QVERIFY(fetched);
+    QVERIFY(fetched != dab);
+    QCOMPARE(fetched->bounds(), QRect(0, 0, 64, 64));
+    QCOMPARE(fetched->data()[0], quint8(128));
+
+    // and modifying the fetched one doesn't change it either
+    fetched->initialize(0);
+    QCOMPARE(cache.fetch(createKey(64))->data()[0], quint8(128));
+}
+
+void KisPersistentDabCacheTest::testKeyMismatch()
+{
+    KisPersistentDabCache cache;
+    cache.insert(createKey(64), createDab(64, 128));
+
+    QVERIFY(!cache.fetch(createKey(64, 1)));
+    QVERIFY(!cache.fetch(createKey(65)));
+
+    KisPersistentDabCache::Key otherBrush = createKey(64);
+    otherBrush.brushHash = "other";
+    QVERIFY(!cache.fetch(otherBrush));
+
+    QVERIFY(cache.fetch(createKey(64)));
+}
+
+void KisPersistentDabCacheTest::testLeastRecentlyUsedEviction()
+{
+    KisPersistentDabCache cache;
+
+    // room for exactly three 64x64 alpha dabs
+    cache.setMemoryLimit(3 * 64 * 64);
+
+    cache.insert(createKey(64, 0), createDab(64, 0));
+    cache.insert(createKey(64, 1), createDab(64, 1));
+    cache.insert(createKey(64, 2), createDab(64, 2));
+    QCOMPARE(cache.numDabs(), 3);
+    QCOMPARE(cache.memoryUsage(), qint64(3 * 64 * 64));
+
+    // touch the oldest dab, so the second one becomes the LRU
+    QVERIFY(cache.fetch(createKey(64, 0)));
+
+    cache.insert(createKey(64, 3), createDab(64, 3));
+    QCOMPARE(cache.numDabs(), 3);
+
+    QVERIFY(cache.fetch(createKey(64, 0)));
+    QVERIFY(!cache.fetch(createKey(64, 1)));
+    QVERIFY(cache.fetch(createKey(64, 2)));
+    QVERIFY(cache.fetch(createKey(64, 3)));
+
+    // a dab bigger than the whole cache is not stored
+    cache.insert(createKey(256), createDab(256, 0));
+    QVERIFY(!cache.fetch(createKey(256)));
+
+    cache.clear();
+    QCOMPARE(cache.numDabs(), 0);
+    QCOMPARE(cache.memoryUsage(), qint64(0));
+}
+
+void KisPersistentDabCacheTest::testDisabledCache()
+{
+    KisPersistentDabCache cache;
+    cache.setMemoryLimit(0);
+
+    cache.insert(createKey(64), createDab(64, 128));
+    QVERIFY(!cache.fetch(createKey(64)));
+    QCOMPARE(cache.numDabs(), 0);
+}
+
+SIMPLE_TEST_MAIN(KisPersistentDabCacheTest)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERSISTENTDABCACHETEST_H
+#define KISPERSISTENTDABCACHETEST_H
+
+#include <QObject>
+
+class KisPersistentDabCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFetchReturnsCopy();
+    void testKeyMismatch();
+    void testLeastRecentlyUsedEviction();
+    void testDisabledCache();
+};
+
+#endif // KISPERSISTENTDABCACHETEST_H
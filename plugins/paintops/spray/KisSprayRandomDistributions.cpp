@@ -4,6 +4,7 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include <kis_assert.h>
@@ -23,6 +24,33 @@ public:
 
     std::vector<SampleInfo> samples;
 
+    /**
+     * The index of the first sample with the cdf greater than the
+     * start of each of the equally sized buckets of the [0..1] range.
+     * It narrows the search of the sample down to a few entries, so
+     * sampling the distribution costs nearly the same for the dense
+     * curve-based tables as it does for the simple ones.
+     */
+    static constexpr size_t numberOfBuckets {256};
+    std::vector<size_t> bucketStarts;
+
+    void initializeBuckets()
+    {
+        bucketStarts.clear();
+
+        if (samples.empty()) {
+            return;
+        }
+
+        bucketStarts.reserve(numberOfBuckets + 1);
+        for (size_t i = 0; i <= numberOfBuckets; ++i) {
+            const double value = static_cast<double>(i) / static_cast<double>(numberOfBuckets);
+            auto it = std::upper_bound(samples.begin(), samples.end(), SampleInfo{0.0, value, 0.0},
+                                       kismpl::mem_less(&SampleInfo::cdfAtX));
+            bucketStarts.push_back(static_cast<size_t>(it - samples.begin()));
+        }
+    }
+
     template <typename Function>
     void initialize(size_t numberOfSamples, double a, double b, Function f)
     {
@@ -30,10 +58,12 @@ public:
         KIS_SAFE_ASSERT_RECOVER_RETURN(b > a);
 
         samples.clear();
+        bucketStarts.clear();
 
         if (numberOfSamples < 3) {
             samples.push_back({a, 0.0, 0.0});
             samples.push_back({b, 1.0, 1.0});
+            initializeBuckets();
             return;
         }
 
@@ -146,13 +176,21 @@ public:
             samples.back().cdfAtX = 1.0;
             samples.back().oneOverCdfDy = 1.0 / (1.0 - samples[samples.size() - 2].cdfAtX);
         }
+
+        initializeBuckets();
     }
 
     double generate(double randomValue) const
     {
-        // Find the first sample that has cdf greater than the passed value
+        // Find the first sample that has cdf greater than the passed value.
+        // It is guaranteed to be in the range of the value's bucket
+        const size_t bucket =
+            std::min(static_cast<size_t>(std::max(randomValue, 0.0) * static_cast<double>(numberOfBuckets)),
+                     numberOfBuckets - 1);
+        const auto first = samples.begin() + bucketStarts[bucket];
+        const auto last = samples.begin() + std::min(bucketStarts[bucket + 1] + 1, samples.size());
         auto sampleIterator =
-            std::upper_bound(samples.begin(), samples.end(), SampleInfo{0.0, randomValue, 0.0},
+            std::upper_bound(first, last, SampleInfo{0.0, randomValue, 0.0},
                              kismpl::mem_less(&SampleInfo::cdfAtX));
         const double t = (randomValue - (sampleIterator - 1)->cdfAtX) * sampleIterator->oneOverCdfDy;
         return (sampleIterator - 1)->x + t * (sampleIterator->x - (sampleIterator - 1)->x);
@@ -177,12 +215,14 @@ KisSprayFunctionBasedDistribution::KisSprayFunctionBasedDistribution(const KisSp
     : m_d(new Private)
 {
     m_d->samples = other.m_d->samples;
+    m_d->bucketStarts = other.m_d->bucketStarts;
 }
 
 KisSprayFunctionBasedDistribution& KisSprayFunctionBasedDistribution::KisSprayFunctionBasedDistribution::operator=(const KisSprayFunctionBasedDistribution &rhs)
 {
     if (this != &rhs) {
         m_d->samples = rhs.m_d->samples;
+        m_d->bucketStarts = rhs.m_d->bucketStarts;
     }
     return *this;
 }
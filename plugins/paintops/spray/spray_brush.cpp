@@ -36,10 +36,21 @@
 
 #include <QtGlobal>
 
+namespace {
+
+/**
+ * The max number of brush dabs that are composited in one pass. It
+ * limits the memory consumed by the dabs waiting for compositing.
+ */
+const int maxBatchedDabs = 128;
+
+}
+
 SprayBrush::SprayBrush()
 {
     m_painter = nullptr;
     m_transfo = nullptr;
+    m_particlesPath.setFillRule(Qt::WindingFill);
 }
 
 SprayBrush::~SprayBrush()
@@ -258,6 +269,9 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         // color transformation
 
         if (shouldColor) {
+            // the batched particles should be painted with the old color
+            flushParticles();
+
             if (m_colorProperties->sampleInputColor) {
                 colorSampler.sampleOldColor(nx + x, ny + y, m_inkColor.data());
             }
@@ -302,6 +316,15 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             m_painter->setPaintColor(m_inkColor);
         }
 
+        /**
+         * Opaque shapes of the same color can be united into a single
+         * path and filled at once, the result of the compositing of the
+         * semi-transparent ones depends on their overlapping though
+         */
+        const bool canBatchShapes =
+            m_painter->opacityF() == OPACITY_OPAQUE_F &&
+            m_inkColor.opacityU8() == OPACITY_OPAQUE_U8;
+
         qreal jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
         qreal jitteredHeight = qMax(1.0 * additionalScale, effectiveSize.height() * particleScale * additionalScale);
 
@@ -311,17 +334,23 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             case 0:
             {
                 if (effectiveSize.width() == effectiveSize.height()){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
+                    addCircle(m_particlesPath, nx + x, ny + y, jitteredWidth * 0.5);
                 }
                 else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                    addEllipse(m_particlesPath, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                }
+                if (!canBatchShapes) {
+                    flushParticles();
                 }
                 break;
             }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                addRectangle(m_particlesPath, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                if (!canBatchShapes) {
+                    flushParticles();
+                }
                 break;
             }
             // wu-particle
@@ -388,28 +417,45 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
             m_brush->prepareForSeqNo(info, m_dabSeqNo);
 
-            //KisFixedPaintDeviceSP dab;
+            KisFixedPaintDeviceSP particleDab;
+
             if (m_brush->brushApplication() == IMAGESTAMP) {
-                m_fixedDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
+                particleDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
                           shape, info, xFraction, yFraction);
 
                 if (m_colorProperties->useRandomHSV && m_transfo) {
-                    quint8 * dabPointer = m_fixedDab->data();
-                    int pixelCount = m_fixedDab->bounds().width() * m_fixedDab->bounds().height();
+                    quint8 * dabPointer = particleDab->data();
+                    int pixelCount = particleDab->bounds().width() * particleDab->bounds().height();
                     m_transfo->transform(dabPointer, dabPointer, pixelCount);
                 }
 
             }
             else {
-                m_brush->mask(m_fixedDab, m_inkColor, shape,
+                // the devices of the composited dabs are reused for the next batch
+                if (m_renderedDabs.size() >= m_particleDabsPool.size()) {
+                    m_particleDabsPool.append(new KisFixedPaintDevice(m_fixedDab->colorSpace()));
+                }
+                particleDab = m_particleDabsPool[m_renderedDabs.size()];
+
+                m_brush->mask(particleDab, m_inkColor, shape,
                               info, xFraction, yFraction);
             }
-            m_painter->bltFixed(QPoint(ix, iy), m_fixedDab, m_fixedDab->bounds());
+
+            KisRenderedDab renderedDab(particleDab);
+            renderedDab.offset = QPoint(ix, iy);
+            renderedDab.opacity = m_painter->opacityF();
+            m_renderedDabs.append(renderedDab);
+
+            if (m_renderedDabs.size() >= maxBatchedDabs) {
+                flushParticles();
+            }
         }
         if (m_colorProperties->colorPerParticle){
             m_inkColor=color;//reset color//
         }
     }
+
+    flushParticles();
     // recover from jittering of color,
     // m_inkColor.opacity is recovered with every paint
 }
@@ -453,34 +499,55 @@ void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor
     memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
 }
 
+void SprayBrush::flushParticles()
+{
+    if (!m_particlesPath.isEmpty()) {
+        m_painter->fillPainterPath(m_particlesPath);
+        m_particlesPath = QPainterPath();
+        m_particlesPath.setFillRule(Qt::WindingFill);
+    }
+
+    if (!m_renderedDabs.isEmpty()) {
+        QRect rc;
+        Q_FOREACH (const KisRenderedDab &dab, m_renderedDabs) {
+            rc |= dab.realBounds();
+        }
+
+        m_painter->bltFixed(rc, m_renderedDabs);
+        m_renderedDabs.clear();
+    }
+}
+
 void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
 {
     QPainterPath path;
-    path.addEllipse(QPointF(x,y),radius,radius);
+    addCircle(path, x, y, radius);
     painter->fillPainterPath(path);
 }
 
+void SprayBrush::addCircle(QPainterPath &path, qreal x, qreal y, qreal radius)
+{
+    path.addEllipse(QPointF(x,y),radius,radius);
+}
 
-void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle)
+void SprayBrush::addEllipse(QPainterPath &path, qreal x, qreal y, qreal a, qreal b, qreal angle)
 {
-    QPainterPath path;
-    path.addEllipse(QPointF(), a, b);
+    QPainterPath ellipse;
+    ellipse.addEllipse(QPointF(), a, b);
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    path.addPath(t.map(ellipse));
 }
 
-void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle)
+void SprayBrush::addRectangle(QPainterPath &path, qreal x, qreal y, qreal width, qreal height, qreal angle)
 {
-    QPainterPath path;
-    path.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
+    QPainterPath rect;
+    rect.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    path.addPath(t.map(rect));
 }
 
 
@@ -24,7 +24,11 @@
 
 
 #include <QImage>
+#include <QList>
+#include <QPainterPath>
+#include <QVector>
 #include <kis_brush.h>
+#include <KisRenderedDab.h>
 
 class KisPaintInformation;
 
@@ -74,6 +78,15 @@ private:
     KisBrushSP m_brush;
     KisFixedPaintDeviceSP m_fixedDab;
 
+    /**
+     * The particles of the same color are not painted one by one,
+     * they are collected into a single path or a list of dabs and
+     * composited in one pass by flushParticles()
+     */
+    QPainterPath m_particlesPath;
+    QList<KisRenderedDab> m_renderedDabs;
+    QVector<KisFixedPaintDeviceSP> m_particleDabsPool;
+
 private:
     template <typename AngularDistribution>
     void paintImpl(KisPaintDeviceSP dab,
@@ -101,8 +114,11 @@ private:
     /// Paints Wu Particle
     void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
     void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    void addCircle(QPainterPath &path, qreal x, qreal y, qreal radius);
+    void addEllipse(QPainterPath &path, qreal x, qreal y, qreal a, qreal b, qreal angle);
+    void addRectangle(QPainterPath &path, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    /// composites the batched particles into the dab
+    void flushParticles();
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 
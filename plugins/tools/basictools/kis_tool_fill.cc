@@ -52,6 +52,7 @@
 #include <commands_new/kis_update_command.h>
 #include <kis_fill_painter.h>
 #include <kis_selection_filters.h>
+#include <floodfill/kis_gap_map_cache.h>
 
 #include <KisPart.h>
 #include <KisDocument.h>
@@ -114,6 +115,7 @@ void KisToolFill::activate(const QSet<KoShape*> &shapes)
 
 void KisToolFill::deactivate()
 {
+    KisGapMapCache::clear();
     m_referencePaintDevice = nullptr;
     m_referenceNodeList = nullptr;
     KisCanvas2 *kisCanvas = static_cast<KisCanvas2*>(canvas());
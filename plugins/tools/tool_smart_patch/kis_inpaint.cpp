@@ -16,6 +16,7 @@
  */
 
 #include <boost/multi_array.hpp>
+#include <algorithm>
 #include <random>
 #include <iostream>
 #include <functional>
@@ -47,6 +48,8 @@ const quint8 MASK_CLEAR = 0;
 
 class MaskedImage; //forward decl for the forward decl below
 template <typename T> float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo);
+template <typename T> int patch_distance_impl(const MaskedImage& input, int x, int y, const MaskedImage& output, int xp, int yp, int patchSize);
+
 
 
 class ImageView
@@ -201,6 +204,7 @@ class MaskedImage : public KisShared
 private:
 
     template <typename T> friend float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo);
+    template <typename T> friend int patch_distance_impl(const MaskedImage& input, int x, int y, const MaskedImage& output, int xp, int yp, int patchSize);
 
     QRect imageSize;
     int nChannels {0};
@@ -239,6 +243,9 @@ private:
 public:
     std::function< float(const MaskedImage&, int, int, const MaskedImage& , int , int ) > distance;
 
+    // the distance between the whole patches, see NearestNeighborField::distance()
+    int (*patchDistance)(const MaskedImage&, int, int, const MaskedImage&, int, int, int) {nullptr};
+
     void toPaintDevice(KisPaintDeviceSP imageDev, QRect rect, KisSelectionSP selection)
     {
         if (!selection) {
@@ -275,18 +282,27 @@ public:
 
         //Use RGB traits to assign actual pixel data types.
         distance = &distance_impl<KoRgbU8Traits::channels_type>;
+        patchDistance = &patch_distance_impl<KoRgbU8Traits::channels_type>;
 
-        if( colorDepthId == Integer16BitsColorDepthID )
+        if( colorDepthId == Integer16BitsColorDepthID ) {
             distance = &distance_impl<KoRgbU16Traits::channels_type>;
+            patchDistance = &patch_distance_impl<KoRgbU16Traits::channels_type>;
+        }
 #ifdef HAVE_OPENEXR
-        if( colorDepthId == Float16BitsColorDepthID )
+        if( colorDepthId == Float16BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF16Traits::channels_type>;
+            patchDistance = &patch_distance_impl<KoRgbF16Traits::channels_type>;
+        }
 #endif
-        if( colorDepthId == Float32BitsColorDepthID )
+        if( colorDepthId == Float32BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF32Traits::channels_type>;
+            patchDistance = &patch_distance_impl<KoRgbF32Traits::channels_type>;
+        }
 
-        if( colorDepthId == Float64BitsColorDepthID )
+        if( colorDepthId == Float64BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF64Traits::channels_type>;
+            patchDistance = &patch_distance_impl<KoRgbF64Traits::channels_type>;
+        }
     }
 
     MaskedImage(KisPaintDeviceSP _imageDev, KisPaintDeviceSP _maskDev, QRect _maskRect)
@@ -383,6 +399,7 @@ public:
         clone->cs = this->cs;
         clone->csMask = this->csMask;
         clone->distance = this->distance;
+        clone->patchDistance = this->patchDistance;
         return clone;
     }
 
@@ -440,7 +457,7 @@ public:
         cs->fromNormalisedChannelsValue(imageData(x, y), value);
     }
 
-    inline void mixColors(std::vector< quint8* > pixels, std::vector< float > w, float wsum,  quint8* dst)
+    inline void mixColors(const std::vector< quint8* >& pixels, const std::vector< float >& w, float wsum,  quint8* dst)
     {
         const KoMixColorsOp* mixOp = cs->mixColorsOp();
 
@@ -478,12 +495,9 @@ public:
 
 //Generic version of the distance function. produces distance between colors in the range [0, MAX_DIST]. This
 //is a fast distance computation. More accurate, but very slow implementation is to use color space operations.
-template <typename T> float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo)
+template <typename T> inline float pixel_distance(const T *v1, const T *v2, quint32 nchannels)
 {
     float dsq = 0;
-    quint32 nchannels = my.channelCount();
-    T *v1 = reinterpret_cast<T*>(my.imageData(x, y));
-    T *v2 = reinterpret_cast<T*>(other.imageData(xo, yo));
 
     for (quint32 chan = 0; chan < nchannels; chan++) {
         //It's very important not to lose precision in the next line
@@ -495,6 +509,59 @@ template <typename T> float distance_impl(const MaskedImage& my, int x, int y, c
     return qMin((float)(nchannels * MAX_DIST), dsq / (pow2((float)KoColorSpaceMathsTraits<T>::unitValue) / MAX_DIST ));
 }
 
+template <typename T> float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo)
+{
+    const T *v1 = reinterpret_cast<const T*>(my.imageData(x, y));
+    const T *v2 = reinterpret_cast<const T*>(other.imageData(xo, yo));
+
+    return pixel_distance(v1, v2, my.channelCount());
+}
+
+//Distance between the patch of the input centered at (x, y) and the patch of the output centered at (xp, yp),
+//in the range [0, MAX_DIST]. The pixels outside any of the images or masked in any of them count as the
+//maximum distance. The valid part of every row of the patch is contiguous in both images, so the rows are
+//walked with plain pointers and the inner loop can be vectorized by the compiler.
+template <typename T> int patch_distance_impl(const MaskedImage& input, int x, int y, const MaskedImage& output, int xp, int yp, int patchSize)
+{
+    const quint32 nchannels = input.channelCount();
+    const qint64 ssdmax = nchannels * 255 * (qint64)255;
+    const int patchWidth = 2 * patchSize + 1;
+    const qint64 wsum = ssdmax * patchWidth * patchWidth;
+
+    const int dxMin = std::max({-patchSize, -x, -xp});
+    const int dxMax = std::min({patchSize, input.imageSize.width() - 1 - x, output.imageSize.width() - 1 - xp});
+    const int dyMin = std::max({-patchSize, -y, -yp});
+    const int dyMax = std::min({patchSize, input.imageSize.height() - 1 - y, output.imageSize.height() - 1 - yp});
+
+    const int inputPixelSize = input.imageData.pixel_size();
+    const int outputPixelSize = output.imageData.pixel_size();
+
+    qint64 distance = 0;
+    int numSkippedPixels = patchWidth * patchWidth;
+
+    for (int dy = dyMin; dy <= dyMax && dxMin <= dxMax; dy++) {
+        const quint8 *inputMask = input.maskData(x + dxMin, y + dy);
+        const quint8 *outputMask = output.maskData(xp + dxMin, yp + dy);
+        const quint8 *inputPixel = input.imageData(x + dxMin, y + dy);
+        const quint8 *outputPixel = output.imageData(xp + dxMin, yp + dy);
+
+        for (int i = 0; i <= dxMax - dxMin; i++) {
+            //cannot use masked pixels as a valid source of information
+            if (inputMask[i] == MASK_CLEAR && outputMask[i] == MASK_CLEAR) {
+                const float ssd = pixel_distance(reinterpret_cast<const T*>(inputPixel + i * inputPixelSize),
+                                                 reinterpret_cast<const T*>(outputPixel + i * outputPixelSize),
+                                                 nchannels);
+                distance += qRound(ssd);
+                numSkippedPixels--;
+            }
+        }
+    }
+
+    distance += numSkippedPixels * ssdmax;
+
+    return qFloor(MAX_DIST * (qreal(distance) / wsum));
+}
+
 
 typedef KisSharedPtr<MaskedImage> MaskedImageSP;
 
@@ -517,9 +584,11 @@ class NearestNeighborField : public KisShared
 {
 
 private:
+    typedef std::mt19937 RandomGenerator;
+
     template< typename T> T randomInt(T range)
     {
-        return rand() % range;
+        return m_generator() % range;
     }
 
     //compute initial value of the distance term
@@ -561,6 +630,7 @@ private:
 
 private:
     int patchSize; //patch size
+    RandomGenerator m_generator;
 public:
     MaskedImageSP input;
     MaskedImageSP output;
@@ -685,62 +755,7 @@ public:
     //compute distance between two patches
     int distance(int x, int y, int xp, int yp)
     {
-        qint64 distance = 0;
-        qint64 wsum = 0;
-        const qint64 ssdmax = nColors * 255 * (qint64)255;
-
-        //for each pixel in the source patch
-        for (int dy = -patchSize; dy <= patchSize; dy++) {
-            for (int dx = -patchSize; dx <= patchSize; dx++) {
-                wsum += ssdmax;
-                int xks = x + dx;
-                int yks = y + dy;
-
-                if (xks < 0 || xks >= input->size().width()) {
-                    distance += ssdmax;
-                    continue;
-                }
-
-                if (yks < 0 || yks >= input->size().height()) {
-                    distance += ssdmax;
-                    continue;
-                }
-
-                //cannot use masked pixels as a valid source of information
-                if (input->isMasked(xks, yks)) {
-                    distance += ssdmax;
-                    continue;
-                }
-
-                //corresponding pixel in target patch
-                int xkt = xp + dx;
-                int ykt = yp + dy;
-                if (xkt < 0 || xkt >= output->size().width()) {
-                    distance += ssdmax;
-                    continue;
-                }
-                if (ykt < 0 || ykt >= output->size().height()) {
-                    distance += ssdmax;
-                    continue;
-                }
-
-                //cannot use masked pixels as a valid source of information
-                if (output->isMasked(xkt, ykt)) {
-                    distance += ssdmax;
-                    continue;
-                }
-
-                //SSD distance between pixels
-                float ssd = input->distance(*input, xks, yks, *output, xkt, ykt);
-                distance += qRound(ssd);
-
-            }
-        }
-
-        if (wsum == 0) {
-            return 0; // sanity check, to avoid undefined behaviour in code below
-        }
-        return qFloor(MAX_DIST * (qreal(distance) / wsum));
+        return input->patchDistance(*input, x, y, *output, xp, yp, patchSize);
     }
 
     static MaskedImageSP ExpectationMaximization(KisSharedPtr<NearestNeighborField> TargetToSource, int level, int radius, QList<MaskedImageSP>& pyramid);
@@ -23,6 +23,7 @@ struct KisCageTransformStrategy::Private
     }
 
     KisCageTransformStrategy * const q;
+    KisCageTransformWorker::GridCacheSP gridCache;
 };
 
 
@@ -44,6 +45,11 @@ KisCageTransformStrategy::~KisCageTransformStrategy()
 {
 }
 
+void KisCageTransformStrategy::clearGridCache()
+{
+    m_d->gridCache.clear();
+}
+
 void KisCageTransformStrategy::drawConnectionLines(QPainter &gc,
                                                    const QVector<QPointF> &origPoints,
                                                    const QVector<QPointF> &transfPoints,
@@ -84,6 +90,12 @@ QImage KisCageTransformStrategy::calculateTransformedImage(ToolTransformArgs &cu
                                   origPoints,
                                   0,
                                   currentArgs.previewPixelPrecision());
+
+    if (!m_d->gridCache) {
+        m_d->gridCache = KisCageTransformWorker::createGridCache();
+    }
+
+    worker.setGridCache(m_d->gridCache);
     worker.prepareTransform();
     worker.setTransformedCage(transfPoints);
     return worker.runOnQImage(dstOffset);
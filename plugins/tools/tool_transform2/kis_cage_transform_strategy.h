@@ -29,6 +29,12 @@ public:
                              TransformTransactionProperties &transaction);
     ~KisCageTransformStrategy() override;
 
+    /**
+     * Drops the grid of the cage cached for the preview. Called
+     * when the transform stroke is finished or cancelled.
+     */
+    void clearGridCache();
+
 protected:
     void drawConnectionLines(QPainter &gc,
                              const QVector<QPointF> &origPoints,
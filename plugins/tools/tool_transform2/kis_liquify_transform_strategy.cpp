@@ -272,7 +272,7 @@ void KisLiquifyTransformStrategy::Private::recalculateTransformations()
     paintingOffset = transaction.originalTopLeft();
     if (!q->originalImage().isNull()) {
         if (useFlakeOptimization) {
-            transformedImage = q->originalImage().transformed(resultThumbTransform);
+            transformedImage = q->transformedOriginalImage(resultThumbTransform);
             paintingTransform = QTransform();
         } else {
             transformedImage = q->originalImage();
@@ -831,7 +831,7 @@ void KisMeshTransformStrategy::Private::recalculateTransformations()
     if (!q->originalImage().isNull()) {
         const QPointF origTLInFlake = imageToThumb.map(transaction.originalTopLeft());
         if (useFlakeOptimization) {
-            transformedImage = q->originalImage().transformed(resultThumbTransform);
+            transformedImage = q->transformedOriginalImage(resultThumbTransform);
             paintingTransform = QTransform();
         } else {
             transformedImage = q->originalImage();
@@ -1025,6 +1025,7 @@ void KisToolTransform::endStroke()
     }
 
     image()->endStroke(m_strokeId);
+    m_cageStrategy->clearGridCache();
 
     m_strokeStrategyCookie = 0;
     m_strokeId.clear();
@@ -1103,6 +1104,7 @@ void KisToolTransform::cancelStroke()
     }
 
     image()->cancelStroke(m_strokeId);
+    m_cageStrategy->clearGridCache();
     m_strokeStrategyCookie = 0;
     m_strokeId.clear();
     m_changesTracker.reset();
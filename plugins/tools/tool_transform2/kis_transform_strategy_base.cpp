@@ -17,6 +17,9 @@ struct KisTransformStrategyBase::Private
     QTransform thumbToImageTransform;
     QImage originalImage;
     int decorationThickness = 1;
+
+    QImage transformedOriginalImage;
+    QTransform transformedOriginalImageTransform;
 };
 
 
@@ -62,10 +65,23 @@ QTransform KisTransformStrategyBase::thumbToImageTransform() const
     return m_d->thumbToImageTransform;
 }
 
+QImage KisTransformStrategyBase::transformedOriginalImage(const QTransform &transform) const
+{
+    if (m_d->transformedOriginalImage.isNull() ||
+        m_d->transformedOriginalImageTransform != transform) {
+
+        m_d->transformedOriginalImage = m_d->originalImage.transformed(transform);
+        m_d->transformedOriginalImageTransform = transform;
+    }
+
+    return m_d->transformedOriginalImage;
+}
+
 void KisTransformStrategyBase::setThumbnailImage(const QImage &image, QTransform thumbToImageTransform)
 {
     m_d->originalImage = image;
     m_d->thumbToImageTransform = thumbToImageTransform;
+    m_d->transformedOriginalImage = QImage();
 }
 
 bool KisTransformStrategyBase::acceptsClicks() const
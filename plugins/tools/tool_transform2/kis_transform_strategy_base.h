@@ -30,6 +30,14 @@ public:
     QImage originalImage() const;
     QTransform thumbToImageTransform() const;
 
+    /**
+     * The original image mapped with \p transform (usually, into the
+     * flake coordinates). The result is cached, so that the strategies
+     * that deform the preview on every mouse move don't rescale the
+     * thumbnail again while the view transform stays the same.
+     */
+    QImage transformedOriginalImage(const QTransform &transform) const;
+
     void setThumbnailImage(const QImage &image, QTransform thumbToImageTransform);
 
 public:
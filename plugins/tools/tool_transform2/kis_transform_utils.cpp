@@ -281,12 +281,48 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
 
 namespace {
 
+void runPerspectiveTransform(const ToolTransformArgs &config,
+                             KisPaintDeviceSP dstDevice,
+                             KoUpdaterPtr updater,
+                             bool cropDst,
+                             bool forceSubPixelTranslation)
+{
+    KisPerspectiveTransformWorker::SampleType sampleType =
+        config.filterId() == "NearestNeighbor" ?
+        KisPerspectiveTransformWorker::NearestNeighbour :
+        KisPerspectiveTransformWorker::Bilinear;
+
+    if (config.mode() == ToolTransformArgs::FREE_TRANSFORM) {
+        KisPerspectiveTransformWorker perspectiveWorker(dstDevice,
+                                                        config.transformedCenter(),
+                                                        config.aX(),
+                                                        config.aY(),
+                                                        config.cameraPos().z(),
+                                                        cropDst,
+                                                        updater);
+        perspectiveWorker.setForceSubPixelTranslation(forceSubPixelTranslation);
+        perspectiveWorker.run(sampleType);
+    } else if (config.mode() == ToolTransformArgs::PERSPECTIVE_4POINT) {
+        QTransform T =
+            QTransform::fromTranslate(config.transformedCenter().x(),
+                                      config.transformedCenter().y());
+
+        KisPerspectiveTransformWorker perspectiveWorker(dstDevice,
+                                                        T.inverted() * config.flattenedPerspectiveTransform() * T,
+                                                        cropDst,
+                                                        updater);
+        perspectiveWorker.setForceSubPixelTranslation(forceSubPixelTranslation);
+        perspectiveWorker.run(sampleType);
+    }
+}
+
 void transformDeviceImpl(const ToolTransformArgs &config,
                          KisPaintDeviceSP srcDevice,
                          KisPaintDeviceSP dstDevice,
                          KisProcessingVisitor::ProgressHelper *helper,
                          bool cropDst,
-                         bool forceSubPixelTranslation)
+                         bool forceSubPixelTranslation,
+                         KisCageTransformWorker::GridCacheSP cageGridCache = KisCageTransformWorker::GridCacheSP())
 {
     if (config.mode() == ToolTransformArgs::WARP) {
         KoUpdaterPtr updater = helper->updater();
@@ -307,6 +343,7 @@ void transformDeviceImpl(const ToolTransformArgs &config,
                                       updater,
                                       config.pixelPrecision());
 
+        worker.setGridCache(cageGridCache);
         worker.prepareTransform();
         worker.setTransformedCage(config.transfPoints());
         worker.run(srcDevice, dstDevice);
@@ -336,33 +373,7 @@ void transformDeviceImpl(const ToolTransformArgs &config,
         transformWorker.setForceSubPixelTranslation(forceSubPixelTranslation);
         transformWorker.run();
 
-        KisPerspectiveTransformWorker::SampleType sampleType =
-            config.filterId() == "NearestNeighbor" ?
-            KisPerspectiveTransformWorker::NearestNeighbour :
-            KisPerspectiveTransformWorker::Bilinear;
-
-        if (config.mode() == ToolTransformArgs::FREE_TRANSFORM) {
-            KisPerspectiveTransformWorker perspectiveWorker(dstDevice,
-                                                            config.transformedCenter(),
-                                                            config.aX(),
-                                                            config.aY(),
-                                                            config.cameraPos().z(),
-                                                            cropDst,
-                                                            updater2);
-            perspectiveWorker.setForceSubPixelTranslation(forceSubPixelTranslation);
-            perspectiveWorker.run(sampleType);
-        } else if (config.mode() == ToolTransformArgs::PERSPECTIVE_4POINT) {
-            QTransform T =
-                QTransform::fromTranslate(config.transformedCenter().x(),
-                                          config.transformedCenter().y());
-
-            KisPerspectiveTransformWorker perspectiveWorker(dstDevice,
-                                                            T.inverted() * config.flattenedPerspectiveTransform() * T,
-                                                            cropDst,
-                                                            updater2);
-            perspectiveWorker.setForceSubPixelTranslation(forceSubPixelTranslation);
-            perspectiveWorker.run(sampleType);
-        }
+        runPerspectiveTransform(config, dstDevice, updater2, cropDst, forceSubPixelTranslation);
     }
 }
 
@@ -376,6 +387,38 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
     transformDeviceImpl(config, srcDevice, dstDevice, helper, false, false);
 }
 
+void KisTransformUtils::transformDeviceInJobs(const ToolTransformArgs &config,
+                                              KisPaintDeviceSP srcDevice,
+                                              KisPaintDeviceSP dstDevice,
+                                              QSharedPointer<KisProcessingVisitor::ProgressHelper> helper,
+                                              KisCageTransformWorker::GridCacheSP cageGridCache,
+                                              KisRunnableStrokeJobsInterface *jobsInterface,
+                                              int levelOfDetail,
+                                              std::function<void()> finishCallback)
+{
+    if (config.mode() != ToolTransformArgs::FREE_TRANSFORM &&
+        config.mode() != ToolTransformArgs::PERSPECTIVE_4POINT) {
+
+        transformDeviceImpl(config, srcDevice, dstDevice, helper.data(), false, false, cageGridCache);
+        finishCallback();
+        return;
+    }
+
+    KoUpdaterPtr updater1 = helper->updater();
+    KoUpdaterPtr updater2 = helper->updater();
+
+    dstDevice->makeCloneFromRough(srcDevice, srcDevice->extent());
+
+    KisTransformWorker transformWorker =
+        KisTransformUtils::createTransformWorker(config, dstDevice, updater1);
+
+    transformWorker.runPartialInJobs(dstDevice->exactBounds(), jobsInterface, levelOfDetail,
+        [config, dstDevice, updater2, helper, finishCallback] () {
+            runPerspectiveTransform(config, dstDevice, updater2, false, false);
+            finishCallback();
+        });
+}
+
 void KisTransformUtils::transformDeviceWithCroppedDst(const ToolTransformArgs &config, KisPaintDeviceSP srcDevice, KisPaintDeviceSP dstDevice, KisProcessingVisitor::ProgressHelper *helper, bool forceSubPixelTranslation)
 {
     transformDeviceImpl(config, srcDevice, dstDevice, helper, true, forceSubPixelTranslation);
@@ -15,11 +15,14 @@
 #include <QMatrix4x4>
 #include <kis_processing_visitor.h>
 #include <limits>
+#include <functional>
+#include <QSharedPointer>
 
 // for kisSquareDistance only
 #include "kis_global.h"
 
 #include "tool_transform_args.h"
+#include "kis_cage_transform_worker.h"
 
 class ToolTransformArgs;
 class KisTransformWorker;
@@ -27,6 +30,7 @@ class TransformTransactionProperties;
 class KisSavedMacroCommand;
 class KisStrokeUndoFacade;
 class KisStrokeJobData;
+class KisRunnableStrokeJobsInterface;
 
 class KisTransformUtils
 {
@@ -96,6 +100,25 @@ public:
                                 KisPaintDeviceSP dstDevice,
                                 KisProcessingVisitor::ProgressHelper *helper);
 
+    /**
+     * Same as transformDevice(), but in FREE_TRANSFORM and PERSPECTIVE_4POINT
+     * modes the resampling passes of the transform worker are added into
+     * \p jobsInterface as concurrent stroke jobs. \p finishCallback is
+     * called from the last of the jobs, when \p dstDevice is ready. The
+     * other modes are transformed synchronously, the CAGE mode reuses the
+     * grid from \p cageGridCache if it is set.
+     *
+     * Must be called from a job of a running stroke.
+     */
+    static void transformDeviceInJobs(const ToolTransformArgs &config,
+                                      KisPaintDeviceSP srcDevice,
+                                      KisPaintDeviceSP dstDevice,
+                                      QSharedPointer<KisProcessingVisitor::ProgressHelper> helper,
+                                      KisCageTransformWorker::GridCacheSP cageGridCache,
+                                      KisRunnableStrokeJobsInterface *jobsInterface,
+                                      int levelOfDetail,
+                                      std::function<void()> finishCallback);
+
     static void transformDeviceWithCroppedDst(const ToolTransformArgs &config,
                                               KisPaintDeviceSP srcDevice,
                                               KisPaintDeviceSP dstDevice,
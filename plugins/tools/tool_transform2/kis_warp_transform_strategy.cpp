@@ -597,7 +597,7 @@ void KisWarpTransformStrategy::Private::recalculateTransformations()
         QPointF origTLInFlake = imageToThumb(transaction.originalTopLeft(), useFlakeOptimization);
 
         if (useFlakeOptimization) {
-            transformedImage = q->originalImage().transformed(resultThumbTransform);
+            transformedImage = q->transformedOriginalImage(resultThumbTransform);
             paintingTransform = QTransform();
         } else {
             transformedImage = q->originalImage();
@@ -86,6 +86,12 @@ struct InplaceTransformStrokeStrategy::Private
     QList<KisSelectionSP> deactivatedSelections;
     QList<KisSelectionMaskSP> deactivatedOverlaySelectionMasks;
 
+    /**
+     * Keeps the grid of the cage while its handles are moved, the
+     * grid is dropped when the stroke is finished or cancelled
+     */
+    KisCageTransformWorker::GridCacheSP cageGridCache = KisCageTransformWorker::createGridCache();
+
     QMutex commandsMutex;
 
     struct SavedCommand {
@@ -824,14 +830,34 @@ void InplaceTransformStrokeStrategy::transformNode(KisNodeSP node, const ToolTra
 
         KIS_SAFE_ASSERT_RECOVER_RETURN(cachedPortion);
 
-        KisTransaction transaction(device);
+        QSharedPointer<KisProcessingVisitor::ProgressHelper> helper(
+            new KisProcessingVisitor::ProgressHelper(node));
+        KoUpdaterPtr mergeUpdater = helper->updater();
 
-        KisProcessingVisitor::ProgressHelper helper(node);
-        KisTransformUtils::transformAndMergeDevice(config, cachedPortion,
-                                                   device, &helper);
+        KisPaintDeviceSP transformedDevice = new KisPaintDevice(cachedPortion->colorSpace());
+        transformedDevice->prepareClone(cachedPortion);
 
-        executeAndAddCommand(transaction.endAndTake(), commandGroup, KisStrokeJobData::CONCURRENT);
-        addDirtyRect(node, cachedPortion->extent() | node->projectionPlane()->tightUserVisibleBounds(), levelOfDetail);
+        /**
+         * The resampling passes of the transform worker are split into
+         * bands and added into the stroke as concurrent jobs, the device
+         * is merged when the last of them is completed
+         */
+        KisTransformUtils::transformDeviceInJobs(config, cachedPortion, transformedDevice,
+                                                 helper, m_d->cageGridCache,
+                                                 runnableJobsInterface(), levelOfDetail,
+            [this, node, device, cachedPortion, transformedDevice, helper, mergeUpdater, commandGroup, levelOfDetail] () {
+
+                KisTransaction transaction(device);
+
+                const QRect mergeRect = transformedDevice->extent();
+                KisPainter painter(device);
+                painter.setProgress(mergeUpdater);
+                painter.bitBlt(mergeRect.topLeft(), transformedDevice, mergeRect);
+                painter.end();
+
+                executeAndAddCommand(transaction.endAndTake(), commandGroup, KisStrokeJobData::CONCURRENT);
+                addDirtyRect(node, cachedPortion->extent() | node->projectionPlane()->tightUserVisibleBounds(), levelOfDetail);
+            });
 
     } else if (KisTransformMask *transformMask =
                dynamic_cast<KisTransformMask*>(node.data())) {
@@ -1025,6 +1051,7 @@ void InplaceTransformStrokeStrategy::finalizeStrokeImpl(QVector<KisStrokeJobData
         }
 
         m_d->commandUpdatesBlockerCookie.reset();
+        m_d->cageGridCache.clear();
     });
 
 